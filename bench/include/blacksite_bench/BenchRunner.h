@@ -0,0 +1,90 @@
+#pragma once
+#include <blacksite/core/Engine.h>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace BlacksiteBench {
+
+struct BenchConfig {
+    int frames = 600;        // Measured frames per scenario
+    int warmupFrames = 120;  // Run first and thrown away - shader compiles, first allocations, bodies settling
+    int cubeCount = 2000;    // For falling_cubes
+    uint32_t seed = 1337;
+    std::vector<std::string> only;  // Scenario names to run, empty = all
+};
+
+/**
+ * Scenario - One reproducible workload: a fresh Engine at a fixed size, set up once, then stepped every frame
+ * Everything is driven off the fixed timestep and the seeded rng, so two runs on the same build do the same
+ * work frame for frame and only the timings move. A setup that starts a FrameCapture replay hands the frame
+ * count to the capture, and warmup becomes one full pass through it.
+ */
+struct Scenario {
+    std::string name;
+    std::string description;
+    int width = 1280;
+    int height = 720;
+    bool postProcessing = false;
+    std::function<void(Blacksite::Engine& engine, std::mt19937& rng)> setup;
+    std::function<void(Blacksite::Engine& engine, std::mt19937& rng, int frame)> step;  // Optional
+};
+
+struct Percentiles {
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+
+    static Percentiles FromSamples(std::vector<double> samples);
+};
+
+struct ScenarioResult {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    bool ok = false;
+    int frames = 0;
+    size_t entityCount = 0;  // After the last frame
+    Percentiles frameMs;
+    std::vector<std::pair<std::string, Percentiles>> cpuScopesMs;  // Profiler scopes, per frame sum over threads
+    std::vector<std::pair<std::string, Percentiles>> gpuZonesMs;   // GpuProfiler passes, lag a few frames
+    std::vector<std::pair<std::string, size_t>> peakBytes;         // MemoryTracker, per tag
+};
+
+/**
+ * BenchRunner - Runs scenarios offscreen and writes what they measured as JSON
+ * Frame time is UpdateFrame + RenderFrame + glFinish, so GPU work lands in the frame that queued it.
+ */
+class BenchRunner {
+  public:
+    explicit BenchRunner(const BenchConfig& config) : m_config(config) {}
+
+    void AddScenario(Scenario scenario) { m_scenarios.push_back(std::move(scenario)); }
+    void AddDefaultScenarios();
+    void AddReplayScenario(const std::string& capturePath);
+    const std::vector<Scenario>& GetScenarios() const { return m_scenarios; }
+
+    bool Run();  // False if a scenario couldn't start, the others still run
+    void WriteJson(std::ostream& out) const;
+    const std::vector<ScenarioResult>& GetResults() const { return m_results; }
+
+  private:
+    BenchConfig m_config;
+    std::vector<Scenario> m_scenarios;
+    std::vector<ScenarioResult> m_results;
+
+    bool ShouldRun(const Scenario& scenario) const;
+    ScenarioResult RunScenario(const Scenario& scenario);
+};
+
+// Same numbers from the same seed on every standard library, unlike std::uniform_real_distribution
+float RandomFloat(std::mt19937& rng, float min, float max);
+
+}  // namespace BlacksiteBench
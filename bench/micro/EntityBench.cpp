@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <blacksite/core/EntitySystem.h>
+#include <blacksite/physics/PhysicsSystem.h>
+#include <vector>
+
+namespace {
+
+// One physics world for every entity benchmark. Never destroyed, Jolt's globals may already be gone at exit.
+Blacksite::PhysicsSystem* GetPhysics() {
+    static Blacksite::PhysicsSystem* physics = [] {
+        auto* system = new Blacksite::PhysicsSystem();
+        return system->Initialize() ? system : nullptr;
+    }();
+    return physics;
+}
+
+glm::vec3 GridPosition(int i) {
+    return glm::vec3((i % 32) * 2.0f, 1.0f + (i / 1024) * 2.0f, ((i / 32) % 32) * 2.0f);
+}
+
+// Spawn N cubes one by one, then remove them all - the path gameplay code takes
+void BM_EntitySpawnRemove(benchmark::State& state) {
+    Blacksite::PhysicsSystem* physics = GetPhysics();
+    if (!physics) {
+        state.SkipWithError("PhysicsSystem failed to initialize");
+        return;
+    }
+
+    Blacksite::EntitySystem entities;
+    entities.SetPhysicsSystem(physics);
+
+    int count = static_cast<int>(state.range(0));
+    std::vector<int> ids(static_cast<size_t>(count));
+    for (auto _ : state) {
+        for (int i = 0; i < count; ++i) {
+            ids[i] = entities.SpawnCube(GridPosition(i));
+        }
+        for (int id : ids) {
+            entities.RemoveEntity(id);
+        }
+        physics->FlushBodyChanges();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_EntitySpawnRemove)->Arg(64)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+// Same count through SpawnBatch, bodies inserted together
+void BM_EntitySpawnBatchRemove(benchmark::State& state) {
+    Blacksite::PhysicsSystem* physics = GetPhysics();
+    if (!physics) {
+        state.SkipWithError("PhysicsSystem failed to initialize");
+        return;
+    }
+
+    Blacksite::EntitySystem entities;
+    entities.SetPhysicsSystem(physics);
+
+    int count = static_cast<int>(state.range(0));
+    std::vector<glm::vec3> positions;
+    for (int i = 0; i < count; ++i) {
+        positions.push_back(GridPosition(i));
+    }
+
+    std::vector<int> ids;
+    for (auto _ : state) {
+        ids.clear();
+        entities.SpawnBatch(positions, {}, {}, "basic", &ids);
+        for (int id : ids) {
+            entities.RemoveEntity(id);
+        }
+        physics->FlushBodyChanges();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_EntitySpawnBatchRemove)->Arg(64)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,23 @@
+#include <benchmark/benchmark.h>
+#include <blacksite/graphics/GeometryManager.h>
+#include <vector>
+
+namespace {
+
+// Args are sectors and stacks. 30x30 is what the renderer's default sphere uses, the others are LOD-ish.
+void BM_GenerateSphere(benchmark::State& state) {
+    int sectors = static_cast<int>(state.range(0));
+    int stacks = static_cast<int>(state.range(1));
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    for (auto _ : state) {
+        Blacksite::GeometryManager::GenerateSphere(vertices, indices, 0.5f, sectors, stacks);
+        benchmark::DoNotOptimize(vertices.data());
+        benchmark::DoNotOptimize(indices.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (sectors + 1) * (stacks + 1));  // Vertices
+}
+BENCHMARK(BM_GenerateSphere)->Args({12, 8})->Args({30, 30})->Args({64, 64})->Unit(benchmark::kMicrosecond);
+
+}  // namespace
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <blacksite/core/Logger.h>
+
+namespace {
+
+using Blacksite::LogCategory;
+using Blacksite::Logger;
+using Blacksite::LogLevel;
+
+// main() turns console and file output off, what's left is formatting, locking and the editor history
+
+// A call below the level - what every disabled BS_DEBUG in a hot loop costs
+void BM_LogFiltered(benchmark::State& state) {
+    Logger::Instance().SetLevel(LogLevel::WARN);
+    int value = 0;
+    for (auto _ : state) {
+        BS_DEBUG_F(LogCategory::CORE, "Filtered message %d", value++);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogFiltered);
+
+void BM_LogSync(benchmark::State& state) {
+    Logger::Instance().SetLevel(LogLevel::INFO);
+    for (auto _ : state) {
+        BS_INFO(LogCategory::CORE, "Benchmark message with a bit of length to it");
+    }
+    Logger::Instance().SetLevel(LogLevel::WARN);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogSync);
+
+void BM_LogSyncFormatted(benchmark::State& state) {
+    Logger::Instance().SetLevel(LogLevel::INFO);
+    int value = 0;
+    for (auto _ : state) {
+        BS_INFO_F(LogCategory::CORE, "Entity %d moved to (%.2f, %.2f, %.2f)", value++, 1.0f, 2.0f, 3.0f);
+    }
+    Logger::Instance().SetLevel(LogLevel::WARN);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogSyncFormatted);
+
+// The caller's side of the async writer. Messages the ring had no room for show up as 'dropped'.
+// Thread 0 does setup and teardown, the benchmark loop doesn't start until it's done.
+void BM_LogAsync(benchmark::State& state) {
+    Logger& logger = Logger::Instance();
+    uint64_t droppedBefore = 0;
+    if (state.thread_index() == 0) {
+        logger.SetLevel(LogLevel::INFO);
+        logger.SetAsync(true);
+        droppedBefore = logger.GetDroppedCount();
+    }
+
+    for (auto _ : state) {
+        BS_INFO(LogCategory::CORE, "Benchmark message with a bit of length to it");
+    }
+
+    if (state.thread_index() == 0) {
+        logger.SetAsync(false);
+        logger.SetLevel(LogLevel::WARN);
+        state.counters["dropped"] = static_cast<double>(logger.GetDroppedCount() - droppedBefore);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogAsync)->Threads(1)->Threads(4);
+
+}  // namespace
@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+#include <blacksite/graphics/Renderer.h>
+#include <blacksite/math/Transform.h>
+#include <blacksite/physics/PhysicsSystem.h>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Blacksite::Transform;
+
+// Same transforms every run, enough of them that the loop isn't just one cached value
+const std::vector<Transform>& GetTransforms() {
+    static const std::vector<Transform> transforms = [] {
+        std::mt19937 rng(42);
+        auto unit = [&rng]() { return static_cast<float>(rng()) / 4294967296.0f; };
+
+        std::vector<Transform> result(1024);
+        for (Transform& transform : result) {
+            transform.position = glm::vec3(unit(), unit(), unit()) * 100.0f - 50.0f;
+            transform.SetEulerRotation(glm::vec3(unit(), unit(), unit()) * 360.0f);
+            transform.scale = glm::vec3(0.5f + unit(), 0.5f + unit(), 0.5f + unit());
+        }
+        return result;
+    }();
+    return transforms;
+}
+
+void BM_TransformGetMatrix(benchmark::State& state) {
+    const auto& transforms = GetTransforms();
+    for (auto _ : state) {
+        for (const Transform& transform : transforms) {
+            glm::mat4 model = transform.GetMatrix();
+            benchmark::DoNotOptimize(model);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * transforms.size());
+}
+BENCHMARK(BM_TransformGetMatrix);
+
+void BM_CreateModelMatrix(benchmark::State& state) {
+    const auto& transforms = GetTransforms();
+    for (auto _ : state) {
+        for (const Transform& transform : transforms) {
+            glm::mat4 model = Blacksite::Renderer::CreateModelMatrix(transform);
+            benchmark::DoNotOptimize(model);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * transforms.size());
+}
+BENCHMARK(BM_CreateModelMatrix);
+
+// translate * rotate * scale the glm way, the baseline ComposeTRS has to beat
+void BM_ModelMatrixGlmReference(benchmark::State& state) {
+    const auto& transforms = GetTransforms();
+    for (auto _ : state) {
+        for (const Transform& transform : transforms) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), transform.position) * glm::mat4_cast(transform.rotation) *
+                              glm::scale(glm::mat4(1.0f), transform.scale);
+            benchmark::DoNotOptimize(model);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * transforms.size());
+}
+BENCHMARK(BM_ModelMatrixGlmReference);
+
+void BM_ToJoltRotQuat(benchmark::State& state) {
+    const auto& transforms = GetTransforms();
+    for (auto _ : state) {
+        for (const Transform& transform : transforms) {
+            JPH::Quat rotation = Blacksite::ToJoltRot(transform.rotation);
+            benchmark::DoNotOptimize(rotation);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * transforms.size());
+}
+BENCHMARK(BM_ToJoltRotQuat);
+
+void BM_ToJoltRotEuler(benchmark::State& state) {
+    const auto& transforms = GetTransforms();
+    std::vector<glm::vec3> angles;
+    for (const Transform& transform : transforms) {
+        angles.push_back(transform.GetEulerRotation());
+    }
+
+    for (auto _ : state) {
+        for (const glm::vec3& euler : angles) {
+            JPH::Quat rotation = Blacksite::ToJoltRot(euler);
+            benchmark::DoNotOptimize(rotation);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * angles.size());
+}
+BENCHMARK(BM_ToJoltRotEuler);
+
+void BM_ToGLMQuat(benchmark::State& state) {
+    std::vector<JPH::Quat> rotations;
+    for (const Transform& transform : GetTransforms()) {
+        rotations.push_back(Blacksite::ToJoltRot(transform.rotation));
+    }
+
+    for (auto _ : state) {
+        for (const JPH::Quat& rotation : rotations) {
+            glm::quat result = Blacksite::ToGLMQuat(rotation);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * rotations.size());
+}
+BENCHMARK(BM_ToGLMQuat);
+
+void BM_ToGLMRot(benchmark::State& state) {
+    std::vector<JPH::Quat> rotations;
+    for (const Transform& transform : GetTransforms()) {
+        rotations.push_back(Blacksite::ToJoltRot(transform.rotation));
+    }
+
+    for (auto _ : state) {
+        for (const JPH::Quat& rotation : rotations) {
+            glm::vec3 euler = Blacksite::ToGLMRot(rotation);
+            benchmark::DoNotOptimize(euler);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * rotations.size());
+}
+BENCHMARK(BM_ToGLMRot);
+
+}  // namespace
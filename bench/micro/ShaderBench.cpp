@@ -0,0 +1,130 @@
+#include <benchmark/benchmark.h>
+#include <blacksite/core/Window.h>
+#include <blacksite/graphics/ShaderManager.h>
+#include <string>
+
+namespace {
+
+const char* VERTEX_SOURCE = R"(#version 330 core
+layout(location = 0) in vec3 aPos;
+uniform mat4 u_model;
+uniform mat4 u_view;
+uniform mat4 u_projection;
+void main() { gl_Position = u_projection * u_view * u_model * vec4(aPos, 1.0); }
+)";
+
+const char* FRAGMENT_SOURCE = R"(#version 330 core
+uniform vec3 u_color;
+uniform float u_alpha;
+out vec4 FragColor;
+void main() { FragColor = vec4(u_color, u_alpha); }
+)";
+
+// Hidden window for a context plus one small program. Never torn down, the process is about to end anyway.
+Blacksite::ShaderManager* GetShaders() {
+    static Blacksite::ShaderManager* shaders = []() -> Blacksite::ShaderManager* {
+        auto* window = new Blacksite::Window();
+        if (!window->Initialize(64, 64, "blacksite_microbench", false)) {
+            return nullptr;
+        }
+        auto* manager = new Blacksite::ShaderManager();
+        if (!manager->LoadShader("bench", VERTEX_SOURCE, FRAGMENT_SOURCE) || !manager->UseShader("bench")) {
+            return nullptr;
+        }
+        return manager;
+    }();
+    return shaders;
+}
+
+// Call sites pass string literals, so a std::string gets built every time - that's part of the cost
+void BM_SetUniformMat4(benchmark::State& state) {
+    Blacksite::ShaderManager* shaders = GetShaders();
+    if (!shaders) {
+        state.SkipWithError("No GL context");
+        return;
+    }
+
+    glm::mat4 model(1.0f);
+    for (auto _ : state) {
+        shaders->SetUniform("u_model", model);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SetUniformMat4);
+
+void BM_SetUniformMat4Prebuilt(benchmark::State& state) {
+    Blacksite::ShaderManager* shaders = GetShaders();
+    if (!shaders) {
+        state.SkipWithError("No GL context");
+        return;
+    }
+
+    const std::string name = "u_model";
+    glm::mat4 model(1.0f);
+    for (auto _ : state) {
+        shaders->SetUniform(name, model);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SetUniformMat4Prebuilt);
+
+void BM_SetUniformFloat(benchmark::State& state) {
+    Blacksite::ShaderManager* shaders = GetShaders();
+    if (!shaders) {
+        state.SkipWithError("No GL context");
+        return;
+    }
+
+    for (auto _ : state) {
+        shaders->SetUniform("u_alpha", 1.0f);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SetUniformFloat);
+
+// Just the name -> location lookup, no GL call
+void BM_GetUniformLocation(benchmark::State& state) {
+    Blacksite::ShaderManager* shaders = GetShaders();
+    if (!shaders) {
+        state.SkipWithError("No GL context");
+        return;
+    }
+
+    const std::string name = "u_projection";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shaders->GetUniformLocation(name));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetUniformLocation);
+
+void BM_UseShaderByName(benchmark::State& state) {
+    Blacksite::ShaderManager* shaders = GetShaders();
+    if (!shaders) {
+        state.SkipWithError("No GL context");
+        return;
+    }
+
+    for (auto _ : state) {
+        shaders->UseShader("bench");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UseShaderByName);
+
+void BM_UseShaderByHandle(benchmark::State& state) {
+    Blacksite::ShaderManager* shaders = GetShaders();
+    if (!shaders) {
+        state.SkipWithError("No GL context");
+        return;
+    }
+
+    Blacksite::ShaderHandle handle = shaders->GetShaderHandle("bench");
+    for (auto _ : state) {
+        shaders->UseShader(handle);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UseShaderByHandle);
+
+}  // namespace
@@ -0,0 +1,18 @@
+#include <benchmark/benchmark.h>
+#include <blacksite/core/Logger.h>
+
+int main(int argc, char** argv) {
+    // Spawning and shader loading log a line each, keep them out of the numbers and the output
+    Blacksite::Logger& logger = Blacksite::Logger::Instance();
+    logger.SetLevel(Blacksite::LogLevel::WARN);
+    logger.SetConsoleOutput(false);
+    logger.SetFileOutput(false);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
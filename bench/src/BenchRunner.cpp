@@ -0,0 +1,254 @@
+#include "blacksite_bench/BenchRunner.h"
+#include <blacksite/core/EntitySystem.h>
+#include <blacksite/core/Logger.h>
+#include <blacksite/core/MemoryTracker.h>
+#include <blacksite/core/Profiler.h>
+#include <blacksite/scene/Scene.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <numeric>
+
+namespace BlacksiteBench {
+
+namespace {
+
+constexpr float FIXED_DELTA = 1.0f / 60.0f;
+
+double Nth(const std::vector<double>& sorted, double percentile) {
+    // Nearest rank, a p99 of 600 frames is an actual frame rather than a blend of two
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+void WriteJsonString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+void WritePercentiles(std::ostream& out, const Percentiles& p) {
+    out << "{\"mean\":" << p.mean << ",\"p50\":" << p.p50 << ",\"p90\":" << p.p90 << ",\"p95\":" << p.p95
+        << ",\"p99\":" << p.p99 << ",\"max\":" << p.max << "}";
+}
+
+void WriteNamedPercentiles(std::ostream& out, const std::vector<std::pair<std::string, Percentiles>>& entries) {
+    out << "{";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        out << (i ? ",\n        " : "\n        ");
+        WriteJsonString(out, entries[i].first);
+        out << ":";
+        WritePercentiles(out, entries[i].second);
+    }
+    out << (entries.empty() ? "}" : "\n      }");
+}
+
+// Per-frame samples keyed by name. A name that skipped some frames is padded with zeros for them.
+using SampleMap = std::map<std::string, std::vector<double>>;
+
+std::vector<std::pair<std::string, Percentiles>> Summarize(SampleMap& samples, size_t frames) {
+    std::vector<std::pair<std::string, Percentiles>> result;
+    result.reserve(samples.size());
+    for (auto& [name, values] : samples) {
+        values.resize(std::max(values.size(), frames), 0.0);
+        result.emplace_back(name, Percentiles::FromSamples(std::move(values)));
+    }
+    return result;
+}
+
+}  // namespace
+
+float RandomFloat(std::mt19937& rng, float min, float max) {
+    double unit = static_cast<double>(rng()) / 4294967296.0;  // [0, 1)
+    return min + static_cast<float>(unit) * (max - min);
+}
+
+Percentiles Percentiles::FromSamples(std::vector<double> samples) {
+    Percentiles result;
+    if (samples.empty()) {
+        return result;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    result.p50 = Nth(samples, 50.0);
+    result.p90 = Nth(samples, 90.0);
+    result.p95 = Nth(samples, 95.0);
+    result.p99 = Nth(samples, 99.0);
+    result.max = samples.back();
+    return result;
+}
+
+bool BenchRunner::ShouldRun(const Scenario& scenario) const {
+    return m_config.only.empty() ||
+           std::find(m_config.only.begin(), m_config.only.end(), scenario.name) != m_config.only.end();
+}
+
+bool BenchRunner::Run() {
+    m_results.clear();
+
+    bool allOk = true;
+    for (const Scenario& scenario : m_scenarios) {
+        if (!ShouldRun(scenario)) {
+            continue;
+        }
+
+        std::fprintf(stderr, "bench: %s (%dx%d)\n", scenario.name.c_str(), scenario.width, scenario.height);
+        m_results.push_back(RunScenario(scenario));
+        allOk = allOk && m_results.back().ok;
+    }
+    return allOk;
+}
+
+ScenarioResult BenchRunner::RunScenario(const Scenario& scenario) {
+    ScenarioResult result;
+    result.name = scenario.name;
+    result.width = scenario.width;
+    result.height = scenario.height;
+
+    // A fresh engine each time, nothing left over from the scenario before
+    Blacksite::Engine engine;
+    engine.SetOffscreen(true);
+
+    // The default limits are for small scenes, falling_cubes and static_planes_10k go well past them
+    Blacksite::PhysicsConfig physicsConfig;
+    physicsConfig.maxBodies = 65536;
+    physicsConfig.maxBodyPairs = 65536;
+    physicsConfig.maxContactConstraints = 10240;
+    engine.SetPhysicsConfig(physicsConfig);
+    if (!engine.Initialize(scenario.width, scenario.height, "Blacksite Bench - " + scenario.name)) {
+        BS_ERROR_F(Blacksite::LogCategory::CORE, "bench: Engine failed to start for %s", scenario.name.c_str());
+        return result;
+    }
+
+    engine.CreateScene(scenario.name);
+    engine.SwitchToScene(scenario.name);
+    engine.GetRenderer()->EnablePostProcessing(scenario.postProcessing);
+    engine.SetGpuProfilingEnabled(true);
+
+    std::mt19937 rng(m_config.seed);
+    if (scenario.setup) {
+        scenario.setup(engine, rng);
+    }
+
+    bool replay = engine.GetFrameCapture()->IsReplaying();
+    int warmupFrames = m_config.warmupFrames;
+    int measuredFrames = m_config.frames;
+    if (replay) {
+        measuredFrames = static_cast<int>(engine.GetFrameCapture()->GetReplayFrameCount());
+        warmupFrames = warmupFrames > 0 ? measuredFrames : 0;
+    }
+
+    int frame = 0;
+    auto runFrame = [&]() {
+        if (scenario.step) {
+            scenario.step(engine, rng, frame);
+        }
+        engine.UpdateFrame(FIXED_DELTA);
+        engine.RenderFrame();
+        glFinish();
+        ++frame;
+    };
+
+    for (int i = 0; i < warmupFrames; ++i) {
+        runFrame();
+    }
+    // A standalone replay starts over from its saved scene, the warmup pass leaves nothing behind
+    if (replay && warmupFrames > 0) {
+        scenario.setup(engine, rng);
+        if (!engine.GetFrameCapture()->IsReplaying()) {
+            return result;
+        }
+    }
+
+    bool wasProfiling = Blacksite::Profiler::IsEnabled();
+    Blacksite::Profiler::SetEnabled(true);
+    Blacksite::MemoryTracker::ResetPeaks();
+
+    std::vector<double> frameMs;
+    frameMs.reserve(static_cast<size_t>(measuredFrames));
+    SampleMap cpuScopes;
+    SampleMap gpuZones;
+
+    for (int i = 0; i < measuredFrames; ++i) {
+        // Workers are idle between frames, so clearing their rings here can't race a write
+        Blacksite::Profiler::Clear();
+
+        uint64_t start = Blacksite::Profiler::Now();
+        runFrame();
+        frameMs.push_back((Blacksite::Profiler::Now() - start) / 1e6);
+
+        for (const auto& total : Blacksite::Profiler::GetScopeTotals()) {
+            auto& values = cpuScopes[total.name];
+            values.resize(static_cast<size_t>(i), 0.0);
+            values.push_back(total.totalNs / 1e6);
+        }
+        for (const auto& zone : engine.GetGpuTimings()) {
+            auto& values = gpuZones[zone.name];
+            values.resize(static_cast<size_t>(i), 0.0);
+            values.push_back(zone.ms);
+        }
+    }
+
+    Blacksite::Profiler::SetEnabled(wasProfiling);
+    Blacksite::Profiler::Clear();
+
+    result.frames = measuredFrames;
+    result.frameMs = Percentiles::FromSamples(frameMs);
+    result.cpuScopesMs = Summarize(cpuScopes, frameMs.size());
+    result.gpuZonesMs = Summarize(gpuZones, frameMs.size());
+
+    for (size_t tag = 0; tag < static_cast<size_t>(Blacksite::MemoryTag::Count); ++tag) {
+        auto memoryTag = static_cast<Blacksite::MemoryTag>(tag);
+        result.peakBytes.emplace_back(Blacksite::MemoryTracker::GetTagName(memoryTag),
+                                      Blacksite::MemoryTracker::GetStats(memoryTag).peakBytes);
+    }
+
+    if (Blacksite::Scene* scene = engine.GetActiveScene()) {
+        result.entityCount = scene->GetEntitySystem()->GetAliveCount();
+    }
+    result.ok = true;
+
+    if (replay && engine.GetFrameCapture()->GetDivergedFrame() != Blacksite::FrameCapture::NO_DIVERGENCE) {
+        std::fprintf(stderr, "bench: %s entity count drifted from the capture at frame %llu\n", scenario.name.c_str(),
+                     static_cast<unsigned long long>(engine.GetFrameCapture()->GetDivergedFrame()));
+    }
+
+    engine.Shutdown();
+    return result;
+}
+
+void BenchRunner::WriteJson(std::ostream& out) const {
+    out << "{\n  \"frames\": " << m_config.frames << ",\n  \"warmupFrames\": " << m_config.warmupFrames
+        << ",\n  \"seed\": " << m_config.seed << ",\n  \"scenarios\": [";
+
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const ScenarioResult& result = m_results[i];
+        out << (i ? ",\n    {" : "\n    {") << "\n      \"name\": ";
+        WriteJsonString(out, result.name);
+        out << ",\n      \"ok\": " << (result.ok ? "true" : "false") << ",\n      \"width\": " << result.width
+            << ",\n      \"height\": " << result.height << ",\n      \"frames\": " << result.frames
+            << ",\n      \"entities\": " << result.entityCount << ",\n      \"frameMs\": ";
+        WritePercentiles(out, result.frameMs);
+        out << ",\n      \"cpuScopesMs\": ";
+        WriteNamedPercentiles(out, result.cpuScopesMs);
+        out << ",\n      \"gpuZonesMs\": ";
+        WriteNamedPercentiles(out, result.gpuZonesMs);
+        out << ",\n      \"peakBytes\": {";
+        for (size_t tag = 0; tag < result.peakBytes.size(); ++tag) {
+            out << (tag ? ", " : "");
+            WriteJsonString(out, result.peakBytes[tag].first);
+            out << ": " << result.peakBytes[tag].second;
+        }
+        out << "}\n    }";
+    }
+    out << (m_results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+}  // namespace BlacksiteBench
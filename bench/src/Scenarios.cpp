@@ -0,0 +1,91 @@
+#include "blacksite_bench/BenchRunner.h"
+#include <blacksite/scene/Scene.h>
+#include <memory>
+
+namespace BlacksiteBench {
+
+namespace {
+
+glm::vec3 RandomColor(std::mt19937& rng) {
+    return {RandomFloat(rng, 0.2f, 1.0f), RandomFloat(rng, 0.2f, 1.0f), RandomFloat(rng, 0.2f, 1.0f)};
+}
+
+int SpawnFallingCube(Blacksite::Engine& engine, std::mt19937& rng, float spread, float minHeight, float maxHeight) {
+    glm::vec3 position(RandomFloat(rng, -spread, spread), RandomFloat(rng, minHeight, maxHeight),
+                       RandomFloat(rng, -spread, spread));
+    return engine.SpawnCube(position, "basic", RandomColor(rng));
+}
+
+// Ground plus a few hundred cubes frozen in place, so the frame is mostly the renderer
+void SetupStaticShowcase(Blacksite::Engine& engine, std::mt19937& rng) {
+    engine.SpawnPlane({0.0f, -1.0f, 0.0f}, {60.0f, 0.2f, 60.0f}, "basic", {0.5f, 0.5f, 0.5f});
+    for (int i = 0; i < 500; ++i) {
+        int id = SpawnFallingCube(engine, rng, 25.0f, 0.0f, 12.0f);
+        engine.GetEntity(id).MakeStatic();
+    }
+    engine.SetCameraPosition({0.0f, 18.0f, 45.0f});
+    engine.SetCameraTarget({0.0f, 2.0f, 0.0f});
+}
+
+}  // namespace
+
+void BenchRunner::AddDefaultScenarios() {
+    int cubeCount = m_config.cubeCount;
+    AddScenario({"falling_cubes", "Cubes dropped onto a ground plane, piling up as the run goes", 1280, 720, false,
+                 [cubeCount](Blacksite::Engine& engine, std::mt19937& rng) {
+                     engine.SpawnPlane({0.0f, -1.0f, 0.0f}, {60.0f, 0.2f, 60.0f}, "basic", {0.5f, 0.5f, 0.5f});
+                     for (int i = 0; i < cubeCount; ++i) {
+                         SpawnFallingCube(engine, rng, 15.0f, 5.0f, 5.0f + cubeCount * 0.02f);
+                     }
+                     engine.SetCameraPosition({0.0f, 25.0f, 50.0f});
+                     engine.SetCameraTarget({0.0f, 5.0f, 0.0f});
+                 },
+                 nullptr});
+
+    // 1000 live cubes, 50 random ones replaced every frame
+    auto churnIds = std::make_shared<std::vector<int>>();
+    AddScenario({"spawn_churn", "Constant spawning and removal against a fixed live count", 1280, 720, false,
+                 [churnIds](Blacksite::Engine& engine, std::mt19937& rng) {
+                     churnIds->clear();
+                     engine.SpawnPlane({0.0f, -1.0f, 0.0f}, {60.0f, 0.2f, 60.0f}, "basic", {0.5f, 0.5f, 0.5f});
+                     for (int i = 0; i < 1000; ++i) {
+                         churnIds->push_back(SpawnFallingCube(engine, rng, 20.0f, 2.0f, 20.0f));
+                     }
+                     engine.SetCameraPosition({0.0f, 25.0f, 50.0f});
+                     engine.SetCameraTarget({0.0f, 5.0f, 0.0f});
+                 },
+                 [churnIds](Blacksite::Engine& engine, std::mt19937& rng, int) {
+                     Blacksite::Scene* scene = engine.GetActiveScene();
+                     for (int i = 0; i < 50 && !churnIds->empty(); ++i) {
+                         size_t index = rng() % churnIds->size();
+                         scene->RemoveEntity((*churnIds)[index]);
+                         (*churnIds)[index] = SpawnFallingCube(engine, rng, 20.0f, 2.0f, 20.0f);
+                     }
+                 }});
+
+    AddScenario({"static_planes_10k", "A 100x100 grid of static planes, culling and draw submission", 1280, 720, false,
+                 [](Blacksite::Engine& engine, std::mt19937& rng) {
+                     for (int z = 0; z < 100; ++z) {
+                         for (int x = 0; x < 100; ++x) {
+                             glm::vec3 position((x - 50) * 2.0f, 0.0f, (z - 50) * 2.0f);
+                             engine.SpawnPlane(position, {1.8f, 0.1f, 1.8f}, "basic", RandomColor(rng));
+                         }
+                     }
+                     engine.SetCameraPosition({0.0f, 40.0f, 80.0f});
+                     engine.SetCameraTarget({0.0f, 0.0f, 0.0f});
+                 },
+                 nullptr});
+
+    AddScenario({"postprocess_1080p", "Static scene with the full post-processing chain", 1920, 1080, true,
+                 SetupStaticShowcase, nullptr});
+    AddScenario({"postprocess_4k", "Static scene with the full post-processing chain", 3840, 2160, true,
+                 SetupStaticShowcase, nullptr});
+}
+
+void BenchRunner::AddReplayScenario(const std::string& capturePath) {
+    AddScenario({"replay", "Standalone replay of " + capturePath, 1280, 720, false,
+                 [capturePath](Blacksite::Engine& engine, std::mt19937&) { engine.StartReplay(capturePath, true); },
+                 nullptr});
+}
+
+}  // namespace BlacksiteBench
@@ -0,0 +1,132 @@
+#include "blacksite_bench/BenchRunner.h"
+#include <blacksite/core/Logger.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+void PrintUsage() {
+    std::fprintf(stderr,
+                 "usage: blacksite_bench [options]\n"
+                 "  --list              print the scenarios and exit\n"
+                 "  --scenario NAME     run only this one (repeatable)\n"
+                 "  --frames N          measured frames per scenario (default 600)\n"
+                 "  --warmup N          frames run before measuring (default 120)\n"
+                 "  --cubes N           cube count for falling_cubes (default 2000)\n"
+                 "  --seed N            rng seed (default 1337)\n"
+                 "  --replay PATH       replay a frame capture standalone, as the 'replay' scenario\n"
+                 "  --out PATH          JSON results, '-' for stdout (default bench_results.json)\n"
+                 "  --verbose           keep the engine's info logging\n"
+                 "Run from the repository root so assets/shaders is found.\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BlacksiteBench::BenchConfig config;
+    std::string outPath = "bench_results.json";
+    std::string replayPath;
+    bool list = false;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool takesValue = true;
+
+        if (std::strcmp(arg, "--list") == 0) {
+            list = true;
+            takesValue = false;
+        } else if (std::strcmp(arg, "--verbose") == 0) {
+            verbose = true;
+            takesValue = false;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            PrintUsage();
+            return 0;
+        } else if (!value) {
+            PrintUsage();
+            return 2;
+        } else if (std::strcmp(arg, "--scenario") == 0) {
+            config.only.push_back(value);
+        } else if (std::strcmp(arg, "--frames") == 0) {
+            config.frames = std::max(1, std::atoi(value));
+        } else if (std::strcmp(arg, "--warmup") == 0) {
+            config.warmupFrames = std::max(0, std::atoi(value));
+        } else if (std::strcmp(arg, "--cubes") == 0) {
+            config.cubeCount = std::max(0, std::atoi(value));
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            config.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(arg, "--replay") == 0) {
+            replayPath = value;
+        } else if (std::strcmp(arg, "--out") == 0) {
+            outPath = value;
+        } else {
+            PrintUsage();
+            return 2;
+        }
+
+        if (takesValue) {
+            ++i;
+        }
+    }
+
+    // The replay runs on its own, or next to whatever --scenario picked
+    if (!replayPath.empty()) {
+        if (!std::ifstream(replayPath, std::ios::binary)) {
+            std::fprintf(stderr, "Can't read capture %s\n", replayPath.c_str());
+            return 2;
+        }
+        config.only.push_back("replay");
+    }
+
+    BlacksiteBench::BenchRunner runner(config);
+    runner.AddDefaultScenarios();
+    if (!replayPath.empty()) {
+        runner.AddReplayScenario(replayPath);
+    }
+
+    if (list) {
+        for (const auto& scenario : runner.GetScenarios()) {
+            std::printf("%-20s %4dx%-4d %s\n", scenario.name.c_str(), scenario.width, scenario.height,
+                        scenario.description.c_str());
+        }
+        return 0;
+    }
+
+    for (const std::string& name : config.only) {
+        bool known = false;
+        for (const auto& scenario : runner.GetScenarios()) {
+            known = known || scenario.name == name;
+        }
+        if (!known) {
+            std::fprintf(stderr, "Unknown scenario '%s', see --list\n", name.c_str());
+            return 2;
+        }
+    }
+
+    // Setup spawns thousands of entities, each one logging would dominate the run
+    if (!verbose) {
+        Blacksite::Logger::Instance().SetLevel(Blacksite::LogLevel::WARN);
+    }
+
+    bool ok = runner.Run();
+
+    if (outPath == "-") {
+        runner.WriteJson(std::cout);
+    } else {
+        std::ofstream out(outPath);
+        if (!out) {
+            std::fprintf(stderr, "Can't write %s\n", outPath.c_str());
+            return 1;
+        }
+        runner.WriteJson(out);
+        std::fprintf(stderr, "Wrote %s\n", outPath.c_str());
+    }
+
+    return ok ? 0 : 1;
+}
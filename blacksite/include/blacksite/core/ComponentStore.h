@@ -0,0 +1,192 @@
+#pragma once
+#include <blacksite/physics/JoltConfig.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include "blacksite/graphics/RenderHandles.h"
+#include "blacksite/math/Transform.h"
+#include "blacksite/physics/PhysicsLayers.h"
+
+namespace Blacksite {
+
+// Lives outside Entity so the component structs can use it, Entity re-exports it (Entity::CUBE etc.)
+struct EntityShape {
+    enum VisualShape { CUBE, SPHERE, PLANE, MESH };  // MESH = a loaded mesh, named by Entity::mesh
+};
+
+// What the renderer needs per entity
+struct RenderComponent {
+    EntityShape::VisualShape shape = EntityShape::CUBE;
+    ShaderHandle shaderHandle;  // Cached lookup of Entity::shader, filled in at render time
+    MeshHandle meshHandle;      // Same for Entity::mesh, MESH entities only
+    TextureHandle textureHandle;  // And Entity::texture
+    bool hasTexture = false;      // Entity::texture isn't empty, so untextured entities never look it up
+    glm::vec3 color{1.0f, 1.0f, 1.0f};
+    bool staticBatched = false;  // Drawn as part of a StaticBatcher mesh, the per-entity path skips it
+    uint8_t lodLevel = 0;        // Last frame's pick, SelectLod needs it for the hysteresis
+};
+
+// Link to the Jolt body, the body itself lives in the physics system
+struct PhysicsComponent {
+    JPH::BodyID body;
+    bool hasPhysics = false;
+    bool isDynamic = true;
+    PhysicsLayer layer = AUTO_LAYER;  // Object layer, AUTO_LAYER = Static/Moving from isDynamic
+
+    static constexpr PhysicsLayer AUTO_LAYER = 0xFFFF;
+};
+
+// Body pose from the physics step before the latest one, for render interpolation.
+// 'valid' stays false until the physics sync has written the slot at least once.
+struct BodyPose {
+    glm::vec3 position{0.0f};
+    glm::quat orientation{1.0f, 0.0f, 0.0f, 0.0f};
+    bool valid = false;
+};
+
+/**
+ * ComponentStore - Hot per-entity data as parallel arrays, indexed by entity slot
+ * Per-frame loops (physics sync, culling, command recording) walk these directly and never touch
+ * the Entity objects, which only hold the cold stuff (names, shader names, colliders, behaviour).
+ */
+class ComponentStore {
+  public:
+    // Grows every array to 'count' slots, new slots start inactive
+    void Resize(size_t count) {
+        m_transforms.resize(count);
+        m_render.resize(count);
+        m_physics.resize(count);
+        m_previousPoses.resize(count);
+        m_active.resize(count, 0);
+        m_worldMatrices.resize(count, glm::mat4(1.0f));
+        m_worldRadii.resize(count, 0.0f);
+        m_transformDirty.resize(count, 1);
+        m_spatialDirty.resize(count, 1);
+        m_shadowDirty.resize(count, 1);
+    }
+
+    void Reserve(size_t count) {
+        m_transforms.reserve(count);
+        m_render.reserve(count);
+        m_physics.reserve(count);
+        m_previousPoses.reserve(count);
+        m_active.reserve(count);
+        m_worldMatrices.reserve(count);
+        m_worldRadii.reserve(count);
+        m_transformDirty.reserve(count);
+        m_spatialDirty.reserve(count);
+        m_shadowDirty.reserve(count);
+    }
+
+    // Heap bytes the arrays hold on to - capacity, not size
+    size_t GetCapacityBytes() const {
+        return m_transforms.capacity() * sizeof(Transform) + m_render.capacity() * sizeof(RenderComponent) +
+               m_physics.capacity() * sizeof(PhysicsComponent) + m_previousPoses.capacity() * sizeof(BodyPose) +
+               m_active.capacity() + m_worldMatrices.capacity() * sizeof(glm::mat4) +
+               m_worldRadii.capacity() * sizeof(float) + m_transformDirty.capacity() + m_spatialDirty.capacity() +
+               m_shadowDirty.capacity();
+    }
+
+    void Clear() {
+        m_transforms.clear();
+        m_render.clear();
+        m_physics.clear();
+        m_previousPoses.clear();
+        m_active.clear();
+        m_worldMatrices.clear();
+        m_worldRadii.clear();
+        m_transformDirty.clear();
+        m_spatialDirty.clear();
+        m_shadowDirty.clear();
+    }
+
+    size_t Size() const { return m_transforms.size(); }
+
+    // Back to defaults (and inactive) when an entity leaves the slot
+    void ResetSlot(uint32_t index) {
+        m_transforms[index] = Transform{};
+        m_render[index] = RenderComponent{};
+        m_physics[index] = PhysicsComponent{};
+        m_previousPoses[index] = BodyPose{};
+        m_active[index] = 0;
+        m_worldRadii[index] = 0.0f;  // Not drawn yet
+        m_transformDirty[index] = 1;
+        m_spatialDirty[index] = 1;
+        m_shadowDirty[index] = 1;
+    }
+
+    // Single slot access
+    Transform& GetTransform(uint32_t index) { return m_transforms[index]; }
+    const Transform& GetTransform(uint32_t index) const { return m_transforms[index]; }
+    RenderComponent& GetRender(uint32_t index) { return m_render[index]; }
+    const RenderComponent& GetRender(uint32_t index) const { return m_render[index]; }
+    PhysicsComponent& GetPhysics(uint32_t index) { return m_physics[index]; }
+    const PhysicsComponent& GetPhysics(uint32_t index) const { return m_physics[index]; }
+    BodyPose& GetPreviousPose(uint32_t index) { return m_previousPoses[index]; }
+    const BodyPose& GetPreviousPose(uint32_t index) const { return m_previousPoses[index]; }
+    bool IsActive(uint32_t index) const { return m_active[index] != 0; }
+    void SetActive(uint32_t index, bool active) {
+        uint8_t value = active ? 1 : 0;
+        if (m_active[index] != value) {
+            m_active[index] = value;
+            m_shadowDirty[index] = 1;  // Joins or leaves the shadow casters, see Scene::SyncShadowCasters
+        }
+    }
+
+    // Cached world matrix + bounding sphere radius per slot, only rebuilt while the dirty flag is set.
+    // Anything that writes a transform (or the shape) outside Entity::GetTransform has to mark it.
+    void MarkTransformDirty(uint32_t index) {
+        m_transformDirty[index] = 1;
+        m_spatialDirty[index] = 1;
+        m_shadowDirty[index] = 1;
+    }
+    bool IsTransformDirty(uint32_t index) const { return m_transformDirty[index] != 0; }
+    void SetWorldCache(uint32_t index, const glm::mat4& world, float radius) {
+        m_worldMatrices[index] = world;
+        if (m_worldRadii[index] != radius) {
+            m_worldRadii[index] = radius;
+            m_spatialDirty[index] = 1;  // The SpatialIndex takes its radius from here
+        }
+        m_transformDirty[index] = 0;
+    }
+    const glm::mat4& GetWorldMatrix(uint32_t index) const { return m_worldMatrices[index]; }
+    float GetWorldRadius(uint32_t index) const { return m_worldRadii[index]; }
+
+    // Second copy of the dirty flag for the SpatialIndex. The renderer only clears its flag for what it
+    // draws, and on its own schedule, so the index keeps track separately.
+    bool IsSpatialDirty(uint32_t index) const { return m_spatialDirty[index] != 0; }
+    void ClearSpatialDirty(uint32_t index) { m_spatialDirty[index] = 0; }
+
+    // And a third for the shadow caster sync, which decides what counts as static geometry
+    bool IsShadowDirty(uint32_t index) const { return m_shadowDirty[index] != 0; }
+    void ClearShadowDirty(uint32_t index) { m_shadowDirty[index] = 0; }
+    const std::vector<uint8_t>& GetShadowDirtyFlags() const { return m_shadowDirty; }
+
+    // Whole arrays for the batch loops
+    std::vector<Transform>& GetTransforms() { return m_transforms; }
+    const std::vector<Transform>& GetTransforms() const { return m_transforms; }
+    std::vector<RenderComponent>& GetRenderComponents() { return m_render; }
+    const std::vector<RenderComponent>& GetRenderComponents() const { return m_render; }
+    std::vector<PhysicsComponent>& GetPhysicsComponents() { return m_physics; }
+    const std::vector<PhysicsComponent>& GetPhysicsComponents() const { return m_physics; }
+    std::vector<BodyPose>& GetPreviousPoses() { return m_previousPoses; }
+    const std::vector<BodyPose>& GetPreviousPoses() const { return m_previousPoses; }
+    const std::vector<uint8_t>& GetActiveFlags() const { return m_active; }
+    const std::vector<uint8_t>& GetTransformDirtyFlags() const { return m_transformDirty; }
+
+  private:
+    std::vector<Transform> m_transforms;
+    std::vector<RenderComponent> m_render;
+    std::vector<PhysicsComponent> m_physics;
+    std::vector<BodyPose> m_previousPoses;
+    std::vector<uint8_t> m_active;  // Not vector<bool>, we want plain bytes
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<float> m_worldRadii;
+    std::vector<uint8_t> m_transformDirty;  // Bytes here too, render chunks write their own slots in parallel
+    std::vector<uint8_t> m_spatialDirty;
+    std::vector<uint8_t> m_shadowDirty;
+};
+
+}  // namespace Blacksite
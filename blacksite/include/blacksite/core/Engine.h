@@ -1,6 +1,10 @@
 #pragma once
 #include <functional>
 #include <memory>
+#include "blacksite/core/FrameArena.h"
+#include "blacksite/core/FrameCapture.h"
+#include "blacksite/core/FramePacer.h"
+#include "blacksite/core/JobSystem.h"
 #include "blacksite/core/Window.h"
 #include "blacksite/graphics/Renderer.h"
 #include "blacksite/graphics/ShaderSystem.h"
@@ -21,6 +25,33 @@ class Engine {
     void Shutdown();
     bool IsRunning() const { return m_running; }
 
+    // Call before Initialize, the physics limits are fixed once the system is up
+    void SetPhysicsConfig(const PhysicsConfig& config) { m_physicsConfig = config; }
+
+    // Worker threads for the shared JobSystem (physics included), before Initialize. -1 = hardware threads - 1.
+    void SetJobThreads(int count) { m_jobThreads = count; }
+
+    // Starting size of each of the two FrameArena buffers, before Initialize. They grow if a frame needs more.
+    void SetFrameArenaSize(size_t bytes) { m_frameArenaSize = bytes; }
+
+    // Hidden window, no vsync and no renderer diagnostics, before Initialize. For benchmarks and tools -
+    // it still needs a GL driver (Xvfb or a software one does on a machine without a display).
+    void SetOffscreen(bool offscreen) { m_offscreen = offscreen; }
+    bool IsOffscreen() const { return m_offscreen; }
+
+    // Vsync, frame cap, fixed update rate and idle throttling. Works before or after Initialize,
+    // offscreen engines ignore it. See FramePacingConfig.
+    void SetFramePacing(const FramePacingConfig& config);
+    const FramePacingConfig& GetFramePacing() const { return m_framePacingConfig; }
+    FramePacer* GetFramePacer() { return m_framePacer.get(); }
+
+    // Step physics on its own thread while the frame renders, see PhysicsSystem::SetThreadedStepping.
+    // Needs an initialized engine. Render callbacks must leave the physics bodies alone.
+    void SetThreadedPhysics(bool enabled) {
+        if (m_physicsSystem)
+            m_physicsSystem->SetThreadedStepping(enabled);
+    }
+
     // --- Game Code Interface ---
     using UpdateCallback = std::function<void(Engine& engine, float deltaTime)>;
     void SetUpdateCallback(UpdateCallback callback);
@@ -58,10 +89,15 @@ class Engine {
                    const glm::vec3& color = glm::vec3(1.0f));
 
     // Generic spawn method
+    // Mesh from Renderer::LoadMesh, by the name it was loaded under
+    int SpawnMesh(const std::string& mesh, const glm::vec3& position, const std::string& shader = "basic",
+                  const glm::vec3& color = glm::vec3(1.0f));
+
     int SpawnEntity(Entity::VisualShape shape, const glm::vec3& position, const std::string& shader = "basic",
                     const glm::vec3& color = glm::vec3(1.0f));
 
     EntityHandle GetEntity(int id);
+    EntityEditBatch EditEntities();  // Transform edits to many entities, committed to physics together
 
     // --- Convenience Camera API (delegates to active scene via SceneSystem) ---
     void SetCameraPosition(const glm::vec3& position);
@@ -69,11 +105,27 @@ class Engine {
     glm::vec3 GetCameraPosition() const;
     glm::vec3 GetCameraTarget() const;
 
-    // Single frame update/render for external main loops.
-    void UpdateFrame(float deltaTime);
+    // --- Profiling ---
+    // GPU time per render pass ("scene", "bloom_downsample", ...), a few frames behind. Empty until then.
+    std::vector<GpuZoneTiming> GetGpuTimings() const;
+    void SetGpuProfilingEnabled(bool enabled);
+
+    // --- Frame Capture ---
+    // Records the active scene from here on, see FrameCapture. path gets the log, path + ".bscn" the starting scene.
+    bool StartCapture(const std::string& path);
+    // Plays a capture back into the active scene. standalone = no game code, load the capture's scene instead.
+    bool StartReplay(const std::string& path, bool standalone = false);
+    void StopCapture();
+    FrameCapture* GetFrameCapture() { return m_frameCapture.get(); }
+
+    // Single frame update/render for external main loops. Game code that spawns or reads input goes in
+    // gameUpdate, so a capture sees it as part of the frame and a replay hands it the recorded deltaTime.
+    void UpdateFrame(float deltaTime, const UpdateCallback& gameUpdate = {});
     void RenderFrame();
 
     // --- Core System Access ---
+    JobSystem* GetJobSystem() { return m_jobSystem.get(); }
+    FrameArena* GetFrameArena() { return m_frameArena.get(); }
     InputSystem* GetInputSystem() { return m_inputSystem.get(); }
     PhysicsSystem* GetPhysicsSystem() { return m_physicsSystem.get(); }
     Renderer* GetRenderer() { return m_renderer.get(); }
@@ -83,22 +135,39 @@ class Engine {
 
   private:
     // --- Core Systems ---
+    std::unique_ptr<JobSystem> m_jobSystem;
+    std::unique_ptr<FrameArena> m_frameArena;
     std::unique_ptr<Window> m_window;
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<PhysicsSystem> m_physicsSystem;
     std::unique_ptr<InputSystem> m_inputSystem;
     std::unique_ptr<SceneSystem> m_sceneSystem;
     std::unique_ptr<ShaderSystem> m_shaderSystem;
+    std::unique_ptr<FrameCapture> m_frameCapture;
+    std::unique_ptr<FramePacer> m_framePacer;
 
     // --- Engine State ---
     UpdateCallback m_updateCallback;
+    PhysicsConfig m_physicsConfig;
+    FramePacingConfig m_framePacingConfig;
+    int m_jobThreads = -1;
+    size_t m_frameArenaSize = FrameArena::DEFAULT_SIZE;
+    bool m_offscreen = false;
     bool m_running = false;
     bool m_initialized = false;
 
+    // What TrackActivity saw last frame, a difference means the frame changed something
+    Scene* m_lastActiveScene = nullptr;
+    uint64_t m_lastEntityVersion = 0;
+    glm::vec3 m_lastCameraPosition{0.0f};
+    glm::vec3 m_lastCameraTarget{0.0f};
+
     // --- Internal Methods ---
     void Update(float deltaTime);
     void Render();
     void HandleInput();
+    bool BeginCaptureFrame(float& deltaTime);  // Input sampling + capture, false once a replay ran out
+    void TrackActivity();                      // Tells the frame pacer whether the scene is still changing
 };
 
 }  // namespace Blacksite
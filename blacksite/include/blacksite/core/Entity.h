@@ -1,32 +1,39 @@
 #pragma once
-#include <blacksite/physics/JoltConfig.h>
-#include <Jolt/Physics/Body/BodyID.h>
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
 // #include <nlohmann/json.hpp>
+#include "blacksite/core/ComponentStore.h"
+#include "blacksite/core/Prefab.h"
 #include "blacksite/math/Transform.h"
 #include "blacksite/physics/Collider.h"
 
 namespace Blacksite {
 
+class EntityCommandBuffer;
+class EntitySystem;
+
 class Entity {
 public:
-    int id = -1;
+    int id = -1;  // Generational (slot index + generation), see EntitySystem
     std::string name;
-    bool active = true;
-    Transform transform;
 
-    // Visual properties
-    enum VisualShape { CUBE, SPHERE, PLANE } shape = CUBE;
+    // Visual properties - shape, color and the cached shader handle live in the RenderComponent
+    using VisualShape = EntityShape::VisualShape;
+    static constexpr VisualShape CUBE = EntityShape::CUBE;
+    static constexpr VisualShape SPHERE = EntityShape::SPHERE;
+    static constexpr VisualShape PLANE = EntityShape::PLANE;
+    static constexpr VisualShape MESH = EntityShape::MESH;
     std::string shader{"basic"};
-    glm::vec3 color{1.0f, 1.0f, 1.0f};
+    std::string mesh;  // Name given to Renderer::LoadMesh, only used by MESH entities
+    std::string texture;  // Name given to Renderer::LoadTexture, empty = untextured
+
+    // Physics - body link is in the PhysicsComponent, collider descriptions stay here.
+    // Shared with the prefab / other copies until written to.
+    ColliderSet colliders;
 
-    // Physics
-    bool hasPhysics = false;
-    bool isDynamic = true;
-    JPH::BodyID physicsBody;
-    std::vector<Collider> colliders;
+    // What this was instantiated from, null for entities spawned the regular way
+    PrefabRef prefab;
 
     // Space management
     enum class Space {
@@ -39,10 +46,53 @@ public:
 
     // Constructors
     Entity() = default;
-    Entity(VisualShape s) : shape(s) {}
-    Entity(VisualShape s, const std::string& shaderName) : shape(s), shader(shaderName) {}
+    Entity(VisualShape s) { m_stagedRender.shape = s; }
+    Entity(VisualShape s, const std::string& shaderName) : shader(shaderName) { m_stagedRender.shape = s; }
     virtual ~Entity() = default;
 
+    // Hot data - points into the EntitySystem's ComponentStore once spawned, before that into a local copy.
+    // Handing out a writable transform marks it dirty, so the cached world matrix gets rebuilt.
+    Transform& GetTransform() {
+        MarkTransformDirty();
+        return m_store ? m_store->GetTransform(m_index) : m_stagedTransform;
+    }
+    const Transform& GetTransform() const { return m_store ? m_store->GetTransform(m_index) : m_stagedTransform; }
+    RenderComponent& GetRender() { return m_store ? m_store->GetRender(m_index) : m_stagedRender; }
+    const RenderComponent& GetRender() const { return m_store ? m_store->GetRender(m_index) : m_stagedRender; }
+    PhysicsComponent& GetPhysics() { return m_store ? m_store->GetPhysics(m_index) : m_stagedPhysics; }
+    const PhysicsComponent& GetPhysics() const { return m_store ? m_store->GetPhysics(m_index) : m_stagedPhysics; }
+    bool IsActive() const { return m_store ? m_store->IsActive(m_index) : m_stagedActive; }
+    void MarkTransformDirty() {
+        if (m_store)
+            m_store->MarkTransformDirty(m_index);
+    }
+    void SetActive(bool active);  // Bumps the EntitySystem version when it actually changes
+
+    // Changes the shader and drops the cached handle so the renderer resolves it again
+    void SetShader(const std::string& shaderName) {
+        shader = shaderName;
+        GetRender().shaderHandle = ShaderHandle{};
+    }
+
+    // Same idea for the mesh. The bounding radius comes from the mesh, so the world cache goes stale too.
+    void SetMesh(const std::string& meshName) {
+        mesh = meshName;
+        GetRender().meshHandle = MeshHandle{};
+        MarkTransformDirty();
+    }
+
+    // And the texture, empty to go back to untextured
+    void SetTexture(const std::string& textureName) {
+        texture = textureName;
+        GetRender().textureHandle = TextureHandle{};
+        GetRender().hasTexture = !textureName.empty();
+    }
+
+    // Shadow this with true in a subclass whose Update only touches its own entity (and reads nothing other
+    // entities write). Those types get updated in parallel chunks, before everything else, and have to go
+    // through Commands() for spawns, removals and physics instead of calling into the systems.
+    static constexpr bool PARALLEL_UPDATE = false;
+
     // Virtual methods for custom behavior
     virtual void OnSpawn() {}
     virtual void Update(float deltaTime) {}
@@ -53,6 +103,37 @@ public:
     // virtual void Serialize(nlohmann::json& data) const {}
     // virtual void Deserialize(const nlohmann::json& data) {}
     virtual std::string GetTypeName() const { return "Entity"; }
+
+protected:
+    // Queue for changes that can't happen mid-update, applied by the EntitySystem after the update phase.
+    // Each parallel chunk gets its own, so it's safe from any Update. Only valid once spawned.
+    EntityCommandBuffer& Commands();
+
+private:
+    friend class EntitySystem;
+    template <typename T>
+    friend class TypedEntityPool;
+
+    // Moves the staged values into slot 'index' of the store, from then on accessors read the store
+    void AttachToStore(ComponentStore* store, uint32_t index) {
+        store->GetTransform(index) = m_stagedTransform;
+        store->GetRender(index) = m_stagedRender;
+        store->GetPhysics(index) = m_stagedPhysics;
+        store->SetActive(index, m_stagedActive);
+        store->MarkTransformDirty(index);
+        m_store = store;
+        m_index = index;
+    }
+
+    ComponentStore* m_store = nullptr;
+    EntitySystem* m_system = nullptr;
+    uint32_t m_index = 0;
+    uint32_t m_poolIndex = 0;  // Where the owning TypedEntityPool put us
+
+    Transform m_stagedTransform;
+    RenderComponent m_stagedRender;
+    PhysicsComponent m_stagedPhysics;
+    bool m_stagedActive = true;
 };
 
 }  // namespace Blacksite
@@ -0,0 +1,47 @@
+#pragma once
+#include <functional>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include "blacksite/core/ComponentStore.h"
+
+namespace Blacksite {
+
+class EntitySystem;
+
+/**
+ * EntityCommandBuffer - Structural changes recorded now, applied later on the main thread
+ * Parallel entity updates can't spawn, remove or touch physics directly, so they queue it here
+ * (Entity::Commands()) and EntitySystem applies every buffer once the update phase is over.
+ * Commands run in the order they were queued, removals after all of them.
+ */
+class EntityCommandBuffer {
+  public:
+    using Command = std::function<void(EntitySystem& entities)>;
+
+    void Remove(int id) { m_removals.push_back(id); }
+    void Defer(Command command) { m_commands.push_back(std::move(command)); }
+
+    void Spawn(EntityShape::VisualShape shape, const glm::vec3& position, const std::string& shader = "basic",
+               const glm::vec3& color = glm::vec3(1.0f));
+
+    // Same as the EntityHandle calls on entity 'id', skipped if it's gone by then
+    void Push(int id, const glm::vec3& force);
+    void Impulse(int id, const glm::vec3& impulse);
+    void SetVelocity(int id, const glm::vec3& velocity);
+    void SetActive(int id, bool active);
+
+    bool IsEmpty() const { return m_commands.empty() && m_removals.empty(); }
+    size_t GetSize() const { return m_commands.size() + m_removals.size(); }
+
+    // Runs and clears everything. Commands queued while applying land in whatever buffer is current
+    // then, not this one.
+    void Apply(EntitySystem& entities);
+    void Clear();
+
+  private:
+    std::vector<Command> m_commands;
+    std::vector<int> m_removals;
+};
+
+}  // namespace Blacksite
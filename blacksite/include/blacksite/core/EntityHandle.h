@@ -1,5 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include "blacksite/physics/PhysicsLayers.h"
 
 namespace Blacksite {
 
@@ -7,6 +11,77 @@ namespace Blacksite {
 class EntitySystem;
 class PhysicsSystem;
 class Entity;
+class EntityEditBatch;
+
+/**
+ * EntityEdit - Transform changes collected and applied in one go
+ * At/Rotate/Scale only record. Commit (or the destructor) looks the entity up once, writes the transform and
+ * syncs the body with one SetPositionAndRotation plus at most one shape swap, instead of a lookup and a
+ * physics call per setter. Inside an EntityEditBatch the body pose is left to the batch.
+ *
+ *     engine.GetEntity(id).Edit().At(p).Rotate(r).Scale(s);  // Commits at the semicolon
+ */
+class EntityEdit {
+  public:
+    EntityEdit(EntitySystem* entitySystem, PhysicsSystem* physicsSystem, int id, EntityEditBatch* batch = nullptr);
+    ~EntityEdit() { Commit(); }
+    EntityEdit(EntityEdit&& other) noexcept;  // other is left with nothing to commit
+    EntityEdit(const EntityEdit&) = delete;
+    EntityEdit& operator=(const EntityEdit&) = delete;
+    EntityEdit& operator=(EntityEdit&&) = delete;
+
+    EntityEdit& At(const glm::vec3& position);
+    EntityEdit& At(float x, float y, float z) { return At(glm::vec3(x, y, z)); }
+    EntityEdit& Rotate(const glm::vec3& rotation);  // Euler degrees
+    EntityEdit& Rotate(const glm::quat& rotation);
+    EntityEdit& Scale(const glm::vec3& scale);
+    EntityEdit& Scale(float x, float y, float z) { return Scale(glm::vec3(x, y, z)); }
+    EntityEdit& Scale(float uniformScale) { return Scale(glm::vec3(uniformScale)); }
+
+    void Commit();  // No-op when nothing was set since the last one
+    void Cancel() { m_changes = 0; }
+    bool HasChanges() const { return m_changes != 0; }
+    int GetId() const { return m_id; }
+
+  private:
+    enum Change : uint8_t { POSITION = 1, ROTATION = 2, SCALE = 4 };
+
+    EntitySystem* m_entitySystem;
+    PhysicsSystem* m_physicsSystem;
+    EntityEditBatch* m_batch;
+    int m_id;
+    uint8_t m_changes = 0;
+    glm::vec3 m_position{0.0f};
+    glm::quat m_rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 m_scale{1.0f};
+};
+
+/**
+ * EntityEditBatch - Edits to many entities, one physics pass
+ * Every Edit(id) commits its transform (and shape, when scaled) as usual, but the body poses wait for the
+ * batch's Commit and go to PhysicsSystem::SetBodyTransforms together - one flush, no per-body locking.
+ * For multi-select drags and scripted formations. Commits on destruction too, so edits must not outlive it.
+ * Main thread, and not while a threaded physics step is in flight.
+ */
+class EntityEditBatch {
+  public:
+    EntityEditBatch(EntitySystem* entitySystem, PhysicsSystem* physicsSystem);
+    ~EntityEditBatch() { Commit(); }
+    EntityEditBatch(const EntityEditBatch&) = delete;
+    EntityEditBatch& operator=(const EntityEditBatch&) = delete;
+
+    EntityEdit Edit(int id) { return EntityEdit(m_entitySystem, m_physicsSystem, id, this); }
+    void Commit();
+    size_t GetPendingCount() const { return m_pending.size(); }
+
+  private:
+    friend class EntityEdit;
+
+    EntitySystem* m_entitySystem;
+    PhysicsSystem* m_physicsSystem;
+    std::vector<int> m_pending;       // Entities whose body is behind their transform
+    std::vector<Entity*> m_entities;  // Commit's scratch
+};
 
 class EntityHandle {
   public:
@@ -15,11 +90,16 @@ class EntityHandle {
     // Transform manipulation
     EntityHandle& At(const glm::vec3& position);
     EntityHandle& At(float x, float y, float z);
-    EntityHandle& Rotate(const glm::vec3& rotation);
+    EntityHandle& Rotate(const glm::vec3& rotation);  // Euler degrees
+    EntityHandle& Rotate(const glm::quat& rotation);
     EntityHandle& Scale(const glm::vec3& scale);
     EntityHandle& Scale(float x, float y, float z);
     EntityHandle& Scale(float uniformScale);
 
+    // Collects At/Rotate/Scale and applies them together, see EntityEdit. The setters above each sync
+    // physics on their own.
+    EntityEdit Edit() { return EntityEdit(m_entitySystem, m_physicsSystem, m_id); }
+
     // Physics operations
     EntityHandle& Push(const glm::vec3& force);
     EntityHandle& Impulse(const glm::vec3& impulse);
@@ -27,6 +107,7 @@ class EntityHandle {
     EntityHandle& SetAngularVelocity(const glm::vec3& angularVel);
     EntityHandle& MakeStatic();
     EntityHandle& MakeDynamic();
+    EntityHandle& SetLayer(PhysicsLayer layer);  // PhysicsSystem::FindLayer("name") for the index
     void RecreatePhysicsBodyWithScale(Entity& entity, const glm::vec3& scale);
 
     // Appearance
@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "blacksite/core/Entity.h"
+#include "blacksite/core/MemoryTracker.h"
+
+namespace Blacksite {
+
+// Per-slot update plan, see SimulationLod. Slots past 'size' update every frame with the frame's deltaTime.
+struct UpdateSchedule {
+    const uint8_t* due = nullptr;       // 0 = skip this frame
+    const float* deltaTimes = nullptr;  // Time since the entity's last update, instead of the frame's
+    size_t size = 0;
+};
+
+/**
+ * EntityPool - Storage for one concrete entity type
+ * EntitySystem keeps one pool per type it has spawned, so objects are stored as their real type
+ * (no slicing) and updates run type by type instead of bouncing through the vtable per object.
+ */
+class EntityPool {
+  public:
+    virtual ~EntityPool() = default;
+
+    virtual void Destroy(Entity* entity) = 0;
+    // Calls Update on every live, active entity - or the ones the schedule says are due, if there is one
+    virtual void UpdateAll(float deltaTime, const UpdateSchedule* schedule) = 0;
+    virtual size_t GetLiveCount() const = 0;
+
+    // For the parallel update phase: the type's PARALLEL_UPDATE flag, and Update over blocks [begin, end)
+    // only. The block count can't change while that runs - parallel types spawn through command buffers.
+    virtual bool IsParallelUpdate() const = 0;
+    virtual size_t GetBlockCount() const = 0;
+    virtual void UpdateBlocks(float deltaTime, const UpdateSchedule* schedule, size_t begin, size_t end) = 0;
+};
+
+template <typename T>
+class TypedEntityPool final : public EntityPool {
+    static_assert(std::is_base_of_v<Entity, T>, "T must derive from Entity");
+
+  public:
+    // Objects are placed in fixed-size blocks so their addresses never move
+    static constexpr uint32_t BLOCK_SIZE = 64;
+
+    TypedEntityPool() = default;
+    TypedEntityPool(const TypedEntityPool&) = delete;
+    TypedEntityPool& operator=(const TypedEntityPool&) = delete;
+
+    ~TypedEntityPool() override {
+        for (auto& block : m_blocks) {
+            for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+                if (block->live[i]) {
+                    block->Get(i)->~T();
+                }
+            }
+        }
+    }
+
+    template <typename... Args>
+    T* Create(Args&&... args) {
+        if (m_freeList.empty()) {
+            AddBlock();
+        }
+
+        uint32_t poolIndex = m_freeList.back();
+        m_freeList.pop_back();
+
+        Block& block = *m_blocks[poolIndex / BLOCK_SIZE];
+        uint32_t local = poolIndex % BLOCK_SIZE;
+        T* entity = new (block.Address(local)) T(std::forward<Args>(args)...);
+        block.live[local] = true;
+        entity->m_poolIndex = poolIndex;
+        m_liveCount++;
+        return entity;
+    }
+
+    void Destroy(Entity* entity) override {
+        uint32_t poolIndex = entity->m_poolIndex;
+        Block& block = *m_blocks[poolIndex / BLOCK_SIZE];
+        uint32_t local = poolIndex % BLOCK_SIZE;
+
+        static_cast<T*>(entity)->~T();
+        block.live[local] = false;
+        m_freeList.push_back(poolIndex);
+        m_liveCount--;
+    }
+
+    void UpdateAll(float deltaTime, const UpdateSchedule* schedule) override {
+        // Index loop - Update may spawn more of this type, which can add blocks
+        for (size_t b = 0; b < m_blocks.size(); ++b) {
+            UpdateBlock(*m_blocks[b], deltaTime, schedule);
+        }
+    }
+
+    void UpdateBlocks(float deltaTime, const UpdateSchedule* schedule, size_t begin, size_t end) override {
+        for (size_t b = begin; b < end; ++b) {
+            UpdateBlock(*m_blocks[b], deltaTime, schedule);
+        }
+    }
+
+    size_t GetLiveCount() const override { return m_liveCount; }
+    bool IsParallelUpdate() const override { return T::PARALLEL_UPDATE; }
+    size_t GetBlockCount() const override { return m_blocks.size(); }
+
+  private:
+    struct Block {
+        alignas(T) unsigned char storage[sizeof(T) * BLOCK_SIZE];
+        bool live[BLOCK_SIZE] = {};
+
+        void* Address(uint32_t i) { return storage + sizeof(T) * i; }
+        T* Get(uint32_t i) { return std::launder(reinterpret_cast<T*>(Address(i))); }
+    };
+    static_assert(std::is_trivially_destructible_v<Block>, "Blocks are freed without running a destructor");
+
+    static void UpdateBlock(Block& block, float deltaTime, const UpdateSchedule* schedule) {
+        for (uint32_t i = 0; i < BLOCK_SIZE; ++i) {
+            if (!block.live[i])
+                continue;
+
+            T* entity = block.Get(i);
+            if (!entity->IsActive())
+                continue;
+
+            float entityDelta = deltaTime;
+            if (schedule && entity->m_index < schedule->size) {
+                if (!schedule->due[entity->m_index])
+                    continue;
+                entityDelta = schedule->deltaTimes[entity->m_index];
+            }
+
+            // We know the exact type here, so skip the vtable
+            entity->T::Update(entityDelta);
+        }
+    }
+
+    void AddBlock() {
+        uint32_t base = static_cast<uint32_t>(m_blocks.size()) * BLOCK_SIZE;
+        void* memory = MemoryTracker::Allocate(sizeof(Block), MemoryTag::Entities, alignof(Block));
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+        m_blocks.emplace_back(new (memory) Block());
+
+        // Reverse so the lowest index comes off the back first
+        for (uint32_t i = BLOCK_SIZE; i > 0; --i) {
+            m_freeList.push_back(base + i - 1);
+        }
+    }
+
+    std::vector<std::unique_ptr<Block, TrackedDelete>> m_blocks;
+    std::vector<uint32_t> m_freeList;
+    size_t m_liveCount = 0;
+};
+
+}  // namespace Blacksite
@@ -1,14 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
 #include <vector>
+#include "blacksite/core/ComponentStore.h"
 #include "blacksite/core/Entity.h"
+#include "blacksite/core/EntityCommandBuffer.h"
 #include "blacksite/core/EntityHandle.h"
+#include "blacksite/core/EntityPool.h"
+#include "blacksite/physics/CollisionEvent.h"
 
 namespace Blacksite {
 
+class FrameCapture;
 class PhysicsSystem;
 
 class EntitySystem {
@@ -17,6 +27,7 @@ class EntitySystem {
     ~EntitySystem();
 
     void SetPhysicsSystem(PhysicsSystem* physics) { m_physicsSystem = physics; }
+    void SetFrameCapture(FrameCapture* capture) { m_capture = capture; }  // Spawns/removes get reported to it
 
     // Default shader versions (backward compatible)
     int SpawnCube(const glm::vec3& position);
@@ -29,56 +40,186 @@ class EntitySystem {
     int SpawnPlane(const glm::vec3& position, const glm::vec3& size, const std::string& shader,
                    const glm::vec3& color = glm::vec3(1.0f));
 
+    // Loaded mesh (Renderer::LoadMesh name). Static, with a unit box collider until you give it colliders.
+    int SpawnMesh(const std::string& mesh, const glm::vec3& position, const std::string& shader = "basic",
+                  const glm::vec3& color = glm::vec3(1.0f));
+
     // Generic spawn method
     int SpawnEntity(Entity::VisualShape shape, const glm::vec3& position, const std::string& shader = "basic",
                     const glm::vec3& color = glm::vec3(1.0f));
 
+    // Level-load path: one entity per position, all physics bodies inserted together.
+    // shapes/colors can be empty (cube/white) or have one entry per position. Default names are
+    // not built here, GetEntityName makes them on demand. Returns how many were spawned.
+    size_t SpawnBatch(const std::vector<glm::vec3>& positions, const std::vector<Entity::VisualShape>& shapes,
+                      const std::vector<glm::vec3>& colors, const std::string& shader = "basic",
+                      std::vector<int>* outIds = nullptr);
+
+    // The general form: setup(i, entity) fills in each plain Entity before it gets a slot - transform, render,
+    // shader/mesh names, colliders. Ones left with GetPhysics().hasPhysics set get their bodies in one batch.
+    using BatchSetup = std::function<void(size_t index, Entity& entity)>;
+    size_t SpawnBatch(size_t count, const BatchSetup& setup, std::vector<int>* outIds = nullptr);
+
+    // Makes room for 'count' more entities so big spawns don't regrow storage over and over
+    void Reserve(size_t count);
+
     void RemoveEntity(int id);
-    void DuplicateEntity(int id);
+    void DuplicateEntity(int id);  // Copies the entity's data straight over, colliders stay shared until edited
     void Clear();
 
+    // --- Prefabs ---
+    // Registered by name, replacing an older one of that name for future instances. Empty colliders get the
+    // shape's default here so every instance shares them.
+    PrefabRef RegisterPrefab(Prefab prefab);
+    PrefabRef CreatePrefabFromEntity(int id, const std::string& name);  // Snapshot of a live entity
+    PrefabRef GetPrefab(const std::string& name) const;                 // nullptr if there's none
+    const std::unordered_map<std::string, PrefabRef>& GetPrefabs() const { return m_prefabs; }
+
+    // Instances copy nothing but a couple of names and two shared pointers, the position is theirs.
+    // Goes through SpawnBatch, so a batch's bodies enter the broadphase together. -1 / 0 on failure.
+    int Instantiate(const PrefabRef& prefab, const glm::vec3& position);
+    size_t InstantiateBatch(const PrefabRef& prefab, const std::vector<glm::vec3>& positions,
+                            std::vector<int>* outIds = nullptr);
+
     // Shader and color management methods
     void SetEntityShader(int id, const std::string& shader);
     void SetEntityColor(int id, const glm::vec3& color);
+    void SetEntityTexture(int id, const std::string& texture);  // Name from Renderer::LoadTexture, empty = none
     std::string GetEntityShader(int id) const;
     glm::vec3 GetEntityColor(int id) const;
 
     void SetEntityName(int id, const std::string& name);
     std::string GetEntityName(int id) const;
 
-    Entity* GetEntityPtr(int id);
-    bool IsValidEntity(int id) const;
-
-    const std::vector<Entity>& GetEntities() const { return m_entities; }
-    std::vector<Entity>& GetEntities() { return m_entities; }
+    // Entity ids pack a slot index (low bits) and a generation (high bits). Removing an entity bumps
+    // its slot's generation, so stale ids don't resolve to whatever spawned into the slot next.
+    static constexpr int ID_INDEX_BITS = 20;
+    static constexpr uint32_t ID_INDEX_MASK = (1u << ID_INDEX_BITS) - 1;
+    static constexpr uint32_t ID_GENERATION_MASK = 0x7FF;  // 11 bits, keeps ids positive
+    static uint32_t GetIdIndex(int id) { return static_cast<uint32_t>(id) & ID_INDEX_MASK; }
+    static uint32_t GetIdGeneration(int id) { return (static_cast<uint32_t>(id) >> ID_INDEX_BITS) & ID_GENERATION_MASK; }
+    // Id of whatever lives in an alive slot, without touching the Entity
+    int GetSlotId(uint32_t slot) const { return static_cast<int>((m_generations[slot] << ID_INDEX_BITS) | slot); }
+
+    Entity* GetEntityPtr(int id);      // nullptr for removed/stale ids
+    bool IsAlive(int id) const;        // Spawned and not removed (may still be inactive)
+    bool IsValidEntity(int id) const;  // Alive and active
+
+    // Entity objects (names, shaders, colliders, behaviour) by slot - they live in per-type pools.
+    // Free slots are nullptr, use GetAliveSlots() to walk only live entities.
+    const std::vector<Entity*>& GetEntities() const { return m_entities; }
+
+    // Runs Update on every active entity, one pool (= one concrete type) at a time. Types with
+    // PARALLEL_UPDATE go first, their blocks split across the JobSystem, and their command buffers are
+    // applied in chunk order before the serial types run - so results don't depend on thread timing.
+    // Removals requested from inside Update are deferred until every pool is done.
+    // With a schedule only the entities it marks due get updated, each with its own deltaTime.
+    void UpdateEntities(float deltaTime, const UpdateSchedule* schedule = nullptr);
+
+    // Off runs PARALLEL_UPDATE types serially too (same order, same command buffers), handy for debugging
+    void SetParallelUpdateEnabled(bool enabled) { m_parallelUpdate = enabled; }
+    bool IsParallelUpdateEnabled() const { return m_parallelUpdate; }
+
+    // The calling thread's buffer: its chunk's during the parallel phase, the shared one otherwise.
+    // Whatever is in the shared one gets applied at the end of UpdateEntities and DispatchCollisions.
+    EntityCommandBuffer& GetCommandBuffer();
+
+    // Calls OnCollision on both entities of every event. Events for entities that are gone (or get
+    // removed by an earlier callback) are skipped, removals from inside OnCollision are deferred.
+    void DispatchCollisions(const std::vector<CollisionEvent>& events);
+
+    // Hot per-entity data as parallel arrays, same indices as GetEntities()
+    const ComponentStore& GetComponents() const { return m_components; }
+    ComponentStore& GetComponents() { return m_components; }
+
+    // Dense list of occupied slots, unordered
+    const std::vector<uint32_t>& GetAliveSlots() const { return m_aliveSlots; }
+    size_t GetAliveCount() const { return m_aliveSlots.size(); }
+
+    // Goes up whenever an entity is added, removed, renamed or toggled (Entity::SetActive).
+    // Lets views like the editor hierarchy keep a cached list and only rebuild when something changed.
+    // Atomic because entities can toggle themselves from parallel update chunks.
+    uint64_t GetVersion() const { return m_version.load(std::memory_order_relaxed); }
+    void MarkChanged() { m_version.fetch_add(1, std::memory_order_relaxed); }
     EntityHandle GetEntityHandle(int id) { return EntityHandle(this, m_physicsSystem, id); }
 
   private:
-    std::vector<Entity> m_entities;
+    template <typename T>
+    TypedEntityPool<T>& GetPool() {
+        auto it = m_poolLookup.find(std::type_index(typeid(T)));
+        if (it != m_poolLookup.end()) {
+            return static_cast<TypedEntityPool<T>&>(*it->second);
+        }
+
+        auto pool = std::make_unique<TypedEntityPool<T>>();
+        TypedEntityPool<T>& result = *pool;
+        m_poolLookup.emplace(std::type_index(typeid(T)), pool.get());
+        m_pools.push_back(std::move(pool));
+        return result;
+    }
+
+    // Gives a freshly pooled entity a slot (free list first) and moves its staged components into the store.
+    // Hands the entity back to its pool and returns nullptr if we ran out of slots.
+    Entity* RegisterEntity(Entity* entity, EntityPool* pool);
+    Entity* StoreEntity(const Entity& entity);  // Plain Entity, copied into the base pool
+    void ReleaseSlot(uint32_t index);
+    void TrackMemory();  // Reports slot array growth to MemoryTracker under Entities
+    void ReportUncapturedSpawn();  // Spawn<T> goes through here, FrameCapture stays out of the header
+
+    static constexpr uint32_t NOT_ALIVE = 0xFFFFFFFF;
+
+    std::vector<std::unique_ptr<EntityPool>> m_pools;  // Update order = first-spawn order of each type
+    std::unordered_map<std::type_index, EntityPool*> m_poolLookup;
+
+    std::vector<Entity*> m_entities;
+    std::vector<EntityPool*> m_slotPools;    // Which pool owns each slot's entity
+    ComponentStore m_components;
+    std::vector<uint32_t> m_generations;     // Per slot, bumped on removal
+    std::vector<uint32_t> m_freeSlots;       // Recycled before we grow
+    std::vector<uint32_t> m_aliveSlots;      // Dense, drives iteration
+    std::vector<uint32_t> m_alivePositions;  // Slot -> position in m_aliveSlots, NOT_ALIVE if free
     std::vector<std::string> m_entityNames;
+    std::unordered_map<std::string, PrefabRef> m_prefabs;
     PhysicsSystem* m_physicsSystem = nullptr;
-    int m_nextEntityId = 0;
+    FrameCapture* m_capture = nullptr;
+    bool m_capturingBatch = false;  // The positions SpawnBatch reports itself, not the general one under it
+    int m_spawnCounter = 0;  // Only used for default names
+    std::atomic<uint64_t> m_version{0};
+    size_t m_trackedBytes = 0;  // What we last reported to MemoryTracker
+
+    bool m_updatingEntities = false;
+    std::vector<int> m_pendingRemovals;
+
+    // Parallel update phase, all reused frame to frame
+    static constexpr size_t PARALLEL_MIN_BLOCKS = 4;  // Per chunk, 256 entities
+    bool m_parallelUpdate = true;
+    EntityCommandBuffer m_commands;
+    std::vector<EntityCommandBuffer> m_chunkCommands;
+    std::vector<EntityPool*> m_parallelPools;
+    std::vector<size_t> m_parallelBlockStarts;  // Prefix sums of block counts, one past the end per pool
+
+    void UpdateParallelPools(float deltaTime, const UpdateSchedule* schedule);
+    void FlushPendingRemovals();
 
   public:
     template <typename T>
     int Spawn() {
         static_assert(std::is_base_of_v<Entity, T>, "T must derive from Entity");
 
-        // Create entity instance
-        auto entity = std::make_unique<T>();
-        int id = m_nextEntityId++;
-        entity->id = id;
-
-        // Add to entities vector
-        if (id >= static_cast<int>(m_entities.size())) {
-            m_entities.resize(id + 1);
+        // Constructed straight into its pool as the real type
+        TypedEntityPool<T>& pool = GetPool<T>();
+        Entity* stored = RegisterEntity(pool.Create(), &pool);
+        if (!stored) {
+            return -1;
         }
-        m_entities[id] = *entity;
 
         // Call OnSpawn for custom initialization
-        m_entities[id].OnSpawn();
+        stored->OnSpawn();
 
-        return id;
+        if (m_capture) {
+            ReportUncapturedSpawn();
+        }
+        return stored->id;
     }
 };
 
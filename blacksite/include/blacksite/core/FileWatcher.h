@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Blacksite {
+
+/**
+ * FileWatcher - Change notifications for a directory tree from the OS instead of stat() polling
+ * inotify on Linux, ReadDirectoryChangesW on Windows, FSEvents on macOS. The OS side runs on a background
+ * thread (a dispatch queue for FSEvents) and only records paths; PollChanges hands them to the caller's thread
+ * once they've been quiet for the debounce window, so a save that shows up as truncate + write + rename is one change.
+ * Not tied to shaders - anything that wants hot reload can own one.
+ */
+class FileWatcher {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    FileWatcher() = default;
+    ~FileWatcher() { Stop(); }
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // False if there's no backend for this platform or the OS said no - callers fall back to polling
+    bool Start(const std::string& directory);
+    void Stop();
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    void SetDebounce(std::chrono::milliseconds debounce) { m_debounce = debounce; }
+
+    // Absolute, lexically normalized paths (generic '/' separators) that changed and have settled.
+    // Call from the thread that acts on them. Cheap when nothing happened: one lock, one empty check.
+    std::vector<std::string> PollChanges();
+
+    // Same form PollChanges reports paths in, so callers can key their own tables by it
+    static std::string NormalizePath(const std::string& path);
+
+    // What the backends call, from any thread. Also works for forcing a reload by hand.
+    void RecordChange(const std::string& path);
+
+  private:
+    std::string m_directory;  // Normalized, with a trailing '/'
+    std::chrono::milliseconds m_debounce{100};
+    std::atomic<bool> m_running{false};
+    std::thread m_thread;
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Clock::time_point> m_pending;  // Path -> last time the OS mentioned it
+
+#if defined(__linux__)
+    int m_inotify = -1;
+    std::unordered_map<int, std::string> m_watchDirs;  // Watch descriptor -> directory, only the thread touches it
+    bool AddWatchRecursive(const std::string& directory);
+    void WatchLoop();
+#elif defined(_WIN32)
+    void* m_dirHandle = nullptr;
+    void* m_stopEvent = nullptr;
+    void WatchLoop();
+#elif defined(__APPLE__)
+    void* m_stream = nullptr;  // FSEventStreamRef
+    void* m_queue = nullptr;   // dispatch_queue_t
+#endif
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "blacksite/core/MemoryTracker.h"
+
+namespace Blacksite {
+
+/**
+ * FrameArena - Bump allocator for data that only lives for a frame or two
+ * Two buffers, flipped by BeginFrame at the top of every frame, so anything allocated last frame is still
+ * there this frame and gone the one after. Allocate bumps the offset with a compare-and-swap loop (it has to
+ * align first, so a plain add won't do) and is safe from jobs. Freeing is a no-op, the whole buffer resets at
+ * once. A frame that doesn't fit spills to the heap and the buffer grows to fit next time it comes around, so
+ * a steady frame ends up never touching the general heap.
+ * Don't keep arena memory across more than one BeginFrame, and don't put anything in it whose destructor
+ * has to run.
+ */
+class FrameArena {
+  public:
+    static constexpr size_t DEFAULT_SIZE = 8 * 1024 * 1024;  // Per buffer
+
+    // The Engine's arena, or a fallback made on first use that the Engine's replaces once it exists.
+    // Without an Engine, whoever runs the loop calls BeginFrame on the fallback.
+    static FrameArena& Get();
+
+    explicit FrameArena(size_t bytesPerFrame = DEFAULT_SIZE);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* AllocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Nothing runs destructors on arena memory");
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Flips to the other buffer and empties it. Nothing may be allocating while this runs.
+    void BeginFrame();
+
+    // Bumped by BeginFrame, lets a holder tell whether its arena memory is from an older frame
+    uint64_t GetFrameIndex() const { return m_frameIndex; }
+
+    size_t GetCapacity() const { return m_buffers[m_current].capacity; }
+    size_t GetUsedBytes() const;  // This frame so far, spills included
+    size_t GetPeakBytes() const { return m_peakBytes; }
+    size_t GetSpillCount() const { return m_spillCount; }  // Frames that didn't fit, since startup
+
+  private:
+    struct Buffer {
+        std::unique_ptr<unsigned char, TrackedDelete> memory;
+        size_t capacity = 0;
+        std::atomic<size_t> offset{0};
+
+        // Whatever didn't fit, freed on the next reset of this buffer
+        std::mutex spillMutex;
+        std::vector<std::unique_ptr<unsigned char, TrackedDelete>> spills;
+        size_t spilledBytes = 0;
+    };
+
+    Buffer m_buffers[2];
+    int m_current = 0;
+    uint64_t m_frameIndex = 0;
+    size_t m_peakBytes = 0;
+    size_t m_spillCount = 0;
+
+    static std::atomic<FrameArena*> s_current;
+
+    FrameArena(size_t bytesPerFrame, bool makeCurrent);  // Get's fallbacks pass false
+
+    void* Spill(Buffer& buffer, size_t size, size_t alignment);
+};
+
+/**
+ * FrameAllocator - STL allocator on top of a FrameArena
+ * deallocate does nothing, so a FrameVector has to be rebuilt (not just cleared) once its frame is over -
+ * see Renderer's queue for the pattern. Default-constructed ones use FrameArena::Get().
+ */
+template <typename T>
+class FrameAllocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    FrameAllocator() noexcept : m_arena(&FrameArena::Get()) {}
+    explicit FrameAllocator(FrameArena& arena) noexcept : m_arena(&arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) noexcept : m_arena(other.m_arena) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(m_arena->Allocate(sizeof(T) * count, alignof(T))); }
+    void deallocate(T*, size_t) noexcept {}
+
+    FrameArena& GetArena() const { return *m_arena; }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& other) const {
+        return m_arena == other.m_arena;
+    }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>& other) const {
+        return m_arena != other.m_arena;
+    }
+
+  private:
+    template <typename U>
+    friend class FrameAllocator;
+    FrameArena* m_arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+}  // namespace Blacksite
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "blacksite/core/InputSystem.h"
+
+namespace Blacksite {
+
+class Scene;
+
+/**
+ * FrameCapture - Records a run frame by frame and plays it back with the same frame times
+ * A capture is a compact binary log (<path>) plus the scene as it was when recording started (<path>.bscn).
+ * Per frame it keeps the delta time, what changed in the input, the camera, the live entity count, and every
+ * spawn/remove that went through EntitySystem - tagged with whether it happened inside the frame (game code,
+ * regenerated on replay) or outside it (editor UI, tools - has to be re-applied).
+ *
+ * Two ways to play it back:
+ *  - In app: same app, same startup. Frame times and input are fed back, game code runs as usual and only the
+ *    outside spawns/removes are re-applied. The entity count is checked every frame to catch divergence.
+ *  - Standalone: no game code at all (blacksite_bench --replay). The .bscn gets loaded, and every recorded
+ *    spawn/remove and camera move is applied - the workload comes back, gameplay logic doesn't.
+ * Spawn<T> and the setup-callback SpawnBatch can't be written down, a capture that uses them outside the frame
+ * only replays in app. Same build and platform only, the file is raw host-order data.
+ */
+class FrameCapture {
+  public:
+    enum class Mode : uint8_t { Off, Recording, ReplayInApp, ReplayStandalone };
+
+    FrameCapture() = default;
+    ~FrameCapture() { Stop(); }
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    bool StartRecording(const std::string& path, Scene& scene);
+    // standalone = replace the scene's entities with the capture's snapshot and apply every recorded command
+    bool StartReplay(const std::string& path, Scene& scene, bool standalone);
+    void Stop();  // Finishes the file when recording
+
+    Mode GetMode() const { return m_mode; }
+    bool IsRecording() const { return m_mode == Mode::Recording; }
+    bool IsReplaying() const { return m_mode == Mode::ReplayInApp || m_mode == Mode::ReplayStandalone; }
+    bool IsReplayFinished() const { return IsReplaying() && m_replayFrame >= m_frames.size(); }
+
+    uint64_t GetFrameIndex() const { return m_frameIndex; }
+    size_t GetReplayFrameCount() const { return m_frames.size(); }
+    uint64_t GetDivergedFrame() const { return m_divergedFrame; }  // NO_DIVERGENCE unless the counts went apart
+    static constexpr uint64_t NO_DIVERGENCE = UINT64_MAX;
+
+    // The engine wraps every frame's Update in these. Recording notes deltaTime and the input; replay
+    // overwrites both and applies the frame's commands. False when a replay has no frames left.
+    bool BeginFrame(float& deltaTime, InputSystem& input);
+    void EndFrame();
+
+    // EntitySystem reports what it spawned and removed
+    void OnSpawn(uint8_t shape, int id, const glm::vec3& position, const glm::vec3& size, const std::string& shader,
+                 const glm::vec3& color);
+    void OnSpawnMesh(int id, const std::string& mesh, const glm::vec3& position, const std::string& shader,
+                     const glm::vec3& color);
+    void OnSpawnBatch(const std::vector<int>& ids, const std::vector<glm::vec3>& positions,
+                      const std::vector<uint8_t>& shapes, const std::vector<glm::vec3>& colors,
+                      const std::string& shader);
+    void OnRemove(int id);
+    void OnUncapturedSpawn();  // Spawn<T> and friends
+
+    static constexpr uint32_t FORMAT_VERSION = 2;  // 2: starting camera in the header
+
+  private:
+    enum class CommandType : uint8_t { Spawn, SpawnMesh, SpawnBatch, Remove };
+
+    struct Command {
+        CommandType type = CommandType::Spawn;
+        bool inFrame = false;  // Happened between BeginFrame and EndFrame
+        uint8_t shape = 0;
+        int id = -1;
+        glm::vec3 position{0.0f};
+        glm::vec3 size{1.0f};
+        glm::vec3 color{1.0f};
+        std::string shader;
+        std::string mesh;
+        std::vector<int> ids;  // Batch
+        std::vector<glm::vec3> positions;
+        std::vector<uint8_t> shapes;
+        std::vector<glm::vec3> colors;
+    };
+
+    struct Frame {
+        float deltaTime = 0.0f;
+        uint32_t entityCount = 0;  // After the frame's update
+        glm::vec3 cameraPosition{0.0f};
+        glm::vec3 cameraTarget{0.0f};
+        InputSystem::Snapshot input;
+        size_t firstCommand = 0;
+        size_t commandCount = 0;
+    };
+
+    Mode m_mode = Mode::Off;
+    Scene* m_scene = nullptr;
+    std::string m_path;
+    uint64_t m_frameIndex = 0;
+    bool m_inFrame = false;
+    bool m_warnedUncaptured = false;
+
+    // Recording
+    std::ofstream m_file;
+    Frame m_current;
+    Frame m_previous;  // What the last written frame held, fields are only written when they change
+    std::vector<Command> m_pending;  // Since the last frame was written
+
+    // Replay
+    std::vector<Frame> m_frames;
+    std::vector<Command> m_commands;
+    size_t m_replayFrame = 0;
+    uint64_t m_divergedFrame = NO_DIVERGENCE;
+    std::unordered_map<int, int> m_idMap;  // Captured id -> the id it got this time, where they differ
+
+    int MapId(int capturedId) const;
+    void Record(Command&& command);
+    void WriteFrame();
+    void ApplyCommand(const Command& command);
+    bool ReadFile(const std::string& path, uint32_t& startEntityCount, std::vector<int>& snapshotIds);
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,89 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+struct GLFWwindow;
+
+namespace Blacksite {
+
+enum class VSyncMode : uint8_t {
+    Off,
+    On,
+    Adaptive,  // Waits for the display unless the frame is late, then tears instead of dropping to half rate
+};
+
+struct FramePacingConfig {
+    VSyncMode vsync = VSyncMode::On;
+    int targetFps = 0;     // Frame cap on top of vsync, 0 = none
+    int updateRate = 0;    // Fixed game updates per second, 0 = one update per rendered frame
+    int unfocusedFps = 15; // Cap while the window is unfocused or minimized, 0 = no throttling
+
+    // Stop redrawing once nothing has changed for idleDelay seconds and sleep until input arrives.
+    // "Changed" = input, window events, entities added/removed/edited, camera moves, bodies awake.
+    // Anything animating on its own has to call FramePacer::RequestRedraw.
+    bool idleWhenUnchanged = false;
+    float idleDelay = 0.5f;
+    float idleTimeout = 0.5f;  // Longest sleep while idle, so hot reloads and log output still show up
+};
+
+/**
+ * FramePacer - Decides when the main loop runs its next frame
+ * PollEvents replaces glfwPollEvents at the top of the frame and blocks there while the app is idle;
+ * EndFrame goes after SwapBuffers and holds the frame to the cap with a sleep followed by a short spin, so the
+ * cap is hit to well under a millisecond without burning a core for the whole wait.
+ */
+class FramePacer {
+  public:
+    FramePacer() = default;
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Hooks the window's input callbacks to notice activity. Install anything that chains callbacks (ImGui)
+    // after this.
+    void Initialize(GLFWwindow* window);
+
+    void SetConfig(const FramePacingConfig& config);  // Applies the vsync mode right away
+    const FramePacingConfig& GetConfig() const { return m_config; }
+
+    void PollEvents();
+    void EndFrame();
+
+    // Fixed update steps to run for this frame's deltaTime, stepDelta gets the step length.
+    // Without an update rate it's always 1 step of deltaTime.
+    int ConsumeUpdateSteps(float deltaTime, float& stepDelta);
+
+    void MarkActivity();           // This frame changed something, keep drawing at full rate
+    static void RequestRedraw();   // Wakes an idle loop, safe from any thread
+
+    bool IsIdle() const { return m_idle; }
+    bool IsThrottled() const { return m_throttled; }
+    bool IsAdaptiveVSyncSupported() const { return m_adaptiveSupported; }
+    float GetLastWaitMs() const { return m_lastWaitMs; }  // Slept + spun at the end of the last frame
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int MAX_UPDATE_STEPS = 5;  // Past this a slow frame drops time instead of spiralling
+
+    GLFWwindow* m_window = nullptr;
+    FramePacingConfig m_config;
+    bool m_adaptiveSupported = false;
+
+    uint64_t m_seenEvents = 0;  // Window event count (kept by the chained callbacks) at the last check
+    Clock::time_point m_lastActivity = Clock::now();
+    Clock::time_point m_nextFrame = Clock::now();
+    double m_oversleepMs = 1.0;  // Running estimate of how late sleep_for wakes up, sets the spin length
+    float m_updateAccumulator = 0.0f;
+    float m_lastWaitMs = 0.0f;
+    bool m_idle = false;
+    bool m_throttled = false;
+
+    void ApplyVSync();
+    void WaitUntil(Clock::time_point deadline, bool spin);
+    void InstallCallbacks();  // Chained in front of whatever the window had, the user pointer stays free
+    void RemoveCallbacks();
+};
+
+}  // namespace Blacksite
@@ -2,8 +2,11 @@
 
 #include <glm/glm.hpp>
 #include <GLFW/glfw3.h>
+#include <bitset>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Blacksite {
 
@@ -85,15 +88,51 @@ enum class Key {
 
 enum class Mouse { Left = GLFW_MOUSE_BUTTON_LEFT, Right = GLFW_MOUSE_BUTTON_RIGHT, Middle = GLFW_MOUSE_BUTTON_MIDDLE };
 
+// One GLFW callback, queued until the next Update. Cursor moves aren't queued, only the latest position counts.
+struct InputEvent {
+    enum class Type : uint8_t { Key, MouseButton, Scroll };
+
+    Type type = Type::Key;
+    bool pressed = false;  // Key / MouseButton, repeats are dropped
+    int code = 0;          // GLFW key or mouse button
+    glm::vec2 scroll{0.0f};
+    uint64_t frame = 0;  // The Update that applied it
+};
+
+/**
+ * InputSystem - Keyboard + mouse state, fed by GLFW callbacks
+ * Callbacks append to a queue and Update applies it once per frame: down state plus pressed/released bits
+ * for this frame, so every query is a bit test and nothing polls all MAX_KEYS keys. A key that goes down and
+ * up between two frames still reports KeyPressed + KeyReleased for the frame it lands in.
+ * The callbacks chain whatever was installed before (the FramePacer's), so initialize after it and before
+ * anything else that chains (ImGui).
+ */
 class InputSystem {
   public:
+    static constexpr int MAX_KEYS = 1024;
+    static constexpr int MAX_MOUSE_BUTTONS = 8;
+
+    // Everything Update samples in one frame - what FrameCapture records and plays back
+    struct Snapshot {
+        std::bitset<MAX_KEYS> keys;
+        uint8_t mouseButtons = 0;  // Bit per GLFW mouse button
+        double mouseX = 0.0;
+        double mouseY = 0.0;
+    };
+
     InputSystem() = default;
-    ~InputSystem() = default;
+    ~InputSystem() { Shutdown(); }
+    InputSystem(const InputSystem&) = delete;
+    InputSystem& operator=(const InputSystem&) = delete;
 
     bool Initialize(GLFWwindow* window);
     void Update();
     void Shutdown();
 
+    void GetSnapshot(Snapshot& out) const;
+    // Stands in for Update: this frame's state becomes last frame's, the snapshot becomes this frame's
+    void ApplySnapshot(const Snapshot& snapshot);
+
     // Main API - supports both enum and char
     bool KeyDown(Key key) const { return IsKeyPressed(static_cast<int>(key)); }
     bool KeyDown(char key) const { return KeyDown(CharToKey(key)); }
@@ -107,8 +146,15 @@ class InputSystem {
 
     // Mouse
     bool MouseDown(Mouse button) const { return IsMouseButtonPressed(static_cast<int>(button)); }
+    bool MousePressed(Mouse button) const { return TestMouseBit(m_mousePressed, static_cast<int>(button)); }
+    bool MouseReleased(Mouse button) const { return TestMouseBit(m_mouseReleased, static_cast<int>(button)); }
     glm::vec2 MousePos() const { return {m_mouseX, m_mouseY}; }
     glm::vec2 MouseDelta() const { return {m_mouseX - m_lastMouseX, m_mouseY - m_lastMouseY}; }
+    glm::vec2 ScrollDelta() const { return m_scroll; }  // Summed over the frame
+
+    // What the last Update applied, in arrival order. Empty on replayed frames.
+    const std::vector<InputEvent>& GetEvents() const { return m_frameEvents; }
+    uint64_t GetFrame() const { return m_frame; }
 
     // Axis system - 2 keys (positive/negative)
     float GetAxis(Key positive, Key negative) const {
@@ -182,22 +228,42 @@ class InputSystem {
     bool IsKeyJustPressed(int key) const;
     bool IsKeyJustReleased(int key) const;
     bool IsMouseButtonPressed(int button) const;
+    static bool TestMouseBit(uint8_t bits, int button) {
+        return button >= 0 && button < MAX_MOUSE_BUTTONS && ((bits >> button) & 1u);
+    }
 
-    void UpdateKeyStates();
+    void ApplyEvent(const InputEvent& event);
     void UpdateMouseState();
 
+    // GLFW side - queue into the window's InputSystem, then call whatever was installed before us
+    void InstallCallbacks();
+    void RemoveCallbacks();
+    static void OnKey(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void OnMouseButton(GLFWwindow* window, int button, int action, int mods);
+    static void OnCursorPos(GLFWwindow* window, double x, double y);
+    static void OnScroll(GLFWwindow* window, double x, double y);
+
     GLFWwindow* m_window = nullptr;
     bool m_initialized = false;
     bool m_editorActive = false;
     bool m_mouseOverUI = false;
     bool m_firstMouse = true;
 
-    static constexpr int MAX_KEYS = 1024;
-    bool m_keys[MAX_KEYS] = {};
-    bool m_keysLastFrame[MAX_KEYS] = {};
+    std::bitset<MAX_KEYS> m_keys;
+    std::bitset<MAX_KEYS> m_keysPressed;   // Went down this frame (may be up again already)
+    std::bitset<MAX_KEYS> m_keysReleased;  // Went up this frame
+    uint8_t m_mouseButtons = 0;            // Bit per GLFW mouse button, like the keys
+    uint8_t m_mousePressed = 0;
+    uint8_t m_mouseReleased = 0;
+    glm::vec2 m_scroll{0.0f};
+
+    std::vector<InputEvent> m_pendingEvents;  // Since the last Update
+    std::vector<InputEvent> m_frameEvents;    // Applied by the last Update
+    uint64_t m_frame = 0;
 
     double m_mouseX = 0.0, m_mouseY = 0.0;
     double m_lastMouseX = 0.0, m_lastMouseY = 0.0;
+    double m_cursorX = 0.0, m_cursorY = 0.0;  // Latest from the callback
 };
 
 }  // namespace Blacksite
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Blacksite {
+
+class JobSystem;
+
+/**
+ * JobCounter - How many jobs are still out, plus whatever waits for them to finish
+ * Pass one to Run for every job in a group, then Wait on it or hang more jobs off it with RunAfter.
+ * Must outlive the jobs counted on it.
+ */
+class JobCounter {
+  public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+  private:
+    friend class JobSystem;
+    std::atomic<uint32_t> m_pending{0};
+    std::mutex m_mutex;  // Guards m_continuations and the hand-off when m_pending hits 0
+    std::vector<std::function<void()>> m_continuations;
+};
+
+/**
+ * JobSystem - The engine's one set of worker threads
+ * Each worker has its own deque: it pushes and pops at the back, idle workers steal from the front of
+ * the others', and jobs from outside the pool go through a shared queue. Physics runs on it too (Jolt
+ * gets it through JoltJobSystem), so culling, loading and game jobs all share the same cores instead of
+ * each pool assuming the machine is its own. Anything that waits helps run jobs meanwhile, so waiting
+ * inside a job is fine. Nothing in here touches OpenGL - keep GL calls on the context thread.
+ */
+class JobSystem {
+  public:
+    using Job = std::function<void()>;
+    using ChunkFunction = std::function<void(size_t chunkIndex, size_t begin, size_t end)>;
+
+    // The Engine's job system, or one made on first use for code running without an Engine.
+    // After the Engine's has shut down, a pool without threads that runs jobs as they're queued.
+    static JobSystem& Get();
+
+    // -1 = hardware threads - 1, the calling thread makes up the last one
+    explicit JobSystem(int workerThreads = -1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t GetWorkerCount() const { return m_workers.size(); }
+    size_t GetConcurrency() const { return m_workers.size() + 1; }  // Workers + whoever waits
+
+    // Queues a job. 'counter' (optional) goes up now and back down once the job has run.
+    void Run(Job job, JobCounter* counter = nullptr);
+
+    // Queues 'job' once 'dependency' reaches zero - right away if it already has
+    void RunAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+
+    // Runs other jobs until the counter reaches zero
+    void Wait(JobCounter& counter);
+
+    // How many chunks ParallelFor will use for this many items (so callers can size per-chunk buffers)
+    size_t GetChunkCount(size_t itemCount, size_t minItemsPerChunk) const;
+
+    // Runs fn over [0, itemCount) in GetChunkCount() chunks, blocks until they're all done
+    void ParallelFor(size_t itemCount, size_t minItemsPerChunk, const ChunkFunction& fn);
+
+  private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex m_sharedMutex;
+    std::deque<Job> m_sharedJobs;  // Queued from threads that aren't workers
+
+    // Sleeping workers wait here. m_queued counts jobs sitting in any queue, it's what they wake up on.
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<size_t> m_queued{0};
+    std::atomic<bool> m_shutdown{false};
+
+    static std::atomic<JobSystem*> s_current;
+
+    JobSystem(int workerThreads, bool makeCurrent);  // Exact count, 0 = run jobs inline in Run
+
+    void Push(Job job);
+    bool TryRunOne(int workerIndex);  // workerIndex -1 for threads outside the pool
+    bool TryPop(int workerIndex, Job& out);
+    void Finish(JobCounter& counter);
+    void WorkerLoop(int index);
+};
+
+}  // namespace Blacksite
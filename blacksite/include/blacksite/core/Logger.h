@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <chrono>
 #include <iomanip>
@@ -54,28 +57,27 @@ enum class LogColor {
 };
 
 struct LogEntry {
-    LogLevel level;
-    LogCategory category;
+    LogLevel level = LogLevel::INFO;
+    LogCategory category = LogCategory::CORE;
     std::string message;
-    std::string timestamp;
+    std::string timestamp;  // Formatted from 'time' by whoever writes the entry out, off-thread in async mode
     std::string file;
-    int line;
+    int line = 0;
+    std::chrono::system_clock::time_point time;
 
+    LogEntry() = default;
     LogEntry(LogLevel lvl, LogCategory cat, const std::string& msg,
              const std::string& f = "", int l = 0)
-        : level(lvl), category(cat), message(msg), file(f), line(l) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
-
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time_t), "%H:%M:%S");
-        ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-        timestamp = ss.str();
-    }
+        : level(lvl), category(cat), message(msg), file(f), line(l),
+          time(std::chrono::system_clock::now()) {}
 };
 
+/**
+ * Logger - console, file and editor history output
+ * Sync mode writes each line before Log returns. Async mode (the default after Initialize) pushes into a
+ * lock-free ring and a writer thread formats and writes in batches, so a log call never waits on I/O.
+ * When the ring is full new entries are dropped and counted rather than blocking the caller.
+ */
 class Logger {
 public:
     static Logger& Instance() {
@@ -85,7 +87,7 @@ public:
 
     // Core logging functions
     void Log(LogLevel level, LogCategory category, const std::string& message,
-             const std::string& file = "", int line = 0);
+             const char* file = "", int line = 0);
 
     // Convenience functions
     void Trace(LogCategory category, const std::string& message) {
@@ -112,6 +114,11 @@ public:
         Log(LogLevel::FATAL, category, message);
     }
 
+    // Same filtering Log does, the macros call it first so a dropped message never gets formatted
+    bool ShouldLog(LogLevel level, LogCategory category) const {
+        return level >= m_level && m_categoryFilter[(int)category];
+    }
+
     // Configuration
     void SetLevel(LogLevel level) { m_level = level; }
     void SetConsoleOutput(bool enabled) { m_consoleOutput = enabled; }
@@ -120,17 +127,55 @@ public:
     void SetColorOutput(bool enabled) { m_colorOutput = enabled; }
     void SetLogFile(const std::string& filename);
 
+    // Async writer. Switching off drains what's queued first. FATAL always waits for its own line to land.
+    void SetAsync(bool enabled);
+    bool IsAsync() const { return m_async.load(std::memory_order_relaxed); }
+    void Flush();  // Blocks until everything logged so far is written
+    uint64_t GetDroppedCount() const { return m_droppedTotal.load(std::memory_order_relaxed); }
+
+    static constexpr size_t RING_SIZE = 8192;  // Power of two
+    static constexpr std::chrono::milliseconds WRITER_INTERVAL{4};  // How long the writer naps when idle
+
     // Filter by category
     void EnableCategory(LogCategory category) { m_categoryFilter[(int)category] = true; }
     void DisableCategory(LogCategory category) { m_categoryFilter[(int)category] = false; }
 
-    // Editor integration
-    const std::vector<LogEntry>& GetLogHistory() const { return m_logHistory; }
+    // Editor integration. History is a ring of the newest HISTORY_SIZE entries, each with a sequence number
+    // that only goes up, so a viewer can remember where it got to and only look at what's new.
+    uint64_t GetHistorySequence();  // Sequence the next entry will get
+    uint64_t GetOldestHistorySequence();
+
+    // Calls fn(sequence, entry) for each kept entry from 'fromSequence' on, in order, without copying.
+    // Runs under the output lock, so keep fn short and don't log from it. Returns the next sequence.
+    template <typename Fn>
+    uint64_t VisitHistory(uint64_t fromSequence, Fn&& fn) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint64_t first = fromSequence > m_historyFirst ? fromSequence : m_historyFirst;
+        for (uint64_t seq = first; seq < m_historyNext; ++seq) {
+            fn(seq, m_logHistory[seq % HISTORY_SIZE]);
+        }
+        return m_historyNext;
+    }
+
+    // One entry by sequence, false if it has already been overwritten (or hasn't happened yet)
+    template <typename Fn>
+    bool VisitHistoryEntry(uint64_t sequence, Fn&& fn) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (sequence < m_historyFirst || sequence >= m_historyNext) {
+            return false;
+        }
+        fn(m_logHistory[sequence % HISTORY_SIZE]);
+        return true;
+    }
+
+    std::vector<LogEntry> GetLogHistory();  // Copy, oldest first
     void ClearHistory() {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_logHistory.clear();
+        m_historyFirst = m_historyNext;
     }
 
+    static constexpr uint64_t HISTORY_SIZE = 1024;
+
     // Initialize with sensible defaults
     void Initialize();
     void Shutdown();
@@ -150,8 +195,31 @@ private:
     bool m_colorOutput = true;
 
     std::ofstream m_logFile;
-    std::vector<LogEntry> m_logHistory;
-    std::mutex m_mutex;
+    std::vector<LogEntry> m_logHistory = std::vector<LogEntry>(HISTORY_SIZE);
+    uint64_t m_historyFirst = 0;  // Oldest sequence still valid
+    uint64_t m_historyNext = 0;
+    std::mutex m_mutex;  // Output side: file, console, history
+
+    // Bounded MPSC ring, each slot's sequence says whether it's free to write or ready to read
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        LogEntry entry;
+    };
+    std::unique_ptr<Slot[]> m_ring;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) size_t m_dequeuePos = 0;  // Writer thread only
+    std::atomic<bool> m_async{false};
+    std::atomic<int> m_activePushes{0};  // Log calls that may have seen m_async on and not finished pushing yet
+    std::atomic<uint64_t> m_dropped{0};  // Since the writer last reported it
+    std::atomic<uint64_t> m_droppedTotal{0};
+
+    std::thread m_writer;
+    std::mutex m_writerMutex;
+    std::condition_variable m_writerWake;
+    std::condition_variable m_writerDone;
+    bool m_stopWriter = false;
+    bool m_flushRequested = false;
+    size_t m_writtenPos = 0;
 
     // Category filtering (all enabled by default)
     bool m_categoryFilter[8] = {true, true, true, true, true, true, true, true};
@@ -161,72 +229,61 @@ private:
     LogColor GetLevelColor(LogLevel level) const;
     std::string ColorToAnsi(LogColor color) const;
 
+    std::string FormatTimestamp(std::chrono::system_clock::time_point time) const;
+    std::string FormatLine(const LogEntry& entry, bool color) const;
+
     void WriteToConsole(const LogEntry& entry);
     void WriteToFile(const LogEntry& entry);
     void AddToHistory(const LogEntry& entry);
-};
-
-// Convenience macros for easy logging with file/line info
-#define BS_TRACE(category, message) \
-    Blacksite::Logger::Instance().Log(Blacksite::LogLevel::TRACE, category, message, __FILE__, __LINE__)
 
-#define BS_DEBUG(category, message) \
-    Blacksite::Logger::Instance().Log(Blacksite::LogLevel::DEBUG, category, message, __FILE__, __LINE__)
-
-#define BS_INFO(category, message) \
-    Blacksite::Logger::Instance().Log(Blacksite::LogLevel::INFO, category, message, __FILE__, __LINE__)
-
-#define BS_WARN(category, message) \
-    Blacksite::Logger::Instance().Log(Blacksite::LogLevel::WARN, category, message, __FILE__, __LINE__)
-
-#define BS_ERROR(category, message) \
-    Blacksite::Logger::Instance().Log(Blacksite::LogLevel::ERROR, category, message, __FILE__, __LINE__)
-
-#define BS_FATAL(category, message) \
-    Blacksite::Logger::Instance().Log(Blacksite::LogLevel::FATAL, category, message, __FILE__, __LINE__)
+    bool TryPush(LogEntry&& entry);
+    size_t PopBatch(std::vector<LogEntry>& batch);
+    void WriteBatch(std::vector<LogEntry>& batch);
+    void StartWriter();
+    void StopWriter();
+    void WriterLoop();
+};
 
-// Formatted logging macros
-#define BS_TRACE_F(category, format, ...) \
-    do { \
-        char buffer[512]; \
-        snprintf(buffer, sizeof(buffer), format, __VA_ARGS__); \
-        BS_TRACE(category, std::string(buffer)); \
-    } while(0)
+// Lowest level that gets compiled in at all (LogLevel as an int). CMake sets it from BLACKSITE_MIN_LOG_LEVEL,
+// Release defaults to INFO. Calls below it are still type-checked, they just never run or evaluate arguments.
+#ifndef BS_MIN_LOG_LEVEL
+#define BS_MIN_LOG_LEVEL 0
+#endif
 
-#define BS_DEBUG_F(category, format, ...) \
-    do { \
-        char buffer[512]; \
-        snprintf(buffer, sizeof(buffer), format, __VA_ARGS__); \
-        BS_DEBUG(category, std::string(buffer)); \
-    } while(0)
+// Compile-time cut first, then the runtime level/category check, all before any formatting happens
+#define BS_LOG_ENABLED(level, category) \
+    (static_cast<int>(level) >= BS_MIN_LOG_LEVEL && Blacksite::Logger::Instance().ShouldLog(level, category))
 
-#define BS_INFO_F(category, format, ...) \
+#define BS_LOG(level, category, message) \
     do { \
-        char buffer[512]; \
-        snprintf(buffer, sizeof(buffer), format, __VA_ARGS__); \
-        BS_INFO(category, std::string(buffer)); \
+        if (BS_LOG_ENABLED(level, category)) \
+            Blacksite::Logger::Instance().Log(level, category, message, __FILE__, __LINE__); \
     } while(0)
 
-#define BS_WARN_F(category, format, ...) \
+#define BS_LOG_F(level, category, format, ...) \
     do { \
-        char buffer[512]; \
-        snprintf(buffer, sizeof(buffer), format, __VA_ARGS__); \
-        BS_WARN(category, std::string(buffer)); \
+        if (BS_LOG_ENABLED(level, category)) { \
+            char buffer[512]; \
+            snprintf(buffer, sizeof(buffer), format, __VA_ARGS__); \
+            Blacksite::Logger::Instance().Log(level, category, std::string(buffer), __FILE__, __LINE__); \
+        } \
     } while(0)
 
-#define BS_ERROR_F(category, format, ...) \
-    do { \
-        char buffer[512]; \
-        snprintf(buffer, sizeof(buffer), format, __VA_ARGS__); \
-        BS_ERROR(category, std::string(buffer)); \
-    } while(0)
+// Convenience macros for easy logging with file/line info
+#define BS_TRACE(category, message) BS_LOG(Blacksite::LogLevel::TRACE, category, message)
+#define BS_DEBUG(category, message) BS_LOG(Blacksite::LogLevel::DEBUG, category, message)
+#define BS_INFO(category, message) BS_LOG(Blacksite::LogLevel::INFO, category, message)
+#define BS_WARN(category, message) BS_LOG(Blacksite::LogLevel::WARN, category, message)
+#define BS_ERROR(category, message) BS_LOG(Blacksite::LogLevel::ERROR, category, message)
+#define BS_FATAL(category, message) BS_LOG(Blacksite::LogLevel::FATAL, category, message)
 
-#define BS_FATAL_F(category, format, ...) \
-    do { \
-        char buffer[512]; \
-        snprintf(buffer, sizeof(buffer), format, __VA_ARGS__); \
-        BS_FATAL(category, std::string(buffer)); \
-    } while(0)
+// Formatted logging macros
+#define BS_TRACE_F(category, format, ...) BS_LOG_F(Blacksite::LogLevel::TRACE, category, format, __VA_ARGS__)
+#define BS_DEBUG_F(category, format, ...) BS_LOG_F(Blacksite::LogLevel::DEBUG, category, format, __VA_ARGS__)
+#define BS_INFO_F(category, format, ...) BS_LOG_F(Blacksite::LogLevel::INFO, category, format, __VA_ARGS__)
+#define BS_WARN_F(category, format, ...) BS_LOG_F(Blacksite::LogLevel::WARN, category, format, __VA_ARGS__)
+#define BS_ERROR_F(category, format, ...) BS_LOG_F(Blacksite::LogLevel::ERROR, category, format, __VA_ARGS__)
+#define BS_FATAL_F(category, format, ...) BS_LOG_F(Blacksite::LogLevel::FATAL, category, format, __VA_ARGS__)
 
 // Quick category shortcuts for common use
 namespace Log {
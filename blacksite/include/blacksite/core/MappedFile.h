@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Blacksite {
+
+/**
+ * MappedFile - A whole file mapped read-only into memory
+ * The mapping is page-aligned, so anything stored at an aligned offset in the file can be read in place.
+ * Data() is only good while the MappedFile is open.
+ */
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False if the file is missing or smaller than minSize
+    bool Open(const std::string& path, size_t minSize = 1);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+  private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+
+}  // namespace Blacksite
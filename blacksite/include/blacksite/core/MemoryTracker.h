@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Blacksite {
+
+// Who the memory belongs to. The GPU ones are estimates from the sizes we hand GL, the driver may pad.
+enum class MemoryTag : uint8_t {
+    Physics,        // Jolt, through its allocation hooks
+    Entities,       // Entity pools and the EntitySystem slot arrays
+    FrameArena,     // Both arena buffers plus whatever spilled
+    Meshes,         // GPU: MeshArena vertex and index buffers
+    RenderTargets,  // GPU: framebuffer color and depth textures
+    GpuBuffers,     // GPU: the upload ring (instance rows, indirect draws), Hi-Z pyramid and its readback PBO
+    Textures,       // GPU: whichever mips TextureManager has resident
+    Count
+};
+
+struct MemoryStats {
+    int64_t liveBytes = 0;
+    int64_t peakBytes = 0;
+    int64_t liveAllocations = 0;
+    uint64_t totalAllocations = 0;
+};
+
+/**
+ * MemoryTracker - Live and peak bytes per subsystem
+ * Allocate/Free put a small header in front of every block so Free knows the size and tag. Memory
+ * something else allocates (GL objects, container capacity) gets reported with Adjust instead.
+ * Every counter is a relaxed atomic, fine from any thread.
+ */
+class MemoryTracker {
+  public:
+    static constexpr size_t DEFAULT_ALIGNMENT = 16;
+
+    static void* Allocate(size_t size, MemoryTag tag, size_t alignment = DEFAULT_ALIGNMENT);
+    // Keeps the block's tag and alignment, 'tag' only matters when block is nullptr
+    static void* Reallocate(void* block, size_t newSize, MemoryTag tag);
+    static void Free(void* block);
+
+    // Reports bytes that didn't come from Allocate, negative when they're released
+    static void Adjust(MemoryTag tag, int64_t bytes);
+
+    static MemoryStats GetStats(MemoryTag tag);
+    static void ResetPeaks();  // Peaks start over from what's live now
+
+    static const char* GetTagName(MemoryTag tag);
+    static bool IsGpuTag(MemoryTag tag) { return tag >= MemoryTag::Meshes && tag < MemoryTag::Count; }
+
+  private:
+    struct Counters {
+        std::atomic<int64_t> liveBytes{0};
+        std::atomic<int64_t> peakBytes{0};
+        std::atomic<int64_t> liveAllocations{0};
+        std::atomic<uint64_t> totalAllocations{0};
+    };
+
+    static Counters s_counters[static_cast<size_t>(MemoryTag::Count)];
+
+    static void AddBytes(Counters& counters, int64_t bytes);
+};
+
+// unique_ptr deleter for blocks from MemoryTracker::Allocate. Doesn't run destructors.
+struct TrackedDelete {
+    void operator()(void* block) const { MemoryTracker::Free(block); }
+};
+
+}  // namespace Blacksite
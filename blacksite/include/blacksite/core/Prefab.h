@@ -0,0 +1,35 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include "blacksite/core/ComponentStore.h"
+#include "blacksite/physics/Collider.h"
+
+namespace Blacksite {
+
+/**
+ * Prefab - Shared description of an entity, for spawning lots of the same thing
+ * Instances keep a reference to it and share its collider list (copy-on-write, see ColliderSet), so a
+ * thousand crates hold one collider vector between them - and one Jolt shape, through the physics shape
+ * cache. What differs per instance (transform, color, active state) lives in the ComponentStore as usual and
+ * can be changed like on any entity; collider edits on an instance copy the list for that instance only.
+ * Immutable once registered. Registering again under the same name replaces it for new instances, existing
+ * ones keep what they were made from.
+ */
+struct Prefab {
+    std::string name;
+    EntityShape::VisualShape shape = EntityShape::CUBE;
+    std::string shader{"basic"};
+    std::string mesh;     // MESH prefabs only
+    std::string texture;  // Empty = untextured
+    glm::vec3 color{1.0f};
+    glm::vec3 scale{1.0f};
+    ColliderSet colliders;  // Left empty, RegisterPrefab fills in the shape's default
+    bool hasPhysics = true;
+    bool isDynamic = true;
+    PhysicsLayer layer = PhysicsComponent::AUTO_LAYER;
+};
+
+using PrefabRef = std::shared_ptr<const Prefab>;
+
+}  // namespace Blacksite
@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef BS_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace Blacksite {
+
+// One finished scope. The name isn't copied, so it has to outlive the buffer (string literals, __func__).
+struct ProfileEvent {
+    const char* name = nullptr;
+    uint64_t startNs = 0;
+    uint64_t endNs = 0;
+};
+
+// Everything recorded under one name, summed over all threads
+struct ProfileScopeTotal {
+    std::string name;
+    uint64_t totalNs = 0;
+    uint32_t count = 0;
+};
+
+/**
+ * Profiler - CPU scopes into a ring buffer per thread, dumped as a Chrome trace (chrome://tracing, Perfetto)
+ * Off by default. While off a scope is one relaxed atomic load. Turn it on with BLACKSITE_PROFILE=1 or
+ * SetEnabled; each thread keeps its newest RING_SIZE events. Builds with BLACKSITE_TRACY also feed every
+ * scope to the Tracy client, and BLACKSITE_PROFILE_JOLT routes Jolt's internal zones through the same place.
+ */
+class Profiler {
+  public:
+    static void Initialize();  // Reads BLACKSITE_PROFILE, hooks up Jolt if it was built for it
+
+    static void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Shows up as the thread's row name in the trace. Call from the thread itself.
+    static void SetThreadName(const std::string& name);
+
+    static uint64_t Now();  // Nanoseconds, steady clock
+    static void Record(const char* name, uint64_t startNs, uint64_t endNs);
+
+    // Best with recording off - a thread writing while we read can tear its newest event
+    static bool ExportChromeTrace(const std::string& path);
+    static void Clear();
+
+    // What's in the rings right now, grouped by scope name. Clear, run a frame, read it -> that frame's times.
+    static std::vector<ProfileScopeTotal> GetScopeTotals();
+
+    static constexpr uint32_t RING_SIZE = 16 * 1024;  // Events per thread, about a second of a busy frame loop
+
+  private:
+    static std::atomic<bool> s_enabled;
+};
+
+class ProfileScope {
+  public:
+    explicit ProfileScope(const char* name) : m_name(name), m_startNs(Profiler::IsEnabled() ? Profiler::Now() : 0) {}
+    ~ProfileScope() {
+        if (m_startNs != 0) {
+            Profiler::Record(m_name, m_startNs, Profiler::Now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    const char* m_name;
+    uint64_t m_startNs;
+};
+
+}  // namespace Blacksite
+
+// Build with BLACKSITE_PROFILING=OFF (BS_PROFILE_OFF) to compile every scope out
+#define BS_PROFILE_CONCAT_INNER(a, b) a##b
+#define BS_PROFILE_CONCAT(a, b) BS_PROFILE_CONCAT_INNER(a, b)
+
+// BS_PROFILE_SCOPE wants a string literal, Tracy builds a static source location out of it
+#if defined(BS_PROFILE_OFF)
+#define BS_PROFILE_SCOPE(name) ((void)0)
+#define BS_PROFILE_FUNCTION() ((void)0)
+#define BS_PROFILE_FRAME() ((void)0)
+#elif defined(BS_TRACY)
+#define BS_PROFILE_SCOPE(name) \
+    ZoneScopedN(name);         \
+    ::Blacksite::ProfileScope BS_PROFILE_CONCAT(bsProfileScope, __LINE__)(name)
+#define BS_PROFILE_FUNCTION() \
+    ZoneScoped;               \
+    ::Blacksite::ProfileScope BS_PROFILE_CONCAT(bsProfileScope, __LINE__)(__func__)
+#define BS_PROFILE_FRAME() FrameMark
+#else
+#define BS_PROFILE_SCOPE(name) ::Blacksite::ProfileScope BS_PROFILE_CONCAT(bsProfileScope, __LINE__)(name)
+#define BS_PROFILE_FUNCTION() BS_PROFILE_SCOPE(__func__)
+#define BS_PROFILE_FRAME() ((void)0)
+#endif
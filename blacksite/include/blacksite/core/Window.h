@@ -13,7 +13,8 @@ namespace Blacksite {
         ~Window();
 
         // --- Create window with OpenGL context ---
-        bool Initialize(int width, int height, const std::string& title);
+        // visible = false keeps the window hidden and vsync off, for offscreen runs (benchmarks, tools)
+        bool Initialize(int width, int height, const std::string& title, bool visible = true);
         void Shutdown();
 
         // --- Window State checks ---
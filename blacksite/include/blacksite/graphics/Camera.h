@@ -1,6 +1,7 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "blacksite/graphics/Frustum.h"
 
 namespace Blacksite {
 
@@ -20,10 +21,15 @@ class Camera {
     // Matrix getters
     glm::mat4 GetViewMatrix() const;        // Where the camera is and what it's looking at
     glm::mat4 GetProjectionMatrix() const;  // The perspective transform
+    Frustum GetFrustum() const;             // World-space planes for culling, rebuilt on every call
 
     // Getters
     const glm::vec3& GetPosition() const { return m_position; }
     const glm::vec3& GetTarget() const { return m_target; }
+    float GetFov() const { return m_fov; }  // Vertical, degrees
+    float GetAspectRatio() const { return m_aspect; }
+    float GetNearPlane() const { return m_nearPlane; }
+    float GetFarPlane() const { return m_farPlane; }
 
   private:
     // Camera position and orientation
@@ -0,0 +1,74 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+#include "blacksite/graphics/DynamicBufferRing.h"
+
+namespace Blacksite {
+
+// One end of a debug line
+struct DebugVertex {
+    glm::vec3 position;
+    uint32_t color;  // RGBA8, red in the low byte
+};
+static_assert(sizeof(DebugVertex) == 16, "DebugDraw's attribute setup expects this layout");
+
+/**
+ * DebugDraw - Immediate-mode debug lines, the whole frame's worth in one GL_LINES draw
+ * Colliders, gizmos, physics debug output... anything adds lines during the frame, the renderer draws
+ * them after the scene and starts over. Shapes are just line lists, no meshes and no state changes per
+ * shape. Vertices go through the upload ring when there is one, an orphaned VBO otherwise.
+ * Main thread only.
+ */
+class DebugDraw {
+  public:
+    DebugDraw() = default;
+    ~DebugDraw() { Shutdown(); }
+    DebugDraw(const DebugDraw&) = delete;
+    DebugDraw& operator=(const DebugDraw&) = delete;
+
+    bool Initialize();  // Needs a GL context
+    void Shutdown();
+
+    void Line(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color);
+
+    // transform places the box, halfExtents are in its local space
+    void Box(const glm::mat4& transform, const glm::vec3& halfExtents, const glm::vec3& color);
+
+    // Three great circles
+    void Sphere(const glm::vec3& center, float radius, const glm::vec3& color);
+
+    // Along the transform's local Y. halfHeight is the cylinder part, the caps go on top of it.
+    void Capsule(const glm::mat4& transform, float radius, float halfHeight, const glm::vec3& color);
+
+    // axisU / axisV: unit length and perpendicular, they span the circle's plane
+    void Circle(const glm::vec3& center, const glm::vec3& axisU, const glm::vec3& axisV, float radius,
+                const glm::vec3& color);
+
+    // Uploads and draws everything added since the last call with whatever shader is bound, then clears.
+    // The ring may be uninitialized.
+    void Flush(DynamicBufferRing& ring);
+    void Clear() { m_vertices.clear(); }
+
+    bool IsEmpty() const { return m_vertices.empty(); }
+    size_t GetLineCount() const { return m_vertices.size() / 2; }
+
+    static uint32_t PackColor(const glm::vec3& color);
+
+    static constexpr int CIRCLE_SEGMENTS = 24;
+    static constexpr size_t MAX_LINES = 1u << 20;  // Per frame, anything past it is dropped
+
+  private:
+    std::vector<DebugVertex> m_vertices;
+    GLuint m_vao = 0;
+    GLuint m_vbo = 0;  // Only used without the ring
+    bool m_overflowWarned = false;
+
+    void Arc(const glm::vec3& center, const glm::vec3& axisU, const glm::vec3& axisV, float radius, float fromAngle,
+             float toAngle, int segments, uint32_t color);
+    void Push(const glm::vec3& from, const glm::vec3& to, uint32_t color);
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,75 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace Blacksite {
+
+/**
+ * DynamicBufferRing - Scratch GPU memory for everything that's rewritten every frame
+ * One persistently mapped, coherent buffer split into FRAMES_IN_FLIGHT slices. Allocate hands out ranges
+ * of the current slice to write straight into, no glBufferData/glBufferSubData and so nothing for the
+ * driver to stall on. A fence per slice keeps us from writing where the GPU may still be reading.
+ * The buffer works for any target: bind it as uniform range, vertex source, indirect buffer...
+ * Needs GL 4.4 or ARB_buffer_storage, without it Initialize fails and callers keep their old paths.
+ */
+class DynamicBufferRing {
+  public:
+    // Range of the current slice. Valid until the ring comes back around to this slice, three frames on.
+    struct Allocation {
+        void* data = nullptr;  // Mapped, write-only - don't read it back
+        GLintptr offset = 0;   // Into GetBuffer()
+        GLsizeiptr size = 0;
+
+        bool IsValid() const { return data != nullptr; }
+    };
+
+    DynamicBufferRing() = default;
+    ~DynamicBufferRing() { Shutdown(); }
+    DynamicBufferRing(const DynamicBufferRing&) = delete;
+    DynamicBufferRing& operator=(const DynamicBufferRing&) = delete;
+
+    static bool IsSupported();
+
+    bool Initialize(size_t sliceSize = INITIAL_SLICE_SIZE);
+    void Shutdown();
+    bool IsInitialized() const { return m_buffer != 0; }
+
+    // Moves on to the next slice and waits until the GPU is done with it. If the last frame ran out of room
+    // the ring is recreated bigger first, which changes GetBuffer() (and bumps GetGeneration()).
+    void BeginFrame();
+    void EndFrame();  // Fences the slice, call after the last draw that reads from it
+
+    // Invalid once the slice is full - fall back for the rest of the frame, the next one has room.
+    // alignment doesn't have to be a power of two: sizeof(InstanceData) works, so offset / stride can
+    // go straight into a draw's baseInstance.
+    Allocation Allocate(size_t bytes, size_t alignment = 16);
+
+    GLuint GetBuffer() const { return m_buffer; }
+    uint32_t GetGeneration() const { return m_generation; }  // Changes whenever the buffer does
+    size_t GetSliceSize() const { return m_sliceSize; }
+    size_t GetUsedBytes() const { return m_used; }  // In the current slice
+
+    // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, use it for anything bound with glBindBufferRange as a UBO
+    size_t GetUniformAlignment() const { return m_uniformAlignment; }
+
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+    static constexpr size_t INITIAL_SLICE_SIZE = 4 * 1024 * 1024;
+
+  private:
+    GLuint m_buffer = 0;
+    uint8_t* m_mapped = nullptr;
+    size_t m_sliceSize = 0;
+    size_t m_used = 0;
+    size_t m_shortfall = 0;  // Bytes that didn't fit this frame, the next BeginFrame grows by at least this
+    size_t m_uniformAlignment = 256;
+    uint32_t m_frame = 0;
+    uint32_t m_generation = 0;
+    GLsync m_fences[FRAMES_IN_FLIGHT] = {};
+
+    bool CreateBuffer(size_t sliceSize);
+    void DestroyBuffer();
+    void WaitForFence(uint32_t frame);
+};
+
+}  // namespace Blacksite
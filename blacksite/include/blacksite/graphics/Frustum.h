@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Blacksite {
+
+/**
+ * Frustum - Six world-space planes pulled out of a view-projection matrix
+ * Planes point inwards: dot(n, p) + d >= 0 means p is on the visible side
+ */
+struct Frustum {
+    enum Plane { LEFT = 0, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE, COUNT };
+
+    glm::vec4 planes[COUNT];  // xyz = normal, w = distance
+
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+    bool IntersectsSphere(const glm::vec3& center, float radius) const;
+    bool IntersectsAABB(const glm::vec3& min, const glm::vec3& max) const;
+
+    // Batch sphere test over structure-of-arrays data, visible[i] = 1 if sphere i touches the frustum.
+    // Plain loop over flat float arrays so the compiler can vectorize it.
+    void CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count,
+                     uint8_t* visible) const;
+};
+
+}  // namespace Blacksite
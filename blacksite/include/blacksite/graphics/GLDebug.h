@@ -0,0 +1,44 @@
+#pragma once
+#include <GL/glew.h>
+
+namespace Blacksite {
+
+/**
+ * GLDebug - Driver messages (KHR_debug) routed into the Logger
+ * On by default in debug builds (BS_GL_DEBUG, see the CMake option), off everywhere else - release never
+ * polls glGetError. For triage on a release build either set BLACKSITE_GL_DEBUG=1 in the environment
+ * (also asks for a debug context, which gets you the most detail) or call SetEnabled at runtime.
+ */
+class GLDebug {
+  public:
+    // Whether to start enabled: build default or the environment variable. Window asks before creating the context.
+    static bool IsRequestedAtStartup();
+
+    // Call once the context is current and GLEW is loaded
+    static void Initialize();
+
+    // Without KHR_debug, enabling falls back to polling glGetError in CheckErrors
+    static void SetEnabled(bool enable);
+    static bool IsEnabled() { return s_enabled; }
+    static bool HasDebugOutput() { return s_debugOutput; }
+
+    // Checkpoint for code that used to call glGetError itself. Free unless we're enabled and stuck polling.
+    static void CheckErrors(const char* operation) {
+        if (s_enabled && !s_debugOutput) {
+            PollErrors(operation);
+        }
+    }
+
+    // Logs and clears everything glGetError has queued, enabled or not. For code that checks glGetError
+    // itself - call it first, so someone else's leftover error isn't taken for (or hiding) our own.
+    static void PollErrors(const char* operation);
+
+  private:
+    static bool s_enabled;
+    static bool s_debugOutput;  // KHR_debug is there, messages come to us instead of being polled
+
+    static void GLAPIENTRY OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                          const GLchar* message, const void* userParam);
+};
+
+}  // namespace Blacksite
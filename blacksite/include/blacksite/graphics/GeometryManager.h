@@ -1,24 +1,58 @@
 #pragma once
 
 #include <GL/glew.h>
+#include <glm/glm.hpp>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "blacksite/graphics/MeshArena.h"
+#include "blacksite/graphics/RenderHandles.h"
 
 namespace Blacksite {
 
+struct MeshAsset;
+
 /**
  * Mesh - A collection of vertices that hopefully forms something recognizable
- * Contains all the OpenGL handles
+ * The geometry itself lives in the MeshArena, this is where to find it. Always indexed, draw with
+ * glDrawElementsBaseVertex with the allocation's offsets after binding VAO.
  */
 
+// A coarser stand-in for a mesh, used once it's smaller than screenSize on screen
+struct MeshLod {
+    MeshHandle mesh;
+    float screenSize = 0.0f;  // Bounding radius over the half-height of the view, 1 = fills the screen
+};
+
 struct Mesh {
-    unsigned int VAO = 0;
-    unsigned int VBO = 0;
-    unsigned int EBO = 0;
-    unsigned int indexCount = 0;
-    bool useIndices = false;
-    unsigned int vertexCount = 0;
+    unsigned int VAO = 0;      // Shared by every mesh with the same vertex layout
+    unsigned int instancedVAO = 0;  // Same, plus the per-instance attributes - only for instanced draws
+    MeshAllocation allocation;  // baseVertex / firstIndex / indexCount for the draw
+    unsigned int vertexStride = 0;  // Bytes per vertex on the GPU, depends on the VertexFormat it was packed with
+
+    // Local-space bounds, filled in from the vertex positions when the mesh is created
+    glm::vec3 boundsMin{0.0f};
+    glm::vec3 boundsMax{0.0f};
+    float boundingRadius = 0.0f;  // Around the mesh origin, not the box center
+
+    std::vector<MeshLod> lods;  // Finest first, empty for meshes that don't have any
+};
+
+/**
+ * VertexFormat - How meshes get packed into their VBO
+ * Input is always fp32 position + normal. Compact: fp16 positions (padded to 4) and 10:10:10:2 normals,
+ * 12 bytes per vertex instead of 24. The shaders still see vec3s, GL unpacks for us.
+ */
+struct VertexFormat {
+    bool halfPositions = true;       // Only for meshes where fp16 stays within maxPositionError
+    bool packedNormals = true;       // GL_INT_2_10_10_10_REV, plenty for lighting
+    float maxPositionError = 0.001f;  // Largest fp16 rounding we accept, in mesh units (world-space batches fail this)
+};
+
+// One mesh placed in the world, input for CreateStaticBatch
+struct StaticBatchPiece {
+    MeshHandle mesh;
+    glm::mat4 model{1.0f};
 };
 
 class GeometryManager {
@@ -34,21 +68,95 @@ class GeometryManager {
     void CreateSphere(const std::string& name = "sphere", float radius = 0.5f, int sectors = 30, int stacks = 30);
     void CreatePlane(const std::string& name = "plane");
 
+    // Sphere generation math, interleaved position + normal. No GL involved.
+    static void GenerateSphere(std::vector<float>& vertices, std::vector<unsigned int>& indices, float radius,
+                               int sectors, int stacks);
+
+    // Imported mesh (OBJ/FBX/glTF...). The first load goes through assimp and writes <path>.bsmesh next to
+    // the file, after that the cache gets memory-mapped and uploaded as-is until the source changes.
+    // Works from the cache alone too, if the source isn't there.
+    MeshHandle LoadMesh(const std::string& name, const std::string& path);
+
+    // Applies to meshes created after the call, set it before the renderer builds the primitives
+    void SetVertexFormat(const VertexFormat& format) { m_vertexFormat = format; }
+    const VertexFormat& GetVertexFormat() const { return m_vertexFormat; }
+
+    // Creates the shared per-instance buffer and hooks it into the arena VAOs (existing and future)
+    void InitializeInstancing();
+    GLuint GetInstanceBuffer() const { return m_instanceVBO; }
+
+    // Points the instance attributes at someone else's buffer instead (the renderer's indirect ring), 0 for ours
+    void SetInstanceSource(GLuint buffer) { m_arena.SetInstanceBuffer(buffer != 0 ? buffer : m_instanceVBO); }
+
     // Get mesh for rendering
     const Mesh* GetMesh(const std::string& name) const;
+    const Mesh* GetMesh(MeshHandle handle) const;  // Fast path, just an index
+
+    // Name -> handle, invalid handle if there's no such mesh
+    MeshHandle GetMeshHandle(const std::string& name) const;
+
+    // Bounding sphere radius for culling, 0 for invalid handles
+    float GetBoundingRadius(MeshHandle handle) const;
+
+    // Picks the LOD for something screenSize big on screen (see MeshLod). level is the caller's state from
+    // last frame and gets updated - going back to a finer level needs LOD_HYSTERESIS more size than leaving
+    // it did, so things sitting right at a threshold don't flicker between two meshes. Thread safe.
+    MeshHandle SelectLod(MeshHandle handle, float screenSize, uint8_t& level) const;
+    static constexpr float LOD_HYSTERESIS = 1.25f;
+
+    // Static batching - pre-transforms every piece into world space and packs them into one indexed
+    // VBO/EBO, so the lot is a single draw with an identity model matrix. Only meshes that kept their
+    // vertex data (the built-in primitives) can be batched, others are skipped with a warning.
+    // Same name again replaces the old batch in place and keeps the handle.
+    MeshHandle CreateStaticBatch(const std::string& name, const std::vector<StaticBatchPiece>& pieces);
+
+    // Frees the GPU buffers and forgets the name, LODs included. The handle goes stale, don't draw with it.
+    void DestroyMesh(MeshHandle handle);
 
     // Cleanup all the GPU resources
     void Cleanup();
 
   private:
-    // Geometry cache
-    std::unordered_map<std::string, Mesh> m_meshes;
+    // Geometry cache - handles index into m_meshes
+    std::vector<Mesh> m_meshes;
+    std::unordered_map<std::string, MeshHandle> m_meshHandles;
+
+    // CPU copy of the vertex data, same indices as m_meshes - empty unless the mesh can be batched
+    struct MeshData {
+        std::vector<float> vertices;  // Interleaved position + normal
+        std::vector<unsigned int> indices;
+    };
+    std::vector<MeshData> m_meshData;
+
+    // Puts a mesh in its slot (replacing whatever had that name before). Pass the vertex data to keep
+    // a CPU copy for static batching. Invalid (and the mesh freed) once the sort key is out of mesh ids.
+    MeshHandle StoreMesh(const std::string& name, const Mesh& mesh, const std::vector<float>* vertices = nullptr,
+                    const std::vector<unsigned int>* indices = nullptr);
+    void DeleteMesh(Mesh& mesh);  // Gives its arena ranges back
+
+    VertexFormat m_vertexFormat;
+
+    MeshArena m_arena;
+
+    // One instance buffer for everyone - the renderer refills it per batch
+    GLuint m_instanceVBO = 0;
+
+    // LOD switch points, level 1 first. Spheres get regenerated with fewer segments, imported meshes
+    // get clustered down at LOD_GRID_RESOLUTIONS.
+    static constexpr float LOD_SCREEN_SIZES[] = {0.2f, 0.07f, 0.025f};
+    static constexpr int LOD_GRID_RESOLUTIONS[] = {48, 20, 8};
+    static constexpr size_t MIN_LOD_TRIANGLES = 12;  // Past this it's not a mesh anymore
+
+    // Stores the LOD as <name>_lod<n> and appends it to the base mesh's chain
+    void AddLod(const std::string& name, MeshHandle base, const float* vertices, size_t floatCount,
+                const unsigned int* indices, size_t indexCount);
+    // Fills asset.lods from its base mesh, done once at import and then read back from the .bsmesh
+    static void SimplifyLods(MeshAsset& asset);
 
-    // Sphere generation math
-    void GenerateSphere(std::vector<float>& vertices, std::vector<unsigned int>& indices, float radius, int sectors,
-                        int stacks);
+    static void ComputeBounds(Mesh& mesh, const float* vertices, size_t floatCount);
 
-    // Creates the actual OpenGL mesh from vertex data
+    // Creates the actual OpenGL mesh from vertex data, packed per m_vertexFormat
     Mesh CreateMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices = {});
+    Mesh CreateMesh(const float* vertices, size_t floatCount, const unsigned int* indices, size_t indexCount);
 };
 }  // namespace Blacksite
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Blacksite {
+
+struct GpuZoneTiming {
+    std::string name;
+    float ms = 0.0f;
+};
+
+/**
+ * GpuProfiler - GL_TIME_ELAPSED around each pass, read back a few frames later without stalling
+ * Every frame gets its own slice of the query pool. When we come back around to a slice, its results are
+ * either there (we collect them) or the GPU is badly behind (we drop them, never wait). Zones can't nest,
+ * GL only allows one time-elapsed query at a time.
+ */
+class GpuProfiler {
+  public:
+    GpuProfiler() = default;
+    ~GpuProfiler() { Shutdown(); }
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    void Shutdown();  // Deletes the queries, call while the context is still current
+
+    void BeginFrame();  // Moves to the next slice, collecting what it held
+    void EndFrame();
+
+    void BeginZone(const std::string& name);
+    void EndZone();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_enabled; }
+
+    // The newest frame the GPU has finished, FRAME_LATENCY - 1 frames behind the CPU
+    const std::vector<GpuZoneTiming>& GetResults() const { return m_results; }
+    float GetZoneMs(const std::string& name) const;  // 0 if the zone didn't run
+    float GetFrameMs() const { return m_frameMs; }   // Sum of the zones, not including gaps between them
+    uint32_t GetDroppedFrames() const { return m_droppedFrames; }
+
+    // Frame totals for plotting, oldest at GetHistoryOffset()
+    static constexpr int HISTORY_SIZE = 120;
+    const float* GetFrameHistory() const { return m_history; }
+    int GetHistoryOffset() const { return m_historyIndex; }
+
+    static constexpr uint32_t FRAME_LATENCY = 3;
+
+  private:
+    struct FrameSlice {
+        std::vector<GLuint> queries;  // Grows to the most zones a frame has had, then stays
+        std::vector<std::string> names;
+        uint32_t used = 0;
+    };
+
+    FrameSlice m_slices[FRAME_LATENCY];
+    uint32_t m_slice = 0;
+    bool m_enabled = true;
+    bool m_inFrame = false;
+    bool m_inZone = false;
+
+    std::vector<GpuZoneTiming> m_results;
+    float m_frameMs = 0.0f;
+    uint32_t m_droppedFrames = 0;
+
+    float m_history[HISTORY_SIZE] = {};
+    int m_historyIndex = 0;
+
+    void Collect(FrameSlice& slice);
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,94 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Blacksite {
+
+class ShaderSystem;
+
+/**
+ * HiZBuffer - Max-depth pyramid of the scene, for occlusion culling on the CPU
+ * Build halves the depth texture on the GPU (farthest of every 2x2) until a level is small enough to read back,
+ * then copies that one into a pixel buffer. A frame or two later the copy is picked up without waiting and the
+ * CPU builds the remaining levels. Culling tests bounding spheres against that pyramid with the camera it was
+ * rendered with - something hidden from there is skipped. Being a few frames old, things can show up a frame
+ * or two late when the camera swings around a corner.
+ */
+class HiZBuffer {
+  public:
+    HiZBuffer() = default;
+    ~HiZBuffer() { Shutdown(); }
+    HiZBuffer(const HiZBuffer&) = delete;
+    HiZBuffer& operator=(const HiZBuffer&) = delete;
+
+    bool Initialize(ShaderSystem* shaderSystem);  // Needs the "hiz_downsample" shader
+    void Shutdown();
+
+    // Right after the scene pass. width/height is the part of depthTexture this frame rendered into,
+    // view/projection what it was rendered with. Skipped while the last readback is still in flight.
+    // Changes the framebuffer, viewport and program, the caller restores what it needs.
+    void Build(GLuint depthTexture, int width, int height, const glm::mat4& view, const glm::mat4& projection);
+    void Invalidate();  // Forget the CPU pyramid, e.g. after a camera cut
+
+    bool IsReady() const { return !m_levels.empty(); }
+
+    // False unless the sphere is certainly behind what the pyramid saw. Safe from any thread while
+    // nothing calls Build.
+    bool IsSphereOccluded(const glm::vec3& center, float radius) const;
+
+    // Clears visible[i] for the spheres that are occluded, leaves the rest alone. Returns how many it cleared.
+    size_t CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count,
+                       uint8_t* visible) const;
+
+    // Largest level that gets read back. 1080p reads 240x135 floats.
+    static constexpr int READBACK_MAX_SIZE = 256;
+
+  private:
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::vector<float> depth;
+    };
+
+    // GPU levels 1..m_readbackLevel, [0] is level 1 (level 0 is the depth texture itself)
+    struct GpuLevel {
+        GLuint texture = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    ShaderSystem* m_shaderSystem = nullptr;
+    GLuint m_fbo = 0;
+    GLuint m_vao = 0;  // Empty, the vertex shader makes its own triangle
+    std::vector<GpuLevel> m_gpuLevels;
+    int m_sourceWidth = 0;  // Depth size m_gpuLevels were made for
+    int m_sourceHeight = 0;
+
+    // Readback in flight
+    GLuint m_pbo = 0;
+    size_t m_pboSize = 0;
+    GLsync m_fence = nullptr;
+    int m_pendingLevel = 0;
+    int m_pendingWidth = 0;
+    int m_pendingHeight = 0;
+    int m_pendingDepthWidth = 0;
+    int m_pendingDepthHeight = 0;
+    glm::mat4 m_pendingViewProjection{1.0f};
+
+    // What culling reads: m_levels[i] is pyramid level m_firstLevel + i, down to 1x1
+    std::vector<Level> m_levels;
+    int m_firstLevel = 0;
+    int m_depthWidth = 0;  // Level 0, the depth it all came from
+    int m_depthHeight = 0;
+    glm::mat4 m_viewProjection{1.0f};
+
+    void ResizeGpuLevels(int width, int height);
+    void DestroyGpuLevels();
+    void PollReadback();  // Never waits
+    void BuildCpuLevels(const float* data, int width, int height);
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Blacksite {
+
+// 8 bit RGBA, top row first
+struct ImageData {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;
+};
+
+/**
+ * ImageLoader - Source images into RGBA8
+ * Only the formats we can read without pulling in an image library: TGA (true color/grayscale, raw or RLE)
+ * and uncompressed 24/32 bit BMP. No GL, safe from any thread.
+ */
+class ImageLoader {
+  public:
+    static bool Load(const std::string& path, ImageData& out);
+
+    // extension is lowercase with the dot, picks the decoder
+    static bool Decode(const uint8_t* data, size_t size, const std::string& extension, ImageData& out);
+
+    static bool IsSupported(const std::string& extension);
+
+    static constexpr uint32_t MAX_DIMENSION = 16384;
+    static constexpr uint64_t MAX_FILE_SIZE = 256ull * 1024 * 1024;
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,49 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include "blacksite/graphics/DynamicBufferRing.h"
+#include "blacksite/graphics/MeshArena.h"
+
+namespace Blacksite {
+
+// Layout GL expects in GL_DRAW_INDIRECT_BUFFER for glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;  // Where this draw's rows start in the instance buffer
+};
+
+/**
+ * IndirectDrawBuffer - Per-frame draw records and instance data, written straight into GPU memory
+ * Both come out of the renderer's DynamicBufferRing, which takes care of the fencing: the renderer fills
+ * this frame's ranges while the GPU is still reading older slices. Bind GetBuffer() as the indirect
+ * buffer and as the instance source, commands and instances are just different ranges of it.
+ * Needs GL 4.3 (multi-draw-indirect) + 4.4 (buffer storage) or the matching extensions.
+ */
+class IndirectDrawBuffer {
+  public:
+    static bool IsSupported();
+
+    // Carves out room for maxDraws instances and as many commands. False if the ring is out of space this
+    // frame - it grows for the next one, draw the plain way until then.
+    bool BeginFrame(DynamicBufferRing& ring, uint32_t maxDraws);
+
+    // This frame's ranges - index 0 here is GetInstanceBase() / GetCommandBase() in the whole buffer
+    InstanceData* GetInstances() const { return m_instances; }
+    DrawElementsIndirectCommand* GetCommands() const { return m_commands; }
+    uint32_t GetInstanceBase() const { return m_instanceBase; }  // For baseInstance
+    uint32_t GetCommandBase() const { return m_commandBase; }    // In commands, times the stride for the offset
+
+    GLuint GetBuffer() const { return m_buffer; }
+
+  private:
+    GLuint m_buffer = 0;
+    InstanceData* m_instances = nullptr;
+    DrawElementsIndirectCommand* m_commands = nullptr;
+    uint32_t m_instanceBase = 0;
+    uint32_t m_commandBase = 0;
+};
+
+}  // namespace Blacksite
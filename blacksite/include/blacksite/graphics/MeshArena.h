@@ -0,0 +1,119 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Blacksite {
+
+/**
+ * InstanceData - What the instanced shaders read per instance
+ * Model matrix lives at attribute locations 3-6, color at 7, entity id (integer attribute) at 8
+ */
+struct InstanceData {
+    glm::mat4 model{1.0f};
+    glm::vec3 color{1.0f};
+    uint32_t entityId = 0;  // Same as RenderCommand::entityId. Sits where color's alpha was, stride stays 80.
+};
+static_assert(sizeof(InstanceData) == 80, "The instance attribute offsets in MeshArena expect this layout");
+
+// Attribute layout of one vertex format - see VertexFormat for what the flags mean
+struct VertexLayout {
+    bool halfPositions = false;
+    bool packedNormals = false;
+
+    uint32_t PositionBytes() const { return halfPositions ? 4 * sizeof(uint16_t) : 3 * sizeof(float); }
+    uint32_t NormalBytes() const { return packedNormals ? sizeof(uint32_t) : 3 * sizeof(float); }
+    uint32_t Stride() const { return PositionBytes() + NormalBytes(); }
+    bool operator==(const VertexLayout& other) const {
+        return halfPositions == other.halfPositions && packedNormals == other.packedNormals;
+    }
+};
+
+// Where a mesh lives inside the arena. Indices are mesh-local, draws add baseVertex.
+struct MeshAllocation {
+    static constexpr uint32_t INVALID_POOL = 0xFFFFFFFFu;
+    uint32_t pool = INVALID_POOL;  // Which vertex format pool, picks the VAO
+    uint32_t baseVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+
+    bool IsValid() const { return pool != INVALID_POOL; }
+};
+
+/**
+ * MeshArena - All mesh geometry sub-allocated out of a few big GPU buffers
+ * One VBO + VAO per vertex layout, one index buffer shared by all of them. Switching between meshes of
+ * the same layout is just different draw offsets (glDrawElementsBaseVertex), no rebinding.
+ * Buffers grow by doubling and copy their contents over on the GPU, so allocations never move.
+ */
+class MeshArena {
+  public:
+    MeshArena() = default;
+    ~MeshArena() { Cleanup(); }
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+
+    // vertexData is already packed per layout. Invalid allocation if GL can't give us the memory.
+    MeshAllocation Allocate(const VertexLayout& layout, const void* vertexData, uint32_t vertexCount,
+                            const unsigned int* indices, uint32_t indexCount);
+    void Free(const MeshAllocation& allocation);
+
+    GLuint GetVertexArray(uint32_t pool) const { return pool < m_pools.size() ? m_pools[pool].vao : 0; }
+    // Same vertices plus the per-instance attributes, for instanced draws only
+    GLuint GetInstancedVertexArray(uint32_t pool) const {
+        return pool < m_pools.size() ? m_pools[pool].instancedVao : 0;
+    }
+    size_t GetPoolCount() const { return m_pools.size(); }
+
+    // Hooks the per-instance attributes (locations 3-8) into every pool's instanced VAO, now and later
+    void SetInstanceBuffer(GLuint instanceBuffer);
+
+    void Cleanup();
+
+    static constexpr uint32_t INITIAL_VERTEX_CAPACITY = 64 * 1024;  // Per pool
+    static constexpr uint32_t INITIAL_INDEX_CAPACITY = 256 * 1024;
+
+  private:
+    // First-fit free list over [0, capacity), neighbours merge back together on free
+    class RangeAllocator {
+      public:
+        bool Allocate(uint32_t size, uint32_t& outOffset);
+        void Free(uint32_t offset, uint32_t size);
+        void Grow(uint32_t newCapacity);
+        uint32_t GetCapacity() const { return m_capacity; }
+
+      private:
+        struct Range {
+            uint32_t offset;
+            uint32_t size;
+        };
+        std::vector<Range> m_free;  // Sorted by offset
+        uint32_t m_capacity = 0;
+    };
+
+    struct Pool {
+        VertexLayout layout;
+        GLuint vao = 0;
+        GLuint instancedVao = 0;  // Divisor attributes live here, so plain draws never read the instance buffer
+        GLuint vbo = 0;
+        RangeAllocator vertices;  // In vertices, not bytes - baseVertex needs whole vertices anyway
+    };
+
+    std::vector<Pool> m_pools;
+    GLuint m_indexBuffer = 0;
+    RangeAllocator m_indices;
+    GLuint m_instanceBuffer = 0;
+
+    uint32_t FindOrCreatePool(const VertexLayout& layout);
+    void SetupVertexAttributes(const Pool& pool);
+    void SetupInstanceAttributes(const Pool& pool);
+
+    // Bigger buffer, old contents copied over, VAOs re-pointed. False if GL ran out of memory.
+    bool GrowVertexBuffer(Pool& pool, uint32_t minCapacity);
+    bool GrowIndexBuffer(uint32_t minCapacity);
+    static GLuint ResizeBuffer(GLuint oldBuffer, size_t oldBytes, size_t newBytes);
+};
+
+}  // namespace Blacksite
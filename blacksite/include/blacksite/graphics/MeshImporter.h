@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "blacksite/core/MappedFile.h"
+
+namespace Blacksite {
+
+// Imported geometry in the engine's vertex layout - interleaved position + normal, 6 floats per vertex
+struct MeshAsset {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<MeshAsset> lods;  // Simplified levels, finest first - cached too, so loads never simplify
+};
+
+/**
+ * MeshCacheFile - A .bsmesh cache mapped straight into memory
+ * The vertex and index pointers point into the mapping, so uploading one is no parse and no copy.
+ * They're only good while the MeshCacheFile is open. Same for the LOD levels stored after the mesh.
+ */
+class MeshCacheFile {
+  public:
+    MeshCacheFile() = default;
+    ~MeshCacheFile() { Close(); }
+    MeshCacheFile(const MeshCacheFile&) = delete;
+    MeshCacheFile& operator=(const MeshCacheFile&) = delete;
+
+    // False if the cache is missing, malformed, or was built from a different version of the source.
+    // sourceStamp 0 skips the source check (the source isn't shipped, only the cache).
+    bool Open(const std::string& path, uint64_t sourceStamp);
+    void Close();
+
+    const float* GetVertices() const { return m_base.vertices; }
+    size_t GetVertexFloatCount() const { return m_base.vertexFloatCount; }
+    const unsigned int* GetIndices() const { return m_base.indices; }
+    size_t GetIndexCount() const { return m_base.indexCount; }
+
+    struct Level {
+        const float* vertices = nullptr;
+        size_t vertexFloatCount = 0;
+        const unsigned int* indices = nullptr;
+        size_t indexCount = 0;
+    };
+    size_t GetLodCount() const { return m_lods.size(); }
+    const Level& GetLod(size_t index) const { return m_lods[index]; }
+
+  private:
+    MappedFile m_file;
+    Level m_base;
+    std::vector<Level> m_lods;
+};
+
+/**
+ * MeshImporter - OBJ/FBX/glTF (anything assimp reads) into a MeshAsset, plus the .bsmesh cache
+ * The whole file is flattened into one mesh with the node transforms baked in, welded by assimp and
+ * then run through MeshOptimizer, so the cache stores the optimized order and loads skip all of it.
+ */
+class MeshImporter {
+  public:
+    static bool Import(const std::string& sourcePath, MeshAsset& out);
+
+    // Written next to the source as <source>.bsmesh, via a temp file so a half-written cache never gets mapped
+    static bool WriteCache(const std::string& cachePath, uint64_t sourceStamp, const MeshAsset& mesh);
+    static std::string GetCachePath(const std::string& sourcePath) { return sourcePath + ".bsmesh"; }
+
+    // Size + modification time of the source folded together, 0 if the file doesn't exist
+    static uint64_t GetSourceStamp(const std::string& sourcePath);
+
+    static constexpr uint32_t CACHE_VERSION = 3;  // 2: index order from MeshOptimizer, 3: LOD chain
+    static constexpr uint32_t MAX_CACHED_LODS = 8;
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace Blacksite {
+
+/**
+ * MeshOptimizer - Index/vertex reordering for interleaved position + normal meshes (6 floats per vertex)
+ * Run Optimize on anything before it goes to the GPU: unindexed meshes get indexed, triangles get ordered
+ * so the post-transform cache hits, and vertices get laid out in the order they're first used.
+ */
+class MeshOptimizer {
+  public:
+    // All three below in the right order
+    static void Optimize(std::vector<float>& vertices, std::vector<unsigned int>& indices);
+
+    // Merges bit-identical vertices and builds the index buffer (indices must be empty)
+    static void WeldVertices(std::vector<float>& vertices, std::vector<unsigned int>& indices);
+
+    // Forsyth's linear-speed vertex cache optimization, only touches the index order
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+    // Renumbers vertices by first use so fetches walk the VBO forwards, drops unreferenced ones
+    static void OptimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices);
+
+    // Vertex clustering for LODs: snaps vertices to a grid with gridResolution cells along the longest
+    // axis, merges each cell (split by rough normal direction so hard edges survive) and drops the
+    // triangles that collapsed. Fast and crude, only meant for meshes seen from far off. Output is indexed
+    // but not reordered, run Optimize on it after.
+    static void SimplifyClustered(const float* vertices, size_t floatCount, const unsigned int* indices,
+                                  size_t indexCount, int gridResolution, std::vector<float>& outVertices,
+                                  std::vector<unsigned int>& outIndices);
+
+    static constexpr size_t FLOATS_PER_VERTEX = 6;
+};
+
+}  // namespace Blacksite
@@ -1,11 +1,23 @@
 #pragma once
 #include <GL/glew.h>
+#include <glm/glm.hpp>
 #include <string>
+#include <vector>
+#include "blacksite/graphics/RenderGraph.h"
+#include "blacksite/graphics/RenderTargetPool.h"
 
 namespace Blacksite {
 
+class GpuProfiler;
 class ShaderSystem;
 
+// How much of the bloom mip chain to run - Low for weak GPUs, High when it's the look you're going for
+enum class BloomQuality {
+    Low,     // Starts at quarter res, 4 mips, 11:11:10 float
+    Medium,  // Half res, 5 mips, 11:11:10 float
+    High,    // Half res, 6 mips, RGBA16F
+};
+
 struct PostProcessSettings {
     bool enableBloom = true;
     bool enableFXAA = true;
@@ -15,19 +27,27 @@ struct PostProcessSettings {
     // Bloom
     float bloomThreshold = 1.2f;  // Only really bright pixels bloom (prevents flashlight vomit)
     float bloomStrength = 0.6f;   // Less aggressive glow
-    int bloomBlurPasses = 3;      // Less blur for sharper bloom edges
+    BloomQuality bloomQuality = BloomQuality::Medium;  // Changing it rebuilds the chain on the next frame
+    float bloomRadius = 1.0f;   // Upsample tent size in texels, bigger = softer and wider
 
     // Tonemapping & exposure
     float exposure = 1.1f;  // Slightly boosted but not overblown
     float gamma = 2.0f;     // Less contrasty than 2.2, keeps mids readable
-};
 
-struct FrameBuffer {
-    GLuint FBO = 0;
-    GLuint colorTexture = 0;
-    GLuint depthTexture = 0;
-    int width = 0;
-    int height = 0;
+    // One compute dispatch for composite + tone map + FXAA when GL 4.3 is there, quad passes otherwise
+    bool useComputePath = true;
+
+    // Dynamic resolution - the scene renders into part of the main target and the last pass (FXAA, or the
+    // composite without it) stretches it to the window. The scale follows GPU frame time, so it needs the
+    // GpuProfiler running.
+    bool dynamicResolution = false;
+    float gpuBudgetMs = 14.0f;  // Leaves some room under 16.6 ms for the UI and the swap
+    float minRenderScale = 0.5f;
+    float maxRenderScale = 1.0f;
+
+    // Entity ids per pixel (R32UI) next to the scene color, for RequestPick. 4 more bytes a pixel and a clear.
+    // Takes effect on the next BeginFrame.
+    bool entityIdBuffer = false;
 };
 
 class PostProcessManager {
@@ -43,23 +63,56 @@ class PostProcessManager {
     void EndFrame();
 
     PostProcessSettings& GetSettings() { return m_settings; }
+    void SetGpuProfiler(GpuProfiler* profiler) { m_gpuProfiler = profiler; }  // Not owned, null = no timings
 
     void RenderDebugUI();
 
     GLuint GetSceneTexture() const { return m_mainBuffer.colorTexture; }
+    // The scene texture can be bigger than the viewport, this is the part that has the image (bottom-left)
+    glm::vec2 GetSceneUvScale() const;
     GLuint GetDepthTexture() const { return m_mainBuffer.depthTexture; }
     bool IsInitialized() const { return m_initialized; }
 
     // Optional: Get specific buffer textures
     GLuint GetMainColorTexture() const { return m_mainBuffer.colorTexture; }
-    GLuint GetBloomTexture() const { return m_bloomBuffer.colorTexture; }
+    GLuint GetBloomTexture() const { return m_bloomMips.empty() ? 0 : m_bloomMips[0].colorTexture; }  // In EndFrame
+
+    bool IsComputePathAvailable() const { return m_computeAvailable; }
+
+    // What the scene actually renders at this frame, window size times the render scale
+    float GetRenderScale() const { return m_renderScale; }
+    int GetRenderWidth() const { return m_renderWidth; }
+    int GetRenderHeight() const { return m_renderHeight; }
+
+    // Picking - x/y are window pixels, bottom-left origin. The one-pixel read is queued at the end of the frame
+    // into a pixel buffer and PollPick hands the result over once the GPU got there, a frame or two later.
+    // Nothing ever waits on it. Needs settings.entityIdBuffer.
+    void RequestPick(int x, int y);
+    bool PollPick(int& entityId);  // False while nothing new has arrived, entityId -1 = background
+    bool IsEntityIdBufferActive() const { return m_entityIdTexture != 0; }
+    GLuint GetEntityIdTexture() const { return m_entityIdTexture; }
+
+    // Last EndFrame's passes in order, culled ones included
+    const std::vector<RenderPassTiming>& GetPassTimings() const { return m_graph.GetTimings(); }
+    RenderGraph& GetRenderGraph() { return m_graph; }
 
   private:
-    // Core functionality
-    void CreateFrameBuffers();
-    void DeleteFrameBuffers();
-    bool CreateFrameBuffer(FrameBuffer& fb, int width, int height, bool needDepth);
+    // Core functionality - everything comes out of m_targetPool
+    bool AcquireMainBuffer(int textureWidth, int textureHeight);
+    bool AcquireTarget(FrameBuffer& fb, int width, int height, int textureWidth, int textureHeight, bool needDepth,
+                       GLenum colorFormat = GL_RGBA16F);
+    std::vector<RenderResource> DeclareBloomChain();  // Transient targets in m_graph, largest first
+    void BuildGraph();
     void CreateScreenQuad();
+    void UpdateRenderScale();  // Dynamic resolution controller, once per frame
+    void ApplyRenderScale();   // Fits the render size and the main buffer's used area to m_renderScale
+
+    // Entity id attachment - lives on the main FBO as color attachment 1, follows it through resizes
+    void UpdateEntityIdBuffer();
+    bool AttachEntityIdBuffer();
+    void DetachEntityIdBuffer();  // Before the main buffer goes back to the pool, it must come back clean
+    void IssuePickRead();
+    void ResolvePick();
 
     // Rendering
     void BindFrameBuffer(const FrameBuffer& fb);
@@ -67,30 +120,58 @@ class PostProcessManager {
     void RenderScreenQuad();
 
     // Post-processing pipeline
-    void ExtractBloom();
-    void BlurBloom();
+    void DownsampleBloom();  // Scene -> mip 0 (bright pass) -> ... -> smallest mip
+    void UpsampleBloom();    // Back up again, each mip adds onto the one above. Result ends up in mip 0.
     void CombineAndToneMap();
     void ApplyFXAA();
+    void CompositeCompute();  // CombineAndToneMap + ApplyFXAA in one dispatch, then a blit to the screen
 
     // Debugging
     void DebugFrameBuffers();
     void CheckGLError(const std::string& operation);
     bool ValidateShader(const std::string& shaderName);
 
+    // Shrinking less than this (per axis) keeps the textures and renders into a sub-rect
+    static constexpr float SHRINK_HYSTERESIS = 0.75f;
+
+    // Render scale moves in these steps, faster down than up so a heavy frame recovers quickly
+    static constexpr float RENDER_SCALE_STEP = 0.05f;
+    static constexpr float MAX_SCALE_DOWN = 0.15f;
+    static constexpr float MAX_SCALE_UP = 0.05f;
+
     // Member variables
     ShaderSystem* m_shaderSystem = nullptr;
+    GpuProfiler* m_gpuProfiler = nullptr;
     PostProcessSettings m_settings;
 
-    int m_width = 0;
+    int m_width = 0;   // Window (output) size
     int m_height = 0;
+    int m_renderWidth = 0;  // Scene size, <= the window
+    int m_renderHeight = 0;
+    float m_renderScale = 1.0f;
+    float m_smoothedGpuMs = 0.0f;
+    int m_lastGpuSample = -1;  // GpuProfiler history offset we last read
+    int m_scaleCooldown = 0;   // GPU samples to skip after a change, they were measured at the old size
     bool m_initialized = false;
+    bool m_computeAvailable = false;  // "composite_fxaa" loaded, GL 4.3 or the extensions
 
-    // Framebuffers
+    // Framebuffers - main lives until the next real resize, the others are graph transients
+    RenderTargetPool m_targetPool;
+    RenderGraph m_graph;
     FrameBuffer m_mainBuffer;
-    FrameBuffer m_bloomBuffer;
-    FrameBuffer m_blurBuffer1;
-    FrameBuffer m_blurBuffer2;
-    FrameBuffer m_fxaaBuffer;
+    std::vector<FrameBuffer> m_bloomMips;  // Largest first. Set by the graph for the pass that's running.
+    FrameBuffer m_fxaaBuffer;  // Same, the LDR target. Also what the compute path writes into.
+
+    // Entity id buffer + picking
+    GLuint m_entityIdTexture = 0;
+    GLuint m_entityIdFBO = 0;  // The main FBO it's attached to
+    GLuint m_pickBuffer = 0;   // GL_PIXEL_PACK_BUFFER, one uint
+    GLsync m_pickFence = nullptr;
+    bool m_pickRequested = false;
+    bool m_pickReady = false;
+    int m_pickX = 0;
+    int m_pickY = 0;
+    uint32_t m_pickValue = 0;  // Entity id + 1, 0 = nothing there
 
     // Screen quad
     GLuint m_quadVAO = 0;
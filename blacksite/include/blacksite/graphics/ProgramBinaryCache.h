@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Blacksite {
+
+/**
+ * ProgramBinaryCache - Linked GL programs saved to disk with glGetProgramBinary
+ * One <name>.bsprog per program, keyed by a hash of its sources plus the vendor/renderer/version strings,
+ * so an edited shader or a driver update just misses and gets compiled (and stored) again.
+ * Does nothing if the driver has no binary formats (some report zero even with GL 4.1).
+ */
+class ProgramBinaryCache {
+  public:
+    // Call with the context current. Empty directory or no driver support leaves the cache off.
+    bool Initialize(const std::string& directory);
+    bool IsEnabled() const { return m_enabled; }
+
+    // Null sources are skipped, so vertex+fragment and compute use the same call
+    uint64_t MakeKey(const char* sourceA, const char* sourceB = nullptr) const;
+
+    // A linked program on a hit, 0 on a miss or if the driver refused the binary
+    unsigned int Load(const std::string& name, uint64_t key) const;
+
+    // Before glLinkProgram, otherwise some drivers won't hand the binary back afterwards
+    void PrepareForLink(unsigned int program) const;
+    // Written via a temp file, so a crash mid-write never leaves a cache that looks valid
+    bool Store(const std::string& name, uint64_t key, unsigned int program) const;
+
+    static constexpr uint32_t CACHE_VERSION = 1;
+
+  private:
+    bool m_enabled = false;
+    std::string m_directory;
+    uint64_t m_driverHash = 0;
+    std::vector<int> m_formats;  // GL_PROGRAM_BINARY_FORMATS, anything else in a file is stale
+
+    std::string GetCachePath(const std::string& name) const { return m_directory + name + ".bsprog"; }
+};
+
+}  // namespace Blacksite
@@ -1,16 +1,47 @@
 #pragma once
+#include <cassert>
+#include <cstdint>
 #include <glm/glm.hpp>
-#include <string>
+#include "blacksite/graphics/RenderHandles.h"
 #include "blacksite/math/Transform.h"
 
 namespace Blacksite {
 
 
 struct RenderCommand {
-    std::string meshName;               // What geometry to draw
-    Transform transform;                // Where to put it and how big
+    MeshHandle mesh;                    // What geometry to draw
+    glm::mat4 model{1.0f};              // Where to put it and how big (already built from a Transform)
     glm::vec3 color{1.0f, 1.0f, 1.0f};  // What color (white by default)
-    std::string shaderName = "basic";   // Which shader to use
+    ShaderHandle shader;                // Which shader to use (Renderer::GetShaderHandle)
+    uint32_t entityId = 0;              // Entity id + 1 for the picking buffer, 0 = not pickable
+    TextureHandle texture;              // Optional, invalid = untextured (Renderer::GetTextureHandle)
+
+    // Filled in by Renderer::Submit - shader | mesh | texture | depth, so sorting groups state changes together
+    uint64_t sortKey = 0;
 };
 
-}  // namespace Blacksite
\ No newline at end of file
+// Sort key layout (most significant first):
+//   [63..48] shader id    - program switches are the most expensive, so they go on top
+//   [47..32] mesh id      - groups draws into batches (meshes only switch VAO across vertex layouts)
+//   [31..20] texture id+1 - 0 for untextured, a batch is one mesh with one texture
+//   [19..0]  depth        - front-to-back within a batch to help early-z, top bits of the float are plenty
+namespace RenderSortKey {
+constexpr int SHADER_SHIFT = 48;
+constexpr int MESH_SHIFT = 32;
+constexpr int TEXTURE_SHIFT = 20;
+constexpr uint64_t ID_MASK = 0xFFFF;
+constexpr uint64_t TEXTURE_MASK = 0xFFF;
+// Past this two ids would share a key and Flush would batch them together, so the managers refuse to hand one out
+constexpr uint32_t MAX_ID = uint32_t(ID_MASK);
+
+inline uint64_t Make(uint32_t shaderId, uint32_t meshId, uint32_t textureSlot, uint32_t depthBits) {
+    assert(shaderId <= MAX_ID && meshId <= MAX_ID && textureSlot <= TEXTURE_MASK);
+    return ((uint64_t(shaderId) & ID_MASK) << SHADER_SHIFT) | ((uint64_t(meshId) & ID_MASK) << MESH_SHIFT) |
+           ((uint64_t(textureSlot) & TEXTURE_MASK) << TEXTURE_SHIFT) | uint64_t(depthBits >> (32 - TEXTURE_SHIFT));
+}
+
+inline uint32_t ShaderId(uint64_t key) { return uint32_t((key >> SHADER_SHIFT) & ID_MASK); }
+inline uint32_t MeshId(uint64_t key) { return uint32_t((key >> MESH_SHIFT) & ID_MASK); }
+}  // namespace RenderSortKey
+
+}  // namespace Blacksite
@@ -0,0 +1,90 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "blacksite/graphics/RenderTargetPool.h"
+
+namespace Blacksite {
+
+using RenderResource = uint32_t;
+constexpr RenderResource INVALID_RENDER_RESOURCE = UINT32_MAX;
+
+// What a transient target should look like - width/height is the part that gets rendered
+struct RenderTargetDesc {
+    int width = 0;
+    int height = 0;
+    int textureWidth = 0;
+    int textureHeight = 0;
+    GLenum colorFormat = GL_RGBA16F;
+    bool needDepth = false;
+};
+
+class GpuProfiler;
+
+struct RenderPassTiming {
+    std::string name;
+    float gpuMs = 0.0f;  // From the GpuProfiler, so a couple of frames old
+    bool culled = false;
+};
+
+/**
+ * RenderGraph - Passes declare what they read and write, the graph works out the rest
+ * Rebuilt every frame: Reset, Import/CreateTarget, AddPass + Read/Write, Execute. Passes run in the order
+ * they were added. Anything that doesn't end up feeding an output (see Import) is culled. Transient targets
+ * are only taken from the pool for their first to last use, so ones that don't overlap share textures.
+ */
+class RenderGraph {
+  public:
+    using ExecuteFn = std::function<void(const RenderGraph&)>;
+    using PassHandle = uint32_t;
+
+    RenderGraph() = default;
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    void Reset();  // Drops last frame's passes and resources, the timings stay
+
+    // Something that lives outside the graph (the scene buffer, the screen). Outputs keep their writers alive.
+    RenderResource Import(const std::string& name, const FrameBuffer& fb, bool isOutput = false);
+    RenderResource CreateTarget(const std::string& name, const RenderTargetDesc& desc);
+
+    PassHandle AddPass(const std::string& name, ExecuteFn execute);
+    void Read(PassHandle pass, RenderResource resource);
+    void Write(PassHandle pass, RenderResource resource);
+
+    void Execute(RenderTargetPool& pool, GpuProfiler* profiler = nullptr);  // One GPU zone per live pass
+
+    // Only valid inside a pass that declared the resource
+    const FrameBuffer& GetTarget(RenderResource resource) const { return m_resources[resource].fb; }
+
+    const std::vector<RenderPassTiming>& GetTimings() const { return m_timings; }
+
+  private:
+    struct Resource {
+        std::string name;
+        RenderTargetDesc desc;
+        FrameBuffer fb;
+        bool imported = false;
+        bool isOutput = false;
+        uint32_t firstPass = UINT32_MAX;  // Live passes only, filled in by Compile
+        uint32_t lastPass = 0;
+    };
+
+    struct Pass {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<RenderResource> reads;
+        std::vector<RenderResource> writes;
+        bool culled = false;
+    };
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<RenderPassTiming> m_timings;
+
+    void Compile();  // Culling + lifetimes
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+namespace Blacksite {
+
+/**
+ * RenderHandle - A small index that stands in for a mesh/shader/texture name
+ * Resolve the name once (GetMeshHandle / GetShaderHandle), then pass the handle around.
+ * Handles stay valid across shader hot reloads since reloading reuses the same slot.
+ */
+template <typename Tag>
+struct RenderHandle {
+    static constexpr uint32_t INVALID_ID = 0xFFFFFFFFu;
+    uint32_t id = INVALID_ID;
+
+    constexpr RenderHandle() = default;
+    constexpr explicit RenderHandle(uint32_t handleId) : id(handleId) {}
+
+    constexpr bool IsValid() const { return id != INVALID_ID; }
+    constexpr bool operator==(const RenderHandle& other) const { return id == other.id; }
+    constexpr bool operator!=(const RenderHandle& other) const { return id != other.id; }
+};
+
+using MeshHandle = RenderHandle<struct MeshHandleTag>;
+using ShaderHandle = RenderHandle<struct ShaderHandleTag>;
+using TextureHandle = RenderHandle<struct TextureHandleTag>;
+
+}  // namespace Blacksite
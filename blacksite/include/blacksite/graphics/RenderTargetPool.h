@@ -0,0 +1,63 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Blacksite {
+
+struct FrameBuffer {
+    GLuint FBO = 0;
+    GLuint colorTexture = 0;
+    GLuint depthTexture = 0;
+    int width = 0;  // What we render into, from the bottom-left corner
+    int height = 0;
+    int textureWidth = 0;  // What's allocated, >= width/height
+    int textureHeight = 0;
+};
+
+/**
+ * RenderTargetPool - Framebuffers handed out by texture size + format and taken back when a pass is done
+ * Released targets stay allocated, so a pass asking for the same thing next frame gets them back for free.
+ * Anything nobody has asked for in EVICT_FRAMES frames gets deleted. Sizes go in as-is, round them with
+ * BucketSize first so nearby sizes land on the same textures.
+ */
+class RenderTargetPool {
+  public:
+    RenderTargetPool() = default;
+    ~RenderTargetPool() { Clear(); }
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    // out's width/height start out as the whole texture, shrink them to render into a sub-rect
+    bool Acquire(FrameBuffer& out, int textureWidth, int textureHeight, GLenum colorFormat, bool needDepth);
+    void Release(const FrameBuffer& fb);
+
+    void EndFrame();  // Ages the free targets and evicts the stale ones
+    void Clear();     // Deletes everything, in use or not
+
+    size_t GetTargetCount() const { return m_targets.size(); }
+    size_t GetAllocatedBytes() const;
+
+    static int BucketSize(int size);  // Rounded up to a BUCKET_SIZE multiple
+
+    static constexpr int BUCKET_SIZE = 64;
+    static constexpr uint32_t EVICT_FRAMES = 30;  // Half a second at 60, long enough to survive a splitter drag back
+
+  private:
+    struct Target {
+        FrameBuffer fb;
+        GLenum colorFormat = GL_RGBA16F;
+        bool hasDepth = false;
+        bool inUse = false;
+        uint32_t lastUsedFrame = 0;
+    };
+
+    std::vector<Target> m_targets;
+    uint32_t m_frame = 0;
+
+    static bool CreateTarget(Target& target);
+    static void DeleteTarget(Target& target);
+};
+
+}  // namespace Blacksite
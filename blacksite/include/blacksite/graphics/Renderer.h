@@ -1,14 +1,39 @@
 #pragma once
+#include <chrono>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "blacksite/core/Entity.h"
+#include "blacksite/core/FrameArena.h"
 #include "Camera.h"
 #include "GeometryManager.h"
+#include "DebugDraw.h"
+#include "DynamicBufferRing.h"
+#include "GpuProfiler.h"
+#include "HiZBuffer.h"
+#include "IndirectDrawBuffer.h"
 #include "PostProcessManager.h"
 #include "RenderCommand.h"
+#include "RenderGraph.h"
 #include "ShaderSystem.h"
+#include "ShadowCascades.h"
+#include "TextureManager.h"
 
 namespace Blacksite {
 
+// What the last Flush() actually did - handy for spotting state churn
+struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint32_t shaderBinds = 0;
+    uint32_t meshBinds = 0;  // Actual VAO switches, one per vertex layout at best
+    uint32_t textureBinds = 0;
+    uint32_t instancedBatches = 0;  // How many of the draw calls were instanced
+    uint32_t instancedObjects = 0;  // ...and how many objects they covered
+    uint32_t indirectCommands = 0;  // Draw records behind the multi-draw calls (one per mesh per bucket)
+    uint32_t debugLines = 0;        // DebugDraw lines, all in one of the draw calls
+    uint32_t prepassDraws = 0;      // Depth-only occluder draws, counted in drawCalls too
+};
+
 class Renderer {
   public:
     Renderer();
@@ -32,9 +57,122 @@ class Renderer {
                     const glm::vec3& color = glm::vec3(1.0f));
     void DrawPlane(const Transform& transform, const std::string& shaderName, const glm::vec3& color = glm::vec3(1.0f));
 
+    // Handle versions - resolve once, skip the string lookups every frame
+    void DrawCube(const Transform& transform, ShaderHandle shader, const glm::vec3& color = glm::vec3(1.0f));
+    void DrawSphere(const Transform& transform, ShaderHandle shader, const glm::vec3& color = glm::vec3(1.0f));
+    void DrawPlane(const Transform& transform, ShaderHandle shader, const glm::vec3& color = glm::vec3(1.0f));
+    void DrawMesh(MeshHandle mesh, const Transform& transform, ShaderHandle shader,
+                  const glm::vec3& color = glm::vec3(1.0f));
+
+    MeshHandle GetMeshHandle(const std::string& meshName) const;
+    // Unknown names get "basic" instead, with one warning per name rather than one per lookup
+    ShaderHandle GetShaderHandle(const std::string& shaderName) const;
+
     // Advanced rendering
     void Submit(const RenderCommand& command);  // Queue up a draw command
-    void Flush();                               // Execute all queued commands
+    void Flush();                               // Sort and execute all queued commands
+
+    // For commands built off-thread: model matrix and sortKey (BuildSortKey) must already be filled in.
+    // Copies them into the queue and leaves 'commands' empty.
+    void SubmitPrebuilt(FrameVector<RenderCommand>& commands);
+    uint64_t BuildSortKey(const RenderCommand& command) const;  // Safe to call from worker threads
+
+    MeshHandle GetCubeMesh() const { return m_cubeMesh; }
+    MeshHandle GetSphereMesh() const { return m_sphereMesh; }
+    MeshHandle GetPlaneMesh() const { return m_planeMesh; }
+    float GetMeshBoundingRadius(MeshHandle mesh) const { return m_geometryManager.GetBoundingRadius(mesh); }
+
+    // LOD for a mesh at this screen size, see GeometryManager::SelectLod. Fine from worker threads.
+    MeshHandle SelectLod(MeshHandle mesh, float screenSize, uint8_t& level) const {
+        return m_geometryManager.SelectLod(mesh, screenSize, level);
+    }
+
+    // Static batches live in the GeometryManager like any other mesh, see GeometryManager::CreateStaticBatch
+    MeshHandle CreateStaticBatch(const std::string& name, const std::vector<StaticBatchPiece>& pieces) {
+        return m_geometryManager.CreateStaticBatch(name, pieces);
+    }
+    void DestroyMesh(MeshHandle mesh) { m_geometryManager.DestroyMesh(mesh); }
+
+    // Vertex packing for new meshes - call before Initialize to get the primitives too
+    void SetVertexFormat(const VertexFormat& format) { m_geometryManager.SetVertexFormat(format); }
+    const VertexFormat& GetVertexFormat() const { return m_geometryManager.GetVertexFormat(); }
+
+    // Imported meshes, cached as .bsmesh after the first load - see GeometryManager::LoadMesh
+    MeshHandle LoadMesh(const std::string& name, const std::string& path) {
+        return m_geometryManager.LoadMesh(name, path);
+    }
+    bool GetMeshBounds(MeshHandle mesh, glm::vec3& outMin, glm::vec3& outMax) const;
+
+    // Block-compressed textures with streamed mips, cached as .bstex - see TextureManager. Put the handle in
+    // RenderCommand::texture to draw with one, Flush tells the streamer how big it ended up on screen.
+    TextureHandle LoadTexture(const std::string& name, const std::string& path) {
+        return m_textureManager.LoadTexture(name, path);
+    }
+    TextureHandle GetTextureHandle(const std::string& name) const { return m_textureManager.GetTextureHandle(name); }
+    void DestroyTexture(TextureHandle texture) { m_textureManager.DestroyTexture(texture); }
+    TextureManager& GetTextureManager() { return m_textureManager; }
+
+    // Transform math - pure function, fine to call from any thread
+    static glm::mat4 CreateModelMatrix(const Transform& transform);
+
+    const RenderStats& GetRenderStats() const { return m_renderStats; }
+
+    // GPU time per pass (shadows, scene, every post pass), a few frames behind. Off = no queries issued at all.
+    const std::vector<GpuZoneTiming>& GetGpuTimings() const { return m_gpuProfiler.GetResults(); }
+    GpuProfiler& GetGpuProfiler() { return m_gpuProfiler; }
+
+    // Instancing - batches of the same mesh + shader collapse into one draw when the shader has an instanced twin
+    void SetInstancingEnabled(bool enable) { m_instancingEnabled = enable; }
+    bool IsInstancingEnabled() const { return m_instancingEnabled; }
+
+    // Indirect mode - every instanced batch becomes a record in a GPU buffer and each shader + vertex layout
+    // bucket goes out as one glMultiDrawElementsIndirect. Falls back to plain instancing without GL 4.4.
+    void SetIndirectDrawEnabled(bool enable) { m_indirectDrawEnabled = enable; }
+    bool IsIndirectDrawEnabled() const { return m_indirectDrawEnabled; }
+    bool IsIndirectDrawSupported() const { return m_indirectDrawSupported; }
+
+    // Per-frame scratch GPU memory (FrameData, instance rows, indirect records), see DynamicBufferRing.
+    // Not initialized without buffer storage, everything falls back to glBufferData then.
+    DynamicBufferRing& GetUploadRing() { return m_uploadRing; }
+
+    // Depth pre-pass - commands whose bounding sphere covers at least minScreenSize of the view (radius over
+    // the half-height, like MeshLod::screenSize) first draw depth only, so what they hide never gets shaded
+    void SetDepthPrepassEnabled(bool enable) { m_depthPrepassEnabled = enable; }
+    bool IsDepthPrepassEnabled() const { return m_depthPrepassEnabled; }
+    void SetDepthPrepassMinScreenSize(float minScreenSize) { m_depthPrepassMinScreenSize = minScreenSize; }
+    float GetDepthPrepassMinScreenSize() const { return m_depthPrepassMinScreenSize; }
+
+    // Occlusion culling - each frame's depth becomes a Hi-Z pyramid that Scene tests bounding spheres against
+    // a frame or two later. Needs post-processing on, the depth comes from its main buffer.
+    void SetOcclusionCullingEnabled(bool enable);
+    bool IsOcclusionCullingEnabled() const { return m_occlusionCullingEnabled; }
+    // Null while it's off or nothing has been read back yet
+    const HiZBuffer* GetOcclusionBuffer() const {
+        return m_occlusionCullingEnabled && m_hiZBuffer.IsReady() ? &m_hiZBuffer : nullptr;
+    }
+
+    // The one directional light the lit shaders use, pointing towards it
+    void SetLightDirection(const glm::vec3& towardsLight);
+    const glm::vec3& GetLightDirection() const { return m_lightDirection; }
+
+    // Cascaded shadow maps for that light, see ShadowCascades. A Scene feeds them its entities while it's on.
+    void SetShadowsEnabled(bool enable);
+    bool IsShadowsEnabled() const { return m_shadowsEnabled && m_shadowCascades.IsInitialized(); }
+    void SetShadowSettings(const ShadowSettings& settings) { m_shadowCascades.SetSettings(settings); }
+    const ShadowSettings& GetShadowSettings() const { return m_shadowCascades.GetSettings(); }
+    const ShadowStats& GetShadowStats() const { return m_shadowCascades.GetStats(); }
+
+    // Moving casters, this frame only. radius = world bounding sphere.
+    void SubmitShadowCaster(MeshHandle mesh, const glm::mat4& model, float radius);
+    // Static ones stay cached until they change, only the texels they cover get re-rendered then
+    void SetStaticShadowCaster(uint32_t id, MeshHandle mesh, const glm::mat4& model, float radius) {
+        m_shadowCascades.SetStaticCaster(id, mesh, model, radius);
+    }
+    void RemoveStaticShadowCaster(uint32_t id) { m_shadowCascades.RemoveStaticCaster(id); }
+    void ClearStaticShadowCasters() { m_shadowCascades.ClearStaticCasters(); }
+    // Whoever registered the static casters. Someone else finding it isn't them clears them and starts over.
+    const void* GetShadowCasterOwner() const { return m_shadowCasterOwner; }
+    void SetShadowCasterOwner(const void* owner) { m_shadowCasterOwner = owner; }
 
     void EnablePostProcessing(bool enable) { m_postProcessingEnabled = enable; }
     bool IsPostProcessingEnabled() const { return m_postProcessingEnabled; }
@@ -57,7 +195,11 @@ class Renderer {
     void DebugGeometry();
     void DebugMatrices();
 
-    void DrawColliders(const std::vector<Entity>& entities);
+    // Lines added during the frame are drawn right after the scene (depth tested) in one call, then dropped
+    DebugDraw& GetDebugDraw() { return m_debugDraw; }
+
+    // Collider outlines into the DebugDraw, green = dynamic, red = static. No-op unless ShowColliders is on.
+    void DrawColliders(const std::vector<Entity*>& entities);
     void DrawEntityCollider(const Entity& entity);
 
     void SetShowColliders(bool show) { m_showColliders = show; }
@@ -69,30 +211,106 @@ class Renderer {
   private:
     ShaderSystem* m_shaderSystem = nullptr;  // Reference to engine's shader system
     GeometryManager m_geometryManager;       // Keeps track of our meshes
+    TextureManager m_textureManager;         // And our textures, with whatever mips are resident
     Camera* m_camera = nullptr;              // External camera (not owned)
     Camera m_internalCamera;                 // Fallback internal camera
 
     std::unique_ptr<PostProcessManager> m_postProcessManager;
     bool m_postProcessingEnabled = true;
 
-    // Command queue for batched rendering
-    std::vector<RenderCommand> m_renderQueue;
+    // Command queue for batched rendering. Both live in the FrameArena: the queue is swapped for a fresh one
+    // on the first submit of a frame (PrepareQueue), the sorted list is rebuilt by every Flush.
+    FrameVector<RenderCommand> m_renderQueue;
+    FrameVector<std::pair<uint64_t, uint32_t>> m_sortedQueue;  // (sort key, queue index) - cheaper to sort than commands
+    uint64_t m_queueFrame = 0;
+
+    // Built-in meshes, looked up once in SetupDefaultGeometry
+    MeshHandle m_cubeMesh;
+    MeshHandle m_sphereMesh;
+    MeshHandle m_planeMesh;
+
+    // Shader names that didn't resolve, and what they fell back to - so each one only complains once
+    mutable std::unordered_map<std::string, ShaderHandle> m_missingShaders;
+
+    RenderStats m_renderStats;
+    GpuProfiler m_gpuProfiler;
+
+    // Shadow passes + the scene pass, rebuilt every EndFrame. Post-processing runs its own graph after it.
+    RenderGraph m_frameGraph;
+    RenderTargetPool m_frameTargets;  // Nothing in the frame graph is transient yet, so this stays empty
+
+    // Instancing
+    bool m_instancingEnabled = true;
+    std::unordered_map<uint32_t, ShaderHandle> m_instancedVariants;  // "basic" -> "basic_instanced", by handle id
+    std::vector<InstanceData> m_instanceData;                        // Scratch for the current batch
+    static constexpr size_t MIN_INSTANCED_BATCH = 4;                 // Below this the plain path is just as good
+
+    // Per-frame uploads - fenced slices of one persistently mapped buffer instead of orphaning every frame
+    DynamicBufferRing m_uploadRing;
+    bool m_baseInstanceSupported = false;            // Ring-fed plain instancing needs baseInstance
+    DynamicBufferRing::Allocation m_instanceUpload;  // This flush's rows for DrawBatchInstanced, invalid = glBufferData
+    uint32_t m_instanceUploadUsed = 0;
+
+    // Indirect drawing
+    bool m_indirectDrawEnabled = true;
+    bool m_indirectDrawSupported = false;
+    IndirectDrawBuffer m_indirectBuffer;
+    GLuint m_instanceSource = 0;  // Which instance buffer the arena VAOs read right now, 0 = the GeometryManager's
+    uint32_t m_instanceSourceGeneration = 0;  // Ring generation it was set for, a regrown ring can reuse the name
+
+    bool m_writeEntityIds = false;  // Picking buffer is attached this frame, see PostProcessManager::RequestPick
+
+    ShaderHandle m_boundShader;  // What Flush last bound, so we skip redundant UseShader calls
+    GLuint m_boundVertexArray = 0;  // Same for the arena VAOs
+    TextureHandle m_boundTexture;   // And unit 0, reset whenever the shader changes (uHasTexture is per program)
+
+    DebugDraw m_debugDraw;
+    ShaderHandle m_debugLineShader;
+
+    // Depth pre-pass + occlusion culling
+    bool m_depthPrepassEnabled = false;
+    float m_depthPrepassMinScreenSize = 0.3f;
+    ShaderHandle m_depthOnlyShader;
+    ShaderHandle m_transparentShader;  // Blended, never an occluder
+    bool m_occlusionCullingEnabled = false;
+    HiZBuffer m_hiZBuffer;
+
+    // Shadows
+    bool m_shadowsEnabled = false;
+    ShadowCascades m_shadowCascades;
+    const void* m_shadowCasterOwner = nullptr;
+    static constexpr GLenum SHADOW_MAP_UNIT = GL_TEXTURE1;  // uShadowMap, unit 0 is uTexture
 
     // Current viewport dimensions
     int m_width = 0;
     int m_height = 0;
 
-    // Basic lighting setup [hardcoded]
-    glm::vec3 m_lightPosition{2.0f, 4.0f, 2.0f};
+    glm::vec3 m_lightDirection{0.57735f, 0.57735f, 0.57735f};  // Towards the light, normalized
+
+    // For uTime in the FrameData block
+    std::chrono::steady_clock::time_point m_startTime;
+
+    void UploadFrameData();  // Camera + light into the shared uniform buffer, once per flush
+    void RequestTextureResolutions();  // Screen size of every textured command, for the mip streamer
 
     // Setup functions
     void SetupDefaultShaders();   // Verify required shaders are available
     void SetupDefaultGeometry();  // Create cube, sphere, plane
 
-    void ExecuteRenderCommand(const RenderCommand& command);
-
-    // Transform math
-    glm::mat4 CreateModelMatrix(const Transform& transform);
+    // State binding for Flush - only called when the sort key says something changed
+    bool BindShaderForFrame(ShaderHandle shader);
+    void BindVertexArrayForFrame(GLuint vertexArray);
+    void BindTextureForBatch(TextureHandle texture);
+    void PrepareQueue();
+    void DrawBatch(size_t begin, size_t end);  // Range in m_sortedQueue that shares shader + mesh + texture
+    void DrawBatchInstanced(size_t begin, size_t end, const Mesh& mesh);
+    void DrawIndirect();  // The whole sorted queue, multi-draw per bucket
+    void SetInstanceSource(GLuint buffer, uint32_t generation);
+    void ExecuteRenderCommand(const RenderCommand& command, const Mesh& mesh);
+    void DrawDebugLines();  // Everything in m_debugDraw, after Flush
+    bool DrawDepthPrepass();  // True if it drew anything, the main pass then needs GL_LEQUAL
+    void BuildOcclusionBuffer();
+    void BuildFrameGraph();  // shadow_static -> shadow_dynamic -> scene, the shadow ones only when enabled
 
     bool m_showColliders = false;
 };
@@ -1,23 +1,73 @@
 #pragma once
 
 #include <GL/gl.h>
+#include <functional>
 #include <glm/glm.hpp>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include "blacksite/graphics/ProgramBinaryCache.h"
+#include "blacksite/graphics/RenderHandles.h"
 
 namespace Blacksite {
 
+// Mirrors the std140 "FrameData" uniform block in the built-in shaders - keep the two in sync!
+constexpr int MAX_SHADOW_CASCADES = 4;
+
+struct FrameData {
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::vec4 lightDir{0.0f};  // Towards the light, w is padding (vec3 takes a vec4 slot in std140)
+    glm::vec3 viewPos{0.0f};
+    float time = 0.0f;         // Packs into the viewPos slot
+    // Shadows - only basic/basic_instanced read these. The GLSL side is Shaders::FRAME_DATA_BLOCK.
+    glm::mat4 shadowMatrices[MAX_SHADOW_CASCADES];  // World -> [0,1] texture coords + depth, per cascade
+    glm::vec4 cascadeSplits{0.0f};                  // View distance where each cascade ends
+    glm::vec4 shadowParams{0.0f};                   // x = cascade count (0 = off), y = depth bias, w = 1 / map size
+};
+static_assert(sizeof(FrameData) == 448, "FrameData must match the std140 layout of the GLSL block");
+
 class ShaderManager {
 public:
+    static constexpr unsigned int FRAME_DATA_BINDING = 0;  // Uniform buffer binding point for FrameData
+
     ShaderManager() = default;
     ~ShaderManager();
 
+    // Linked programs get saved here and later loads skip the GLSL compiler. Needs the context current.
+    bool EnableProgramBinaryCache(const std::string& directory) { return m_binaryCache.Initialize(directory); }
+    const ProgramBinaryCache& GetProgramBinaryCache() const { return m_binaryCache; }
+
     // Load shader from the shader library
     bool LoadShaderFromLibrary(const std::string& libraryName);
 
     // Load and compile shader programs (existing method)
     bool LoadShader(const std::string& name, const char* vertexSource, const char* fragmentSource);
+    // Compute programs live in the same table, UseShader + SetUniform work on them too. Needs GL 4.3.
+    bool LoadComputeShader(const std::string& name, const char* computeSource);
+    static bool IsComputeSupported();  // Compute + image load/store, what LoadComputeShader needs
+
+    // Async versions: compile and link get handed to the driver and these return straight away. The program
+    // shows up once PollPendingPrograms sees it finish - a reload keeps drawing with the old one until then.
+    // Submitting a name that's already in flight replaces the older submission.
+    bool SubmitShader(const std::string& name, const char* vertexSource, const char* fragmentSource);
+    bool SubmitComputeShader(const std::string& name, const char* computeSource);
+    bool SubmitShaderFromLibrary(const std::string& libraryName);
+
+    // KHR/ARB_parallel_shader_compile: compiles run on driver threads and can be polled without blocking
+    static bool IsParallelCompileSupported();
+    using CompileCallback = std::function<void(const std::string& name, bool success)>;
+    // Never waits when the driver can report completion, otherwise finishes everything in one go
+    size_t PollPendingPrograms(const CompileCallback& onDone = {});
+    void FinishPendingPrograms(const CompileCallback& onDone = {});  // Blocks until nothing's in flight
+    bool IsPending(const std::string& name) const;
+    size_t GetPendingCount() const { return m_pendingPrograms.size(); }
     bool UseShader(const std::string& name);
+    bool UseShader(ShaderHandle handle);  // No string hashing, use this in hot paths
+
+    // Name -> handle, invalid handle if the shader isn't loaded
+    ShaderHandle GetShaderHandle(const std::string& name) const;
+    const std::string& GetShaderName(ShaderHandle handle) const;
 
     // Uniform setters - Complete set
     void SetUniform(const std::string& name, const glm::mat4& matrix);
@@ -27,6 +77,7 @@ public:
     void SetUniform(const std::string& name, const glm::vec2& vector);
     void SetUniform(const std::string& name, float value);
     void SetUniform(const std::string& name, int value);
+    void SetUniform(const std::string& name, uint32_t value);
     void SetUniform(const std::string& name, bool value);
 
     // Two-parameter overloads for convenience
@@ -35,6 +86,12 @@ public:
     void SetUniform(const std::string& name, float x, float y, float z, float w);
     void SetUniform(const std::string& name, int x, int y);
 
+    // Per-frame uniform buffer - upload once, every program with a FrameData block sees it
+    void UpdateFrameData(const FrameData& data);
+    void BindFrameData(GLuint buffer, GLintptr offset);  // Or point the block at a FrameData someone else wrote
+    bool CurrentShaderUsesFrameData() const;
+    bool CurrentShaderWritesEntityId() const;  // Has an "EntityId" output on location 1, for picking
+
     // Utility methods
     bool HasShader(const std::string& name) const;
     std::string GetCurrentShaderName() const;
@@ -43,16 +100,47 @@ public:
     void Cleanup();
 
 private:
-    // Collection of compiled shaders
-    std::unordered_map<std::string, unsigned int> m_shaderPrograms;
+    // Collection of compiled shaders - handles index into m_programs, names map to handles
+    struct ProgramSlot {
+        std::string name;
+        unsigned int program = 0;
+        std::unordered_map<std::string, GLint> uniformLocations;  // Filled right after linking
+        bool usesFrameData = false;
+        bool writesEntityId = false;
+    };
+    std::vector<ProgramSlot> m_programs;
+    std::unordered_map<std::string, ShaderHandle> m_shaderHandles;
 
     // Currently active program
     unsigned int m_currentProgram = 0;
     std::string m_currentShaderName;
+    ShaderHandle m_currentHandle;
+
+    unsigned int m_frameDataUBO = 0;
+    ProgramBinaryCache m_binaryCache;
+
+    // A program between glLinkProgram and its status check
+    struct PendingProgram {
+        std::string name;
+        unsigned int program = 0;
+        unsigned int shaders[2] = {0, 0};  // Vertex + fragment, or just compute
+        uint64_t cacheKey = 0;
+    };
+    std::vector<PendingProgram> m_pendingPrograms;
+    bool m_compilerThreadsRequested = false;
 
-    // Shader compilation
-    bool CompileShader(unsigned int shader, const char* source);
-    bool LinkProgram(unsigned int program);
+    // Shader compilation - nothing here asks for status until FinishProgram, so it never stalls
+    bool BeginProgram(const std::string& name, const char* vertexSource, const char* fragmentSource,
+                      const char* computeSource, PendingProgram& out);  // False on a binary cache hit
+    bool FinishProgram(PendingProgram& pending);
+    void DeletePending(PendingProgram& pending);
+    void RequestCompilerThreads();
+    unsigned int CompileShader(unsigned int type, const char* source);
+    bool CheckCompileStatus(unsigned int shader);
+    bool CheckLinkStatus(unsigned int program);
+    void CacheProgramInfo(ProgramSlot& slot);  // Uniform locations + FrameData block binding
+    // New slot, or swapped into the old one. False (and the program deleted) once the sort key is out of ids.
+    bool StoreProgram(const std::string& name, unsigned int program);
 
     // Helper for getting uniform location with error checking
     GLint GetUniformLocationSafe(const std::string& name) const;
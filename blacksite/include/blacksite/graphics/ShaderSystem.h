@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <memory>
 #include "ShaderManager.h"
+#include "blacksite/core/FileWatcher.h"
 #include "shaders/ShaderLibrary.h"
 
 namespace Blacksite {
@@ -23,7 +24,9 @@ public:
     ~ShaderSystem();
 
     // Core lifecycle - called by main engine
-    bool Initialize(const std::string& shaderDirectory = "assets/shaders/");
+    // Empty cacheDirectory turns the program binary cache off, everything compiles from source
+    bool Initialize(const std::string& shaderDirectory = "assets/shaders/",
+                    const std::string& cacheDirectory = "cache/shaders/");
     void Shutdown();
     void Update(); // Call this each frame for hot-reloading
 
@@ -60,8 +63,10 @@ private:
     std::unordered_map<std::string, ShaderFileInfo> m_shaderFiles;
     std::vector<std::string> m_builtInShaders;
 
-    // Hot reloading
+    // Hot reloading - the watcher tells us what changed, polling timestamps is only the fallback
     bool m_hotReloadEnabled = true;
+    FileWatcher m_fileWatcher;
+    std::unordered_map<std::string, std::string> m_watchedFiles;  // Normalized file path -> shader name
 
     // Helper methods
     bool LoadShaderFromFile(const std::string& name, const std::string& vertexPath, const std::string& fragmentPath);
@@ -69,6 +74,8 @@ private:
     bool IsShaderFile(const std::string& extension);
     std::filesystem::file_time_type GetFileModificationTime(const std::string& path);
     void CheckForShaderChanges();
+    void ProcessFileChanges();
+    void OnProgramFinished(const std::string& name, bool success);  // Async compiles report back here
 
     // Shader file naming conventions
     std::pair<std::string, std::string> FindShaderPair(const std::string& baseName);
@@ -0,0 +1,179 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+#include "MeshArena.h"
+#include "RenderHandles.h"
+#include "ShaderManager.h"
+
+namespace Blacksite {
+
+class Camera;
+class DynamicBufferRing;
+class GeometryManager;
+class ShaderSystem;
+
+struct ShadowSettings {
+    int cascadeCount = 4;         // 1..MAX_SHADOW_CASCADES
+    int resolution = 2048;        // Texels per side, every cascade
+    float maxDistance = 80.0f;    // From the camera, nothing further out gets shadows
+    float splitLambda = 0.75f;    // 0 = even splits, 1 = logarithmic
+    float casterDistance = 60.0f; // How far towards the light casters outside the view still count
+    float depthBias = 0.0015f;    // Compare offset in [0,1] depth, on top of the polygon offset while rendering
+    // Frames between re-renders, per cascade. The far ones cover lots of ground in coarse texels, moving
+    // shadows in them can lag a frame or three without anyone noticing.
+    int updateInterval[MAX_SHADOW_CASCADES] = {1, 1, 2, 4};
+};
+
+// What the last frame's update did
+struct ShadowStats {
+    uint32_t cascadesUpdated = 0;
+    uint32_t staticRegions = 0;   // Dirty rectangles of the static cache re-rendered
+    uint32_t staticCasters = 0;   // Instances drawn into them
+    uint32_t dynamicCasters = 0;  // Instances drawn on top, summed over cascades
+    uint32_t drawCalls = 0;
+};
+
+/**
+ * ShadowCascades - Cascaded shadow maps for one directional light, static geometry cached
+ * The view up to maxDistance is split into cascades, each covered by an orthographic light-space box around
+ * the bounding sphere of its slice. The sphere's size doesn't change as the camera turns and the box only
+ * moves in whole texels, so nothing shimmers - and a cascade that slid over by a few texels can keep most of
+ * what it had. Every cascade has two layers: static casters (registered once, kept until they change) and
+ * the final map, which is the static layer copied over with this frame's dynamic casters drawn on top.
+ * A static caster that moves or goes away only re-renders the rectangles it covered and now covers. Moving
+ * the camera scrolls the static layer and re-renders the strip that came into view.
+ */
+class ShadowCascades {
+  public:
+    ShadowCascades() = default;
+    ~ShadowCascades() { Shutdown(); }
+    ShadowCascades(const ShadowCascades&) = delete;
+    ShadowCascades& operator=(const ShadowCascades&) = delete;
+
+    // Needs the "shadow_depth" shader. The ring is optional, with it (and baseInstance) instance rows skip
+    // the glBufferData path.
+    bool Initialize(ShaderSystem* shaderSystem, GeometryManager* geometry, DynamicBufferRing* uploadRing,
+                    bool baseInstanceSupported);
+    void Shutdown();
+    bool IsInitialized() const { return m_shaderSystem != nullptr; }
+
+    void SetSettings(const ShadowSettings& settings);  // Starts the cache over
+    const ShadowSettings& GetSettings() const { return m_settings; }
+
+    // Static casters stay until removed. Setting an id that exists moves it. radius = world bounding sphere.
+    void SetStaticCaster(uint32_t id, MeshHandle mesh, const glm::mat4& model, float radius);
+    void RemoveStaticCaster(uint32_t id);
+    void ClearStaticCasters();
+    size_t GetStaticCasterCount() const { return m_staticCasters.size(); }
+
+    // Dynamic casters only count for the next update
+    void SubmitCaster(MeshHandle mesh, const glm::mat4& model, float radius);
+
+    // A frame's update in two halves, the renderer's shadow_static and shadow_dynamic graph passes. UpdateStatic
+    // places the cascades that are due and re-renders the dirty parts of their static layers, UpdateDynamic
+    // copies those into the final map and draws the dynamic casters on top. towardsLight is normalized. Both
+    // leave the framebuffer, viewport, program, VAO and instance source changed, the caller restores what it needs.
+    void UpdateStatic(const Camera& camera, const glm::vec3& towardsLight);
+    void UpdateDynamic();
+    void Invalidate();  // Everything re-renders next update
+
+    // Matrices, splits and params for the lit shaders. Cascade count stays 0 until there's something to sample.
+    void FillFrameData(FrameData& data) const;
+    GLuint GetTexture() const { return m_finalTexture; }
+    bool IsReady() const;
+    const ShadowStats& GetStats() const { return m_stats; }
+
+  private:
+    static constexpr size_t MAX_DIRTY_RECTS = 8;  // Per cascade, more get merged into one
+
+    struct Caster {
+        MeshHandle mesh;
+        glm::mat4 model{1.0f};
+        glm::vec3 center{0.0f};  // World bounding sphere
+        float radius = 0.0f;
+    };
+
+    // Texels in light space, absolute (not relative to where the map is right now). Half-open.
+    struct TexelRect {
+        int64_t x0 = 0;
+        int64_t y0 = 0;
+        int64_t x1 = 0;
+        int64_t y1 = 0;
+        bool IsEmpty() const { return x0 >= x1 || y0 >= y1; }
+    };
+
+    struct Cascade {
+        float splitDistance = 0.0f;  // View distance where it ends
+        float radius = 0.0f;         // Slice's bounding sphere, rounded up
+        float texelSize = 0.0f;      // World units
+        int64_t originX = 0;         // Absolute texel at the map's lower left corner
+        int64_t originY = 0;
+        float depthCenter = 0.0f;    // Light-space z the depth range is built around
+        glm::mat4 viewProjection{1.0f};  // What the final layer was rendered with
+        bool staticValid = false;
+        bool rendered = false;
+        bool hadDynamic = false;  // Final layer has dynamic casters the static layer doesn't
+        bool pending = false;     // UpdateStatic got to it, UpdateDynamic still owes it a final layer
+        std::vector<TexelRect> dirty;
+    };
+
+    // One instance row + where its mesh is, sorted by mesh before drawing
+    struct DrawItem {
+        uint32_t mesh = 0;
+        const glm::mat4* model = nullptr;
+    };
+
+    ShaderSystem* m_shaderSystem = nullptr;
+    ShaderHandle m_shader;
+    GeometryManager* m_geometry = nullptr;
+    DynamicBufferRing* m_uploadRing = nullptr;
+    bool m_baseInstanceSupported = false;
+    GLuint m_instanceSource = 0;  // What the arena VAOs read instances from right now, ~0 = don't know
+    ShadowSettings m_settings;
+    ShadowStats m_stats;
+
+    GLuint m_finalTexture = 0;   // Depth array, one layer per cascade, what the lit shaders sample
+    GLuint m_staticTexture = 0;  // Same shape, static casters only
+    GLuint m_scratchTexture = 0; // One layer's worth, for scrolling the static layer
+    GLuint m_readFbo = 0;
+    GLuint m_drawFbo = 0;
+    int m_textureResolution = 0;
+    int m_textureLayers = 0;
+
+    Cascade m_cascades[MAX_SHADOW_CASCADES];
+    glm::vec3 m_towardsLight{0.0f};
+    glm::mat4 m_lightView{1.0f};  // Rotation only, so texel coordinates stay put as the camera moves
+    uint64_t m_frame = 0;
+
+    std::vector<Caster> m_staticCasters;
+    std::unordered_map<uint32_t, size_t> m_staticIndex;  // Id -> m_staticCasters index
+    std::vector<uint32_t> m_staticIds;                   // m_staticCasters index -> id, for the swap-remove
+    std::vector<glm::vec4> m_changedSpheres;  // Old and new spots of changed static casters, world xyz + radius
+    std::vector<Caster> m_dynamicCasters;
+
+    // Reused every update
+    std::vector<DrawItem> m_drawItems;
+    std::vector<InstanceData> m_instanceRows;
+
+    bool BeginDepthDraws();  // Shader + depth state + viewport, false if the shader won't bind
+    void EndDepthDraws();
+    void CreateTextures(int resolution, int layers);
+    void DestroyTextures();
+    // Where the cascade covering this slice of the view goes, in light space and snapped to texels
+    void PlaceCascade(const Camera& camera, float nearDistance, float farDistance, Cascade& target) const;
+    TexelRect SphereRect(const Cascade& cascade, const glm::vec3& center, float radius) const;
+    void AddDirtyRect(Cascade& cascade, const TexelRect& rect);
+    void ScrollStaticLayer(int layer, int64_t dx, int64_t dy);
+    void CopyLayer(GLuint source, int sourceLayer, GLuint target, int targetLayer, int x0, int y0, int x1, int y1,
+                   int dx, int dy);
+    void RenderStaticRects(int layer, Cascade& cascade);
+    bool RenderDynamic(int layer, const Cascade& cascade);  // Static layer + dynamic casters, true if it drew any
+    void DrawItems(const glm::mat4& viewProjection);
+    bool Overlaps(const Cascade& cascade, const TexelRect& area, const glm::vec3& center, float radius) const;
+};
+
+}  // namespace Blacksite
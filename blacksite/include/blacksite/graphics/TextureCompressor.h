@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "blacksite/graphics/ImageLoader.h"
+
+namespace Blacksite {
+
+// How a texture's mips are stored, on disk and on the GPU. Values are part of the .bstex format.
+enum class TextureFormat : uint32_t {
+    RGBA8 = 0,
+    BC1 = 1,  // DXT1, 4 bpp RGB - anything without alpha
+    BC3 = 2,  // DXT5, 8 bpp RGBA
+};
+
+/**
+ * TextureCompressor - Mip chains and BC1/BC3 block compression, done once at import
+ * The encoder is the quick bounding-box fit (endpoints from the block's color extents, inset a little),
+ * not an exhaustive search. Quality is a notch below offline tools but it's fast enough to run on first
+ * load, and every texture ends up at 4 or 8 bits per pixel instead of 32.
+ */
+class TextureCompressor {
+  public:
+    // Level 0 is the image itself, each next one half the size (box filter) down to 1x1
+    static void GenerateMipChain(const ImageData& image, std::vector<ImageData>& out);
+
+    // Whole image in 4x4 blocks, edges padded by repeating the last row/column
+    static void CompressBC1(const ImageData& image, std::vector<uint8_t>& out);
+    static void CompressBC3(const ImageData& image, std::vector<uint8_t>& out);
+
+    static bool HasAlpha(const ImageData& image);  // Any pixel below 255
+
+    // Bytes of one level of this size
+    static size_t GetLevelSize(TextureFormat format, uint32_t width, uint32_t height);
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "blacksite/core/MappedFile.h"
+#include "blacksite/graphics/MeshImporter.h"
+#include "blacksite/graphics/TextureCompressor.h"
+
+namespace Blacksite {
+
+// Imported texture, every mip already in its final format. Level 0 is the full size one.
+struct TextureAsset {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    TextureFormat format = TextureFormat::BC1;
+    std::vector<std::vector<uint8_t>> mips;
+};
+
+/**
+ * TextureCacheFile - A .bstex cache mapped straight into memory
+ * Stays open for as long as the texture is loaded: the streamer uploads mips from it whenever it decides
+ * to, so no level is ever held in system memory on top of the mapping.
+ */
+class TextureCacheFile {
+  public:
+    TextureCacheFile() = default;
+    ~TextureCacheFile() { Close(); }
+    TextureCacheFile(const TextureCacheFile&) = delete;
+    TextureCacheFile& operator=(const TextureCacheFile&) = delete;
+
+    // False if the cache is missing, malformed, or was built from a different version of the source.
+    // sourceStamp 0 skips the source check (the source isn't shipped, only the cache).
+    bool Open(const std::string& path, uint64_t sourceStamp);
+    void Close();
+
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+    TextureFormat GetFormat() const { return m_format; }
+    uint32_t GetMipCount() const { return static_cast<uint32_t>(m_mips.size()); }
+
+    const uint8_t* GetMipData(uint32_t level) const { return m_file.Data() + m_mips[level].offset; }
+    size_t GetMipSize(uint32_t level) const { return static_cast<size_t>(m_mips[level].size); }
+
+  private:
+    struct MipRange {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    MappedFile m_file;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    TextureFormat m_format = TextureFormat::RGBA8;
+    std::vector<MipRange> m_mips;
+};
+
+/**
+ * TextureImporter - Source image into a compressed, mipped TextureAsset, plus the .bstex cache
+ * Opaque images go to BC1, anything with alpha to BC3. This is the slow part (mips + block compression),
+ * so it happens once per source version - run ImportToCache from a build step to keep it off first load.
+ */
+class TextureImporter {
+  public:
+    static bool Import(const std::string& sourcePath, TextureAsset& out);
+
+    // Written next to the source as <source>.bstex, via a temp file so a half-written cache never gets mapped
+    static bool WriteCache(const std::string& cachePath, uint64_t sourceStamp, const TextureAsset& texture);
+    static std::string GetCachePath(const std::string& sourcePath) { return sourcePath + ".bstex"; }
+
+    // Import + WriteCache unless the cache is already current
+    static bool ImportToCache(const std::string& sourcePath);
+
+    // Same stamp the mesh cache uses, size + modification time
+    static uint64_t GetSourceStamp(const std::string& sourcePath) { return MeshImporter::GetSourceStamp(sourcePath); }
+
+    static constexpr uint32_t CACHE_VERSION = 1;
+};
+
+}  // namespace Blacksite
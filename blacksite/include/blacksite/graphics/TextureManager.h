@@ -0,0 +1,109 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "blacksite/graphics/RenderHandles.h"
+#include "blacksite/graphics/TextureImporter.h"
+
+namespace Blacksite {
+
+struct TextureStreamingStats {
+    size_t residentBytes = 0;  // On the GPU right now
+    size_t wantedBytes = 0;    // What this frame's demand would take without a budget
+    size_t uploadedBytes = 0;  // Streamed in this frame
+    uint32_t textureCount = 0;
+    uint32_t starvedCount = 0;  // Held coarser than they're drawn because of the budget
+};
+
+/**
+ * TextureManager - Compressed textures with mips streamed to what's on screen
+ * Every texture keeps its .bstex mapped and only the levels worth drawing live on the GPU. Draws report
+ * how big the texture is on screen (RequestResolution), Update turns that into a finest level per texture
+ * and fits the lot into the memory budget, coarsening the least visible textures first. Small mips
+ * (RESIDENT_TAIL_SIZE and below) are always there, so a texture never has nothing to sample.
+ */
+class TextureManager {
+  public:
+    TextureManager() = default;
+    ~TextureManager();
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+
+    bool Initialize();  // Needs a GL context
+    void Cleanup();
+
+    // Same deal as GeometryManager::LoadMesh: the first load imports (see TextureImporter) and writes
+    // <path>.bstex, after that the cache is all it reads. Same name again replaces and keeps the handle.
+    TextureHandle LoadTexture(const std::string& name, const std::string& path);
+
+    // Name -> handle, invalid handle if there's no such texture. Doesn't log, the scene calls it from workers.
+    TextureHandle GetTextureHandle(const std::string& name) const;
+
+    // Frees the GL texture and unmaps the cache, the handle goes stale
+    void DestroyTexture(TextureHandle handle);
+
+    // 0 for invalid handles
+    GLuint GetGLTexture(TextureHandle handle) const;
+
+    // Something using this texture covers screenPixels (its larger side) this frame. The biggest request
+    // since the last Update wins.
+    void RequestResolution(TextureHandle handle, float screenPixels);
+
+    // Once per frame - picks levels from the requests, fits the budget and streams finer mips in
+    void Update();
+
+    // GPU bytes for all textures together. Going over it coarsens textures right away.
+    void SetMemoryBudget(size_t bytes) { m_memoryBudget = bytes; }
+    size_t GetMemoryBudget() const { return m_memoryBudget; }
+
+    // Bytes of finer mips uploaded per frame at most, a texture coming into view sharpens over a few frames
+    void SetUploadBudget(size_t bytesPerFrame) { m_uploadBudget = bytesPerFrame; }
+
+    // Finest level on the GPU, 0 = full size. 0 for invalid handles.
+    uint32_t GetResidentLevel(TextureHandle handle) const;
+
+    const TextureStreamingStats& GetStats() const { return m_stats; }
+
+    static constexpr uint32_t RESIDENT_TAIL_SIZE = 64;  // Mips this size and smaller are never streamed out
+    static constexpr uint32_t MAX_TEXTURES = 4095;      // What fits in the render sort key
+
+  private:
+    struct Texture {
+        std::string name;
+        std::unique_ptr<TextureCacheFile> file;  // Null for free slots
+        GLuint id = 0;
+        uint32_t residentLevel = 0;  // Finest level on the GPU, which is the GL texture's level 0
+        uint32_t tailLevel = 0;      // From here down it's always resident
+        float demand = 0.0f;         // Largest request since the last Update, in pixels
+
+        // Update scratch
+        uint32_t wantedLevel = 0;
+        uint32_t targetLevel = 0;
+    };
+
+    std::vector<Texture> m_textures;
+    std::unordered_map<std::string, TextureHandle> m_textureHandles;
+    std::vector<uint32_t> m_freeSlots;
+
+    size_t m_memoryBudget = 256u * 1024 * 1024;
+    size_t m_uploadBudget = 8u * 1024 * 1024;
+    bool m_compressionSupported = false;
+    TextureStreamingStats m_stats;
+
+    Texture* Find(TextureHandle handle);
+    const Texture* Find(TextureHandle handle) const;
+
+    uint32_t WantedLevel(const Texture& texture) const;
+    static size_t ResidentBytes(const Texture& texture, uint32_t level);  // Level and everything coarser
+
+    // New GL texture holding levels [level, mipCount), replaces the old one
+    bool MakeResident(Texture& texture, uint32_t level);
+    void Release(Texture& texture);
+};
+
+}  // namespace Blacksite
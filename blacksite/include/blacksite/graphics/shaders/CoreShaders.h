@@ -3,6 +3,9 @@
 namespace Blacksite {
 namespace Shaders {
 
+// The shared per-frame uniform block, prepended by ShaderLibrary to the stages that use it
+extern const char* FRAME_DATA_BLOCK;
+
 // Basic Phong lighting shader - the workhorse of the engine
 extern const char* BASIC_VERTEX_SHADER;
 extern const char* BASIC_FRAGMENT_SHADER;
@@ -11,9 +14,23 @@ extern const char* BASIC_FRAGMENT_SHADER;
 extern const char* UNLIT_VERTEX_SHADER;
 extern const char* UNLIT_FRAGMENT_SHADER;
 
+// Instanced versions of basic/unlit - per-instance model matrix and color
+extern const char* BASIC_INSTANCED_VERTEX_SHADER;
+extern const char* BASIC_INSTANCED_FRAGMENT_SHADER;
+extern const char* UNLIT_INSTANCED_VERTEX_SHADER;
+extern const char* UNLIT_INSTANCED_FRAGMENT_SHADER;
+
 // Transparent shader - for alpha blending
 extern const char* TRANSPARENT_VERTEX_SHADER;
 extern const char* TRANSPARENT_FRAGMENT_SHADER;
 
+// Depth only - the renderer's depth pre-pass for big occluders
+extern const char* DEPTH_ONLY_VERTEX_SHADER;
+extern const char* DEPTH_ONLY_FRAGMENT_SHADER;
+
+// Shadow depth - instanced shadow casters into one cascade of the shadow map
+extern const char* SHADOW_DEPTH_VERTEX_SHADER;
+extern const char* SHADOW_DEPTH_FRAGMENT_SHADER;
+
 } // namespace Shaders
 } // namespace Blacksite
@@ -11,5 +11,9 @@ extern const char* WIREFRAME_FRAGMENT_SHADER;
 extern const char* DEBUG_VERTEX_SHADER;
 extern const char* DEBUG_FRAGMENT_SHADER;
 
+// Per-vertex colored lines for DebugDraw
+extern const char* DEBUG_LINES_VERTEX_SHADER;
+extern const char* DEBUG_LINES_FRAGMENT_SHADER;
+
 } // namespace Shaders
 } // namespace Blacksite
@@ -11,6 +11,10 @@ extern const char* POSTPROCESS_FRAGMENT_SHADER;
 extern const char* BLUR_VERTEX_SHADER;
 extern const char* BLUR_FRAGMENT_SHADER;
 
+// Mip-chain bloom: 13-tap downsample (threshold + Karis average on the first pass), tent upsample
+extern const char* BLOOM_DOWNSAMPLE_FRAGMENT_SHADER;
+extern const char* BLOOM_UPSAMPLE_FRAGMENT_SHADER;
+
 // Simple bloom effect
 extern const char* BLOOM_VERTEX_SHADER;
 extern const char* BLOOM_FRAGMENT_SHADER;
@@ -19,5 +23,12 @@ extern const char* BLOOM_FRAGMENT_SHADER;
 extern const char* FXAA_VERTEX_SHADER;
 extern const char* FXAA_FRAGMENT_SHADER;
 
+// Compute (GL 4.3): bloom composite + tone mapping + FXAA in one dispatch, through a shared memory tile
+extern const char* COMPOSITE_FXAA_COMPUTE_SHADER;
+
+// Hierarchical Z: each level keeps the farthest depth of 2x2 texels of the one above, see HiZBuffer
+extern const char* HIZ_VERTEX_SHADER;
+extern const char* HIZ_DOWNSAMPLE_FRAGMENT_SHADER;
+
 } // namespace Shaders
 } // namespace Blacksite
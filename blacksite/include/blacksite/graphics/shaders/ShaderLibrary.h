@@ -1,4 +1,5 @@
 #pragma once
+#include <deque>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -9,10 +10,15 @@ enum class ShaderType {
     // Core rendering shaders
     Basic,          // Standard Phong lighting
     Unlit,          // No lighting, just color/texture
+    BasicInstanced, // Basic, but one draw for a whole batch
+    UnlitInstanced, // Unlit, same deal
+    DepthOnly,      // Depth pre-pass, no color
+    ShadowDepth,    // Instanced shadow casters, no color
 
     // Debug shaders
     Wireframe,      // For collider visualization
     Debug,          // Solid color for debugging
+    DebugLines,     // DebugDraw's line lists
 
     // Effect shaders
     Transparent,    // Alpha blending support
@@ -21,7 +27,11 @@ enum class ShaderType {
     PostProcess,    // Basic post-process quad
     Blur,           // Gaussian blur
     Bloom,          // Bloom effect
+    BloomDownsample, // Bloom mip chain, going down
+    BloomUpsample,   // ...and back up
+    CompositeFXAA,   // Compute: composite + tone map + FXAA fused
     FXAA,           // Anti-aliasing
+    HiZDownsample,  // Depth pyramid for occlusion culling
 };
 
 struct ShaderSource {
@@ -31,6 +41,7 @@ struct ShaderSource {
     std::string description;
     bool requiresTime = false;      // Does this shader need time uniform?
     bool requiresLighting = false;  // Does this shader need lighting uniforms?
+    const char* computeSource = nullptr;  // Set for compute programs, the other two stay null
 };
 
 class ShaderLibrary {
@@ -54,7 +65,10 @@ public:
 
 private:
     static void InitializeShaders();
+    // Source with Shaders::FRAME_DATA_BLOCK inserted after its #version line, kept alive in s_generatedSources
+    static const char* WithFrameData(const char* source);
     static std::unordered_map<std::string, ShaderSource> s_shaders;
+    static std::deque<std::string> s_generatedSources;  // Deque so the c_str()s handed out never move
     static std::unordered_map<ShaderType, std::string> s_typeToName;
     static bool s_initialized;
 };
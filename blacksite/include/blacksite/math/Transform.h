@@ -1,26 +1,71 @@
 #pragma once
 
+#include <cmath>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 namespace Blacksite {
 
+// Euler degrees <-> quaternion, XYZ order (same as rotating around X, then Y, then Z in local space).
+// Only for the editor and scripts that think in angles, nothing per-frame goes through these.
+inline glm::quat EulerToQuat(const glm::vec3& eulerDegrees) {
+    glm::vec3 half = glm::radians(eulerDegrees) * 0.5f;
+    glm::quat qx(std::cos(half.x), std::sin(half.x), 0.0f, 0.0f);
+    glm::quat qy(std::cos(half.y), 0.0f, std::sin(half.y), 0.0f);
+    glm::quat qz(std::cos(half.z), 0.0f, 0.0f, std::sin(half.z));
+    return qx * qy * qz;
+}
+
+inline glm::vec3 QuatToEuler(const glm::quat& q) {
+    // Rows/columns of the rotation matrix we need for the XYZ decomposition, R = Rx * Ry * Rz
+    float r02 = 2.0f * (q.x * q.z + q.w * q.y);
+    float r12 = 2.0f * (q.y * q.z - q.w * q.x);
+    float r22 = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+    float r01 = 2.0f * (q.x * q.y - q.w * q.z);
+    float r00 = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
+
+    float y = std::asin(glm::clamp(r02, -1.0f, 1.0f));
+    float x, z;
+    if (std::abs(r02) < 0.9999f) {
+        x = std::atan2(-r12, r22);
+        z = std::atan2(-r01, r00);
+    } else {
+        // Gimbal lock, X and Z spin around the same axis - put it all on X
+        float r21 = 2.0f * (q.y * q.z + q.w * q.x);
+        float r11 = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+        x = std::atan2(r21, r11);
+        z = 0.0f;
+    }
+    return glm::degrees(glm::vec3(x, y, z));
+}
+
+// Model matrix straight from position/rotation/scale - the rotation columns come out of the
+// quaternion already scaled, no trig and no matrix products
+inline glm::mat4 ComposeTRS(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+    float xx = rotation.x * rotation.x, yy = rotation.y * rotation.y, zz = rotation.z * rotation.z;
+    float xy = rotation.x * rotation.y, xz = rotation.x * rotation.z, yz = rotation.y * rotation.z;
+    float wx = rotation.w * rotation.x, wy = rotation.w * rotation.y, wz = rotation.w * rotation.z;
+
+    glm::mat4 m;
+    m[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy + wz) * scale.x, 2.0f * (xz - wy) * scale.x, 0.0f);
+    m[1] = glm::vec4(2.0f * (xy - wz) * scale.y, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz + wx) * scale.y, 0.0f);
+    m[2] = glm::vec4(2.0f * (xz + wy) * scale.z, 2.0f * (yz - wx) * scale.z, (1.0f - 2.0f * (xx + yy)) * scale.z, 0.0f);
+    m[3] = glm::vec4(position, 1.0f);
+    return m;
+}
+
 struct Transform {
     glm::vec3 position{0.0f};
-    glm::vec3 rotation{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};  // Physics writes this as-is, Euler is only a view
     glm::vec3 scale{1.0f};
 
+    // Euler degrees view for the editor / gameplay code
+    glm::vec3 GetEulerRotation() const { return QuatToEuler(rotation); }
+    void SetEulerRotation(const glm::vec3& eulerDegrees) { rotation = EulerToQuat(eulerDegrees); }
+
     // create transform matrix
-    glm::mat4 GetMatrix() const {
-        glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position);
-        glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(rotation.x), glm::vec3(1, 0, 0));
-        rotationMatrix = glm::rotate(rotationMatrix, glm::radians(rotation.y), glm::vec3(0, 1, 0));
-        rotationMatrix = glm::rotate(rotationMatrix, glm::radians(rotation.z), glm::vec3(0, 0, 1));
-        glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale);
-
-        return translationMatrix * rotationMatrix * scaleMatrix;
-    }
+    glm::mat4 GetMatrix() const { return ComposeTRS(position, rotation, scale); }
 };
 
-}  // namespace Blacksite
\ No newline at end of file
+}  // namespace Blacksite
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Blacksite {
+
+// out[i] = ComposeTRS(positions[i], rotations[i], scales[i]) for the whole range.
+// SSE (AVX2 when the build enables it) or NEON, 4/8 matrices per iteration, scalar for the tail.
+// Rotations must be normalized. The output can't overlap the inputs.
+void BuildModelMatrices(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales,
+                        size_t count, glm::mat4* out);
+
+// Which kernel BuildModelMatrices was compiled with ("AVX2", "SSE", "NEON" or "Scalar")
+const char* GetModelMatrixKernelName();
+
+}  // namespace Blacksite
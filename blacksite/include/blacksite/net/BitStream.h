@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Blacksite {
+
+/**
+ * BitWriter / BitReader - Bit-packed buffers for network messages
+ * Values take exactly the bits asked for, least significant bit first, no byte alignment between them.
+ * The reader never reads past the end: it returns zeros from there on and remembers it overflowed, so a
+ * decoder can read a whole message and check IsOverflowed() once at the end.
+ */
+class BitWriter {
+  public:
+    explicit BitWriter(std::vector<uint8_t>& buffer) : m_buffer(buffer) {}
+    ~BitWriter() { Flush(); }
+    BitWriter(const BitWriter&) = delete;
+    BitWriter& operator=(const BitWriter&) = delete;
+
+    void Write(uint32_t value, int bits);  // 1..32 bits, anything above 'bits' is ignored
+    void WriteBool(bool value) { Write(value ? 1u : 0u, 1); }
+    void WriteSigned(int32_t value, int bits);  // Zigzag, so small magnitudes of either sign stay small
+    void WriteVarUint(uint32_t value);          // 4-bit groups with a continue bit, 5 bits for anything < 16
+
+    void Flush();  // Pads the last byte out with zeros, the buffer is complete after this
+    size_t GetBitCount() const { return m_bitCount; }
+
+  private:
+    std::vector<uint8_t>& m_buffer;
+    uint64_t m_scratch = 0;
+    int m_scratchBits = 0;
+    size_t m_bitCount = 0;
+};
+
+class BitReader {
+  public:
+    BitReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+    uint32_t Read(int bits);
+    bool ReadBool() { return Read(1) != 0; }
+    int32_t ReadSigned(int bits);
+    uint32_t ReadVarUint();
+
+    bool IsOverflowed() const { return m_overflowed; }
+    size_t GetBitsRemaining() const { return m_size * 8 - m_bitPosition; }
+
+  private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_bitPosition = 0;
+    bool m_overflowed = false;
+};
+
+}  // namespace Blacksite
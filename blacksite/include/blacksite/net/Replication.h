@@ -0,0 +1,150 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "blacksite/net/Snapshot.h"
+#include "blacksite/net/UdpSocket.h"
+
+namespace Blacksite {
+
+class EntitySystem;
+
+// Last snapshot tick's numbers, summed over all clients
+struct ReplicationStats {
+    uint32_t tick = 0;
+    size_t clients = 0;
+    size_t snapshotBytes = 0;     // Payload of the last tick's snapshots, before fragment headers
+    size_t fullSnapshots = 0;     // ...how many of them had no baseline to go against
+    float bytesPerSecond = 0.0f;  // Everything sent, averaged over the last second
+};
+
+/**
+ * ReplicationServer - Sends entity snapshots to clients over UDP
+ * Every 1/snapshotRate seconds Update captures the entity arrays, and each client gets that snapshot delta
+ * coded against the newest one it acknowledged. Clients that haven't acked anything recent enough get it in
+ * full. A client with an interest radius only hears about entities within it - leaving it is a removal,
+ * coming back a create. Snapshots bigger than a datagram go out as fragments, a lost fragment loses the tick
+ * and the next one goes against the same baseline again.
+ */
+class ReplicationServer {
+  public:
+    ReplicationServer() = default;
+    ~ReplicationServer() { Stop(); }
+
+    bool Start(uint16_t port, const ReplicationConfig& config = ReplicationConfig{});
+    void Stop();
+    bool IsRunning() const { return m_socket.IsOpen(); }
+
+    // Handles connects and acks, drops silent clients, sends a snapshot when one is due
+    void Update(const EntitySystem& entities, float deltaTime);
+
+    using ClientCallback = std::function<void(int clientId, const NetAddress& address)>;
+    void SetClientConnectedCallback(ClientCallback callback) { m_connectedCallback = callback; }
+    void SetClientDisconnectedCallback(ClientCallback callback) { m_disconnectedCallback = callback; }
+
+    // radius <= 0 = everything (the default)
+    void SetClientInterest(int clientId, const glm::vec3& center, float radius);
+    size_t GetClientCount() const { return m_clients.size(); }
+    const ReplicationStats& GetStats() const { return m_stats; }
+
+  private:
+    static constexpr size_t HISTORY_SIZE = 32;
+
+    struct Client {
+        int id = 0;
+        NetAddress address;
+        float silence = 0.0f;  // Seconds since we last heard from it
+        uint32_t ackedTick = 0;  // Newest snapshot it has, 0 = none
+        glm::vec3 interestCenter{0.0f};
+        float interestRadius = 0.0f;
+        std::array<Snapshot, HISTORY_SIZE> sent;  // What went out, by tick % size, the baseline candidates
+    };
+
+    UdpSocket m_socket;
+    ReplicationConfig m_config;
+    SnapshotCodec m_codec;
+    std::vector<Client> m_clients;
+    int m_nextClientId = 1;
+    uint32_t m_tick = 0;
+    float m_sendTimer = 0.0f;
+
+    // Reused every tick
+    Snapshot m_captured;
+    Snapshot m_filtered;
+    std::vector<uint8_t> m_payload;
+    std::vector<uint8_t> m_packet;
+    bool m_warnedOversize = false;
+
+    ReplicationStats m_stats;
+    size_t m_bytesThisSecond = 0;
+    float m_statsTimer = 0.0f;
+
+    ClientCallback m_connectedCallback;
+    ClientCallback m_disconnectedCallback;
+
+    void ReceiveMessages();
+    void DropClient(size_t index, const char* reason);
+    void SendSnapshot(Client& client, const Snapshot& snapshot);
+};
+
+/**
+ * ReplicationClient - Mirrors a ReplicationServer's entities into a local EntitySystem
+ * Keeps saying hello until the first snapshot arrives, then acks every snapshot it decodes. Update applies
+ * the newest one: server entities that appeared get spawned (without physics, the server simulates), moved
+ * ones get their transforms written, gone ones are removed. Local ids differ from the server's, GetLocalId
+ * maps between them. MESH entities show up as cubes - mesh names aren't replicated.
+ */
+class ReplicationClient {
+  public:
+    ReplicationClient() = default;
+    ~ReplicationClient() { Disconnect(); }
+
+    bool Connect(const std::string& host, uint16_t port, const ReplicationConfig& config = ReplicationConfig{});
+    // Tells the server and drops the socket. The mirrored entities stay, remove them yourself if you want.
+    void Disconnect();
+    bool IsConnecting() const { return m_socket.IsOpen() && !m_connected; }
+    bool IsConnected() const { return m_connected; }
+
+    void Update(EntitySystem& entities, float deltaTime);
+
+    int GetLocalId(int serverId) const;  // -1 if it isn't mirrored (right now)
+    uint32_t GetLastTick() const { return m_applied.tick; }
+
+  private:
+    static constexpr size_t HISTORY_SIZE = 32;
+
+    UdpSocket m_socket;
+    NetAddress m_server;
+    ReplicationConfig m_config;
+    SnapshotCodec m_codec;
+    bool m_connected = false;
+    float m_silence = 0.0f;
+    float m_helloTimer = 0.0f;
+
+    // Fragments of the tick being put together
+    uint32_t m_assemblyTick = 0;
+    uint32_t m_assemblyBaseline = 0;
+    std::vector<std::vector<uint8_t>> m_fragments;
+    size_t m_fragmentsMissing = 0;
+    std::vector<uint8_t> m_assembled;
+    Snapshot m_decoded;
+
+    std::array<Snapshot, HISTORY_SIZE> m_received;  // Decoded snapshots by tick % size, the server's baselines
+    uint32_t m_newestTick = 0;
+    Snapshot m_applied;           // What the EntitySystem mirrors right now
+    std::vector<int> m_localIds;  // By server slot, -1 = nothing there
+    std::vector<const ReplicatedEntity*> m_spawns;
+    std::vector<int> m_spawnedIds;
+
+    void SendControl(uint32_t type, uint32_t value);
+    void ReceiveMessages();
+    void ResetReception();
+    void OnFragment(BitReader& reader, const uint8_t* payload, size_t payloadSize);
+    void DecodeAssembled();
+    void Apply(EntitySystem& entities, const Snapshot& snapshot);
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+namespace Blacksite {
+
+class BitReader;
+class BitWriter;
+class EntitySystem;
+
+// Quantization and rates - server and clients have to agree on all of it
+struct ReplicationConfig {
+    float snapshotRate = 20.0f;                // Snapshots per second
+    float positionPrecision = 1.0f / 512.0f;  // Metres per step, ~2mm
+    int positionBits = 24;                     // Per axis, +-16km at the default precision
+    int positionDeltaBits = 12;                // Per axis, moves within +-4m of the baseline take these instead
+    int rotationBits = 10;                     // Per smallest-three component (max 10), 2 + 3 * 10 = 32 bits
+    float scalePrecision = 1.0f / 256.0f;
+    int scaleBits = 16;                        // Unsigned, up to 256
+    float clientTimeout = 5.0f;                // Seconds without hearing from the other side
+};
+
+// One entity as it goes over the wire - already quantized, so comparing against a baseline is exact
+struct ReplicatedEntity {
+    uint32_t slot = 0;        // Entity id's slot index, snapshots are sorted by it
+    uint32_t generation = 0;  // Rest of the id, a new generation in the same slot is a new entity
+    uint8_t shape = 0;
+    uint32_t color = 0;       // RGB8
+    int32_t position[3] = {0, 0, 0};
+    uint32_t rotation = 0;    // Smallest three, see QuantizeRotation
+    uint32_t scale[3] = {0, 0, 0};
+
+    int GetId() const;
+    bool SameAppearance(const ReplicatedEntity& other) const {
+        return shape == other.shape && color == other.color;
+    }
+};
+
+struct Snapshot {
+    uint32_t tick = 0;
+    std::vector<ReplicatedEntity> entities;  // Ascending slot
+};
+
+/**
+ * SnapshotCodec - Quantization and delta coding of entity snapshots
+ * Capture reads the active entities' transforms and looks out of the EntitySystem. WriteDelta encodes a
+ * snapshot against a baseline the receiver already has (or none): both are walked in slot order, entities
+ * that didn't change cost nothing, new ones go out in full, gone ones as a slot number. Moves write only the
+ * axes that changed, as small deltas when they fit. ReadDelta rebuilds the full snapshot on the other end,
+ * which then becomes a baseline itself.
+ */
+class SnapshotCodec {
+  public:
+    explicit SnapshotCodec(const ReplicationConfig& config = ReplicationConfig{}) : m_config(config) {}
+
+    void Capture(const EntitySystem& entities, uint32_t tick, Snapshot& out) const;
+
+    // Only entities within radius of center (radius <= 0 keeps everything)
+    void FilterByDistance(const Snapshot& source, const glm::vec3& center, float radius, Snapshot& out) const;
+
+    void WriteDelta(const Snapshot& baseline, const Snapshot& current, BitWriter& writer) const;
+    // False if the data is malformed, 'out' is unusable then
+    bool ReadDelta(const Snapshot& baseline, BitReader& reader, Snapshot& out) const;
+
+    int32_t QuantizePosition(float value) const;
+    float DequantizePosition(int32_t value) const;
+    uint32_t QuantizeRotation(const glm::quat& rotation) const;
+    glm::quat DequantizeRotation(uint32_t packed) const;
+    uint32_t QuantizeScale(float value) const;
+    float DequantizeScale(uint32_t value) const;
+
+    const ReplicationConfig& GetConfig() const { return m_config; }
+
+  private:
+    ReplicationConfig m_config;
+
+    void WriteFull(const ReplicatedEntity& entity, BitWriter& writer) const;
+    void ReadFull(BitReader& reader, ReplicatedEntity& entity) const;
+    void WriteChanges(const ReplicatedEntity& baseline, const ReplicatedEntity& current, BitWriter& writer) const;
+    void ReadChanges(BitReader& reader, ReplicatedEntity& entity) const;
+};
+
+}  // namespace Blacksite
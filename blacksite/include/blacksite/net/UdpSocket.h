@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Blacksite {
+
+// IPv4 address + port, host byte order
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+    bool IsValid() const { return port != 0; }
+    std::string ToString() const;
+
+    // Dotted quad or host name. False (and an invalid address) if it doesn't resolve.
+    static bool Resolve(const std::string& host, uint16_t port, NetAddress& out);
+};
+
+/**
+ * UdpSocket - Non-blocking IPv4 datagram socket
+ * Receive returns straight away when nothing is queued, so the engine can drain it once per frame.
+ * BSD sockets everywhere but Windows, Winsock there (started on first use).
+ */
+class UdpSocket {
+  public:
+    UdpSocket() = default;
+    ~UdpSocket() { Close(); }
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    bool Open(uint16_t port = 0);  // 0 = any free port, what clients want
+    void Close();
+    bool IsOpen() const { return m_handle != INVALID_HANDLE; }
+    uint16_t GetPort() const { return m_port; }
+
+    bool Send(const NetAddress& to, const void* data, size_t size);
+    // Bytes received (0 = nothing waiting). Datagrams longer than capacity are dropped or cut short depending
+    // on the platform, size the buffer for MAX_DATAGRAM.
+    size_t Receive(NetAddress& from, void* data, size_t capacity);
+
+    static constexpr size_t MAX_DATAGRAM = 1400;  // Stays under the usual MTU once IP/UDP headers are added
+
+  private:
+    static constexpr intptr_t INVALID_HANDLE = -1;
+    intptr_t m_handle = INVALID_HANDLE;  // SOCKET on Windows, fd elsewhere
+    uint16_t m_port = 0;
+};
+
+}  // namespace Blacksite
@@ -1,6 +1,9 @@
 #pragma once
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <memory>
+#include <vector>
 
 namespace Blacksite {
 
@@ -14,7 +17,50 @@ struct Collider {
     ColliderType type = ColliderType::Box;
     glm::vec3 center = glm::vec3(0.0f); // Local offset
     glm::quat rotation = glm::quat();   // Local rotation
-    glm::vec3 size = glm::vec3(1.0f);   // Extents for box, radius/height for others
+    glm::vec3 size = glm::vec3(1.0f);   // Box: full extents, sphere: diameter (largest axis),
+                                        // capsule: diameter in x, full height (caps included) in y
+};
+
+// An entity's colliders, shared until someone writes to them. Copies (prefab instances, duplicates, default
+// colliders) all point at one list, the first non-const call makes a private copy. Reads look like a
+// const std::vector<Collider>. Main thread only, like the rest of the Entity's cold data.
+class ColliderSet {
+  public:
+    ColliderSet() = default;
+    ColliderSet(std::vector<Collider> colliders)
+        : m_colliders(std::make_shared<std::vector<Collider>>(std::move(colliders))) {}
+
+    const std::vector<Collider>& Get() const { return m_colliders ? *m_colliders : Empty(); }
+    operator const std::vector<Collider>&() const { return Get(); }
+
+    bool empty() const { return Get().empty(); }
+    size_t size() const { return Get().size(); }
+    std::vector<Collider>::const_iterator begin() const { return Get().begin(); }
+    std::vector<Collider>::const_iterator end() const { return Get().end(); }
+    const Collider& operator[](size_t index) const { return Get()[index]; }
+
+    // Writes, each one detaches from whoever else holds the list
+    Collider& operator[](size_t index) { return Mutable()[index]; }
+    void push_back(const Collider& collider) { Mutable().push_back(collider); }
+    void resize(size_t count) { Mutable().resize(count); }
+    void Erase(size_t index) { Mutable().erase(Mutable().begin() + static_cast<std::ptrdiff_t>(index)); }
+    void clear() { m_colliders.reset(); }
+    std::vector<Collider>& Mutable() {
+        if (!m_colliders || m_colliders.use_count() > 1) {
+            m_colliders = std::make_shared<std::vector<Collider>>(Get());
+        }
+        return *m_colliders;
+    }
+
+    bool IsShared() const { return m_colliders && m_colliders.use_count() > 1; }
+
+  private:
+    std::shared_ptr<std::vector<Collider>> m_colliders;  // Null = no colliders, nothing allocated
+
+    static const std::vector<Collider>& Empty() {
+        static const std::vector<Collider> empty;
+        return empty;
+    }
 };
 
 }  // namespace Blacksite
@@ -0,0 +1,15 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Blacksite {
+
+// One new contact between two entity bodies, recorded during the physics step
+struct CollisionEvent {
+    int entityA = -1;
+    int entityB = -1;
+    glm::vec3 point{0.0f};   // World-space contact point on A
+    glm::vec3 normal{0.0f};  // World space, pointing from A to B
+    float penetrationDepth = 0.0f;
+};
+
+}  // namespace Blacksite
@@ -1,6 +1,7 @@
 #pragma once
 
-// Disable profiling to avoid linking issues
+// Jolt's profiler stays off here, BLACKSITE_PROFILE_JOLT turns it on (external mode, into core/Profiler)
+// for Jolt and us together so both sides agree
 // #define JPH_PROFILE_ENABLED
 // #define JPH_DEBUG_RENDERER
 
@@ -0,0 +1,36 @@
+#pragma once
+#include "JoltConfig.h"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+namespace Blacksite {
+
+class JobSystem;
+
+/**
+ * JoltJobSystem - Jolt's JobSystem interface running on the engine's JobSystem
+ * Jolt keeps its own job objects, dependency counts and barriers (JobSystemWithBarrier), this only
+ * hands the ready ones to the engine workers. So a physics step and the rest of the frame's jobs
+ * share one set of threads instead of fighting over the cores.
+ */
+class JoltJobSystem final : public JPH::JobSystemWithBarrier {
+  public:
+    JoltJobSystem(JobSystem& jobs, JPH::uint maxJobs, JPH::uint maxBarriers);
+
+    int GetMaxConcurrency() const override;
+    JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction,
+                        JPH::uint32 inNumDependencies = 0) override;
+
+  protected:
+    void QueueJob(Job* inJob) override;
+    void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+    void FreeJob(Job* inJob) override;
+
+  private:
+    JobSystem& m_jobs;
+    JPH::FixedSizeFreeList<Job> m_jobPool;  // Jobs come and go every step, no heap allocation for each one
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Blacksite {
+
+using PhysicsLayer = uint16_t;
+
+/**
+ * PhysicsLayerConfig - Object layers, the broadphase layer each one lives in, and which layers collide
+ * Every body sits in one object layer. Jolt keeps one broadphase tree per broadphase layer, so layers
+ * that move differently (static world, debris, projectiles) should get their own broadphase layer.
+ * The two built-in layers are always there: STATIC for non-moving bodies, MOVING for the rest.
+ */
+class PhysicsLayerConfig {
+  public:
+    static constexpr PhysicsLayer STATIC = 0;
+    static constexpr PhysicsLayer MOVING = 1;
+    static constexpr uint32_t MAX_LAYERS = 32;  // Object and broadphase layers each, the masks are 32 bit
+
+    // Built-in layers: static and moving in their own broadphase layers, static skips static
+    PhysicsLayerConfig() {
+        AddBroadPhaseLayer("Static");
+        AddBroadPhaseLayer("Moving");
+        AddLayer("Static", 0);
+        AddLayer("Moving", 1);
+        SetCollision(STATIC, MOVING, true);
+        SetCollision(MOVING, MOVING, true);
+    }
+
+    // Returns the new broadphase layer index, -1 when full
+    int AddBroadPhaseLayer(const std::string& name) {
+        if (m_broadPhaseNames.size() >= MAX_LAYERS)
+            return -1;
+        m_broadPhaseNames.push_back(name);
+        return static_cast<int>(m_broadPhaseNames.size()) - 1;
+    }
+
+    // New object layers collide with nothing until SetCollision says so. -1 when full or the
+    // broadphase layer doesn't exist.
+    int AddLayer(const std::string& name, uint32_t broadPhaseLayer) {
+        if (m_layerNames.size() >= MAX_LAYERS || broadPhaseLayer >= m_broadPhaseNames.size())
+            return -1;
+        m_layerNames.push_back(name);
+        m_layerBroadPhase.push_back(static_cast<uint8_t>(broadPhaseLayer));
+        m_collisionMasks.push_back(0);
+        return static_cast<int>(m_layerNames.size()) - 1;
+    }
+
+    // Symmetric, setting a/b also sets b/a
+    void SetCollision(PhysicsLayer a, PhysicsLayer b, bool collide) {
+        if (a >= m_layerNames.size() || b >= m_layerNames.size())
+            return;
+        if (collide) {
+            m_collisionMasks[a] |= 1u << b;
+            m_collisionMasks[b] |= 1u << a;
+        } else {
+            m_collisionMasks[a] &= ~(1u << b);
+            m_collisionMasks[b] &= ~(1u << a);
+        }
+    }
+
+    bool ShouldCollide(PhysicsLayer a, PhysicsLayer b) const {
+        return a < m_collisionMasks.size() && (m_collisionMasks[a] & (1u << b)) != 0;
+    }
+
+    // Does 'layer' collide with anything living in this broadphase layer
+    bool ShouldCollideWithBroadPhase(PhysicsLayer layer, uint8_t broadPhaseLayer) const {
+        if (layer >= m_collisionMasks.size())
+            return false;
+        uint32_t mask = m_collisionMasks[layer];
+        for (uint32_t other = 0; mask != 0; ++other, mask >>= 1) {
+            if ((mask & 1u) && m_layerBroadPhase[other] == broadPhaseLayer)
+                return true;
+        }
+        return false;
+    }
+
+    // -1 when there's no layer by that name
+    int FindLayer(const std::string& name) const {
+        for (size_t i = 0; i < m_layerNames.size(); ++i) {
+            if (m_layerNames[i] == name)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    uint32_t GetLayerCount() const { return static_cast<uint32_t>(m_layerNames.size()); }
+    uint32_t GetBroadPhaseLayerCount() const { return static_cast<uint32_t>(m_broadPhaseNames.size()); }
+    uint8_t GetBroadPhaseLayer(PhysicsLayer layer) const { return m_layerBroadPhase[layer]; }
+    const std::string& GetLayerName(PhysicsLayer layer) const { return m_layerNames[layer]; }
+    const std::string& GetBroadPhaseLayerName(uint8_t broadPhaseLayer) const { return m_broadPhaseNames[broadPhaseLayer]; }
+
+  private:
+    std::vector<std::string> m_layerNames;
+    std::vector<uint8_t> m_layerBroadPhase;
+    std::vector<uint32_t> m_collisionMasks;  // Bit n set = collides with layer n
+    std::vector<std::string> m_broadPhaseNames;
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,25 @@
+#pragma once
+#include <blacksite/physics/JoltConfig.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Blacksite {
+
+struct Ray {
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};  // Doesn't have to be normalized
+    float maxDistance = 100.0f;
+};
+
+// Closest hit of a ray or sweep. entityId is -1 for bodies that aren't entities (or nothing was hit)
+struct QueryHit {
+    bool hit = false;
+    int entityId = -1;
+    JPH::BodyID body;
+    glm::vec3 point{0.0f};
+    glm::vec3 normal{0.0f};
+    float distance = 0.0f;
+};
+
+}  // namespace Blacksite
@@ -3,14 +3,18 @@
 
 // Include our Jolt configuration first
 #include "blacksite/core/Entity.h"
+#include "blacksite/physics/CollisionEvent.h"
+#include "blacksite/physics/PhysicsLayers.h"
+#include "blacksite/physics/PhysicsQuery.h"
 #include "JoltConfig.h"
 
 // Jolt Physics includes
 #include <Jolt/Core/Factory.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/JobSystem.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/PhysicsSettings.h>
@@ -18,7 +22,11 @@
 #include <Jolt/RegisterTypes.h>
 
 #include <glm/glm.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 
 namespace Blacksite {
@@ -26,17 +34,71 @@ namespace Blacksite {
 // Convert between GLM and Jolt types
 JPH::Vec3 ToJoltPos(const glm::vec3& v);
 glm::vec3 ToGLMPos(const JPH::Vec3& v);
-JPH::Quat ToJoltRot(const glm::vec3& eulerAngles);
-glm::vec3 ToGLMRot(const JPH::Quat& q);
+JPH::Quat ToJoltRot(const glm::quat& q);
+JPH::Quat ToJoltRot(const glm::vec3& eulerAngles);  // Euler degrees, XYZ
+JPH::Quat ToJoltRot(const Transform& transform);
+glm::quat ToGLMQuat(const JPH::Quat& q);
+glm::vec3 ToGLMRot(const JPH::Quat& q);  // Euler degrees, for code that wants angles
+
+// Jolt sizes everything up front in Init, so these are hard limits - past maxBodies body creation
+// fails, past the pair/constraint limits contacts get dropped. The defaults are the old fixed limits, meant
+// for small scenes - raise them for the biggest scene you load.
+struct PhysicsConfig {
+    uint32_t maxBodies = 1024;
+    uint32_t maxBodyPairs = 1024;            // Broadphase pairs per step
+    uint32_t maxContactConstraints = 1024;   // Touching pairs the solver takes per step
+    uint32_t numBodyMutexes = 0;             // 0 = Jolt picks
+    size_t tempAllocatorSize = 10 * 1024 * 1024;  // Per-step scratch, grow with the body count. Capped just under 4 GB.
+    int jobThreads = -1;                     // Own Jolt thread pool only (no JobSystem given), -1 = hardware threads - 1
+    uint32_t maxCollisionEventsPerThread = 4096;  // Per thread per Update (all its steps), the rest are dropped
+    PhysicsLayerConfig layers;               // Object/broadphase layers + collision matrix, fixed after Init
+};
+
+// Snapshot of what's used vs what was configured
+struct PhysicsCapacityReport {
+    uint32_t numBodies = 0;
+    uint32_t numActiveBodies = 0;
+    uint32_t maxBodies = 0;
+    uint32_t maxBodyPairs = 0;
+    uint32_t maxContactConstraints = 0;
+    size_t tempAllocatorSize = 0;
+    int jobThreads = 0;
+};
+
+class JobSystem;
 
 class PhysicsSystem {
   public:
     PhysicsSystem();
     ~PhysicsSystem();
 
-    bool Initialize();
+    // With a JobSystem the step's jobs run on its workers (the Engine passes its own), without one
+    // Jolt gets a private thread pool of config.jobThreads threads
+    bool Initialize(const PhysicsConfig& config = PhysicsConfig{}, JobSystem* jobSystem = nullptr);
     void Shutdown();
-    void Update(float deltaTime);
+    // Fixed step mode: frame time goes into an accumulator and the world advances in whole steps.
+    // Returns how many steps were taken (0 on a short frame). Variable mode always takes 1.
+    int Update(float deltaTime);
+
+    // --- Timestep ---
+    void SetFixedTimestep(bool enabled, float stepSeconds = 1.0f / 60.0f);
+    void SetMaxSubSteps(int maxSubSteps);  // Per frame, anything beyond that is dropped
+    bool IsFixedTimestep() const { return m_fixedTimestep; }
+    float GetFixedStep() const { return m_fixedStep; }
+    int GetMaxSubSteps() const { return m_maxSubSteps; }
+    int GetLastStepCount() const { return m_lastStepCount; }
+    // How far we are between the last two steps (0..1), what the renderer should blend by
+    float GetInterpolationAlpha() const;
+
+    // --- Threaded stepping ---
+    // Off by default. When on, BeginStep runs the step on a dedicated thread so it overlaps with
+    // rendering, WaitForStep collects it. Between the two the bodies belong to that thread - don't
+    // create, move, push or query bodies until the wait. The engine waits before the scene update and
+    // begins after the update callbacks, so game code in update callbacks is safe.
+    void SetThreadedStepping(bool enabled);
+    bool IsThreadedStepping() const { return m_threadedStepping; }
+    int BeginStep(float deltaTime);  // Returns steps started, same as Update
+    void WaitForStep();              // No-op when nothing is in flight or threading is off
 
     // Body creation
     JPH::BodyID CreateBoxBody(const glm::vec3& position, const glm::vec3& size, bool isStatic = false);
@@ -46,6 +108,8 @@ class PhysicsSystem {
     // Body manipulation
     void SetBodyPosition(JPH::BodyID bodyID, const glm::vec3& position);
     void SetBodyRotation(JPH::BodyID bodyID, const glm::vec3& eulerAngles);
+    void SetBodyRotation(JPH::BodyID bodyID, const glm::quat& rotation);
+    void SetBodyPositionAndRotation(JPH::BodyID bodyID, const glm::vec3& position, const glm::quat& rotation);
     glm::vec3 GetBodyPosition(JPH::BodyID bodyID);
     glm::vec3 GetBodyRotation(JPH::BodyID bodyID);
 
@@ -61,12 +125,44 @@ class PhysicsSystem {
     bool IsBodyStatic(JPH::BodyID bodyID);
 
     JPH::BodyID CreatePhysicsBody(Entity& entity);
+
+    // Bulk version for level loads - creates every body first, then inserts them all into the
+    // broadphase with one AddBodiesPrepare/AddBodiesFinalize instead of an AddBody per entity
+    void CreatePhysicsBodies(const std::vector<Entity*>& entities);
     void UpdatePhysicsBody(Entity& entity);
     void RemovePhysicsBody(Entity& entity);
 
+    // Entity bodies aren't added/removed one at a time - they queue up and go into the broadphase
+    // as one batch per frame, right before the step. Update does this itself, call it directly to
+    // have new bodies collide before the next step. Touching a queued body (At, Push, ...) edits it in
+    // place, it still goes in with the batch. Queries flush first, so they never see stale adds or removals.
+    void FlushBodyChanges();
+    size_t GetPendingBodyChanges() const { return m_pendingAdds.size() + m_pendingRemovals.size(); }
+
+    // While a hold is open, new bodies collect in 'held' instead of the add queue: they exist but stay out of
+    // the world until AddHeldBodies queues them. For building a scene next to the running one, see
+    // SceneSystem::LoadSceneAsync. Held bodies can still be removed, they're destroyed without ever going in.
+    void BeginHoldingBodies(std::vector<JPH::BodyID>* held) { m_heldAdds = held; }
+    void EndHoldingBodies() { m_heldAdds = nullptr; }
+    void AddHeldBodies(std::vector<JPH::BodyID>& held);
+
+    // Moves every entity's body to its transform's position + rotation, for EntityEditBatch. One activation call
+    // for all of them and no per-body locks, so a threaded step in flight is waited for first.
+    // Entities without a body are skipped.
+    void SetBodyTransforms(const std::vector<Entity*>& entities);
+
+    // Puts the bodies to sleep (or wakes them) with one call for the lot. Waits out a threaded step, like above.
+    // Asleep they cost nothing, but a moving body touching one wakes it again.
+    void SetBodiesSleeping(const std::vector<JPH::BodyID>& bodies, bool sleeping);
+
+    // Swaps the body's shape for the cached one at this scale, no rebuild when the scale was seen before
+    void SetBodyScale(Entity& entity, const glm::vec3& scale);
+
     // Collider management
     void AddColliderToEntity(Entity& entity, const Collider& collider);
     void RemoveColliderFromEntity(Entity& entity, size_t colliderIndex);
+    // What entities without colliders get, one shared list per shape
+    static const ColliderSet& GetDefaultColliders(Entity::VisualShape shape);
 
     // Getters for EntityHandle
     glm::vec3 GetVelocity(JPH::BodyID bodyID);
@@ -79,40 +175,180 @@ class PhysicsSystem {
     float GetBodyMass(JPH::BodyID bodyID);
     glm::vec3 GetBodyCenterOfMass(JPH::BodyID bodyID);
 
-    // Body mapping (you'll need to implement the mapping between entity IDs and body IDs)
-    JPH::BodyID GetBodyIDFromEntityID(int entityId);
+    // Entity <-> body mapping, plain array lookups both ways. Invalid/-1 for stale ids.
+    JPH::BodyID GetBodyIDFromEntityID(int entityId) const;
+    int GetEntityIDFromBodyID(const JPH::BodyID& bodyID) const;
     void MapEntityToBody(int entityId, JPH::BodyID bodyID);
     void UnmapEntity(int entityId);
 
+    // Copies position + rotation of every awake body into its entity's transform. Sleeping bodies are
+    // skipped, and the rotation goes in as a quaternion (Transform::orientation), no Euler conversion.
+    // The pose being replaced is kept as the slot's previous pose for render interpolation.
+    // Call between simulation steps only - it reads bodies without taking locks.
+    size_t SyncActiveBodies(ComponentStore& components);
+
+    // --- Collision events ---
+    // New contacts between entity bodies get recorded during the step, without locks, into one buffer
+    // per worker thread. After the step, call this on the main thread to move them all into 'out'
+    // (appended) and reset the buffers. The scene does it every frame and calls Entity::OnCollision.
+    // Whatever isn't drained by the next step is thrown away, so nothing piles up.
+    void DrainCollisionEvents(std::vector<CollisionEvent>& out);
+
+    // --- Queries ---
+    // Narrowphase queries against everything in the world. Fine any time the step isn't running (with
+    // threaded stepping: not between BeginStep and WaitForStep). Each one flushes the queued body adds and
+    // removals first, so bodies removed this frame are never hit.
+
+    // Closest hit per ray, outHits[i] belongs to rays[i]. Big batches are split over the Jolt job threads.
+    void RaycastBatch(const std::vector<Ray>& rays, std::vector<QueryHit>& outHits);
+    QueryHit Raycast(const Ray& ray);
+
+    // Entities whose shapes touch the sphere, each listed once. Returns how many were appended to 'out'.
+    size_t OverlapSphere(const glm::vec3& center, float radius, std::vector<int>& out);
+
+    // Sweeps a box from 'from' to 'to' and reports the first thing it hits. The box keeps its exact size,
+    // except that zero extents become a millimetre (Jolt can't cast a completely flat box).
+    QueryHit SweepBox(const glm::vec3& halfExtents, const glm::quat& rotation, const glm::vec3& from,
+                      const glm::vec3& to);
+
+    // --- Shape cache ---
+    // Identical collider sets at the same scale share one Jolt shape. Scaled versions are a ScaledShape
+    // around the unit-scale shape, so a scale change never rebuilds the geometry. Safe from any thread, so
+    // loaders can build shapes ahead of the bodies that use them.
+    JPH::Ref<JPH::Shape> GetOrCreateShape(const std::vector<Collider>& colliders, const glm::vec3& scale);
+    size_t GetShapeCacheSize() const;
+    void PruneShapeCache();  // Drops shapes no body uses anymore
+
+    // --- Layers ---
+    // Entities pick a layer with PhysicsComponent::layer, left at AUTO_LAYER they go in Static/Moving
+    // by motion type. The layer list is fixed after Initialize, which pairs collide is not.
+    int FindLayer(const std::string& name) const { return m_config.layers.FindLayer(name); }
+    void SetBodyLayer(Entity& entity, PhysicsLayer layer);
+    void SetLayerCollision(PhysicsLayer a, PhysicsLayer b, bool collide);  // Not while a step is running
+    const PhysicsLayerConfig& GetLayers() const { return m_config.layers; }
+
+    // --- Capacity ---
+    const PhysicsConfig& GetConfig() const { return m_config; }
+    PhysicsCapacityReport GetCapacityReport() const;
+    void LogCapacityReport() const;
+
     // Get the Jolt physics system for advanced usage
     JPH::PhysicsSystem* GetPhysicsSystem() { return m_physicsSystem.get(); }
 
   private:
     // Jolt Physics objects
     std::unique_ptr<JPH::TempAllocatorImpl> m_tempAllocator;
-    std::unique_ptr<JPH::JobSystemThreadPool> m_jobSystem;
+    std::unique_ptr<JPH::JobSystem> m_jobSystem;  // JoltJobSystem or a JobSystemThreadPool
     std::unique_ptr<JPH::PhysicsSystem> m_physicsSystem;
 
-    // Entity ID to Body ID mapping
-    std::unordered_map<int, JPH::BodyID> m_entityToBodyMap;
+    // Entity slot -> body (with the full entity id to catch reused slots), and body index -> entity id.
+    // Bodies also carry (entity id + 1) as user data, 0 = no entity.
+    struct EntityBodyLink {
+        int entityId = -1;
+        JPH::BodyID body;
+    };
+    std::vector<EntityBodyLink> m_entityBodies;
+    std::vector<int> m_bodyEntities;
+    JPH::BodyIDVector m_activeBodies;  // Scratch for SyncActiveBodies
+    std::vector<uint32_t> m_syncedSlots;  // Slots written by the last sync, their previous pose needs catching up
+
+    // Timestep
+    static constexpr float MAX_FRAME_TIME = 0.25f;  // A longer frame (breakpoint, window drag) counts as this
+    bool m_fixedTimestep = true;
+    float m_fixedStep = 1.0f / 60.0f;
+    int m_maxSubSteps = 4;
+    float m_accumulator = 0.0f;
+    int m_lastStepCount = 0;
+    float m_renderAlpha = 0.0f;
+
+    int AdvanceAccumulator(float deltaTime);  // Steps this frame time pays for
+    void RunSteps(int steps, float stepTime);  // Only touches Jolt, safe on the step thread
+    float GetStepTime(int steps, float deltaTime) const;
+    float ComputeAlpha() const;
+
+    // Step thread - m_stepMutex guards the request fields
+    bool m_threadedStepping = false;
+    std::thread m_stepThread;
+    std::mutex m_stepMutex;
+    std::condition_variable m_stepWake;
+    std::condition_variable m_stepDone;
+    bool m_stepRequested = false;
+    bool m_stopStepThread = false;
+    int m_requestedSteps = 0;
+    float m_requestedStepTime = 0.0f;
+    float m_pendingAlpha = 0.0f;  // Alpha for the step in flight, published by WaitForStep
+    void StepThreadMain();
+
+    // Queries
+    static constexpr size_t RAYS_PER_JOB = 64;
+    static constexpr size_t PARALLEL_RAY_THRESHOLD = 256;  // Smaller batches stay on the calling thread
+    void CastRayRange(const Ray* rays, QueryHit* hits, size_t count) const;
+
+    // Deferred broadphase changes, drained by FlushBodyChanges
+    static constexpr size_t BROADPHASE_OPTIMIZE_THRESHOLD = 1024;  // Body adds + removes before a rebuild
+    std::vector<JPH::BodyID> m_pendingAdds;
+    std::vector<JPH::BodyID> m_pendingRemovals;
+    std::vector<JPH::BodyID>* m_heldAdds = nullptr;  // Open hold, new bodies go here instead
+    std::vector<JPH::BodyID> m_removedInWorld;       // Flush scratch, the removals that made it into the world
+    void QueueBodyAdd(JPH::BodyID bodyID) { (m_heldAdds ? *m_heldAdds : m_pendingAdds).push_back(bodyID); }
+    size_t m_bodiesChangedSinceOptimize = 0;
+    void FlushPendingAdds() {
+        if (!m_pendingAdds.empty())
+            FlushBodyChanges();
+    }
+
+    // Colliders + scale, compared bit for bit
+    struct ShapeCacheKey {
+        std::vector<Collider> colliders;
+        glm::vec3 scale;
+        bool operator==(const ShapeCacheKey& other) const;
+    };
+    struct ShapeCacheKeyHash {
+        size_t operator()(const ShapeCacheKey& key) const;
+    };
+    static constexpr size_t SHAPE_CACHE_PRUNE_SIZE = 4096;  // Prune unused shapes once the cache gets this big
+    std::unordered_map<ShapeCacheKey, JPH::Ref<JPH::Shape>, ShapeCacheKeyHash> m_shapeCache;
+    mutable std::mutex m_shapeCacheMutex;
+    void PruneShapeCacheLocked();
 
     JPH::Ref<JPH::Shape> CreateShapeFromColliders(const std::vector<Collider>& colliders, const glm::vec3& entityScale);
     JPH::Ref<JPH::Shape> CreateSingleColliderShape(const Collider& collider, const glm::vec3& entityScale);
     void AddDefaultColliderToEntity(Entity& entity);
+    static Collider MakeDefaultCollider(Entity::VisualShape shape);
 
-    // Layers and filters (we'll keep it simple for now)
-    static constexpr JPH::ObjectLayer NON_MOVING = 0;
-    static constexpr JPH::ObjectLayer MOVING = 1;
-    static constexpr JPH::ObjectLayer NUM_LAYERS = 2;
+    // Built-in layers, what CreateBoxBody & co. and AUTO_LAYER entities use
+    static constexpr JPH::ObjectLayer NON_MOVING = PhysicsLayerConfig::STATIC;
+    static constexpr JPH::ObjectLayer MOVING = PhysicsLayerConfig::MOVING;
+    JPH::ObjectLayer ResolveLayer(const PhysicsComponent& physics) const;
 
     class BPLayerInterfaceImpl;
     class ObjectVsBroadPhaseLayerFilterImpl;
     class ObjectLayerPairFilterImpl;
+    class ContactListenerImpl;
 
     std::unique_ptr<BPLayerInterfaceImpl> m_broadPhaseLayerInterface;
     std::unique_ptr<ObjectVsBroadPhaseLayerFilterImpl> m_objectVsBroadphaseLayerFilter;
     std::unique_ptr<ObjectLayerPairFilterImpl> m_objectVsObjectLayerFilter;
+    std::unique_ptr<ContactListenerImpl> m_contactListener;
+
+    // Collision event buffers. Each thread that runs contact callbacks claims a buffer the first time
+    // and only ever writes its own, so no locking. Threads past the buffer count share the overflow
+    // buffer through an atomic index. Cache-line aligned so the writers don't false-share counts.
+    // Threads remember their claim by m_eventGeneration, which is new on every Initialize.
+    struct alignas(64) CollisionEventBuffer {
+        std::unique_ptr<CollisionEvent[]> events;
+        uint32_t count = 0;
+    };
+    std::vector<CollisionEventBuffer> m_collisionBuffers;
+    std::atomic<int> m_nextCollisionBuffer{0};
+    uint32_t m_eventGeneration = 0;
+    std::unique_ptr<CollisionEvent[]> m_overflowEvents;
+    std::atomic<uint32_t> m_overflowCount{0};
+    std::atomic<uint32_t> m_droppedCollisionEvents{0};
+    void RecordCollisionEvent(const CollisionEvent& event);  // Called from Jolt's job threads
+    void ClearCollisionEvents();
 
+    PhysicsConfig m_config;
     bool m_initialized = false;
 };
 
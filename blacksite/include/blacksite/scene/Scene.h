@@ -1,13 +1,22 @@
 #pragma once
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 #include "blacksite/core/CameraSystem.h"
 #include "blacksite/core/EntityHandle.h"
 #include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/FrameArena.h"
+#include "blacksite/graphics/Frustum.h"
+#include "blacksite/graphics/RenderCommand.h"
+#include "blacksite/scene/SimulationLod.h"
+#include "blacksite/scene/SpatialIndex.h"
+#include "blacksite/scene/StaticBatcher.h"
 
 namespace Blacksite {
 
+class HiZBuffer;
 class PhysicsSystem;
 class Renderer;
 
@@ -49,11 +58,20 @@ class Scene {
     int SpawnPlane(const glm::vec3& position, const glm::vec3& size, const std::string& shader,
                    const glm::vec3& color = glm::vec3(1.0f));
 
+    int SpawnMesh(const std::string& mesh, const glm::vec3& position, const std::string& shader = "basic",
+                  const glm::vec3& color = glm::vec3(1.0f));
+
     // Generic spawn method
     int SpawnEntity(Entity::VisualShape shape, const glm::vec3& position, const std::string& shader = "basic",
                     const glm::vec3& color = glm::vec3(1.0f));
 
+    // Many entities in one call, see EntitySystem::SpawnBatch
+    size_t SpawnBatch(const std::vector<glm::vec3>& positions, const std::vector<Entity::VisualShape>& shapes,
+                      const std::vector<glm::vec3>& colors, const std::string& shader = "basic",
+                      std::vector<int>* outIds = nullptr);
+
     EntityHandle GetEntity(int id);
+    EntityEditBatch EditEntities();  // Many transform edits, one physics pass - see EntityEditBatch
     void RemoveEntity(int id);
 
     // --- Camera Management ---
@@ -74,6 +92,55 @@ class Scene {
     void SetUpdateCallback(UpdateCallback callback) { m_updateCallback = callback; }
     void SetRenderCallback(RenderCallback callback) { m_renderCallback = callback; }
 
+    // --- Culling ---
+    void SetFrustumCullingEnabled(bool enabled) { m_frustumCulling = enabled; }
+    bool IsFrustumCullingEnabled() const { return m_frustumCulling; }
+    size_t GetVisibleEntityCount() const { return m_visibleEntityCount; }  // From the last Render
+    // Visible entities whose world matrix had to be built last Render, the rest came from the cache
+    size_t GetRebuiltMatrixCount() const { return m_rebuiltMatrixCount.load(std::memory_order_relaxed); }
+
+    // Skips entities hidden behind what the renderer drew a frame or two ago. Only does anything while
+    // Renderer::SetOcclusionCullingEnabled is on, that's what builds the depth pyramid.
+    void SetOcclusionCullingEnabled(bool enabled) { m_occlusionCulling = enabled; }
+    bool IsOcclusionCullingEnabled() const { return m_occlusionCulling; }
+    size_t GetOccludedEntityCount() const { return m_occludedEntityCount.load(std::memory_order_relaxed); }
+
+    // --- Spatial Queries ---
+    // Active entities by bounding sphere, ids appended to 'out'. The index catches up at the end of every
+    // Update (after the physics sync), so entity Updates see where things were at the end of the last frame.
+    void QuerySphere(const glm::vec3& center, float radius, std::vector<int>& out) const {
+        m_spatialIndex.QuerySphere(center, radius, out);
+    }
+    void QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<int>& out) const {
+        m_spatialIndex.QueryBox(min, max, out);
+    }
+    SpatialIndex& GetSpatialIndex() { return m_spatialIndex; }
+    const SpatialIndex& GetSpatialIndex() const { return m_spatialIndex; }
+
+    // --- Level of Detail ---
+    // Meshes with LODs swap to coarser ones as they get small on screen
+    void SetLodEnabled(bool enabled) { m_lodEnabled = enabled; }
+    bool IsLodEnabled() const { return m_lodEnabled; }
+
+    // --- Static Batching ---
+    // Merges static entities into a few world-space meshes, happens on the next Render.
+    // Entities spawned afterwards draw individually until baked again.
+    void BakeStaticGeometry() { m_staticBatcher.RequestBake(); }
+    void ClearStaticGeometry() { m_staticBatcher.RequestClear(); }
+    size_t GetStaticBatchCount() const { return m_staticBatcher.GetBatchCount(); }
+    size_t GetStaticBatchedEntityCount() const { return m_staticBatcher.GetBatchedEntityCount(); }
+
+    // --- Simulation LOD ---
+    // Far away entities get their Update every few frames, with the time they missed. Off by default.
+    // Turning it off wakes any bodies it put to sleep on the next Update.
+    void SetSimulationLodEnabled(bool enabled) { m_simulationLodEnabled = enabled; }
+    bool IsSimulationLodEnabled() const { return m_simulationLodEnabled; }
+    void SetSimulationLodSettings(const SimulationLodSettings& settings) { m_simulationLod.SetSettings(settings); }
+    const SimulationLodSettings& GetSimulationLodSettings() const { return m_simulationLod.GetSettings(); }
+    // Higher = stays on a closer tier (the player's squad, a boss), 0 = always the farthest
+    void SetSimulationImportance(int entityId, float importance);
+    const SimulationLodStats& GetSimulationLodStats() const { return m_simulationLod.GetStats(); }
+
   protected:
     std::string m_name;
     bool m_active = false;
@@ -90,9 +157,73 @@ class Scene {
     UpdateCallback m_updateCallback;
     RenderCallback m_renderCallback;
 
+    // --- Render Recording ---
+    // Below this many entities RenderEntities stays on one thread, waking workers costs more than it saves
+    static constexpr size_t PARALLEL_RENDER_THRESHOLD = 2048;
+    static constexpr size_t RENDER_CHUNK_SIZE = 512;
+
   private:
     void SyncPhysicsToGraphics();
+    std::vector<CollisionEvent> m_collisionEvents;  // Reused every frame
     void RenderEntities(Renderer* renderer);
+    // frustum / occlusion may be null, with neither everything active gets recorded
+    void RecordEntityCommands(Renderer* renderer, const Frustum* frustum, const HiZBuffer* occlusion, size_t begin,
+                              size_t end, FrameVector<RenderCommand>& out);
+    // Resolves (and caches) the mesh an entity draws with, invalid if it has none (yet)
+    MeshHandle MeshForSlot(Renderer* renderer, uint32_t slot);
+
+    // One command buffer per chunk, in the FrameArena and started over every frame
+    std::vector<FrameVector<RenderCommand>> m_commandBuffers;
+
+    // Blend factor between the previous and current physics pose, negative = draw the current pose
+    float m_interpolationAlpha = -1.0f;
+
+    // World-space bounding spheres as structure-of-arrays, rebuilt every frame for the cull pass
+    bool m_frustumCulling = true;
+    bool m_occlusionCulling = true;
+    size_t m_visibleEntityCount = 0;
+    std::atomic<size_t> m_occludedEntityCount{0};  // Chunks add to it in parallel
+    std::vector<float> m_boundsX;
+    std::vector<float> m_boundsY;
+    std::vector<float> m_boundsZ;
+    std::vector<float> m_boundsRadius;
+    std::vector<uint8_t> m_visibility;
+
+    // Screen size = radius * m_lodProjectionScale / distance to m_lodCameraPosition, set once per Render
+    bool m_lodEnabled = true;
+    glm::vec3 m_lodCameraPosition{0.0f};
+    float m_lodProjectionScale = 1.0f;
+
+    // Draw poses + their model matrices, same indexing as the bounds. Each chunk packs its visible
+    // entities to the front of its slice and runs BuildModelMatrices over them.
+    std::vector<glm::vec3> m_posePositions;
+    std::vector<glm::quat> m_poseRotations;
+    std::vector<glm::vec3> m_poseScales;
+    std::vector<glm::mat4> m_modelMatrices;
+
+    // Per bounds index: where the entity's matrix comes from this frame
+    enum PoseState : uint8_t { POSE_CACHED, POSE_DIRTY, POSE_INTERPOLATED };
+    std::vector<uint8_t> m_poseState;
+    std::vector<uint32_t> m_packedCommands;  // Packed pose -> index into the chunk's command buffer
+    std::vector<uint32_t> m_packedSources;   // Packed pose -> bounds index it came from
+    std::atomic<size_t> m_rebuiltMatrixCount{0};
+
+    // Batch meshes live in the renderer's GeometryManager, which frees them on its own cleanup
+    StaticBatcher m_staticBatcher;
+
+    // Shadow casters: entities that haven't moved in a while are registered with the renderer's static
+    // cache, the rest get submitted as dynamic casters every frame
+    void SyncShadowCasters(Renderer* renderer);
+    bool GetShadowCaster(Renderer* renderer, uint32_t slot, MeshHandle& mesh, glm::mat4& model, float& radius);
+    static constexpr uint8_t SHADOW_SETTLE_FRAMES = 8;  // Still for this long = static
+    static constexpr uint8_t SHADOW_STATIC = 0xFF;
+    std::vector<uint8_t> m_shadowState;     // By slot: 0 = not a caster, 1..SETTLE = frames still, or STATIC
+    std::vector<uint32_t> m_movingCasters;  // Slots whose state is 1..SETTLE
+
+    SpatialIndex m_spatialIndex;
+
+    bool m_simulationLodEnabled = false;
+    SimulationLod m_simulationLod;
 };
 
 }  // namespace Blacksite
@@ -0,0 +1,63 @@
+#pragma once
+#include "blacksite/core/MappedFile.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Blacksite {
+
+class Scene;
+struct Collider;
+
+/**
+ * SceneSerializer - Scenes to and from .bscn files
+ * A .bscn is a header plus flat, 16-byte aligned arrays (transforms, render data, physics, colliders, a string
+ * table) in the same order as the entities. Loading maps the file and spawns straight out of the mapping through
+ * EntitySystem::SpawnBatch - nothing gets parsed. Entities come back as plain Entity, behaviour subclasses
+ * aren't recorded. ExportJson writes the same data as text for diffing, there's no JSON loader.
+ */
+class SceneSerializer {
+  public:
+    static bool Save(Scene& scene, const std::string& path);
+    // Only the listed entities, in that order - how WorldStreamer writes its cells
+    static bool Save(Scene& scene, const std::string& path, const std::vector<int>& ids);
+
+    // Replaces the scene's entities (and camera) with the file's
+    static bool Load(Scene& scene, const std::string& path);
+
+    static bool ExportJson(Scene& scene, const std::string& path);
+
+    static constexpr uint32_t FORMAT_VERSION = 2;  // 2: render records name a texture. Version 1 still loads.
+
+  private:
+    static bool SaveEntities(Scene& scene, const std::string& path, const std::vector<int>* ids);
+};
+
+/**
+ * SceneFileReader - One .bscn, opened up front and spawned in as many pieces as you like
+ * Open() and ReadColliders() only read the mapping, so they're fine on a worker thread. Spawn() goes through the
+ * scene's EntitySystem and physics and is main thread only. SceneSerializer::Load is Open + one Spawn of everything.
+ */
+class SceneFileReader {
+  public:
+    // Maps and validates the file, then touches every page so the spawn steps don't fault it in
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+
+    size_t GetEntityCount() const;
+
+    // Spawns entities [first, first + count) into the scene, returns how many were created.
+    // outIds gets their ids appended.
+    size_t Spawn(Scene& scene, size_t first, size_t count, std::vector<int>* outIds = nullptr) const;
+    void ApplyCamera(Scene& scene) const;
+
+    // An entity's colliders and scale, false if it has no physics or no colliders of its own
+    bool ReadColliders(size_t index, std::vector<Collider>& colliders, glm::vec3& scale) const;
+
+  private:
+    MappedFile m_file;
+};
+
+}  // namespace Blacksite
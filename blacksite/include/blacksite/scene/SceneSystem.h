@@ -1,6 +1,7 @@
 #pragma once
 #include "blacksite/core/Logger.h"
 #include "blacksite/scene/Scene.h"
+#include "blacksite/scene/WorldStreamer.h"
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -46,11 +47,35 @@ public:
     using TransitionCallback = std::function<void(Scene* from, Scene* to)>;
     void SetTransitionCallback(TransitionCallback callback) { m_transitionCallback = callback; }
 
+    // --- Async Loading ---
+    // Called every Update while a load runs. progress goes 0..1, the last call has done = true and
+    // says whether the scene made it.
+    using LoadProgressCallback = std::function<void(float progress, bool done, bool success)>;
+
+    // Fills scene 'name' (created if it doesn't exist) from a .bscn and switches to it once it's complete.
+    // A job maps and checks the file and builds the physics shapes, then Update spawns the entities
+    // in slices of at most budgetMs per frame. The active scene keeps updating and rendering the whole time,
+    // so it can be a loading screen. One load at a time, and not into the active scene.
+    // The new scene's bodies are held out of the physics world until it's switched to.
+    bool LoadSceneAsync(const std::string& name, const std::string& path, LoadProgressCallback onProgress = nullptr,
+                        float budgetMs = 4.0f);
+    bool IsLoading() const { return m_pendingLoad != nullptr; }
+    float GetLoadProgress() const;
+    void CancelLoad();  // Drops whatever was spawned so far
+
+    // --- World Streaming ---
+    // Streams cells around the camera into scene 'name' (see WorldStreamer), updated while that scene is active.
+    // One streamed scene at a time, enabling again replaces it.
+    WorldStreamer* EnableWorldStreaming(const std::string& name, const WorldStreamingConfig& config);
+    void DisableWorldStreaming();
+    WorldStreamer* GetWorldStreamer() { return m_streamer.get(); }
+
     // --- Convenience API (delegates to active scene) ---
     int SpawnCube(const glm::vec3& position);
     int SpawnSphere(const glm::vec3& position);
     int SpawnPlane(const glm::vec3& position, const glm::vec3& size);
     EntityHandle GetEntity(int id);
+    EntityEditBatch EditEntities();
     void SetCameraPosition(const glm::vec3& position);
     void SetCameraTarget(const glm::vec3& target);
 
@@ -68,6 +93,16 @@ private:
     // --- Callbacks ---
     TransitionCallback m_transitionCallback;
 
+    // --- Async Loading ---
+    struct PendingLoad;
+    std::unique_ptr<PendingLoad> m_pendingLoad;
+    void StepLoad();
+    void FinishLoad(bool success);
+
+    // --- World Streaming ---
+    std::unique_ptr<WorldStreamer> m_streamer;
+    std::string m_streamingSceneName;
+
     bool m_initialized = false;
 };
 
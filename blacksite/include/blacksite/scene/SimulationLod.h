@@ -0,0 +1,85 @@
+#pragma once
+#include <blacksite/physics/JoltConfig.h>
+#include <Jolt/Physics/Body/BodyID.h>
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+#include "blacksite/core/EntityPool.h"
+
+namespace Blacksite {
+
+class EntitySystem;
+class PhysicsSystem;
+struct Frustum;
+
+struct SimulationLodSettings {
+    static constexpr int MAX_TIERS = 4;
+
+    float tierDistances[MAX_TIERS - 1] = {40.0f, 80.0f, 160.0f};  // Where each tier ends, the last never does
+    int tierIntervals[MAX_TIERS] = {1, 2, 4, 8};                   // Update every Nth frame
+    // Dynamic bodies in the last tier that are out of view go to sleep, and wake once they're either
+    // closer or visible again. They stay frozen until then - unless something bumps into them.
+    bool sleepOffscreenBodies = false;
+};
+
+// What the last Schedule did
+struct SimulationLodStats {
+    uint32_t tierCounts[SimulationLodSettings::MAX_TIERS] = {};  // Alive entities per tier
+    uint32_t updated = 0;                                       // Due this frame
+    uint32_t skipped = 0;
+    uint32_t sleepingBodies = 0;  // Put to sleep by us and still are
+};
+
+/**
+ * SimulationLod - Updates far away entities less often
+ * Every frame each alive entity lands in a tier by its distance to the camera (divided by its importance).
+ * Tier N updates every tierIntervals[N]th frame and gets all the time since its last update as deltaTime.
+ * Which frame is staggered by slot, so a tier's entities are spread evenly over its interval instead
+ * of all coming due at once. The result is an UpdateSchedule for EntitySystem::UpdateEntities.
+ */
+class SimulationLod {
+  public:
+    void SetSettings(const SimulationLodSettings& settings);
+    const SimulationLodSettings& GetSettings() const { return m_settings; }
+
+    // 1 = default, 2 = treated as half as far away, 0 = always the last tier. Resets when the entity goes.
+    void SetImportance(const EntitySystem& entities, int id, float importance);
+
+    // Works out this frame's schedule. physics may be null (no sleeping then). Between physics steps only.
+    void Schedule(EntitySystem& entities, PhysicsSystem* physics, const glm::vec3& cameraPosition,
+                  const Frustum& view, float deltaTime);
+    const UpdateSchedule& GetSchedule() const { return m_schedule; }
+
+    // Wakes whatever we put to sleep and forgets the accumulated time, for turning it off
+    void Reset(EntitySystem& entities, PhysicsSystem* physics);
+    bool HasSleepingBodies() const { return m_sleepingCount > 0; }
+
+    const SimulationLodStats& GetStats() const { return m_stats; }
+
+  private:
+    struct SlotState {
+        int id = -1;  // Who this belongs to, anything else in the slot starts over
+        float importance = 1.0f;
+        float accumulated = 0.0f;
+        bool sleeping = false;  // We put its body to sleep
+    };
+
+    SimulationLodSettings m_settings;
+    SimulationLodStats m_stats;
+    std::vector<SlotState> m_slots;
+    std::vector<uint8_t> m_due;
+    std::vector<float> m_deltaTimes;
+    UpdateSchedule m_schedule;
+    uint64_t m_frame = 0;
+    uint32_t m_sleepingCount = 0;
+
+    // Reused every frame
+    std::vector<JPH::BodyID> m_toSleep;
+    std::vector<JPH::BodyID> m_toWake;
+
+    SlotState& GetSlot(const EntitySystem& entities, uint32_t slot);
+    int GetTier(float distance) const;
+};
+
+}  // namespace Blacksite
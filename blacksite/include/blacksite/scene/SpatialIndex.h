@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace Blacksite {
+
+class EntitySystem;
+struct Frustum;
+
+/**
+ * SpatialIndex - Loose spatial hash over every active entity's bounding sphere
+ * Each entity sits in the one cell its center falls in, queries widen their search by half a cell to catch
+ * the ones that hang over the edge. Entities bigger than that (ground planes and such) go in a short list
+ * that every query checks. Update only touches entities whose transform was marked dirty, or that were
+ * spawned, removed or (de)activated since the last one, so a mostly static level costs a byte scan.
+ *
+ * Radii: the render cache's world radius once an entity has been drawn, a unit-shape estimate before that.
+ * Results are entity ids in no particular order, appended to 'out'.
+ */
+class SpatialIndex {
+  public:
+    explicit SpatialIndex(float cellSize = DEFAULT_CELL_SIZE) : m_cellSize(cellSize) {}
+
+    void Update(EntitySystem& entities);
+    void Clear();
+
+    // Re-buckets everything on the next Update. Around the size of a typical query works best.
+    void SetCellSize(float cellSize);
+    float GetCellSize() const { return m_cellSize; }
+
+    void QuerySphere(const glm::vec3& center, float radius, std::vector<int>& out) const;
+    void QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<int>& out) const;
+    void QueryFrustum(const Frustum& frustum, std::vector<int>& out) const;
+    // Closest surface (center distance minus radius) within maxDistance, -1 if nothing is that close
+    int QueryNearest(const glm::vec3& point, float maxDistance) const;
+
+    size_t GetEntityCount() const { return m_entityCount; }
+    size_t GetCellCount() const { return m_cells.size(); }
+    size_t GetLargeEntityCount() const { return m_large.size(); }
+
+    static constexpr float DEFAULT_CELL_SIZE = 8.0f;
+
+  private:
+    struct Entry {
+        glm::vec3 center{0.0f};
+        float radius = 0.0f;
+        float localRadius = 0.0f;  // Radius at scale 1, learned from the render cache. 0 = not known yet.
+        int id = -1;
+        uint64_t cell = 0;
+        uint32_t position = 0;  // Index in its cell's list (or m_large)
+        bool indexed = false;
+        bool large = false;
+    };
+
+    float m_cellSize;
+    bool m_rebuild = false;
+    size_t m_entityCount = 0;
+    std::vector<Entry> m_entries;  // By entity slot
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;  // Cell key -> slots
+    std::vector<uint32_t> m_large;
+
+    void Insert(uint32_t slot);
+    void Remove(uint32_t slot);
+    glm::ivec3 CellOf(const glm::vec3& position) const;
+    static uint64_t CellKey(const glm::ivec3& cell);
+    static glm::ivec3 CellFromKey(uint64_t key);
+
+    // Calls fn(entry) for everything whose cell could overlap [min, max], plus the large ones
+    template<typename Fn>
+    void ForEachCandidate(const glm::vec3& min, const glm::vec3& max, Fn&& fn) const;
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include "blacksite/core/ComponentStore.h"
+#include "blacksite/graphics/RenderHandles.h"
+
+namespace Blacksite {
+
+class EntitySystem;
+class Renderer;
+struct Frustum;
+
+/**
+ * StaticBatcher - Bakes static entities into a few big world-space meshes
+ * Static entities (physics not dynamic) that share a shader and color and sit in the same grid cell
+ * become one mesh in the GeometryManager, drawn with one call. Baked entities drop out of the
+ * per-entity render path. When a member moves, changes color/shader, goes dynamic, inactive or
+ * away, it leaves the batch (and draws on its own again) and only that batch gets rebuilt.
+ * Entities spawned after a bake aren't picked up until the next bake.
+ */
+class StaticBatcher {
+  public:
+    // Both are deferred to the next Update, which runs where the GL context is
+    void RequestBake() { m_bakeRequested = true; }
+    void RequestClear() { m_clearRequested = true; }
+
+    // Pending bake/clear, then checks every member and rebuilds the batches that changed
+    void Update(Renderer* renderer, EntitySystem& entities);
+
+    // Gives the batch meshes back to the renderer they were built with, for when the scene goes away.
+    // Members aren't released, their entities are expected to be gone too.
+    void Shutdown();
+
+    // Queues the batches that touch the frustum (all of them when frustum is null)
+    void Submit(Renderer* renderer, const Frustum* frustum) const;
+
+    size_t GetBatchCount() const { return m_batches.size(); }
+    size_t GetBatchedEntityCount() const;
+
+    static constexpr float BATCH_CELL_SIZE = 32.0f;  // World units, keeps batches small enough to cull
+
+  private:
+    struct Member {
+        int id;
+        EntityShape::VisualShape shape;  // Shape changes don't move the entity, so check them separately
+    };
+
+    struct Batch {
+        std::string name;  // Mesh name in the GeometryManager
+        ShaderHandle shader;
+        glm::vec3 color{1.0f};
+        glm::ivec3 cell{0};
+        MeshHandle mesh;
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        std::vector<Member> members;
+        bool dirty = false;
+    };
+
+    std::vector<Batch> m_batches;
+    std::vector<Member> m_kept;      // Update's scratch, swapped with a batch's members when it changes
+    Renderer* m_renderer = nullptr;  // Owner of the batch meshes, set by Update
+    bool m_bakeRequested = false;
+    bool m_clearRequested = false;
+    static uint32_t s_nextBatchId;  // Mesh names are global, scenes share one GeometryManager
+
+    void Bake(Renderer* renderer, EntitySystem& entities);
+    void Clear(Renderer* renderer, EntitySystem& entities);
+    bool CanBatch(Renderer* renderer, EntitySystem& entities, uint32_t slot) const;
+    bool IsMemberUnchanged(const Batch& batch, EntitySystem& entities, const Member& member) const;
+    void Release(EntitySystem& entities, int id) const;  // Back to the per-entity path
+    bool BuildMesh(Renderer* renderer, EntitySystem& entities, Batch& batch);
+};
+
+}  // namespace Blacksite
@@ -0,0 +1,92 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Blacksite {
+
+class PhysicsSystem;
+class Scene;
+
+struct WorldStreamingConfig {
+    std::string directory;         // Where BuildCells wrote the cell_<x>_<z>.bscn files
+    float cellSize = 64.0f;        // Has to match what BuildCells was given
+    float prefetchRadius = 160.0f; // Cells closer than this (XZ distance to the cell's edge) get loaded
+    float evictRadius = 224.0f;    // Resident cells stay until they're past this, keeps border cells from thrashing
+    float budgetMs = 2.0f;         // Main thread time per Update for spawning and removing
+    int maxConcurrentLoads = 2;    // Cells being read by jobs at once
+};
+
+/**
+ * WorldStreamer - Pages grid cells of a big world in and out of one Scene around the camera
+ * The world is cut into square XZ cells ahead of time (BuildCells), each its own .bscn. Update looks at the
+ * scene camera, starts the cells inside the prefetch radius nearest first - the file and physics shapes in a
+ * job, the entities in budgeted SpawnBatch slices - and removes cells past the evict radius the same way,
+ * with their bodies going out in the physics system's batched removal. Entities belong to the cell they were
+ * loaded from wherever they wander off to, and nothing is written back: a cell comes back as it is on disk.
+ */
+class WorldStreamer {
+  public:
+    WorldStreamer();
+    ~WorldStreamer();
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    // Finds the cell files in config.directory. Entities already in the scene aren't touched.
+    bool Initialize(Scene* scene, PhysicsSystem* physicsSystem, const WorldStreamingConfig& config);
+    void Shutdown();  // Cancels loads and removes every streamed entity
+    bool IsInitialized() const { return m_scene != nullptr; }
+
+    void Update();                                // Around the scene's camera
+    void Update(const glm::vec3& focusPosition);  // Around anything else
+
+    // Splits the scene's entities into cell files by position. Returns the number of cells written.
+    static size_t BuildCells(Scene& scene, const std::string& directory, float cellSize);
+    static std::string GetCellFileName(int x, int z);
+
+    const WorldStreamingConfig& GetConfig() const { return m_config; }
+    size_t GetCellCount() const { return m_cells.size(); }
+    size_t GetResidentCellCount() const { return m_residentCount; }
+    size_t GetLoadingCellCount() const;
+    size_t GetStreamedEntityCount() const;
+    bool IsCellResident(int x, int z) const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    enum class CellState : uint8_t { Unloaded, Reading, Spawning, Resident, Unloading, Failed };
+
+    struct CellLoad;  // Reader + read job for one cell, in the .cpp to keep Jolt out of this header
+
+    struct Cell {
+        int x = 0;
+        int z = 0;
+        std::string path;
+        CellState state = CellState::Unloaded;
+        std::vector<int> ids;  // Entities this cell spawned
+        size_t removed = 0;    // How far an unload has got through ids
+        std::unique_ptr<CellLoad> load;
+    };
+
+    Scene* m_scene = nullptr;
+    PhysicsSystem* m_physicsSystem = nullptr;
+    WorldStreamingConfig m_config;
+    std::unordered_map<uint64_t, Cell> m_cells;
+    std::vector<std::pair<float, Cell*>> m_work;  // Cells with something to do, by distance. Reused every Update.
+    size_t m_residentCount = 0;
+
+    static uint64_t CellKey(int x, int z) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+    }
+    float DistanceToCell(const Cell& cell, const glm::vec3& position) const;
+
+    void StartLoad(Cell& cell);
+    void StepSpawn(Cell& cell, Clock::time_point deadline);
+    void StepUnload(Cell& cell, Clock::time_point deadline);
+};
+
+}  // namespace Blacksite
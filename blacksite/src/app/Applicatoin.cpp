@@ -29,18 +29,18 @@ int Application::Run() {
         float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
 
-        glfwPollEvents();
+        m_engine.GetFramePacer()->PollEvents();  // Blocks here while idle
         HandleInput();
 
-        // Update game
-        OnUpdate(deltaTime);
-        m_engine.UpdateFrame(deltaTime);
+        // Update game - inside the engine's frame so captures and replays see it
+        m_engine.UpdateFrame(deltaTime, [this](Engine&, float frameDeltaTime) { OnUpdate(frameDeltaTime); });
 
         // FIXED: Render 3D scene first, then UI on top
         m_engine.RenderFrame();  // 3D scene renders to back buffer
         OnRender();              // ImGui renders on top of 3D scene
 
         glfwSwapBuffers(m_engine.GetGLFWWindow());
+        m_engine.GetFramePacer()->EndFrame();
     }
 
     return 0;
@@ -2,6 +2,7 @@
 #include <GL/glew.h>
 #include <chrono>
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
 
 namespace Blacksite {
 
@@ -17,13 +18,26 @@ bool Engine::Initialize(int width, int height, const std::string& title) {
         return false;
     }
 
+    Profiler::Initialize();
+
+    // Before anything that wants worker threads, so they all get this one (JobSystem::Get included)
+    m_jobSystem = std::make_unique<JobSystem>(m_jobThreads);
+    m_frameArena = std::make_unique<FrameArena>(m_frameArenaSize);
+
     // Initialize core systems first
     m_window = std::make_unique<Window>();
-    if (!m_window->Initialize(width, height, title)) {
+    if (!m_window->Initialize(width, height, title, !m_offscreen)) {
         BS_ERROR(LogCategory::CORE, "Failed to initialize window!");
         return false;
     }
 
+    // Offscreen keeps the window's vsync off and never idles
+    m_framePacer = std::make_unique<FramePacer>();
+    if (!m_offscreen) {
+        m_framePacer->Initialize(m_window->GetGLFWindow());
+        m_framePacer->SetConfig(m_framePacingConfig);
+    }
+
     // Initialize shader system EARLY (before renderer)
     m_shaderSystem = std::make_unique<ShaderSystem>();
     if (!m_shaderSystem->Initialize("assets/shaders/")) {
@@ -40,13 +54,15 @@ bool Engine::Initialize(int width, int height, const std::string& title) {
     }
 
     m_physicsSystem = std::make_unique<PhysicsSystem>();
-    if (!m_physicsSystem->Initialize()) {
+    if (!m_physicsSystem->Initialize(m_physicsConfig, m_jobSystem.get())) {
         BS_ERROR(LogCategory::CORE, "Failed to initialize physics system!");
         return false;
     }
 
+    // Chains onto the FramePacer's window callbacks, so it has to come after it
     m_inputSystem = std::make_unique<InputSystem>();
     m_inputSystem->Initialize(m_window->GetGLFWindow());
+    m_frameCapture = std::make_unique<FrameCapture>();
 
     // Initialize SceneSystem
     m_sceneSystem = std::make_unique<SceneSystem>();
@@ -56,11 +72,14 @@ bool Engine::Initialize(int width, int height, const std::string& title) {
         return false;
     }
 
-    BS_INFO(LogCategory::CORE, "Running renderer diagnostics...");
-    m_renderer->DebugOpenGLState();
-    m_renderer->DebugShaderCompilation();
-    m_renderer->DebugGeometry();
-    m_renderer->DebugMatrices();
+    // They dump a lot and draw test geometry, not something a benchmark should start with
+    if (!m_offscreen) {
+        BS_INFO(LogCategory::CORE, "Running renderer diagnostics...");
+        m_renderer->DebugOpenGLState();
+        m_renderer->DebugShaderCompilation();
+        m_renderer->DebugGeometry();
+        m_renderer->DebugMatrices();
+    }
 
     // Log shader system status
     auto availableShaders = m_shaderSystem->GetAvailableShaders();
@@ -91,13 +110,25 @@ int Engine::Run() {
         float deltaTime = std::chrono::duration<float>(currentTime - lastTime).count();
         lastTime = currentTime;
 
-        m_window->PollEvents();
+        // Frame boundary - everything from two frames ago in the arena is gone from here on
+        m_frameArena->BeginFrame();
+
+        m_framePacer->PollEvents();  // Blocks here while idle
+        bool capturing = BeginCaptureFrame(deltaTime);
         HandleInput();
 
-        Update(deltaTime);
+        float stepDelta = deltaTime;
+        int steps = m_framePacer->ConsumeUpdateSteps(deltaTime, stepDelta);
+        for (int step = 0; step < steps; ++step) {
+            Update(stepDelta);
+        }
+        if (capturing) {
+            m_frameCapture->EndFrame();
+        }
         Render();
 
         m_window->SwapBuffers();
+        m_framePacer->EndFrame();
     }
 
     BS_INFO(LogCategory::CORE, "Main loop ended");
@@ -125,12 +156,36 @@ void Engine::HandleInput() {
     }
 }
 
+bool Engine::BeginCaptureFrame(float& deltaTime) {
+    // A replay brings its own input
+    if (!m_frameCapture->IsReplaying()) {
+        m_inputSystem->Update();
+    }
+
+    if (!m_frameCapture->BeginFrame(deltaTime, *m_inputSystem)) {
+        // Replay ran out, carry on live from where it left the scene
+        StopCapture();
+        m_inputSystem->Update();
+        return false;
+    }
+    return m_frameCapture->GetMode() != FrameCapture::Mode::Off;
+}
+
 void Engine::Update(float deltaTime) {
+    BS_PROFILE_SCOPE("Engine::Update");
+
     // Update shader system first (for hot reloading)
     m_shaderSystem->Update();
 
-    // Update physics system
-    m_physicsSystem->Update(deltaTime);
+    // Threaded physics: pick up the step that ran while the last frame rendered. The scene update
+    // syncs it into the transforms, which is what this frame draws.
+    bool threadedPhysics = m_physicsSystem->IsThreadedStepping();
+    if (threadedPhysics) {
+        m_physicsSystem->WaitForStep();
+    } else {
+        // Update physics system - fixed step by default, it takes as many steps as the frame time covers
+        m_physicsSystem->Update(deltaTime);
+    }
 
     // Update scene system (which updates the active scene)
     m_sceneSystem->Update(deltaTime);
@@ -139,9 +194,39 @@ void Engine::Update(float deltaTime) {
     if (m_updateCallback) {
         m_updateCallback(*this, deltaTime);
     }
+
+    TrackActivity();
+
+    // Game code is done with the bodies, next step runs alongside Render
+    if (threadedPhysics) {
+        m_physicsSystem->BeginStep(deltaTime);
+    }
+}
+
+void Engine::TrackActivity() {
+    Scene* scene = GetActiveScene();
+    uint64_t version = scene ? scene->GetEntitySystem()->GetVersion() : 0;
+    glm::vec3 cameraPosition = scene ? scene->GetCameraPosition() : glm::vec3(0.0f);
+    glm::vec3 cameraTarget = scene ? scene->GetCameraTarget() : glm::vec3(0.0f);
+
+    // Awake bodies move every step even though nothing else changes. A capture needs every frame.
+    bool changed = scene != m_lastActiveScene || version != m_lastEntityVersion ||
+                   cameraPosition != m_lastCameraPosition || cameraTarget != m_lastCameraTarget ||
+                   m_physicsSystem->GetCapacityReport().numActiveBodies > 0 ||
+                   m_frameCapture->GetMode() != FrameCapture::Mode::Off;
+    if (changed) {
+        m_framePacer->MarkActivity();
+    }
+
+    m_lastActiveScene = scene;
+    m_lastEntityVersion = version;
+    m_lastCameraPosition = cameraPosition;
+    m_lastCameraTarget = cameraTarget;
 }
 
 void Engine::Render() {
+    BS_PROFILE_SCOPE("Engine::Render");
+
     if (!m_renderer || !m_sceneSystem) {
         BS_ERROR(LogCategory::RENDERER, "Missing renderer or scene system!");
         return;
@@ -157,6 +242,15 @@ void Engine::Shutdown() {
 
     BS_INFO(LogCategory::CORE, "Shutting down Blacksite Engine...");
 
+    // Scenes remove their bodies on the way out, so no step can still be running
+    if (m_physicsSystem) {
+        m_physicsSystem->WaitForStep();
+    }
+
+    // Finishes the file while the scene it points at is still around
+    m_frameCapture.reset();
+    m_framePacer.reset();
+
     // Shutdown systems in reverse order
     m_sceneSystem.reset();
     m_inputSystem.reset();
@@ -164,6 +258,8 @@ void Engine::Shutdown() {
     m_physicsSystem.reset();
     m_shaderSystem.reset();  // Add shader system shutdown
     m_window.reset();
+    m_frameArena.reset();
+    m_jobSystem.reset();  // Last, physics and scenes queue work on it until they're gone
 
     m_running = false;
     m_initialized = false;
@@ -204,6 +300,12 @@ int Engine::SpawnPlane(const glm::vec3& position, const glm::vec3& size, const s
     return activeScene ? activeScene->SpawnPlane(position, size, shader, color) : -1;
 }
 
+int Engine::SpawnMesh(const std::string& mesh, const glm::vec3& position, const std::string& shader,
+                      const glm::vec3& color) {
+    Scene* activeScene = GetActiveScene();
+    return activeScene ? activeScene->SpawnMesh(mesh, position, shader, color) : -1;
+}
+
 int Engine::SpawnEntity(Entity::VisualShape shape, const glm::vec3& position, const std::string& shader,
                         const glm::vec3& color) {
     Scene* activeScene = GetActiveScene();
@@ -214,6 +316,10 @@ EntityHandle Engine::GetEntity(int id) {
     return m_sceneSystem ? m_sceneSystem->GetEntity(id) : EntityHandle(nullptr, nullptr, -1);
 }
 
+EntityEditBatch Engine::EditEntities() {
+    return m_sceneSystem ? m_sceneSystem->EditEntities() : EntityEditBatch(nullptr, nullptr);
+}
+
 // --- Convenience Camera API (delegates to SceneSystem) ---
 void Engine::SetCameraPosition(const glm::vec3& position) {
     if (m_sceneSystem)
@@ -235,15 +341,65 @@ glm::vec3 Engine::GetCameraTarget() const {
     return activeScene ? activeScene->GetCameraTarget() : glm::vec3(0.0f);
 }
 
-void Engine::UpdateFrame(float deltaTime) {
+std::vector<GpuZoneTiming> Engine::GetGpuTimings() const {
+    return m_renderer ? m_renderer->GetGpuTimings() : std::vector<GpuZoneTiming>{};
+}
+
+void Engine::SetGpuProfilingEnabled(bool enabled) {
+    if (m_renderer) {
+        m_renderer->GetGpuProfiler().SetEnabled(enabled);
+    }
+}
+
+bool Engine::StartCapture(const std::string& path) {
+    Scene* scene = GetActiveScene();
+    if (!m_initialized || !scene) {
+        BS_ERROR(LogCategory::CORE, "StartCapture needs an initialized engine with an active scene");
+        return false;
+    }
+    return m_frameCapture->StartRecording(path, *scene);
+}
+
+bool Engine::StartReplay(const std::string& path, bool standalone) {
+    Scene* scene = GetActiveScene();
+    if (!m_initialized || !scene) {
+        BS_ERROR(LogCategory::CORE, "StartReplay needs an initialized engine with an active scene");
+        return false;
+    }
+    return m_frameCapture->StartReplay(path, *scene, standalone);
+}
+
+void Engine::SetFramePacing(const FramePacingConfig& config) {
+    m_framePacingConfig = config;
+    if (m_framePacer && !m_offscreen) {
+        m_framePacer->SetConfig(config);
+    }
+}
+
+void Engine::StopCapture() {
+    if (m_frameCapture) {
+        m_frameCapture->Stop();
+    }
+}
+
+void Engine::UpdateFrame(float deltaTime, const UpdateCallback& gameUpdate) {
     if (!m_initialized)
         return;
 
-    if (m_inputSystem) {
-        m_inputSystem->Update();
-    }
+    m_frameArena->BeginFrame();
 
-    Update(deltaTime);
+    bool capturing = BeginCaptureFrame(deltaTime);
+    float stepDelta = deltaTime;
+    int steps = m_framePacer->ConsumeUpdateSteps(deltaTime, stepDelta);
+    for (int step = 0; step < steps; ++step) {
+        if (gameUpdate) {
+            gameUpdate(*this, stepDelta);
+        }
+        Update(stepDelta);
+    }
+    if (capturing) {
+        m_frameCapture->EndFrame();
+    }
 }
 
 void Engine::RenderFrame() {
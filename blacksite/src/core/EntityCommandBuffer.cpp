@@ -0,0 +1,73 @@
+#include "blacksite/core/EntityCommandBuffer.h"
+#include "blacksite/core/EntitySystem.h"
+
+namespace Blacksite {
+
+void EntityCommandBuffer::Spawn(EntityShape::VisualShape shape, const glm::vec3& position, const std::string& shader,
+                                const glm::vec3& color) {
+    Defer([shape, position, shader, color](EntitySystem& entities) {
+        entities.SpawnEntity(shape, position, shader, color);
+    });
+}
+
+void EntityCommandBuffer::Push(int id, const glm::vec3& force) {
+    Defer([id, force](EntitySystem& entities) {
+        if (entities.IsAlive(id))
+            entities.GetEntityHandle(id).Push(force);
+    });
+}
+
+void EntityCommandBuffer::Impulse(int id, const glm::vec3& impulse) {
+    Defer([id, impulse](EntitySystem& entities) {
+        if (entities.IsAlive(id))
+            entities.GetEntityHandle(id).Impulse(impulse);
+    });
+}
+
+void EntityCommandBuffer::SetVelocity(int id, const glm::vec3& velocity) {
+    Defer([id, velocity](EntitySystem& entities) {
+        if (entities.IsAlive(id))
+            entities.GetEntityHandle(id).SetVelocity(velocity);
+    });
+}
+
+void EntityCommandBuffer::SetActive(int id, bool active) {
+    Defer([id, active](EntitySystem& entities) {
+        if (entities.IsAlive(id))
+            entities.GetEntityHandle(id).SetActive(active);
+    });
+}
+
+void EntityCommandBuffer::Apply(EntitySystem& entities) {
+    // Swapped out first, a command that queues more must not grow the vector we're walking
+    std::vector<Command> commands;
+    std::vector<int> removals;
+    commands.swap(m_commands);
+    removals.swap(m_removals);
+
+    for (Command& command : commands) {
+        command(entities);
+    }
+    for (int id : removals) {
+        if (entities.IsAlive(id)) {
+            entities.RemoveEntity(id);
+        }
+    }
+
+    // Hand the capacity back so the next frame doesn't reallocate
+    if (m_commands.empty()) {
+        commands.clear();
+        m_commands.swap(commands);
+    }
+    if (m_removals.empty()) {
+        removals.clear();
+        m_removals.swap(removals);
+    }
+}
+
+void EntityCommandBuffer::Clear() {
+    m_commands.clear();
+    m_removals.clear();
+}
+
+}  // namespace Blacksite
@@ -2,7 +2,6 @@
 #include "blacksite/core/EntitySystem.h"
 #include "blacksite/physics/PhysicsSystem.h"
 #include "blacksite/core/Logger.h"
-#include <Jolt/Physics/Collision/Shape/ScaledShape.h>
 
 namespace Blacksite {
 
@@ -12,9 +11,9 @@ EntityHandle::EntityHandle(EntitySystem* entitySystem, PhysicsSystem* physicsSys
 
 EntityHandle& EntityHandle::At(const glm::vec3& position) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        entity->transform.position = position;
-        if (entity->hasPhysics && m_physicsSystem) {
-            m_physicsSystem->SetBodyPosition(entity->physicsBody, position);
+        entity->GetTransform().position = position;
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->SetBodyPosition(entity->GetPhysics().body, position);
         }
     } else {
         BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to move non-existent entity %d", m_id);
@@ -24,8 +23,22 @@ EntityHandle& EntityHandle::At(const glm::vec3& position) {
 
 EntityHandle& EntityHandle::Rotate(const glm::vec3& rotation) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        entity->transform.rotation = rotation;
-        // TODO: Sync rotation with physics system
+        entity->GetTransform().SetEulerRotation(rotation);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->SetBodyRotation(entity->GetPhysics().body, entity->GetTransform().rotation);
+        }
+    } else {
+        BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to rotate non-existent entity %d", m_id);
+    }
+    return *this;
+}
+
+EntityHandle& EntityHandle::Rotate(const glm::quat& rotation) {
+    if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
+        entity->GetTransform().rotation = rotation;
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->SetBodyRotation(entity->GetPhysics().body, rotation);
+        }
     } else {
         BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to rotate non-existent entity %d", m_id);
     }
@@ -34,13 +47,13 @@ EntityHandle& EntityHandle::Rotate(const glm::vec3& rotation) {
 
 EntityHandle& EntityHandle::Scale(const glm::vec3& scale) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        glm::vec3 oldScale = entity->transform.scale;
+        glm::vec3 oldScale = entity->GetTransform().scale;
 
         // Update visual scale
-        entity->transform.scale = scale;
+        entity->GetTransform().scale = scale;
 
         // If physics body exists and scale changed, recreate it with new scale
-        if (entity->hasPhysics && m_physicsSystem && oldScale != scale) {
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem && oldScale != scale) {
                 RecreatePhysicsBodyWithScale(*entity, scale);
         }
 
@@ -60,59 +73,129 @@ EntityHandle& EntityHandle::Scale(float uniformScale) {
     return Scale(glm::vec3(uniformScale));
 }
 
-void EntityHandle::RecreatePhysicsBodyWithScale(Entity& entity, const glm::vec3& scale) {
-    if (!entity.hasPhysics || !m_physicsSystem) {
-        BS_DEBUG_F(LogCategory::PHYSICS, "Entity %d has no physics or physics system", entity.id);
+EntityEdit::EntityEdit(EntitySystem* entitySystem, PhysicsSystem* physicsSystem, int id, EntityEditBatch* batch)
+    : m_entitySystem(entitySystem), m_physicsSystem(physicsSystem), m_batch(batch), m_id(id) {
+}
+
+EntityEdit::EntityEdit(EntityEdit&& other) noexcept
+    : m_entitySystem(other.m_entitySystem),
+      m_physicsSystem(other.m_physicsSystem),
+      m_batch(other.m_batch),
+      m_id(other.m_id),
+      m_changes(other.m_changes),
+      m_position(other.m_position),
+      m_rotation(other.m_rotation),
+      m_scale(other.m_scale) {
+    other.m_changes = 0;
+}
+
+EntityEdit& EntityEdit::At(const glm::vec3& position) {
+    m_position = position;
+    m_changes |= POSITION;
+    return *this;
+}
+
+EntityEdit& EntityEdit::Rotate(const glm::vec3& rotation) {
+    return Rotate(EulerToQuat(rotation));
+}
+
+EntityEdit& EntityEdit::Rotate(const glm::quat& rotation) {
+    m_rotation = rotation;
+    m_changes |= ROTATION;
+    return *this;
+}
+
+EntityEdit& EntityEdit::Scale(const glm::vec3& scale) {
+    m_scale = scale;
+    m_changes |= SCALE;
+    return *this;
+}
+
+void EntityEdit::Commit() {
+    if (m_changes == 0) {
         return;
     }
+    uint8_t changes = m_changes;
+    m_changes = 0;
 
-    if (entity.physicsBody.IsInvalid()) {
-        BS_ERROR_F(LogCategory::PHYSICS, "Entity %d has invalid physics body", entity.id);
+    Entity* entity = m_entitySystem ? m_entitySystem->GetEntityPtr(m_id) : nullptr;
+    if (!entity) {
+        BS_ERROR_F(LogCategory::CORE, "EntityEdit: Tried to edit non-existent entity %d", m_id);
         return;
     }
 
-    BS_DEBUG_F(LogCategory::PHYSICS, "Scaling physics body for entity %d to (%.2f, %.2f, %.2f)",
-               entity.id, scale.x, scale.y, scale.z);
-
-    // Get the physics system
-    JPH::PhysicsSystem* joltSystem = m_physicsSystem->GetPhysicsSystem();
-    JPH::BodyInterface& bodyInterface = joltSystem->GetBodyInterface();
+    Transform& transform = entity->GetTransform();
+    if (changes & POSITION) {
+        transform.position = m_position;
+    }
+    if (changes & ROTATION) {
+        transform.rotation = m_rotation;
+    }
+    if (changes & SCALE) {
+        transform.scale = m_scale;
+    }
 
-    // Lock the body for modification
-    JPH::BodyLockWrite lock(joltSystem->GetBodyLockInterface(), entity.physicsBody);
-    if (!lock.Succeeded()) {
-        BS_ERROR_F(LogCategory::PHYSICS, "Failed to lock body for entity %d", entity.id);
+    const PhysicsComponent& physics = entity->GetPhysics();
+    if (!physics.hasPhysics || !m_physicsSystem) {
         return;
     }
 
-    JPH::Body& body = lock.GetBody();
+    // Cached shape for the new scale, then the pose - Jolt keeps the body position across SetShape
+    if (changes & SCALE) {
+        m_physicsSystem->SetBodyScale(*entity, transform.scale);
+    }
+    if (changes & (POSITION | ROTATION)) {
+        if (m_batch) {
+            m_batch->m_pending.push_back(m_id);
+        } else {
+            m_physicsSystem->SetBodyPositionAndRotation(physics.body, transform.position, transform.rotation);
+        }
+    }
+}
 
-    // Get the current shape
-    JPH::RefConst<JPH::Shape> currentShape = body.GetShape();
+EntityEditBatch::EntityEditBatch(EntitySystem* entitySystem, PhysicsSystem* physicsSystem)
+    : m_entitySystem(entitySystem), m_physicsSystem(physicsSystem) {
+}
 
-    // If it's already a ScaledShape, get the inner shape
-    JPH::RefConst<JPH::Shape> baseShape;
-    if (currentShape->GetSubType() == JPH::EShapeSubType::Scaled) {
-        const JPH::ScaledShape* scaledShape = static_cast<const JPH::ScaledShape*>(currentShape.GetPtr());
-        baseShape = scaledShape->GetInnerShape();
-    } else {
-        baseShape = currentShape;
+void EntityEditBatch::Commit() {
+    if (m_pending.empty()) {
+        return;
     }
 
-    // Create new scaled shape
-    JPH::Vec3 joltScale(scale.x, scale.y, scale.z);
-    JPH::RefConst<JPH::Shape> newScaledShape = new JPH::ScaledShape(baseShape, joltScale);
+    // Anything removed since its edit just drops out
+    m_entities.clear();
+    for (int id : m_pending) {
+        if (Entity* entity = m_entitySystem->GetEntityPtr(id)) {
+            m_entities.push_back(entity);
+        }
+    }
+    m_pending.clear();
 
-    // Set the new shape (this is the key - using the non-locking interface since we have the lock)
-    joltSystem->GetBodyInterfaceNoLock().SetShape(entity.physicsBody, newScaledShape, true, JPH::EActivation::Activate);
+    if (m_physicsSystem) {
+        m_physicsSystem->SetBodyTransforms(m_entities);
+    }
+}
 
-    BS_DEBUG_F(LogCategory::PHYSICS, "Successfully scaled physics body for entity %d using ScaledShape", entity.id);
+void EntityHandle::RecreatePhysicsBodyWithScale(Entity& entity, const glm::vec3& scale) {
+    if (!entity.GetPhysics().hasPhysics || !m_physicsSystem) {
+        BS_DEBUG_F(LogCategory::PHYSICS, "Entity %d has no physics or physics system", entity.id);
+        return;
+    }
+
+    if (entity.GetPhysics().body.IsInvalid()) {
+        BS_ERROR_F(LogCategory::PHYSICS, "Entity %d has invalid physics body", entity.id);
+        return;
+    }
+
+    // The physics system wraps the cached unit-scale shape in a ScaledShape, and reuses that too,
+    // so scaling back and forth doesn't build anything new
+    m_physicsSystem->SetBodyScale(entity, scale);
 }
 
 
 EntityHandle& EntityHandle::Color(float r, float g, float b) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        entity->color = {r, g, b};
+        entity->GetRender().color = {r, g, b};
     } else {
         BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to color non-existent entity %d", m_id);
     }
@@ -121,7 +204,7 @@ EntityHandle& EntityHandle::Color(float r, float g, float b) {
 
 EntityHandle& EntityHandle::Color(const glm::vec3& color) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        entity->color = color;
+        entity->GetRender().color = color;
     } else {
         BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to color non-existent entity %d", m_id);
     }
@@ -131,9 +214,8 @@ EntityHandle& EntityHandle::Color(const glm::vec3& color) {
 glm::vec3 EntityHandle::GetPosition() const {
     if (!IsValid()) return glm::vec3(0.0f);
 
-    const auto& entities = m_entitySystem->GetEntities();
-    if (m_id >= 0 && m_id < static_cast<int>(entities.size())) {
-        return entities[m_id].transform.position;
+    if (const Entity* entity = m_entitySystem->GetEntityPtr(m_id)) {
+        return entity->GetTransform().position;
     }
     return glm::vec3(0.0f);
 }
@@ -141,9 +223,8 @@ glm::vec3 EntityHandle::GetPosition() const {
 glm::vec3 EntityHandle::GetRotation() const {
     if (!IsValid()) return glm::vec3(0.0f);
 
-    const auto& entities = m_entitySystem->GetEntities();
-    if (m_id >= 0 && m_id < static_cast<int>(entities.size())) {
-        return entities[m_id].transform.rotation;
+    if (const Entity* entity = m_entitySystem->GetEntityPtr(m_id)) {
+        return entity->GetTransform().GetEulerRotation();
     }
     return glm::vec3(0.0f);
 }
@@ -151,9 +232,8 @@ glm::vec3 EntityHandle::GetRotation() const {
 glm::vec3 EntityHandle::GetScale() const {
     if (!IsValid()) return glm::vec3(1.0f);
 
-    const auto& entities = m_entitySystem->GetEntities();
-    if (m_id >= 0 && m_id < static_cast<int>(entities.size())) {
-        return entities[m_id].transform.scale;
+    if (const Entity* entity = m_entitySystem->GetEntityPtr(m_id)) {
+        return entity->GetTransform().scale;
     }
     return glm::vec3(1.0f);
 }
@@ -162,8 +242,8 @@ glm::vec3 EntityHandle::GetVelocity() const {
     if (!IsValid()) return glm::vec3(0.0f);
 
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            return m_physicsSystem->GetVelocity(entity->physicsBody);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            return m_physicsSystem->GetVelocity(entity->GetPhysics().body);
         }
     }
     return glm::vec3(0.0f);
@@ -173,8 +253,8 @@ glm::vec3 EntityHandle::GetAngularVelocity() const {
     if (!IsValid()) return glm::vec3(0.0f);
 
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            return m_physicsSystem->GetAngularVelocity(entity->physicsBody);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            return m_physicsSystem->GetAngularVelocity(entity->GetPhysics().body);
         }
     }
     return glm::vec3(0.0f);
@@ -182,9 +262,8 @@ glm::vec3 EntityHandle::GetAngularVelocity() const {
 glm::vec3 EntityHandle::GetColor() const {
     if (!IsValid()) return glm::vec3(1.0f);
 
-    const auto& entities = m_entitySystem->GetEntities();
-    if (m_id >= 0 && m_id < static_cast<int>(entities.size())) {
-        return entities[m_id].color;
+    if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
+        return entity->GetRender().color;
     }
     return glm::vec3(1.0f, 1.0f, 1.0f);
 }
@@ -192,20 +271,20 @@ glm::vec3 EntityHandle::GetColor() const {
 bool EntityHandle::IsActive() const {
     if (!IsValid()) return false;
 
-    const auto& entities = m_entitySystem->GetEntities();
-    if (m_id >= 0 && m_id < static_cast<int>(entities.size())) {
-        return entities[m_id].active;
+    if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
+        return entity->IsActive();
     }
     return false;
 }
 
 bool EntityHandle::IsValid() const {
-    return m_id >= 0 && m_entitySystem != nullptr && m_physicsSystem != nullptr;
+    // IsAlive does the generation check, so handles to removed entities go invalid even after slot reuse
+    return m_entitySystem != nullptr && m_physicsSystem != nullptr && m_entitySystem->IsAlive(m_id);
 }
 
 EntityHandle& EntityHandle::SetActive(bool active) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        entity->active = active;
+        entity->SetActive(active);  // Marks the system changed itself
         BS_DEBUG_F(LogCategory::CORE, "EntityHandle: Entity %d is now %s", m_id, (active ? "active" : "inactive"));
     } else {
         BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to set state of non-existent entity %d", m_id);
@@ -214,8 +293,8 @@ EntityHandle& EntityHandle::SetActive(bool active) {
 }
 
 void EntityHandle::Destroy() {
-    if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        entity->active = false;
+    if (m_entitySystem->IsAlive(m_id)) {
+        m_entitySystem->RemoveEntity(m_id);
         BS_DEBUG_F(LogCategory::CORE, "EntityHandle: Entity %d destroyed", m_id);
     } else {
         BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to destroy non-existent entity %d", m_id);
@@ -225,8 +304,8 @@ void EntityHandle::Destroy() {
 // Physics operations
 EntityHandle& EntityHandle::Push(const glm::vec3& force) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            m_physicsSystem->AddForce(entity->physicsBody, force);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->AddForce(entity->GetPhysics().body, force);
         } else {
             BS_ERROR_F(LogCategory::PHYSICS, "EntityHandle: Entity %d has no physics body", m_id);
         }
@@ -236,8 +315,8 @@ EntityHandle& EntityHandle::Push(const glm::vec3& force) {
 
 EntityHandle& EntityHandle::Impulse(const glm::vec3& impulse) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            m_physicsSystem->AddImpulse(entity->physicsBody, impulse);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->AddImpulse(entity->GetPhysics().body, impulse);
         } else {
             BS_ERROR_F(LogCategory::PHYSICS, "EntityHandle: Entity %d has no physics body", m_id);
         }
@@ -247,8 +326,8 @@ EntityHandle& EntityHandle::Impulse(const glm::vec3& impulse) {
 
 EntityHandle& EntityHandle::SetVelocity(const glm::vec3& velocity) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            m_physicsSystem->SetVelocity(entity->physicsBody, velocity);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->SetVelocity(entity->GetPhysics().body, velocity);
         } else {
             BS_ERROR_F(LogCategory::PHYSICS, "EntityHandle: Entity %d has no physics body", m_id);
         }
@@ -258,8 +337,8 @@ EntityHandle& EntityHandle::SetVelocity(const glm::vec3& velocity) {
 
 EntityHandle& EntityHandle::SetAngularVelocity(const glm::vec3& angularVel) {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            m_physicsSystem->SetAngularVelocity(entity->physicsBody, angularVel);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->SetAngularVelocity(entity->GetPhysics().body, angularVel);
         } else {
             BS_ERROR_F(LogCategory::PHYSICS, "EntityHandle: Entity %d has no physics body", m_id);
         }
@@ -269,8 +348,8 @@ EntityHandle& EntityHandle::SetAngularVelocity(const glm::vec3& angularVel) {
 
 EntityHandle& EntityHandle::MakeStatic() {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            m_physicsSystem->MakeBodyStatic(entity->physicsBody);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->MakeBodyStatic(entity->GetPhysics().body);
             BS_DEBUG_F(LogCategory::PHYSICS, "EntityHandle: Entity %d is now static", m_id);
         }
     }
@@ -279,12 +358,24 @@ EntityHandle& EntityHandle::MakeStatic() {
 
 EntityHandle& EntityHandle::MakeDynamic() {
     if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
-        if (entity->hasPhysics && m_physicsSystem) {
-            m_physicsSystem->MakeBodyDynamic(entity->physicsBody);
+        if (entity->GetPhysics().hasPhysics && m_physicsSystem) {
+            m_physicsSystem->MakeBodyDynamic(entity->GetPhysics().body);
             BS_DEBUG_F(LogCategory::PHYSICS, "EntityHandle: Entity %d is now dynamic", m_id);
         }
     }
     return *this;
 }
 
+EntityHandle& EntityHandle::SetLayer(PhysicsLayer layer) {
+    if (auto* entity = m_entitySystem->GetEntityPtr(m_id)) {
+        if (m_physicsSystem) {
+            // Fine before the body exists too, the layer gets picked up when it's created
+            m_physicsSystem->SetBodyLayer(*entity, layer);
+        }
+    } else {
+        BS_ERROR_F(LogCategory::CORE, "EntityHandle: Tried to set layer of non-existent entity %d", m_id);
+    }
+    return *this;
+}
+
 }
@@ -1,12 +1,48 @@
 #include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/FrameCapture.h"
+#include "blacksite/core/JobSystem.h"
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+#include "blacksite/core/Profiler.h"
 #include "blacksite/physics/PhysicsSystem.h"
 
+#include <algorithm>
+
 namespace Blacksite {
 
+namespace {
+
+// Set while a thread runs a parallel update chunk, so Entity::Commands() finds that chunk's buffer
+thread_local EntityCommandBuffer* t_chunkCommands = nullptr;
+thread_local const EntitySystem* t_chunkOwner = nullptr;
+
+}  // namespace
+
+EntityCommandBuffer& Entity::Commands() {
+    return m_system->GetCommandBuffer();
+}
+
+void Entity::SetActive(bool active) {
+    if (!m_store) {
+        m_stagedActive = active;
+        return;
+    }
+    if (m_store->IsActive(m_index) == active) {
+        return;
+    }
+    m_store->SetActive(m_index, active);
+
+    // The hierarchy shows the active state too, so it has to rebuild
+    if (m_system) {
+        m_system->MarkChanged();
+    }
+}
+
 EntitySystem::EntitySystem() = default;
 
-EntitySystem::~EntitySystem() = default;
+EntitySystem::~EntitySystem() {
+    MemoryTracker::Adjust(MemoryTag::Entities, -static_cast<int64_t>(m_trackedBytes));
+}
 
 // Template spawn method implementation (moved to header as template)
 // The Spawn<T>() method is now in the header file
@@ -33,32 +69,29 @@ int EntitySystem::SpawnCube(const glm::vec3& position, const std::string& shader
 
     // Create basic entity (not using template system for backward compatibility)
     Entity entity(Entity::CUBE, shader);
-    entity.transform.position = position;
-    entity.transform.scale = glm::vec3(1.0f);
-    entity.color = color;
-    entity.id = m_nextEntityId;
-    entity.name = "Cube_" + std::to_string(m_nextEntityId);
-
-    // Add entity to vector FIRST
-    int id = m_nextEntityId++;
-
-    // Ensure vector is large enough
-    if (id >= static_cast<int>(m_entities.size())) {
-        m_entities.resize(id + 1);
+    entity.GetTransform().position = position;
+    entity.GetTransform().scale = glm::vec3(1.0f);
+    entity.GetRender().color = color;
+    entity.name = "Cube_" + std::to_string(m_spawnCounter);
+
+    // Add entity to storage FIRST, the physics body is created from the stored copy
+    Entity* stored = StoreEntity(entity);
+    if (!stored) {
+        return -1;
     }
 
-    m_entities[id] = entity;
-
-    // NOW create physics body (entity is in vector)
-    Entity& storedEntity = m_entities[id];
-    storedEntity.physicsBody = m_physicsSystem->CreatePhysicsBody(storedEntity);
-    storedEntity.hasPhysics = true;
+    Entity& storedEntity = *stored;
+    storedEntity.GetPhysics().body = m_physicsSystem->CreatePhysicsBody(storedEntity);
+    storedEntity.GetPhysics().hasPhysics = true;
 
     // Call OnSpawn for any custom initialization
     storedEntity.OnSpawn();
 
     BS_INFO_F(LogCategory::PHYSICS, "EntitySystem: Spawned cube with %zu colliders", storedEntity.colliders.size());
-    return id;
+    if (m_capture) {
+        m_capture->OnSpawn(Entity::CUBE, storedEntity.id, position, glm::vec3(1.0f), shader, color);
+    }
+    return storedEntity.id;
 }
 
 int EntitySystem::SpawnSphere(const glm::vec3& position, const std::string& shader, const glm::vec3& color) {
@@ -68,28 +101,27 @@ int EntitySystem::SpawnSphere(const glm::vec3& position, const std::string& shad
     }
 
     Entity entity(Entity::SPHERE, shader);
-    entity.transform.position = position;
-    entity.transform.scale = glm::vec3(1.0f);
-    entity.color = color;
-    entity.id = m_nextEntityId;
-    entity.name = "Sphere_" + std::to_string(m_nextEntityId);
+    entity.GetTransform().position = position;
+    entity.GetTransform().scale = glm::vec3(1.0f);
+    entity.GetRender().color = color;
+    entity.name = "Sphere_" + std::to_string(m_spawnCounter);
 
-    int id = m_nextEntityId++;
-
-    if (id >= static_cast<int>(m_entities.size())) {
-        m_entities.resize(id + 1);
+    Entity* stored = StoreEntity(entity);
+    if (!stored) {
+        return -1;
     }
 
-    m_entities[id] = entity;
-
-    Entity& storedEntity = m_entities[id];
-    storedEntity.physicsBody = m_physicsSystem->CreatePhysicsBody(storedEntity);
-    storedEntity.hasPhysics = true;
+    Entity& storedEntity = *stored;
+    storedEntity.GetPhysics().body = m_physicsSystem->CreatePhysicsBody(storedEntity);
+    storedEntity.GetPhysics().hasPhysics = true;
 
     storedEntity.OnSpawn();
 
     BS_INFO_F(LogCategory::PHYSICS, "EntitySystem: Spawned sphere with %zu colliders", storedEntity.colliders.size());
-    return id;
+    if (m_capture) {
+        m_capture->OnSpawn(Entity::SPHERE, storedEntity.id, position, glm::vec3(1.0f), shader, color);
+    }
+    return storedEntity.id;
 }
 
 int EntitySystem::SpawnPlane(const glm::vec3& position, const glm::vec3& size, const std::string& shader, const glm::vec3& color) {
@@ -99,29 +131,258 @@ int EntitySystem::SpawnPlane(const glm::vec3& position, const glm::vec3& size, c
     }
 
     Entity entity(Entity::PLANE, shader);
-    entity.transform.position = position;
-    entity.transform.scale = size;
-    entity.color = color;
-    entity.id = m_nextEntityId;
-    entity.name = "Plane_" + std::to_string(m_nextEntityId);
-    entity.isDynamic = false;
+    entity.GetTransform().position = position;
+    entity.GetTransform().scale = size;
+    entity.GetRender().color = color;
+    entity.name = "Plane_" + std::to_string(m_spawnCounter);
+    entity.GetPhysics().isDynamic = false;
+
+    Entity* stored = StoreEntity(entity);
+    if (!stored) {
+        return -1;
+    }
+
+    Entity& storedEntity = *stored;
+    storedEntity.GetPhysics().body = m_physicsSystem->CreatePhysicsBody(storedEntity);
+    storedEntity.GetPhysics().hasPhysics = true;
 
-    int id = m_nextEntityId++;
+    storedEntity.OnSpawn();
 
-    if (id >= static_cast<int>(m_entities.size())) {
-        m_entities.resize(id + 1);
+    BS_INFO_F(LogCategory::PHYSICS, "EntitySystem: Spawned plane with %zu colliders", storedEntity.colliders.size());
+    if (m_capture) {
+        m_capture->OnSpawn(Entity::PLANE, storedEntity.id, position, size, shader, color);
     }
+    return storedEntity.id;
+}
 
-    m_entities[id] = entity;
+int EntitySystem::SpawnMesh(const std::string& mesh, const glm::vec3& position, const std::string& shader,
+                            const glm::vec3& color) {
+    if (!m_physicsSystem) {
+        BS_ERROR(LogCategory::CORE, "EntitySystem: No physics system available!");
+        return -1;
+    }
 
-    Entity& storedEntity = m_entities[id];
-    storedEntity.physicsBody = m_physicsSystem->CreatePhysicsBody(storedEntity);
-    storedEntity.hasPhysics = true;
+    // The mesh handle is looked up at render time like the shader, so the mesh can be loaded later
+    Entity entity(Entity::MESH, shader);
+    entity.mesh = mesh;
+    entity.GetTransform().position = position;
+    entity.GetTransform().scale = glm::vec3(1.0f);
+    entity.GetRender().color = color;
+    entity.name = mesh + "_" + std::to_string(m_spawnCounter);
+    entity.GetPhysics().isDynamic = false;
+
+    Entity* stored = StoreEntity(entity);
+    if (!stored) {
+        return -1;
+    }
+
+    Entity& storedEntity = *stored;
+    storedEntity.GetPhysics().body = m_physicsSystem->CreatePhysicsBody(storedEntity);
+    storedEntity.GetPhysics().hasPhysics = true;
 
     storedEntity.OnSpawn();
 
-    BS_INFO_F(LogCategory::PHYSICS, "EntitySystem: Spawned plane with %zu colliders", storedEntity.colliders.size());
-    return id;
+    BS_INFO_F(LogCategory::PHYSICS, "EntitySystem: Spawned mesh '%s' with %zu colliders", mesh.c_str(),
+              storedEntity.colliders.size());
+    if (m_capture) {
+        m_capture->OnSpawnMesh(storedEntity.id, mesh, position, shader, color);
+    }
+    return storedEntity.id;
+}
+
+size_t EntitySystem::SpawnBatch(const std::vector<glm::vec3>& positions, const std::vector<Entity::VisualShape>& shapes,
+                               const std::vector<glm::vec3>& colors, const std::string& shader,
+                               std::vector<int>* outIds) {
+    if ((!shapes.empty() && shapes.size() != positions.size()) ||
+        (!colors.empty() && colors.size() != positions.size())) {
+        BS_ERROR(LogCategory::CORE, "EntitySystem: SpawnBatch shapes/colors must be empty or match positions");
+        return 0;
+    }
+
+    // The capture needs the ids even when the caller doesn't want them
+    std::vector<int> capturedIds;
+    std::vector<int>* ids = outIds;
+    if (m_capture && !ids) {
+        ids = &capturedIds;
+    }
+    size_t first = ids ? ids->size() : 0;
+
+    m_capturingBatch = true;
+    size_t spawned = SpawnBatch(
+        positions.size(),
+        [&](size_t i, Entity& entity) {
+            Entity::VisualShape shape = shapes.empty() ? Entity::CUBE : shapes[i];
+            entity.shader = shader;
+            entity.GetRender().shape = shape;
+            entity.GetTransform().position = positions[i];
+            entity.GetRender().color = colors.empty() ? glm::vec3(1.0f) : colors[i];
+            entity.GetPhysics().isDynamic = shape != Entity::PLANE;
+            entity.GetPhysics().hasPhysics = true;
+        },
+        ids);
+    m_capturingBatch = false;
+
+    // Running out of slots cuts the batch short, only what made it in gets recorded
+    if (m_capture && spawned > 0) {
+        std::vector<int> batchIds(ids->begin() + first, ids->end());
+        std::vector<uint8_t> batchShapes;
+        for (size_t i = 0; i < spawned && !shapes.empty(); ++i) {
+            batchShapes.push_back(static_cast<uint8_t>(shapes[i]));
+        }
+        std::vector<glm::vec3> batchPositions(positions.begin(), positions.begin() + spawned);
+        std::vector<glm::vec3> batchColors(colors.begin(), colors.begin() + (colors.empty() ? 0 : spawned));
+        m_capture->OnSpawnBatch(batchIds, batchPositions, batchShapes, batchColors, shader);
+    }
+    return spawned;
+}
+
+size_t EntitySystem::SpawnBatch(size_t count, const BatchSetup& setup, std::vector<int>* outIds) {
+    if (!m_physicsSystem) {
+        BS_ERROR(LogCategory::CORE, "EntitySystem: No physics system available!");
+        return 0;
+    }
+
+    Reserve(count);
+    if (outIds) {
+        outIds->reserve(outIds->size() + count);
+    }
+
+    TypedEntityPool<Entity>& pool = GetPool<Entity>();
+    std::vector<Entity*> spawned;
+    std::vector<Entity*> withBodies;
+    spawned.reserve(count);
+    withBodies.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        // Built in place in the pool, no temporary Entity
+        Entity* entity = pool.Create();
+        setup(i, *entity);
+
+        // Nothing to link to yet, CreatePhysicsBodies sets it again once the body exists
+        bool wantsBody = entity->GetPhysics().hasPhysics;
+        entity->GetPhysics().hasPhysics = false;
+
+        if (!RegisterEntity(entity, &pool)) {
+            break;
+        }
+        spawned.push_back(entity);
+        if (wantsBody) {
+            withBodies.push_back(entity);
+        }
+    }
+
+    if (!withBodies.empty()) {
+        m_physicsSystem->CreatePhysicsBodies(withBodies);
+    }
+
+    for (Entity* entity : spawned) {
+        entity->OnSpawn();
+        if (outIds) {
+            outIds->push_back(entity->id);
+        }
+    }
+
+    BS_INFO_F(LogCategory::CORE, "EntitySystem: Batch spawned %zu entities", spawned.size());
+    if (m_capture && !m_capturingBatch && !spawned.empty()) {
+        ReportUncapturedSpawn();
+    }
+    return spawned.size();
+}
+
+void EntitySystem::Reserve(size_t count) {
+    size_t total = m_aliveSlots.size() + count;
+    if (total <= m_entities.size()) {
+        return;  // Enough free slots already
+    }
+
+    m_entities.reserve(total);
+    m_slotPools.reserve(total);
+    m_components.Reserve(total);
+    m_generations.reserve(total);
+    m_alivePositions.reserve(total);
+    m_aliveSlots.reserve(total);
+    TrackMemory();
+}
+
+void EntitySystem::TrackMemory() {
+    // Capacity, so arrays that grew and never shrink back show up as what they really hold
+    size_t bytes = m_entities.capacity() * sizeof(Entity*) + m_slotPools.capacity() * sizeof(EntityPool*) +
+                   m_generations.capacity() * sizeof(uint32_t) + m_freeSlots.capacity() * sizeof(uint32_t) +
+                   m_aliveSlots.capacity() * sizeof(uint32_t) + m_alivePositions.capacity() * sizeof(uint32_t) +
+                   m_entityNames.capacity() * sizeof(std::string) + m_components.GetCapacityBytes();
+    if (bytes != m_trackedBytes) {
+        MemoryTracker::Adjust(MemoryTag::Entities, static_cast<int64_t>(bytes) - static_cast<int64_t>(m_trackedBytes));
+        m_trackedBytes = bytes;
+    }
+}
+
+void EntitySystem::ReportUncapturedSpawn() {
+    m_capture->OnUncapturedSpawn();
+}
+
+Entity* EntitySystem::StoreEntity(const Entity& entity) {
+    TypedEntityPool<Entity>& pool = GetPool<Entity>();
+    return RegisterEntity(pool.Create(entity), &pool);
+}
+
+Entity* EntitySystem::RegisterEntity(Entity* entity, EntityPool* pool) {
+    // Reuse a freed slot if there is one, otherwise grow
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        if (m_entities.size() > ID_INDEX_MASK) {
+            BS_ERROR(LogCategory::CORE, "EntitySystem: Out of entity slots!");
+            pool->Destroy(entity);
+            return nullptr;
+        }
+
+        index = static_cast<uint32_t>(m_entities.size());
+        m_entities.push_back(nullptr);
+        m_slotPools.push_back(nullptr);
+        m_components.Resize(m_entities.size());
+        m_generations.push_back(0);
+        m_alivePositions.push_back(NOT_ALIVE);
+    }
+
+    m_spawnCounter++;
+
+    // The object stays in its pool, the hot components go into the matching store slot
+    m_entities[index] = entity;
+    m_slotPools[index] = pool;
+    entity->id = static_cast<int>((m_generations[index] << ID_INDEX_BITS) | index);
+    entity->AttachToStore(&m_components, index);
+    entity->m_system = this;
+
+    m_alivePositions[index] = static_cast<uint32_t>(m_aliveSlots.size());
+    m_aliveSlots.push_back(index);
+    ++m_version;
+    TrackMemory();
+    return entity;
+}
+
+void EntitySystem::ReleaseSlot(uint32_t index) {
+    // Swap-remove from the alive list, the last alive slot takes our position
+    uint32_t position = m_alivePositions[index];
+    uint32_t lastSlot = m_aliveSlots.back();
+    m_aliveSlots[position] = lastSlot;
+    m_alivePositions[lastSlot] = position;
+    m_aliveSlots.pop_back();
+    m_alivePositions[index] = NOT_ALIVE;
+
+    // New generation, so ids pointing at the old occupant stop resolving
+    m_generations[index] = (m_generations[index] + 1) & ID_GENERATION_MASK;
+
+    // Back to the pool, the slot stays empty until reused
+    m_slotPools[index]->Destroy(m_entities[index]);
+    m_entities[index] = nullptr;
+    m_slotPools[index] = nullptr;
+    m_components.ResetSlot(index);
+
+    m_freeSlots.push_back(index);
+    ++m_version;
+    TrackMemory();
 }
 
 // Generic spawn method
@@ -133,26 +394,170 @@ int EntitySystem::SpawnEntity(Entity::VisualShape shape, const glm::vec3& positi
             return SpawnSphere(position, shader, color);
         case Entity::PLANE:
             return SpawnPlane(position, glm::vec3(1.0f), shader, color);
+        case Entity::MESH:
+            BS_ERROR(LogCategory::CORE, "SpawnEntity can't spawn meshes, use SpawnMesh with the mesh name");
+            return -1;
         default:
             BS_ERROR(LogCategory::CORE, "Unknown entity shape in SpawnEntity");
             return -1;
     }
 }
 
+void EntitySystem::UpdateEntities(float deltaTime, const UpdateSchedule* schedule) {
+    BS_PROFILE_SCOPE("EntitySystem::UpdateEntities");
+    m_updatingEntities = true;
+
+    UpdateParallelPools(deltaTime, schedule);
+
+    // Index loop - an Update can spawn a new type and grow m_pools
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        if (!m_pools[i]->IsParallelUpdate()) {
+            m_pools[i]->UpdateAll(deltaTime, schedule);
+        }
+    }
+
+    m_updatingEntities = false;
+
+    m_commands.Apply(*this);
+    FlushPendingRemovals();
+}
+
+EntityCommandBuffer& EntitySystem::GetCommandBuffer() {
+    if (t_chunkOwner == this && t_chunkCommands) {
+        return *t_chunkCommands;
+    }
+    return m_commands;
+}
+
+void EntitySystem::UpdateParallelPools(float deltaTime, const UpdateSchedule* schedule) {
+    // All parallel pools' blocks laid end to end, so small types share chunks instead of getting one each
+    m_parallelPools.clear();
+    m_parallelBlockStarts.clear();
+    size_t blockCount = 0;
+    for (auto& pool : m_pools) {
+        if (pool->IsParallelUpdate() && pool->GetBlockCount() > 0) {
+            blockCount += pool->GetBlockCount();
+            m_parallelPools.push_back(pool.get());
+            m_parallelBlockStarts.push_back(blockCount);
+        }
+    }
+    if (blockCount == 0) {
+        return;
+    }
+
+    BS_PROFILE_SCOPE("EntitySystem::UpdateParallelPools");
+
+    JobSystem& jobs = JobSystem::Get();
+    size_t chunkCount = m_parallelUpdate ? jobs.GetChunkCount(blockCount, PARALLEL_MIN_BLOCKS) : 1;
+    if (m_chunkCommands.size() < chunkCount) {
+        m_chunkCommands.resize(chunkCount);
+    }
+
+    auto updateChunk = [this, deltaTime, schedule](size_t chunk, size_t begin, size_t end) {
+        // Saved and restored - a worker waiting inside an Update can pick up another chunk
+        EntityCommandBuffer* previousCommands = t_chunkCommands;
+        const EntitySystem* previousOwner = t_chunkOwner;
+        t_chunkCommands = &m_chunkCommands[chunk];
+        t_chunkOwner = this;
+
+        // First pool reaching past 'begin', then the range pool by pool
+        size_t p = static_cast<size_t>(
+            std::upper_bound(m_parallelBlockStarts.begin(), m_parallelBlockStarts.end(), begin) -
+            m_parallelBlockStarts.begin());
+        while (begin < end) {
+            size_t poolStart = p == 0 ? 0 : m_parallelBlockStarts[p - 1];
+            size_t poolEnd = std::min(end, m_parallelBlockStarts[p]);
+            m_parallelPools[p]->UpdateBlocks(deltaTime, schedule, begin - poolStart, poolEnd - poolStart);
+            begin = poolEnd;
+            ++p;
+        }
+
+        t_chunkCommands = previousCommands;
+        t_chunkOwner = previousOwner;
+    };
+
+    if (m_parallelUpdate) {
+        jobs.ParallelFor(blockCount, PARALLEL_MIN_BLOCKS, updateChunk);
+    } else {
+        updateChunk(0, 0, blockCount);
+    }
+
+    // Chunk order, not finish order, so the same frame always plays out the same way
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        m_chunkCommands[chunk].Apply(*this);
+    }
+}
+
+void EntitySystem::DispatchCollisions(const std::vector<CollisionEvent>& events) {
+    if (events.empty())
+        return;
+
+    // Same deal as UpdateEntities, an OnCollision can't delete an entity we're still calling into
+    m_updatingEntities = true;
+
+    for (const CollisionEvent& event : events) {
+        Entity* a = GetEntityPtr(event.entityA);
+        Entity* b = GetEntityPtr(event.entityB);
+        if (!a || !b || !a->IsActive() || !b->IsActive())
+            continue;
+
+        a->OnCollision(*b);
+        if (a->IsActive() && b->IsActive()) {
+            b->OnCollision(*a);
+        }
+    }
+
+    m_updatingEntities = false;
+
+    m_commands.Apply(*this);
+    FlushPendingRemovals();
+}
+
+void EntitySystem::FlushPendingRemovals() {
+    for (int id : m_pendingRemovals) {
+        RemoveEntity(id);
+    }
+    m_pendingRemovals.clear();
+}
+
 void EntitySystem::RemoveEntity(int id) {
-    if (IsValidEntity(id)) {
-        // Call OnDestroy before deactivating
-        m_entities[id].OnDestroy();
-        m_entities[id].active = false;
-        BS_INFO_F(LogCategory::CORE, "EntitySystem: Entity removed (ID: %d)", id);
+    // Can't destroy an object while its pool is walking over it, do it after the update pass
+    if (m_updatingEntities && IsAlive(id)) {
+        m_entities[GetIdIndex(id)]->SetActive(false);
+        ++m_version;
+        if (std::find(m_pendingRemovals.begin(), m_pendingRemovals.end(), id) == m_pendingRemovals.end()) {
+            m_pendingRemovals.push_back(id);
+        }
+        return;
+    }
+
+    if (IsAlive(id)) {
+        // Call OnDestroy before the slot gets recycled
+        Entity& entity = *m_entities[GetIdIndex(id)];
+        entity.OnDestroy();
+
+        // The body would keep simulating (and pointing at a reused slot) otherwise
+        if (m_physicsSystem && entity.GetPhysics().hasPhysics) {
+            m_physicsSystem->RemovePhysicsBody(entity);
+        }
+
+        ReleaseSlot(GetIdIndex(id));
+        BS_DEBUG_F(LogCategory::CORE, "EntitySystem: Entity removed (ID: %d)", id);
+        if (m_capture) {
+            m_capture->OnRemove(id);
+        }
     } else {
         BS_WARN_F(LogCategory::CORE, "EntitySystem: Tried to remove invalid entity (ID: %d)", id);
     }
 }
 
 void EntitySystem::Clear(){
-    for (auto entity : m_entities){
-        RemoveEntity(entity.id);
+    // Anything queued was aimed at entities that are about to go
+    m_commands.Clear();
+
+    // Removing swaps the alive list around, so always take from the back
+    while (!m_aliveSlots.empty()) {
+        RemoveEntity(m_entities[m_aliveSlots.back()]->id);
     }
 }
 
@@ -162,41 +567,139 @@ void EntitySystem::DuplicateEntity(int id) {
         return;
     }
 
-    const Entity& original = m_entities[id];
-    glm::vec3 newPos = original.transform.position + glm::vec3(1.0f, 0.0f, 0.0f);
+    // Straight copy of the cold data, no per-shape spawn. Taken by pointer since the pool doesn't move
+    // entities - only the slot arrays grow.
+    const Entity* original = m_entities[GetIdIndex(id)];
+    std::vector<int> ids;
+    SpawnBatch(
+        1,
+        [&](size_t, Entity& entity) {
+            entity.shader = original->shader;
+            entity.mesh = original->mesh;
+            entity.texture = original->texture;
+            entity.colliders = original->colliders;
+            entity.prefab = original->prefab;
+            entity.space = original->space;
+            entity.GetTransform() = original->GetTransform();
+            entity.GetTransform().position += glm::vec3(1.0f, 0.0f, 0.0f);
+
+            // Render state minus the cached handles, those get resolved again
+            const RenderComponent& render = original->GetRender();
+            entity.GetRender().shape = render.shape;
+            entity.GetRender().color = render.color;
+            entity.GetRender().hasTexture = render.hasTexture;
+
+            const PhysicsComponent& physics = original->GetPhysics();
+            entity.GetPhysics().hasPhysics = physics.hasPhysics;
+            entity.GetPhysics().isDynamic = physics.isDynamic;
+            entity.GetPhysics().layer = physics.layer;
+        },
+        &ids);
+
+    if (!ids.empty()) {
+        BS_INFO_F(LogCategory::CORE, "EntitySystem: Entity duplicated (original: %d, copy: %d, shader: %s)", id,
+                  ids[0], original->shader.c_str());
+    }
+}
 
-    int newId = -1;
-    switch (original.shape) {
-        case Entity::CUBE:
-            newId = SpawnCube(newPos, original.shader, original.color);
-            break;
-        case Entity::SPHERE:
-            newId = SpawnSphere(newPos, original.shader, original.color);
-            break;
-        case Entity::PLANE:
-            newId = SpawnPlane(newPos, original.transform.scale, original.shader, original.color);
-            break;
+PrefabRef EntitySystem::RegisterPrefab(Prefab prefab) {
+    if (prefab.name.empty()) {
+        BS_ERROR(LogCategory::CORE, "EntitySystem: Prefabs need a name");
+        return nullptr;
+    }
+    if (prefab.colliders.empty() && prefab.hasPhysics) {
+        prefab.colliders = PhysicsSystem::GetDefaultColliders(prefab.shape);
     }
 
-    if (newId >= 0) {
-        BS_INFO_F(LogCategory::CORE, "EntitySystem: Entity duplicated (original: %d, copy: %d, shader: %s)",
-                  id, newId, original.shader.c_str());
+    auto shared = std::make_shared<const Prefab>(std::move(prefab));
+    m_prefabs[shared->name] = shared;
+    BS_DEBUG_F(LogCategory::CORE, "EntitySystem: Registered prefab '%s' (%zu colliders)", shared->name.c_str(),
+               shared->colliders.size());
+    return shared;
+}
+
+PrefabRef EntitySystem::CreatePrefabFromEntity(int id, const std::string& name) {
+    if (!IsAlive(id)) {
+        BS_WARN_F(LogCategory::CORE, "EntitySystem: Tried to make a prefab from invalid entity (ID: %d)", id);
+        return nullptr;
     }
+
+    const Entity& entity = *m_entities[GetIdIndex(id)];
+    Prefab prefab;
+    prefab.name = name;
+    prefab.shape = entity.GetRender().shape;
+    prefab.shader = entity.shader;
+    prefab.mesh = entity.mesh;
+    prefab.texture = entity.texture;
+    prefab.color = entity.GetRender().color;
+    prefab.scale = entity.GetTransform().scale;
+    prefab.colliders = entity.colliders;  // Shared, the entity detaches if it edits them later
+    prefab.hasPhysics = entity.GetPhysics().hasPhysics;
+    prefab.isDynamic = entity.GetPhysics().isDynamic;
+    prefab.layer = entity.GetPhysics().layer;
+    return RegisterPrefab(std::move(prefab));
+}
+
+PrefabRef EntitySystem::GetPrefab(const std::string& name) const {
+    auto it = m_prefabs.find(name);
+    return it != m_prefabs.end() ? it->second : nullptr;
+}
+
+int EntitySystem::Instantiate(const PrefabRef& prefab, const glm::vec3& position) {
+    std::vector<int> ids;
+    InstantiateBatch(prefab, {position}, &ids);
+    return ids.empty() ? -1 : ids[0];
+}
+
+size_t EntitySystem::InstantiateBatch(const PrefabRef& prefab, const std::vector<glm::vec3>& positions,
+                                      std::vector<int>* outIds) {
+    if (!prefab) {
+        BS_ERROR(LogCategory::CORE, "EntitySystem: Tried to instantiate a null prefab");
+        return 0;
+    }
+
+    // No name either, GetEntityName derives one from the prefab
+    return SpawnBatch(
+        positions.size(),
+        [&](size_t i, Entity& entity) {
+            entity.prefab = prefab;
+            entity.shader = prefab->shader;
+            entity.mesh = prefab->mesh;
+            entity.SetTexture(prefab->texture);
+            entity.colliders = prefab->colliders;
+            entity.GetRender().shape = prefab->shape;
+            entity.GetRender().color = prefab->color;
+            entity.GetTransform().position = positions[i];
+            entity.GetTransform().scale = prefab->scale;
+            entity.GetPhysics().hasPhysics = prefab->hasPhysics;
+            entity.GetPhysics().isDynamic = prefab->isDynamic;
+            entity.GetPhysics().layer = prefab->layer;
+        },
+        outIds);
 }
 
 // Shader and color management methods
 void EntitySystem::SetEntityShader(int id, const std::string& shader) {
     if (IsValidEntity(id)) {
-        m_entities[id].shader = shader;
+        m_entities[GetIdIndex(id)]->SetShader(shader);
         BS_DEBUG_F(LogCategory::CORE, "EntitySystem: Entity %d shader changed to '%s'", id, shader.c_str());
     } else {
         BS_WARN_F(LogCategory::CORE, "EntitySystem: Tried to set shader on invalid entity (ID: %d)", id);
     }
 }
 
+void EntitySystem::SetEntityTexture(int id, const std::string& texture) {
+    if (IsValidEntity(id)) {
+        m_entities[GetIdIndex(id)]->SetTexture(texture);
+        BS_DEBUG_F(LogCategory::CORE, "EntitySystem: Entity %d texture changed to '%s'", id, texture.c_str());
+    } else {
+        BS_WARN_F(LogCategory::CORE, "EntitySystem: Tried to set texture on invalid entity (ID: %d)", id);
+    }
+}
+
 void EntitySystem::SetEntityColor(int id, const glm::vec3& color) {
     if (IsValidEntity(id)) {
-        m_entities[id].color = color;
+        m_entities[GetIdIndex(id)]->GetRender().color = color;
         BS_DEBUG_F(LogCategory::CORE, "EntitySystem: Entity %d color changed to (%.2f, %.2f, %.2f)",
                   id, color.r, color.g, color.b);
     } else {
@@ -206,44 +709,68 @@ void EntitySystem::SetEntityColor(int id, const glm::vec3& color) {
 
 std::string EntitySystem::GetEntityShader(int id) const {
     if (IsValidEntity(id)) {
-        return m_entities[id].shader;
+        return m_entities[GetIdIndex(id)]->shader;
     }
     return "basic";
 }
 
 glm::vec3 EntitySystem::GetEntityColor(int id) const {
     if (IsValidEntity(id)) {
-        return m_entities[id].color;
+        return m_entities[GetIdIndex(id)]->GetRender().color;
     }
     return glm::vec3(1.0f);
 }
 
 void EntitySystem::SetEntityName(int id, const std::string& name) {
     if (IsValidEntity(id)) {
-        m_entities[id].name = name;
+        m_entities[GetIdIndex(id)]->name = name;
+        ++m_version;
         BS_DEBUG_F(LogCategory::CORE, "EntitySystem: Entity %d renamed to '%s'", id, name.c_str());
     }
 }
 
 std::string EntitySystem::GetEntityName(int id) const {
     if (IsValidEntity(id)) {
-        return m_entities[id].name;
+        const Entity& entity = *m_entities[GetIdIndex(id)];
+        if (!entity.name.empty()) {
+            return entity.name;
+        }
+        if (entity.prefab) {
+            return entity.prefab->name + "_" + std::to_string(GetIdIndex(id));
+        }
+
+        // Batch spawns skip the name, make one up like the single spawns would have
+        switch (entity.GetRender().shape) {
+            case Entity::SPHERE:
+                return "Sphere_" + std::to_string(GetIdIndex(id));
+            case Entity::PLANE:
+                return "Plane_" + std::to_string(GetIdIndex(id));
+            case Entity::MESH:
+                return entity.mesh + "_" + std::to_string(GetIdIndex(id));
+            default:
+                return "Cube_" + std::to_string(GetIdIndex(id));
+        }
     }
     return "Unknown";
 }
 
 Entity* EntitySystem::GetEntityPtr(int id) {
-    if (id >= 0 && id < static_cast<int>(m_entities.size())) {
-        return &m_entities[id];
-    }
-    return nullptr;
+    return IsAlive(id) ? m_entities[GetIdIndex(id)] : nullptr;
 }
 
-bool EntitySystem::IsValidEntity(int id) const {
-    if (id < 0 || id >= static_cast<int>(m_entities.size())) {
+bool EntitySystem::IsAlive(int id) const {
+    if (id < 0) {
         return false;
     }
-    return m_entities[id].active;
+
+    // Generation check is what catches stale ids after the slot got reused
+    uint32_t index = GetIdIndex(id);
+    return index < m_entities.size() && m_generations[index] == GetIdGeneration(id) &&
+           m_alivePositions[index] != NOT_ALIVE;
+}
+
+bool EntitySystem::IsValidEntity(int id) const {
+    return IsAlive(id) && m_entities[GetIdIndex(id)]->IsActive();
 }
 
 }  // namespace Blacksite
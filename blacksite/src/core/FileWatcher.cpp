@@ -0,0 +1,334 @@
+#include "blacksite/core/FileWatcher.h"
+#include "blacksite/core/Logger.h"
+
+#include <filesystem>
+#include <system_error>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <CoreServices/CoreServices.h>
+#include <dispatch/dispatch.h>
+#endif
+
+namespace Blacksite {
+
+namespace {
+// How long the watch thread blocks before checking whether it should stop
+constexpr int WAKE_INTERVAL_MS = 100;
+}  // namespace
+
+std::string FileWatcher::NormalizePath(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    if (error) {
+        absolute = path;
+    }
+    return absolute.lexically_normal().generic_string();
+}
+
+void FileWatcher::RecordChange(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending[path] = Clock::now();
+}
+
+std::vector<std::string> FileWatcher::PollChanges() {
+    std::vector<std::string> settled;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pending.empty()) {
+        return settled;
+    }
+
+    auto now = Clock::now();
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (now - it->second >= m_debounce) {
+            settled.push_back(it->first);
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return settled;
+}
+
+#if defined(__linux__)
+
+namespace {
+constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM;
+}  // namespace
+
+bool FileWatcher::Start(const std::string& directory) {
+    Stop();
+
+    m_directory = NormalizePath(directory);
+    if (m_directory.empty() || m_directory.back() != '/') {
+        m_directory += '/';
+    }
+
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0) {
+        BS_WARN(LogCategory::CORE, "FileWatcher: inotify_init1 failed, falling back to polling");
+        return false;
+    }
+
+    if (!AddWatchRecursive(m_directory)) {
+        close(m_inotify);
+        m_inotify = -1;
+        m_watchDirs.clear();
+        BS_WARN_F(LogCategory::CORE, "FileWatcher: can't watch '%s', falling back to polling", m_directory.c_str());
+        return false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&FileWatcher::WatchLoop, this);
+    BS_DEBUG_F(LogCategory::CORE, "FileWatcher: watching '%s' (%zu directories, inotify)", m_directory.c_str(),
+               m_watchDirs.size());
+    return true;
+}
+
+void FileWatcher::Stop() {
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_inotify >= 0) {
+        close(m_inotify);
+        m_inotify = -1;
+    }
+    m_watchDirs.clear();
+}
+
+bool FileWatcher::AddWatchRecursive(const std::string& directory) {
+    // inotify isn't recursive, every directory gets its own watch
+    int wd = inotify_add_watch(m_inotify, directory.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        return false;
+    }
+    std::string dir = directory.back() == '/' ? directory : directory + '/';
+    m_watchDirs[wd] = dir;
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(dir, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_directory(error)) {
+            AddWatchRecursive(it->path().generic_string());
+        }
+    }
+    return true;
+}
+
+void FileWatcher::WatchLoop() {
+    alignas(inotify_event) char buffer[16 * 1024];
+    pollfd descriptor{m_inotify, POLLIN, 0};
+
+    while (m_running.load(std::memory_order_acquire)) {
+        if (poll(&descriptor, 1, WAKE_INTERVAL_MS) <= 0) {
+            continue;
+        }
+
+        ssize_t length;
+        while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0) {
+            for (char* at = buffer; at < buffer + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(at);
+                at += sizeof(inotify_event) + event->len;
+
+                auto dir = m_watchDirs.find(event->wd);
+                if (dir == m_watchDirs.end() || event->len == 0) {
+                    continue;
+                }
+
+                std::string path = dir->second + event->name;
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                        AddWatchRecursive(path);
+                    }
+                    continue;
+                }
+                RecordChange(path);
+            }
+        }
+    }
+}
+
+#elif defined(_WIN32)
+
+bool FileWatcher::Start(const std::string& directory) {
+    Stop();
+
+    m_directory = NormalizePath(directory);
+    if (m_directory.empty() || m_directory.back() != '/') {
+        m_directory += '/';
+    }
+
+    HANDLE dir = CreateFileA(m_directory.c_str(), FILE_LIST_DIRECTORY,
+                             FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                             FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (dir == INVALID_HANDLE_VALUE) {
+        BS_WARN_F(LogCategory::CORE, "FileWatcher: can't open '%s', falling back to polling", m_directory.c_str());
+        return false;
+    }
+
+    m_dirHandle = dir;
+    m_stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&FileWatcher::WatchLoop, this);
+    BS_DEBUG_F(LogCategory::CORE, "FileWatcher: watching '%s' (ReadDirectoryChangesW)", m_directory.c_str());
+    return true;
+}
+
+void FileWatcher::Stop() {
+    m_running.store(false, std::memory_order_release);
+    if (m_stopEvent) {
+        SetEvent(static_cast<HANDLE>(m_stopEvent));
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_dirHandle) {
+        CloseHandle(static_cast<HANDLE>(m_dirHandle));
+        m_dirHandle = nullptr;
+    }
+    if (m_stopEvent) {
+        CloseHandle(static_cast<HANDLE>(m_stopEvent));
+        m_stopEvent = nullptr;
+    }
+}
+
+void FileWatcher::WatchLoop() {
+    HANDLE dir = static_cast<HANDLE>(m_dirHandle);
+    alignas(DWORD) char buffer[32 * 1024];
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    HANDLE waits[2] = {overlapped.hEvent, static_cast<HANDLE>(m_stopEvent)};
+    const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(dir, buffer, sizeof(buffer), TRUE, filter, nullptr, &overlapped, nullptr)) {
+            BS_WARN(LogCategory::CORE, "FileWatcher: ReadDirectoryChangesW failed, watcher stopped");
+            break;
+        }
+
+        DWORD signalled = WaitForMultipleObjects(2, waits, FALSE, INFINITE);
+        if (signalled != WAIT_OBJECT_0) {
+            CancelIoEx(dir, &overlapped);
+            DWORD ignored = 0;
+            GetOverlappedResult(dir, &overlapped, &ignored, TRUE);
+            break;
+        }
+
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(dir, &overlapped, &bytes, FALSE) || bytes == 0) {
+            continue;  // Buffer overflowed, the next round picks up from here
+        }
+
+        for (const char* at = buffer;;) {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(at);
+            int wideLength = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+            int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, nullptr, 0, nullptr, nullptr);
+            std::string name(length, '\0');
+            WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, &name[0], length, nullptr, nullptr);
+            RecordChange(std::filesystem::path(m_directory + name).lexically_normal().generic_string());
+
+            if (info->NextEntryOffset == 0) {
+                break;
+            }
+            at += info->NextEntryOffset;
+        }
+    }
+
+    CloseHandle(overlapped.hEvent);
+}
+
+#elif defined(__APPLE__)
+
+namespace {
+
+void OnFSEvents(ConstFSEventStreamRef, void* info, size_t count, void* eventPaths,
+                const FSEventStreamEventFlags flags[], const FSEventStreamEventId[]) {
+    auto* watcher = static_cast<FileWatcher*>(info);
+    auto** paths = static_cast<char**>(eventPaths);
+    for (size_t i = 0; i < count; ++i) {
+        if (flags[i] & kFSEventStreamEventFlagItemIsFile) {
+            watcher->RecordChange(FileWatcher::NormalizePath(paths[i]));
+        }
+    }
+}
+
+}  // namespace
+
+bool FileWatcher::Start(const std::string& directory) {
+    Stop();
+
+    m_directory = NormalizePath(directory);
+    if (m_directory.empty() || m_directory.back() != '/') {
+        m_directory += '/';
+    }
+
+    CFStringRef path = CFStringCreateWithCString(nullptr, m_directory.c_str(), kCFStringEncodingUTF8);
+    CFArrayRef paths = CFArrayCreate(nullptr, reinterpret_cast<const void**>(&path), 1, &kCFTypeArrayCallBacks);
+    FSEventStreamContext context{0, this, nullptr, nullptr, nullptr};
+
+    // Our own debounce does the coalescing, keep the OS latency short
+    FSEventStreamRef stream =
+        FSEventStreamCreate(nullptr, &OnFSEvents, &context, paths, kFSEventStreamEventIdSinceNow, 0.05,
+                            kFSEventStreamCreateFlagFileEvents | kFSEventStreamCreateFlagNoDefer);
+    CFRelease(paths);
+    CFRelease(path);
+    if (!stream) {
+        BS_WARN_F(LogCategory::CORE, "FileWatcher: can't watch '%s', falling back to polling", m_directory.c_str());
+        return false;
+    }
+
+    dispatch_queue_t queue = dispatch_queue_create("blacksite.filewatcher", DISPATCH_QUEUE_SERIAL);
+    FSEventStreamSetDispatchQueue(stream, queue);
+    if (!FSEventStreamStart(stream)) {
+        FSEventStreamInvalidate(stream);
+        FSEventStreamRelease(stream);
+        dispatch_release(queue);
+        BS_WARN_F(LogCategory::CORE, "FileWatcher: can't start FSEvents on '%s'", m_directory.c_str());
+        return false;
+    }
+
+    m_stream = stream;
+    m_queue = queue;
+    m_running.store(true, std::memory_order_release);
+    BS_DEBUG_F(LogCategory::CORE, "FileWatcher: watching '%s' (FSEvents)", m_directory.c_str());
+    return true;
+}
+
+void FileWatcher::Stop() {
+    m_running.store(false, std::memory_order_release);
+    if (m_stream) {
+        auto stream = static_cast<FSEventStreamRef>(m_stream);
+        FSEventStreamStop(stream);
+        FSEventStreamInvalidate(stream);
+        FSEventStreamRelease(stream);
+        m_stream = nullptr;
+    }
+    if (m_queue) {
+        dispatch_release(static_cast<dispatch_queue_t>(m_queue));
+        m_queue = nullptr;
+    }
+}
+
+#else
+
+bool FileWatcher::Start(const std::string&) {
+    BS_INFO(LogCategory::CORE, "FileWatcher: no backend for this platform, falling back to polling");
+    return false;
+}
+
+void FileWatcher::Stop() {
+    m_running.store(false, std::memory_order_release);
+}
+
+#endif
+
+}  // namespace Blacksite
@@ -0,0 +1,122 @@
+#include "blacksite/core/FrameArena.h"
+#include <algorithm>
+#include <new>
+#include "blacksite/core/Logger.h"
+
+namespace Blacksite {
+
+std::atomic<FrameArena*> FrameArena::s_current{nullptr};
+
+namespace {
+
+std::atomic<bool> s_fallbackMade{false};  // Get had to make its own arena before there was a current one
+std::atomic<bool> s_retired{false};       // A current arena was there and is gone again
+
+unsigned char* AllocateBytes(size_t size) {
+    void* memory = MemoryTracker::Allocate(size, MemoryTag::FrameArena);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return static_cast<unsigned char*>(memory);
+}
+
+unsigned char* AlignUp(unsigned char* pointer, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+    return pointer + ((alignment - address % alignment) % alignment);
+}
+
+}  // namespace
+
+FrameArena& FrameArena::Get() {
+    if (FrameArena* current = s_current.load(std::memory_order_acquire)) {
+        return *current;
+    }
+
+    // Shutting down (or static destructors) - stragglers get a small one, nobody flips it anymore
+    if (s_retired.load(std::memory_order_acquire)) {
+        static FrameArena retired(0, false);
+        return retired;
+    }
+
+    // No Engine (yet). Never made current, so an Engine arena made later still takes over.
+    s_fallbackMade.store(true, std::memory_order_relaxed);
+    static FrameArena fallback(DEFAULT_SIZE, false);
+    return fallback;
+}
+
+FrameArena::FrameArena(size_t bytesPerFrame) : FrameArena(bytesPerFrame, true) {}
+
+FrameArena::FrameArena(size_t bytesPerFrame, bool makeCurrent) {
+    bytesPerFrame = std::max<size_t>(bytesPerFrame, 64 * 1024);
+    for (Buffer& buffer : m_buffers) {
+        buffer.memory.reset(AllocateBytes(bytesPerFrame));
+        buffer.capacity = bytesPerFrame;
+    }
+
+    // First public one made is the one Get hands out, Get's own fallbacks never are
+    FrameArena* expected = nullptr;
+    if (makeCurrent && s_current.compare_exchange_strong(expected, this, std::memory_order_acq_rel) &&
+        s_fallbackMade.load(std::memory_order_relaxed)) {
+        BS_WARN(LogCategory::CORE, "FrameArena::Get was used before this arena existed, that went to a fallback");
+    }
+}
+
+FrameArena::~FrameArena() {
+    FrameArena* expected = this;
+    if (s_current.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+        s_retired.store(true, std::memory_order_release);
+    }
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    Buffer& buffer = m_buffers[m_current];
+    unsigned char* base = buffer.memory.get();
+
+    size_t offset = buffer.offset.load(std::memory_order_relaxed);
+    while (true) {
+        size_t start = static_cast<size_t>(AlignUp(base + offset, alignment) - base);
+        if (start + size > buffer.capacity) {
+            return Spill(buffer, size, alignment);
+        }
+        if (buffer.offset.compare_exchange_weak(offset, start + size, std::memory_order_relaxed)) {
+            return base + start;
+        }
+    }
+}
+
+void* FrameArena::Spill(Buffer& buffer, size_t size, size_t alignment) {
+    std::lock_guard<std::mutex> lock(buffer.spillMutex);
+    buffer.spills.emplace_back(AllocateBytes(size + alignment));
+    buffer.spilledBytes += size + alignment;
+    return AlignUp(buffer.spills.back().get(), alignment);
+}
+
+void FrameArena::BeginFrame() {
+    ++m_frameIndex;
+    m_current = static_cast<int>(m_frameIndex & 1);
+
+    // This buffer was last used two frames ago, nobody may still point into it
+    Buffer& buffer = m_buffers[m_current];
+    size_t used = buffer.offset.load(std::memory_order_relaxed) + buffer.spilledBytes;
+    m_peakBytes = std::max(m_peakBytes, used);
+
+    if (buffer.spilledBytes > 0) {
+        // Grow with some headroom so a slowly growing scene doesn't spill every other frame
+        size_t capacity = std::max(buffer.capacity * 2, used + used / 2);
+        buffer.memory.reset(AllocateBytes(capacity));
+        buffer.capacity = capacity;
+        m_spillCount++;
+        BS_DEBUG_F(LogCategory::CORE, "FrameArena: frame needed %zu bytes, buffer grown to %zu", used, capacity);
+    }
+
+    buffer.spills.clear();
+    buffer.spilledBytes = 0;
+    buffer.offset.store(0, std::memory_order_relaxed);
+}
+
+size_t FrameArena::GetUsedBytes() const {
+    const Buffer& buffer = m_buffers[m_current];
+    return buffer.offset.load(std::memory_order_relaxed) + buffer.spilledBytes;
+}
+
+}  // namespace Blacksite
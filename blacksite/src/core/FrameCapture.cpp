@@ -0,0 +1,609 @@
+#include "blacksite/core/FrameCapture.h"
+#include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MappedFile.h"
+#include "blacksite/scene/Scene.h"
+#include "blacksite/scene/SceneSerializer.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace Blacksite {
+
+namespace {
+
+constexpr char CAPTURE_MAGIC[4] = {'B', 'S', 'C', 'P'};
+
+// What follows a frame's flags byte, only the parts that changed since the frame before
+enum FrameFlags : uint8_t {
+    FRAME_KEYS = 1 << 0,     // u16 count, u16 key codes that flipped
+    FRAME_MOUSE = 1 << 1,    // f64 x, f64 y
+    FRAME_BUTTONS = 1 << 2,  // u8
+    FRAME_CAMERA = 1 << 3,   // 2 x vec3
+    FRAME_COMMANDS = 1 << 4, // u32 count, commands
+};
+
+template <typename T>
+void Put(std::ofstream& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "raw writes only");
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void PutString(std::ofstream& out, const std::string& text) {
+    uint16_t length = static_cast<uint16_t>(std::min<size_t>(text.size(), UINT16_MAX));
+    Put(out, length);
+    out.write(text.data(), length);
+}
+
+// Bounds-checked reads out of the mapped file. Once a read fails everything after it does too.
+struct ByteReader {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    bool ok = true;
+
+    template <typename T>
+    bool Get(T& value) {
+        if (!ok || size - offset < sizeof(T)) {
+            ok = false;
+            return false;
+        }
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool GetString(std::string& text) {
+        uint16_t length = 0;
+        if (!Get(length) || size - offset < length) {
+            ok = false;
+            return false;
+        }
+        text.assign(reinterpret_cast<const char*>(data + offset), length);
+        offset += length;
+        return true;
+    }
+
+    bool AtEnd() const { return offset >= size; }
+};
+
+}  // namespace
+
+bool FrameCapture::StartRecording(const std::string& path, Scene& scene) {
+    Stop();
+
+    EntitySystem* entities = scene.GetEntitySystem();
+    if (!entities) {
+        BS_ERROR(LogCategory::CORE, "FrameCapture: Scene isn't initialized");
+        return false;
+    }
+
+    // Slot order, same as the snapshot file - a standalone replay maps these to what the load hands out
+    std::vector<int> ids;
+    ids.reserve(entities->GetAliveCount());
+    for (const Entity* entity : entities->GetEntities()) {
+        if (entity) {
+            ids.push_back(entity->id);
+        }
+    }
+
+    if (!SceneSerializer::Save(scene, path + ".bscn", ids)) {
+        BS_ERROR_F(LogCategory::CORE, "FrameCapture: Couldn't write the starting scene for %s", path.c_str());
+        return false;
+    }
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        BS_ERROR_F(LogCategory::CORE, "FrameCapture: Can't write %s", path.c_str());
+        return false;
+    }
+
+    m_file.write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    Put(m_file, FORMAT_VERSION);
+    Put(m_file, static_cast<uint32_t>(entities->GetAliveCount()));
+    Put(m_file, static_cast<uint32_t>(ids.size()));
+    for (int id : ids) {
+        Put(m_file, static_cast<int32_t>(id));
+    }
+
+    // Frames only carry the camera when it moves, so the reader needs where it started
+    m_previous = Frame{};
+    m_previous.cameraPosition = scene.GetCameraPosition();
+    m_previous.cameraTarget = scene.GetCameraTarget();
+    Put(m_file, m_previous.cameraPosition);
+    Put(m_file, m_previous.cameraTarget);
+
+    m_mode = Mode::Recording;
+    m_scene = &scene;
+    m_path = path;
+    m_frameIndex = 0;
+    m_pending.clear();
+    m_warnedUncaptured = false;
+    entities->SetFrameCapture(this);
+
+    BS_INFO_F(LogCategory::CORE, "FrameCapture: Recording to %s (%zu entities in the starting scene)", path.c_str(),
+              ids.size());
+    return true;
+}
+
+bool FrameCapture::StartReplay(const std::string& path, Scene& scene, bool standalone) {
+    Stop();
+
+    EntitySystem* entities = scene.GetEntitySystem();
+    if (!entities) {
+        BS_ERROR(LogCategory::CORE, "FrameCapture: Scene isn't initialized");
+        return false;
+    }
+
+    uint32_t startEntityCount = 0;
+    std::vector<int> snapshotIds;
+    if (!ReadFile(path, startEntityCount, snapshotIds)) {
+        return false;
+    }
+
+    m_idMap.clear();
+    if (standalone) {
+        SceneFileReader reader;
+        if (!reader.Open(path + ".bscn")) {
+            BS_ERROR_F(LogCategory::CORE, "FrameCapture: Starting scene %s.bscn is missing", path.c_str());
+            return false;
+        }
+
+        std::vector<int> loadedIds;
+        scene.Clear();
+        reader.Spawn(scene, 0, reader.GetEntityCount(), &loadedIds);
+        reader.ApplyCamera(scene);
+        for (size_t i = 0; i < loadedIds.size() && i < snapshotIds.size(); ++i) {
+            if (loadedIds[i] != snapshotIds[i]) {
+                m_idMap[snapshotIds[i]] = loadedIds[i];
+            }
+        }
+    } else if (entities->GetAliveCount() != startEntityCount) {
+        BS_WARN_F(LogCategory::CORE, "FrameCapture: Capture started with %u entities, the scene has %zu - "
+                  "the replay will probably diverge", startEntityCount, entities->GetAliveCount());
+    }
+
+    m_mode = standalone ? Mode::ReplayStandalone : Mode::ReplayInApp;
+    m_scene = &scene;
+    m_path = path;
+    m_frameIndex = 0;
+    m_replayFrame = 0;
+    m_divergedFrame = NO_DIVERGENCE;
+    entities->SetFrameCapture(this);
+
+    BS_INFO_F(LogCategory::CORE, "FrameCapture: Replaying %zu frames from %s (%s)", m_frames.size(), path.c_str(),
+              standalone ? "standalone" : "in app");
+    return true;
+}
+
+void FrameCapture::Stop() {
+    if (m_mode == Mode::Off) {
+        return;
+    }
+
+    if (m_mode == Mode::Recording) {
+        // Whatever happened after the last frame goes out with an empty one so nothing is lost
+        if (!m_pending.empty()) {
+            m_current.deltaTime = 0.0f;
+            WriteFrame();
+        }
+        m_file.close();
+        BS_INFO_F(LogCategory::CORE, "FrameCapture: Wrote %llu frames to %s",
+                  static_cast<unsigned long long>(m_frameIndex), m_path.c_str());
+    }
+
+    if (m_scene && m_scene->GetEntitySystem()) {
+        m_scene->GetEntitySystem()->SetFrameCapture(nullptr);
+    }
+
+    m_mode = Mode::Off;
+    m_scene = nullptr;
+    m_inFrame = false;
+    m_pending.clear();
+    m_frames.clear();
+    m_commands.clear();
+    m_idMap.clear();
+}
+
+bool FrameCapture::BeginFrame(float& deltaTime, InputSystem& input) {
+    if (m_mode == Mode::Recording) {
+        m_current.deltaTime = deltaTime;
+        input.GetSnapshot(m_current.input);
+        m_inFrame = true;
+        return true;
+    }
+
+    if (!IsReplaying()) {
+        return true;
+    }
+    if (m_replayFrame >= m_frames.size()) {
+        return false;
+    }
+
+    const Frame& frame = m_frames[m_replayFrame];
+    deltaTime = frame.deltaTime;
+    input.ApplySnapshot(frame.input);
+
+    // In app the game makes its own in-frame changes again, standalone there's no game so we make them too
+    for (size_t i = 0; i < frame.commandCount; ++i) {
+        const Command& command = m_commands[frame.firstCommand + i];
+        if (m_mode == Mode::ReplayStandalone || !command.inFrame) {
+            ApplyCommand(command);
+        }
+    }
+
+    if (m_mode == Mode::ReplayStandalone) {
+        m_scene->SetCameraPosition(frame.cameraPosition);
+        m_scene->SetCameraTarget(frame.cameraTarget);
+    }
+
+    m_inFrame = true;
+    return true;
+}
+
+void FrameCapture::EndFrame() {
+    if (!m_inFrame) {
+        return;
+    }
+    m_inFrame = false;
+
+    EntitySystem* entities = m_scene->GetEntitySystem();
+    uint32_t entityCount = static_cast<uint32_t>(entities->GetAliveCount());
+
+    if (m_mode == Mode::Recording) {
+        m_current.entityCount = entityCount;
+        m_current.cameraPosition = m_scene->GetCameraPosition();
+        m_current.cameraTarget = m_scene->GetCameraTarget();
+        WriteFrame();
+        return;
+    }
+
+    const Frame& frame = m_frames[m_replayFrame];
+    if (entityCount != frame.entityCount && m_divergedFrame == NO_DIVERGENCE) {
+        m_divergedFrame = m_frameIndex;
+        BS_WARN_F(LogCategory::CORE, "FrameCapture: Replay diverged at frame %llu (%u entities, capture had %u)",
+                  static_cast<unsigned long long>(m_frameIndex), entityCount, frame.entityCount);
+    }
+    ++m_replayFrame;
+    ++m_frameIndex;
+
+    if (m_replayFrame == m_frames.size()) {
+        BS_INFO_F(LogCategory::CORE, "FrameCapture: Replay of %s finished", m_path.c_str());
+    }
+}
+
+void FrameCapture::OnSpawn(uint8_t shape, int id, const glm::vec3& position, const glm::vec3& size,
+                           const std::string& shader, const glm::vec3& color) {
+    Command command;
+    command.type = CommandType::Spawn;
+    command.shape = shape;
+    command.id = id;
+    command.position = position;
+    command.size = size;
+    command.shader = shader;
+    command.color = color;
+    Record(std::move(command));
+}
+
+void FrameCapture::OnSpawnMesh(int id, const std::string& mesh, const glm::vec3& position, const std::string& shader,
+                               const glm::vec3& color) {
+    Command command;
+    command.type = CommandType::SpawnMesh;
+    command.id = id;
+    command.mesh = mesh;
+    command.position = position;
+    command.shader = shader;
+    command.color = color;
+    Record(std::move(command));
+}
+
+void FrameCapture::OnSpawnBatch(const std::vector<int>& ids, const std::vector<glm::vec3>& positions,
+                                const std::vector<uint8_t>& shapes, const std::vector<glm::vec3>& colors,
+                                const std::string& shader) {
+    Command command;
+    command.type = CommandType::SpawnBatch;
+    command.ids = ids;
+    command.positions = positions;
+    command.shapes = shapes;
+    command.colors = colors;
+    command.shader = shader;
+    Record(std::move(command));
+}
+
+void FrameCapture::OnRemove(int id) {
+    Command command;
+    command.type = CommandType::Remove;
+    command.id = id;
+    Record(std::move(command));
+}
+
+void FrameCapture::OnUncapturedSpawn() {
+    if (m_mode != Mode::Recording || m_warnedUncaptured) {
+        return;
+    }
+    m_warnedUncaptured = true;
+    BS_WARN_F(LogCategory::CORE, "FrameCapture: Frame %llu spawned through Spawn<T> or a setup-callback SpawnBatch. "
+              "Those aren't recorded, replay this capture in app.", static_cast<unsigned long long>(m_frameIndex));
+}
+
+int FrameCapture::MapId(int capturedId) const {
+    auto it = m_idMap.find(capturedId);
+    return it != m_idMap.end() ? it->second : capturedId;
+}
+
+void FrameCapture::Record(Command&& command) {
+    if (m_mode != Mode::Recording) {
+        return;
+    }
+    command.inFrame = m_inFrame;
+    m_pending.push_back(std::move(command));
+}
+
+void FrameCapture::WriteFrame() {
+    const Frame& frame = m_current;
+
+    uint8_t flags = 0;
+    std::vector<uint16_t> flipped;
+    if (frame.input.keys != m_previous.input.keys) {
+        for (int key = 0; key < InputSystem::MAX_KEYS; ++key) {
+            if (frame.input.keys[key] != m_previous.input.keys[key]) {
+                flipped.push_back(static_cast<uint16_t>(key));
+            }
+        }
+        flags |= FRAME_KEYS;
+    }
+    if (frame.input.mouseX != m_previous.input.mouseX || frame.input.mouseY != m_previous.input.mouseY) {
+        flags |= FRAME_MOUSE;
+    }
+    if (frame.input.mouseButtons != m_previous.input.mouseButtons) {
+        flags |= FRAME_BUTTONS;
+    }
+    if (frame.cameraPosition != m_previous.cameraPosition || frame.cameraTarget != m_previous.cameraTarget) {
+        flags |= FRAME_CAMERA;
+    }
+    if (!m_pending.empty()) {
+        flags |= FRAME_COMMANDS;
+    }
+
+    Put(m_file, flags);
+    Put(m_file, frame.deltaTime);
+    Put(m_file, frame.entityCount);
+    if (flags & FRAME_KEYS) {
+        Put(m_file, static_cast<uint16_t>(flipped.size()));
+        for (uint16_t key : flipped) {
+            Put(m_file, key);
+        }
+    }
+    if (flags & FRAME_MOUSE) {
+        Put(m_file, frame.input.mouseX);
+        Put(m_file, frame.input.mouseY);
+    }
+    if (flags & FRAME_BUTTONS) {
+        Put(m_file, frame.input.mouseButtons);
+    }
+    if (flags & FRAME_CAMERA) {
+        Put(m_file, frame.cameraPosition);
+        Put(m_file, frame.cameraTarget);
+    }
+    if (flags & FRAME_COMMANDS) {
+        Put(m_file, static_cast<uint32_t>(m_pending.size()));
+        for (const Command& command : m_pending) {
+            Put(m_file, static_cast<uint8_t>(command.type));
+            Put(m_file, static_cast<uint8_t>(command.inFrame));
+            Put(m_file, static_cast<int32_t>(command.id));
+            switch (command.type) {
+                case CommandType::Spawn:
+                    Put(m_file, command.shape);
+                    Put(m_file, command.position);
+                    Put(m_file, command.size);
+                    Put(m_file, command.color);
+                    PutString(m_file, command.shader);
+                    break;
+                case CommandType::SpawnMesh:
+                    Put(m_file, command.position);
+                    Put(m_file, command.color);
+                    PutString(m_file, command.shader);
+                    PutString(m_file, command.mesh);
+                    break;
+                case CommandType::SpawnBatch:
+                    PutString(m_file, command.shader);
+                    Put(m_file, static_cast<uint32_t>(command.ids.size()));
+                    for (size_t i = 0; i < command.ids.size(); ++i) {
+                        Put(m_file, static_cast<int32_t>(command.ids[i]));
+                        Put(m_file, command.shapes.empty() ? uint8_t{0} : command.shapes[i]);
+                        Put(m_file, command.positions[i]);
+                        Put(m_file, command.colors.empty() ? glm::vec3(1.0f) : command.colors[i]);
+                    }
+                    break;
+                case CommandType::Remove:
+                    break;
+            }
+        }
+    }
+
+    m_previous = frame;
+    m_pending.clear();
+    ++m_frameIndex;
+}
+
+void FrameCapture::ApplyCommand(const Command& command) {
+    EntitySystem& entities = *m_scene->GetEntitySystem();
+
+    // A spawn that lands on a different id than it did while recording gets remembered, later removes follow it
+    auto remember = [this](int capturedId, int id) {
+        if (id != capturedId) {
+            m_idMap[capturedId] = id;
+        }
+    };
+
+    switch (command.type) {
+        case CommandType::Spawn: {
+            auto shape = static_cast<Entity::VisualShape>(command.shape);
+            int id = shape == Entity::PLANE
+                         ? entities.SpawnPlane(command.position, command.size, command.shader, command.color)
+                         : entities.SpawnEntity(shape, command.position, command.shader, command.color);
+            remember(command.id, id);
+            break;
+        }
+        case CommandType::SpawnMesh:
+            remember(command.id, entities.SpawnMesh(command.mesh, command.position, command.shader, command.color));
+            break;
+        case CommandType::SpawnBatch: {
+            std::vector<Entity::VisualShape> shapes;
+            shapes.reserve(command.shapes.size());
+            for (uint8_t shape : command.shapes) {
+                shapes.push_back(static_cast<Entity::VisualShape>(shape));
+            }
+            std::vector<int> ids;
+            entities.SpawnBatch(command.positions, shapes, command.colors, command.shader, &ids);
+            for (size_t i = 0; i < ids.size() && i < command.ids.size(); ++i) {
+                remember(command.ids[i], ids[i]);
+            }
+            break;
+        }
+        case CommandType::Remove:
+            entities.RemoveEntity(MapId(command.id));
+            break;
+    }
+}
+
+bool FrameCapture::ReadFile(const std::string& path, uint32_t& startEntityCount, std::vector<int>& snapshotIds) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        BS_ERROR_F(LogCategory::CORE, "FrameCapture: Can't open %s", path.c_str());
+        return false;
+    }
+
+    ByteReader reader{file.Data(), file.Size()};
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint32_t idCount = 0;
+    reader.Get(magic);
+    reader.Get(version);
+    reader.Get(startEntityCount);
+    reader.Get(idCount);
+    if (!reader.ok || std::memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0 || version != FORMAT_VERSION) {
+        BS_ERROR_F(LogCategory::CORE, "FrameCapture: %s isn't a version %u capture", path.c_str(), FORMAT_VERSION);
+        return false;
+    }
+
+    snapshotIds.resize(idCount);
+    for (int& id : snapshotIds) {
+        int32_t value = 0;
+        reader.Get(value);
+        id = value;
+    }
+
+    m_frames.clear();
+    m_commands.clear();
+    Frame frame;  // Carries over whatever the next frame doesn't change, starting with the camera
+    reader.Get(frame.cameraPosition);
+    reader.Get(frame.cameraTarget);
+    if (!reader.ok) {
+        BS_ERROR_F(LogCategory::CORE, "FrameCapture: %s ends inside its header", path.c_str());
+        return false;
+    }
+    while (reader.ok && !reader.AtEnd()) {
+        uint8_t flags = 0;
+        reader.Get(flags);
+        reader.Get(frame.deltaTime);
+        reader.Get(frame.entityCount);
+
+        if (flags & FRAME_KEYS) {
+            uint16_t count = 0;
+            reader.Get(count);
+            for (uint16_t i = 0; i < count && reader.ok; ++i) {
+                uint16_t key = 0;
+                if (reader.Get(key) && key < InputSystem::MAX_KEYS) {
+                    frame.input.keys.flip(key);
+                }
+            }
+        }
+        if (flags & FRAME_MOUSE) {
+            reader.Get(frame.input.mouseX);
+            reader.Get(frame.input.mouseY);
+        }
+        if (flags & FRAME_BUTTONS) {
+            reader.Get(frame.input.mouseButtons);
+        }
+        if (flags & FRAME_CAMERA) {
+            reader.Get(frame.cameraPosition);
+            reader.Get(frame.cameraTarget);
+        }
+
+        frame.firstCommand = m_commands.size();
+        frame.commandCount = 0;
+        if (flags & FRAME_COMMANDS) {
+            uint32_t count = 0;
+            reader.Get(count);
+            for (uint32_t i = 0; i < count && reader.ok; ++i) {
+                Command command;
+                uint8_t type = 0;
+                uint8_t inFrame = 0;
+                int32_t id = 0;
+                reader.Get(type);
+                reader.Get(inFrame);
+                reader.Get(id);
+                command.type = static_cast<CommandType>(type);
+                command.inFrame = inFrame != 0;
+                command.id = id;
+
+                switch (command.type) {
+                    case CommandType::Spawn:
+                        reader.Get(command.shape);
+                        reader.Get(command.position);
+                        reader.Get(command.size);
+                        reader.Get(command.color);
+                        reader.GetString(command.shader);
+                        break;
+                    case CommandType::SpawnMesh:
+                        reader.Get(command.position);
+                        reader.Get(command.color);
+                        reader.GetString(command.shader);
+                        reader.GetString(command.mesh);
+                        break;
+                    case CommandType::SpawnBatch: {
+                        uint32_t batchCount = 0;
+                        reader.GetString(command.shader);
+                        reader.Get(batchCount);
+                        for (uint32_t b = 0; b < batchCount && reader.ok; ++b) {
+                            int32_t batchId = 0;
+                            uint8_t shape = 0;
+                            glm::vec3 position(0.0f);
+                            glm::vec3 color(1.0f);
+                            reader.Get(batchId);
+                            reader.Get(shape);
+                            reader.Get(position);
+                            reader.Get(color);
+                            command.ids.push_back(batchId);
+                            command.shapes.push_back(shape);
+                            command.positions.push_back(position);
+                            command.colors.push_back(color);
+                        }
+                        break;
+                    }
+                    case CommandType::Remove:
+                        break;
+                    default:
+                        reader.ok = false;
+                        break;
+                }
+                if (reader.ok) {
+                    m_commands.push_back(std::move(command));
+                    ++frame.commandCount;
+                }
+            }
+        }
+
+        if (!reader.ok) {
+            // A capture cut short by a crash still replays up to where it stopped
+            BS_WARN_F(LogCategory::CORE, "FrameCapture: %s is truncated after %zu frames", path.c_str(),
+                      m_frames.size());
+            break;
+        }
+        m_frames.push_back(frame);
+    }
+    return true;
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,282 @@
+#include "blacksite/core/FramePacer.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+namespace Blacksite {
+
+namespace {
+
+std::atomic<bool> s_redrawRequested{false};
+
+constexpr double MIN_SPIN_MS = 0.2;
+constexpr double MAX_SPIN_MS = 4.0;
+
+// What was installed before us, per window. Our callbacks count the event and pass it on, so the
+// InputSystem, ImGui and whoever else hooked the window keep getting theirs.
+struct PacerHooks {
+    uint64_t eventCount = 0;
+    GLFWkeyfun key = nullptr;
+    GLFWcharfun character = nullptr;
+    GLFWmousebuttonfun mouseButton = nullptr;
+    GLFWcursorposfun cursorPos = nullptr;
+    GLFWcursorenterfun cursorEnter = nullptr;
+    GLFWscrollfun scroll = nullptr;
+    GLFWdropfun drop = nullptr;
+    GLFWwindowfocusfun focus = nullptr;
+    GLFWwindowiconifyfun iconify = nullptr;
+    GLFWframebuffersizefun framebufferSize = nullptr;
+    GLFWwindowrefreshfun refresh = nullptr;
+};
+
+std::unordered_map<GLFWwindow*, PacerHooks> s_pacerHooks;  // Main thread only, like GLFW callbacks
+
+// Only used to tell "something happened", whatever the event was
+template <typename Fn, typename... Args>
+void CountAndForward(GLFWwindow* window, Fn PacerHooks::*previous, Args... args) {
+    auto it = s_pacerHooks.find(window);
+    if (it == s_pacerHooks.end()) {
+        return;
+    }
+    ++it->second.eventCount;
+    if (Fn fn = it->second.*previous) {
+        fn(window, args...);
+    }
+}
+
+void OnKey(GLFWwindow* w, int key, int scancode, int action, int mods) {
+    CountAndForward(w, &PacerHooks::key, key, scancode, action, mods);
+}
+void OnChar(GLFWwindow* w, unsigned int codepoint) { CountAndForward(w, &PacerHooks::character, codepoint); }
+void OnMouseButton(GLFWwindow* w, int button, int action, int mods) {
+    CountAndForward(w, &PacerHooks::mouseButton, button, action, mods);
+}
+void OnCursorPos(GLFWwindow* w, double x, double y) { CountAndForward(w, &PacerHooks::cursorPos, x, y); }
+void OnCursorEnter(GLFWwindow* w, int entered) { CountAndForward(w, &PacerHooks::cursorEnter, entered); }
+void OnScroll(GLFWwindow* w, double x, double y) { CountAndForward(w, &PacerHooks::scroll, x, y); }
+void OnDrop(GLFWwindow* w, int count, const char** paths) { CountAndForward(w, &PacerHooks::drop, count, paths); }
+void OnFocus(GLFWwindow* w, int focused) { CountAndForward(w, &PacerHooks::focus, focused); }
+void OnIconify(GLFWwindow* w, int iconified) { CountAndForward(w, &PacerHooks::iconify, iconified); }
+void OnFramebufferSize(GLFWwindow* w, int width, int height) {
+    CountAndForward(w, &PacerHooks::framebufferSize, width, height);
+}
+void OnRefresh(GLFWwindow* w) { CountAndForward(w, &PacerHooks::refresh); }
+
+// Same rule as the InputSystem's: put previous back only if ours is still the installed callback
+template <typename Fn>
+bool RestoreCallback(GLFWwindow* window, Fn (*set)(GLFWwindow*, Fn), Fn ours, Fn previous) {
+    Fn current = set(window, previous);
+    if (current != ours) {
+        set(window, current);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+FramePacer::~FramePacer() {
+    // The window can outlive us, hand its callbacks back
+    if (m_window) {
+        RemoveCallbacks();
+    }
+}
+
+void FramePacer::Initialize(GLFWwindow* window) {
+    m_window = window;
+    InstallCallbacks();
+
+    // Needs the context current, which it is by the time the engine gets here
+    m_adaptiveSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                          glfwExtensionSupported("GLX_EXT_swap_control_tear");
+
+    m_lastActivity = Clock::now();
+    m_nextFrame = m_lastActivity;
+    ApplyVSync();
+}
+
+void FramePacer::SetConfig(const FramePacingConfig& config) {
+    bool vsyncChanged = config.vsync != m_config.vsync;
+    m_config = config;
+    m_updateAccumulator = 0.0f;
+    MarkActivity();
+    if (vsyncChanged) {
+        ApplyVSync();
+    }
+}
+
+void FramePacer::ApplyVSync() {
+    if (!m_window) {
+        return;
+    }
+
+    int interval = 0;
+    switch (m_config.vsync) {
+        case VSyncMode::Off:
+            interval = 0;
+            break;
+        case VSyncMode::On:
+            interval = 1;
+            break;
+        case VSyncMode::Adaptive:
+            if (!m_adaptiveSupported) {
+                BS_WARN(LogCategory::CORE, "FramePacer: Adaptive vsync isn't supported here, using regular vsync");
+            }
+            interval = m_adaptiveSupported ? -1 : 1;
+            break;
+    }
+    glfwSwapInterval(interval);
+}
+
+void FramePacer::PollEvents() {
+    BS_PROFILE_SCOPE("FramePacer::PollEvents");
+
+    double quietSeconds = std::chrono::duration<double>(Clock::now() - m_lastActivity).count();
+    m_idle = m_window && m_config.idleWhenUnchanged && quietSeconds >= m_config.idleDelay;
+    if (m_idle) {
+        // Returns on the first event, or after the timeout so the frame still comes around now and then
+        glfwWaitEventsTimeout(std::max(0.001f, m_config.idleTimeout));
+    } else {
+        glfwPollEvents();
+    }
+
+    auto hooks = s_pacerHooks.find(m_window);
+    uint64_t eventCount = hooks != s_pacerHooks.end() ? hooks->second.eventCount : m_seenEvents;
+    if (eventCount != m_seenEvents || s_redrawRequested.exchange(false)) {
+        m_seenEvents = eventCount;
+        MarkActivity();
+    }
+}
+
+void FramePacer::EndFrame() {
+    BS_PROFILE_SCOPE("FramePacer::EndFrame");
+
+    int cap = m_config.targetFps;
+    m_throttled = false;
+    if (m_window && m_config.unfocusedFps > 0 && (cap == 0 || m_config.unfocusedFps < cap)) {
+        m_throttled = !glfwGetWindowAttrib(m_window, GLFW_FOCUSED) || glfwGetWindowAttrib(m_window, GLFW_ICONIFIED);
+        if (m_throttled) {
+            cap = m_config.unfocusedFps;
+        }
+    }
+
+    Clock::time_point now = Clock::now();
+    if (cap <= 0) {
+        m_nextFrame = now;
+        m_lastWaitMs = 0.0f;
+        return;
+    }
+
+    // Deadlines follow each other so the rate holds on average. One that's already gone resets to now,
+    // a late frame shouldn't be followed by a burst of catch-up frames.
+    m_nextFrame += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / cap));
+    if (m_nextFrame < now) {
+        m_nextFrame = now;
+    }
+
+    // A throttled frame doesn't need to be on time, don't spin for it
+    WaitUntil(m_nextFrame, !m_throttled);
+    m_lastWaitMs = std::chrono::duration<float, std::milli>(Clock::now() - now).count();
+}
+
+void FramePacer::WaitUntil(Clock::time_point deadline, bool spin) {
+    if (!spin) {
+        std::this_thread::sleep_until(deadline);
+        return;
+    }
+
+    // Sleep most of the way, wake up early by about twice what sleeps usually overshoot, spin the rest
+    double spinMs = std::clamp(m_oversleepMs * 2.0, MIN_SPIN_MS, MAX_SPIN_MS);
+    Clock::time_point wake = deadline - std::chrono::duration_cast<Clock::duration>(
+                                            std::chrono::duration<double, std::milli>(spinMs));
+
+    Clock::time_point before = Clock::now();
+    if (before < wake) {
+        std::this_thread::sleep_until(wake);
+        double oversleep = std::chrono::duration<double, std::milli>(Clock::now() - wake).count();
+        m_oversleepMs += (std::max(0.0, oversleep) - m_oversleepMs) * 0.1;
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+int FramePacer::ConsumeUpdateSteps(float deltaTime, float& stepDelta) {
+    if (m_config.updateRate <= 0) {
+        stepDelta = deltaTime;
+        return 1;
+    }
+
+    stepDelta = 1.0f / m_config.updateRate;
+    m_updateAccumulator += deltaTime;
+    int steps = static_cast<int>(m_updateAccumulator / stepDelta);
+    if (steps > MAX_UPDATE_STEPS) {
+        steps = MAX_UPDATE_STEPS;
+        m_updateAccumulator = 0.0f;
+    } else {
+        m_updateAccumulator -= steps * stepDelta;
+    }
+    return steps;
+}
+
+void FramePacer::MarkActivity() {
+    m_lastActivity = Clock::now();
+    m_idle = false;
+}
+
+void FramePacer::RequestRedraw() {
+    s_redrawRequested = true;
+    glfwPostEmptyEvent();
+}
+
+void FramePacer::InstallCallbacks() {
+    // Still hooked by an earlier pacer that something chained on top of, the count carries on
+    if (s_pacerHooks.count(m_window)) {
+        return;
+    }
+
+    PacerHooks& hooks = s_pacerHooks[m_window];
+    hooks.key = glfwSetKeyCallback(m_window, OnKey);
+    hooks.character = glfwSetCharCallback(m_window, OnChar);
+    hooks.mouseButton = glfwSetMouseButtonCallback(m_window, OnMouseButton);
+    hooks.cursorPos = glfwSetCursorPosCallback(m_window, OnCursorPos);
+    hooks.cursorEnter = glfwSetCursorEnterCallback(m_window, OnCursorEnter);
+    hooks.scroll = glfwSetScrollCallback(m_window, OnScroll);
+    hooks.drop = glfwSetDropCallback(m_window, OnDrop);
+    hooks.focus = glfwSetWindowFocusCallback(m_window, OnFocus);
+    hooks.iconify = glfwSetWindowIconifyCallback(m_window, OnIconify);
+    hooks.framebufferSize = glfwSetFramebufferSizeCallback(m_window, OnFramebufferSize);
+    hooks.refresh = glfwSetWindowRefreshCallback(m_window, OnRefresh);
+}
+
+void FramePacer::RemoveCallbacks() {
+    auto it = s_pacerHooks.find(m_window);
+    if (it == s_pacerHooks.end()) {
+        return;
+    }
+
+    // Anything chained on top of us keeps calling ours, so the entry stays until every one is back
+    const PacerHooks& hooks = it->second;
+    bool restored = RestoreCallback(m_window, glfwSetKeyCallback, &OnKey, hooks.key);
+    restored &= RestoreCallback(m_window, glfwSetCharCallback, &OnChar, hooks.character);
+    restored &= RestoreCallback(m_window, glfwSetMouseButtonCallback, &OnMouseButton, hooks.mouseButton);
+    restored &= RestoreCallback(m_window, glfwSetCursorPosCallback, &OnCursorPos, hooks.cursorPos);
+    restored &= RestoreCallback(m_window, glfwSetCursorEnterCallback, &OnCursorEnter, hooks.cursorEnter);
+    restored &= RestoreCallback(m_window, glfwSetScrollCallback, &OnScroll, hooks.scroll);
+    restored &= RestoreCallback(m_window, glfwSetDropCallback, &OnDrop, hooks.drop);
+    restored &= RestoreCallback(m_window, glfwSetWindowFocusCallback, &OnFocus, hooks.focus);
+    restored &= RestoreCallback(m_window, glfwSetWindowIconifyCallback, &OnIconify, hooks.iconify);
+    restored &= RestoreCallback(m_window, glfwSetFramebufferSizeCallback, &OnFramebufferSize, hooks.framebufferSize);
+    restored &= RestoreCallback(m_window, glfwSetWindowRefreshCallback, &OnRefresh, hooks.refresh);
+    if (restored) {
+        s_pacerHooks.erase(it);
+    }
+}
+
+}  // namespace Blacksite
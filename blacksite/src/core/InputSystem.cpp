@@ -1,10 +1,36 @@
 #include "blacksite/core/InputSystem.h"
 #include "blacksite/core/Logger.h"
-#include <cstring>
 #include <cctype>
 
 namespace Blacksite {
 
+namespace {
+
+// Per window: who gets the events and what we replaced. Outlives the InputSystem when something chained on
+// top of us (ImGui), the callbacks still have to forward then.
+struct WindowHooks {
+    InputSystem* input = nullptr;
+    GLFWkeyfun key = nullptr;
+    GLFWmousebuttonfun mouseButton = nullptr;
+    GLFWcursorposfun cursorPos = nullptr;
+    GLFWscrollfun scroll = nullptr;
+};
+
+std::unordered_map<GLFWwindow*, WindowHooks> s_hooks;  // Main thread only, like GLFW callbacks
+
+// Puts previous back if ours is still the installed callback, otherwise leaves whoever chained on top alone
+template <typename Fn>
+bool RestoreCallback(GLFWwindow* window, Fn (*set)(GLFWwindow*, Fn), Fn ours, Fn previous) {
+    Fn current = set(window, previous);
+    if (current != ours) {
+        set(window, current);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
 bool InputSystem::Initialize(GLFWwindow* window) {
     if (m_initialized) {
         BS_WARN(LogCategory::INPUT, "InputSystem already initialized");
@@ -19,9 +45,15 @@ bool InputSystem::Initialize(GLFWwindow* window) {
     m_window = window;
     m_initialized = true;
 
-    // Initialize arrays
-    std::memset(m_keys, false, sizeof(m_keys));
-    std::memset(m_keysLastFrame, false, sizeof(m_keysLastFrame));
+    m_keys.reset();
+    m_keysPressed.reset();
+    m_keysReleased.reset();
+    m_mouseButtons = m_mousePressed = m_mouseReleased = 0;
+    m_pendingEvents.clear();
+    m_frameEvents.clear();
+    glfwGetCursorPos(window, &m_cursorX, &m_cursorY);
+
+    InstallCallbacks();
 
     BS_INFO(LogCategory::INPUT, "InputSystem initialized with new API");
     return true;
@@ -30,7 +62,19 @@ bool InputSystem::Initialize(GLFWwindow* window) {
 void InputSystem::Update() {
     if (!m_initialized || !m_window) return;
 
-    UpdateKeyStates();
+    ++m_frame;
+    m_keysPressed.reset();
+    m_keysReleased.reset();
+    m_mousePressed = m_mouseReleased = 0;
+    m_scroll = glm::vec2(0.0f);
+
+    // Swap instead of copy, both vectors keep their capacity
+    m_frameEvents.swap(m_pendingEvents);
+    m_pendingEvents.clear();
+    for (InputEvent& event : m_frameEvents) {
+        event.frame = m_frame;
+        ApplyEvent(event);
+    }
 
     // Only update mouse if we should capture it
     if (ShouldCaptureMouse()) {
@@ -38,13 +82,36 @@ void InputSystem::Update() {
     }
 }
 
-void InputSystem::UpdateKeyStates() {
-    // Copy current frame to last frame
-    std::memcpy(m_keysLastFrame, m_keys, sizeof(m_keys));
-
-    // Update current frame key states
-    for (int i = 0; i < MAX_KEYS; ++i) {
-        m_keys[i] = (glfwGetKey(m_window, i) == GLFW_PRESS);
+void InputSystem::ApplyEvent(const InputEvent& event) {
+    switch (event.type) {
+        case InputEvent::Type::Key:
+            if (event.code < 0 || event.code >= MAX_KEYS) {
+                return;
+            }
+            if (event.pressed) {
+                m_keysPressed.set(event.code);
+            } else {
+                m_keysReleased.set(event.code);
+            }
+            m_keys.set(event.code, event.pressed);
+            break;
+        case InputEvent::Type::MouseButton: {
+            if (event.code < 0 || event.code >= MAX_MOUSE_BUTTONS) {
+                return;
+            }
+            uint8_t bit = static_cast<uint8_t>(1u << event.code);
+            if (event.pressed) {
+                m_mousePressed |= bit;
+                m_mouseButtons |= bit;
+            } else {
+                m_mouseReleased |= bit;
+                m_mouseButtons &= static_cast<uint8_t>(~bit);
+            }
+            break;
+        }
+        case InputEvent::Type::Scroll:
+            m_scroll += event.scroll;
+            break;
     }
 }
 
@@ -52,7 +119,8 @@ void InputSystem::UpdateMouseState() {
     m_lastMouseX = m_mouseX;
     m_lastMouseY = m_mouseY;
 
-    glfwGetCursorPos(m_window, &m_mouseX, &m_mouseY);
+    m_mouseX = m_cursorX;
+    m_mouseY = m_cursorY;
 
     if (m_firstMouse) {
         m_lastMouseX = m_mouseX;
@@ -68,26 +136,154 @@ bool InputSystem::IsKeyPressed(int key) const {
 
 bool InputSystem::IsKeyJustPressed(int key) const {
     if (key < 0 || key >= MAX_KEYS) return false;
-    return m_keys[key] && !m_keysLastFrame[key];
+    return m_keysPressed[key];
 }
 
 bool InputSystem::IsKeyJustReleased(int key) const {
     if (key < 0 || key >= MAX_KEYS) return false;
-    return !m_keys[key] && m_keysLastFrame[key];
+    return m_keysReleased[key];
 }
 
 bool InputSystem::IsMouseButtonPressed(int button) const {
-    if (!m_window) return false;
-    return glfwGetMouseButton(m_window, button) == GLFW_PRESS;
+    return TestMouseBit(m_mouseButtons, button);
+}
+
+void InputSystem::GetSnapshot(Snapshot& out) const {
+    out.keys = m_keys;
+    out.mouseButtons = m_mouseButtons;
+    out.mouseX = m_mouseX;
+    out.mouseY = m_mouseY;
+}
+
+void InputSystem::ApplySnapshot(const Snapshot& snapshot) {
+    // Edges from the difference to the last frame, a snapshot only has down state
+    ++m_frame;
+    m_keysPressed = snapshot.keys & ~m_keys;
+    m_keysReleased = m_keys & ~snapshot.keys;
+    m_keys = snapshot.keys;
+    m_mousePressed = static_cast<uint8_t>(snapshot.mouseButtons & ~m_mouseButtons);
+    m_mouseReleased = static_cast<uint8_t>(m_mouseButtons & ~snapshot.mouseButtons);
+    m_mouseButtons = snapshot.mouseButtons;
+    m_scroll = glm::vec2(0.0f);
+
+    // Live input doesn't count while replaying
+    m_pendingEvents.clear();
+    m_frameEvents.clear();
+
+    m_lastMouseX = m_mouseX;
+    m_lastMouseY = m_mouseY;
+    m_mouseX = snapshot.mouseX;
+    m_mouseY = snapshot.mouseY;
+    m_firstMouse = false;
 }
 
 void InputSystem::Shutdown() {
     if (!m_initialized) return;
 
+    RemoveCallbacks();
     m_window = nullptr;
     m_initialized = false;
 
     BS_INFO(LogCategory::INPUT, "InputSystem shut down");
 }
 
+void InputSystem::InstallCallbacks() {
+    // Still hooked from an earlier InputSystem that something chained on top of, just take the events over
+    auto it = s_hooks.find(m_window);
+    if (it != s_hooks.end()) {
+        it->second.input = this;
+        return;
+    }
+
+    WindowHooks& hooks = s_hooks[m_window];
+    hooks.input = this;
+    hooks.key = glfwSetKeyCallback(m_window, OnKey);
+    hooks.mouseButton = glfwSetMouseButtonCallback(m_window, OnMouseButton);
+    hooks.cursorPos = glfwSetCursorPosCallback(m_window, OnCursorPos);
+    hooks.scroll = glfwSetScrollCallback(m_window, OnScroll);
+}
+
+void InputSystem::RemoveCallbacks() {
+    auto it = s_hooks.find(m_window);
+    if (it == s_hooks.end()) {
+        return;
+    }
+
+    WindowHooks& hooks = it->second;
+    bool restored = RestoreCallback(m_window, glfwSetKeyCallback, &OnKey, hooks.key);
+    restored &= RestoreCallback(m_window, glfwSetMouseButtonCallback, &OnMouseButton, hooks.mouseButton);
+    restored &= RestoreCallback(m_window, glfwSetCursorPosCallback, &OnCursorPos, hooks.cursorPos);
+    restored &= RestoreCallback(m_window, glfwSetScrollCallback, &OnScroll, hooks.scroll);
+    if (restored) {
+        s_hooks.erase(it);
+    } else {
+        hooks.input = nullptr;  // Forward only from now on
+    }
+}
+
+void InputSystem::OnKey(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    auto it = s_hooks.find(window);
+    if (it == s_hooks.end()) {
+        return;
+    }
+    if (it->second.input && action != GLFW_REPEAT) {
+        InputEvent event;
+        event.type = InputEvent::Type::Key;
+        event.pressed = action == GLFW_PRESS;
+        event.code = key;
+        it->second.input->m_pendingEvents.push_back(event);
+    }
+    if (it->second.key) {
+        it->second.key(window, key, scancode, action, mods);
+    }
+}
+
+void InputSystem::OnMouseButton(GLFWwindow* window, int button, int action, int mods) {
+    auto it = s_hooks.find(window);
+    if (it == s_hooks.end()) {
+        return;
+    }
+    if (it->second.input) {
+        InputEvent event;
+        event.type = InputEvent::Type::MouseButton;
+        event.pressed = action == GLFW_PRESS;
+        event.code = button;
+        it->second.input->m_pendingEvents.push_back(event);
+    }
+    if (it->second.mouseButton) {
+        it->second.mouseButton(window, button, action, mods);
+    }
+}
+
+void InputSystem::OnCursorPos(GLFWwindow* window, double x, double y) {
+    auto it = s_hooks.find(window);
+    if (it == s_hooks.end()) {
+        return;
+    }
+    // Dozens per frame and only the last one matters, no point queueing them
+    if (it->second.input) {
+        it->second.input->m_cursorX = x;
+        it->second.input->m_cursorY = y;
+    }
+    if (it->second.cursorPos) {
+        it->second.cursorPos(window, x, y);
+    }
+}
+
+void InputSystem::OnScroll(GLFWwindow* window, double x, double y) {
+    auto it = s_hooks.find(window);
+    if (it == s_hooks.end()) {
+        return;
+    }
+    if (it->second.input) {
+        InputEvent event;
+        event.type = InputEvent::Type::Scroll;
+        event.scroll = glm::vec2(static_cast<float>(x), static_cast<float>(y));
+        it->second.input->m_pendingEvents.push_back(event);
+    }
+    if (it->second.scroll) {
+        it->second.scroll(window, x, y);
+    }
+}
+
 } // namespace Blacksite
@@ -0,0 +1,279 @@
+#include "blacksite/core/JobSystem.h"
+#include <algorithm>
+#include <string>
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+
+namespace Blacksite {
+
+std::atomic<JobSystem*> JobSystem::s_current{nullptr};
+
+namespace {
+
+// Which pool the current thread works for, so Run from inside a job lands on its own deque
+thread_local const JobSystem* t_owner = nullptr;
+thread_local int t_workerIndex = -1;
+
+std::atomic<bool> s_fallbackMade{false};  // Get had to make its own pool before there was a current one
+std::atomic<bool> s_retired{false};       // A current pool was there and is gone again
+
+int ResolveWorkerCount(int workerThreads) {
+    if (workerThreads < 0) {
+        workerThreads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    }
+    return std::max(workerThreads, 1);
+}
+
+}  // namespace
+
+JobSystem& JobSystem::Get() {
+    if (JobSystem* current = s_current.load(std::memory_order_acquire)) {
+        return *current;
+    }
+
+    // Shutting down (or static destructors) - don't start a whole new set of threads for stragglers,
+    // their jobs run right where they're queued
+    if (s_retired.load(std::memory_order_acquire)) {
+        static JobSystem inlineJobs(0, false);
+        return inlineJobs;
+    }
+
+    // No Engine (yet). Never made current, so an Engine pool made later still takes over.
+    s_fallbackMade.store(true, std::memory_order_relaxed);
+    static JobSystem fallback(ResolveWorkerCount(-1), false);
+    return fallback;
+}
+
+JobSystem::JobSystem(int workerThreads) : JobSystem(ResolveWorkerCount(workerThreads), true) {}
+
+JobSystem::JobSystem(int workerThreads, bool makeCurrent) {
+    // Every deque exists before any thread can try to steal from it
+    m_workers.reserve(static_cast<size_t>(workerThreads));
+    for (int i = 0; i < workerThreads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (int i = 0; i < workerThreads; ++i) {
+        m_workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+    }
+
+    // First one made is the one Get hands out
+    JobSystem* expected = nullptr;
+    if (makeCurrent && s_current.compare_exchange_strong(expected, this, std::memory_order_acq_rel) &&
+        s_fallbackMade.load(std::memory_order_relaxed)) {
+        BS_WARN(LogCategory::CORE, "JobSystem::Get was used before this pool existed, its fallback pool sits idle");
+    }
+    BS_DEBUG_F(LogCategory::CORE, "JobSystem started with %d worker threads", workerThreads);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_shutdown.store(true, std::memory_order_release);
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+
+    JobSystem* expected = this;
+    if (s_current.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+        s_retired.store(true, std::memory_order_release);
+    }
+}
+
+void JobSystem::Run(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+        job = [this, counter, inner = std::move(job)]() {
+            inner();
+            Finish(*counter);
+        };
+    }
+    Push(std::move(job));
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, Job job, JobCounter* counter) {
+    if (counter) {
+        // Counted from now, not from when it's queued, so a Wait on it can't slip through in between
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+        job = [this, counter, inner = std::move(job)]() {
+            inner();
+            Finish(*counter);
+        };
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (dependency.m_pending.load(std::memory_order_acquire) != 0) {
+            dependency.m_continuations.push_back(std::move(job));
+            return;
+        }
+    }
+    Push(std::move(job));
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    int workerIndex = t_owner == this ? t_workerIndex : -1;
+    while (!counter.IsDone()) {
+        if (!TryRunOne(workerIndex)) {
+            std::this_thread::yield();  // What we wait on is running somewhere else
+        }
+    }
+
+    // Finish may still be handing out continuations under the lock, don't let the counter die under it
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+size_t JobSystem::GetChunkCount(size_t itemCount, size_t minItemsPerChunk) const {
+    if (itemCount == 0) {
+        return 0;
+    }
+
+    minItemsPerChunk = std::max<size_t>(1, minItemsPerChunk);
+    size_t maxUseful = (itemCount + minItemsPerChunk - 1) / minItemsPerChunk;
+
+    // A few chunks per thread so a slow chunk doesn't leave everyone else idle
+    return std::min(maxUseful, GetConcurrency() * 4);
+}
+
+void JobSystem::ParallelFor(size_t itemCount, size_t minItemsPerChunk, const ChunkFunction& fn) {
+    size_t chunkCount = GetChunkCount(itemCount, minItemsPerChunk);
+    if (chunkCount == 0) {
+        return;
+    }
+
+    size_t chunkSize = (itemCount + chunkCount - 1) / chunkCount;
+
+    // Not worth waking anyone up
+    if (chunkCount == 1) {
+        fn(0, 0, itemCount);
+        return;
+    }
+
+    // The caller takes chunk 0 itself, the rest go out as jobs
+    JobCounter counter;
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+        size_t begin = chunk * chunkSize;
+        size_t end = std::min(itemCount, begin + chunkSize);
+        Run([&fn, chunk, begin, end]() {
+            if (begin < end) {
+                fn(chunk, begin, end);
+            }
+        }, &counter);
+    }
+    fn(0, 0, std::min(itemCount, chunkSize));
+    Wait(counter);
+}
+
+void JobSystem::Push(Job job) {
+    if (m_workers.empty()) {
+        job();  // Nobody to hand it to, see Get
+        return;
+    }
+
+    // Counted before it's visible, so a thief can never take m_queued below zero
+    m_queued.fetch_add(1, std::memory_order_release);
+    if (t_owner == this && t_workerIndex >= 0) {
+        Worker& worker = *m_workers[t_workerIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    } else {
+        std::lock_guard<std::mutex> lock(m_sharedMutex);
+        m_sharedJobs.push_back(std::move(job));
+    }
+
+    {
+        // Taking the lock orders this against a worker that just checked m_queued and is about to sleep
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_one();
+}
+
+bool JobSystem::TryPop(int workerIndex, Job& out) {
+    // Own deque from the back - the most recent job, likely still in cache
+    if (workerIndex >= 0) {
+        Worker& worker = *m_workers[workerIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            out = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sharedMutex);
+        if (!m_sharedJobs.empty()) {
+            out = std::move(m_sharedJobs.front());
+            m_sharedJobs.pop_front();
+            return true;
+        }
+    }
+
+    // Steal the oldest job from someone else, starting past ourselves so thieves spread out
+    size_t count = m_workers.size();
+    size_t start = workerIndex >= 0 ? static_cast<size_t>(workerIndex) + 1 : 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (start + i) % count;
+        if (static_cast<int>(victim) == workerIndex) {
+            continue;
+        }
+        Worker& worker = *m_workers[victim];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.jobs.empty()) {
+            out = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::TryRunOne(int workerIndex) {
+    Job job;
+    if (m_queued.load(std::memory_order_acquire) == 0 || !TryPop(workerIndex, job)) {
+        return false;
+    }
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    job();
+    return true;
+}
+
+void JobSystem::Finish(JobCounter& counter) {
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+        if (counter.m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations.swap(counter.m_continuations);
+    }
+
+    for (Job& job : continuations) {
+        Push(std::move(job));
+    }
+}
+
+void JobSystem::WorkerLoop(int index) {
+    Profiler::SetThreadName("Job Worker " + std::to_string(index));
+    t_owner = this;
+    t_workerIndex = index;
+
+    while (true) {
+        if (TryRunOne(index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wake.wait(lock, [this] {
+            return m_shutdown.load(std::memory_order_acquire) || m_queued.load(std::memory_order_acquire) > 0;
+        });
+        if (m_shutdown.load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+}  // namespace Blacksite
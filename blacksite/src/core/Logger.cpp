@@ -1,4 +1,7 @@
 #include "blacksite/core/Logger.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
 
 #ifdef _WIN32
@@ -28,24 +31,45 @@ void Logger::Initialize() {
 #else
     m_colorOutput = isatty(fileno(stdout));
 #endif
+
+    // BLACKSITE_LOG_SYNC=1 keeps every line written before Log returns, handy when chasing a crash
+    const char* sync = std::getenv("BLACKSITE_LOG_SYNC");
+    SetAsync(!(sync && sync[0] != '\0' && std::strcmp(sync, "0") != 0));
 }
 
 void Logger::Shutdown() {
+    StopWriter();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
     if (m_logFile.is_open()) {
         m_logFile.close();
     }
 }
 
 void Logger::Log(LogLevel level, LogCategory category, const std::string& message,
-                const std::string& file, int line) {
-    // Check level filtering
-    if (level < m_level) return;
-
-    // Check category filtering
-    if (!m_categoryFilter[(int)category]) return;
+                const char* file, int line) {
+    if (!ShouldLog(level, category)) return;
+
+    // Only errors print where they came from, no point copying the path for the rest
+    LogEntry entry(level, category, message, level >= LogLevel::ERROR && file ? file : "", line);
+
+    // Counted before m_async is read, so StopWriter can wait for a push that still saw the writer running
+    m_activePushes.fetch_add(1, std::memory_order_seq_cst);
+    if (m_async.load(std::memory_order_seq_cst)) {
+        bool pushed = TryPush(std::move(entry));
+        if (!pushed) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            m_droppedTotal.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_activePushes.fetch_sub(1, std::memory_order_release);
+        if (pushed && level == LogLevel::FATAL) {
+            Flush();  // We're probably about to go down, make sure this one makes it out
+        }
+        return;
+    }
+    m_activePushes.fetch_sub(1, std::memory_order_relaxed);
 
-    // Create log entry
-    LogEntry entry(level, category, message, file, line);
+    entry.timestamp = FormatTimestamp(entry.time);
 
     std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -75,6 +99,215 @@ void Logger::SetLogFile(const std::string& filename) {
     }
 }
 
+void Logger::SetAsync(bool enabled) {
+    if (enabled) {
+        StartWriter();
+    } else {
+        StopWriter();
+    }
+}
+
+void Logger::Flush() {
+    if (m_async.load(std::memory_order_acquire)) {
+        size_t target = m_enqueuePos.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+        m_flushRequested = true;
+        m_writerWake.notify_one();
+        m_writerDone.wait(lock, [this, target] { return m_writtenPos >= target || m_stopWriter; });
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_logFile.is_open()) {
+        m_logFile.flush();
+    }
+    std::cout.flush();
+}
+
+bool Logger::TryPush(LogEntry&& entry) {
+    // Claim a slot by bumping the enqueue position, the slot's sequence tells us if the writer is done with it
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = m_ring[pos & (RING_SIZE - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.entry = std::move(entry);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                if ((pos & (RING_SIZE / 4 - 1)) == 0) {
+                    m_writerWake.notify_one();  // Bursts shouldn't have to wait out the writer's nap
+                }
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full, the writer hasn't got to this slot from last time around
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t Logger::PopBatch(std::vector<LogEntry>& batch) {
+    size_t count = 0;
+    while (true) {
+        Slot& slot = m_ring[m_dequeuePos & (RING_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePos + 1) {
+            break;  // Empty, or a producer has claimed it but not finished writing
+        }
+        batch.push_back(std::move(slot.entry));
+        slot.sequence.store(m_dequeuePos + RING_SIZE, std::memory_order_release);
+        ++m_dequeuePos;
+        ++count;
+    }
+    return count;
+}
+
+void Logger::WriteBatch(std::vector<LogEntry>& batch) {
+    std::string fileText;
+    std::string consoleText;
+    bool consoleIsErr = false;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool toFile = m_fileOutput && m_logFile.is_open();
+
+    for (LogEntry& entry : batch) {
+        entry.timestamp = FormatTimestamp(entry.time);
+
+        if (toFile) {
+            fileText += FormatLine(entry, false);
+        }
+
+        if (m_consoleOutput) {
+            // Same split as the sync path, and keep the order when a batch switches between the two
+            bool isErr = entry.level >= LogLevel::WARN;
+            if (isErr != consoleIsErr && !consoleText.empty()) {
+                (consoleIsErr ? std::cerr : std::cout) << consoleText;
+                consoleText.clear();
+            }
+            consoleIsErr = isErr;
+            consoleText += FormatLine(entry, m_colorOutput);
+        }
+
+        if (m_editorOutput) {
+            AddToHistory(entry);
+        }
+    }
+
+    if (!consoleText.empty()) {
+        (consoleIsErr ? std::cerr : std::cout) << consoleText;
+    }
+    std::cout.flush();
+
+    if (!fileText.empty()) {
+        m_logFile.write(fileText.data(), static_cast<std::streamsize>(fileText.size()));
+        m_logFile.flush();  // Once per batch instead of once per line
+    }
+}
+
+void Logger::StartWriter() {
+    if (m_writer.joinable()) return;
+
+    if (!m_ring) {
+        m_ring.reset(new Slot[RING_SIZE]);
+        for (size_t i = 0; i < RING_SIZE; ++i) {
+            m_ring[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueuePos.store(0, std::memory_order_relaxed);
+        m_dequeuePos = 0;
+    }
+
+    m_stopWriter = false;
+    m_writer = std::thread(&Logger::WriterLoop, this);
+    m_async.store(true, std::memory_order_release);
+}
+
+void Logger::StopWriter() {
+    if (!m_writer.joinable()) return;
+
+    // New entries go the sync route from here, the writer drains what's already queued before it exits.
+    // A Log that read m_async just before the store may still be filling its slot - wait for it to land,
+    // otherwise the writer can do its last pass first and leave that entry stuck in the ring.
+    m_async.store(false, std::memory_order_seq_cst);
+    while (m_activePushes.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_stopWriter = true;
+    }
+    m_writerWake.notify_one();
+    m_writer.join();
+}
+
+void Logger::WriterLoop() {
+    std::vector<LogEntry> batch;
+    batch.reserve(256);
+
+    while (true) {
+        batch.clear();
+        PopBatch(batch);
+
+        uint64_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            batch.emplace_back(LogLevel::WARN, LogCategory::CORE,
+                               "Logger: Dropped " + std::to_string(dropped) + " messages, the queue was full");
+        }
+
+        if (!batch.empty()) {
+            WriteBatch(batch);
+        }
+
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+        m_writtenPos = m_dequeuePos;
+        m_writerDone.notify_all();
+
+        if (!batch.empty()) continue;  // More probably came in while we were writing
+        if (m_stopWriter) break;
+
+        m_flushRequested = false;
+        m_writerWake.wait_for(lock, WRITER_INTERVAL, [this] { return m_stopWriter || m_flushRequested; });
+    }
+}
+
+std::string Logger::FormatTimestamp(std::chrono::system_clock::time_point time) const {
+    auto time_t = std::chrono::system_clock::to_time_t(time);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) % 1000;
+
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time_t);
+#else
+    localtime_r(&time_t, &local);
+#endif
+
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d.%03d", local.tm_hour, local.tm_min, local.tm_sec,
+             static_cast<int>(ms.count()));
+    return buffer;
+}
+
+std::string Logger::FormatLine(const LogEntry& entry, bool color) const {
+    std::string colorCode = color ? ColorToAnsi(GetLevelColor(entry.level)) : "";
+    std::string resetCode = color ? ColorToAnsi(LogColor::RESET) : "";
+
+    std::string line = colorCode + "[" + entry.timestamp + "] [" + LevelToString(entry.level) + "] [" +
+                       CategoryToString(entry.category) + "] " + resetCode + entry.message;
+
+    // Add file/line info for ERROR and FATAL
+    if (entry.level >= LogLevel::ERROR && !entry.file.empty()) {
+        // Extract just the filename from the full path
+        std::string filename = entry.file;
+        size_t lastSlash = filename.find_last_of("/\\");
+        if (lastSlash != std::string::npos) {
+            filename = filename.substr(lastSlash + 1);
+        }
+        line += colorCode + " (" + filename + ":" + std::to_string(entry.line) + ")" + resetCode;
+    }
+
+    line += '\n';
+    return line;
+}
+
 std::string Logger::LevelToString(LogLevel level) const {
     switch (level) {
         case LogLevel::TRACE: return "TRACE";
@@ -120,37 +353,14 @@ std::string Logger::ColorToAnsi(LogColor color) const {
 }
 
 void Logger::WriteToConsole(const LogEntry& entry) {
-    std::string colorCode = ColorToAnsi(GetLevelColor(entry.level));
-    std::string resetCode = ColorToAnsi(LogColor::RESET);
-
-    std::ostringstream oss;
-    oss << colorCode
-        << "[" << entry.timestamp << "] "
-        << "[" << LevelToString(entry.level) << "] "
-        << "[" << CategoryToString(entry.category) << "] "
-        << resetCode
-        << entry.message;
-
-    // Add file/line info for ERROR and FATAL
-    if (entry.level >= LogLevel::ERROR && !entry.file.empty()) {
-        // Extract just the filename from the full path
-        std::string filename = entry.file;
-        size_t lastSlash = filename.find_last_of("/\\");
-        if (lastSlash != std::string::npos) {
-            filename = filename.substr(lastSlash + 1);
-        }
-
-        oss << colorCode << " (" << filename << ":" << entry.line << ")" << resetCode;
-    }
-
-    oss << std::endl;
+    std::string line = FormatLine(entry, m_colorOutput);
 
     // Output to stderr for warnings and errors, stdout for everything else
     if (entry.level >= LogLevel::WARN) {
-        std::cerr << oss.str();
+        std::cerr << line;
         std::cerr.flush();
     } else {
-        std::cout << oss.str();
+        std::cout << line;
         std::cout.flush();
     }
 }
@@ -158,32 +368,33 @@ void Logger::WriteToConsole(const LogEntry& entry) {
 void Logger::WriteToFile(const LogEntry& entry) {
     if (!m_logFile.is_open()) return;
 
-    m_logFile << "[" << entry.timestamp << "] "
-              << "[" << LevelToString(entry.level) << "] "
-              << "[" << CategoryToString(entry.category) << "] "
-              << entry.message;
+    m_logFile << FormatLine(entry, false);
+    m_logFile.flush();
+}
 
-    // Add file/line info for ERROR and FATAL
-    if (entry.level >= LogLevel::ERROR && !entry.file.empty()) {
-        std::string filename = entry.file;
-        size_t lastSlash = filename.find_last_of("/\\");
-        if (lastSlash != std::string::npos) {
-            filename = filename.substr(lastSlash + 1);
-        }
-        m_logFile << " (" << filename << ":" << entry.line << ")";
+void Logger::AddToHistory(const LogEntry& entry) {
+    // Overwrites the oldest slot once full, keeps the strings' capacity around too
+    m_logHistory[m_historyNext % HISTORY_SIZE] = entry;
+    ++m_historyNext;
+    if (m_historyNext - m_historyFirst > HISTORY_SIZE) {
+        m_historyFirst = m_historyNext - HISTORY_SIZE;
     }
+}
 
-    m_logFile << std::endl;
-    m_logFile.flush();
+uint64_t Logger::GetHistorySequence() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_historyNext;
 }
 
-void Logger::AddToHistory(const LogEntry& entry) {
-    m_logHistory.push_back(entry);
+uint64_t Logger::GetOldestHistorySequence() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_historyFirst;
+}
 
-    // Keep history size reasonable (last 1000 entries)
-    if (m_logHistory.size() > 1000) {
-        m_logHistory.erase(m_logHistory.begin());
-    }
+std::vector<LogEntry> Logger::GetLogHistory() {
+    std::vector<LogEntry> history;
+    VisitHistory(0, [&history](uint64_t, const LogEntry& entry) { history.push_back(entry); });
+    return history;
 }
 
 } // namespace Blacksite
@@ -0,0 +1,128 @@
+#include "blacksite/core/MemoryTracker.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace Blacksite {
+
+MemoryTracker::Counters MemoryTracker::s_counters[static_cast<size_t>(MemoryTag::Count)];
+
+namespace {
+
+// Sits right in front of the block we hand out
+struct alignas(16) BlockHeader {
+    void* base;  // What malloc returned
+    size_t size;
+    size_t alignment;
+    MemoryTag tag;
+};
+
+BlockHeader* HeaderOf(void* block) {
+    return static_cast<BlockHeader*>(block) - 1;
+}
+
+}  // namespace
+
+void* MemoryTracker::Allocate(size_t size, MemoryTag tag, size_t alignment) {
+    alignment = std::max(alignment, alignof(BlockHeader));
+
+    // Room for the header plus however far we have to move to line the block up
+    void* base = std::malloc(sizeof(BlockHeader) + alignment + size);
+    if (!base) {
+        return nullptr;
+    }
+
+    uintptr_t first = reinterpret_cast<uintptr_t>(base) + sizeof(BlockHeader);
+    uintptr_t aligned = (first + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    void* block = reinterpret_cast<void*>(aligned);
+
+    BlockHeader* header = HeaderOf(block);
+    header->base = base;
+    header->size = size;
+    header->alignment = alignment;
+    header->tag = tag;
+
+    Counters& counters = s_counters[static_cast<size_t>(tag)];
+    AddBytes(counters, static_cast<int64_t>(size));
+    counters.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+void* MemoryTracker::Reallocate(void* block, size_t newSize, MemoryTag tag) {
+    if (!block) {
+        return Allocate(newSize, tag);
+    }
+
+    const BlockHeader& header = *HeaderOf(block);
+    void* resized = Allocate(newSize, header.tag, header.alignment);
+    if (resized) {
+        std::memcpy(resized, block, std::min(header.size, newSize));
+        Free(block);
+    }
+    return resized;
+}
+
+void MemoryTracker::Free(void* block) {
+    if (!block) {
+        return;
+    }
+
+    BlockHeader* header = HeaderOf(block);
+    Counters& counters = s_counters[static_cast<size_t>(header->tag)];
+    counters.liveBytes.fetch_sub(static_cast<int64_t>(header->size), std::memory_order_relaxed);
+    counters.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    std::free(header->base);
+}
+
+void MemoryTracker::Adjust(MemoryTag tag, int64_t bytes) {
+    AddBytes(s_counters[static_cast<size_t>(tag)], bytes);
+}
+
+void MemoryTracker::AddBytes(Counters& counters, int64_t bytes) {
+    int64_t live = counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    // Racing updates can lose a peak by a hair, good enough for a stats panel
+    int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+MemoryStats MemoryTracker::GetStats(MemoryTag tag) {
+    const Counters& counters = s_counters[static_cast<size_t>(tag)];
+    MemoryStats stats;
+    stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    stats.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+    stats.totalAllocations = counters.totalAllocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MemoryTracker::ResetPeaks() {
+    for (Counters& counters : s_counters) {
+        counters.peakBytes.store(counters.liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+const char* MemoryTracker::GetTagName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::Physics:
+            return "Physics";
+        case MemoryTag::Entities:
+            return "Entities";
+        case MemoryTag::FrameArena:
+            return "Frame Arena";
+        case MemoryTag::Meshes:
+            return "Meshes";
+        case MemoryTag::RenderTargets:
+            return "Render Targets";
+        case MemoryTag::GpuBuffers:
+            return "GPU Buffers";
+        case MemoryTag::Textures:
+            return "Textures";
+        default:
+            return "Unknown";
+    }
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,207 @@
+#include "blacksite/core/Profiler.h"
+#include "blacksite/core/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef JPH_EXTERNAL_PROFILE
+#include "blacksite/physics/JoltConfig.h"
+#include <Jolt/Core/Profiler.h>
+#endif
+
+namespace Blacksite {
+
+std::atomic<bool> Profiler::s_enabled{false};
+
+namespace {
+
+// Only the owning thread writes, head is published with release so the exporter sees whole events
+struct ThreadBuffer {
+    uint32_t threadId = 0;
+    std::string name;
+    std::vector<ProfileEvent> events;
+    std::atomic<uint64_t> head{0};
+};
+
+// Buffers are never freed, a thread that has exited still shows up in the next export
+std::mutex s_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer* GetThreadBuffer() {
+    if (t_buffer) {
+        return t_buffer;
+    }
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->events.resize(Profiler::RING_SIZE);
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    buffer->threadId = static_cast<uint32_t>(s_buffers.size());
+    buffer->name = buffer->threadId == 0 ? "Main" : "Thread " + std::to_string(buffer->threadId);
+    t_buffer = buffer.get();
+    s_buffers.push_back(std::move(buffer));
+    return t_buffer;
+}
+
+void WriteJsonString(std::ofstream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+#ifdef JPH_EXTERNAL_PROFILE
+// Jolt gives us 64 bytes per measurement to keep our state in
+struct JoltMeasurement {
+    const char* name;
+    uint64_t startNs;
+};
+static_assert(sizeof(JoltMeasurement) <= 64, "Jolt's per-measurement user data is 64 bytes");
+
+void JoltProfileStart(const char* name, JPH::uint32 color, JPH::uint8* userData) {
+    (void)color;
+    JoltMeasurement measurement{name, Profiler::IsEnabled() ? Profiler::Now() : 0};
+    std::memcpy(userData, &measurement, sizeof(measurement));
+}
+
+void JoltProfileEnd(JPH::uint8* userData) {
+    JoltMeasurement measurement;
+    std::memcpy(&measurement, userData, sizeof(measurement));
+    if (measurement.startNs != 0) {
+        Profiler::Record(measurement.name, measurement.startNs, Profiler::Now());
+    }
+}
+#endif
+
+}  // namespace
+
+void Profiler::Initialize() {
+    GetThreadBuffer();  // So whoever initializes gets thread id 0
+
+    const char* env = std::getenv("BLACKSITE_PROFILE");
+    if (env && env[0] != '\0' && std::strcmp(env, "0") != 0) {
+        SetEnabled(true);
+        BS_INFO(LogCategory::CORE, "CPU profiler recording (BLACKSITE_PROFILE)");
+    }
+
+#ifdef JPH_EXTERNAL_PROFILE
+    JPH::ProfileStartMeasurement = JoltProfileStart;
+    JPH::ProfileEndMeasurement = JoltProfileEnd;
+#endif
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    buffer->name = name;
+}
+
+uint64_t Profiler::Now() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+void Profiler::Record(const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    uint64_t index = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[index % RING_SIZE] = ProfileEvent{name, startNs, endNs};
+    buffer->head.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        BS_ERROR_F(LogCategory::CORE, "Profiler: Can't write %s", path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+
+    // Chrome wants microseconds, starting near zero reads better than steady_clock's epoch
+    uint64_t origin = UINT64_MAX;
+    for (const auto& buffer : s_buffers) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = head > RING_SIZE ? head - RING_SIZE : 0;
+        if (head > first) {
+            origin = std::min(origin, buffer->events[first % RING_SIZE].startNs);
+        }
+    }
+    if (origin == UINT64_MAX) {
+        origin = 0;
+    }
+
+    size_t eventCount = 0;
+    bool firstEntry = true;
+    out << "{\"traceEvents\":[\n";
+    for (const auto& buffer : s_buffers) {
+        out << (firstEntry ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+            << buffer->threadId << ",\"args\":{\"name\":";
+        WriteJsonString(out, buffer->name.c_str());
+        out << "}}";
+        firstEntry = false;
+
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = head > RING_SIZE ? head - RING_SIZE : 0;
+        for (uint64_t i = first; i < head; ++i) {
+            const ProfileEvent& event = buffer->events[i % RING_SIZE];
+            if (!event.name || event.startNs < origin) {
+                continue;
+            }
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"name\":";
+            WriteJsonString(out, event.name);
+            out << ",\"ts\":" << (event.startNs - origin) / 1000.0 << ",\"dur\":" << (event.endNs - event.startNs) / 1000.0
+                << "}";
+            ++eventCount;
+        }
+    }
+    out << "\n]}\n";
+
+    BS_INFO_F(LogCategory::CORE, "Profiler: Wrote %zu events from %zu threads to %s", eventCount, s_buffers.size(),
+              path.c_str());
+    return true;
+}
+
+void Profiler::Clear() {
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    for (const auto& buffer : s_buffers) {
+        buffer->head.store(0, std::memory_order_release);
+    }
+}
+
+std::vector<ProfileScopeTotal> Profiler::GetScopeTotals() {
+    std::vector<ProfileScopeTotal> totals;
+    std::unordered_map<std::string, size_t> byName;  // Same literal can have different addresses across TUs
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    for (const auto& buffer : s_buffers) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = head > RING_SIZE ? head - RING_SIZE : 0;
+        for (uint64_t i = first; i < head; ++i) {
+            const ProfileEvent& event = buffer->events[i % RING_SIZE];
+            if (!event.name) {
+                continue;
+            }
+            auto [it, inserted] = byName.try_emplace(event.name, totals.size());
+            if (inserted) {
+                totals.push_back(ProfileScopeTotal{event.name, 0, 0});
+            }
+            ProfileScopeTotal& total = totals[it->second];
+            total.totalNs += event.endNs - event.startNs;
+            ++total.count;
+        }
+    }
+    return totals;
+}
+
+}  // namespace Blacksite
@@ -1,5 +1,7 @@
 #include "blacksite/core/Window.h"
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/GLDebug.h"
 #include <GLFW/glfw3.h>
 
 namespace Blacksite {
@@ -10,7 +12,7 @@ Window::~Window() {
     Shutdown();
 }
 
-bool Window::Initialize(int width, int height, const std::string& title) {
+bool Window::Initialize(int width, int height, const std::string& title, bool visible) {
     m_width = width;
     m_height = height;
 
@@ -24,6 +26,8 @@ bool Window::Initialize(int width, int height, const std::string& title) {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLDebug::IsRequestedAtStartup() ? GLFW_TRUE : GLFW_FALSE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
     // --- Create window ---
     m_window = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
@@ -34,6 +38,9 @@ bool Window::Initialize(int width, int height, const std::string& title) {
     }
 
     glfwMakeContextCurrent(m_window);  // Required before glewInit()
+    if (!visible) {
+        glfwSwapInterval(0);  // Nobody is looking, don't wait on the display
+    }
 
     // --- Load OpenGL functions via GLEW ---
     if (glewInit() != GLEW_OK) {
@@ -41,6 +48,8 @@ bool Window::Initialize(int width, int height, const std::string& title) {
         return false;  // No recovery—OpenGL functions won't be available
     }
 
+    GLDebug::Initialize();  // Debug builds only, unless asked for
+
     // --- Setup default GL state ---
     glViewport(0, 0, width, height);  // Viewport = full window
     glEnable(GL_DEPTH_TEST);          // Enable Z-buffering for 3D rendering
@@ -62,6 +71,7 @@ bool Window::ShouldClose() const {
 
 void Window::SwapBuffers() {
     glfwSwapBuffers(m_window);  // Push back buffer to front
+    BS_PROFILE_FRAME();
 }
 
 void Window::PollEvents() {
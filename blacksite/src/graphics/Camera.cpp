@@ -43,4 +43,8 @@ glm::mat4 Camera::GetProjectionMatrix() const {
     // Convert our FOV from degrees to radians
     return glm::perspective(glm::radians(m_fov), m_aspect, m_nearPlane, m_farPlane);
 }
+
+Frustum Camera::GetFrustum() const {
+    return Frustum::FromMatrix(GetProjectionMatrix() * GetViewMatrix());
+}
 }  // namespace Blacksite
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "blacksite/graphics/DebugDraw.h"
+#include "blacksite/core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Blacksite {
+
+namespace {
+
+constexpr float PI = 3.14159265359f;
+constexpr float TWO_PI = PI * 2.0f;
+
+}  // namespace
+
+bool DebugDraw::Initialize() {
+    Shutdown();
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+
+    // The buffer gets attached per Flush (ring or m_vbo), only the enables live here
+    glBindVertexArray(m_vao);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    return true;
+}
+
+void DebugDraw::Shutdown() {
+    if (m_vao != 0) {
+        glDeleteVertexArrays(1, &m_vao);
+        m_vao = 0;
+    }
+    if (m_vbo != 0) {
+        glDeleteBuffers(1, &m_vbo);
+        m_vbo = 0;
+    }
+    m_vertices.clear();
+}
+
+void DebugDraw::Line(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color) {
+    Push(from, to, PackColor(color));
+}
+
+void DebugDraw::Box(const glm::mat4& transform, const glm::vec3& halfExtents, const glm::vec3& color) {
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 local((i & 1) ? halfExtents.x : -halfExtents.x, (i & 2) ? halfExtents.y : -halfExtents.y,
+                        (i & 4) ? halfExtents.z : -halfExtents.z);
+        corners[i] = glm::vec3(transform * glm::vec4(local, 1.0f));
+    }
+
+    // Corner index bits are x/y/z, every edge flips exactly one of them
+    uint32_t packed = PackColor(color);
+    for (int i = 0; i < 8; ++i) {
+        for (int bit = 1; bit < 8; bit <<= 1) {
+            if ((i & bit) == 0) {
+                Push(corners[i], corners[i | bit], packed);
+            }
+        }
+    }
+}
+
+void DebugDraw::Sphere(const glm::vec3& center, float radius, const glm::vec3& color) {
+    uint32_t packed = PackColor(color);
+    const glm::vec3 x(1.0f, 0.0f, 0.0f);
+    const glm::vec3 y(0.0f, 1.0f, 0.0f);
+    const glm::vec3 z(0.0f, 0.0f, 1.0f);
+    Arc(center, x, y, radius, 0.0f, TWO_PI, CIRCLE_SEGMENTS, packed);
+    Arc(center, y, z, radius, 0.0f, TWO_PI, CIRCLE_SEGMENTS, packed);
+    Arc(center, z, x, radius, 0.0f, TWO_PI, CIRCLE_SEGMENTS, packed);
+}
+
+void DebugDraw::Capsule(const glm::mat4& transform, float radius, float halfHeight, const glm::vec3& color) {
+    uint32_t packed = PackColor(color);
+    glm::vec3 center(transform[3]);
+    glm::vec3 right = glm::normalize(glm::vec3(transform[0]));
+    glm::vec3 up = glm::normalize(glm::vec3(transform[1]));
+    glm::vec3 forward = glm::normalize(glm::vec3(transform[2]));
+    glm::vec3 top = center + up * halfHeight;
+    glm::vec3 bottom = center - up * halfHeight;
+
+    // Rings where the caps meet the cylinder, four lines along the side
+    Arc(top, right, forward, radius, 0.0f, TWO_PI, CIRCLE_SEGMENTS, packed);
+    Arc(bottom, right, forward, radius, 0.0f, TWO_PI, CIRCLE_SEGMENTS, packed);
+    for (const glm::vec3& side : {right, -right, forward, -forward}) {
+        Push(top + side * radius, bottom + side * radius, packed);
+    }
+
+    // Half circles over each cap, in both vertical planes
+    const int capSegments = CIRCLE_SEGMENTS / 2;
+    Arc(top, right, up, radius, 0.0f, PI, capSegments, packed);
+    Arc(top, forward, up, radius, 0.0f, PI, capSegments, packed);
+    Arc(bottom, right, up, radius, PI, TWO_PI, capSegments, packed);
+    Arc(bottom, forward, up, radius, PI, TWO_PI, capSegments, packed);
+}
+
+void DebugDraw::Circle(const glm::vec3& center, const glm::vec3& axisU, const glm::vec3& axisV, float radius,
+                       const glm::vec3& color) {
+    Arc(center, axisU, axisV, radius, 0.0f, TWO_PI, CIRCLE_SEGMENTS, PackColor(color));
+}
+
+void DebugDraw::Flush(DynamicBufferRing& ring) {
+    if (m_vertices.empty() || m_vao == 0) {
+        m_vertices.clear();
+        return;
+    }
+
+    size_t bytes = m_vertices.size() * sizeof(DebugVertex);
+    GLuint buffer = m_vbo;
+    GLint first = 0;
+    DynamicBufferRing::Allocation upload = ring.Allocate(bytes, sizeof(DebugVertex));
+    if (upload.IsValid()) {
+        std::memcpy(upload.data, m_vertices.data(), bytes);
+        buffer = ring.GetBuffer();
+        first = static_cast<GLint>(upload.offset / sizeof(DebugVertex));
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), m_vertices.data(), GL_STREAM_DRAW);
+    }
+
+    // Re-pointed every time, the ring's buffer changes when it grows
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, position));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, color));
+    glDrawArrays(GL_LINES, first, static_cast<GLsizei>(m_vertices.size()));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_vertices.clear();
+    m_overflowWarned = false;
+}
+
+uint32_t DebugDraw::PackColor(const glm::vec3& color) {
+    auto channel = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return channel(color.r) | (channel(color.g) << 8) | (channel(color.b) << 16) | (255u << 24);
+}
+
+void DebugDraw::Arc(const glm::vec3& center, const glm::vec3& axisU, const glm::vec3& axisV, float radius,
+                    float fromAngle, float toAngle, int segments, uint32_t color) {
+    float step = (toAngle - fromAngle) / static_cast<float>(segments);
+    glm::vec3 previous = center + (axisU * std::cos(fromAngle) + axisV * std::sin(fromAngle)) * radius;
+    for (int i = 1; i <= segments; ++i) {
+        float angle = fromAngle + step * static_cast<float>(i);
+        glm::vec3 point = center + (axisU * std::cos(angle) + axisV * std::sin(angle)) * radius;
+        Push(previous, point, color);
+        previous = point;
+    }
+}
+
+void DebugDraw::Push(const glm::vec3& from, const glm::vec3& to, uint32_t color) {
+    if (m_vertices.size() >= MAX_LINES * 2) {
+        if (!m_overflowWarned) {
+            BS_WARN_F(LogCategory::RENDERER, "More than %zu debug lines this frame, dropping the rest", MAX_LINES);
+            m_overflowWarned = true;
+        }
+        return;
+    }
+    m_vertices.push_back({from, color});
+    m_vertices.push_back({to, color});
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,149 @@
+#include "blacksite/graphics/DynamicBufferRing.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+
+#include <algorithm>
+
+namespace Blacksite {
+
+bool DynamicBufferRing::IsSupported() {
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+bool DynamicBufferRing::Initialize(size_t sliceSize) {
+    Shutdown();
+    if (!IsSupported()) {
+        return false;
+    }
+
+    GLint uniformAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+    m_uniformAlignment = uniformAlignment > 0 ? static_cast<size_t>(uniformAlignment) : 256;
+    return CreateBuffer(sliceSize);
+}
+
+void DynamicBufferRing::Shutdown() {
+    for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+        WaitForFence(i);
+    }
+    DestroyBuffer();
+    m_frame = 0;
+    m_used = 0;
+    m_shortfall = 0;
+}
+
+void DynamicBufferRing::BeginFrame() {
+    if (!IsInitialized()) {
+        return;
+    }
+
+    // The mapping can't grow in place, so wait out the other slices and start over bigger
+    if (m_shortfall > 0) {
+        size_t newSize = std::max(m_sliceSize * 2, m_used + m_shortfall);
+        for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+            WaitForFence(i);
+        }
+        DestroyBuffer();
+        m_frame = 0;
+        m_used = 0;
+        m_shortfall = 0;
+        if (!CreateBuffer(newSize)) {
+            return;
+        }
+        BS_DEBUG_F(LogCategory::RENDERER, "Dynamic upload ring grown to %zu KB per frame", newSize / 1024);
+        return;  // Fresh buffer, slice 0 has nothing in flight
+    }
+
+    m_frame = (m_frame + 1) % FRAMES_IN_FLIGHT;
+    m_used = 0;
+    WaitForFence(m_frame);
+}
+
+void DynamicBufferRing::EndFrame() {
+    if (!IsInitialized() || m_fences[m_frame]) {
+        return;
+    }
+    m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+DynamicBufferRing::Allocation DynamicBufferRing::Allocate(size_t bytes, size_t alignment) {
+    if (!IsInitialized() || bytes == 0) {
+        return Allocation{};
+    }
+
+    // Aligned in the whole buffer, not just the slice - baseInstance math depends on that
+    size_t sliceBase = static_cast<size_t>(m_frame) * m_sliceSize;
+    size_t absolute = sliceBase + m_used;
+    size_t aligned = (absolute + alignment - 1) / alignment * alignment;
+    size_t end = aligned - sliceBase + bytes;
+    if (end > m_sliceSize) {
+        m_shortfall += bytes;
+        return Allocation{};
+    }
+
+    m_used = end;
+    return Allocation{m_mapped + aligned, static_cast<GLintptr>(aligned), static_cast<GLsizeiptr>(bytes)};
+}
+
+bool DynamicBufferRing::CreateBuffer(size_t sliceSize) {
+    // Whole slices of 256 bytes, so every slice starts aligned for anything we'd bind
+    sliceSize = (sliceSize + 255) & ~size_t(255);
+
+    // Coherent, so what we write is visible to the GPU without explicit flushes
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(sliceSize * FRAMES_IN_FLIGHT);
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, bytes, nullptr, flags);
+    m_mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bytes, flags));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if (!m_mapped) {
+        BS_ERROR_F(LogCategory::RENDERER, "Failed to map a %zu KB dynamic upload ring", sliceSize / 1024);
+        DestroyBuffer();
+        return false;
+    }
+
+    m_sliceSize = sliceSize;
+    ++m_generation;
+    MemoryTracker::Adjust(MemoryTag::GpuBuffers, static_cast<int64_t>(bytes));
+    return true;
+}
+
+void DynamicBufferRing::DestroyBuffer() {
+    // Only a fully created ring was counted
+    if (m_sliceSize > 0) {
+        MemoryTracker::Adjust(MemoryTag::GpuBuffers, -static_cast<int64_t>(m_sliceSize * FRAMES_IN_FLIGHT));
+    }
+
+    // Deleting a mapped buffer unmaps it too
+    if (m_buffer != 0) {
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_mapped = nullptr;
+    m_sliceSize = 0;
+}
+
+void DynamicBufferRing::WaitForFence(uint32_t frame) {
+    GLsync& fence = m_fences[frame];
+    if (!fence) {
+        return;
+    }
+
+    // Normally long signaled by the time we come back around, the loop is for when the GPU is behind
+    const GLuint64 TIMEOUT_NS = 1000000;  // 1ms per try
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT_NS);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, 0, TIMEOUT_NS);
+    }
+    if (result == GL_WAIT_FAILED) {
+        BS_WARN(LogCategory::RENDERER, "Waiting on a dynamic upload ring fence failed");
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,73 @@
+#include "blacksite/graphics/Frustum.h"
+#include <cmath>
+
+namespace Blacksite {
+
+Frustum Frustum::FromMatrix(const glm::mat4& m) {
+    // Gribb/Hartmann - each plane is the last row +/- one of the others.
+    // glm is column major so "row i" is m[0][i], m[1][i], m[2][i], m[3][i]
+    auto row = [&m](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+    glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    Frustum frustum;
+    frustum.planes[LEFT] = r3 + r0;
+    frustum.planes[RIGHT] = r3 - r0;
+    frustum.planes[BOTTOM] = r3 + r1;
+    frustum.planes[TOP] = r3 - r1;
+    frustum.planes[NEAR_PLANE] = r3 + r2;
+    frustum.planes[FAR_PLANE] = r3 - r2;
+
+    // Normalize so the plane distance is in world units (needed for the sphere radius test)
+    for (glm::vec4& plane : frustum.planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const {
+    for (const glm::vec4& plane : planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::IntersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+    for (const glm::vec4& plane : planes) {
+        // Test the corner furthest along the plane normal, if that one's outside the whole box is
+        glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y,
+                         plane.z >= 0.0f ? max.z : min.z);
+        if (plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Frustum::CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count,
+                          uint8_t* visible) const {
+    // Copy the planes into locals so the compiler knows they can't alias the output
+    float px[COUNT], py[COUNT], pz[COUNT], pw[COUNT];
+    for (int p = 0; p < COUNT; ++p) {
+        px[p] = planes[p].x;
+        py[p] = planes[p].y;
+        pz[p] = planes[p].z;
+        pw[p] = planes[p].w;
+    }
+
+    // No early-outs, branch-free so each lane does the same work
+    for (size_t i = 0; i < count; ++i) {
+        bool inside = true;
+        for (int p = 0; p < COUNT; ++p) {
+            float distance = px[p] * x[i] + py[p] * y[i] + pz[p] * z[i] + pw[p];
+            inside &= distance >= -radius[i];
+        }
+        visible[i] = inside ? 1 : 0;
+    }
+}
+
+}  // namespace Blacksite
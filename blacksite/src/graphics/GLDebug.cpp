@@ -0,0 +1,116 @@
+#include "blacksite/graphics/GLDebug.h"
+#include "blacksite/core/Logger.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace Blacksite {
+
+bool GLDebug::s_enabled = false;
+bool GLDebug::s_debugOutput = false;
+
+namespace {
+
+const char* SourceName(GLenum source) {
+    switch (source) {
+        case GL_DEBUG_SOURCE_API:
+            return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+            return "Window";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER:
+            return "Shader";
+        case GL_DEBUG_SOURCE_THIRD_PARTY:
+            return "ThirdParty";
+        case GL_DEBUG_SOURCE_APPLICATION:
+            return "App";
+        default:
+            return "Other";
+    }
+}
+
+const char* TypeName(GLenum type) {
+    switch (type) {
+        case GL_DEBUG_TYPE_ERROR:
+            return "error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+            return "deprecated";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+            return "undefined";
+        case GL_DEBUG_TYPE_PORTABILITY:
+            return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE:
+            return "performance";
+        default:
+            return "other";
+    }
+}
+
+}  // namespace
+
+bool GLDebug::IsRequestedAtStartup() {
+    const char* env = std::getenv("BLACKSITE_GL_DEBUG");
+    if (env && env[0] != '\0') {
+        return std::strcmp(env, "0") != 0;
+    }
+#ifdef BS_GL_DEBUG
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GLDebug::Initialize() {
+    s_debugOutput = GLEW_VERSION_4_3 || GLEW_KHR_debug;
+    if (s_debugOutput) {
+        // Installed once and left alone, SetEnabled just flips GL_DEBUG_OUTPUT
+        glDebugMessageCallback(OnDebugMessage, nullptr);
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+    }
+    SetEnabled(IsRequestedAtStartup());
+}
+
+void GLDebug::SetEnabled(bool enable) {
+    s_enabled = enable;
+    if (s_debugOutput) {
+        // Synchronous so the message arrives while the offending call is still on the stack
+        if (enable) {
+            glEnable(GL_DEBUG_OUTPUT);
+            glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        } else {
+            glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+            glDisable(GL_DEBUG_OUTPUT);
+        }
+    }
+
+    if (enable) {
+        BS_INFO_F(LogCategory::RENDERER, "GL debug output on (%s)",
+                  s_debugOutput ? "KHR_debug" : "no KHR_debug, polling glGetError at checkpoints");
+    }
+}
+
+void GLDebug::PollErrors(const char* operation) {
+    // Several errors can be queued up, drain them all so the next checkpoint starts clean
+    for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError()) {
+        BS_ERROR_F(LogCategory::RENDERER, "OpenGL error in %s: 0x%X", operation, error);
+    }
+}
+
+void GLAPIENTRY GLDebug::OnDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                        const GLchar* message, const void* userParam) {
+    (void)length;
+    (void)userParam;
+
+    switch (severity) {
+        case GL_DEBUG_SEVERITY_HIGH:
+            BS_ERROR_F(LogCategory::RENDERER, "GL %s %s [%u]: %s", SourceName(source), TypeName(type), id, message);
+            break;
+        case GL_DEBUG_SEVERITY_MEDIUM:
+            BS_WARN_F(LogCategory::RENDERER, "GL %s %s [%u]: %s", SourceName(source), TypeName(type), id, message);
+            break;
+        default:
+            BS_DEBUG_F(LogCategory::RENDERER, "GL %s %s [%u]: %s", SourceName(source), TypeName(type), id, message);
+            break;
+    }
+}
+
+}  // namespace Blacksite
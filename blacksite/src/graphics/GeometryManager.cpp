@@ -1,7 +1,16 @@
 #include "blacksite/graphics/GeometryManager.h"
 #include "blacksite/core/Logger.h"
+#include "blacksite/graphics/MeshImporter.h"
+#include "blacksite/graphics/MeshOptimizer.h"
+#include "blacksite/graphics/RenderCommand.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+#include <iterator>
+#include <string>
 
 namespace Blacksite {
 
@@ -40,8 +49,10 @@ void GeometryManager::CreateCube(const std::string& name) {
         -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
         0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f, -0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f, -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f};
 
-    m_meshes[name] = CreateMesh(vertices);
-    m_meshes[name].vertexCount = 36;  // 6 faces * 2 triangles * 3 vertices
+    // 36 corners in, 24 unique vertices out (each face has its own normal)
+    std::vector<unsigned int> indices;
+    MeshOptimizer::Optimize(vertices, indices);
+    StoreMesh(name, CreateMesh(vertices, indices), &vertices, &indices);
 
     BS_DEBUG_F(LogCategory::RENDERER, "Cube geometry '%s' created", name.c_str());
 }
@@ -53,12 +64,31 @@ void GeometryManager::CreateSphere(const std::string& name, float radius, int se
     // Here be dragons
     GenerateSphere(vertices, indices, radius, sectors, stacks);
 
-    m_meshes[name] = CreateMesh(vertices, indices);
-    m_meshes[name].useIndices = true;
-    m_meshes[name].indexCount = indices.size();
+    // Stack-by-stack order thrashes the vertex cache, this one is worth reordering
+    MeshOptimizer::Optimize(vertices, indices);
+    MeshHandle base = StoreMesh(name, CreateMesh(vertices, indices), &vertices, &indices);
+    if (!base.IsValid()) {
+        return;
+    }
+
+    // Same sphere with half the segments per LOD, until it would stop looking round
+    int lodSectors = sectors;
+    int lodStacks = stacks;
+    for (size_t level = 0; level < std::size(LOD_SCREEN_SIZES); ++level) {
+        lodSectors /= 2;
+        lodStacks /= 2;
+        if (lodSectors < 6 || lodStacks < 4)
+            break;
+
+        std::vector<float> lodVertices;
+        std::vector<unsigned int> lodIndices;
+        GenerateSphere(lodVertices, lodIndices, radius, lodSectors, lodStacks);
+        MeshOptimizer::Optimize(lodVertices, lodIndices);
+        AddLod(name, base, lodVertices.data(), lodVertices.size(), lodIndices.data(), lodIndices.size());
+    }
 
-    BS_DEBUG_F(LogCategory::RENDERER, "Sphere geometry '%s' created with %zu vertices, %zu indices",
-               name.c_str(), vertices.size() / 6, indices.size());
+    BS_DEBUG_F(LogCategory::RENDERER, "Sphere geometry '%s' created with %zu vertices, %zu indices, %zu LODs",
+               name.c_str(), vertices.size() / 6, indices.size(), m_meshes[base.id].lods.size());
 }
 
 void GeometryManager::CreatePlane(const std::string& name) {
@@ -75,37 +105,308 @@ void GeometryManager::CreatePlane(const std::string& name) {
         -0.5f, 0.0f, -0.5f, 0.0f, 1.0f, 0.0f  // Bottom-left
     };
 
-    m_meshes[name] = CreateMesh(vertices);
-    m_meshes[name].vertexCount = 6;  // 2 triangles * 3 vertices
+    std::vector<unsigned int> indices;
+    MeshOptimizer::Optimize(vertices, indices);
+    StoreMesh(name, CreateMesh(vertices, indices), &vertices, &indices);
 
     BS_DEBUG_F(LogCategory::RENDERER, "Plane geometry '%s' created", name.c_str());
 }
 
+MeshHandle GeometryManager::LoadMesh(const std::string& name, const std::string& path) {
+    std::string cachePath = MeshImporter::GetCachePath(path);
+    uint64_t stamp = MeshImporter::GetSourceStamp(path);
+
+    // Fast path - map the cache and hand it to GL directly, no parsing
+    MeshCacheFile cache;
+    if (cache.Open(cachePath, stamp)) {
+        Mesh mesh = CreateMesh(cache.GetVertices(), cache.GetVertexFloatCount(), cache.GetIndices(),
+                               cache.GetIndexCount());
+        if (!mesh.allocation.IsValid()) {
+            return MeshHandle{};
+        }
+        MeshHandle handle = StoreMesh(name, mesh);
+        if (!handle.IsValid()) {
+            return handle;
+        }
+        for (size_t i = 0; i < cache.GetLodCount(); ++i) {
+            const MeshCacheFile::Level& lod = cache.GetLod(i);
+            AddLod(name, handle, lod.vertices, lod.vertexFloatCount, lod.indices, lod.indexCount);
+        }
+        BS_DEBUG_F(LogCategory::RENDERER, "Mesh '%s' loaded from cache '%s' (%zu LODs)", name.c_str(),
+                   cachePath.c_str(), m_meshes[handle.id].lods.size());
+        return handle;
+    }
+
+    if (stamp == 0) {
+        BS_ERROR_F(LogCategory::RENDERER, "Mesh file '%s' not found (and no cache next to it)", path.c_str());
+        return MeshHandle{};
+    }
+
+    MeshAsset asset;
+    if (!MeshImporter::Import(path, asset)) {
+        return MeshHandle{};
+    }
+    SimplifyLods(asset);
+    if (!MeshImporter::WriteCache(cachePath, stamp, asset)) {
+        BS_WARN_F(LogCategory::RENDERER, "Mesh '%s' loaded but not cached, the next run imports it again",
+                  name.c_str());
+    }
+
+    Mesh mesh = CreateMesh(asset.vertices, asset.indices);
+    if (!mesh.allocation.IsValid()) {
+        return MeshHandle{};
+    }
+    MeshHandle handle = StoreMesh(name, mesh);
+    if (!handle.IsValid()) {
+        return handle;
+    }
+    for (const MeshAsset& lod : asset.lods) {
+        AddLod(name, handle, lod.vertices.data(), lod.vertices.size(), lod.indices.data(), lod.indices.size());
+    }
+    BS_DEBUG_F(LogCategory::RENDERER, "Mesh '%s' imported from '%s' (%zu LODs)", name.c_str(), path.c_str(),
+               m_meshes[handle.id].lods.size());
+    return handle;
+}
+
+void GeometryManager::InitializeInstancing() {
+    if (m_instanceVBO != 0) {
+        return;
+    }
+
+    glGenBuffers(1, &m_instanceVBO);
+    m_arena.SetInstanceBuffer(m_instanceVBO);
+
+    BS_DEBUG_F(LogCategory::RENDERER, "Instancing enabled for %zu vertex layouts", m_arena.GetPoolCount());
+}
+
 const Mesh* GeometryManager::GetMesh(const std::string& name) const {
-    auto it = m_meshes.find(name);
-    if (it != m_meshes.end()) {
-        return &it->second;
+    MeshHandle handle = GetMeshHandle(name);
+    if (handle.IsValid()) {
+        return &m_meshes[handle.id];
     }
 
     BS_ERROR_F(LogCategory::RENDERER, "Mesh '%s' not found! Did you forget to create it?", name.c_str());
     return nullptr;
 }
 
-void GeometryManager::Cleanup() {
-    // Delete all GPU resources
-    for (auto& pair : m_meshes) {
-        Mesh& mesh = pair.second;
-        if (mesh.VAO != 0) {
-            glDeleteVertexArrays(1, &mesh.VAO);
+const Mesh* GeometryManager::GetMesh(MeshHandle handle) const {
+    if (!handle.IsValid() || handle.id >= m_meshes.size()) {
+        BS_ERROR(LogCategory::RENDERER, "Invalid mesh handle!");
+        return nullptr;
+    }
+    return &m_meshes[handle.id];
+}
+
+MeshHandle GeometryManager::GetMeshHandle(const std::string& name) const {
+    auto it = m_meshHandles.find(name);
+    return it != m_meshHandles.end() ? it->second : MeshHandle{};
+}
+
+float GeometryManager::GetBoundingRadius(MeshHandle handle) const {
+    if (!handle.IsValid() || handle.id >= m_meshes.size()) {
+        return 0.0f;
+    }
+    return m_meshes[handle.id].boundingRadius;
+}
+
+MeshHandle GeometryManager::SelectLod(MeshHandle handle, float screenSize, uint8_t& level) const {
+    if (!handle.IsValid() || handle.id >= m_meshes.size()) {
+        return handle;
+    }
+    const std::vector<MeshLod>& lods = m_meshes[handle.id].lods;
+    size_t current = std::min<size_t>(level, lods.size());
+
+    // Coarser as soon as it's under the threshold, finer only once it's clearly over it again
+    while (current < lods.size() && screenSize < lods[current].screenSize) {
+        current++;
+    }
+    while (current > 0 && screenSize > lods[current - 1].screenSize * LOD_HYSTERESIS) {
+        current--;
+    }
+
+    level = static_cast<uint8_t>(current);
+    return current == 0 ? handle : lods[current - 1].mesh;
+}
+
+void GeometryManager::AddLod(const std::string& name, MeshHandle base, const float* vertices, size_t floatCount,
+                             const unsigned int* indices, size_t indexCount) {
+    size_t level = m_meshes[base.id].lods.size();
+    if (level >= std::size(LOD_SCREEN_SIZES)) {
+        return;
+    }
+
+    Mesh mesh = CreateMesh(vertices, floatCount, indices, indexCount);
+    if (!mesh.allocation.IsValid()) {
+        return;  // Just fewer LODs, the base mesh is fine
+    }
+
+    std::string lodName = name + "_lod" + std::to_string(level + 1);
+    MeshHandle lod = StoreMesh(lodName, mesh);  // Can grow m_meshes, so look the base up again below
+    if (lod.IsValid()) {
+        m_meshes[base.id].lods.push_back({lod, LOD_SCREEN_SIZES[level]});
+    }
+}
+
+void GeometryManager::SimplifyLods(MeshAsset& asset) {
+    // Each level clusters the original, not the previous level, so the errors don't stack up
+    asset.lods.clear();
+    size_t previousTriangles = asset.indices.size() / 3;
+    for (int resolution : LOD_GRID_RESOLUTIONS) {
+        MeshAsset lod;
+        MeshOptimizer::SimplifyClustered(asset.vertices.data(), asset.vertices.size(), asset.indices.data(),
+                                         asset.indices.size(), resolution, lod.vertices, lod.indices);
+
+        size_t triangles = lod.indices.size() / 3;
+        if (triangles < MIN_LOD_TRIANGLES)
+            break;
+        if (triangles * 10 > previousTriangles * 6)
+            continue;  // Not worth a level unless it properly cuts the triangle count
+
+        MeshOptimizer::Optimize(lod.vertices, lod.indices);
+        asset.lods.push_back(std::move(lod));
+        previousTriangles = triangles;
+    }
+}
+
+void GeometryManager::ComputeBounds(Mesh& mesh, const float* vertices, size_t floatCount) {
+    // Interleaved position + normal, 6 floats per vertex
+    if (floatCount < 6) {
+        return;
+    }
+
+    mesh.boundsMin = glm::vec3(vertices[0], vertices[1], vertices[2]);
+    mesh.boundsMax = mesh.boundsMin;
+    float radiusSq = 0.0f;
+    for (size_t i = 0; i + 2 < floatCount; i += 6) {
+        glm::vec3 position(vertices[i], vertices[i + 1], vertices[i + 2]);
+        mesh.boundsMin = glm::min(mesh.boundsMin, position);
+        mesh.boundsMax = glm::max(mesh.boundsMax, position);
+        radiusSq = std::max(radiusSq, glm::dot(position, position));
+    }
+    mesh.boundingRadius = std::sqrt(radiusSq);
+}
+
+MeshHandle GeometryManager::StoreMesh(const std::string& name, const Mesh& mesh, const std::vector<float>* vertices,
+                                      const std::vector<unsigned int>* indices) {
+    uint32_t index;
+    auto it = m_meshHandles.find(name);
+    if (it != m_meshHandles.end()) {
+        // Same name again - free the old GPU data but keep the handle
+        index = it->second.id;
+        DeleteMesh(m_meshes[index]);
+        m_meshes[index] = mesh;
+    } else {
+        if (m_meshes.size() > RenderSortKey::MAX_ID) {
+            BS_ERROR_F(LogCategory::RENDERER, "Mesh '%s' not stored, all %u mesh ids are taken", name.c_str(),
+                       RenderSortKey::MAX_ID + 1);
+            Mesh rejected = mesh;
+            DeleteMesh(rejected);
+            return MeshHandle{};
         }
-        if (mesh.VBO != 0) {
-            glDeleteBuffers(1, &mesh.VBO);
+        index = static_cast<uint32_t>(m_meshes.size());
+        m_meshHandles.emplace(name, MeshHandle(index));
+        m_meshes.push_back(mesh);
+        m_meshData.emplace_back();
+    }
+
+    MeshData& data = m_meshData[index];
+    data.vertices = vertices ? *vertices : std::vector<float>{};
+    data.indices = indices ? *indices : std::vector<unsigned int>{};
+    return MeshHandle(index);
+}
+
+MeshHandle GeometryManager::CreateStaticBatch(const std::string& name, const std::vector<StaticBatchPiece>& pieces) {
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+
+    size_t skipped = 0;
+    for (const StaticBatchPiece& piece : pieces) {
+        if (!piece.mesh.IsValid() || piece.mesh.id >= m_meshData.size() || m_meshData[piece.mesh.id].vertices.empty()) {
+            skipped++;
+            continue;
+        }
+        const MeshData& source = m_meshData[piece.mesh.id];
+
+        // Normals need the inverse transpose, non-uniform scale would skew them otherwise
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(piece.model)));
+        unsigned int base = static_cast<unsigned int>(vertices.size() / 6);
+        size_t sourceVertexCount = source.vertices.size() / 6;
+
+        for (size_t v = 0; v < sourceVertexCount; ++v) {
+            const float* src = &source.vertices[v * 6];
+            glm::vec3 position = glm::vec3(piece.model * glm::vec4(src[0], src[1], src[2], 1.0f));
+            glm::vec3 normal = glm::normalize(normalMatrix * glm::vec3(src[3], src[4], src[5]));
+            vertices.insert(vertices.end(), {position.x, position.y, position.z, normal.x, normal.y, normal.z});
         }
-        if (mesh.EBO != 0) {
-            glDeleteBuffers(1, &mesh.EBO);
+
+        // Everything in a batch is indexed, the unindexed primitives just count up
+        if (source.indices.empty()) {
+            for (size_t v = 0; v < sourceVertexCount; ++v) {
+                indices.push_back(base + static_cast<unsigned int>(v));
+            }
+        } else {
+            for (unsigned int index : source.indices) {
+                indices.push_back(base + index);
+            }
         }
     }
+
+    if (skipped > 0) {
+        BS_WARN_F(LogCategory::RENDERER, "Static batch '%s': skipped %zu pieces without batchable vertex data",
+                  name.c_str(), skipped);
+    }
+    if (vertices.empty()) {
+        BS_ERROR_F(LogCategory::RENDERER, "Static batch '%s' has nothing to draw", name.c_str());
+        return MeshHandle{};
+    }
+
+    Mesh mesh = CreateMesh(vertices, indices);
+    if (!mesh.allocation.IsValid()) {
+        return MeshHandle{};  // The arena already said why
+    }
+    MeshHandle handle = StoreMesh(name, mesh);
+    if (handle.IsValid()) {
+        BS_DEBUG_F(LogCategory::RENDERER, "Static batch '%s': %zu pieces, %zu vertices, %zu indices", name.c_str(),
+                   pieces.size() - skipped, vertices.size() / 6, indices.size());
+    }
+    return handle;
+}
+
+void GeometryManager::DestroyMesh(MeshHandle handle) {
+    if (!handle.IsValid() || handle.id >= m_meshes.size()) {
+        return;
+    }
+
+    std::vector<MeshLod> lods = m_meshes[handle.id].lods;
+    DeleteMesh(m_meshes[handle.id]);
+    m_meshData[handle.id] = MeshData{};
+    for (const MeshLod& lod : lods) {
+        DestroyMesh(lod.mesh);
+    }
+    for (auto it = m_meshHandles.begin(); it != m_meshHandles.end(); ++it) {
+        if (it->second == handle) {
+            m_meshHandles.erase(it);
+            break;
+        }
+    }
+}
+
+void GeometryManager::DeleteMesh(Mesh& mesh) {
+    m_arena.Free(mesh.allocation);
+    mesh = Mesh{};
+}
+
+void GeometryManager::Cleanup() {
+    // Delete all GPU resources - the arena owns every mesh buffer, no need to free them one by one
+    m_arena.Cleanup();
     m_meshes.clear();
+    m_meshData.clear();
+    m_meshHandles.clear();
+
+    if (m_instanceVBO != 0) {
+        glDeleteBuffers(1, &m_instanceVBO);
+        m_instanceVBO = 0;
+    }
 
     BS_DEBUG(LogCategory::RENDERER, "GeometryManager cleaned up");
 }
@@ -167,39 +468,63 @@ void GeometryManager::GenerateSphere(std::vector<float>& vertices, std::vector<u
 }
 
 Mesh GeometryManager::CreateMesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices) {
-    Mesh mesh;
-
-    // Generate OpenGL objects
-    glGenVertexArrays(1, &mesh.VAO);
-    glGenBuffers(1, &mesh.VBO);
-
-    glBindVertexArray(mesh.VAO);
-
-    // Upload vertex data to GPU
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
-
-    // Tell OpenGL how to interpret our vertex data
-    // Position attribute (location 0): 3 floats starting at offset 0
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    return CreateMesh(vertices.data(), vertices.size(), indices.empty() ? nullptr : indices.data(), indices.size());
+}
 
-    // Normal attribute (location 1): 3 floats starting at offset 3
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+Mesh GeometryManager::CreateMesh(const float* vertices, size_t floatCount, const unsigned int* indices,
+                                 size_t indexCount) {
+    Mesh mesh;
+    size_t vertexCount = floatCount / 6;
+    ComputeBounds(mesh, vertices, floatCount);
+
+    // fp16 rounds to within |x| * 2^-11, so the largest coordinate decides whether it's good enough
+    glm::vec3 extent = glm::max(glm::abs(mesh.boundsMin), glm::abs(mesh.boundsMax));
+    float maxCoordinate = std::max(extent.x, std::max(extent.y, extent.z));
+    bool halfPositions = m_vertexFormat.halfPositions && maxCoordinate < 65504.0f &&
+                         maxCoordinate * (1.0f / 2048.0f) <= m_vertexFormat.maxPositionError;
+
+    VertexLayout layout;
+    layout.halfPositions = halfPositions;
+    layout.packedNormals = m_vertexFormat.packedNormals;
+    size_t positionBytes = layout.PositionBytes();
+    mesh.vertexStride = layout.Stride();
+
+    // Interleave into the packed layout, position then normal
+    std::vector<uint8_t> packed(vertexCount * mesh.vertexStride);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const float* src = &vertices[v * 6];
+        uint8_t* dst = &packed[v * mesh.vertexStride];
+
+        if (layout.halfPositions) {
+            uint64_t position = glm::packHalf4x16(glm::vec4(src[0], src[1], src[2], 1.0f));
+            std::memcpy(dst, &position, sizeof(position));
+        } else {
+            std::memcpy(dst, src, 3 * sizeof(float));
+        }
 
-    // Setup element buffer if we have indices
-    if (!indices.empty()) {
-        glGenBuffers(1, &mesh.EBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-        mesh.useIndices = true;
-        mesh.indexCount = indices.size();
+        if (layout.packedNormals) {
+            uint32_t normal = glm::packSnorm3x10_1x2(glm::vec4(src[3], src[4], src[5], 0.0f));
+            std::memcpy(dst + positionBytes, &normal, sizeof(normal));
+        } else {
+            std::memcpy(dst + positionBytes, src + 3, 3 * sizeof(float));
+        }
     }
 
-    // Unbind to prevent accidental modification
-    glBindVertexArray(0);
+    // The arena only does indexed meshes, give unindexed input the trivial index buffer
+    std::vector<unsigned int> sequential;
+    if (indexCount == 0) {
+        sequential.resize(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            sequential[v] = static_cast<unsigned int>(v);
+        }
+        indices = sequential.data();
+        indexCount = sequential.size();
+    }
 
+    mesh.allocation = m_arena.Allocate(layout, packed.data(), static_cast<uint32_t>(vertexCount), indices,
+                                       static_cast<uint32_t>(indexCount));
+    mesh.VAO = m_arena.GetVertexArray(mesh.allocation.pool);
+    mesh.instancedVAO = m_arena.GetInstancedVertexArray(mesh.allocation.pool);
     return mesh;
 }
 
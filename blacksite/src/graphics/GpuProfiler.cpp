@@ -0,0 +1,120 @@
+#include "blacksite/graphics/GpuProfiler.h"
+#include "blacksite/core/Logger.h"
+
+namespace Blacksite {
+
+void GpuProfiler::Shutdown() {
+    if (m_inZone) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_inZone = false;
+    }
+    for (FrameSlice& slice : m_slices) {
+        if (!slice.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(slice.queries.size()), slice.queries.data());
+        }
+        slice = FrameSlice{};
+    }
+    m_results.clear();
+    m_frameMs = 0.0f;
+    m_inFrame = false;
+}
+
+void GpuProfiler::BeginFrame() {
+    if (!m_enabled) {
+        return;
+    }
+
+    m_slice = (m_slice + 1) % FRAME_LATENCY;
+    Collect(m_slices[m_slice]);
+    m_inFrame = true;
+}
+
+void GpuProfiler::EndFrame() {
+    if (m_inZone) {
+        EndZone();
+    }
+    m_inFrame = false;
+}
+
+void GpuProfiler::BeginZone(const std::string& name) {
+    if (!m_enabled || !m_inFrame) {
+        return;
+    }
+    if (m_inZone) {
+        BS_WARN_F(LogCategory::RENDERER, "GPU zone '%s' started inside another one, zones can't nest", name.c_str());
+        EndZone();
+    }
+
+    FrameSlice& slice = m_slices[m_slice];
+    if (slice.used == slice.queries.size()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        slice.queries.push_back(query);
+        slice.names.emplace_back();
+    }
+
+    slice.names[slice.used] = name;
+    glBeginQuery(GL_TIME_ELAPSED, slice.queries[slice.used]);
+    ++slice.used;
+    m_inZone = true;
+}
+
+void GpuProfiler::EndZone() {
+    if (!m_inZone) {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    m_inZone = false;
+}
+
+void GpuProfiler::SetEnabled(bool enabled) {
+    if (!enabled) {
+        EndFrame();
+        for (FrameSlice& slice : m_slices) {
+            slice.used = 0;  // Whatever was in flight is stale by the time we turn back on
+        }
+        m_results.clear();
+        m_frameMs = 0.0f;
+    }
+    m_enabled = enabled;
+}
+
+float GpuProfiler::GetZoneMs(const std::string& name) const {
+    for (const GpuZoneTiming& zone : m_results) {
+        if (zone.name == name) {
+            return zone.ms;
+        }
+    }
+    return 0.0f;
+}
+
+void GpuProfiler::Collect(FrameSlice& slice) {
+    if (slice.used == 0) {
+        return;
+    }
+
+    // Queries finish in order, if the last one is done they all are
+    GLint available = 0;
+    glGetQueryObjectiv(slice.queries[slice.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++m_droppedFrames;
+        slice.used = 0;
+        return;
+    }
+
+    m_results.resize(slice.used);
+    m_frameMs = 0.0f;
+    for (uint32_t i = 0; i < slice.used; ++i) {
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(slice.queries[i], GL_QUERY_RESULT, &elapsedNs);
+        m_results[i].name = slice.names[i];
+        m_results[i].ms = static_cast<float>(elapsedNs / 1000000.0);
+        m_frameMs += m_results[i].ms;
+    }
+    slice.used = 0;
+
+    m_history[m_historyIndex] = m_frameMs;
+    m_historyIndex = (m_historyIndex + 1) % HISTORY_SIZE;
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,315 @@
+#include "blacksite/graphics/HiZBuffer.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/ShaderSystem.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Blacksite {
+
+bool HiZBuffer::Initialize(ShaderSystem* shaderSystem) {
+    Shutdown();
+    m_shaderSystem = shaderSystem;
+
+    auto& shaderManager = shaderSystem->GetShaderManager();
+    if (!shaderManager.HasShader("hiz_downsample") && !shaderManager.LoadShaderFromLibrary("hiz_downsample")) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to load the Hi-Z shader, occlusion culling stays off");
+        m_shaderSystem = nullptr;
+        return false;
+    }
+
+    glGenFramebuffers(1, &m_fbo);
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_pbo);
+    return true;
+}
+
+void HiZBuffer::Shutdown() {
+    if (m_fence) {
+        glDeleteSync(m_fence);
+        m_fence = nullptr;
+    }
+    DestroyGpuLevels();
+    if (m_pbo != 0) {
+        glDeleteBuffers(1, &m_pbo);
+        m_pbo = 0;
+        MemoryTracker::Adjust(MemoryTag::GpuBuffers, -static_cast<int64_t>(m_pboSize));
+        m_pboSize = 0;
+    }
+    if (m_vao != 0) {
+        glDeleteVertexArrays(1, &m_vao);
+        m_vao = 0;
+    }
+    if (m_fbo != 0) {
+        glDeleteFramebuffers(1, &m_fbo);
+        m_fbo = 0;
+    }
+    m_levels.clear();
+    m_shaderSystem = nullptr;
+}
+
+void HiZBuffer::Build(GLuint depthTexture, int width, int height, const glm::mat4& view,
+                      const glm::mat4& projection) {
+    BS_PROFILE_SCOPE("HiZBuffer::Build");
+
+    PollReadback();
+    if (!m_shaderSystem || m_fence || depthTexture == 0 || width <= 0 || height <= 0) {
+        return;
+    }
+
+    if (width != m_sourceWidth || height != m_sourceHeight) {
+        ResizeGpuLevels(width, height);
+    }
+    auto& shaderManager = m_shaderSystem->GetShaderManager();
+    if (!shaderManager.UseShader("hiz_downsample")) {
+        return;
+    }
+    shaderManager.SetUniform("uSource", 0);
+
+    GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glBindVertexArray(m_vao);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+
+    int sourceWidth = width;
+    int sourceHeight = height;
+    for (const GpuLevel& level : m_gpuLevels) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, level.texture, 0);
+        glViewport(0, 0, level.width, level.height);
+        shaderManager.SetUniform("uSourceSize", sourceWidth, sourceHeight);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        glBindTexture(GL_TEXTURE_2D, level.texture);  // Source for the next one
+        sourceWidth = level.width;
+        sourceHeight = level.height;
+    }
+
+    // Smallest GPU level goes to the CPU, asynchronously - PollReadback picks it up once the fence says so
+    const GpuLevel& last = m_gpuLevels.back();
+    size_t bytes = static_cast<size_t>(last.width) * last.height * sizeof(float);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo);
+    if (bytes > m_pboSize) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+        MemoryTracker::Adjust(MemoryTag::GpuBuffers, static_cast<int64_t>(bytes) - static_cast<int64_t>(m_pboSize));
+        m_pboSize = bytes;
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, last.width, last.height, GL_RED, GL_FLOAT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    m_pendingLevel = static_cast<int>(m_gpuLevels.size());
+    m_pendingWidth = last.width;
+    m_pendingHeight = last.height;
+    m_pendingViewProjection = projection * view;
+    m_pendingDepthWidth = width;
+    m_pendingDepthHeight = height;
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (depthTest) {
+        glEnable(GL_DEPTH_TEST);
+    }
+}
+
+void HiZBuffer::Invalidate() {
+    m_levels.clear();
+}
+
+bool HiZBuffer::IsSphereOccluded(const glm::vec3& center, float radius) const {
+    if (m_levels.empty()) {
+        return false;
+    }
+
+    // The sphere's world-space box, projected. Corners are center +- radius along each axis, so they're
+    // the center's clip position plus/minus the matrix columns scaled by the radius.
+    const glm::mat4& viewProjection = m_viewProjection;
+    glm::vec4 base = viewProjection * glm::vec4(center, 1.0f);
+    glm::vec4 axisX = viewProjection[0] * radius;
+    glm::vec4 axisY = viewProjection[1] * radius;
+    glm::vec4 axisZ = viewProjection[2] * radius;
+
+    glm::vec2 ndcMin(1.0f);
+    glm::vec2 ndcMax(-1.0f);
+    float nearestDepth = 1.0f;
+    for (int corner = 0; corner < 8; ++corner) {
+        glm::vec4 clip = base + ((corner & 1) ? axisX : -axisX) + ((corner & 2) ? axisY : -axisY) +
+                         ((corner & 4) ? axisZ : -axisZ);
+        if (clip.w <= 1e-5f) {
+            return false;  // Reaches behind the camera it was seen from, can't tell
+        }
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        if (ndc.z < -1.0f) {
+            return false;  // In front of the near plane
+        }
+        ndcMin = glm::min(ndcMin, glm::vec2(ndc));
+        ndcMax = glm::max(ndcMax, glm::vec2(ndc));
+        nearestDepth = std::min(nearestDepth, ndc.z * 0.5f + 0.5f);
+    }
+
+    // Partly off that screen: the pyramid knows nothing about the part outside, it may be what shows now
+    if (ndcMin.x < -1.0f || ndcMin.y < -1.0f || ndcMax.x > 1.0f || ndcMax.y > 1.0f) {
+        return false;
+    }
+
+    // Rect in pixels of the full-size depth, then the first level where it's at most 2x2 texels
+    auto toPixel = [](float ndc, int size) {
+        return std::clamp(static_cast<int>((ndc * 0.5f + 0.5f) * static_cast<float>(size)), 0, size - 1);
+    };
+    int x0 = toPixel(ndcMin.x, m_depthWidth), x1 = toPixel(ndcMax.x, m_depthWidth);
+    int y0 = toPixel(ndcMin.y, m_depthHeight), y1 = toPixel(ndcMax.y, m_depthHeight);
+
+    size_t index = 0;
+    int shift = m_firstLevel;
+    auto fits = [&](int s) { return (x1 >> s) - (x0 >> s) <= 1 && (y1 >> s) - (y0 >> s) <= 1; };
+    while (index + 1 < m_levels.size() && !fits(shift)) {
+        ++index;
+        ++shift;
+    }
+
+    const Level& level = m_levels[index];
+    float farthest = 0.0f;
+    for (int y = std::min(y0 >> shift, level.height - 1); y <= std::min(y1 >> shift, level.height - 1); ++y) {
+        for (int x = std::min(x0 >> shift, level.width - 1); x <= std::min(x1 >> shift, level.width - 1); ++x) {
+            farthest = std::max(farthest, level.depth[static_cast<size_t>(y) * level.width + x]);
+        }
+    }
+    return nearestDepth > farthest;
+}
+
+size_t HiZBuffer::CullSpheres(const float* x, const float* y, const float* z, const float* radius, size_t count,
+                              uint8_t* visible) const {
+    if (m_levels.empty()) {
+        return 0;
+    }
+
+    size_t culled = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (visible[i] && IsSphereOccluded(glm::vec3(x[i], y[i], z[i]), radius[i])) {
+            visible[i] = 0;
+            ++culled;
+        }
+    }
+    return culled;
+}
+
+void HiZBuffer::ResizeGpuLevels(int width, int height) {
+    DestroyGpuLevels();
+    m_sourceWidth = width;
+    m_sourceHeight = height;
+
+    // Halve (rounding up, so the last row/column is never dropped) until it's small enough to read back
+    int levelWidth = width;
+    int levelHeight = height;
+    while (levelWidth > READBACK_MAX_SIZE || levelHeight > READBACK_MAX_SIZE || m_gpuLevels.empty()) {
+        levelWidth = std::max(1, (levelWidth + 1) / 2);
+        levelHeight = std::max(1, (levelHeight + 1) / 2);
+
+        GpuLevel level;
+        level.width = levelWidth;
+        level.height = levelHeight;
+        glGenTextures(1, &level.texture);
+        glBindTexture(GL_TEXTURE_2D, level.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, levelWidth, levelHeight, 0, GL_RED, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        MemoryTracker::Adjust(MemoryTag::GpuBuffers, static_cast<int64_t>(levelWidth) * levelHeight * 4);
+        m_gpuLevels.push_back(level);
+
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    BS_DEBUG_F(LogCategory::RENDERER, "Hi-Z pyramid for %dx%d, reading back level %zu (%dx%d)", width, height,
+               m_gpuLevels.size(), levelWidth, levelHeight);
+}
+
+void HiZBuffer::DestroyGpuLevels() {
+    for (const GpuLevel& level : m_gpuLevels) {
+        glDeleteTextures(1, &level.texture);
+        MemoryTracker::Adjust(MemoryTag::GpuBuffers, -static_cast<int64_t>(level.width) * level.height * 4);
+    }
+    m_gpuLevels.clear();
+    m_sourceWidth = 0;
+    m_sourceHeight = 0;
+}
+
+void HiZBuffer::PollReadback() {
+    if (!m_fence) {
+        return;
+    }
+
+    GLenum status = glClientWaitSync(m_fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return;  // Next frame then
+    }
+    glDeleteSync(m_fence);
+    m_fence = nullptr;
+    if (status == GL_WAIT_FAILED) {
+        return;
+    }
+
+    size_t bytes = static_cast<size_t>(m_pendingWidth) * m_pendingHeight * sizeof(float);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo);
+    const float* data =
+        static_cast<const float*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                                   GL_MAP_READ_BIT));
+    if (data) {
+        m_firstLevel = m_pendingLevel;
+        m_viewProjection = m_pendingViewProjection;
+        m_depthWidth = m_pendingDepthWidth;
+        m_depthHeight = m_pendingDepthHeight;
+        BuildCpuLevels(data, m_pendingWidth, m_pendingHeight);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void HiZBuffer::BuildCpuLevels(const float* data, int width, int height) {
+    BS_PROFILE_SCOPE("HiZBuffer::BuildCpuLevels");
+
+    // Same reduction the shader does, the rest of the way down to 1x1. Vectors are reused between readbacks.
+    size_t count = 1;
+    for (int w = width, h = height; w > 1 || h > 1; w = (w + 1) / 2, h = (h + 1) / 2) {
+        ++count;
+    }
+    m_levels.resize(count);
+
+    Level& top = m_levels[0];
+    top.width = width;
+    top.height = height;
+    top.depth.resize(static_cast<size_t>(width) * height);
+    std::memcpy(top.depth.data(), data, top.depth.size() * sizeof(float));
+
+    for (size_t i = 1; i < count; ++i) {
+        const Level& source = m_levels[i - 1];
+        Level& level = m_levels[i];
+        level.width = (source.width + 1) / 2;
+        level.height = (source.height + 1) / 2;
+        level.depth.resize(static_cast<size_t>(level.width) * level.height);
+
+        for (int y = 0; y < level.height; ++y) {
+            const float* row0 = &source.depth[static_cast<size_t>(y * 2) * source.width];
+            const float* row1 = &source.depth[static_cast<size_t>(std::min(y * 2 + 1, source.height - 1)) *
+                                              source.width];
+            for (int x = 0; x < level.width; ++x) {
+                int left = x * 2;
+                int right = std::min(left + 1, source.width - 1);
+                level.depth[static_cast<size_t>(y) * level.width + x] =
+                    std::max(std::max(row0[left], row0[right]), std::max(row1[left], row1[right]));
+            }
+        }
+    }
+}
+
+}  // namespace Blacksite
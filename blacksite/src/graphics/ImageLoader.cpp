@@ -0,0 +1,190 @@
+#include "blacksite/graphics/ImageLoader.h"
+#include "blacksite/core/Logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+
+namespace Blacksite {
+
+namespace {
+
+uint16_t Read16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t Read32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool ValidSize(int64_t width, int64_t height) {
+    return width > 0 && height > 0 && width <= ImageLoader::MAX_DIMENSION && height <= ImageLoader::MAX_DIMENSION;
+}
+
+// Types 2/3 (true color, grayscale) and their RLE versions 10/11. Color-mapped and 16 bit ones are rare enough.
+bool DecodeTGA(const uint8_t* data, size_t size, ImageData& image) {
+    if (size < 18 || data[1] != 0) {
+        return false;
+    }
+    int type = data[2];
+    int bpp = data[16];
+    bool gray = type == 3 || type == 11;
+    bool rle = type == 10 || type == 11;
+    if ((type != 2 && type != 3 && type != 10 && type != 11) || (gray ? bpp != 8 : bpp != 24 && bpp != 32)) {
+        return false;
+    }
+
+    image.width = Read16(&data[12]);
+    image.height = Read16(&data[14]);
+    if (!ValidSize(image.width, image.height)) {
+        return false;
+    }
+
+    size_t bytes = static_cast<size_t>(bpp / 8);
+    size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+    size_t offset = 18 + data[0];
+    image.rgba.resize(pixelCount * 4);
+
+    auto store = [&](size_t index, const uint8_t* src) {
+        uint8_t* dst = &image.rgba[index * 4];
+        if (gray) {
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = 255;
+        } else {
+            dst[0] = src[2];
+            dst[1] = src[1];
+            dst[2] = src[0];
+            dst[3] = bytes == 4 ? src[3] : 255;
+        }
+    };
+
+    for (size_t pixel = 0; pixel < pixelCount;) {
+        size_t run = 1;
+        bool repeat = false;
+        if (rle) {
+            if (offset >= size) {
+                return false;
+            }
+            uint8_t header = data[offset++];
+            run = (header & 0x7f) + 1u;
+            repeat = (header & 0x80) != 0;
+        }
+        run = std::min(run, pixelCount - pixel);
+        if (offset + (repeat ? 1 : run) * bytes > size) {
+            return false;
+        }
+        for (size_t i = 0; i < run; ++i) {
+            store(pixel + i, &data[offset + (repeat ? 0 : i * bytes)]);
+        }
+        offset += (repeat ? 1 : run) * bytes;
+        pixel += run;
+    }
+
+    // Bottom-up unless bit 5 of the descriptor says otherwise
+    if ((data[17] & 0x20) == 0) {
+        size_t rowBytes = static_cast<size_t>(image.width) * 4;
+        for (uint32_t y = 0; y < image.height / 2; ++y) {
+            std::swap_ranges(image.rgba.begin() + y * rowBytes, image.rgba.begin() + (y + 1) * rowBytes,
+                             image.rgba.begin() + (image.height - 1 - y) * rowBytes);
+        }
+    }
+    return true;
+}
+
+// Uncompressed 24/32 bit only, which is what tools write by default
+bool DecodeBMP(const uint8_t* data, size_t size, ImageData& image) {
+    if (size < 54 || data[0] != 'B' || data[1] != 'M') {
+        return false;
+    }
+    uint32_t pixelOffset = Read32(&data[10]);
+    int64_t width = static_cast<int32_t>(Read32(&data[18]));
+    int64_t height = static_cast<int32_t>(Read32(&data[22]));
+    int bpp = Read16(&data[28]);
+    uint32_t compression = Read32(&data[30]);
+    if (compression != 0 || (bpp != 24 && bpp != 32)) {
+        return false;
+    }
+
+    bool topDown = height < 0;
+    if (!ValidSize(width, topDown ? -height : height)) {
+        return false;
+    }
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(topDown ? -height : height);
+
+    size_t bytes = static_cast<size_t>(bpp / 8);
+    size_t stride = (static_cast<size_t>(image.width) * bytes + 3) & ~size_t(3);
+    if (pixelOffset + stride * image.height > size) {
+        return false;
+    }
+
+    // The 4th byte of 32 bit BI_RGB is usually just padding, treat it as opaque
+    image.rgba.resize(static_cast<size_t>(image.width) * image.height * 4);
+    for (uint32_t y = 0; y < image.height; ++y) {
+        const uint8_t* row = &data[pixelOffset + stride * (topDown ? y : image.height - 1 - y)];
+        uint8_t* dst = &image.rgba[static_cast<size_t>(y) * image.width * 4];
+        for (uint32_t x = 0; x < image.width; ++x, row += bytes, dst += 4) {
+            dst[0] = row[2];
+            dst[1] = row[1];
+            dst[2] = row[0];
+            dst[3] = 255;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool ImageLoader::Load(const std::string& path, ImageData& out) {
+    std::filesystem::path file = std::filesystem::u8path(path);
+    std::string extension = file.extension().u8string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (!IsSupported(extension)) {
+        BS_WARN_F(LogCategory::RENDERER, "No decoder for '%s' images (%s), convert it to TGA or BMP",
+                  extension.c_str(), path.c_str());
+        return false;
+    }
+
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(file, error);
+    if (error || size == 0 || size > MAX_FILE_SIZE) {
+        BS_WARN_F(LogCategory::RENDERER, "Can't read image '%s'", path.c_str());
+        return false;
+    }
+
+    std::vector<uint8_t> data(size);
+    std::ifstream stream(file, std::ios::binary);
+    if (!stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size))) {
+        BS_WARN_F(LogCategory::RENDERER, "Can't read image '%s'", path.c_str());
+        return false;
+    }
+
+    if (!Decode(data.data(), data.size(), extension, out)) {
+        BS_WARN_F(LogCategory::RENDERER, "Image '%s' is malformed or uses an unsupported variant", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ImageLoader::Decode(const uint8_t* data, size_t size, const std::string& extension, ImageData& out) {
+    out = ImageData();
+    bool decoded = false;
+    if (extension == ".tga") {
+        decoded = DecodeTGA(data, size, out);
+    } else if (extension == ".bmp") {
+        decoded = DecodeBMP(data, size, out);
+    }
+    if (!decoded) {
+        out = ImageData();
+    }
+    return decoded;
+}
+
+bool ImageLoader::IsSupported(const std::string& extension) {
+    return extension == ".tga" || extension == ".bmp";
+}
+
+}  // namespace Blacksite
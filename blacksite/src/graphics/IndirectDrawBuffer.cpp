@@ -0,0 +1,34 @@
+#include "blacksite/graphics/IndirectDrawBuffer.h"
+
+namespace Blacksite {
+
+bool IndirectDrawBuffer::IsSupported() {
+    // baseInstance in the commands needs 4.2 / ARB_base_instance, the rest is the two big ones
+    bool multiDraw = GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+    bool baseInstance = GLEW_VERSION_4_2 || GLEW_ARB_base_instance;
+    return multiDraw && baseInstance && DynamicBufferRing::IsSupported();
+}
+
+bool IndirectDrawBuffer::BeginFrame(DynamicBufferRing& ring, uint32_t maxDraws) {
+    m_instances = nullptr;
+    m_commands = nullptr;
+
+    // Every command could end up its own record in the worst case, so that's what both ranges have to fit.
+    // Aligned to their own strides, so the offsets turn into whole baseInstance / command indices.
+    DynamicBufferRing::Allocation instances =
+        ring.Allocate(size_t(maxDraws) * sizeof(InstanceData), sizeof(InstanceData));
+    DynamicBufferRing::Allocation commands =
+        ring.Allocate(size_t(maxDraws) * sizeof(DrawElementsIndirectCommand), sizeof(DrawElementsIndirectCommand));
+    if (!instances.IsValid() || !commands.IsValid()) {
+        return false;
+    }
+
+    m_buffer = ring.GetBuffer();
+    m_instances = static_cast<InstanceData*>(instances.data);
+    m_commands = static_cast<DrawElementsIndirectCommand*>(commands.data);
+    m_instanceBase = static_cast<uint32_t>(instances.offset / sizeof(InstanceData));
+    m_commandBase = static_cast<uint32_t>(commands.offset / sizeof(DrawElementsIndirectCommand));
+    return true;
+}
+
+}  // namespace Blacksite
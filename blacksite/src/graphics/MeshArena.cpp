@@ -0,0 +1,321 @@
+#include "blacksite/graphics/MeshArena.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+#include "blacksite/graphics/GLDebug.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Blacksite {
+
+bool MeshArena::RangeAllocator::Allocate(uint32_t size, uint32_t& outOffset) {
+    for (size_t i = 0; i < m_free.size(); ++i) {
+        Range& range = m_free[i];
+        if (range.size < size)
+            continue;
+
+        outOffset = range.offset;
+        range.offset += size;
+        range.size -= size;
+        if (range.size == 0) {
+            m_free.erase(m_free.begin() + i);
+        }
+        return true;
+    }
+    return false;
+}
+
+void MeshArena::RangeAllocator::Free(uint32_t offset, uint32_t size) {
+    if (size == 0)
+        return;
+
+    auto next = std::lower_bound(m_free.begin(), m_free.end(), offset,
+                                 [](const Range& range, uint32_t value) { return range.offset < value; });
+    next = m_free.insert(next, Range{offset, size});
+
+    // Merge with whatever touches it on either side
+    auto after = next + 1;
+    if (after != m_free.end() && next->offset + next->size == after->offset) {
+        next->size += after->size;
+        m_free.erase(after);
+    }
+    if (next != m_free.begin()) {
+        auto before = next - 1;
+        if (before->offset + before->size == next->offset) {
+            before->size += next->size;
+            m_free.erase(next);
+        }
+    }
+}
+
+void MeshArena::RangeAllocator::Grow(uint32_t newCapacity) {
+    if (newCapacity <= m_capacity)
+        return;
+
+    uint32_t added = newCapacity - m_capacity;
+    if (!m_free.empty() && m_free.back().offset + m_free.back().size == m_capacity) {
+        m_free.back().size += added;
+    } else {
+        m_free.push_back(Range{m_capacity, added});
+    }
+    m_capacity = newCapacity;
+}
+
+MeshAllocation MeshArena::Allocate(const VertexLayout& layout, const void* vertexData, uint32_t vertexCount,
+                                   const unsigned int* indices, uint32_t indexCount) {
+    MeshAllocation allocation;
+    if (vertexCount == 0 || indexCount == 0) {
+        BS_ERROR(LogCategory::RENDERER, "MeshArena: Can't allocate an empty mesh");
+        return allocation;
+    }
+
+    uint32_t poolIndex = FindOrCreatePool(layout);
+    if (poolIndex == MeshAllocation::INVALID_POOL) {
+        return allocation;
+    }
+
+    Pool& pool = m_pools[poolIndex];
+    uint32_t baseVertex;
+    if (!pool.vertices.Allocate(vertexCount, baseVertex)) {
+        if (!GrowVertexBuffer(pool, pool.vertices.GetCapacity() + vertexCount) ||
+            !pool.vertices.Allocate(vertexCount, baseVertex)) {
+            BS_ERROR_F(LogCategory::RENDERER, "MeshArena: Out of vertex space (%u vertices)", vertexCount);
+            return allocation;
+        }
+    }
+
+    uint32_t firstIndex;
+    if (!m_indices.Allocate(indexCount, firstIndex)) {
+        if (!GrowIndexBuffer(m_indices.GetCapacity() + indexCount) || !m_indices.Allocate(indexCount, firstIndex)) {
+            BS_ERROR_F(LogCategory::RENDERER, "MeshArena: Out of index space (%u indices)", indexCount);
+            pool.vertices.Free(baseVertex, vertexCount);
+            return allocation;
+        }
+    }
+
+    // Copy targets, so uploading never touches a VAO's element buffer binding
+    uint32_t stride = layout.Stride();
+    glBindBuffer(GL_COPY_WRITE_BUFFER, pool.vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(baseVertex) * stride,
+                    static_cast<GLsizeiptr>(vertexCount) * stride, vertexData);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(firstIndex) * sizeof(unsigned int),
+                    static_cast<GLsizeiptr>(indexCount) * sizeof(unsigned int), indices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    allocation.pool = poolIndex;
+    allocation.baseVertex = baseVertex;
+    allocation.vertexCount = vertexCount;
+    allocation.firstIndex = firstIndex;
+    allocation.indexCount = indexCount;
+    return allocation;
+}
+
+void MeshArena::Free(const MeshAllocation& allocation) {
+    if (!allocation.IsValid() || allocation.pool >= m_pools.size())
+        return;
+
+    m_pools[allocation.pool].vertices.Free(allocation.baseVertex, allocation.vertexCount);
+    m_indices.Free(allocation.firstIndex, allocation.indexCount);
+}
+
+void MeshArena::SetInstanceBuffer(GLuint instanceBuffer) {
+    m_instanceBuffer = instanceBuffer;
+    for (const Pool& pool : m_pools) {
+        SetupInstanceAttributes(pool);
+    }
+}
+
+void MeshArena::Cleanup() {
+    for (Pool& pool : m_pools) {
+        glDeleteVertexArrays(1, &pool.vao);
+        glDeleteVertexArrays(1, &pool.instancedVao);
+        glDeleteBuffers(1, &pool.vbo);
+        MemoryTracker::Adjust(MemoryTag::Meshes,
+                              -static_cast<int64_t>(size_t(pool.vertices.GetCapacity()) * pool.layout.Stride()));
+    }
+    m_pools.clear();
+
+    if (m_indexBuffer != 0) {
+        glDeleteBuffers(1, &m_indexBuffer);
+        m_indexBuffer = 0;
+        MemoryTracker::Adjust(MemoryTag::Meshes,
+                              -static_cast<int64_t>(size_t(m_indices.GetCapacity()) * sizeof(unsigned int)));
+    }
+    m_indices = RangeAllocator{};
+    m_instanceBuffer = 0;  // Not ours, the GeometryManager deletes it
+}
+
+uint32_t MeshArena::FindOrCreatePool(const VertexLayout& layout) {
+    for (uint32_t i = 0; i < m_pools.size(); ++i) {
+        if (m_pools[i].layout == layout)
+            return i;
+    }
+
+    // The index buffer comes with the first pool
+    if (m_indexBuffer == 0 && !GrowIndexBuffer(INITIAL_INDEX_CAPACITY)) {
+        return MeshAllocation::INVALID_POOL;
+    }
+
+    Pool pool;
+    pool.layout = layout;
+    glGenVertexArrays(1, &pool.vao);
+    glGenVertexArrays(1, &pool.instancedVao);
+    m_pools.push_back(pool);
+    if (!GrowVertexBuffer(m_pools.back(), INITIAL_VERTEX_CAPACITY)) {
+        glDeleteVertexArrays(1, &m_pools.back().vao);
+        glDeleteVertexArrays(1, &m_pools.back().instancedVao);
+        m_pools.pop_back();
+        return MeshAllocation::INVALID_POOL;
+    }
+
+    const Pool& created = m_pools.back();
+    for (GLuint vao : {created.vao, created.instancedVao}) {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    }
+    glBindVertexArray(0);
+    if (m_instanceBuffer != 0) {
+        SetupInstanceAttributes(created);
+    }
+
+    BS_DEBUG_F(LogCategory::RENDERER, "MeshArena: New pool for %u-byte vertices", layout.Stride());
+    return static_cast<uint32_t>(m_pools.size() - 1);
+}
+
+void MeshArena::SetupVertexAttributes(const Pool& pool) {
+    uint32_t stride = pool.layout.Stride();
+    glBindBuffer(GL_ARRAY_BUFFER, pool.vbo);
+
+    // Both VAOs read the same vertices, only the instanced one has anything past location 1
+    for (GLuint vao : {pool.vao, pool.instancedVao}) {
+        glBindVertexArray(vao);
+
+        // Position attribute (location 0): the shader only reads xyz, the fp16 pad is just alignment
+        if (pool.layout.halfPositions) {
+            glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void*)0);
+        } else {
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        }
+        glEnableVertexAttribArray(0);
+
+        // Normal attribute (location 1): packed ones have to be read as all 4 components, normalized to -1..1
+        void* normalOffset = (void*)static_cast<uintptr_t>(pool.layout.PositionBytes());
+        if (pool.layout.packedNormals) {
+            glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, normalOffset);
+        } else {
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, normalOffset);
+        }
+        glEnableVertexAttribArray(1);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void MeshArena::SetupInstanceAttributes(const Pool& pool) {
+    glBindVertexArray(pool.instancedVao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+
+    // mat4 = 4 vec4 attributes, one column each (locations 3, 4, 5, 6)
+    for (int column = 0; column < 4; ++column) {
+        GLuint location = 3 + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+
+    // Color (location 7)
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)offsetof(InstanceData, color));
+    glEnableVertexAttribArray(7);
+    glVertexAttribDivisor(7, 1);
+
+    // Entity id for the picking buffer (location 8) - the I variant, a float would lose ids past 2^24
+    glVertexAttribIPointer(8, 1, GL_UNSIGNED_INT, sizeof(InstanceData), (void*)offsetof(InstanceData, entityId));
+    glEnableVertexAttribArray(8);
+    glVertexAttribDivisor(8, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool MeshArena::GrowVertexBuffer(Pool& pool, uint32_t minCapacity) {
+    uint32_t oldCapacity = pool.vertices.GetCapacity();
+    uint32_t newCapacity = std::max(minCapacity, std::max(oldCapacity * 2, INITIAL_VERTEX_CAPACITY));
+    size_t stride = pool.layout.Stride();
+
+    GLuint buffer = ResizeBuffer(pool.vbo, oldCapacity * stride, newCapacity * stride);
+    if (buffer == 0) {
+        return false;
+    }
+
+    pool.vbo = buffer;
+    pool.vertices.Grow(newCapacity);
+    SetupVertexAttributes(pool);  // The attribute pointers captured the old buffer
+    if (oldCapacity > 0) {
+        BS_DEBUG_F(LogCategory::RENDERER, "MeshArena: Vertex pool grown to %u vertices", newCapacity);
+    }
+    return true;
+}
+
+bool MeshArena::GrowIndexBuffer(uint32_t minCapacity) {
+    uint32_t oldCapacity = m_indices.GetCapacity();
+    uint32_t newCapacity = std::max(minCapacity, std::max(oldCapacity * 2, INITIAL_INDEX_CAPACITY));
+
+    GLuint buffer = ResizeBuffer(m_indexBuffer, oldCapacity * sizeof(unsigned int), newCapacity * sizeof(unsigned int));
+    if (buffer == 0) {
+        return false;
+    }
+
+    m_indexBuffer = buffer;
+    m_indices.Grow(newCapacity);
+
+    // The element buffer binding is VAO state, every pool has to pick up the new one
+    for (const Pool& pool : m_pools) {
+        for (GLuint vao : {pool.vao, pool.instancedVao}) {
+            glBindVertexArray(vao);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+        }
+    }
+    glBindVertexArray(0);
+    if (oldCapacity > 0) {
+        BS_DEBUG_F(LogCategory::RENDERER, "MeshArena: Index buffer grown to %u indices", newCapacity);
+    }
+    return true;
+}
+
+GLuint MeshArena::ResizeBuffer(GLuint oldBuffer, size_t oldBytes, size_t newBytes) {
+    GLDebug::PollErrors("before MeshArena::ResizeBuffer");
+
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newBytes), nullptr, GL_STATIC_DRAW);
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        if (error == GL_OUT_OF_MEMORY) {
+            BS_ERROR_F(LogCategory::RENDERER, "MeshArena: Out of GPU memory growing a buffer to %zu bytes", newBytes);
+        } else {
+            BS_ERROR_F(LogCategory::RENDERER, "MeshArena: Growing a buffer to %zu bytes failed (GL error 0x%X)",
+                       newBytes, error);
+        }
+        GLDebug::PollErrors("MeshArena::ResizeBuffer");
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+        return 0;
+    }
+
+    // Copy stays on the GPU, offsets are unchanged so every existing allocation is still good
+    if (oldBuffer != 0) {
+        glBindBuffer(GL_COPY_READ_BUFFER, oldBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(oldBytes));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteBuffers(1, &oldBuffer);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    MemoryTracker::Adjust(MemoryTag::Meshes, static_cast<int64_t>(newBytes) - static_cast<int64_t>(oldBytes));
+    return buffer;
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,242 @@
+#include "blacksite/graphics/MeshImporter.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/graphics/MeshOptimizer.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/config.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace Blacksite {
+
+namespace {
+
+// .bsmesh layout: this header, then vertexCount * floatsPerVertex floats, then indexCount uint32 indices.
+// After that lodCount levels, each a MeshCacheLodHeader followed by its vertices and indices the same way.
+// Native endianness, the cache never leaves the machine that built it.
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceStamp;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t floatsPerVertex;
+    uint32_t lodCount;
+};
+static_assert(sizeof(MeshCacheHeader) == 32, "MeshCacheHeader layout is part of the file format");
+
+struct MeshCacheLodHeader {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+};
+static_assert(sizeof(MeshCacheLodHeader) == 8, "MeshCacheLodHeader layout is part of the file format");
+
+constexpr char CACHE_MAGIC[4] = {'B', 'S', 'M', 'H'};
+constexpr uint32_t FLOATS_PER_VERTEX = MeshOptimizer::FLOATS_PER_VERTEX;
+
+// Points 'level' at the arrays starting at 'offset' and moves past them, false if they run off the end.
+// Everything is a multiple of 4 bytes, so the arrays stay aligned inside the page-aligned mapping.
+bool MapLevel(const MappedFile& file, size_t& offset, uint32_t vertexCount, uint32_t indexCount,
+              MeshCacheFile::Level& level) {
+    size_t vertexBytes = static_cast<size_t>(vertexCount) * FLOATS_PER_VERTEX * sizeof(float);
+    size_t indexBytes = static_cast<size_t>(indexCount) * sizeof(unsigned int);
+    if (offset > file.Size() || vertexBytes + indexBytes > file.Size() - offset)
+        return false;
+
+    level.vertices = reinterpret_cast<const float*>(file.Data() + offset);
+    level.vertexFloatCount = static_cast<size_t>(vertexCount) * FLOATS_PER_VERTEX;
+    level.indices = reinterpret_cast<const unsigned int*>(file.Data() + offset + vertexBytes);
+    level.indexCount = indexCount;
+    offset += vertexBytes + indexBytes;
+    return true;
+}
+
+bool IndicesInRange(const MeshCacheFile::Level& level) {
+    size_t vertexCount = level.vertexFloatCount / FLOATS_PER_VERTEX;
+    for (size_t i = 0; i < level.indexCount; ++i) {
+        if (level.indices[i] >= vertexCount)
+            return false;
+    }
+    return true;
+}
+
+bool WriteLevel(std::ofstream& file, const MeshAsset& mesh) {
+    file.write(reinterpret_cast<const char*>(mesh.vertices.data()),
+               static_cast<std::streamsize>(mesh.vertices.size() / FLOATS_PER_VERTEX * FLOATS_PER_VERTEX *
+                                            sizeof(float)));
+    file.write(reinterpret_cast<const char*>(mesh.indices.data()),
+               static_cast<std::streamsize>(mesh.indices.size() * sizeof(unsigned int)));
+    return static_cast<bool>(file);
+}
+
+}  // namespace
+
+bool MeshCacheFile::Open(const std::string& path, uint64_t sourceStamp) {
+    Close();
+    if (!m_file.Open(path, sizeof(MeshCacheHeader)))
+        return false;
+    const uint8_t* data = m_file.Data();
+
+    MeshCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    size_t offset = sizeof(header);
+    bool valid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                 header.version == MeshImporter::CACHE_VERSION && header.floatsPerVertex == FLOATS_PER_VERTEX &&
+                 (sourceStamp == 0 || header.sourceStamp == sourceStamp) &&
+                 header.lodCount <= MeshImporter::MAX_CACHED_LODS &&
+                 MapLevel(m_file, offset, header.vertexCount, header.indexCount, m_base);
+    m_lods.resize(valid ? header.lodCount : 0);
+    for (Level& lod : m_lods) {
+        MeshCacheLodHeader lodHeader;
+        valid = valid && offset + sizeof(lodHeader) <= m_file.Size();
+        if (!valid)
+            break;
+        std::memcpy(&lodHeader, data + offset, sizeof(lodHeader));
+        offset += sizeof(lodHeader);
+        valid = MapLevel(m_file, offset, lodHeader.vertexCount, lodHeader.indexCount, lod);
+    }
+    if (!valid || offset != m_file.Size()) {
+        BS_DEBUG_F(LogCategory::RENDERER, "Mesh cache '%s' is stale or malformed, ignoring it", path.c_str());
+        Close();
+        return false;
+    }
+
+    // GL reads all of it on upload anyway, might as well make sure a bad index can't get that far
+    bool inRange = IndicesInRange(m_base);
+    for (const Level& lod : m_lods) {
+        inRange = inRange && IndicesInRange(lod);
+    }
+    if (!inRange) {
+        BS_WARN_F(LogCategory::RENDERER, "Mesh cache '%s' has out of range indices, ignoring it", path.c_str());
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MeshCacheFile::Close() {
+    m_file.Close();
+    m_base = Level{};
+    m_lods.clear();
+}
+
+bool MeshImporter::Import(const std::string& sourcePath, MeshAsset& out) {
+    out = MeshAsset{};
+
+    // Points and lines get dropped, everything else ends up as welded triangles
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+    const aiScene* scene = importer.ReadFile(
+        sourcePath, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices |
+                        aiProcess_PreTransformVertices | aiProcess_FindDegenerates | aiProcess_SortByPType |
+                        aiProcess_OptimizeMeshes);
+    if (!scene) {
+        BS_ERROR_F(LogCategory::RENDERER, "Failed to import mesh '%s': %s", sourcePath.c_str(),
+                   importer.GetErrorString());
+        return false;
+    }
+
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+        const aiMesh* mesh = scene->mMeshes[m];
+        if (!(mesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE))
+            continue;
+
+        unsigned int base = static_cast<unsigned int>(out.vertices.size() / FLOATS_PER_VERTEX);
+        out.vertices.reserve(out.vertices.size() + mesh->mNumVertices * FLOATS_PER_VERTEX);
+        for (unsigned int v = 0; v < mesh->mNumVertices; ++v) {
+            const aiVector3D& position = mesh->mVertices[v];
+            aiVector3D normal = mesh->HasNormals() ? mesh->mNormals[v] : aiVector3D{0.0f, 1.0f, 0.0f};
+            out.vertices.insert(out.vertices.end(), {position.x, position.y, position.z, normal.x, normal.y, normal.z});
+        }
+
+        out.indices.reserve(out.indices.size() + mesh->mNumFaces * 3);
+        for (unsigned int f = 0; f < mesh->mNumFaces; ++f) {
+            const aiFace& face = mesh->mFaces[f];
+            if (face.mNumIndices != 3)
+                continue;
+            out.indices.insert(out.indices.end(),
+                               {base + face.mIndices[0], base + face.mIndices[1], base + face.mIndices[2]});
+        }
+    }
+
+    if (out.indices.empty()) {
+        BS_ERROR_F(LogCategory::RENDERER, "Mesh '%s' has no triangles", sourcePath.c_str());
+        return false;
+    }
+
+    // Done once here, the cache stores the optimized order
+    MeshOptimizer::Optimize(out.vertices, out.indices);
+    BS_INFO_F(LogCategory::RENDERER, "Imported mesh '%s': %zu vertices, %zu triangles", sourcePath.c_str(),
+              out.vertices.size() / FLOATS_PER_VERTEX, out.indices.size() / 3);
+    return true;
+}
+
+bool MeshImporter::WriteCache(const std::string& cachePath, uint64_t sourceStamp, const MeshAsset& mesh) {
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.sourceStamp = sourceStamp;
+    header.vertexCount = static_cast<uint32_t>(mesh.vertices.size() / FLOATS_PER_VERTEX);
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.floatsPerVertex = FLOATS_PER_VERTEX;
+    header.lodCount = static_cast<uint32_t>(std::min<size_t>(mesh.lods.size(), MAX_CACHED_LODS));
+
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            BS_WARN_F(LogCategory::RENDERER, "Can't write mesh cache '%s'", tempPath.c_str());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        bool written = WriteLevel(file, mesh);
+        for (uint32_t i = 0; i < header.lodCount && written; ++i) {
+            const MeshAsset& lod = mesh.lods[i];
+            MeshCacheLodHeader lodHeader{static_cast<uint32_t>(lod.vertices.size() / FLOATS_PER_VERTEX),
+                                         static_cast<uint32_t>(lod.indices.size())};
+            file.write(reinterpret_cast<const char*>(&lodHeader), sizeof(lodHeader));
+            written = WriteLevel(file, lod);
+        }
+        if (!written) {
+            BS_WARN_F(LogCategory::RENDERER, "Failed writing mesh cache '%s'", tempPath.c_str());
+            file.close();
+            std::error_code ignored;
+            std::filesystem::remove(tempPath, ignored);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        BS_WARN_F(LogCategory::RENDERER, "Can't move mesh cache into place at '%s': %s", cachePath.c_str(),
+                  error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+uint64_t MeshImporter::GetSourceStamp(const std::string& sourcePath) {
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(sourcePath, error);
+    if (error)
+        return 0;
+    auto modified = std::filesystem::last_write_time(sourcePath, error);
+    if (error)
+        return 0;
+
+    // FNV-style fold, good enough to notice the file being saved again
+    uint64_t stamp = 14695981039346656037ull;
+    stamp = (stamp ^ size) * 1099511628211ull;
+    stamp = (stamp ^ static_cast<uint64_t>(modified.time_since_epoch().count())) * 1099511628211ull;
+    return stamp != 0 ? stamp : 1;
+}
+
+}  // namespace Blacksite
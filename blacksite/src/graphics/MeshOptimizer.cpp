@@ -0,0 +1,293 @@
+#include "blacksite/graphics/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace Blacksite {
+
+namespace {
+
+// Forsyth's tuning, the simulated cache is bigger than any real one so it works everywhere
+constexpr int CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+constexpr uint32_t NO_TRIANGLE = 0xFFFFFFFFu;
+
+float VertexScore(int cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0)
+        return -1.0f;  // Nothing left to draw with it
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        // The last triangle's vertices get a fixed score, so the next one doesn't just reuse the same edge
+        if (cachePosition < 3) {
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            const float scaler = 1.0f / (CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+
+    // Vertices with few triangles left get finished off first, no orphans left at the end
+    score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+}  // namespace
+
+void MeshOptimizer::Optimize(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    if (indices.empty()) {
+        WeldVertices(vertices, indices);
+    }
+    OptimizeVertexCache(indices, vertices.size() / FLOATS_PER_VERTEX);
+    OptimizeVertexFetch(vertices, indices);
+}
+
+void MeshOptimizer::WeldVertices(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    size_t vertexCount = vertices.size() / FLOATS_PER_VERTEX;
+    auto vertexAt = [&vertices](unsigned int v) { return &vertices[v * FLOATS_PER_VERTEX]; };
+
+    // Sort vertex ids by their bytes, equal vertices end up next to each other
+    std::vector<unsigned int> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        return std::memcmp(vertexAt(a), vertexAt(b), FLOATS_PER_VERTEX * sizeof(float)) < 0;
+    });
+
+    std::vector<float> welded;
+    welded.reserve(vertices.size());
+    indices.assign(vertexCount, 0);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        bool same = i > 0 && std::memcmp(vertexAt(order[i]), vertexAt(order[i - 1]),
+                                         FLOATS_PER_VERTEX * sizeof(float)) == 0;
+        if (!same) {
+            welded.insert(welded.end(), vertexAt(order[i]), vertexAt(order[i]) + FLOATS_PER_VERTEX);
+        }
+        indices[order[i]] = static_cast<unsigned int>(welded.size() / FLOATS_PER_VERTEX - 1);
+    }
+    vertices.swap(welded);
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // Vertex -> triangles it's in, packed into one array. remaining[v] = how many of those aren't emitted
+    // yet, they're kept at the front of the vertex's range.
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (unsigned int index : indices) {
+        remaining[index]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            adjacency[cursor[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    uint32_t best = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+                           vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[best]) {
+            best = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    unsigned int cache[CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scanCursor = 0;  // Fallback when nothing in the cache has triangles left
+
+    while (best != NO_TRIANGLE) {
+        const unsigned int* triangle = &indices[best * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+        emitted[best] = 1;
+
+        // Take the triangle out of its vertices' lists
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = triangle[k];
+            uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t i = 0; i < remaining[v]; ++i) {
+                if (list[i] == best) {
+                    std::swap(list[i], list[remaining[v] - 1]);
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+
+        // Its vertices go to the front of the cache, everything else shifts back
+        unsigned int newCache[CACHE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            newCache[newCount++] = triangle[k];
+        }
+        for (int i = 0; i < cacheCount; ++i) {
+            unsigned int v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                newCache[newCount++] = v;
+            }
+        }
+
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            cachePosition[v] = i < CACHE_SIZE ? i : -1;  // Past the end = fell out
+            vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+        }
+
+        // Only triangles touching the cache changed score, the next one comes from those
+        best = NO_TRIANGLE;
+        float bestScore = -1.0f;
+        for (int i = 0; i < newCount; ++i) {
+            unsigned int v = newCache[i];
+            const uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t j = 0; j < remaining[v]; ++j) {
+                uint32_t t = list[j];
+                const unsigned int* tri = &indices[t * 3];
+                triangleScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, CACHE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+
+        if (best == NO_TRIANGLE) {
+            while (scanCursor < triangleCount && emitted[scanCursor]) {
+                scanCursor++;
+            }
+            if (scanCursor < triangleCount) {
+                best = static_cast<uint32_t>(scanCursor);
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<float>& vertices, std::vector<unsigned int>& indices) {
+    const unsigned int UNUSED = 0xFFFFFFFFu;
+    std::vector<unsigned int> remap(vertices.size() / FLOATS_PER_VERTEX, UNUSED);
+    std::vector<float> reordered;
+    reordered.reserve(vertices.size());
+
+    unsigned int next = 0;
+    for (unsigned int& index : indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = next++;
+            const float* vertex = &vertices[index * FLOATS_PER_VERTEX];
+            reordered.insert(reordered.end(), vertex, vertex + FLOATS_PER_VERTEX);
+        }
+        index = remap[index];
+    }
+    vertices.swap(reordered);
+}
+
+void MeshOptimizer::SimplifyClustered(const float* vertices, size_t floatCount, const unsigned int* indices,
+                                      size_t indexCount, int gridResolution, std::vector<float>& outVertices,
+                                      std::vector<unsigned int>& outIndices) {
+    outVertices.clear();
+    outIndices.clear();
+    size_t vertexCount = floatCount / FLOATS_PER_VERTEX;
+    if (vertexCount == 0 || gridResolution < 1)
+        return;
+
+    float boundsMin[3] = {vertices[0], vertices[1], vertices[2]};
+    float boundsMax[3] = {vertices[0], vertices[1], vertices[2]};
+    for (size_t v = 0; v < vertexCount; ++v) {
+        for (int axis = 0; axis < 3; ++axis) {
+            boundsMin[axis] = std::min(boundsMin[axis], vertices[v * FLOATS_PER_VERTEX + axis]);
+            boundsMax[axis] = std::max(boundsMax[axis], vertices[v * FLOATS_PER_VERTEX + axis]);
+        }
+    }
+    float extent =
+        std::max(boundsMax[0] - boundsMin[0], std::max(boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2]));
+    float cellSize = extent > 0.0f ? extent / gridResolution : 1.0f;
+
+    // Cell coordinates get 20 bits each, the normal bin (dominant axis + sign) the last few
+    struct Cluster {
+        float position[3] = {0.0f, 0.0f, 0.0f};
+        float normal[3] = {0.0f, 0.0f, 0.0f};
+        uint32_t count = 0;
+    };
+    std::unordered_map<uint64_t, uint32_t> clusterIds;
+    std::vector<Cluster> clusters;
+    std::vector<uint32_t> remap(vertexCount);
+
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const float* vertex = &vertices[v * FLOATS_PER_VERTEX];
+        uint64_t key = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            uint64_t cell = static_cast<uint64_t>((vertex[axis] - boundsMin[axis]) / cellSize) & 0xFFFFF;
+            key = (key << 20) | cell;
+        }
+
+        int dominant = 0;
+        for (int axis = 1; axis < 3; ++axis) {
+            if (std::fabs(vertex[3 + axis]) > std::fabs(vertex[3 + dominant]))
+                dominant = axis;
+        }
+        key = (key << 3) | static_cast<uint64_t>(dominant * 2 + (vertex[3 + dominant] < 0.0f ? 1 : 0));
+
+        auto [it, inserted] = clusterIds.emplace(key, static_cast<uint32_t>(clusters.size()));
+        if (inserted) {
+            clusters.emplace_back();
+        }
+        Cluster& cluster = clusters[it->second];
+        for (int k = 0; k < 3; ++k) {
+            cluster.position[k] += vertex[k];
+            cluster.normal[k] += vertex[3 + k];
+        }
+        cluster.count++;
+        remap[v] = it->second;
+    }
+
+    // Each cluster becomes the average of what went into it
+    outVertices.reserve(clusters.size() * FLOATS_PER_VERTEX);
+    for (const Cluster& cluster : clusters) {
+        float length = std::sqrt(cluster.normal[0] * cluster.normal[0] + cluster.normal[1] * cluster.normal[1] +
+                                 cluster.normal[2] * cluster.normal[2]);
+        float scale = length > 0.0f ? 1.0f / length : 0.0f;
+        outVertices.insert(outVertices.end(),
+                           {cluster.position[0] / cluster.count, cluster.position[1] / cluster.count,
+                            cluster.position[2] / cluster.count, cluster.normal[0] * scale, cluster.normal[1] * scale,
+                            cluster.normal[2] * scale});
+    }
+
+    // Triangles with two corners in the same cluster are gone
+    for (size_t t = 0; t + 2 < indexCount; t += 3) {
+        uint32_t a = remap[indices[t]];
+        uint32_t b = remap[indices[t + 1]];
+        uint32_t c = remap[indices[t + 2]];
+        if (a != b && b != c && a != c) {
+            outIndices.insert(outIndices.end(), {a, b, c});
+        }
+    }
+}
+
+}  // namespace Blacksite
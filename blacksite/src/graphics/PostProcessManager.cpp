@@ -1,10 +1,44 @@
 #include "blacksite/graphics/PostProcessManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/GLDebug.h"
+#include "blacksite/graphics/GpuProfiler.h"
+#include "blacksite/graphics/ShaderManager.h"
 #include "blacksite/graphics/ShaderSystem.h"
 
 namespace Blacksite {
 
+namespace {
+
+// 1 - the used fraction of the texture, what uTexCoordTrim in the post-process vertex shader wants
+glm::vec2 TexCoordTrim(const FrameBuffer& fb) {
+    return glm::vec2(1.0f - static_cast<float>(fb.width) / fb.textureWidth,
+                     1.0f - static_cast<float>(fb.height) / fb.textureHeight);
+}
+
+// Last texel center inside the used area, filters clamp to it so they never pick up stale texels past the edge
+glm::vec2 UvMax(const FrameBuffer& fb) {
+    return glm::vec2((fb.width - 0.5f) / fb.textureWidth, (fb.height - 0.5f) / fb.textureHeight);
+}
+
+glm::vec2 TexelSize(const FrameBuffer& fb) {
+    return glm::vec2(1.0f / fb.textureWidth, 1.0f / fb.textureHeight);
+}
+
+// Keep the current texture size while it still fits and we haven't shrunk too far below it, else re-bucket
+int FitTextureSize(int current, int wanted, float shrinkHysteresis) {
+    if (wanted <= current && wanted >= current * shrinkHysteresis) {
+        return current;
+    }
+    return RenderTargetPool::BucketSize(wanted);
+}
+
+}  // namespace
+
 PostProcessManager::PostProcessManager() {
     BS_DEBUG(LogCategory::RENDERER, "PostProcessManager created");
 }
@@ -37,7 +71,7 @@ bool PostProcessManager::Initialize(int width, int height, ShaderSystem* shaderS
 
     // Load and validate all required shaders
     auto& shaderManager = m_shaderSystem->GetShaderManager();
-    std::vector<std::string> requiredShaders = {"postprocess", "blur", "bloom", "fxaa"};
+    std::vector<std::string> requiredShaders = {"postprocess", "bloom", "bloom_downsample", "bloom_upsample", "fxaa"};
 
     for (const auto& shaderName : requiredShaders) {
         if (!m_shaderSystem->HasShader(shaderName)) {
@@ -54,8 +88,16 @@ bool PostProcessManager::Initialize(int width, int height, ShaderSystem* shaderS
         }
     }
 
-    // Create framebuffers and screen quad
-    CreateFrameBuffers();
+    // The compute path is optional, without it we just keep using the quad passes
+    m_computeAvailable = ShaderManager::IsComputeSupported() &&
+                         (m_shaderSystem->HasShader("composite_fxaa") ||
+                          shaderManager.LoadShaderFromLibrary("composite_fxaa"));
+    BS_INFO_F(LogCategory::RENDERER, "Post-process composite: %s",
+              m_computeAvailable ? "compute (fused tone map + FXAA)" : "fragment passes");
+
+    // Create the scene target and screen quad, the rest is acquired per frame
+    AcquireMainBuffer(RenderTargetPool::BucketSize(width), RenderTargetPool::BucketSize(height));
+    ApplyRenderScale();
     CreateScreenQuad();
 
     // Validate everything was created successfully
@@ -70,7 +112,7 @@ bool PostProcessManager::Initialize(int width, int height, ShaderSystem* shaderS
     m_settings.gamma = 2.2f;
     m_settings.bloomThreshold = 0.8f;
     m_settings.bloomStrength = 0.2f;
-    m_settings.bloomBlurPasses = 3;
+    m_settings.bloomQuality = BloomQuality::Medium;
     m_settings.enableBloom = true;
     m_settings.enableFXAA = true;
     m_settings.enableToneMapping = true;
@@ -87,7 +129,23 @@ void PostProcessManager::Shutdown() {
 
     BS_INFO(LogCategory::RENDERER, "Shutting down PostProcessManager");
 
-    DeleteFrameBuffers();
+    DetachEntityIdBuffer();
+    if (m_pickFence) {
+        glDeleteSync(m_pickFence);
+        m_pickFence = nullptr;
+    }
+    if (m_pickBuffer) {
+        glDeleteBuffers(1, &m_pickBuffer);
+        m_pickBuffer = 0;
+    }
+    m_pickRequested = false;
+    m_pickReady = false;
+
+    m_bloomMips.clear();
+    m_graph.Reset();
+    m_targetPool.Clear();
+    m_mainBuffer = FrameBuffer{};
+    m_fxaaBuffer = FrameBuffer{};
 
     if (m_quadVAO) {
         glDeleteVertexArrays(1, &m_quadVAO);
@@ -116,8 +174,21 @@ void PostProcessManager::OnWindowResize(int width, int height) {
     m_width = width;
     m_height = height;
 
-    DeleteFrameBuffers();
-    CreateFrameBuffers();
+    // Growing inside the bucket or shrinking a little keeps the textures, we just draw into less of them.
+    // Dragging a dock splitter is mostly this case and costs nothing.
+    int textureWidth = FitTextureSize(m_mainBuffer.textureWidth, width, SHRINK_HYSTERESIS);
+    int textureHeight = FitTextureSize(m_mainBuffer.textureHeight, height, SHRINK_HYSTERESIS);
+    if (textureWidth == m_mainBuffer.textureWidth && textureHeight == m_mainBuffer.textureHeight) {
+        ApplyRenderScale();
+        return;
+    }
+
+    // The old one goes back to the pool, a drag back to that size within EVICT_FRAMES gets it again.
+    // The id buffer comes back at the new size on the next BeginFrame.
+    DetachEntityIdBuffer();
+    m_targetPool.Release(m_mainBuffer);
+    AcquireMainBuffer(textureWidth, textureHeight);
+    ApplyRenderScale();
 
     CheckGLError("Window resize");
 }
@@ -128,13 +199,26 @@ void PostProcessManager::BeginFrame() {
         return;
     }
 
+    UpdateRenderScale();
+    UpdateEntityIdBuffer();
+
     // Bind main framebuffer for scene rendering
     BindFrameBuffer(m_mainBuffer);
-    glViewport(0, 0, m_width, m_height);
+    glViewport(0, 0, m_renderWidth, m_renderHeight);
 
     // Clear with default clear color
     glClearColor(0.f, 0.f, 0.f, 0.f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    if (m_entityIdTexture) {
+        // glClear on an integer attachment is undefined, each one gets its own clear
+        const GLfloat clearColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        const GLuint noEntity[4] = {0, 0, 0, 0};
+        glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);  // The renderer masks it per shader, clears obey that
+        glClearBufferfv(GL_COLOR, 0, clearColor);
+        glClearBufferuiv(GL_COLOR, 1, noEntity);
+        glClear(GL_DEPTH_BUFFER_BIT);
+    } else {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
 
     // Ensure proper 3D rendering state
     // glEnable(GL_DEPTH_TEST);
@@ -155,6 +239,10 @@ void PostProcessManager::EndFrame() {
     GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
     GLboolean cullFace = glIsEnabled(GL_CULL_FACE);
 
+    // The scene is done, so this frame's ids are what a pick sees
+    ResolvePick();
+    IssuePickRead();
+
     // Unbind framebuffer and prepare for post-processing
     UnbindFrameBuffer();
     glDisable(GL_DEPTH_TEST);
@@ -162,18 +250,8 @@ void PostProcessManager::EndFrame() {
 
     try {
         // Execute post-processing pipeline
-        if (m_settings.enableBloom) {
-            ExtractBloom();
-            BlurBloom();
-        }
-
-        // Final composite and tone mapping
-        CombineAndToneMap();
-
-        // Apply FXAA if enabled
-        if (m_settings.enableFXAA) {
-            ApplyFXAA();
-        }
+        BuildGraph();
+        m_graph.Execute(m_targetPool, m_gpuProfiler);
     } catch (const std::exception& e) {
         BS_ERROR_F(LogCategory::RENDERER, "Post-processing error: {}", e.what());
     }
@@ -186,90 +264,357 @@ void PostProcessManager::EndFrame() {
     if (cullFace)
         glEnable(GL_CULL_FACE);
 
+    m_bloomMips.clear();
+    m_fxaaBuffer = FrameBuffer{};
+    m_targetPool.EndFrame();
+
     CheckGLError("EndFrame");
 }
 
-void PostProcessManager::CreateFrameBuffers() {
-    BS_DEBUG(LogCategory::RENDERER, "Creating framebuffers");
+void PostProcessManager::UpdateRenderScale() {
+    if (!m_settings.dynamicResolution) {
+        if (m_renderScale != 1.0f) {
+            m_renderScale = 1.0f;
+            ApplyRenderScale();
+        }
+        return;
+    }
 
-    // Main scene buffer (full resolution with depth)
-    if (!CreateFrameBuffer(m_mainBuffer, m_width, m_height, true)) {
-        BS_ERROR(LogCategory::RENDERER, "Failed to create main framebuffer");
+    // Only a new GPU sample can move the scale, and it's already FRAME_LATENCY - 1 frames old
+    if (!m_gpuProfiler || !m_gpuProfiler->IsEnabled() || m_gpuProfiler->GetHistoryOffset() == m_lastGpuSample) {
+        return;
+    }
+    m_lastGpuSample = m_gpuProfiler->GetHistoryOffset();
+    float gpuMs = m_gpuProfiler->GetFrameMs();
+    if (m_scaleCooldown > 0) {
+        --m_scaleCooldown;
+        return;
+    }
+    if (gpuMs <= 0.0f) {
         return;
     }
+    m_smoothedGpuMs = m_smoothedGpuMs > 0.0f ? m_smoothedGpuMs + (gpuMs - m_smoothedGpuMs) * 0.2f : gpuMs;
+
+    float minScale = std::clamp(m_settings.minRenderScale, 0.25f, 1.0f);
+    float maxScale = std::clamp(m_settings.maxRenderScale, minScale, 1.0f);
+    float budget = std::max(m_settings.gpuBudgetMs, 0.5f);
 
-    // Bloom buffers (half resolution for performance)
-    int bloomWidth = std::max(1, m_width / 2);
-    int bloomHeight = std::max(1, m_height / 2);
+    // Between 80% and 100% of the budget is close enough, moving in there just makes the image pump
+    float wanted = std::clamp(m_renderScale, minScale, maxScale);
+    if (m_smoothedGpuMs > budget || m_smoothedGpuMs < budget * 0.8f) {
+        // Cost goes roughly with pixel count, so with the square of the scale. Aim for 90% of the budget.
+        float ideal = m_renderScale * std::sqrt(budget * 0.9f / m_smoothedGpuMs);
+        wanted = std::clamp(ideal, m_renderScale - MAX_SCALE_DOWN, m_renderScale + MAX_SCALE_UP);
+        wanted = std::clamp(std::round(wanted / RENDER_SCALE_STEP) * RENDER_SCALE_STEP, minScale, maxScale);
+    }
 
-    if (!CreateFrameBuffer(m_bloomBuffer, bloomWidth, bloomHeight, false)) {
-        BS_ERROR(LogCategory::RENDERER, "Failed to create bloom framebuffer");
+    if (wanted != m_renderScale) {
+        BS_DEBUG_F(LogCategory::RENDERER, "Render scale %.2f -> %.2f (GPU %.2f ms, budget %.2f ms)", m_renderScale,
+                   wanted, m_smoothedGpuMs, budget);
+        m_renderScale = wanted;
+        m_smoothedGpuMs = 0.0f;
+        m_scaleCooldown = GpuProfiler::FRAME_LATENCY;
+        ApplyRenderScale();
+    }
+}
+
+void PostProcessManager::ApplyRenderScale() {
+    // Never bigger than the window, so it always fits the main texture and nothing gets reallocated
+    m_renderWidth = std::clamp(static_cast<int>(std::lround(m_width * m_renderScale)), 1, m_width);
+    m_renderHeight = std::clamp(static_cast<int>(std::lround(m_height * m_renderScale)), 1, m_height);
+    m_mainBuffer.width = std::min(m_renderWidth, m_mainBuffer.textureWidth);
+    m_mainBuffer.height = std::min(m_renderHeight, m_mainBuffer.textureHeight);
+}
+
+void PostProcessManager::UpdateEntityIdBuffer() {
+    if (m_entityIdTexture && (!m_settings.entityIdBuffer || m_entityIdFBO != m_mainBuffer.FBO)) {
+        DetachEntityIdBuffer();
+    }
+    if (m_settings.entityIdBuffer && !m_entityIdTexture && m_mainBuffer.FBO && !AttachEntityIdBuffer()) {
+        m_settings.entityIdBuffer = false;  // Don't retry every frame
+    }
+}
+
+bool PostProcessManager::AttachEntityIdBuffer() {
+    // Same size as the main texture, so the scene viewport and sub-rect apply to both
+    glGenTextures(1, &m_entityIdTexture);
+    glBindTexture(GL_TEXTURE_2D, m_entityIdTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, m_mainBuffer.textureWidth, m_mainBuffer.textureHeight, 0,
+                 GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);  // Integer textures can't filter
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_mainBuffer.FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_entityIdTexture, 0);
+    const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+    m_entityIdFBO = m_mainBuffer.FBO;
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        BS_ERROR_F(LogCategory::RENDERER, "Entity id buffer left the main framebuffer incomplete (0x%x)", status);
+        DetachEntityIdBuffer();
+        return false;
+    }
+
+    BS_DEBUG_F(LogCategory::RENDERER, "Entity id buffer %dx%d", m_mainBuffer.textureWidth,
+               m_mainBuffer.textureHeight);
+    return true;
+}
+
+void PostProcessManager::DetachEntityIdBuffer() {
+    if (!m_entityIdTexture) {
         return;
     }
 
-    if (!CreateFrameBuffer(m_blurBuffer1, bloomWidth, bloomHeight, false)) {
-        BS_ERROR(LogCategory::RENDERER, "Failed to create blur buffer 1");
+    // Pooled FBOs get handed to whoever asks next, put it back the way the pool made it
+    glBindFramebuffer(GL_FRAMEBUFFER, m_entityIdFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, 0, 0);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glDeleteTextures(1, &m_entityIdTexture);
+    m_entityIdTexture = 0;
+    m_entityIdFBO = 0;
+}
+
+void PostProcessManager::RequestPick(int x, int y) {
+    if (!m_settings.entityIdBuffer) {
+        BS_WARN(LogCategory::RENDERER, "RequestPick needs the entity id buffer (PostProcessSettings::entityIdBuffer)");
         return;
     }
 
-    if (!CreateFrameBuffer(m_blurBuffer2, bloomWidth, bloomHeight, false)) {
-        BS_ERROR(LogCategory::RENDERER, "Failed to create blur buffer 2");
+    // A newer click wins over one that hasn't gone out yet
+    m_pickRequested = true;
+    m_pickX = x;
+    m_pickY = y;
+}
+
+bool PostProcessManager::PollPick(int& entityId) {
+    if (!m_pickReady) {
+        return false;
+    }
+    m_pickReady = false;
+    entityId = m_pickValue == 0 ? -1 : static_cast<int>(m_pickValue - 1);
+    return true;
+}
+
+void PostProcessManager::IssuePickRead() {
+    // One read in flight at a time, a request made meanwhile goes out once it's back
+    if (!m_pickRequested || m_pickFence || !m_entityIdTexture || m_width <= 0 || m_height <= 0) {
         return;
     }
+    m_pickRequested = false;
 
-    // FXAA buffer (full resolution)
-    if (!CreateFrameBuffer(m_fxaaBuffer, m_width, m_height, false)) {
-        BS_ERROR(LogCategory::RENDERER, "Failed to create FXAA framebuffer");
+    // Window pixel -> scene pixel, the scene may be rendering at a lower scale
+    int x = static_cast<int>(static_cast<float>(m_pickX) * m_renderWidth / m_width);
+    int y = static_cast<int>(static_cast<float>(m_pickY) * m_renderHeight / m_height);
+    if (x < 0 || y < 0 || x >= m_mainBuffer.width || y >= m_mainBuffer.height) {
+        m_pickValue = 0;
+        m_pickReady = true;
         return;
     }
 
-    CheckGLError("CreateFrameBuffers");
-    BS_DEBUG(LogCategory::RENDERER, "All framebuffers created successfully");
+    if (!m_pickBuffer) {
+        glGenBuffers(1, &m_pickBuffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pickBuffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(GLuint), nullptr, GL_STREAM_READ);
+    } else {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pickBuffer);
+    }
+
+    // With a pack buffer bound glReadPixels only queues the copy, the fence tells us when it's done
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_mainBuffer.FBO);
+    glReadBuffer(GL_COLOR_ATTACHMENT1);
+    glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_pickFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    CheckGLError("Pick read");
 }
 
-bool PostProcessManager::CreateFrameBuffer(FrameBuffer& fb, int width, int height, bool needDepth) {
-    fb.width = width;
-    fb.height = height;
+void PostProcessManager::ResolvePick() {
+    if (!m_pickFence) {
+        return;
+    }
 
-    // Create framebuffer
-    glGenFramebuffers(1, &fb.FBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, fb.FBO);
+    // Zero timeout - just asking. The swap flushed the fence, so it does come through.
+    GLenum status = glClientWaitSync(m_pickFence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return;
+    }
+    glDeleteSync(m_pickFence);
+    m_pickFence = nullptr;
+    if (status == GL_WAIT_FAILED) {
+        BS_WARN(LogCategory::RENDERER, "Pick read fence failed, dropping the pick");
+        return;
+    }
 
-    // Create color texture
-    glGenTextures(1, &fb.colorTexture);
-    glBindTexture(GL_TEXTURE_2D, fb.colorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fb.colorTexture, 0);
-
-    // Create depth texture if needed
-    if (needDepth) {
-        glGenTextures(1, &fb.depthTexture);
-        glBindTexture(GL_TEXTURE_2D, fb.depthTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, fb.depthTexture, 0);
-    }
-
-    // Check framebuffer completeness
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE) {
-        BS_ERROR_F(LogCategory::RENDERER, "Framebuffer not complete! Status: 0x{:X}", status);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pickBuffer);
+    if (void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT)) {
+        std::memcpy(&m_pickValue, data, sizeof(GLuint));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        m_pickReady = true;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+glm::vec2 PostProcessManager::GetSceneUvScale() const {
+    if (m_mainBuffer.textureWidth == 0 || m_mainBuffer.textureHeight == 0) {
+        return glm::vec2(1.0f);
+    }
+    return glm::vec2(static_cast<float>(m_mainBuffer.width) / m_mainBuffer.textureWidth,
+                     static_cast<float>(m_mainBuffer.height) / m_mainBuffer.textureHeight);
+}
+
+bool PostProcessManager::AcquireMainBuffer(int textureWidth, int textureHeight) {
+    // Main scene buffer (full resolution with depth)
+    if (!AcquireTarget(m_mainBuffer, m_width, m_height, textureWidth, textureHeight, true)) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to create main framebuffer");
         return false;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    CheckGLError("CreateFrameBuffer");
+    BS_DEBUG_F(LogCategory::RENDERER, "Main framebuffer %dx%d (texture %dx%d)", m_width, m_height, textureWidth,
+               textureHeight);
+    return true;
+}
+
+bool PostProcessManager::AcquireTarget(FrameBuffer& fb, int width, int height, int textureWidth, int textureHeight,
+                                       bool needDepth, GLenum colorFormat) {
+    if (!m_targetPool.Acquire(fb, textureWidth, textureHeight, colorFormat, needDepth)) {
+        fb = FrameBuffer{};
+        return false;
+    }
+
+    fb.width = std::min(width, textureWidth);
+    fb.height = std::min(height, textureHeight);
     return true;
 }
 
+void PostProcessManager::BuildGraph() {
+    m_graph.Reset();
+
+    FrameBuffer screenBuffer;
+    screenBuffer.width = screenBuffer.textureWidth = m_width;
+    screenBuffer.height = screenBuffer.textureHeight = m_height;
+    RenderResource scene = m_graph.Import("scene", m_mainBuffer);
+    RenderResource screen = m_graph.Import("screen", screenBuffer, true);
+
+    // Bloom passes always go in - when bloom is off nothing reads the chain and the graph culls them
+    std::vector<RenderResource> bloom = DeclareBloomChain();
+    auto useBloom = [this, bloom](const RenderGraph& graph, size_t count) {
+        m_bloomMips.clear();
+        for (size_t i = 0; i < count && graph.GetTarget(bloom[i]).FBO != 0; ++i) {
+            m_bloomMips.push_back(graph.GetTarget(bloom[i]));
+        }
+    };
+    if (!bloom.empty()) {
+        auto down = m_graph.AddPass("bloom_downsample", [this, useBloom, bloom](const RenderGraph& graph) {
+            useBloom(graph, bloom.size());
+            DownsampleBloom();
+        });
+        m_graph.Read(down, scene);
+        auto up = m_graph.AddPass("bloom_upsample", [this, useBloom, bloom](const RenderGraph& graph) {
+            useBloom(graph, bloom.size());
+            UpsampleBloom();
+        });
+        for (RenderResource mip : bloom) {
+            m_graph.Write(down, mip);
+            m_graph.Read(up, mip);
+            m_graph.Write(up, mip);
+        }
+    }
+    bool readBloom = m_settings.enableBloom && !bloom.empty();
+
+    bool computePath = m_settings.useComputePath && m_computeAvailable;
+    RenderResource ldr = INVALID_RENDER_RESOURCE;
+    if (computePath || m_settings.enableFXAA) {
+        ldr = m_graph.CreateTarget("ldr", {m_renderWidth, m_renderHeight, m_mainBuffer.textureWidth,
+                                           m_mainBuffer.textureHeight});
+    }
+
+    // Only mip 0 gets read from here on, the rest of the chain is free again after the upsample
+    auto setupComposite = [this, useBloom, readBloom, ldr](const RenderGraph& graph) {
+        useBloom(graph, readBloom ? 1 : 0);
+        m_fxaaBuffer = ldr != INVALID_RENDER_RESOURCE ? graph.GetTarget(ldr) : FrameBuffer{};
+    };
+
+    if (computePath) {
+        auto composite = m_graph.AddPass("composite_fxaa", [this, setupComposite](const RenderGraph& graph) {
+            setupComposite(graph);
+            CompositeCompute();
+        });
+        m_graph.Read(composite, scene);
+        if (readBloom) {
+            m_graph.Read(composite, bloom[0]);
+        }
+        m_graph.Write(composite, ldr);
+        m_graph.Write(composite, screen);
+        return;
+    }
+
+    // Final composite and tone mapping, into the LDR target when FXAA runs after it
+    auto composite = m_graph.AddPass("composite", [this, setupComposite](const RenderGraph& graph) {
+        setupComposite(graph);
+        CombineAndToneMap();
+    });
+    m_graph.Read(composite, scene);
+    if (readBloom) {
+        m_graph.Read(composite, bloom[0]);
+    }
+    m_graph.Write(composite, m_settings.enableFXAA ? ldr : screen);
+
+    // Apply FXAA if enabled
+    if (m_settings.enableFXAA) {
+        auto fxaa = m_graph.AddPass("fxaa", [this, ldr](const RenderGraph& graph) {
+            m_fxaaBuffer = graph.GetTarget(ldr);
+            ApplyFXAA();
+        });
+        m_graph.Read(fxaa, ldr);
+        m_graph.Write(fxaa, screen);
+    }
+}
+
+std::vector<RenderResource> PostProcessManager::DeclareBloomChain() {
+    // Each mip is half the one before, down until it's a handful of pixels
+    int divisor = 2;
+    int mipCount = 5;
+    GLenum format = GL_R11F_G11F_B10F;  // No alpha needed, half the bandwidth of RGBA16F
+    switch (m_settings.bloomQuality) {
+        case BloomQuality::Low:
+            divisor = 4;
+            mipCount = 4;
+            break;
+        case BloomQuality::Medium:
+            break;
+        case BloomQuality::High:
+            mipCount = 6;
+            format = GL_RGBA16F;
+            break;
+    }
+
+    // Textures scale off the main texture, not the viewport, so every mip has the same used fraction
+    RenderTargetDesc desc;
+    desc.width = std::max(1, m_renderWidth / divisor);
+    desc.height = std::max(1, m_renderHeight / divisor);
+    desc.textureWidth = std::max(1, m_mainBuffer.textureWidth / divisor);
+    desc.textureHeight = std::max(1, m_mainBuffer.textureHeight / divisor);
+    desc.colorFormat = format;
+
+    std::vector<RenderResource> mips;
+    for (int i = 0; i < mipCount && desc.width >= 2 && desc.height >= 2; ++i) {
+        mips.push_back(m_graph.CreateTarget("bloom_mip" + std::to_string(i), desc));
+        desc.width /= 2;
+        desc.height /= 2;
+        desc.textureWidth /= 2;
+        desc.textureHeight /= 2;
+    }
+    return mips;
+}
+
 void PostProcessManager::CreateScreenQuad() {
     // Full-screen quad vertices (position + texcoord)
     float quadVertices[] = {// positions   // texCoords
@@ -296,32 +641,6 @@ void PostProcessManager::CreateScreenQuad() {
     CheckGLError("CreateScreenQuad");
 }
 
-void PostProcessManager::DeleteFrameBuffers() {
-    auto deleteFrameBuffer = [](FrameBuffer& fb) {
-        if (fb.FBO) {
-            glDeleteFramebuffers(1, &fb.FBO);
-            fb.FBO = 0;
-        }
-        if (fb.colorTexture) {
-            glDeleteTextures(1, &fb.colorTexture);
-            fb.colorTexture = 0;
-        }
-        if (fb.depthTexture) {
-            glDeleteTextures(1, &fb.depthTexture);
-            fb.depthTexture = 0;
-        }
-        fb.width = fb.height = 0;
-    };
-
-    deleteFrameBuffer(m_mainBuffer);
-    deleteFrameBuffer(m_bloomBuffer);
-    deleteFrameBuffer(m_blurBuffer1);
-    deleteFrameBuffer(m_blurBuffer2);
-    deleteFrameBuffer(m_fxaaBuffer);
-
-    CheckGLError("DeleteFrameBuffers");
-}
-
 void PostProcessManager::BindFrameBuffer(const FrameBuffer& fb) {
     glBindFramebuffer(GL_FRAMEBUFFER, fb.FBO);
     CheckGLError("BindFrameBuffer");
@@ -332,81 +651,88 @@ void PostProcessManager::UnbindFrameBuffer() {
     CheckGLError("UnbindFrameBuffer");
 }
 
-void PostProcessManager::ExtractBloom() {
-    if (!ValidateShader("postprocess")) {  // Use postprocess shader for extraction
-        BS_ERROR(LogCategory::RENDERER, "Postprocess shader not available");
+void PostProcessManager::DownsampleBloom() {
+    BS_PROFILE_SCOPE("PostProcess::DownsampleBloom");
+    if (m_bloomMips.empty() || !ValidateShader("bloom_downsample")) {
+        BS_ERROR(LogCategory::RENDERER, "Bloom downsample not available");
         return;
     }
 
-    BindFrameBuffer(m_bloomBuffer);
-    glViewport(0, 0, m_bloomBuffer.width, m_bloomBuffer.height);
-    glClear(GL_COLOR_BUFFER_BIT);
-
     auto& shaderManager = m_shaderSystem->GetShaderManager();
-    if (!shaderManager.UseShader("postprocess")) {  // Use postprocess shader
-        BS_ERROR(LogCategory::RENDERER, "Failed to use postprocess shader");
+    if (!shaderManager.UseShader("bloom_downsample")) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to use bloom downsample shader");
         return;
     }
 
-    // Bind main scene texture
+    // One program for the whole chain, per mip only the source, target and texel size change
+    float threshold = m_settings.bloomThreshold;
+    float knee = std::max(threshold * 0.5f, 0.0001f);
+    shaderManager.SetUniform("uThreshold", glm::vec4(threshold, threshold - knee, 2.0f * knee, 0.25f / knee));
+    shaderManager.SetUniform("uTexture", 0);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_mainBuffer.colorTexture);
-    shaderManager.SetUniform("uScreenTexture", 0);  // Correct uniform name
-    shaderManager.SetUniform("uBloomThreshold", m_settings.bloomThreshold);
-    shaderManager.SetUniform("uExtractBrightPixels", true);  // Enable extraction mode
 
-    // Set dummy values for required uniforms
-    shaderManager.SetUniform("uExposure", 1.0f);
-    shaderManager.SetUniform("uGamma", 2.2f);
+    // No clears, every pass writes every pixel of its target
+    const FrameBuffer* source = &m_mainBuffer;
+    for (size_t i = 0; i < m_bloomMips.size(); ++i) {
+        const FrameBuffer& target = m_bloomMips[i];
+        BindFrameBuffer(target);
+        glViewport(0, 0, target.width, target.height);
+
+        shaderManager.SetUniform("uPrefilter", i == 0);
+        shaderManager.SetUniform("uTexelSize", TexelSize(*source));
+        shaderManager.SetUniform("uTexCoordTrim", TexCoordTrim(*source));
+        shaderManager.SetUniform("uUvMax", UvMax(*source));
+        glBindTexture(GL_TEXTURE_2D, source->colorTexture);
+        RenderScreenQuad();
+        source = &target;
+    }
 
-    RenderScreenQuad();
-    CheckGLError("ExtractBloom");
+    CheckGLError("DownsampleBloom");
 }
 
-void PostProcessManager::BlurBloom() {
-    if (!ValidateShader("blur")) {
-        BS_ERROR(LogCategory::RENDERER, "Blur shader not available");
-        return;
+void PostProcessManager::UpsampleBloom() {
+    BS_PROFILE_SCOPE("PostProcess::UpsampleBloom");
+    if (m_bloomMips.size() < 2 || !ValidateShader("bloom_upsample")) {
+        return;  // A single mip is already the result
     }
 
     auto& shaderManager = m_shaderSystem->GetShaderManager();
-    if (!shaderManager.UseShader("blur")) {
-        BS_ERROR(LogCategory::RENDERER, "Failed to use blur shader");
+    if (!shaderManager.UseShader("bloom_upsample")) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to use bloom upsample shader");
         return;
     }
 
-    // Set blur size uniform
-    shaderManager.SetUniform("uBlurSize", 1.0f);
-
-    bool horizontal = true;
-    bool firstIteration = true;
-
-    for (int i = 0; i < m_settings.bloomBlurPasses * 2; i++) {
-        FrameBuffer& targetBuffer = horizontal ? m_blurBuffer2 : m_blurBuffer1;
-        BindFrameBuffer(targetBuffer);
-        glViewport(0, 0, targetBuffer.width, targetBuffer.height);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        shaderManager.SetUniform("uHorizontal", horizontal);
-
-        glActiveTexture(GL_TEXTURE0);
-        if (firstIteration) {
-            glBindTexture(GL_TEXTURE_2D, m_bloomBuffer.colorTexture);
-            firstIteration = false;
-        } else {
-            FrameBuffer& sourceBuffer = horizontal ? m_blurBuffer1 : m_blurBuffer2;
-            glBindTexture(GL_TEXTURE_2D, sourceBuffer.colorTexture);
-        }
-        shaderManager.SetUniform("uTexture", 0);
+    shaderManager.SetUniform("uTexture", 0);
+    shaderManager.SetUniform("uRadius", m_settings.bloomRadius);
+    glActiveTexture(GL_TEXTURE0);
 
+    // Each mip gets the blurrier one below it added on top, so mip 0 ends up with every size of glow
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    glBlendEquation(GL_FUNC_ADD);
+
+    for (size_t i = m_bloomMips.size() - 1; i > 0; --i) {
+        const FrameBuffer& source = m_bloomMips[i];
+        const FrameBuffer& target = m_bloomMips[i - 1];
+        BindFrameBuffer(target);
+        glViewport(0, 0, target.width, target.height);
+
+        shaderManager.SetUniform("uTexelSize", TexelSize(source));
+        shaderManager.SetUniform("uTexCoordTrim", TexCoordTrim(source));
+        shaderManager.SetUniform("uUvMax", UvMax(source));
+        glBindTexture(GL_TEXTURE_2D, source.colorTexture);
         RenderScreenQuad();
-        horizontal = !horizontal;
     }
 
-    CheckGLError("BlurBloom");
+    if (!blend) {
+        glDisable(GL_BLEND);
+    }
+    CheckGLError("UpsampleBloom");
 }
 
 void PostProcessManager::CombineAndToneMap() {
+    BS_PROFILE_SCOPE("PostProcess::CombineAndToneMap");
     if (!ValidateShader("bloom")) {  // Use bloom shader for combining
         BS_ERROR(LogCategory::RENDERER, "Bloom shader not available");
         return;
@@ -433,13 +759,15 @@ void PostProcessManager::CombineAndToneMap() {
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, m_mainBuffer.colorTexture);
     shaderManager.SetUniform("uScene", 0);  // Correct uniform name
+    shaderManager.SetUniform("uTexCoordTrim", TexCoordTrim(m_mainBuffer));
 
     // Bind bloom texture
     glActiveTexture(GL_TEXTURE1);
-    if (m_settings.enableBloom) {
-        glBindTexture(GL_TEXTURE_2D, m_blurBuffer1.colorTexture);  // Final blur result
+    if (m_settings.enableBloom && !m_bloomMips.empty()) {
+        glBindTexture(GL_TEXTURE_2D, GetBloomTexture());  // Mip 0 of the chain, everything added up
         shaderManager.SetUniform("uBloomBlur", 1);                 // Correct uniform name
         shaderManager.SetUniform("uBloomStrength", m_settings.bloomStrength);
+        shaderManager.SetUniform("uBloomUvMax", UvMax(m_bloomMips[0]));
     } else {
         // Bind a black texture or set bloom strength to 0
         shaderManager.SetUniform("uBloomBlur", 1);
@@ -455,6 +783,7 @@ void PostProcessManager::CombineAndToneMap() {
 }
 
 void PostProcessManager::ApplyFXAA() {
+    BS_PROFILE_SCOPE("PostProcess::ApplyFXAA");
     if (!ValidateShader("fxaa")) {
         BS_ERROR(LogCategory::RENDERER, "FXAA shader not available");
         return;
@@ -474,12 +803,62 @@ void PostProcessManager::ApplyFXAA() {
     glBindTexture(GL_TEXTURE_2D, m_fxaaBuffer.colorTexture);
     shaderManager.SetUniform("uTexture", 0);
     // Use correct uniform name from shader
-    shaderManager.SetUniform("uInverseScreenSize", glm::vec2(1.0f / m_width, 1.0f / m_height));
+    shaderManager.SetUniform("uInverseScreenSize", TexelSize(m_fxaaBuffer));
+    shaderManager.SetUniform("uTexCoordTrim", TexCoordTrim(m_fxaaBuffer));
+    shaderManager.SetUniform("uUvMax", UvMax(m_fxaaBuffer));
 
     RenderScreenQuad();
     CheckGLError("ApplyFXAA");
 }
 
+void PostProcessManager::CompositeCompute() {
+    BS_PROFILE_SCOPE("PostProcess::CompositeCompute");
+    if (!m_fxaaBuffer.FBO) {
+        return;  // Acquire already complained
+    }
+
+    auto& shaderManager = m_shaderSystem->GetShaderManager();
+    if (!shaderManager.UseShader("composite_fxaa")) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to use composite compute shader");
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_mainBuffer.colorTexture);
+    shaderManager.SetUniform("uScene", 0);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, m_settings.enableBloom ? GetBloomTexture() : 0);
+    shaderManager.SetUniform("uBloomBlur", 1);
+    shaderManager.SetUniform("uBloomStrength", m_settings.enableBloom ? m_settings.bloomStrength : 0.0f);
+    if (!m_bloomMips.empty()) {
+        shaderManager.SetUniform("uBloomUvMax", UvMax(m_bloomMips[0]));
+    }
+
+    shaderManager.SetUniform("uExposure", m_settings.exposure);
+    shaderManager.SetUniform("uGamma", m_settings.gamma);
+    shaderManager.SetUniform("uFXAA", m_settings.enableFXAA);
+    shaderManager.SetUniform("uSize", m_fxaaBuffer.width, m_fxaaBuffer.height);
+
+    // 16x16 groups, must match local_size in the shader
+    glBindImageTexture(0, m_fxaaBuffer.colorTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glDispatchCompute((m_fxaaBuffer.width + 15) / 16, (m_fxaaBuffer.height + 15) / 16, 1);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    // Image writes have to land before the blit reads the attachment
+    glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fxaaBuffer.FBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    // This is also where a lowered render scale gets stretched back up
+    bool scaled = m_fxaaBuffer.width != m_width || m_fxaaBuffer.height != m_height;
+    glBlitFramebuffer(0, 0, m_fxaaBuffer.width, m_fxaaBuffer.height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT,
+                      scaled ? GL_LINEAR : GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_width, m_height);
+
+    CheckGLError("CompositeCompute");
+}
+
 void PostProcessManager::RenderScreenQuad() {
     if (!m_quadVAO) {
         BS_ERROR(LogCategory::RENDERER, "Screen quad not initialized");
@@ -502,18 +881,18 @@ bool PostProcessManager::ValidateShader(const std::string& shaderName) {
 }
 
 void PostProcessManager::CheckGLError(const std::string& operation) {
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        BS_ERROR_F(LogCategory::RENDERER, "OpenGL error in %s: 0x%X", operation.c_str(), error);
-    }
+    // No-op unless GL debugging is on, and then only without KHR_debug
+    GLDebug::CheckErrors(operation.c_str());
 }
 
 void PostProcessManager::DebugFrameBuffers() {
     BS_DEBUG(LogCategory::RENDERER, "=== PostProcess Debug ===");
     BS_DEBUG_F(LogCategory::RENDERER, "Main buffer: FBO={}, Color={}, Depth={} ({}x{})", m_mainBuffer.FBO,
                m_mainBuffer.colorTexture, m_mainBuffer.depthTexture, m_mainBuffer.width, m_mainBuffer.height);
-    BS_DEBUG_F(LogCategory::RENDERER, "Bloom buffer: FBO={}, Color={} ({}x{})", m_bloomBuffer.FBO,
-               m_bloomBuffer.colorTexture, m_bloomBuffer.width, m_bloomBuffer.height);
+    for (size_t i = 0; i < m_bloomMips.size(); ++i) {
+        BS_DEBUG_F(LogCategory::RENDERER, "Bloom mip %zu: FBO=%u, Color=%u (%dx%d)", i, m_bloomMips[i].FBO,
+                   m_bloomMips[i].colorTexture, m_bloomMips[i].width, m_bloomMips[i].height);
+    }
 
     // Validate main framebuffer
     glBindFramebuffer(GL_FRAMEBUFFER, m_mainBuffer.FBO);
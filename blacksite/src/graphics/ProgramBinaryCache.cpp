@@ -0,0 +1,205 @@
+#include "blacksite/graphics/ProgramBinaryCache.h"
+#include "blacksite/core/Logger.h"
+
+#include <GL/glew.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace Blacksite {
+
+namespace {
+
+// .bsprog layout: this header, then binaryLength bytes straight from glGetProgramBinary.
+// Native endianness, a program binary is only good on the machine (and driver) that made it anyway.
+struct ProgramCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+static_assert(sizeof(ProgramCacheHeader) == 24, "ProgramCacheHeader layout is part of the file format");
+
+constexpr char CACHE_MAGIC[4] = {'B', 'S', 'P', 'G'};
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+uint64_t HashString(uint64_t hash, const char* text) {
+    if (!text) {
+        return hash;
+    }
+    for (const char* c = text; *c; ++c) {
+        hash = (hash ^ static_cast<uint8_t>(*c)) * FNV_PRIME;
+    }
+    // Separator, so "ab"+"c" and "a"+"bc" don't collide
+    return (hash ^ 0xffu) * FNV_PRIME;
+}
+
+const char* GetGLString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+}  // namespace
+
+bool ProgramBinaryCache::Initialize(const std::string& directory) {
+    m_enabled = false;
+    m_formats.clear();
+    if (directory.empty()) {
+        return false;
+    }
+
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) {
+        BS_INFO(LogCategory::RENDERER, "No program binaries (GL 4.1 / ARB_get_program_binary), shaders compile every run");
+        return false;
+    }
+
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0) {
+        BS_INFO(LogCategory::RENDERER, "Driver offers no program binary formats, shaders compile every run");
+        return false;
+    }
+    m_formats.resize(formatCount);
+    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, m_formats.data());
+
+    m_directory = directory;
+    if (m_directory.back() != '/' && m_directory.back() != '\\') {
+        m_directory += '/';
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        BS_WARN_F(LogCategory::RENDERER, "Can't create program cache directory '%s': %s", m_directory.c_str(),
+                  error.message().c_str());
+        return false;
+    }
+
+    uint64_t hash = FNV_OFFSET;
+    hash = HashString(hash, GetGLString(GL_VENDOR));
+    hash = HashString(hash, GetGLString(GL_RENDERER));
+    hash = HashString(hash, GetGLString(GL_VERSION));
+    hash = HashString(hash, GetGLString(GL_SHADING_LANGUAGE_VERSION));
+    m_driverHash = hash;
+
+    m_enabled = true;
+    BS_INFO_F(LogCategory::RENDERER, "Program binary cache in '%s' (%d formats)", m_directory.c_str(), formatCount);
+    return true;
+}
+
+uint64_t ProgramBinaryCache::MakeKey(const char* sourceA, const char* sourceB) const {
+    uint64_t key = HashString(HashString(m_driverHash, sourceA), sourceB);
+    return key != 0 ? key : 1;
+}
+
+unsigned int ProgramBinaryCache::Load(const std::string& name, uint64_t key) const {
+    if (!m_enabled) {
+        return 0;
+    }
+
+    std::ifstream file(GetCachePath(name), std::ios::binary);
+    if (!file) {
+        return 0;
+    }
+
+    ProgramCacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    bool valid = file && std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                 header.version == CACHE_VERSION && header.key == key && header.binaryLength > 0 &&
+                 std::find(m_formats.begin(), m_formats.end(), static_cast<int>(header.binaryFormat)) != m_formats.end();
+    if (!valid) {
+        BS_DEBUG_F(LogCategory::RENDERER, "Program cache miss for '%s'", name.c_str());
+        return 0;
+    }
+
+    std::vector<char> binary(header.binaryLength);
+    file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!file) {
+        BS_WARN_F(LogCategory::RENDERER, "Program cache for '%s' is truncated", name.c_str());
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram();
+    glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Drivers are allowed to reject a binary for any reason, that's just another miss
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(program);
+        BS_DEBUG_F(LogCategory::RENDERER, "Driver rejected cached program '%s', recompiling", name.c_str());
+        return 0;
+    }
+
+    BS_DEBUG_F(LogCategory::RENDERER, "Program '%s' loaded from binary cache", name.c_str());
+    return program;
+}
+
+void ProgramBinaryCache::PrepareForLink(unsigned int program) const {
+    if (m_enabled) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+bool ProgramBinaryCache::Store(const std::string& name, uint64_t key, unsigned int program) const {
+    if (!m_enabled) {
+        return false;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return false;
+    }
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return false;
+    }
+
+    ProgramCacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.key = key;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t>(written);
+
+    std::string cachePath = GetCachePath(name);
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            BS_WARN_F(LogCategory::RENDERER, "Can't write program cache '%s'", tempPath.c_str());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file) {
+            BS_WARN_F(LogCategory::RENDERER, "Failed writing program cache '%s'", tempPath.c_str());
+            file.close();
+            std::error_code ignored;
+            std::filesystem::remove(tempPath, ignored);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        BS_WARN_F(LogCategory::RENDERER, "Can't move program cache into place at '%s': %s", cachePath.c_str(),
+                  error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace Blacksite
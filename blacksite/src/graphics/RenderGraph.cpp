@@ -0,0 +1,131 @@
+#include "blacksite/graphics/RenderGraph.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/graphics/GpuProfiler.h"
+
+#include <algorithm>
+
+namespace Blacksite {
+
+void RenderGraph::Reset() {
+    m_resources.clear();
+    m_passes.clear();
+}
+
+RenderResource RenderGraph::Import(const std::string& name, const FrameBuffer& fb, bool isOutput) {
+    Resource resource;
+    resource.name = name;
+    resource.fb = fb;
+    resource.imported = true;
+    resource.isOutput = isOutput;
+    m_resources.push_back(resource);
+    return static_cast<RenderResource>(m_resources.size() - 1);
+}
+
+RenderResource RenderGraph::CreateTarget(const std::string& name, const RenderTargetDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    m_resources.push_back(resource);
+    return static_cast<RenderResource>(m_resources.size() - 1);
+}
+
+RenderGraph::PassHandle RenderGraph::AddPass(const std::string& name, ExecuteFn execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+    return static_cast<PassHandle>(m_passes.size() - 1);
+}
+
+void RenderGraph::Read(PassHandle pass, RenderResource resource) {
+    if (pass < m_passes.size() && resource < m_resources.size()) {
+        m_passes[pass].reads.push_back(resource);
+    }
+}
+
+void RenderGraph::Write(PassHandle pass, RenderResource resource) {
+    if (pass < m_passes.size() && resource < m_resources.size()) {
+        m_passes[pass].writes.push_back(resource);
+    }
+}
+
+void RenderGraph::Compile() {
+    // Walk back from the outputs: a pass stays if something still needed reads what it writes
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i) {
+        needed[i] = m_resources[i].isOutput;
+    }
+
+    for (size_t i = m_passes.size(); i-- > 0;) {
+        Pass& pass = m_passes[i];
+        pass.culled = std::none_of(pass.writes.begin(), pass.writes.end(),
+                                   [&needed](RenderResource resource) { return needed[resource]; });
+        if (pass.culled) {
+            continue;
+        }
+        for (RenderResource resource : pass.reads) {
+            needed[resource] = true;
+        }
+    }
+
+    // First and last live use, that's the window a transient target holds its texture for
+    for (uint32_t i = 0; i < m_passes.size(); ++i) {
+        const Pass& pass = m_passes[i];
+        if (pass.culled) {
+            continue;
+        }
+        auto touch = [this, i](RenderResource resource) {
+            Resource& r = m_resources[resource];
+            r.firstPass = std::min(r.firstPass, i);
+            r.lastPass = std::max(r.lastPass, i);
+        };
+        std::for_each(pass.reads.begin(), pass.reads.end(), touch);
+        std::for_each(pass.writes.begin(), pass.writes.end(), touch);
+    }
+}
+
+void RenderGraph::Execute(RenderTargetPool& pool, GpuProfiler* profiler) {
+    Compile();
+
+    m_timings.clear();
+    for (uint32_t i = 0; i < m_passes.size(); ++i) {
+        const Pass& pass = m_passes[i];
+        if (pass.culled) {
+            m_timings.push_back({pass.name, 0.0f, true});
+            continue;
+        }
+
+        for (Resource& resource : m_resources) {
+            if (resource.imported || resource.firstPass != i) {
+                continue;
+            }
+            const RenderTargetDesc& desc = resource.desc;
+            if (pool.Acquire(resource.fb, desc.textureWidth, desc.textureHeight, desc.colorFormat, desc.needDepth)) {
+                resource.fb.width = std::min(desc.width, desc.textureWidth);
+                resource.fb.height = std::min(desc.height, desc.textureHeight);
+            } else {
+                BS_ERROR_F(LogCategory::RENDERER, "RenderGraph: No target for '%s' (%dx%d)", resource.name.c_str(),
+                           desc.width, desc.height);
+                resource.fb = FrameBuffer{};
+            }
+        }
+
+        if (profiler) {
+            profiler->BeginZone(pass.name);
+        }
+        pass.execute(*this);
+        if (profiler) {
+            profiler->EndZone();
+        }
+        m_timings.push_back({pass.name, profiler ? profiler->GetZoneMs(pass.name) : 0.0f, false});
+
+        // Back to the pool right away, a later pass asking for the same size gets the same texture
+        for (Resource& resource : m_resources) {
+            if (!resource.imported && resource.lastPass == i && resource.fb.FBO != 0) {
+                pool.Release(resource.fb);
+            }
+        }
+    }
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,167 @@
+#include "blacksite/graphics/RenderTargetPool.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+
+#include <algorithm>
+
+namespace Blacksite {
+
+namespace {
+
+size_t BytesPerPixel(GLenum colorFormat) {
+    switch (colorFormat) {
+        case GL_RGBA32F:
+            return 16;
+        case GL_RGBA16F:
+            return 8;
+        default:
+            return 4;  // RGBA8, R11F_G11F_B10F and friends
+    }
+}
+
+int64_t TextureBytes(const FrameBuffer& fb, size_t bytesPerPixel) {
+    return static_cast<int64_t>(static_cast<size_t>(fb.textureWidth) * fb.textureHeight * bytesPerPixel);
+}
+
+}  // namespace
+
+bool RenderTargetPool::Acquire(FrameBuffer& out, int textureWidth, int textureHeight, GLenum colorFormat,
+                               bool needDepth) {
+    for (Target& target : m_targets) {
+        if (target.inUse || target.colorFormat != colorFormat || target.hasDepth != needDepth ||
+            target.fb.textureWidth != textureWidth || target.fb.textureHeight != textureHeight) {
+            continue;
+        }
+
+        target.inUse = true;
+        target.lastUsedFrame = m_frame;
+        out = target.fb;
+        return true;
+    }
+
+    Target target;
+    target.fb.width = target.fb.textureWidth = textureWidth;
+    target.fb.height = target.fb.textureHeight = textureHeight;
+    target.colorFormat = colorFormat;
+    target.hasDepth = needDepth;
+    if (!CreateTarget(target)) {
+        DeleteTarget(target);
+        return false;
+    }
+
+    target.inUse = true;
+    target.lastUsedFrame = m_frame;
+    m_targets.push_back(target);
+    out = target.fb;
+    BS_DEBUG_F(LogCategory::RENDERER, "Render target pool: new %dx%d target (%zu total)", textureWidth, textureHeight,
+               m_targets.size());
+    return true;
+}
+
+void RenderTargetPool::Release(const FrameBuffer& fb) {
+    if (fb.FBO == 0) {
+        return;
+    }
+
+    for (Target& target : m_targets) {
+        if (target.fb.FBO == fb.FBO) {
+            target.inUse = false;
+            target.lastUsedFrame = m_frame;
+            return;
+        }
+    }
+    BS_WARN_F(LogCategory::RENDERER, "Render target pool: FBO %u isn't ours", fb.FBO);
+}
+
+void RenderTargetPool::EndFrame() {
+    ++m_frame;
+
+    auto stale = [this](Target& target) {
+        if (target.inUse || m_frame - target.lastUsedFrame < EVICT_FRAMES) {
+            return false;
+        }
+        DeleteTarget(target);
+        return true;
+    };
+    m_targets.erase(std::remove_if(m_targets.begin(), m_targets.end(), stale), m_targets.end());
+}
+
+void RenderTargetPool::Clear() {
+    for (Target& target : m_targets) {
+        DeleteTarget(target);
+    }
+    m_targets.clear();
+}
+
+size_t RenderTargetPool::GetAllocatedBytes() const {
+    size_t bytes = 0;
+    for (const Target& target : m_targets) {
+        size_t pixels = static_cast<size_t>(target.fb.textureWidth) * target.fb.textureHeight;
+        bytes += pixels * (BytesPerPixel(target.colorFormat) + (target.hasDepth ? 4 : 0));
+    }
+    return bytes;
+}
+
+int RenderTargetPool::BucketSize(int size) {
+    return std::max(BUCKET_SIZE, (size + BUCKET_SIZE - 1) / BUCKET_SIZE * BUCKET_SIZE);
+}
+
+bool RenderTargetPool::CreateTarget(Target& target) {
+    FrameBuffer& fb = target.fb;
+
+    glGenFramebuffers(1, &fb.FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, fb.FBO);
+
+    glGenTextures(1, &fb.colorTexture);
+    glBindTexture(GL_TEXTURE_2D, fb.colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, target.colorFormat, fb.textureWidth, fb.textureHeight, 0, GL_RGBA, GL_FLOAT,
+                 nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fb.colorTexture, 0);
+    MemoryTracker::Adjust(MemoryTag::RenderTargets, TextureBytes(fb, BytesPerPixel(target.colorFormat)));
+
+    if (target.hasDepth) {
+        glGenTextures(1, &fb.depthTexture);
+        glBindTexture(GL_TEXTURE_2D, fb.depthTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, fb.textureWidth, fb.textureHeight, 0,
+                     GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, fb.depthTexture, 0);
+        MemoryTracker::Adjust(MemoryTag::RenderTargets, TextureBytes(fb, 4));
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        BS_ERROR_F(LogCategory::RENDERER, "Render target %dx%d not complete! Status: 0x%X", fb.textureWidth,
+                   fb.textureHeight, status);
+        return false;
+    }
+    return true;
+}
+
+void RenderTargetPool::DeleteTarget(Target& target) {
+    FrameBuffer& fb = target.fb;
+    if (fb.FBO) {
+        glDeleteFramebuffers(1, &fb.FBO);
+        fb.FBO = 0;
+    }
+    if (fb.colorTexture) {
+        glDeleteTextures(1, &fb.colorTexture);
+        fb.colorTexture = 0;
+        MemoryTracker::Adjust(MemoryTag::RenderTargets, -TextureBytes(fb, BytesPerPixel(target.colorFormat)));
+    }
+    if (fb.depthTexture) {
+        glDeleteTextures(1, &fb.depthTexture);
+        fb.depthTexture = 0;
+        MemoryTracker::Adjust(MemoryTag::RenderTargets, -TextureBytes(fb, 4));
+    }
+}
+
+}  // namespace Blacksite
@@ -1,7 +1,13 @@
 #include "blacksite/graphics/Renderer.h"
+#include <algorithm>
+#include <array>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <glm/gtc/type_ptr.hpp>
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/GLDebug.h"
 
 namespace Blacksite {
 
@@ -27,11 +33,31 @@ bool Renderer::Initialize(int width, int height) {
         m_camera = &m_internalCamera;
     }
 
-    m_lightPosition = glm::vec3(10.0f, 10.0f, 10.0f);
+    m_startTime = std::chrono::steady_clock::now();
 
     // Initialize our subsystems
     SetupDefaultShaders();
     SetupDefaultGeometry();
+    m_geometryManager.InitializeInstancing();
+    m_textureManager.Initialize();
+    m_debugDraw.Initialize();
+    m_hiZBuffer.Initialize(m_shaderSystem);
+
+    if (m_uploadRing.Initialize()) {
+        m_baseInstanceSupported = GLEW_VERSION_4_2 || GLEW_ARB_base_instance;
+        BS_INFO(LogCategory::RENDERER, "Per-frame uploads go through a persistently mapped ring");
+    } else {
+        BS_INFO(LogCategory::RENDERER, "No buffer storage, per-frame uploads use glBufferData");
+    }
+
+    m_shadowCascades.Initialize(m_shaderSystem, &m_geometryManager, &m_uploadRing, m_baseInstanceSupported);
+
+    m_indirectDrawSupported = m_uploadRing.IsInitialized() && IndirectDrawBuffer::IsSupported();
+    if (m_indirectDrawSupported) {
+        BS_INFO(LogCategory::RENDERER, "Indirect drawing available (multi-draw-indirect + persistent mapping)");
+    } else {
+        BS_INFO(LogCategory::RENDERER, "No multi-draw-indirect / buffer storage, using plain instancing");
+    }
 
     m_postProcessingEnabled = true;
 
@@ -41,6 +67,7 @@ bool Renderer::Initialize(int width, int height) {
         BS_ERROR(LogCategory::RENDERER, "Failed to initialize post-processing!");
         return false;
     }
+    m_postProcessManager->SetGpuProfiler(&m_gpuProfiler);
 
     BS_INFO(LogCategory::RENDERER, "Renderer initialized successfully");
     return true;
@@ -49,12 +76,28 @@ bool Renderer::Initialize(int width, int height) {
 void Renderer::Shutdown() {
     // Clean up all our GPU resources
     // Note: ShaderSystem is owned by Engine, so we don't clean it up here
+    m_debugDraw.Shutdown();
+    m_hiZBuffer.Shutdown();
+    m_shadowCascades.Shutdown();
+    m_shadowCasterOwner = nullptr;
+    m_frameGraph.Reset();
+    m_frameTargets.Clear();
+    m_uploadRing.Shutdown();
+    m_indirectDrawSupported = false;
+    m_baseInstanceSupported = false;
+    m_gpuProfiler.Shutdown();
+    m_instanceSource = 0;
     m_geometryManager.Cleanup();
+    m_textureManager.Cleanup();
 
     BS_INFO(LogCategory::RENDERER, "Renderer shut down cleanly");
 }
 
 void Renderer::BeginFrame() {
+    m_gpuProfiler.BeginFrame();
+    m_textureManager.Update();  // Works off what last frame's Flush asked for
+    m_uploadRing.BeginFrame();
+
     if (m_postProcessingEnabled) {
         m_postProcessManager->BeginFrame();
     } else {
@@ -65,12 +108,17 @@ void Renderer::BeginFrame() {
 }
 
 void Renderer::EndFrame() {
-    // Execute all queued render commands
-    Flush();
+    BuildFrameGraph();
+    m_frameGraph.Execute(m_frameTargets, &m_gpuProfiler);  // One GPU zone per pass
+    m_frameTargets.EndFrame();
+
+    BuildOcclusionBuffer();
 
     if (m_postProcessingEnabled) {
         m_postProcessManager->EndFrame();
     }
+    m_gpuProfiler.EndFrame();
+    m_uploadRing.EndFrame();  // After the last draw that reads this frame's slice
 }
 
 // Default shader versions (use basic shader)
@@ -86,47 +134,186 @@ void Renderer::DrawPlane(const Transform& transform, const glm::vec3& color) {
     DrawPlane(transform, "basic", color);
 }
 
-// Shader-specific versions
+// Shader-specific versions - thin wrappers that resolve the name and forward
 void Renderer::DrawCube(const Transform& transform, const std::string& shaderName, const glm::vec3& color) {
-    RenderCommand cmd;
-    cmd.meshName = "cube";
-    cmd.shaderName = shaderName;
-    cmd.transform = transform;
-    cmd.color = color;
-    Submit(cmd);
+    DrawMesh(m_cubeMesh, transform, GetShaderHandle(shaderName), color);
 }
 
 void Renderer::DrawSphere(const Transform& transform, const std::string& shaderName, const glm::vec3& color) {
-    RenderCommand cmd;
-    cmd.meshName = "sphere";
-    cmd.shaderName = shaderName;
-    cmd.transform = transform;
-    cmd.color = color;
-    Submit(cmd);
+    DrawMesh(m_sphereMesh, transform, GetShaderHandle(shaderName), color);
 }
 
 void Renderer::DrawPlane(const Transform& transform, const std::string& shaderName, const glm::vec3& color) {
+    DrawMesh(m_planeMesh, transform, GetShaderHandle(shaderName), color);
+}
+
+// Handle versions
+void Renderer::DrawCube(const Transform& transform, ShaderHandle shader, const glm::vec3& color) {
+    DrawMesh(m_cubeMesh, transform, shader, color);
+}
+
+void Renderer::DrawSphere(const Transform& transform, ShaderHandle shader, const glm::vec3& color) {
+    DrawMesh(m_sphereMesh, transform, shader, color);
+}
+
+void Renderer::DrawPlane(const Transform& transform, ShaderHandle shader, const glm::vec3& color) {
+    DrawMesh(m_planeMesh, transform, shader, color);
+}
+
+void Renderer::DrawMesh(MeshHandle mesh, const Transform& transform, ShaderHandle shader, const glm::vec3& color) {
     RenderCommand cmd;
-    cmd.meshName = "plane";
-    cmd.shaderName = shaderName;
-    cmd.transform = transform;
+    cmd.mesh = mesh;
+    cmd.shader = shader;
+    cmd.model = CreateModelMatrix(transform);
     cmd.color = color;
     Submit(cmd);
 }
 
+MeshHandle Renderer::GetMeshHandle(const std::string& meshName) const {
+    return m_geometryManager.GetMeshHandle(meshName);
+}
+
+ShaderHandle Renderer::GetShaderHandle(const std::string& shaderName) const {
+    if (!m_shaderSystem) {
+        return ShaderHandle{};
+    }
+
+    const ShaderManager& shaderManager = m_shaderSystem->GetShaderManager();
+    ShaderHandle handle = shaderManager.GetShaderHandle(shaderName);
+    if (handle.IsValid()) {
+        return handle;
+    }
+
+    // Still checked first above, so a shader that gets loaded later takes over from the fallback
+    auto missing = m_missingShaders.find(shaderName);
+    if (missing != m_missingShaders.end()) {
+        return missing->second;
+    }
+
+    ShaderHandle fallback = shaderManager.GetShaderHandle("basic");
+    if (fallback.IsValid()) {
+        BS_WARN_F(LogCategory::RENDERER, "Shader not found: %s (did you forget to load it?), using 'basic'",
+                  shaderName.c_str());
+    } else {
+        BS_ERROR_F(LogCategory::RENDERER, "Shader not found: %s, and no 'basic' to fall back to", shaderName.c_str());
+    }
+    m_missingShaders.emplace(shaderName, fallback);
+    return fallback;
+}
+
 void Renderer::Submit(const RenderCommand& command) {
-    // Add to our render queue
+    // Nothing sensible to draw with a bad handle, the lookup already complained
+    if (!command.mesh.IsValid() || !command.shader.IsValid()) {
+        return;
+    }
+
+    // Add to our render queue, the key decides where it ends up in Flush
+    PrepareQueue();
     m_renderQueue.push_back(command);
+    m_renderQueue.back().sortKey = BuildSortKey(command);
+}
+
+void Renderer::SubmitPrebuilt(FrameVector<RenderCommand>& commands) {
+    PrepareQueue();
+    m_renderQueue.insert(m_renderQueue.end(), commands.begin(), commands.end());
+    commands.clear();
+}
+
+// Nothing runs destructors on arena memory
+static_assert(std::is_trivially_destructible_v<RenderCommand>, "RenderCommand lives in the FrameArena");
 
-    // TODO: Could sort by material/depth here for optimization
+void Renderer::PrepareQueue() {
+    // Last frame's queue may sit in the buffer the arena is about to reuse, don't even clear() it - start over
+    FrameArena& arena = FrameArena::Get();
+    if (m_queueFrame != arena.GetFrameIndex() || &m_renderQueue.get_allocator().GetArena() != &arena) {
+        m_renderQueue = FrameVector<RenderCommand>(FrameAllocator<RenderCommand>(arena));
+        m_queueFrame = arena.GetFrameIndex();
+    }
 }
 
 void Renderer::Flush() {
-    // Execute all queued render commands
-    for (const auto& command : m_renderQueue) {
-        ExecuteRenderCommand(command);
+    BS_PROFILE_SCOPE("Renderer::Flush");
+    m_renderStats = RenderStats{};
+
+    PrepareQueue();  // Drops anything submitted in an earlier frame and never flushed
+    if (m_renderQueue.empty()) {
+        return;
     }
 
+    if (!m_camera) {
+        BS_ERROR(LogCategory::RENDERER, "No camera set!");
+        m_renderQueue.clear();
+        return;
+    }
+
+    RequestTextureResolutions();
+
+    // Sort (key, index) pairs instead of shuffling whole commands around
+    m_sortedQueue = FrameVector<std::pair<uint64_t, uint32_t>>();
+    m_sortedQueue.reserve(m_renderQueue.size());
+    for (uint32_t i = 0; i < m_renderQueue.size(); ++i) {
+        m_sortedQueue.emplace_back(m_renderQueue[i].sortKey, i);
+    }
+    std::sort(m_sortedQueue.begin(), m_sortedQueue.end());
+
+    UploadFrameData();
+    glActiveTexture(SHADOW_MAP_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, IsShadowsEnabled() ? m_shadowCascades.GetTexture() : 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Plain draws only set uEntityId when something will read it
+    m_writeEntityIds = m_postProcessingEnabled && m_postProcessManager->IsEntityIdBufferActive();
+
+    m_boundShader = ShaderHandle{};
+    m_boundVertexArray = 0;
+    m_boundTexture = TextureHandle{};
+
+    bool indirect = m_indirectDrawEnabled && m_instancingEnabled && m_indirectDrawSupported &&
+                    m_indirectBuffer.BeginFrame(m_uploadRing, static_cast<uint32_t>(m_sortedQueue.size()));
+
+    // Plain instancing writes into the ring as well when baseInstance can point each draw at its rows.
+    // Sized for the worst case (everything instanced), it's scratch anyway.
+    m_instanceUpload = DynamicBufferRing::Allocation{};
+    m_instanceUploadUsed = 0;
+    if (!indirect && m_instancingEnabled && m_baseInstanceSupported) {
+        m_instanceUpload = m_uploadRing.Allocate(m_sortedQueue.size() * sizeof(InstanceData), sizeof(InstanceData));
+    }
+
+    GLuint instanceSource = 0;
+    if (indirect) {
+        instanceSource = m_indirectBuffer.GetBuffer();
+    } else if (m_instanceUpload.IsValid()) {
+        instanceSource = m_uploadRing.GetBuffer();
+    }
+    SetInstanceSource(instanceSource, instanceSource != 0 ? m_uploadRing.GetGeneration() : 0);
+
+    bool prepass = m_depthPrepassEnabled && DrawDepthPrepass();
+
+    if (indirect) {
+        DrawIndirect();
+    } else {
+        // Sorting put everything with the same shader + mesh + texture next to each other, walk it batch by batch
+        size_t begin = 0;
+        while (begin < m_sortedQueue.size()) {
+            uint64_t batchKey = m_sortedQueue[begin].first >> RenderSortKey::TEXTURE_SHIFT;
+            size_t end = begin + 1;
+            while (end < m_sortedQueue.size() &&
+                   (m_sortedQueue[end].first >> RenderSortKey::TEXTURE_SHIFT) == batchKey) {
+                ++end;
+            }
+
+            DrawBatch(begin, end);
+            begin = end;
+        }
+    }
+    glBindVertexArray(0);
+    if (prepass) {
+        glDepthFunc(GL_LESS);
+    }
+
+    // Only does anything with GL debugging on, the driver reports via KHR_debug where it can
+    GLDebug::CheckErrors("Renderer::Flush");
+
     // Clear the queue
     m_renderQueue.clear();
 }
@@ -169,7 +356,8 @@ void Renderer::SetupDefaultShaders() {
     std::vector<std::string> requiredShaders = {"basic", "unlit", "wireframe", "debug"};
 
     // Load post-processing shaders
-    std::vector<std::string> postProcessShaders = {"postprocess", "blur", "bloom", "fxaa"};
+    std::vector<std::string> postProcessShaders = {"postprocess", "blur", "bloom", "bloom_downsample",
+                                                   "bloom_upsample", "fxaa"};
 
     for (const auto& shaderName : postProcessShaders) {
         if (!m_shaderSystem->HasShader(shaderName)) {
@@ -181,6 +369,31 @@ void Renderer::SetupDefaultShaders() {
 
     BS_INFO(LogCategory::RENDERER, "All required shaders are available");
 
+    auto& shaderManager = m_shaderSystem->GetShaderManager();
+    if (!shaderManager.HasShader("debug_lines") && !shaderManager.LoadShaderFromLibrary("debug_lines")) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to load the debug line shader, DebugDraw won't show anything");
+    }
+    m_debugLineShader = shaderManager.GetShaderHandle("debug_lines");
+
+    if (!shaderManager.HasShader("depth_only") && !shaderManager.LoadShaderFromLibrary("depth_only")) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to load the depth-only shader, no depth pre-pass");
+    }
+    m_depthOnlyShader = shaderManager.GetShaderHandle("depth_only");
+    m_transparentShader = shaderManager.GetShaderHandle("transparent");
+
+    // Hook up instanced twins for the shaders that have one
+    const std::pair<const char*, const char*> instancedShaders[] = {{"basic", "basic_instanced"},
+                                                                    {"unlit", "unlit_instanced"}};
+    for (const auto& [shaderName, instancedName] : instancedShaders) {
+        ShaderHandle shader = shaderManager.GetShaderHandle(shaderName);
+        if (shader.IsValid() &&
+            (shaderManager.HasShader(instancedName) || shaderManager.LoadShaderFromLibrary(instancedName))) {
+            m_instancedVariants[shader.id] = shaderManager.GetShaderHandle(instancedName);
+        } else {
+            BS_WARN_F(LogCategory::RENDERER, "No instanced variant for '%s', it will draw one by one", shaderName);
+        }
+    }
+
     // List available shaders for debugging
     auto availableShaders = m_shaderSystem->GetAvailableShaders();
     std::string shaderList;
@@ -198,81 +411,344 @@ void Renderer::SetupDefaultGeometry() {
     m_geometryManager.CreateSphere("sphere");
     m_geometryManager.CreatePlane("plane");
 
+    m_cubeMesh = m_geometryManager.GetMeshHandle("cube");
+    m_sphereMesh = m_geometryManager.GetMeshHandle("sphere");
+    m_planeMesh = m_geometryManager.GetMeshHandle("plane");
+
     BS_DEBUG(LogCategory::RENDERER, "Default geometry created (cube, sphere, plane)");
 }
 
-void Renderer::ExecuteRenderCommand(const RenderCommand& command) {
-    // Get the mesh we want to render
-    const Mesh* mesh = m_geometryManager.GetMesh(command.meshName);
-    if (!mesh) {
-        BS_ERROR_F(LogCategory::RENDERER, "Mesh not found: %s", command.meshName.c_str());
-        return;
+uint64_t Renderer::BuildSortKey(const RenderCommand& command) const {
+    // Handles are small dense indices already, they go into the key as-is
+    uint32_t shaderId = command.shader.id;
+    uint32_t meshId = command.mesh.id;
+    uint32_t textureSlot = command.texture.IsValid() ? command.texture.id + 1 : 0;  // Below MAX_TEXTURES + 1
+
+    // Squared distance to the camera is enough for ordering. Positive floats compare
+    // the same way as their bit patterns, so we can drop them straight into the key.
+    uint32_t depthBits = 0;
+    if (m_camera) {
+        glm::vec3 toCamera = glm::vec3(command.model[3]) - m_camera->GetPosition();
+        float distanceSq = glm::dot(toCamera, toCamera);
+        std::memcpy(&depthBits, &distanceSq, sizeof(depthBits));
     }
 
-    // Use the correct shader for 3D rendering
-    if (!m_shaderSystem->GetShaderManager().UseShader(command.shaderName)) {
-        BS_ERROR_F(LogCategory::RENDERER, "Failed to use shader: %s", command.shaderName.c_str());
-        return;
+    return RenderSortKey::Make(shaderId, meshId, textureSlot, depthBits);
+}
+
+bool Renderer::BindShaderForFrame(ShaderHandle shader) {
+    if (shader == m_boundShader) {
+        return true;
     }
 
-    // DEBUG: Check camera
-    if (!m_camera) {
-        BS_ERROR(LogCategory::RENDERER, "No camera set!");
+    auto& shaderManager = m_shaderSystem->GetShaderManager();
+    if (!shaderManager.UseShader(shader)) {
+        BS_ERROR_F(LogCategory::RENDERER, "Failed to use shader: %s", shaderManager.GetShaderName(shader).c_str());
+        m_boundShader = ShaderHandle{};
+        return false;
+    }
+    m_boundShader = shader;
+    m_renderStats.shaderBinds++;
+
+    // A shader without an EntityId output would leave garbage in the picking buffer, keep it at "nothing"
+    if (m_writeEntityIds) {
+        GLboolean writeIds = shaderManager.CurrentShaderWritesEntityId() ? GL_TRUE : GL_FALSE;
+        glColorMaski(1, writeIds, writeIds, writeIds, writeIds);
+    }
+
+    // Built-in shaders read camera + light from the FrameData block. User shaders that still
+    // declare plain uniforms get them the old way.
+    if (!shaderManager.CurrentShaderUsesFrameData()) {
+        shaderManager.SetUniform("uView", m_camera->GetViewMatrix());
+        shaderManager.SetUniform("uProjection", m_camera->GetProjectionMatrix());
+        shaderManager.SetUniform("uLightPos", m_lightDirection * 1000.0f);  // Far enough to pass for directional
+        shaderManager.SetUniform("uViewPos", m_camera->GetPosition());
+    }
+
+    // Always its own unit, even with no shadows - two sampler types on unit 0 fail every draw
+    shaderManager.SetUniform("uShadowMap", 1);
+
+    // Untextured until a batch says otherwise - uniforms are per program, so the texture state starts over
+    shaderManager.SetUniform("uHasTexture", false);
+    m_boundTexture = TextureHandle{};
+    return true;
+}
+
+void Renderer::BindVertexArrayForFrame(GLuint vertexArray) {
+    // Meshes with the same vertex layout share a VAO, so most mesh switches don't get here
+    if (vertexArray == m_boundVertexArray) {
         return;
     }
+    glBindVertexArray(vertexArray);
+    m_boundVertexArray = vertexArray;
+    m_renderStats.meshBinds++;
+}
 
-    // Set up matrices for the GPU
-    glm::mat4 model = CreateModelMatrix(command.transform);
-    glm::mat4 view = m_camera->GetViewMatrix();
-    glm::mat4 proj = m_camera->GetProjectionMatrix();
+void Renderer::BindTextureForBatch(TextureHandle texture) {
+    if (texture == m_boundTexture) {
+        return;
+    }
 
+    GLuint id = m_textureManager.GetGLTexture(texture);
     auto& shaderManager = m_shaderSystem->GetShaderManager();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, id);
+    shaderManager.SetUniform("uHasTexture", id != 0);
+    if (id != 0) {
+        shaderManager.SetUniform("uTexture", 0);
+    }
+    m_boundTexture = texture;
+    m_renderStats.textureBinds++;
+}
 
-    // *** FIX: Actually set the MVP matrices! ***
-    shaderManager.SetUniform("uModel", model);
-    shaderManager.SetUniform("uView", view);
-    shaderManager.SetUniform("uProjection", proj);
+void Renderer::RequestTextureResolutions() {
+    // Projected diameter in pixels, near enough to how many texels across the texture gets drawn
+    const glm::mat4& projection = m_camera->GetProjectionMatrix();
+    bool orthographic = projection[3][3] == 1.0f;
+    float pixelsPerUnit = projection[1][1] * static_cast<float>(m_height);
+    glm::vec3 cameraPosition = m_camera->GetPosition();
 
-    // Set up lighting uniforms
-    shaderManager.SetUniform("uLightPos", m_lightPosition);
-    shaderManager.SetUniform("uViewPos", m_camera->GetPosition());
-    shaderManager.SetUniform("uColor", command.color);
+    for (const RenderCommand& command : m_renderQueue) {
+        if (!command.texture.IsValid()) {
+            continue;
+        }
+        const glm::mat4& model = command.model;
+        float scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                                glm::length(glm::vec3(model[2]))});
+        float radius = m_geometryManager.GetBoundingRadius(command.mesh) * scale;
+        float distance = glm::length(glm::vec3(model[3]) - cameraPosition);
+
+        float pixels = radius * pixelsPerUnit;
+        if (!orthographic) {
+            pixels = distance > radius ? pixels / distance : std::numeric_limits<float>::max();  // Camera's inside
+        }
+        m_textureManager.RequestResolution(command.texture, pixels);
+    }
+}
 
-    // Set texture uniforms if the shader supports them
-    shaderManager.SetUniform("uHasTexture", false);  // Default to no texture
+void Renderer::UploadFrameData() {
+    FrameData frameData;
+    frameData.view = m_camera->GetViewMatrix();
+    frameData.projection = m_camera->GetProjectionMatrix();
+    frameData.lightDir = glm::vec4(m_lightDirection, 0.0f);
+    frameData.viewPos = m_camera->GetPosition();
+    frameData.time = std::chrono::duration<float>(std::chrono::steady_clock::now() - m_startTime).count();
+    if (IsShadowsEnabled()) {
+        m_shadowCascades.FillFrameData(frameData);
+    }
 
-    // Actually draw the mesh
-    glBindVertexArray(mesh->VAO);
-    if (mesh->useIndices) {
-        glDrawElements(GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_INT, 0);
+    // Into the ring when there is one, the old UBO + glBufferSubData otherwise
+    ShaderManager& shaderManager = m_shaderSystem->GetShaderManager();
+    DynamicBufferRing::Allocation upload =
+        m_uploadRing.Allocate(sizeof(FrameData), m_uploadRing.GetUniformAlignment());
+    if (upload.IsValid()) {
+        std::memcpy(upload.data, &frameData, sizeof(FrameData));
+        shaderManager.BindFrameData(m_uploadRing.GetBuffer(), upload.offset);
     } else {
-        glDrawArrays(GL_TRIANGLES, 0, mesh->vertexCount);
+        shaderManager.UpdateFrameData(frameData);
     }
-    glBindVertexArray(0);
+}
 
-    // Check for errors after drawing
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        BS_ERROR_F(LogCategory::RENDERER, "OpenGL error after drawing %s: %d", command.meshName.c_str(), error);
+void Renderer::DrawBatch(size_t begin, size_t end) {
+    const RenderCommand& first = m_renderQueue[m_sortedQueue[begin].second];
+
+    // Get the mesh we want to render
+    const Mesh* mesh = m_geometryManager.GetMesh(first.mesh);
+    if (!mesh) {
+        return;
+    }
+
+    // Big enough batch with an instanced twin? One draw for the lot
+    if (m_instancingEnabled && end - begin >= MIN_INSTANCED_BATCH) {
+        auto it = m_instancedVariants.find(first.shader.id);
+        if (it != m_instancedVariants.end() && BindShaderForFrame(it->second)) {
+            BindVertexArrayForFrame(mesh->instancedVAO);
+            BindTextureForBatch(first.texture);
+            DrawBatchInstanced(begin, end, *mesh);
+            return;
+        }
+    }
+
+    if (!BindShaderForFrame(first.shader)) {
+        return;
+    }
+
+    BindVertexArrayForFrame(mesh->VAO);
+    BindTextureForBatch(first.texture);
+    for (size_t i = begin; i < end; ++i) {
+        ExecuteRenderCommand(m_renderQueue[m_sortedQueue[i].second], *mesh);
     }
 }
 
-glm::mat4 Renderer::CreateModelMatrix(const Transform& transform) {
-    // Build the model matrix from translation, rotation, and scale
-    // Order matters: Scale -> Rotate -> Translate (applied right to left)
-    glm::mat4 model = glm::mat4(1.0f);  // Start with identity matrix
+void Renderer::DrawBatchInstanced(size_t begin, size_t end, const Mesh& mesh) {
+    GLsizei instanceCount = static_cast<GLsizei>(end - begin);
+    const MeshAllocation& range = mesh.allocation;
+    void* indexOffset = (void*)(static_cast<uintptr_t>(range.firstIndex) * sizeof(unsigned int));
+
+    if (m_instanceUpload.IsValid()) {
+        // Rows go straight into this flush's range of the ring, baseInstance points the draw at them
+        InstanceData* instances = static_cast<InstanceData*>(m_instanceUpload.data) + m_instanceUploadUsed;
+        for (size_t i = begin; i < end; ++i) {
+            const RenderCommand& command = m_renderQueue[m_sortedQueue[i].second];
+            instances[i - begin] = {command.model, command.color, command.entityId};
+        }
+        GLuint baseInstance =
+            static_cast<GLuint>(m_instanceUpload.offset / sizeof(InstanceData)) + m_instanceUploadUsed;
+        m_instanceUploadUsed += static_cast<uint32_t>(instanceCount);
+        glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT, indexOffset,
+                                                      instanceCount, range.baseVertex, baseInstance);
+    } else {
+        m_instanceData.clear();
+        m_instanceData.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            const RenderCommand& command = m_renderQueue[m_sortedQueue[i].second];
+            m_instanceData.push_back({command.model, command.color, command.entityId});
+        }
 
-    // Apply transformations in the correct order
-    model = glm::translate(model, transform.position);  // Move to world position
+        // Orphan + refill, the driver hands us fresh storage instead of waiting on the last batch
+        glBindBuffer(GL_ARRAY_BUFFER, m_geometryManager.GetInstanceBuffer());
+        glBufferData(GL_ARRAY_BUFFER, m_instanceData.size() * sizeof(InstanceData), m_instanceData.data(),
+                     GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    // Apply rotations (Euler angles - not the best but simple to understand)
-    model = glm::rotate(model, glm::radians(transform.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-    model = glm::rotate(model, glm::radians(transform.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-    model = glm::rotate(model, glm::radians(transform.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT, indexOffset,
+                                          instanceCount, range.baseVertex);
+    }
 
-    model = glm::scale(model, transform.scale);  // Apply scaling
+    m_renderStats.drawCalls++;
+    m_renderStats.instancedBatches++;
+    m_renderStats.instancedObjects += instanceCount;
+}
 
-    return model;
+void Renderer::DrawIndirect() {
+    InstanceData* instances = m_indirectBuffer.GetInstances();
+    DrawElementsIndirectCommand* commands = m_indirectBuffer.GetCommands();
+    uint32_t instanceBase = m_indirectBuffer.GetInstanceBase();
+    uint32_t commandBase = m_indirectBuffer.GetCommandBase();
+    uint32_t instanceCount = 0;
+    uint32_t commandCount = 0;
+
+    // A bucket is a run of batches with the same instanced shader, VAO and texture - one multi-draw covers it
+    ShaderHandle bucketShader;
+    GLuint bucketVertexArray = 0;
+    TextureHandle bucketTexture;
+    uint32_t bucketFirst = 0;
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer.GetBuffer());
+
+    auto submitBucket = [&]() {
+        if (commandCount == bucketFirst) {
+            return;
+        }
+        uintptr_t offset = static_cast<uintptr_t>(commandBase + bucketFirst) * sizeof(DrawElementsIndirectCommand);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)offset, commandCount - bucketFirst, 0);
+        m_renderStats.drawCalls++;
+        m_renderStats.instancedBatches++;
+        bucketFirst = commandCount;
+    };
+
+    size_t begin = 0;
+    while (begin < m_sortedQueue.size()) {
+        uint64_t batchKey = m_sortedQueue[begin].first >> RenderSortKey::TEXTURE_SHIFT;
+        size_t end = begin + 1;
+        while (end < m_sortedQueue.size() && (m_sortedQueue[end].first >> RenderSortKey::TEXTURE_SHIFT) == batchKey) {
+            ++end;
+        }
+
+        const RenderCommand& first = m_renderQueue[m_sortedQueue[begin].second];
+        const Mesh* mesh = m_geometryManager.GetMesh(first.mesh);
+        auto variant = m_instancedVariants.find(first.shader.id);
+        if (!mesh || variant == m_instancedVariants.end()) {
+            // No instanced twin, this one draws the old way and breaks the bucket
+            submitBucket();
+            bucketShader = ShaderHandle{};
+            bucketVertexArray = 0;
+            bucketTexture = TextureHandle{};
+            DrawBatch(begin, end);
+            begin = end;
+            continue;
+        }
+
+        if (variant->second != bucketShader || mesh->instancedVAO != bucketVertexArray ||
+            first.texture != bucketTexture) {
+            submitBucket();
+            bucketShader = ShaderHandle{};
+            bucketVertexArray = 0;
+            bucketTexture = TextureHandle{};
+            if (!BindShaderForFrame(variant->second)) {
+                begin = end;
+                continue;
+            }
+            BindVertexArrayForFrame(mesh->instancedVAO);
+            BindTextureForBatch(first.texture);
+            bucketShader = variant->second;
+            bucketVertexArray = mesh->instancedVAO;
+            bucketTexture = first.texture;
+        }
+
+        // Straight into the mapped slice, the GPU reads it without another copy
+        for (size_t i = begin; i < end; ++i) {
+            const RenderCommand& command = m_renderQueue[m_sortedQueue[i].second];
+            instances[instanceCount + (i - begin)] = {command.model, command.color, command.entityId};
+        }
+
+        const MeshAllocation& range = mesh->allocation;
+        uint32_t batchSize = static_cast<uint32_t>(end - begin);
+        commands[commandCount++] = {range.indexCount, batchSize, range.firstIndex,
+                                    static_cast<int32_t>(range.baseVertex), instanceBase + instanceCount};
+        instanceCount += batchSize;
+        m_renderStats.indirectCommands++;
+        m_renderStats.instancedObjects += batchSize;
+        begin = end;
+    }
+    submitBucket();
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void Renderer::SetInstanceSource(GLuint buffer, uint32_t generation) {
+    // Re-pointing touches every arena VAO, only worth doing when the mode (or the ring) actually changed.
+    // The name alone isn't enough, GL can hand a regrown ring the name the old one just gave back.
+    if (buffer == m_instanceSource && generation == m_instanceSourceGeneration) {
+        return;
+    }
+    m_geometryManager.SetInstanceSource(buffer);
+    m_instanceSource = buffer;
+    m_instanceSourceGeneration = generation;
+}
+
+void Renderer::ExecuteRenderCommand(const RenderCommand& command, const Mesh& mesh) {
+    // Shader and VAO are already bound by DrawBatch, only the per-object bits are left
+    auto& shaderManager = m_shaderSystem->GetShaderManager();
+    shaderManager.SetUniform("uModel", command.model);
+    shaderManager.SetUniform("uColor", command.color);
+    if (m_writeEntityIds) {
+        shaderManager.SetUniform("uEntityId", command.entityId);
+    }
+
+    // Actually draw the mesh - it's a slice of the arena buffers the VAO points at
+    const MeshAllocation& range = mesh.allocation;
+    glDrawElementsBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+                             (void*)(static_cast<uintptr_t>(range.firstIndex) * sizeof(unsigned int)),
+                             range.baseVertex);
+    m_renderStats.drawCalls++;
+}
+
+bool Renderer::GetMeshBounds(MeshHandle mesh, glm::vec3& outMin, glm::vec3& outMax) const {
+    if (!mesh.IsValid()) {
+        return false;
+    }
+    const Mesh* data = m_geometryManager.GetMesh(mesh);
+    if (!data) {
+        return false;
+    }
+    outMin = data->boundsMin;
+    outMax = data->boundsMax;
+    return true;
+}
+
+glm::mat4 Renderer::CreateModelMatrix(const Transform& transform) {
+    // Translate * Rotate * Scale in one go, see ComposeTRS
+    return ComposeTRS(transform.position, transform.rotation, transform.scale);
 }
 
 void Renderer::DebugOpenGLState() {
@@ -324,16 +800,15 @@ void Renderer::DebugShaderCompilation() {
         return;
     }
 
-    // Check uniform locations
+    // Check uniform locations (view/projection live in the FrameData block now)
     GLint modelLoc = glGetUniformLocation(currentProgram, "uModel");
-    GLint viewLoc = glGetUniformLocation(currentProgram, "uView");
-    GLint projLoc = glGetUniformLocation(currentProgram, "uProjection");
     GLint colorLoc = glGetUniformLocation(currentProgram, "uColor");
+    GLuint frameBlock = glGetUniformBlockIndex(currentProgram, "FrameData");
 
-    BS_INFO_F(LogCategory::RENDERER, "Uniform locations - Model: %d, View: %d, Proj: %d, Color: %d", modelLoc, viewLoc,
-              projLoc, colorLoc);
+    BS_INFO_F(LogCategory::RENDERER, "Uniform locations - Model: %d, Color: %d, FrameData block: %d", modelLoc,
+              colorLoc, frameBlock == GL_INVALID_INDEX ? -1 : (int)frameBlock);
 
-    if (modelLoc == -1 || viewLoc == -1 || projLoc == -1 || colorLoc == -1) {
+    if (modelLoc == -1 || colorLoc == -1 || frameBlock == GL_INVALID_INDEX) {
         BS_ERROR(LogCategory::RENDERER, "Some uniforms not found in shader!");
     }
 }
@@ -351,8 +826,11 @@ void Renderer::DebugGeometry() {
             continue;
         }
 
-        BS_INFO_F(LogCategory::RENDERER, "Mesh '%s': VAO=%d, VBO=%d, vertices=%d, indices=%d, useIndices=%s", meshName,
-                  mesh->VAO, mesh->VBO, mesh->vertexCount, mesh->indexCount, mesh->useIndices ? "YES" : "NO");
+        const MeshAllocation& range = mesh->allocation;
+        BS_INFO_F(LogCategory::RENDERER,
+                  "Mesh '%s': VAO=%u, pool=%u, vertices=%u at %u (%u bytes each), indices=%u at %u", meshName,
+                  mesh->VAO, range.pool, range.vertexCount, range.baseVertex, mesh->vertexStride, range.indexCount,
+                  range.firstIndex);
 
         // Check if VAO is valid
         if (mesh->VAO == 0) {
@@ -414,7 +892,7 @@ void Renderer::DebugMatrices() {
     Transform testTransform;
     testTransform.position = glm::vec3(0, 0, -5);
     testTransform.scale = glm::vec3(1, 1, 1);
-    testTransform.rotation = glm::vec3(0, 0, 0);
+    testTransform.rotation = glm::quat(1, 0, 0, 0);
 
     glm::mat4 model = CreateModelMatrix(testTransform);
     BS_INFO_F(LogCategory::RENDERER, "Test Model matrix [0]: %.2f, %.2f, %.2f, %.2f", model[0][0], model[0][1],
@@ -426,55 +904,248 @@ void Renderer::DebugMatrices() {
               mvp[0][3]);
 }
 
-void Renderer::DrawColliders(const std::vector<Entity>& entities) {
+void Renderer::DrawColliders(const std::vector<Entity*>& entities) {
     if (!m_showColliders)
         return;
 
-    // Enable wireframe mode
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    glDisable(GL_CULL_FACE);
-    glLineWidth(2.0f);
-
-    for (const auto& entity : entities) {
-        if (entity.active && entity.hasPhysics && !entity.colliders.empty()) {
-            DrawEntityCollider(entity);
+    for (const Entity* entity : entities) {
+        if (entity && entity->IsActive() && entity->GetPhysics().hasPhysics && !entity->colliders.empty()) {
+            DrawEntityCollider(*entity);
         }
     }
-
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glEnable(GL_CULL_FACE);
-    glLineWidth(1.0f);
 }
 
 void Renderer::DrawEntityCollider(const Entity& entity) {
     // Choose collider color: green for dynamic, red for static
-    glm::vec3 colliderColor = entity.isDynamic ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
-
-    for (const auto& collider : entity.colliders) {
-        // Calculate collider transform
-        Transform colliderTransform = entity.transform;
+    glm::vec3 colliderColor = entity.GetPhysics().isDynamic ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
 
-        // Apply collider local offset and scale
-        colliderTransform.position += collider.center * entity.transform.scale;
+    // Same shapes the physics side builds: a lone collider sits on the body, compound ones get their
+    // offset + rotation in body space. Scale goes into the shape sizes, not the matrix
+    const Transform& transform = entity.GetTransform();
+    glm::mat4 bodyTransform = ComposeTRS(transform.position, transform.rotation, glm::vec3(1.0f));
+    bool compound = entity.colliders.size() > 1;
 
-        // Apply collider size to the entity scale
-        glm::vec3 colliderScale = collider.size * entity.transform.scale;
-        colliderTransform.scale = colliderScale;
+    for (const auto& collider : entity.colliders) {
+        glm::mat4 colliderTransform = bodyTransform;
+        if (compound) {
+            colliderTransform *= ComposeTRS(collider.center * transform.scale, collider.rotation, glm::vec3(1.0f));
+        }
+        glm::vec3 size = glm::max(collider.size * transform.scale, glm::vec3(0.01f));
 
-        // Render based on collider type
         switch (collider.type) {
             case ColliderType::Box:
-                DrawCube(colliderTransform, "wireframe", colliderColor);
+                m_debugDraw.Box(colliderTransform, size * 0.5f, colliderColor);
                 break;
             case ColliderType::Sphere:
-                // For sphere, make scale uniform using radius
-                colliderTransform.scale = glm::vec3(collider.size.x * entity.transform.scale.x * 2.0f);
-                DrawSphere(colliderTransform, "wireframe", colliderColor);
+                m_debugDraw.Sphere(glm::vec3(colliderTransform[3]), std::max(size.x, std::max(size.y, size.z)) * 0.5f,
+                                   colliderColor);
                 break;
-            case ColliderType::Capsule:
+            case ColliderType::Capsule: {
+                // size.x is the diameter, size.y the full height caps included
+                float radius = size.x * 0.5f;
+                float halfHeight = std::max(size.y * 0.5f - radius, 0.0f);
+                m_debugDraw.Capsule(colliderTransform, radius, halfHeight, colliderColor);
                 break;
+            }
+        }
+    }
+}
+
+void Renderer::DrawDebugLines() {
+    if (m_debugDraw.IsEmpty()) {
+        return;
+    }
+    if (!m_camera || !m_debugLineShader.IsValid()) {
+        m_debugDraw.Clear();
+        return;
+    }
+
+    // Flush returns before uploading FrameData when there was nothing to draw
+    if (m_renderStats.drawCalls == 0) {
+        UploadFrameData();
+    }
+
+    if (!BindShaderForFrame(m_debugLineShader)) {
+        m_debugDraw.Clear();
+        return;
+    }
+    m_boundVertexArray = 0;  // DebugDraw binds its own VAO
+
+    // Depth tested but not written, so lines stay out of the Hi-Z pyramid. Entity ids stay what's under them.
+    glDepthMask(GL_FALSE);
+    if (m_writeEntityIds) {
+        glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    }
+
+    m_renderStats.debugLines = static_cast<uint32_t>(m_debugDraw.GetLineCount());
+    m_debugDraw.Flush(m_uploadRing);
+    m_renderStats.drawCalls++;
+
+    glDepthMask(GL_TRUE);
+    if (m_writeEntityIds) {
+        glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+}
+
+bool Renderer::DrawDepthPrepass() {
+    if (!m_depthOnlyShader.IsValid()) {
+        return false;
+    }
+
+    // Screen size the way MeshLod measures it: bounding radius over the half-height of the view
+    const glm::mat4& projection = m_camera->GetProjectionMatrix();
+    bool orthographic = projection[3][3] == 1.0f;
+    glm::vec3 cameraPosition = m_camera->GetPosition();
+    auto& shaderManager = m_shaderSystem->GetShaderManager();
+
+    // Sorted order, so occluders sharing a vertex layout don't switch VAOs
+    bool drawn = false;
+    for (const auto& entry : m_sortedQueue) {
+        const RenderCommand& command = m_renderQueue[entry.second];
+        if (command.shader == m_transparentShader) {
+            continue;
+        }
+        const Mesh* mesh = m_geometryManager.GetMesh(command.mesh);
+        if (!mesh) {
+            continue;
+        }
+
+        const glm::mat4& model = command.model;
+        float scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                                glm::length(glm::vec3(model[2]))});
+        float radius = m_geometryManager.GetBoundingRadius(command.mesh) * scale;
+        float screenSize = radius * projection[1][1];
+        if (!orthographic) {
+            float distance = glm::length(glm::vec3(model[3]) - cameraPosition);
+            screenSize = distance > radius ? screenSize / distance : std::numeric_limits<float>::max();
+        }
+        if (screenSize < m_depthPrepassMinScreenSize) {
+            continue;
+        }
+
+        if (!drawn) {
+            if (!BindShaderForFrame(m_depthOnlyShader)) {
+                return false;
+            }
+            // Pushed back a little: the main pass computes the same depth through a different shader (and
+            // instancing), with GL_LEQUAL and the offset it can't lose a pixel to rounding
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(1.0f, 1.0f);
+            drawn = true;
         }
+
+        BindVertexArrayForFrame(mesh->VAO);
+        shaderManager.SetUniform("uModel", model);
+        const MeshAllocation& range = mesh->allocation;
+        glDrawElementsBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+                                 (void*)(static_cast<uintptr_t>(range.firstIndex) * sizeof(unsigned int)),
+                                 range.baseVertex);
+        m_renderStats.drawCalls++;
+        m_renderStats.prepassDraws++;
+    }
+
+    if (drawn) {
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glDepthFunc(GL_LEQUAL);
+    }
+    return drawn;
+}
+
+void Renderer::SetOcclusionCullingEnabled(bool enable) {
+    m_occlusionCullingEnabled = enable;
+    if (!enable) {
+        m_hiZBuffer.Invalidate();  // Coming back on shouldn't cull against a stale view
+    }
+}
+
+void Renderer::BuildOcclusionBuffer() {
+    if (!m_occlusionCullingEnabled || !m_postProcessingEnabled || !m_camera || !m_postProcessManager ||
+        !m_postProcessManager->IsInitialized()) {
+        return;
+    }
+
+    GLint framebuffer = 0;
+    GLint viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    m_gpuProfiler.BeginZone("hi-z");
+    m_hiZBuffer.Build(m_postProcessManager->GetDepthTexture(), m_postProcessManager->GetRenderWidth(),
+                      m_postProcessManager->GetRenderHeight(), m_camera->GetViewMatrix(),
+                      m_camera->GetProjectionMatrix());
+    m_gpuProfiler.EndZone();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(framebuffer));
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    m_boundShader = ShaderHandle{};  // Build switched programs behind our back
+}
+
+void Renderer::SetLightDirection(const glm::vec3& towardsLight) {
+    float length = glm::length(towardsLight);
+    if (length > 0.0f) {
+        m_lightDirection = towardsLight / length;
+    }
+}
+
+void Renderer::SetShadowsEnabled(bool enable) {
+    m_shadowsEnabled = enable;
+    if (!enable) {
+        // Whoever turns them back on registers its static casters from scratch
+        m_shadowCascades.ClearStaticCasters();
+        m_shadowCasterOwner = nullptr;
+    }
+}
+
+void Renderer::SubmitShadowCaster(MeshHandle mesh, const glm::mat4& model, float radius) {
+    if (m_shadowsEnabled) {
+        m_shadowCascades.SubmitCaster(mesh, model, radius);
+    }
+}
+
+void Renderer::BuildFrameGraph() {
+    m_frameGraph.Reset();
+
+    // Whatever BeginFrame bound - the post-process scene buffer or the screen. The cascades own their depth
+    // arrays and may recreate them in shadow_static, so those imports are just names to hang the order on.
+    RenderResource scene = m_frameGraph.Import("scene", FrameBuffer{}, true);
+    RenderResource shadowMap = INVALID_RENDER_RESOURCE;
+
+    if (IsShadowsEnabled() && m_camera) {
+        RenderResource staticLayer = m_frameGraph.Import("shadow_static_layer", FrameBuffer{});
+        shadowMap = m_frameGraph.Import("shadow_map", FrameBuffer{});
+
+        // The scene pass has to land where it would have without the shadows in front of it
+        GLint framebuffer = 0;
+        std::array<GLint, 4> viewport{};
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+        glGetIntegerv(GL_VIEWPORT, viewport.data());
+
+        auto staticPass = m_frameGraph.AddPass("shadow_static", [this](const RenderGraph&) {
+            m_shadowCascades.UpdateStatic(*m_camera, m_lightDirection);
+        });
+        m_frameGraph.Write(staticPass, staticLayer);
+
+        auto dynamicPass = m_frameGraph.AddPass("shadow_dynamic", [this, framebuffer, viewport](const RenderGraph&) {
+            m_shadowCascades.UpdateDynamic();
+            glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(framebuffer));
+            glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+            m_instanceSource = ~GLuint(0);  // It re-pointed the arena VAOs at its own rows
+        });
+        m_frameGraph.Read(dynamicPass, staticLayer);
+        m_frameGraph.Write(dynamicPass, shadowMap);
+    }
+
+    // Execute all queued render commands
+    auto scenePass = m_frameGraph.AddPass("scene", [this](const RenderGraph&) {
+        Flush();
+        DrawDebugLines();
+    });
+    if (shadowMap != INVALID_RENDER_RESOURCE) {
+        m_frameGraph.Read(scenePass, shadowMap);
     }
+    m_frameGraph.Write(scenePass, scene);
 }
 
 GLuint Renderer::GetSceneTexture() const {
@@ -1,13 +1,20 @@
 #include <GL/glew.h>
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <blacksite/core/Logger.h>
 #include <blacksite/graphics/ShaderManager.h>
 #include <GL/glext.h>
+#include "blacksite/graphics/RenderCommand.h"
 #include "blacksite/graphics/shaders/ShaderLibrary.h"
 
 namespace Blacksite {
 
+namespace {
+// GL_COMPLETION_STATUS_KHR and _ARB share a value, spelled out so older GLEW headers still build
+constexpr GLenum COMPLETION_STATUS = 0x91B1;
+}  // namespace
+
 ShaderManager::~ShaderManager() {
     Cleanup();
 }
@@ -19,7 +26,9 @@ bool ShaderManager::LoadShaderFromLibrary(const std::string& libraryName) {
         return false;
     }
 
-    bool success = LoadShader(libraryName, shaderSource->vertexSource, shaderSource->fragmentSource);
+    bool success = shaderSource->computeSource
+                       ? LoadComputeShader(libraryName, shaderSource->computeSource)
+                       : LoadShader(libraryName, shaderSource->vertexSource, shaderSource->fragmentSource);
     if (success) {
         BS_DEBUG_F(LogCategory::RENDERER, "Loaded shader '%s' from library: %s",
                    libraryName.c_str(), shaderSource->description.c_str());
@@ -28,15 +37,36 @@ bool ShaderManager::LoadShaderFromLibrary(const std::string& libraryName) {
     return success;
 }
 
+bool ShaderManager::SubmitShaderFromLibrary(const std::string& libraryName) {
+    const ShaderSource* shaderSource = ShaderLibrary::GetShader(libraryName);
+    if (!shaderSource) {
+        BS_ERROR_F(LogCategory::RENDERER, "Shader '%s' not found in library", libraryName.c_str());
+        return false;
+    }
+
+    return shaderSource->computeSource
+               ? SubmitComputeShader(libraryName, shaderSource->computeSource)
+               : SubmitShader(libraryName, shaderSource->vertexSource, shaderSource->fragmentSource);
+}
+
 void ShaderManager::SetUniform(const std::string& name, int value) {
     if (m_currentProgram == 0) return;
 
-    int location = glGetUniformLocation(m_currentProgram, name.c_str());
+    GLint location = GetUniformLocation(name);
     if (location != -1) {
         glUniform1i(location, value);
     }
 }
 
+void ShaderManager::SetUniform(const std::string& name, uint32_t value) {
+    if (m_currentProgram == 0) return;
+
+    GLint location = GetUniformLocation(name);
+    if (location != -1) {
+        glUniform1ui(location, value);
+    }
+}
+
 void ShaderManager::SetUniform(const std::string& name, bool value) {
     SetUniform(name, static_cast<int>(value));
 }
@@ -91,10 +121,14 @@ void ShaderManager::SetUniform(const std::string& name, int x, int y) {
 }
 
 GLint ShaderManager::GetUniformLocation(const std::string& name) const {
-    if (m_currentProgram == 0) {
+    if (m_currentProgram == 0 || !m_currentHandle.IsValid()) {
         return -1;
     }
-    return glGetUniformLocation(m_currentProgram, name.c_str());
+
+    // Cached at link time - no driver round trip
+    const auto& locations = m_programs[m_currentHandle.id].uniformLocations;
+    auto it = locations.find(name);
+    return it != locations.end() ? it->second : -1;
 }
 
 GLint ShaderManager::GetUniformLocationSafe(const std::string& name) const {
@@ -104,7 +138,7 @@ GLint ShaderManager::GetUniformLocationSafe(const std::string& name) const {
         return -1;
     }
 
-    GLint location = glGetUniformLocation(m_currentProgram, name.c_str());
+    GLint location = GetUniformLocation(name);
     if (location == -1) {
         BS_WARN(LogCategory::RENDERER, "Uniform not found.");
         //(this might be OK if uniform is optimized out)
@@ -115,7 +149,17 @@ GLint ShaderManager::GetUniformLocationSafe(const std::string& name) const {
 
 
 bool ShaderManager::HasShader(const std::string& name) const {
-    return m_shaderPrograms.find(name) != m_shaderPrograms.end();
+    return GetShaderHandle(name).IsValid();
+}
+
+ShaderHandle ShaderManager::GetShaderHandle(const std::string& name) const {
+    auto it = m_shaderHandles.find(name);
+    return it != m_shaderHandles.end() ? it->second : ShaderHandle{};
+}
+
+const std::string& ShaderManager::GetShaderName(ShaderHandle handle) const {
+    static const std::string unknown = "<invalid shader>";
+    return handle.IsValid() && handle.id < m_programs.size() ? m_programs[handle.id].name : unknown;
 }
 
 std::string ShaderManager::GetCurrentShaderName() const {
@@ -124,55 +168,302 @@ std::string ShaderManager::GetCurrentShaderName() const {
 
 // Update the UseShader method to track current shader name:
 bool ShaderManager::UseShader(const std::string& name) {
-    auto it = m_shaderPrograms.find(name);
-    if (it != m_shaderPrograms.end()) {
-        m_currentProgram = it->second;
-        m_currentShaderName = name;
-        glUseProgram(m_currentProgram);
-        return true;
-    } else {
+    ShaderHandle handle = GetShaderHandle(name);
+    if (!handle.IsValid()) {
         BS_ERROR_F(LogCategory::RENDERER, "Shader not found: %s (did you forget to load it?)", name.c_str());
         return false;
     }
+    return UseShader(handle);
+}
+
+bool ShaderManager::UseShader(ShaderHandle handle) {
+    if (!handle.IsValid() || handle.id >= m_programs.size()) {
+        BS_ERROR(LogCategory::RENDERER, "UseShader called with an invalid shader handle");
+        return false;
+    }
+
+    const ProgramSlot& slot = m_programs[handle.id];
+    m_currentProgram = slot.program;
+    m_currentShaderName = slot.name;
+    m_currentHandle = handle;
+    glUseProgram(m_currentProgram);
+    return true;
+}
+
+bool ShaderManager::CurrentShaderUsesFrameData() const {
+    return m_currentHandle.IsValid() && m_programs[m_currentHandle.id].usesFrameData;
+}
+
+bool ShaderManager::CurrentShaderWritesEntityId() const {
+    return m_currentHandle.IsValid() && m_programs[m_currentHandle.id].writesEntityId;
+}
+
+void ShaderManager::UpdateFrameData(const FrameData& data) {
+    if (m_frameDataUBO == 0) {
+        glGenBuffers(1, &m_frameDataUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameDataUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+    } else {
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameDataUBO);
+    }
+
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // Binding points are global state, so this covers every program at once
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, m_frameDataUBO);
+}
+
+void ShaderManager::BindFrameData(GLuint buffer, GLintptr offset) {
+    glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, buffer, offset, sizeof(FrameData));
 }
 
 
 bool ShaderManager::LoadShader(const std::string& name, const char* vertexSource, const char* fragmentSource) {
-    // Create vertex shader
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    if (!CompileShader(vertexShader, vertexSource)) {
-        glDeleteShader(vertexShader);
-        BS_ERROR_F(LogCategory::RENDERER, "Vertex Shader compilation failed for: %s", name.c_str());
+    PendingProgram pending;
+    if (!BeginProgram(name, vertexSource, fragmentSource, nullptr, pending)) {
+        return true;  // Came out of the binary cache
+    }
+    return FinishProgram(pending);
+}
+
+bool ShaderManager::SubmitShader(const std::string& name, const char* vertexSource, const char* fragmentSource) {
+    RequestCompilerThreads();
+    PendingProgram pending;
+    if (BeginProgram(name, vertexSource, fragmentSource, nullptr, pending)) {
+        m_pendingPrograms.push_back(pending);
+    }
+    return true;
+}
+
+bool ShaderManager::IsComputeSupported() {
+    return GLEW_VERSION_4_3 ||
+           (GLEW_ARB_compute_shader && (GLEW_VERSION_4_2 || GLEW_ARB_shader_image_load_store));
+}
+
+bool ShaderManager::LoadComputeShader(const std::string& name, const char* computeSource) {
+    if (!IsComputeSupported()) {
+        BS_WARN_F(LogCategory::RENDERER, "Compute shader '%s' needs GL 4.3 / ARB_compute_shader", name.c_str());
         return false;
     }
 
-    // Create fragment shader
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    if (!CompileShader(fragmentShader, fragmentSource)) {
-        glDeleteShader(fragmentShader);
-        BS_ERROR_F(LogCategory::RENDERER, "Fragment Shader compilation failed for: %s", name.c_str());
+    PendingProgram pending;
+    if (!BeginProgram(name, nullptr, nullptr, computeSource, pending)) {
+        return true;
+    }
+    return FinishProgram(pending);
+}
+
+bool ShaderManager::SubmitComputeShader(const std::string& name, const char* computeSource) {
+    if (!IsComputeSupported()) {
+        BS_WARN_F(LogCategory::RENDERER, "Compute shader '%s' needs GL 4.3 / ARB_compute_shader", name.c_str());
         return false;
     }
 
-    // Create program and link
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
+    RequestCompilerThreads();
+    PendingProgram pending;
+    if (BeginProgram(name, nullptr, nullptr, computeSource, pending)) {
+        m_pendingPrograms.push_back(pending);
+    }
+    return true;
+}
 
-    if (!LinkProgram(program)) {
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        glDeleteProgram(program);
-        BS_ERROR_F(LogCategory::RENDERER, "Shader program linking failed for: %s", name.c_str());
+bool ShaderManager::IsParallelCompileSupported() {
+#if defined(GL_KHR_parallel_shader_compile)
+    if (GLEW_KHR_parallel_shader_compile) {
+        return true;
+    }
+#endif
+#if defined(GL_ARB_parallel_shader_compile)
+    if (GLEW_ARB_parallel_shader_compile) {
+        return true;
     }
+#endif
+    return false;
+}
+
+void ShaderManager::RequestCompilerThreads() {
+    if (m_compilerThreadsRequested) {
+        return;
+    }
+    m_compilerThreadsRequested = true;
+
+    // The default thread count is up to the driver and some pick zero, ask for as many as it's willing to use
+#if defined(GL_KHR_parallel_shader_compile)
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+        BS_DEBUG(LogCategory::RENDERER, "Parallel shader compile on (KHR_parallel_shader_compile)");
+        return;
+    }
+#endif
+#if defined(GL_ARB_parallel_shader_compile)
+    if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+        BS_DEBUG(LogCategory::RENDERER, "Parallel shader compile on (ARB_parallel_shader_compile)");
+    }
+#endif
+}
+
+bool ShaderManager::IsPending(const std::string& name) const {
+    return std::any_of(m_pendingPrograms.begin(), m_pendingPrograms.end(),
+                       [&name](const PendingProgram& pending) { return pending.name == name; });
+}
+
+size_t ShaderManager::PollPendingPrograms(const CompileCallback& onDone) {
+    if (m_pendingPrograms.empty()) {
+        return 0;
+    }
+
+    // Without the extension there's no way to ask without blocking, so everything finishes on the first poll.
+    // The driver had them all at once though, so that's still one wait instead of one per program.
+    bool canPoll = IsParallelCompileSupported();
+
+    size_t finished = 0;
+    for (size_t i = 0; i < m_pendingPrograms.size();) {
+        PendingProgram& pending = m_pendingPrograms[i];
+        if (canPoll) {
+            GLint complete = GL_FALSE;
+            glGetProgramiv(pending.program, COMPLETION_STATUS, &complete);
+            if (!complete) {
+                ++i;
+                continue;
+            }
+        }
+
+        PendingProgram done = pending;
+        m_pendingPrograms.erase(m_pendingPrograms.begin() + i);
+        bool success = FinishProgram(done);
+        ++finished;
+        if (onDone) {
+            onDone(done.name, success);
+        }
+    }
+    return finished;
+}
+
+void ShaderManager::FinishPendingPrograms(const CompileCallback& onDone) {
+    while (!m_pendingPrograms.empty()) {
+        PendingProgram done = m_pendingPrograms.front();
+        m_pendingPrograms.erase(m_pendingPrograms.begin());
+        bool success = FinishProgram(done);
+        if (onDone) {
+            onDone(done.name, success);
+        }
+    }
+}
 
-    // Clean up individual shader - we don't need them anymore
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+bool ShaderManager::BeginProgram(const std::string& name, const char* vertexSource, const char* fragmentSource,
+                                 const char* computeSource, PendingProgram& out) {
+    // Whatever was in flight for this name is out of date now
+    for (auto it = m_pendingPrograms.begin(); it != m_pendingPrograms.end();) {
+        if (it->name == name) {
+            DeletePending(*it);
+            it = m_pendingPrograms.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
-    m_shaderPrograms[name] = program;
+    out = PendingProgram{};
+    out.name = name;
+    out.cacheKey = computeSource ? m_binaryCache.MakeKey(computeSource)
+                                 : m_binaryCache.MakeKey(vertexSource, fragmentSource);
+    if (unsigned int cached = m_binaryCache.Load(name, out.cacheKey)) {
+        StoreProgram(name, cached);
+        return false;
+    }
 
-    BS_DEBUG_F(LogCategory::RENDERER, "Shader '%s' loaded successfully", name.c_str());
+    // Kick off compile and link without asking for status in between - asking is what blocks
+    out.program = glCreateProgram();
+    if (computeSource) {
+        out.shaders[0] = CompileShader(GL_COMPUTE_SHADER, computeSource);
+        glAttachShader(out.program, out.shaders[0]);
+    } else {
+        out.shaders[0] = CompileShader(GL_VERTEX_SHADER, vertexSource);
+        out.shaders[1] = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+        glAttachShader(out.program, out.shaders[0]);
+        glAttachShader(out.program, out.shaders[1]);
+    }
+    m_binaryCache.PrepareForLink(out.program);
+    glLinkProgram(out.program);
+    return true;
+}
+
+bool ShaderManager::FinishProgram(PendingProgram& pending) {
+    // Compile errors first, they explain the link failure better than the link log does
+    bool compiled = true;
+    for (int i = 0; i < 2; ++i) {
+        if (pending.shaders[i] != 0 && !CheckCompileStatus(pending.shaders[i])) {
+            const char* stage = pending.shaders[1] == 0 ? "Compute" : (i == 0 ? "Vertex" : "Fragment");
+            BS_ERROR_F(LogCategory::RENDERER, "%s Shader compilation failed for: %s", stage, pending.name.c_str());
+            compiled = false;
+        }
+    }
+
+    bool linked = compiled && CheckLinkStatus(pending.program);
+    if (compiled && !linked) {
+        BS_ERROR_F(LogCategory::RENDERER, "Shader program linking failed for: %s", pending.name.c_str());
+    }
+
+    if (!linked) {
+        DeletePending(pending);
+        return false;
+    }
+
+    // Clean up individual shaders - we don't need them anymore
+    for (unsigned int& shader : pending.shaders) {
+        if (shader != 0) {
+            glDeleteShader(shader);
+            shader = 0;
+        }
+    }
+
+    // Only now does the old program (if any) get swapped out, it kept drawing while this one compiled
+    m_binaryCache.Store(pending.name, pending.cacheKey, pending.program);
+    if (!StoreProgram(pending.name, pending.program)) {
+        pending.program = 0;  // Already deleted
+        return false;
+    }
+    BS_DEBUG_F(LogCategory::RENDERER, "Shader '%s' loaded successfully", pending.name.c_str());
+    return true;
+}
+
+void ShaderManager::DeletePending(PendingProgram& pending) {
+    for (unsigned int& shader : pending.shaders) {
+        if (shader != 0) {
+            glDeleteShader(shader);
+            shader = 0;
+        }
+    }
+    if (pending.program != 0) {
+        glDeleteProgram(pending.program);
+        pending.program = 0;
+    }
+}
+
+bool ShaderManager::StoreProgram(const std::string& name, unsigned int program) {
+    // Reloads reuse the slot, so handles people are holding keep working
+    auto it = m_shaderHandles.find(name);
+    if (it != m_shaderHandles.end()) {
+        ProgramSlot& slot = m_programs[it->second.id];
+        if (m_currentProgram == slot.program) {
+            m_currentProgram = program;
+        }
+        glDeleteProgram(slot.program);
+        slot.program = program;
+        CacheProgramInfo(slot);
+    } else {
+        if (m_programs.size() > RenderSortKey::MAX_ID) {
+            BS_ERROR_F(LogCategory::RENDERER, "Shader '%s' not stored, all %u shader ids are taken", name.c_str(),
+                       RenderSortKey::MAX_ID + 1);
+            glDeleteProgram(program);
+            return false;
+        }
+        ShaderHandle handle(static_cast<uint32_t>(m_programs.size()));
+        m_programs.push_back({name, program, {}, false});
+        m_shaderHandles.emplace(name, handle);
+        CacheProgramInfo(m_programs.back());
+    }
     return true;
 }
 
@@ -182,7 +473,7 @@ void ShaderManager::SetUniform(const std::string& name, const glm::mat4& matrix)
         return;
     }
 
-    int location = glGetUniformLocation(m_currentProgram, name.c_str());
+    GLint location = GetUniformLocation(name);
     if (location != -1) {
         // Upload the matrix to the GPU
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
@@ -196,7 +487,7 @@ void ShaderManager::SetUniform(const std::string& name, const glm::vec3& vector)
     if (m_currentProgram == 0)
         return;
 
-    int location = glGetUniformLocation(m_currentProgram, name.c_str());
+    GLint location = GetUniformLocation(name);
     if (location != -1) {
         glUniform3fv(location, 1, glm::value_ptr(vector));
     }
@@ -206,28 +497,44 @@ void ShaderManager::SetUniform(const std::string& name, float value) {
     if (m_currentProgram == 0)
         return;
 
-    int location = glGetUniformLocation(m_currentProgram, name.c_str());
+    GLint location = GetUniformLocation(name);
     if (location != -1) {
         glUniform1f(location, value);
     }
 }
 
 void ShaderManager::Cleanup() {
+    for (auto& pending : m_pendingPrograms) {
+        DeletePending(pending);
+    }
+    m_pendingPrograms.clear();
+
     // Delete all our shader programs.
-    for (auto& pair : m_shaderPrograms) {
-        glDeleteProgram(pair.second);
+    for (auto& slot : m_programs) {
+        glDeleteProgram(slot.program);
     }
 
-    m_shaderPrograms.clear();
+    m_programs.clear();
+    m_shaderHandles.clear();
     m_currentProgram = 0;
+    m_currentHandle = ShaderHandle{};
+
+    if (m_frameDataUBO != 0) {
+        glDeleteBuffers(1, &m_frameDataUBO);
+        m_frameDataUBO = 0;
+    }
 
     BS_DEBUG(LogCategory::RENDERER, "ShaderManager cleaned up");
 }
 
-bool ShaderManager::CompileShader(unsigned int shader, const char* source) {
+unsigned int ShaderManager::CompileShader(unsigned int type, const char* source) {
+    unsigned int shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, nullptr);
     glCompileShader(shader);
+    return shader;
+}
 
+bool ShaderManager::CheckCompileStatus(unsigned int shader) {
     int success;
     char infoLog[512];
 
@@ -242,10 +549,8 @@ bool ShaderManager::CompileShader(unsigned int shader, const char* source) {
     return true;
 }
 
-bool ShaderManager::LinkProgram(unsigned int program) {
-    glLinkProgram(program);
-
-    // Check if linking succeeded
+bool ShaderManager::CheckLinkStatus(unsigned int program) {
+    // Linked back in BeginProgram, this just reads the result
     int success;
     char infoLog[512];
 
@@ -259,4 +564,46 @@ bool ShaderManager::LinkProgram(unsigned int program) {
     return true;
 }
 
+void ShaderManager::CacheProgramInfo(ProgramSlot& slot) {
+    slot.uniformLocations.clear();
+
+    // Walk the active uniforms once so SetUniform never has to ask the driver again
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(slot.program, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(slot.program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::string nameBuffer(std::max(maxNameLength, 1), '\0');
+    for (GLint i = 0; i < uniformCount; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(slot.program, i, maxNameLength, &length, &size, &type, &nameBuffer[0]);
+
+        std::string uniformName(nameBuffer.data(), length);
+        GLint location = glGetUniformLocation(slot.program, uniformName.c_str());
+        if (location == -1) {
+            continue;  // Lives in a uniform block, not settable with glUniform*
+        }
+
+        // Arrays come back as "name[0]", let people use plain "name" too
+        slot.uniformLocations[uniformName] = location;
+        auto bracket = uniformName.find('[');
+        if (bracket != std::string::npos) {
+            slot.uniformLocations[uniformName.substr(0, bracket)] = location;
+        }
+    }
+
+    // Hook the FrameData block (if the shader has one) up to the shared binding point
+    GLuint blockIndex = glGetUniformBlockIndex(slot.program, "FrameData");
+    slot.usesFrameData = blockIndex != GL_INVALID_INDEX;
+    if (slot.usesFrameData) {
+        glUniformBlockBinding(slot.program, blockIndex, FRAME_DATA_BINDING);
+    }
+    slot.writesEntityId = glGetFragDataLocation(slot.program, "EntityId") == 1;
+
+    BS_DEBUG_F(LogCategory::RENDERER, "Shader '%s': cached %zu uniform locations%s", slot.name.c_str(),
+               slot.uniformLocations.size(), slot.usesFrameData ? ", uses FrameData" : "");
+}
+
 }  // namespace Blacksite
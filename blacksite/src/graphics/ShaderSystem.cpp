@@ -11,11 +11,14 @@ ShaderSystem::~ShaderSystem() {
     Shutdown();
 }
 
-bool ShaderSystem::Initialize(const std::string& shaderDirectory) {
+bool ShaderSystem::Initialize(const std::string& shaderDirectory, const std::string& cacheDirectory) {
     m_shaderDirectory = shaderDirectory;
 
     BS_INFO(LogCategory::RENDERER, "Initializing Shader System...");
 
+    // Before anything compiles, so the built-ins can come straight from disk
+    m_shaderManager.EnableProgramBinaryCache(cacheDirectory);
+
     // Load built-in shaders first
     if (!LoadBuiltInShaders()) {
         BS_ERROR(LogCategory::RENDERER, "Failed to load built-in shaders!");
@@ -28,8 +31,15 @@ bool ShaderSystem::Initialize(const std::string& shaderDirectory) {
         BS_INFO_F(LogCategory::RENDERER, "Created shader directory: %s", m_shaderDirectory.c_str());
     }
 
-    // Scan for user shaders
+    // Watch before scanning, so a save that lands during the scan still gets picked up
+    if (!m_fileWatcher.Start(m_shaderDirectory)) {
+        BS_INFO(LogCategory::RENDERER, "Shader hot reload will poll file timestamps");
+    }
+
+    // Scan for user shaders, and wait for them here - nothing's drawing yet, so there's no frame to hitch
     ScanShaderDirectory();
+    m_shaderManager.FinishPendingPrograms(
+        [this](const std::string& name, bool success) { OnProgramFinished(name, success); });
 
     BS_INFO_F(LogCategory::RENDERER, "Shader System initialized with %zu total shaders",
               m_shaderFiles.size());
@@ -38,17 +48,38 @@ bool ShaderSystem::Initialize(const std::string& shaderDirectory) {
 }
 
 void ShaderSystem::Shutdown() {
+    m_fileWatcher.Stop();
     m_shaderManager.Cleanup();
     m_shaderFiles.clear();
+    m_watchedFiles.clear();
     m_builtInShaders.clear();
 
     BS_INFO(LogCategory::RENDERER, "Shader System shut down");
 }
 
 void ShaderSystem::Update() {
-    if (m_hotReloadEnabled) {
+    if (m_fileWatcher.IsRunning()) {
+        ProcessFileChanges();
+    } else if (m_hotReloadEnabled) {
         CheckForShaderChanges();
     }
+
+    // Swap in whatever the driver finished since last frame, never waits
+    m_shaderManager.PollPendingPrograms(
+        [this](const std::string& name, bool success) { OnProgramFinished(name, success); });
+}
+
+void ShaderSystem::OnProgramFinished(const std::string& name, bool success) {
+    if (success) {
+        BS_INFO_F(LogCategory::RENDERER, "Loaded shader: %s", name.c_str());
+        return;
+    }
+
+    // A failed reload leaves the old program in place. A first load that failed has nothing to keep.
+    if (!m_shaderManager.HasShader(name)) {
+        m_shaderFiles.erase(name);
+    }
+    BS_ERROR_F(LogCategory::RENDERER, "Failed to load shader: %s", name.c_str());
 }
 
 bool ShaderSystem::LoadBuiltInShaders() {
@@ -57,8 +88,27 @@ bool ShaderSystem::LoadBuiltInShaders() {
     // Get all available shaders from the library
     auto availableShaders = ShaderLibrary::GetAvailableShaderNames();
 
+    // Hand the driver every program first and only then wait, so they compile side by side
+    std::vector<std::string> submitted;
     for (const auto& shaderName : availableShaders) {
-        if (m_shaderManager.LoadShaderFromLibrary(shaderName)) {
+        // Compute programs are optional extras, whoever uses them checks HasShader and falls back
+        const ShaderSource* source = ShaderLibrary::GetShader(shaderName);
+        if (source && source->computeSource && !ShaderManager::IsComputeSupported()) {
+            BS_DEBUG_F(LogCategory::RENDERER, "Skipping compute shader %s, not supported here", shaderName.c_str());
+            continue;
+        }
+
+        if (m_shaderManager.SubmitShaderFromLibrary(shaderName)) {
+            submitted.push_back(shaderName);
+        } else {
+            BS_ERROR_F(LogCategory::RENDERER, "Failed to load built-in shader: %s", shaderName.c_str());
+            success = false;
+        }
+    }
+    m_shaderManager.FinishPendingPrograms();
+
+    for (const auto& shaderName : submitted) {
+        if (m_shaderManager.HasShader(shaderName)) {
             m_builtInShaders.push_back(shaderName);
 
             // Add to tracking (built-in shaders don't have file paths)
@@ -95,8 +145,8 @@ bool ShaderSystem::ReloadShader(const std::string& name) {
     }
 
     if (it->second.isBuiltIn) {
-        // Reload from library
-        return m_shaderManager.LoadShaderFromLibrary(name);
+        // Reload from library, in the background like user shaders
+        return m_shaderManager.SubmitShaderFromLibrary(name);
     } else {
         // Reload from file
         return LoadShaderFromFile(name, it->second.vertexPath, it->second.fragmentPath);
@@ -202,7 +252,9 @@ bool ShaderSystem::LoadShaderFromFile(const std::string& name, const std::string
         return false;
     }
 
-    bool success = m_shaderManager.LoadShader(name, vertexSource.c_str(), fragmentSource.c_str());
+    // Only submitted here - OnProgramFinished reports how it went once the driver is done.
+    // Tracked right away so hot reload doesn't resubmit it every frame while it compiles.
+    bool success = m_shaderManager.SubmitShader(name, vertexSource.c_str(), fragmentSource.c_str());
 
     if (success) {
         // Update tracking info
@@ -215,8 +267,12 @@ bool ShaderSystem::LoadShaderFromFile(const std::string& name, const std::string
         info.isBuiltIn = false;
 
         m_shaderFiles[name] = info;
+        m_watchedFiles[FileWatcher::NormalizePath(vertexPath)] = name;
+        m_watchedFiles[FileWatcher::NormalizePath(fragmentPath)] = name;
 
-        BS_INFO_F(LogCategory::RENDERER, "Loaded user shader: %s", name.c_str());
+        if (!m_shaderManager.IsPending(name)) {
+            BS_INFO_F(LogCategory::RENDERER, "Loaded user shader from cache: %s", name.c_str());
+        }
     }
 
     return success;
@@ -258,16 +314,42 @@ void ShaderSystem::CheckForShaderChanges() {
         if (latestTime > info.lastModified) {
             BS_INFO_F(LogCategory::RENDERER, "Detected changes in shader: %s, reloading...", name.c_str());
 
-            if (ReloadShader(name)) {
-                info.lastModified = latestTime;
-                BS_INFO_F(LogCategory::RENDERER, "Successfully reloaded shader: %s", name.c_str());
-            } else {
+            // Stamp it either way, a broken save gets one error instead of one per frame.
+            // The old program keeps drawing until the new one is done compiling.
+            info.lastModified = latestTime;
+            if (!ReloadShader(name)) {
                 BS_ERROR_F(LogCategory::RENDERER, "Failed to reload shader: %s", name.c_str());
             }
         }
     }
 }
 
+void ShaderSystem::ProcessFileChanges() {
+    // Drained even with hot reload off, otherwise turning it back on would replay everything saved in between
+    std::vector<std::string> changed = m_fileWatcher.PollChanges();
+    if (!m_hotReloadEnabled) {
+        return;
+    }
+
+    for (const auto& path : changed) {
+        auto watched = m_watchedFiles.find(path);
+        if (watched == m_watchedFiles.end()) {
+            continue;
+        }
+
+        auto info = m_shaderFiles.find(watched->second);
+        if (info == m_shaderFiles.end() || info->second.isBuiltIn) {
+            continue;
+        }
+
+        // Vertex and fragment saved together show up as two paths, the second submission replaces the first
+        BS_INFO_F(LogCategory::RENDERER, "Detected changes in shader: %s, reloading...", info->first.c_str());
+        if (!ReloadShader(info->first)) {
+            BS_ERROR_F(LogCategory::RENDERER, "Failed to reload shader: %s", info->first.c_str());
+        }
+    }
+}
+
 std::pair<std::string, std::string> ShaderSystem::FindShaderPair(const std::string& baseName) {
     std::string vertexPath, fragmentPath;
 
@@ -0,0 +1,630 @@
+#include "blacksite/graphics/ShadowCascades.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/Camera.h"
+#include "blacksite/graphics/DynamicBufferRing.h"
+#include "blacksite/graphics/GeometryManager.h"
+#include "blacksite/graphics/ShaderSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Blacksite {
+
+bool ShadowCascades::Initialize(ShaderSystem* shaderSystem, GeometryManager* geometry, DynamicBufferRing* uploadRing,
+                                bool baseInstanceSupported) {
+    Shutdown();
+
+    auto& shaderManager = shaderSystem->GetShaderManager();
+    if (!shaderManager.HasShader("shadow_depth") && !shaderManager.LoadShaderFromLibrary("shadow_depth")) {
+        BS_ERROR(LogCategory::RENDERER, "Failed to load the shadow depth shader, no shadows");
+        return false;
+    }
+
+    m_shaderSystem = shaderSystem;
+    m_shader = shaderManager.GetShaderHandle("shadow_depth");
+    m_geometry = geometry;
+    m_uploadRing = uploadRing;
+    m_baseInstanceSupported = baseInstanceSupported;
+
+    // Depth only, neither framebuffer ever has a color attachment
+    glGenFramebuffers(1, &m_readFbo);
+    glGenFramebuffers(1, &m_drawFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_drawFbo);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_readFbo);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return true;
+}
+
+void ShadowCascades::Shutdown() {
+    DestroyTextures();
+    if (m_readFbo != 0) {
+        glDeleteFramebuffers(1, &m_readFbo);
+        m_readFbo = 0;
+    }
+    if (m_drawFbo != 0) {
+        glDeleteFramebuffers(1, &m_drawFbo);
+        m_drawFbo = 0;
+    }
+    m_staticCasters.clear();
+    m_staticIndex.clear();
+    m_staticIds.clear();
+    m_changedSpheres.clear();
+    m_dynamicCasters.clear();
+    m_shaderSystem = nullptr;
+    m_shader = ShaderHandle{};
+    m_geometry = nullptr;
+    m_uploadRing = nullptr;
+}
+
+void ShadowCascades::SetSettings(const ShadowSettings& settings) {
+    m_settings = settings;
+    m_settings.cascadeCount = std::clamp(m_settings.cascadeCount, 1, MAX_SHADOW_CASCADES);
+    m_settings.resolution = std::clamp(m_settings.resolution, 64, 8192);
+    m_settings.maxDistance = std::max(m_settings.maxDistance, 1.0f);
+    m_settings.splitLambda = std::clamp(m_settings.splitLambda, 0.0f, 1.0f);
+    m_settings.casterDistance = std::max(m_settings.casterDistance, 0.0f);
+    for (int& interval : m_settings.updateInterval) {
+        interval = std::max(interval, 1);
+    }
+    Invalidate();
+}
+
+void ShadowCascades::SetStaticCaster(uint32_t id, MeshHandle mesh, const glm::mat4& model, float radius) {
+    Caster caster;
+    caster.mesh = mesh;
+    caster.model = model;
+    caster.center = glm::vec3(model[3]);
+    caster.radius = radius;
+
+    auto it = m_staticIndex.find(id);
+    if (it != m_staticIndex.end()) {
+        Caster& existing = m_staticCasters[it->second];
+        m_changedSpheres.emplace_back(existing.center, existing.radius);
+        existing = caster;
+    } else {
+        m_staticIndex.emplace(id, m_staticCasters.size());
+        m_staticCasters.push_back(caster);
+        m_staticIds.push_back(id);
+    }
+    m_changedSpheres.emplace_back(caster.center, caster.radius);
+}
+
+void ShadowCascades::RemoveStaticCaster(uint32_t id) {
+    auto it = m_staticIndex.find(id);
+    if (it == m_staticIndex.end()) {
+        return;
+    }
+
+    size_t index = it->second;
+    m_changedSpheres.emplace_back(m_staticCasters[index].center, m_staticCasters[index].radius);
+    m_staticIndex.erase(it);
+
+    // Swap-remove, the last one takes the hole
+    size_t last = m_staticCasters.size() - 1;
+    if (index != last) {
+        m_staticCasters[index] = m_staticCasters[last];
+        m_staticIds[index] = m_staticIds[last];
+        m_staticIndex[m_staticIds[index]] = index;
+    }
+    m_staticCasters.pop_back();
+    m_staticIds.pop_back();
+}
+
+void ShadowCascades::ClearStaticCasters() {
+    m_staticCasters.clear();
+    m_staticIndex.clear();
+    m_staticIds.clear();
+    m_changedSpheres.clear();
+    for (Cascade& cascade : m_cascades) {
+        cascade.staticValid = false;
+    }
+}
+
+void ShadowCascades::SubmitCaster(MeshHandle mesh, const glm::mat4& model, float radius) {
+    Caster caster;
+    caster.mesh = mesh;
+    caster.model = model;
+    caster.center = glm::vec3(model[3]);
+    caster.radius = radius;
+    m_dynamicCasters.push_back(caster);
+}
+
+void ShadowCascades::Invalidate() {
+    for (Cascade& cascade : m_cascades) {
+        cascade.staticValid = false;
+        cascade.rendered = false;
+        cascade.dirty.clear();
+    }
+}
+
+bool ShadowCascades::IsReady() const {
+    if (m_finalTexture == 0) {
+        return false;
+    }
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        if (!m_cascades[i].rendered) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShadowCascades::FillFrameData(FrameData& data) const {
+    data.shadowParams = glm::vec4(0.0f);
+    if (!IsReady()) {
+        return;
+    }
+
+    // Clip space -> [0,1] texture coordinates and depth
+    const glm::mat4 toTexture(0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f, 0.0f, 0.5f, 0.5f,
+                              0.5f, 1.0f);
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        data.shadowMatrices[i] = toTexture * m_cascades[i].viewProjection;
+        data.cascadeSplits[i] = m_cascades[i].splitDistance;
+    }
+    data.shadowParams = glm::vec4(static_cast<float>(m_settings.cascadeCount), m_settings.depthBias, 0.0f,
+                                  1.0f / static_cast<float>(m_textureResolution));
+}
+
+void ShadowCascades::UpdateStatic(const Camera& camera, const glm::vec3& towardsLight) {
+    BS_PROFILE_SCOPE("ShadowCascades::UpdateStatic");
+    m_stats = ShadowStats{};
+
+    if (!m_shaderSystem) {
+        return;
+    }
+    if (m_textureResolution != m_settings.resolution || m_textureLayers != m_settings.cascadeCount) {
+        CreateTextures(m_settings.resolution, m_settings.cascadeCount);
+        Invalidate();
+    }
+
+    // A new light direction is a new light space, none of the cached texels mean anything there
+    if (towardsLight != m_towardsLight) {
+        m_towardsLight = towardsLight;
+        glm::vec3 up = std::abs(towardsLight.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+        m_lightView = glm::lookAt(glm::vec3(0.0f), -towardsLight, up);
+        Invalidate();
+    }
+
+    // Static casters that changed since last time, as rectangles in every cascade that has a cache to keep
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        Cascade& cascade = m_cascades[i];
+        if (!cascade.staticValid) {
+            continue;
+        }
+        for (const glm::vec4& sphere : m_changedSpheres) {
+            AddDirtyRect(cascade, SphereRect(cascade, glm::vec3(sphere), sphere.w));
+        }
+    }
+    m_changedSpheres.clear();
+
+    // Practical split scheme - a blend of even and logarithmic distances
+    float nearDistance = camera.GetNearPlane();
+    float farDistance = std::min(m_settings.maxDistance, camera.GetFarPlane());
+    float splits[MAX_SHADOW_CASCADES];
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        float fraction = static_cast<float>(i + 1) / static_cast<float>(m_settings.cascadeCount);
+        float even = nearDistance + (farDistance - nearDistance) * fraction;
+        float logarithmic = nearDistance * std::pow(farDistance / nearDistance, fraction);
+        splits[i] = even + (logarithmic - even) * m_settings.splitLambda;
+    }
+
+    bool shaderBound = false;
+    int resolution = m_textureResolution;
+    float sliceNear = nearDistance;
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        Cascade& cascade = m_cascades[i];
+        float sliceFar = splits[i];
+        float sliceStart = sliceNear;
+        sliceNear = sliceFar;
+
+        bool due = !cascade.rendered ||
+                   (m_frame + static_cast<uint64_t>(i)) % static_cast<uint64_t>(m_settings.updateInterval[i]) == 0;
+        if (!due) {
+            continue;
+        }
+
+        Cascade placed;
+        PlaceCascade(camera, sliceStart, sliceFar, placed);
+
+        // Same size and depth range: the static layer survives, at most shifted by a few texels
+        int64_t dx = placed.originX - cascade.originX;
+        int64_t dy = placed.originY - cascade.originY;
+        bool sameFrame = cascade.staticValid && placed.radius == cascade.radius &&
+                         placed.depthCenter == cascade.depthCenter && std::abs(dx) < resolution &&
+                         std::abs(dy) < resolution;
+        bool scrolled = sameFrame && (dx != 0 || dy != 0);
+
+        cascade.splitDistance = placed.splitDistance;
+        cascade.radius = placed.radius;
+        cascade.texelSize = placed.texelSize;
+        cascade.originX = placed.originX;
+        cascade.originY = placed.originY;
+        cascade.depthCenter = placed.depthCenter;
+        cascade.viewProjection = placed.viewProjection;
+        if (!sameFrame) {
+            cascade.dirty.clear();
+            cascade.dirty.push_back({cascade.originX, cascade.originY, cascade.originX + resolution,
+                                     cascade.originY + resolution});
+        }
+
+        TexelRect window{cascade.originX, cascade.originY, cascade.originX + resolution, cascade.originY + resolution};
+        bool anyDynamic = false;
+        for (const Caster& caster : m_dynamicCasters) {
+            if (Overlaps(cascade, window, caster.center, caster.radius)) {
+                anyDynamic = true;
+                break;
+            }
+        }
+
+        // Nothing changed under a cascade with only static casters in it - last frame's map is still right
+        if (cascade.rendered && cascade.dirty.empty() && !scrolled && !anyDynamic && !cascade.hadDynamic) {
+            continue;
+        }
+
+        if (!shaderBound) {
+            if (!BeginDepthDraws()) {
+                break;
+            }
+            shaderBound = true;
+        }
+
+        if (scrolled) {
+            ScrollStaticLayer(i, dx, dy);
+
+            // Whatever slid into view wasn't in the cache
+            if (dx > 0) {
+                AddDirtyRect(cascade, {window.x1 - dx, window.y0, window.x1, window.y1});
+            } else if (dx < 0) {
+                AddDirtyRect(cascade, {window.x0, window.y0, window.x0 - dx, window.y1});
+            }
+            if (dy > 0) {
+                AddDirtyRect(cascade, {window.x0, window.y1 - dy, window.x1, window.y1});
+            } else if (dy < 0) {
+                AddDirtyRect(cascade, {window.x0, window.y0, window.x1, window.y0 - dy});
+            }
+        }
+        if (!cascade.dirty.empty()) {
+            RenderStaticRects(i, cascade);
+        }
+        cascade.staticValid = true;
+        cascade.pending = true;
+    }
+
+    if (shaderBound) {
+        EndDepthDraws();
+    }
+}
+
+void ShadowCascades::UpdateDynamic() {
+    BS_PROFILE_SCOPE("ShadowCascades::UpdateDynamic");
+    bool shaderBound = false;
+    for (int i = 0; i < m_settings.cascadeCount; ++i) {
+        Cascade& cascade = m_cascades[i];
+        if (!cascade.pending) {
+            continue;
+        }
+        cascade.pending = false;
+        if (!shaderBound && !BeginDepthDraws()) {
+            continue;  // It bound a moment ago in UpdateStatic, so this won't last
+        }
+        shaderBound = true;
+
+        cascade.hadDynamic = RenderDynamic(i, cascade);
+        cascade.rendered = true;
+        m_stats.cascadesUpdated++;
+    }
+
+    if (shaderBound) {
+        EndDepthDraws();
+    }
+    m_dynamicCasters.clear();
+    m_frame++;
+}
+
+bool ShadowCascades::BeginDepthDraws() {
+    if (!m_shaderSystem->GetShaderManager().UseShader(m_shader)) {
+        return false;
+    }
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_CLAMP);  // Casters between the light and the near plane still land at depth 0
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(2.0f, 4.0f);
+    glViewport(0, 0, m_textureResolution, m_textureResolution);
+    m_instanceSource = ~GLuint(0);
+    return true;
+}
+
+void ShadowCascades::EndDepthDraws() {
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_DEPTH_CLAMP);
+    glBindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowCascades::PlaceCascade(const Camera& camera, float nearDistance, float farDistance,
+                                  Cascade& target) const {
+    // Bounding sphere of the frustum slice. k is how far the corner rays spread per unit of depth, the
+    // center sits where the near and far corners are equally far away (or at the far plane for wide views).
+    float tanHalfFov = std::tan(glm::radians(camera.GetFov()) * 0.5f);
+    float aspect = camera.GetAspectRatio();
+    float kSquared = tanHalfFov * tanHalfFov * (1.0f + aspect * aspect);
+    float centerDistance = std::min(0.5f * (farDistance + nearDistance) * (1.0f + kSquared), farDistance);
+    float farOffset = farDistance - centerDistance;
+    float radius = std::sqrt(farOffset * farOffset + farDistance * farDistance * kSquared);
+    radius = std::ceil(radius * 16.0f) / 16.0f;  // Float noise shouldn't count as a new size
+
+    glm::vec3 forward = glm::normalize(camera.GetTarget() - camera.GetPosition());
+    glm::vec3 center = camera.GetPosition() + forward * centerDistance;
+    glm::vec3 lightCenter = glm::vec3(m_lightView * glm::vec4(center, 1.0f));
+
+    // One texel of slack per side so the box still covers the sphere after snapping
+    int resolution = m_textureResolution;
+    float texelSize = 2.0f * radius / static_cast<float>(resolution - 2);
+
+    target.splitDistance = farDistance;
+    target.radius = radius;
+    target.texelSize = texelSize;
+    target.originX = static_cast<int64_t>(std::floor((lightCenter.x - radius) / texelSize));
+    target.originY = static_cast<int64_t>(std::floor((lightCenter.y - radius) / texelSize));
+    target.depthCenter = std::round(lightCenter.z / radius) * radius;  // In steps of radius, the cache survives
+
+    // Within radius / 2 of the real center, so 1.5 radius each way covers the sphere. Light looks down -z.
+    float left = static_cast<float>(target.originX) * texelSize;
+    float bottom = static_cast<float>(target.originY) * texelSize;
+    float extent = static_cast<float>(resolution) * texelSize;
+    float nearPlane = -(target.depthCenter + 1.5f * radius + m_settings.casterDistance);
+    float farPlane = -(target.depthCenter - 1.5f * radius);
+    target.viewProjection =
+        glm::ortho(left, left + extent, bottom, bottom + extent, nearPlane, farPlane) * m_lightView;
+}
+
+ShadowCascades::TexelRect ShadowCascades::SphereRect(const Cascade& cascade, const glm::vec3& center,
+                                                     float radius) const {
+    // Padded by a texel for the filter taps
+    glm::vec3 lightCenter = glm::vec3(m_lightView * glm::vec4(center, 1.0f));
+    TexelRect rect;
+    rect.x0 = static_cast<int64_t>(std::floor((lightCenter.x - radius) / cascade.texelSize)) - 1;
+    rect.y0 = static_cast<int64_t>(std::floor((lightCenter.y - radius) / cascade.texelSize)) - 1;
+    rect.x1 = static_cast<int64_t>(std::ceil((lightCenter.x + radius) / cascade.texelSize)) + 1;
+    rect.y1 = static_cast<int64_t>(std::ceil((lightCenter.y + radius) / cascade.texelSize)) + 1;
+    return rect;
+}
+
+bool ShadowCascades::Overlaps(const Cascade& cascade, const TexelRect& area, const glm::vec3& center,
+                              float radius) const {
+    TexelRect rect = SphereRect(cascade, center, radius);
+    if (rect.x1 <= area.x0 || rect.x0 >= area.x1 || rect.y1 <= area.y0 || rect.y0 >= area.y1) {
+        return false;
+    }
+    // Entirely behind the box (seen from the light) it can't shade anything in it
+    float lightZ = (m_lightView * glm::vec4(center, 1.0f)).z;
+    return lightZ + radius >= cascade.depthCenter - 1.5f * cascade.radius;
+}
+
+void ShadowCascades::AddDirtyRect(Cascade& cascade, const TexelRect& rect) {
+    if (rect.IsEmpty()) {
+        return;
+    }
+    if (cascade.dirty.size() < MAX_DIRTY_RECTS) {
+        cascade.dirty.push_back(rect);
+        return;
+    }
+
+    // Too many little ones, one rectangle around all of them is cheaper than the draws
+    TexelRect merged = rect;
+    for (const TexelRect& other : cascade.dirty) {
+        merged.x0 = std::min(merged.x0, other.x0);
+        merged.y0 = std::min(merged.y0, other.y0);
+        merged.x1 = std::max(merged.x1, other.x1);
+        merged.y1 = std::max(merged.y1, other.y1);
+    }
+    cascade.dirty.clear();
+    cascade.dirty.push_back(merged);
+}
+
+void ShadowCascades::ScrollStaticLayer(int layer, int64_t dx, int64_t dy) {
+    // Blits within one image can't overlap, so out to the scratch layer and back in shifted
+    int resolution = m_textureResolution;
+    int shiftX = static_cast<int>(dx);
+    int shiftY = static_cast<int>(dy);
+    CopyLayer(m_staticTexture, layer, m_scratchTexture, 0, 0, 0, resolution, resolution, 0, 0);
+    CopyLayer(m_scratchTexture, 0, m_staticTexture, layer, std::max(0, shiftX), std::max(0, shiftY),
+              resolution + std::min(0, shiftX), resolution + std::min(0, shiftY), -shiftX, -shiftY);
+}
+
+void ShadowCascades::CopyLayer(GLuint source, int sourceLayer, GLuint target, int targetLayer, int x0, int y0,
+                               int x1, int y1, int dx, int dy) {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_readFbo);
+    glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, source, 0, sourceLayer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_drawFbo);
+    glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, target, 0, targetLayer);
+    glBlitFramebuffer(x0, y0, x1, y1, x0 + dx, y0 + dy, x1 + dx, y1 + dy, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
+
+void ShadowCascades::RenderStaticRects(int layer, Cascade& cascade) {
+    int resolution = m_textureResolution;
+    glBindFramebuffer(GL_FRAMEBUFFER, m_drawFbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticTexture, 0, layer);
+    glEnable(GL_SCISSOR_TEST);
+
+    for (const TexelRect& dirty : cascade.dirty) {
+        // Into the map's own texels, whatever is outside of it now doesn't matter
+        TexelRect rect{std::max(dirty.x0, cascade.originX), std::max(dirty.y0, cascade.originY),
+                       std::min(dirty.x1, cascade.originX + resolution),
+                       std::min(dirty.y1, cascade.originY + resolution)};
+        if (rect.IsEmpty()) {
+            continue;
+        }
+
+        glScissor(static_cast<GLint>(rect.x0 - cascade.originX), static_cast<GLint>(rect.y0 - cascade.originY),
+                  static_cast<GLsizei>(rect.x1 - rect.x0), static_cast<GLsizei>(rect.y1 - rect.y0));
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+        m_drawItems.clear();
+        for (const Caster& caster : m_staticCasters) {
+            if (Overlaps(cascade, rect, caster.center, caster.radius)) {
+                m_drawItems.push_back({caster.mesh.id, &caster.model});
+            }
+        }
+        m_stats.staticRegions++;
+        m_stats.staticCasters += static_cast<uint32_t>(m_drawItems.size());
+        DrawItems(cascade.viewProjection);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+    cascade.dirty.clear();
+}
+
+bool ShadowCascades::RenderDynamic(int layer, const Cascade& cascade) {
+    int resolution = m_textureResolution;
+    CopyLayer(m_staticTexture, layer, m_finalTexture, layer, 0, 0, resolution, resolution, 0, 0);
+
+    TexelRect window{cascade.originX, cascade.originY, cascade.originX + resolution, cascade.originY + resolution};
+    m_drawItems.clear();
+    for (const Caster& caster : m_dynamicCasters) {
+        if (Overlaps(cascade, window, caster.center, caster.radius)) {
+            m_drawItems.push_back({caster.mesh.id, &caster.model});
+        }
+    }
+    if (m_drawItems.empty()) {
+        return false;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_drawFbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_finalTexture, 0, layer);
+    m_stats.dynamicCasters += static_cast<uint32_t>(m_drawItems.size());
+    DrawItems(cascade.viewProjection);
+    return true;
+}
+
+void ShadowCascades::DrawItems(const glm::mat4& viewProjection) {
+    if (m_drawItems.empty()) {
+        return;
+    }
+
+    // Same mesh next to each other, then each run is one instanced draw
+    std::sort(m_drawItems.begin(), m_drawItems.end(),
+              [](const DrawItem& a, const DrawItem& b) { return a.mesh < b.mesh; });
+    m_instanceRows.resize(m_drawItems.size());
+    for (size_t i = 0; i < m_drawItems.size(); ++i) {
+        m_instanceRows[i].model = *m_drawItems[i].model;
+    }
+
+    // Ring + baseInstance when we have them, like Renderer::DrawBatchInstanced
+    DynamicBufferRing::Allocation upload;
+    if (m_uploadRing && m_uploadRing->IsInitialized() && m_baseInstanceSupported) {
+        upload = m_uploadRing->Allocate(m_instanceRows.size() * sizeof(InstanceData), sizeof(InstanceData));
+    }
+    GLuint source = upload.IsValid() ? m_uploadRing->GetBuffer() : 0;
+    if (source != m_instanceSource) {
+        m_geometry->SetInstanceSource(source);
+        m_instanceSource = source;
+    }
+    if (upload.IsValid()) {
+        std::memcpy(upload.data, m_instanceRows.data(), m_instanceRows.size() * sizeof(InstanceData));
+    }
+    GLuint baseInstance = upload.IsValid() ? static_cast<GLuint>(upload.offset / sizeof(InstanceData)) : 0;
+
+    m_shaderSystem->GetShaderManager().SetUniform("uLightViewProj", viewProjection);
+
+    GLuint boundVertexArray = 0;
+    size_t begin = 0;
+    while (begin < m_drawItems.size()) {
+        size_t end = begin + 1;
+        while (end < m_drawItems.size() && m_drawItems[end].mesh == m_drawItems[begin].mesh) {
+            ++end;
+        }
+
+        const Mesh* mesh = m_geometry->GetMesh(MeshHandle(m_drawItems[begin].mesh));
+        if (mesh) {
+            if (mesh->instancedVAO != boundVertexArray) {
+                glBindVertexArray(mesh->instancedVAO);
+                boundVertexArray = mesh->instancedVAO;
+            }
+            const MeshAllocation& range = mesh->allocation;
+            void* indexOffset = (void*)(static_cast<uintptr_t>(range.firstIndex) * sizeof(unsigned int));
+            GLsizei count = static_cast<GLsizei>(end - begin);
+            if (upload.IsValid()) {
+                glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+                                                              indexOffset, count, range.baseVertex,
+                                                              baseInstance + static_cast<GLuint>(begin));
+            } else {
+                // Orphan + refill per run, the slow path without buffer storage
+                glBindBuffer(GL_ARRAY_BUFFER, m_geometry->GetInstanceBuffer());
+                glBufferData(GL_ARRAY_BUFFER, count * sizeof(InstanceData), m_instanceRows.data() + begin,
+                             GL_STREAM_DRAW);
+                glBindBuffer(GL_ARRAY_BUFFER, 0);
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT, indexOffset,
+                                                  count, range.baseVertex);
+            }
+            m_stats.drawCalls++;
+        }
+        begin = end;
+    }
+}
+
+void ShadowCascades::CreateTextures(int resolution, int layers) {
+    DestroyTextures();
+
+    // Final layers sample with hardware compare + bilinear PCF. Outside the map counts as lit.
+    const float border[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    auto createArray = [resolution](int layerCount, bool compare) {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, resolution, resolution, layerCount, 0,
+                     GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+        if (compare) {
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        }
+        return texture;
+    };
+
+    m_finalTexture = createArray(layers, true);
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+    m_staticTexture = createArray(layers, false);
+    m_scratchTexture = createArray(1, false);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    m_textureResolution = resolution;
+    m_textureLayers = layers;
+    int64_t bytes = static_cast<int64_t>(resolution) * resolution * 4 * (2 * layers + 1);
+    MemoryTracker::Adjust(MemoryTag::RenderTargets, bytes);
+    BS_DEBUG_F(LogCategory::RENDERER, "Shadow cascades: %d x %dx%d, %.1f MB", layers, resolution, resolution,
+               static_cast<float>(bytes) / (1024.0f * 1024.0f));
+}
+
+void ShadowCascades::DestroyTextures() {
+    if (m_finalTexture == 0) {
+        return;
+    }
+    GLuint textures[] = {m_finalTexture, m_staticTexture, m_scratchTexture};
+    glDeleteTextures(3, textures);
+    MemoryTracker::Adjust(MemoryTag::RenderTargets,
+                          -static_cast<int64_t>(m_textureResolution) * m_textureResolution * 4 *
+                              (2 * m_textureLayers + 1));
+    m_finalTexture = 0;
+    m_staticTexture = 0;
+    m_scratchTexture = 0;
+    m_textureResolution = 0;
+    m_textureLayers = 0;
+}
+
+}  // namespace Blacksite
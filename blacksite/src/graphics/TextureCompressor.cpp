@@ -0,0 +1,195 @@
+#include "blacksite/graphics/TextureCompressor.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Blacksite {
+
+namespace {
+
+struct Color {
+    int r, g, b;
+};
+
+uint16_t To565(const Color& c) {
+    return static_cast<uint16_t>(((c.r * 31 + 127) / 255) << 11 | ((c.g * 63 + 127) / 255) << 5 |
+                                 ((c.b * 31 + 127) / 255));
+}
+
+// What the GPU expands the 565 endpoint back to, palette fitting has to use these
+Color From565(uint16_t value) {
+    int r = (value >> 11) & 31;
+    int g = (value >> 5) & 63;
+    int b = value & 31;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+// 4x4 RGBA block at (x, y), clamped at the right and bottom edges
+void FetchBlock(const ImageData& image, uint32_t x, uint32_t y, uint8_t block[64]) {
+    for (uint32_t row = 0; row < 4; ++row) {
+        uint32_t sy = std::min(y + row, image.height - 1);
+        for (uint32_t column = 0; column < 4; ++column) {
+            uint32_t sx = std::min(x + column, image.width - 1);
+            std::memcpy(&block[(row * 4 + column) * 4], &image.rgba[(static_cast<size_t>(sy) * image.width + sx) * 4],
+                        4);
+        }
+    }
+}
+
+// BC1 color half: two 565 endpoints, 2 bit index per pixel. Always the 4 color mode (color0 > color1).
+void EncodeColorBlock(const uint8_t block[64], uint8_t out[8]) {
+    Color min{255, 255, 255};
+    Color max{0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        const uint8_t* p = &block[i * 4];
+        min = {std::min(min.r, int(p[0])), std::min(min.g, int(p[1])), std::min(min.b, int(p[2]))};
+        max = {std::max(max.r, int(p[0])), std::max(max.g, int(p[1])), std::max(max.b, int(p[2]))};
+    }
+
+    // Pull the extents in by 1/16 of the range, the interpolated colors land closer to the actual pixels
+    Color inset{(max.r - min.r) >> 4, (max.g - min.g) >> 4, (max.b - min.b) >> 4};
+    min = {std::min(255, min.r + inset.r), std::min(255, min.g + inset.g), std::min(255, min.b + inset.b)};
+    max = {std::max(0, max.r - inset.r), std::max(0, max.g - inset.g), std::max(0, max.b - inset.b)};
+
+    uint16_t color0 = To565(max);
+    uint16_t color1 = To565(min);
+    uint32_t indices = 0;
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    if (color0 != color1) {
+        Color c0 = From565(color0);
+        Color c1 = From565(color1);
+        Color axis{c1.r - c0.r, c1.g - c0.g, c1.b - c0.b};
+        int lengthSq = axis.r * axis.r + axis.g * axis.g + axis.b * axis.b;
+
+        // Palette order is c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1 - map the position along the axis onto it
+        static constexpr uint32_t STEP_TO_INDEX[4] = {0, 2, 3, 1};
+        for (int i = 0; i < 16; ++i) {
+            const uint8_t* p = &block[i * 4];
+            int dot = (p[0] - c0.r) * axis.r + (p[1] - c0.g) * axis.g + (p[2] - c0.b) * axis.b;
+            int step = std::clamp((dot * 3 + lengthSq / 2) / lengthSq, 0, 3);
+            indices |= STEP_TO_INDEX[step] << (i * 2);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(color0 & 0xff);
+    out[1] = static_cast<uint8_t>(color0 >> 8);
+    out[2] = static_cast<uint8_t>(color1 & 0xff);
+    out[3] = static_cast<uint8_t>(color1 >> 8);
+    for (int i = 0; i < 4; ++i) {
+        out[4 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+}
+
+// BC3 alpha half: two 8 bit endpoints, 3 bit index per pixel, 8 value mode (alpha0 > alpha1)
+void EncodeAlphaBlock(const uint8_t block[64], uint8_t out[8]) {
+    int min = 255;
+    int max = 0;
+    for (int i = 0; i < 16; ++i) {
+        min = std::min(min, int(block[i * 4 + 3]));
+        max = std::max(max, int(block[i * 4 + 3]));
+    }
+
+    uint64_t indices = 0;
+    if (max != min) {
+        // Palette order is a0, a1, then 6/7 a0 + 1/7 a1 ... 1/7 a0 + 6/7 a1
+        int range = max - min;
+        for (int i = 0; i < 16; ++i) {
+            int step = ((max - block[i * 4 + 3]) * 7 + range / 2) / range;
+            uint64_t index = step == 0 ? 0 : step == 7 ? 1 : static_cast<uint64_t>(step + 1);
+            indices |= index << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(max);
+    out[1] = static_cast<uint8_t>(min);
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+}
+
+template<typename EncodeFn>
+void CompressBlocks(const ImageData& image, size_t blockBytes, std::vector<uint8_t>& out, EncodeFn&& encode) {
+    uint32_t blocksX = (image.width + 3) / 4;
+    uint32_t blocksY = (image.height + 3) / 4;
+    out.resize(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+    uint8_t block[64];
+    uint8_t* dst = out.data();
+    for (uint32_t y = 0; y < blocksY; ++y) {
+        for (uint32_t x = 0; x < blocksX; ++x, dst += blockBytes) {
+            FetchBlock(image, x * 4, y * 4, block);
+            encode(block, dst);
+        }
+    }
+}
+
+}  // namespace
+
+void TextureCompressor::GenerateMipChain(const ImageData& image, std::vector<ImageData>& out) {
+    out.clear();
+    out.push_back(image);
+
+    while (out.back().width > 1 || out.back().height > 1) {
+        const ImageData& src = out.back();
+        ImageData mip;
+        mip.width = std::max(1u, src.width / 2);
+        mip.height = std::max(1u, src.height / 2);
+        mip.rgba.resize(static_cast<size_t>(mip.width) * mip.height * 4);
+
+        // 2x2 box, a 1 pixel wide side just averages with itself
+        for (uint32_t y = 0; y < mip.height; ++y) {
+            uint32_t y0 = std::min(y * 2, src.height - 1);
+            uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+            for (uint32_t x = 0; x < mip.width; ++x) {
+                uint32_t x0 = std::min(x * 2, src.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+                const uint8_t* a = &src.rgba[(static_cast<size_t>(y0) * src.width + x0) * 4];
+                const uint8_t* b = &src.rgba[(static_cast<size_t>(y0) * src.width + x1) * 4];
+                const uint8_t* c = &src.rgba[(static_cast<size_t>(y1) * src.width + x0) * 4];
+                const uint8_t* d = &src.rgba[(static_cast<size_t>(y1) * src.width + x1) * 4];
+                uint8_t* dst = &mip.rgba[(static_cast<size_t>(y) * mip.width + x) * 4];
+                for (int channel = 0; channel < 4; ++channel) {
+                    dst[channel] = static_cast<uint8_t>((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4);
+                }
+            }
+        }
+        out.push_back(std::move(mip));
+    }
+}
+
+void TextureCompressor::CompressBC1(const ImageData& image, std::vector<uint8_t>& out) {
+    CompressBlocks(image, 8, out, [](const uint8_t* block, uint8_t* dst) { EncodeColorBlock(block, dst); });
+}
+
+void TextureCompressor::CompressBC3(const ImageData& image, std::vector<uint8_t>& out) {
+    CompressBlocks(image, 16, out, [](const uint8_t* block, uint8_t* dst) {
+        EncodeAlphaBlock(block, dst);
+        EncodeColorBlock(block, dst + 8);
+    });
+}
+
+bool TextureCompressor::HasAlpha(const ImageData& image) {
+    for (size_t i = 3; i < image.rgba.size(); i += 4) {
+        if (image.rgba[i] != 255) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t TextureCompressor::GetLevelSize(TextureFormat format, uint32_t width, uint32_t height) {
+    size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+    switch (format) {
+        case TextureFormat::BC1:
+            return blocks * 8;
+        case TextureFormat::BC3:
+            return blocks * 16;
+        default:
+            return static_cast<size_t>(width) * height * 4;
+    }
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,188 @@
+#include "blacksite/graphics/TextureImporter.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace Blacksite {
+
+namespace {
+
+// .bstex layout: this header, mipCount (offset, size) pairs, then the levels, full size first.
+// Every level starts on a 16 byte boundary. Native endianness, like the mesh cache.
+struct TextureCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceStamp;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t mipCount;
+};
+static_assert(sizeof(TextureCacheHeader) == 32, "TextureCacheHeader layout is part of the file format");
+
+constexpr char CACHE_MAGIC[4] = {'B', 'S', 'T', 'X'};
+constexpr uint32_t MAX_MIPS = 16;  // Past ImageLoader::MAX_DIMENSION
+
+size_t AlignUp(size_t value) {
+    return (value + 15) & ~size_t(15);
+}
+
+}  // namespace
+
+bool TextureCacheFile::Open(const std::string& path, uint64_t sourceStamp) {
+    Close();
+    if (!m_file.Open(path, sizeof(TextureCacheHeader)))
+        return false;
+    const uint8_t* data = m_file.Data();
+
+    TextureCacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    TextureFormat format = static_cast<TextureFormat>(header.format);
+    size_t tableEnd = sizeof(header) + static_cast<size_t>(header.mipCount) * sizeof(MipRange);
+
+    bool valid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                 header.version == TextureImporter::CACHE_VERSION &&
+                 (sourceStamp == 0 || header.sourceStamp == sourceStamp) &&
+                 header.format <= static_cast<uint32_t>(TextureFormat::BC3) && header.width > 0 &&
+                 header.height > 0 && header.mipCount > 0 && header.mipCount <= MAX_MIPS && m_file.Size() >= tableEnd;
+
+    // Every level has to be exactly the size its dimensions say and sit inside the file
+    if (valid) {
+        m_mips.resize(header.mipCount);
+        std::memcpy(m_mips.data(), data + sizeof(header), header.mipCount * sizeof(MipRange));
+        for (uint32_t level = 0; level < header.mipCount && valid; ++level) {
+            uint32_t width = std::max(1u, header.width >> level);
+            uint32_t height = std::max(1u, header.height >> level);
+            const MipRange& mip = m_mips[level];
+            valid = mip.size == TextureCompressor::GetLevelSize(format, width, height) && mip.offset >= tableEnd &&
+                    mip.offset % 16 == 0 && mip.offset + mip.size <= m_file.Size();
+        }
+    }
+    if (!valid) {
+        BS_DEBUG_F(LogCategory::RENDERER, "Texture cache '%s' is stale or malformed, ignoring it", path.c_str());
+        Close();
+        return false;
+    }
+
+    m_width = header.width;
+    m_height = header.height;
+    m_format = format;
+    return true;
+}
+
+void TextureCacheFile::Close() {
+    m_file.Close();
+    m_width = 0;
+    m_height = 0;
+    m_format = TextureFormat::RGBA8;
+    m_mips.clear();
+}
+
+bool TextureImporter::Import(const std::string& sourcePath, TextureAsset& out) {
+    BS_PROFILE_SCOPE("TextureImporter::Import");
+
+    ImageData image;
+    if (!ImageLoader::Load(sourcePath, image)) {
+        return false;
+    }
+
+    std::vector<ImageData> chain;
+    TextureCompressor::GenerateMipChain(image, chain);
+
+    out.width = image.width;
+    out.height = image.height;
+    out.format = TextureCompressor::HasAlpha(image) ? TextureFormat::BC3 : TextureFormat::BC1;
+    out.mips.resize(chain.size());
+    for (size_t level = 0; level < chain.size(); ++level) {
+        if (out.format == TextureFormat::BC3) {
+            TextureCompressor::CompressBC3(chain[level], out.mips[level]);
+        } else {
+            TextureCompressor::CompressBC1(chain[level], out.mips[level]);
+        }
+    }
+
+    BS_INFO_F(LogCategory::RENDERER, "Imported texture '%s' (%ux%u, %s, %zu mips)", sourcePath.c_str(), out.width,
+              out.height, out.format == TextureFormat::BC3 ? "BC3" : "BC1", out.mips.size());
+    return true;
+}
+
+bool TextureImporter::WriteCache(const std::string& cachePath, uint64_t sourceStamp, const TextureAsset& texture) {
+    TextureCacheHeader header{};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.sourceStamp = sourceStamp;
+    header.width = texture.width;
+    header.height = texture.height;
+    header.format = static_cast<uint32_t>(texture.format);
+    header.mipCount = static_cast<uint32_t>(texture.mips.size());
+
+    // Offsets first, the levels follow the table
+    std::vector<uint64_t> table;
+    size_t offset = AlignUp(sizeof(header) + texture.mips.size() * 2 * sizeof(uint64_t));
+    for (const std::vector<uint8_t>& mip : texture.mips) {
+        table.push_back(offset);
+        table.push_back(mip.size());
+        offset = AlignUp(offset + mip.size());
+    }
+
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            BS_WARN_F(LogCategory::RENDERER, "Can't write texture cache '%s'", tempPath.c_str());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()),
+                   static_cast<std::streamsize>(table.size() * sizeof(uint64_t)));
+
+        static const char padding[16] = {};
+        for (size_t level = 0; level < texture.mips.size(); ++level) {
+            size_t position = static_cast<size_t>(file.tellp());
+            file.write(padding, static_cast<std::streamsize>(table[level * 2] - position));
+            file.write(reinterpret_cast<const char*>(texture.mips[level].data()),
+                       static_cast<std::streamsize>(texture.mips[level].size()));
+        }
+        if (!file) {
+            BS_WARN_F(LogCategory::RENDERER, "Failed writing texture cache '%s'", tempPath.c_str());
+            file.close();
+            std::error_code ignored;
+            std::filesystem::remove(tempPath, ignored);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) {
+        BS_WARN_F(LogCategory::RENDERER, "Can't move texture cache into place at '%s': %s", cachePath.c_str(),
+                  error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool TextureImporter::ImportToCache(const std::string& sourcePath) {
+    std::string cachePath = GetCachePath(sourcePath);
+    uint64_t stamp = GetSourceStamp(sourcePath);
+    if (stamp == 0) {
+        BS_ERROR_F(LogCategory::RENDERER, "Texture file '%s' not found", sourcePath.c_str());
+        return false;
+    }
+
+    TextureCacheFile cache;
+    if (cache.Open(cachePath, stamp)) {
+        return true;
+    }
+
+    TextureAsset asset;
+    return Import(sourcePath, asset) && WriteCache(cachePath, stamp, asset);
+}
+
+}  // namespace Blacksite
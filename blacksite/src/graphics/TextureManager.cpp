@@ -0,0 +1,319 @@
+#include "blacksite/graphics/TextureManager.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/GLDebug.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Blacksite {
+
+TextureManager::~TextureManager() {
+    Cleanup();
+}
+
+bool TextureManager::Initialize() {
+    m_compressionSupported = GLEW_EXT_texture_compression_s3tc;
+    if (!m_compressionSupported) {
+        BS_WARN(LogCategory::RENDERER, "No S3TC support, compressed textures won't load");
+    }
+    BS_DEBUG_F(LogCategory::RENDERER, "Texture streaming ready (%zu MB budget)", m_memoryBudget / (1024 * 1024));
+    return true;
+}
+
+void TextureManager::Cleanup() {
+    for (Texture& texture : m_textures) {
+        Release(texture);
+    }
+    m_textures.clear();
+    m_textureHandles.clear();
+    m_freeSlots.clear();
+    m_stats = TextureStreamingStats{};
+}
+
+TextureHandle TextureManager::LoadTexture(const std::string& name, const std::string& path) {
+    BS_PROFILE_SCOPE("TextureManager::LoadTexture");
+
+    std::string cachePath = TextureImporter::GetCachePath(path);
+    uint64_t stamp = TextureImporter::GetSourceStamp(path);
+
+    // The cache has to exist either way, it's what the mips stream from
+    auto file = std::make_unique<TextureCacheFile>();
+    if (!file->Open(cachePath, stamp)) {
+        if (stamp == 0) {
+            BS_ERROR_F(LogCategory::RENDERER, "Texture file '%s' not found (and no cache next to it)", path.c_str());
+            return TextureHandle{};
+        }
+        TextureAsset asset;
+        if (!TextureImporter::Import(path, asset)) {
+            return TextureHandle{};
+        }
+        if (!TextureImporter::WriteCache(cachePath, stamp, asset) || !file->Open(cachePath, stamp)) {
+            BS_ERROR_F(LogCategory::RENDERER, "Texture '%s' imported but its cache can't be used", name.c_str());
+            return TextureHandle{};
+        }
+    }
+
+    if (file->GetFormat() != TextureFormat::RGBA8 && !m_compressionSupported) {
+        BS_ERROR_F(LogCategory::RENDERER, "Texture '%s' is block compressed and this GPU can't sample that",
+                   name.c_str());
+        return TextureHandle{};
+    }
+
+    // Same name reuses the slot, otherwise a freed one, otherwise a new one
+    TextureHandle handle = GetTextureHandle(name);
+    if (handle.IsValid()) {
+        Release(m_textures[handle.id]);
+    } else if (!m_freeSlots.empty()) {
+        handle = TextureHandle(m_freeSlots.back());
+        m_freeSlots.pop_back();
+    } else if (m_textures.size() < MAX_TEXTURES) {
+        handle = TextureHandle(static_cast<uint32_t>(m_textures.size()));
+        m_textures.emplace_back();
+    } else {
+        BS_ERROR_F(LogCategory::RENDERER, "Can't load texture '%s', already at %u textures", name.c_str(),
+                   MAX_TEXTURES);
+        return TextureHandle{};
+    }
+
+    Texture& texture = m_textures[handle.id];
+    texture.name = name;
+    texture.file = std::move(file);
+    texture.tailLevel = 0;
+    while (texture.tailLevel + 1 < texture.file->GetMipCount() &&
+           std::max(texture.file->GetWidth(), texture.file->GetHeight()) >> texture.tailLevel > RESIDENT_TAIL_SIZE) {
+        ++texture.tailLevel;
+    }
+
+    // Starts out at the tail, Update brings in the rest once something draws it
+    if (!MakeResident(texture, texture.tailLevel)) {
+        BS_ERROR_F(LogCategory::RENDERER, "Failed to upload texture '%s'", name.c_str());
+        Release(texture);
+        m_textureHandles.erase(name);
+        m_freeSlots.push_back(handle.id);
+        return TextureHandle{};
+    }
+    m_textureHandles[name] = handle;
+
+    BS_DEBUG_F(LogCategory::RENDERER, "Texture '%s' loaded (%ux%u, %u mips, %u resident)", name.c_str(),
+               texture.file->GetWidth(), texture.file->GetHeight(), texture.file->GetMipCount(),
+               texture.file->GetMipCount() - texture.tailLevel);
+    return handle;
+}
+
+TextureHandle TextureManager::GetTextureHandle(const std::string& name) const {
+    auto it = m_textureHandles.find(name);
+    return it != m_textureHandles.end() ? it->second : TextureHandle{};
+}
+
+void TextureManager::DestroyTexture(TextureHandle handle) {
+    Texture* texture = Find(handle);
+    if (!texture) {
+        return;
+    }
+    m_textureHandles.erase(texture->name);
+    Release(*texture);
+    m_freeSlots.push_back(handle.id);
+}
+
+GLuint TextureManager::GetGLTexture(TextureHandle handle) const {
+    const Texture* texture = Find(handle);
+    return texture ? texture->id : 0;
+}
+
+uint32_t TextureManager::GetResidentLevel(TextureHandle handle) const {
+    const Texture* texture = Find(handle);
+    return texture ? texture->residentLevel : 0;
+}
+
+void TextureManager::RequestResolution(TextureHandle handle, float screenPixels) {
+    Texture* texture = Find(handle);
+    if (texture) {
+        texture->demand = std::max(texture->demand, screenPixels);
+    }
+}
+
+void TextureManager::Update() {
+    BS_PROFILE_SCOPE("TextureManager::Update");
+
+    m_stats = TextureStreamingStats{};
+    std::vector<Texture*> live;
+    live.reserve(m_textures.size());
+    size_t total = 0;
+
+    // Finer than wanted stays as long as there's room, it's already paid for
+    for (Texture& texture : m_textures) {
+        if (!texture.file) {
+            continue;
+        }
+        texture.wantedLevel = WantedLevel(texture);
+        texture.targetLevel = std::min(texture.wantedLevel, texture.residentLevel);
+        total += ResidentBytes(texture, texture.targetLevel);
+        m_stats.wantedBytes += ResidentBytes(texture, texture.wantedLevel);
+        live.push_back(&texture);
+    }
+    std::stable_sort(live.begin(), live.end(),
+                     [](const Texture* a, const Texture* b) { return a->demand < b->demand; });
+
+    // Over budget: give back the leftovers past the demand first, then coarsen a level at a time, least
+    // visible textures first each round
+    for (Texture* texture : live) {
+        if (total <= m_memoryBudget) {
+            break;
+        }
+        if (texture->targetLevel < texture->wantedLevel) {
+            total -= ResidentBytes(*texture, texture->targetLevel) - ResidentBytes(*texture, texture->wantedLevel);
+            texture->targetLevel = texture->wantedLevel;
+        }
+    }
+    for (bool progress = true; total > m_memoryBudget && progress;) {
+        progress = false;
+        for (Texture* texture : live) {
+            if (total <= m_memoryBudget) {
+                break;
+            }
+            if (texture->targetLevel < texture->tailLevel) {
+                total -= ResidentBytes(*texture, texture->targetLevel) -
+                         ResidentBytes(*texture, texture->targetLevel + 1);
+                ++texture->targetLevel;
+                progress = true;
+            }
+        }
+    }
+
+    // Dropping levels happens right away, it's what frees the memory
+    for (Texture* texture : live) {
+        if (texture->targetLevel > texture->residentLevel) {
+            MakeResident(*texture, texture->targetLevel);
+        }
+    }
+
+    // Sharpening goes most visible first, as far as the upload budget reaches. Each step re-uploads the
+    // coarser levels too (the texture gets re-created at the new size), cheap next to the new top level.
+    for (auto it = live.rbegin(); it != live.rend(); ++it) {
+        Texture& texture = **it;
+        if (texture.targetLevel >= texture.residentLevel) {
+            continue;
+        }
+        size_t remaining = m_uploadBudget > m_stats.uploadedBytes ? m_uploadBudget - m_stats.uploadedBytes : 0;
+        uint32_t level = texture.targetLevel;
+        while (level < texture.residentLevel && ResidentBytes(texture, level) > remaining) {
+            ++level;
+        }
+        // Always get somewhere, even if a single level is bigger than the whole budget
+        if (level == texture.residentLevel && m_stats.uploadedBytes == 0) {
+            level = texture.residentLevel - 1;
+        }
+        if (level < texture.residentLevel && MakeResident(texture, level)) {
+            m_stats.uploadedBytes += ResidentBytes(texture, level);
+        }
+    }
+
+    for (Texture* texture : live) {
+        m_stats.residentBytes += ResidentBytes(*texture, texture->residentLevel);
+        m_stats.starvedCount += texture->residentLevel > texture->wantedLevel ? 1 : 0;
+        texture->demand = 0.0f;
+    }
+    m_stats.textureCount = static_cast<uint32_t>(live.size());
+}
+
+TextureManager::Texture* TextureManager::Find(TextureHandle handle) {
+    if (!handle.IsValid() || handle.id >= m_textures.size() || !m_textures[handle.id].file) {
+        return nullptr;
+    }
+    return &m_textures[handle.id];
+}
+
+const TextureManager::Texture* TextureManager::Find(TextureHandle handle) const {
+    if (!handle.IsValid() || handle.id >= m_textures.size() || !m_textures[handle.id].file) {
+        return nullptr;
+    }
+    return &m_textures[handle.id];
+}
+
+uint32_t TextureManager::WantedLevel(const Texture& texture) const {
+    if (texture.demand <= 0.0f) {
+        return texture.tailLevel;  // Not drawn this frame
+    }
+    float size = static_cast<float>(std::max(texture.file->GetWidth(), texture.file->GetHeight()));
+    if (texture.demand >= size) {
+        return 0;
+    }
+    // One texel per pixel or better: the level whose size is still at least the demand
+    uint32_t level = static_cast<uint32_t>(std::floor(std::log2(size / texture.demand)));
+    return std::min(level, texture.tailLevel);
+}
+
+size_t TextureManager::ResidentBytes(const Texture& texture, uint32_t level) {
+    size_t bytes = 0;
+    for (uint32_t i = level; i < texture.file->GetMipCount(); ++i) {
+        bytes += texture.file->GetMipSize(i);
+    }
+    return bytes;
+}
+
+bool TextureManager::MakeResident(Texture& texture, uint32_t level) {
+    const TextureCacheFile& file = *texture.file;
+    GLenum internalFormat = GL_RGBA8;
+    if (file.GetFormat() == TextureFormat::BC1) {
+        internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    } else if (file.GetFormat() == TextureFormat::BC3) {
+        internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+
+    GLDebug::PollErrors("before TextureManager::MakeResident");
+
+    GLuint id = 0;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    for (uint32_t mip = level; mip < file.GetMipCount(); ++mip) {
+        GLsizei width = static_cast<GLsizei>(std::max(1u, file.GetWidth() >> mip));
+        GLsizei height = static_cast<GLsizei>(std::max(1u, file.GetHeight() >> mip));
+        GLint target = static_cast<GLint>(mip - level);
+        if (file.GetFormat() == TextureFormat::RGBA8) {
+            glTexImage2D(GL_TEXTURE_2D, target, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                         file.GetMipData(mip));
+        } else {
+            glCompressedTexImage2D(GL_TEXTURE_2D, target, internalFormat, width, height, 0,
+                                   static_cast<GLsizei>(file.GetMipSize(mip)), file.GetMipData(mip));
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(file.GetMipCount() - 1 - level));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        BS_ERROR_F(LogCategory::RENDERER, "TextureManager: Uploading from mip %u failed (GL error 0x%X)", level,
+                   error);
+        GLDebug::PollErrors("TextureManager::MakeResident");  // Whatever else the upload queued
+        glDeleteTextures(1, &id);
+        return false;
+    }
+
+    int64_t previous = 0;
+    if (texture.id != 0) {
+        previous = static_cast<int64_t>(ResidentBytes(texture, texture.residentLevel));
+        glDeleteTextures(1, &texture.id);
+    }
+    MemoryTracker::Adjust(MemoryTag::Textures, static_cast<int64_t>(ResidentBytes(texture, level)) - previous);
+    texture.id = id;
+    texture.residentLevel = level;
+    return true;
+}
+
+void TextureManager::Release(Texture& texture) {
+    if (texture.id != 0) {
+        int64_t bytes = static_cast<int64_t>(ResidentBytes(texture, texture.residentLevel));
+        MemoryTracker::Adjust(MemoryTag::Textures, -bytes);
+        glDeleteTextures(1, &texture.id);
+    }
+    texture = Texture{};
+}
+
+}  // namespace Blacksite
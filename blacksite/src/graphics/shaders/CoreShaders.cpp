@@ -3,6 +3,21 @@
 namespace Blacksite {
 namespace Shaders {
 
+// Mirrors ShaderManager::FrameData, std140. Not a shader on its own - ShaderLibrary puts it right after
+// the #version line of every stage that reads it.
+const char* FRAME_DATA_BLOCK = R"(
+    layout (std140) uniform FrameData {
+        mat4 uView;
+        mat4 uProjection;
+        vec3 uLightDir;
+        vec3 uViewPos;
+        float uTime;
+        mat4 uShadowMatrices[4];  // World -> cascade texture coords + depth
+        vec4 uCascadeSplits;      // View distance where each cascade ends
+        vec4 uShadowParams;       // x = cascade count (0 = no shadows), y = depth bias, w = texel size
+    };
+)";
+
 const char* BASIC_VERTEX_SHADER = R"(
     #version 330 core
     layout (location = 0) in vec3 aPos;
@@ -10,8 +25,6 @@ const char* BASIC_VERTEX_SHADER = R"(
     layout (location = 2) in vec2 aTexCoord;
 
     uniform mat4 uModel;
-    uniform mat4 uView;
-    uniform mat4 uProjection;
 
     out vec3 FragPos;
     out vec3 Normal;
@@ -33,13 +46,44 @@ const char* BASIC_FRAGMENT_SHADER = R"(
     in vec3 Normal;
     in vec2 TexCoord;
 
-    out vec4 FragColor;
+    layout (location = 0) out vec4 FragColor;
+    layout (location = 1) out uint EntityId;  // Picking buffer, dropped unless it's attached
 
     uniform vec3 uColor;
-    uniform vec3 uLightPos;
-    uniform vec3 uViewPos;
+    uniform uint uEntityId;
     uniform bool uHasTexture;
     uniform sampler2D uTexture;
+    uniform sampler2DArrayShadow uShadowMap;  // Unit 1, one layer per cascade
+
+    // 1 = lit, 0 = in shadow. 2x2 taps on top of the hardware's filtered compare.
+    float ShadowFactor(vec3 worldPos)
+    {
+        int cascadeCount = int(uShadowParams.x);
+        float viewDepth = -(uView * vec4(worldPos, 1.0)).z;
+        if (cascadeCount == 0 || viewDepth > uCascadeSplits[cascadeCount - 1]) {
+            return 1.0;
+        }
+
+        int cascade = 0;
+        while (cascade < cascadeCount - 1 && viewDepth > uCascadeSplits[cascade]) {
+            cascade++;
+        }
+
+        vec3 coord = (uShadowMatrices[cascade] * vec4(worldPos, 1.0)).xyz;
+        if (coord.z >= 1.0) {
+            return 1.0;
+        }
+
+        float reference = coord.z - uShadowParams.y;
+        float lit = 0.0;
+        for (int x = 0; x < 2; ++x) {
+            for (int y = 0; y < 2; ++y) {
+                vec2 offset = (vec2(x, y) - 0.5) * uShadowParams.w;
+                lit += texture(uShadowMap, vec4(coord.xy + offset, float(cascade), reference));
+            }
+        }
+        return lit * 0.25;
+    }
 
     void main()
     {
@@ -50,7 +94,7 @@ const char* BASIC_FRAGMENT_SHADER = R"(
 
         vec3 lightColor = vec3(1.0);
         vec3 norm = normalize(Normal);
-        vec3 lightDir = normalize(uLightPos - FragPos);
+        vec3 lightDir = normalize(uLightDir);
 
         // Ambient
         float ambientStrength = 0.1;
@@ -68,11 +112,13 @@ const char* BASIC_FRAGMENT_SHADER = R"(
         vec3 specular = specularStrength * spec * lightColor;
 
         // HDR-friendly: Don't clamp the result, allow bright colors to stay bright
-        vec3 result = (ambient + diffuse + specular) * baseColor;
+        float shadow = ShadowFactor(FragPos);
+        vec3 result = (ambient + shadow * (diffuse + specular)) * baseColor;
 
         // For HDR bloom: if baseColor is bright (>1.0), preserve it
         // This allows your {10.0, 2.0, 2.0} colors to work for bloom
         FragColor = vec4(result, 1.0);
+        EntityId = uEntityId;
     }
 )";
 
@@ -84,8 +130,6 @@ const char* UNLIT_VERTEX_SHADER = R"(
     layout (location = 2) in vec2 aTexCoord;
 
     uniform mat4 uModel;
-    uniform mat4 uView;
-    uniform mat4 uProjection;
 
     out vec2 TexCoord;
 
@@ -101,9 +145,11 @@ const char* UNLIT_FRAGMENT_SHADER = R"(
     #version 330 core
     in vec2 TexCoord;
 
-    out vec4 FragColor;
+    layout (location = 0) out vec4 FragColor;
+    layout (location = 1) out uint EntityId;  // Picking buffer, dropped unless it's attached
 
     uniform vec3 uColor;
+    uniform uint uEntityId;
     uniform bool uHasTexture;
     uniform sampler2D uTexture;
 
@@ -114,6 +160,159 @@ const char* UNLIT_FRAGMENT_SHADER = R"(
             color *= texture(uTexture, TexCoord).rgb;
         }
         FragColor = vec4(color, 1.0);
+        EntityId = uEntityId;
+    }
+)";
+
+// Instanced variants - same look as basic/unlit, but the model matrix, color and entity id come
+// from a per-instance vertex buffer (see InstanceData in MeshArena.h)
+const char* BASIC_INSTANCED_VERTEX_SHADER = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+    layout (location = 1) in vec3 aNormal;
+    layout (location = 2) in vec2 aTexCoord;
+    layout (location = 3) in mat4 aInstanceModel;  // Eats locations 3-6
+    layout (location = 7) in vec3 aInstanceColor;
+    layout (location = 8) in uint aInstanceEntityId;
+
+    out vec3 FragPos;
+    out vec3 Normal;
+    out vec2 TexCoord;
+    out vec3 InstanceColor;
+    flat out uint InstanceEntityId;
+
+    void main()
+    {
+        FragPos = vec3(aInstanceModel * vec4(aPos, 1.0));
+        Normal = mat3(transpose(inverse(aInstanceModel))) * aNormal;
+        TexCoord = aTexCoord;
+        InstanceColor = aInstanceColor;
+        InstanceEntityId = aInstanceEntityId;
+
+        gl_Position = uProjection * uView * vec4(FragPos, 1.0);
+    }
+)";
+
+const char* BASIC_INSTANCED_FRAGMENT_SHADER = R"(
+    #version 330 core
+    in vec3 FragPos;
+    in vec3 Normal;
+    in vec2 TexCoord;
+    in vec3 InstanceColor;
+    flat in uint InstanceEntityId;
+
+    layout (location = 0) out vec4 FragColor;
+    layout (location = 1) out uint EntityId;
+
+    uniform bool uHasTexture;
+    uniform sampler2D uTexture;
+    uniform sampler2DArrayShadow uShadowMap;  // Unit 1, one layer per cascade
+
+    // 1 = lit, 0 = in shadow. 2x2 taps on top of the hardware's filtered compare.
+    float ShadowFactor(vec3 worldPos)
+    {
+        int cascadeCount = int(uShadowParams.x);
+        float viewDepth = -(uView * vec4(worldPos, 1.0)).z;
+        if (cascadeCount == 0 || viewDepth > uCascadeSplits[cascadeCount - 1]) {
+            return 1.0;
+        }
+
+        int cascade = 0;
+        while (cascade < cascadeCount - 1 && viewDepth > uCascadeSplits[cascade]) {
+            cascade++;
+        }
+
+        vec3 coord = (uShadowMatrices[cascade] * vec4(worldPos, 1.0)).xyz;
+        if (coord.z >= 1.0) {
+            return 1.0;
+        }
+
+        float reference = coord.z - uShadowParams.y;
+        float lit = 0.0;
+        for (int x = 0; x < 2; ++x) {
+            for (int y = 0; y < 2; ++y) {
+                vec2 offset = (vec2(x, y) - 0.5) * uShadowParams.w;
+                lit += texture(uShadowMap, vec4(coord.xy + offset, float(cascade), reference));
+            }
+        }
+        return lit * 0.25;
+    }
+
+    void main()
+    {
+        vec3 baseColor = InstanceColor;
+        if (uHasTexture) {
+            baseColor *= texture(uTexture, TexCoord).rgb;
+        }
+
+        vec3 lightColor = vec3(1.0);
+        vec3 norm = normalize(Normal);
+        vec3 lightDir = normalize(uLightDir);
+
+        // Ambient
+        float ambientStrength = 0.1;
+        vec3 ambient = ambientStrength * lightColor;
+
+        // Diffuse
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 diffuse = diff * lightColor;
+
+        // Specular
+        float specularStrength = 0.5;
+        vec3 viewDir = normalize(uViewPos - FragPos);
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+        vec3 specular = specularStrength * spec * lightColor;
+
+        float shadow = ShadowFactor(FragPos);
+        vec3 result = (ambient + shadow * (diffuse + specular)) * baseColor;
+        FragColor = vec4(result, 1.0);
+        EntityId = InstanceEntityId;
+    }
+)";
+
+const char* UNLIT_INSTANCED_VERTEX_SHADER = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+    layout (location = 1) in vec3 aNormal;
+    layout (location = 2) in vec2 aTexCoord;
+    layout (location = 3) in mat4 aInstanceModel;
+    layout (location = 7) in vec3 aInstanceColor;
+    layout (location = 8) in uint aInstanceEntityId;
+
+    out vec2 TexCoord;
+    out vec3 InstanceColor;
+    flat out uint InstanceEntityId;
+
+    void main()
+    {
+        TexCoord = aTexCoord;
+        InstanceColor = aInstanceColor;
+        InstanceEntityId = aInstanceEntityId;
+        gl_Position = uProjection * uView * aInstanceModel * vec4(aPos, 1.0);
+    }
+)";
+
+const char* UNLIT_INSTANCED_FRAGMENT_SHADER = R"(
+    #version 330 core
+    in vec2 TexCoord;
+    in vec3 InstanceColor;
+    flat in uint InstanceEntityId;
+
+    layout (location = 0) out vec4 FragColor;
+    layout (location = 1) out uint EntityId;
+
+    uniform bool uHasTexture;
+    uniform sampler2D uTexture;
+
+    void main()
+    {
+        vec3 color = InstanceColor;
+        if (uHasTexture) {
+            color *= texture(uTexture, TexCoord).rgb;
+        }
+        FragColor = vec4(color, 1.0);
+        EntityId = InstanceEntityId;
     }
 )";
 
@@ -124,8 +323,6 @@ const char* TRANSPARENT_VERTEX_SHADER = R"(
     layout (location = 2) in vec2 aTexCoord;
 
     uniform mat4 uModel;
-    uniform mat4 uView;
-    uniform mat4 uProjection;
 
     out vec3 FragPos;
     out vec3 Normal;
@@ -147,12 +344,12 @@ const char* TRANSPARENT_FRAGMENT_SHADER = R"(
     in vec3 Normal;
     in vec2 TexCoord;
 
-    out vec4 FragColor;
+    layout (location = 0) out vec4 FragColor;
+    layout (location = 1) out uint EntityId;  // Picking buffer, dropped unless it's attached
 
     uniform vec3 uColor;
+    uniform uint uEntityId;
     uniform float uAlpha;
-    uniform vec3 uLightPos;
-    uniform vec3 uViewPos;
     uniform bool uHasTexture;
     uniform sampler2D uTexture;
 
@@ -169,7 +366,7 @@ const char* TRANSPARENT_FRAGMENT_SHADER = R"(
 
         vec3 lightColor = vec3(1.0);
         vec3 norm = normalize(Normal);
-        vec3 lightDir = normalize(uLightPos - FragPos);
+        vec3 lightDir = normalize(uLightDir);
 
         float ambientStrength = 0.3;
         vec3 ambient = ambientStrength * lightColor;
@@ -179,9 +376,54 @@ const char* TRANSPARENT_FRAGMENT_SHADER = R"(
 
         vec3 result = (ambient + diffuse) * baseColor;
         FragColor = vec4(result, alpha);
+        EntityId = uEntityId;
+    }
+)";
+
+const char* DEPTH_ONLY_VERTEX_SHADER = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+
+    uniform mat4 uModel;
+
+    void main()
+    {
+        // Same order of operations as basic, so the main pass lands on (nearly) the same depth
+        vec3 worldPos = vec3(uModel * vec4(aPos, 1.0));
+        gl_Position = uProjection * uView * vec4(worldPos, 1.0);
+    }
+)";
+
+const char* DEPTH_ONLY_FRAGMENT_SHADER = R"(
+    #version 330 core
+
+    // Color writes are masked off during the pre-pass, depth is all we're after
+    void main()
+    {
     }
 )";
 
+const char* SHADOW_DEPTH_VERTEX_SHADER = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;
+    layout (location = 3) in mat4 aInstanceModel;  // Same instance layout as basic_instanced, only the model used
+
+    uniform mat4 uLightViewProj;  // One cascade's, set per cascade
+
+    void main()
+    {
+        gl_Position = uLightViewProj * aInstanceModel * vec4(aPos, 1.0);
+    }
+)";
+
+const char* SHADOW_DEPTH_FRAGMENT_SHADER = R"(
+    #version 330 core
+
+    // Shadow map is a depth-only target
+    void main()
+    {
+    }
+)";
 
 } // namespace Shaders
 } // namespace Blacksite
@@ -10,8 +10,6 @@ namespace Shaders {
         layout (location = 2) in vec2 aTexCoord;
 
         uniform mat4 uModel;
-        uniform mat4 uView;
-        uniform mat4 uProjection;
 
         out vec3 barycentric;
 
@@ -54,8 +52,6 @@ const char* DEBUG_VERTEX_SHADER = R"(
     layout (location = 1) in vec3 aNormal;
 
     uniform mat4 uModel;
-    uniform mat4 uView;
-    uniform mat4 uProjection;
 
     out vec3 Normal;
 
@@ -95,6 +91,33 @@ const char* DEBUG_FRAGMENT_SHADER = R"(
     }
 )";
 
+const char* DEBUG_LINES_VERTEX_SHADER = R"(
+    #version 330 core
+    layout (location = 0) in vec3 aPos;    // Already in world space
+    layout (location = 1) in vec4 aColor;
+
+    out vec4 LineColor;
+
+    void main()
+    {
+        LineColor = aColor;
+        gl_Position = uProjection * uView * vec4(aPos, 1.0);
+    }
+)";
+
+const char* DEBUG_LINES_FRAGMENT_SHADER = R"(
+    #version 330 core
+    in vec4 LineColor;
+
+    layout (location = 0) out vec4 FragColor;
+    layout (location = 1) out uint EntityId;  // Lines aren't pickable, don't leave garbage in the picking buffer
+
+    void main()
+    {
+        FragColor = LineColor;
+        EntityId = 0u;
+    }
+)";
 
 } // namespace Shaders
 } // namespace Blacksite
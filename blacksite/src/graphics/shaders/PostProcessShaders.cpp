@@ -10,9 +10,12 @@ const char* POSTPROCESS_VERTEX_SHADER = R"(
 
     out vec2 TexCoord;
 
+    // Pooled targets can be bigger than what we draw into, this is 1 - used fraction (0 = whole texture)
+    uniform vec2 uTexCoordTrim;
+
     void main()
     {
-        TexCoord = aTexCoord;
+        TexCoord = aTexCoord * (1.0 - uTexCoordTrim);
         gl_Position = vec4(aPos, 0.0, 1.0);
     }
 )";
@@ -96,6 +99,113 @@ const char* BLUR_FRAGMENT_SHADER = R"(
     }
 )";
 
+const char* BLOOM_DOWNSAMPLE_FRAGMENT_SHADER = R"(
+    #version 330 core
+    in vec2 TexCoord;
+
+    out vec4 FragColor;
+
+    uniform sampler2D uTexture;
+    uniform vec2 uTexelSize;   // Of the source mip
+    uniform bool uPrefilter;   // First pass only: bright pass + firefly suppression
+    uniform vec4 uThreshold;   // threshold, threshold - knee, 2 * knee, 0.25 / knee
+    uniform vec2 uUvMax;       // Last texel center of the used area, nothing past it is ours
+
+    vec3 sampleAt(vec2 offset) {
+        return texture(uTexture, min(TexCoord + offset * uTexelSize, uUvMax)).rgb;
+    }
+
+    // Karis average - weights each box by 1 / (1 + luma), so single bright pixels can't flicker
+    float karisWeight(vec3 color) {
+        return 1.0 / (1.0 + dot(color, vec3(0.2126, 0.7152, 0.0722)));
+    }
+
+    // Soft-knee threshold, fades in over the knee instead of a hard cut
+    vec3 brightPass(vec3 color) {
+        float brightness = max(color.r, max(color.g, color.b));
+        float soft = clamp(brightness - uThreshold.y, 0.0, uThreshold.z);
+        soft = soft * soft * uThreshold.w;
+        float contribution = max(soft, brightness - uThreshold.x) / max(brightness, 0.00001);
+        return color * contribution;
+    }
+
+    void main()
+    {
+        // 13 taps: a 4x4 box at the center plus four overlapping 2x2 boxes around it
+        vec3 a = sampleAt(vec2(-2.0, 2.0));
+        vec3 b = sampleAt(vec2(0.0, 2.0));
+        vec3 c = sampleAt(vec2(2.0, 2.0));
+        vec3 d = sampleAt(vec2(-2.0, 0.0));
+        vec3 e = sampleAt(vec2(0.0, 0.0));
+        vec3 f = sampleAt(vec2(2.0, 0.0));
+        vec3 g = sampleAt(vec2(-2.0, -2.0));
+        vec3 h = sampleAt(vec2(0.0, -2.0));
+        vec3 i = sampleAt(vec2(2.0, -2.0));
+        vec3 j = sampleAt(vec2(-1.0, 1.0));
+        vec3 k = sampleAt(vec2(1.0, 1.0));
+        vec3 l = sampleAt(vec2(-1.0, -1.0));
+        vec3 m = sampleAt(vec2(1.0, -1.0));
+
+        vec3 center = (j + k + l + m) * 0.25;
+        vec3 topLeft = (a + b + d + e) * 0.25;
+        vec3 topRight = (b + c + e + f) * 0.25;
+        vec3 bottomLeft = (d + e + g + h) * 0.25;
+        vec3 bottomRight = (e + f + h + i) * 0.25;
+
+        vec3 result;
+        if (uPrefilter) {
+            float w0 = 0.5 * karisWeight(center);
+            float w1 = 0.125 * karisWeight(topLeft);
+            float w2 = 0.125 * karisWeight(topRight);
+            float w3 = 0.125 * karisWeight(bottomLeft);
+            float w4 = 0.125 * karisWeight(bottomRight);
+            result = (center * w0 + topLeft * w1 + topRight * w2 + bottomLeft * w3 + bottomRight * w4) /
+                     (w0 + w1 + w2 + w3 + w4);
+            result = brightPass(result);
+        } else {
+            result = center * 0.5 + (topLeft + topRight + bottomLeft + bottomRight) * 0.125;
+        }
+
+        FragColor = vec4(result, 1.0);
+    }
+)";
+
+const char* BLOOM_UPSAMPLE_FRAGMENT_SHADER = R"(
+    #version 330 core
+    in vec2 TexCoord;
+
+    out vec4 FragColor;
+
+    uniform sampler2D uTexture;
+    uniform vec2 uTexelSize;  // Of the source (smaller) mip
+    uniform float uRadius;    // Tent size in source texels
+    uniform vec2 uUvMax;      // Last texel center of the used area
+
+    vec3 sampleAt(vec2 uv) {
+        return texture(uTexture, min(uv, uUvMax)).rgb;
+    }
+
+    void main()
+    {
+        // 3x3 tent, blended additively into the next mip up
+        vec2 d = uTexelSize * uRadius;
+        vec3 result = sampleAt(TexCoord) * 4.0;
+
+        vec3 edges = sampleAt(TexCoord + vec2(0.0, d.y));
+        edges += sampleAt(TexCoord - vec2(0.0, d.y));
+        edges += sampleAt(TexCoord + vec2(d.x, 0.0));
+        edges += sampleAt(TexCoord - vec2(d.x, 0.0));
+        result += edges * 2.0;
+
+        result += sampleAt(TexCoord + d);
+        result += sampleAt(TexCoord - d);
+        result += sampleAt(TexCoord + vec2(d.x, -d.y));
+        result += sampleAt(TexCoord + vec2(-d.x, d.y));
+
+        FragColor = vec4(result * (1.0 / 16.0), 1.0);
+    }
+)";
+
 const char* BLOOM_VERTEX_SHADER = POSTPROCESS_VERTEX_SHADER;
 
 const char* BLOOM_FRAGMENT_SHADER = R"(
@@ -109,6 +219,7 @@ const char* BLOOM_FRAGMENT_SHADER = R"(
     uniform float uBloomStrength;
     uniform float uExposure;
     uniform float uGamma;
+    uniform vec2 uBloomUvMax;  // Bloom mip is smaller, clamp so its filter stays in the used area
 
     // Improved tone mapping function
     vec3 reinhardToneMapping(vec3 color, float exposure) {
@@ -130,7 +241,7 @@ const char* BLOOM_FRAGMENT_SHADER = R"(
     void main()
     {
         vec3 sceneColor = texture(uScene, TexCoord).rgb;
-        vec3 bloomColor = texture(uBloomBlur, TexCoord).rgb;
+        vec3 bloomColor = texture(uBloomBlur, min(TexCoord, uBloomUvMax)).rgb;
 
         // Combine scene and bloom with much lower bloom contribution
         vec3 result = sceneColor + bloomColor * uBloomStrength;
@@ -155,7 +266,12 @@ const char* FXAA_FRAGMENT_SHADER = R"(
     out vec4 FragColor;
 
     uniform sampler2D uTexture;
-    uniform vec2 uInverseScreenSize;
+    uniform vec2 uInverseScreenSize;  // Of the texture, not the used area
+    uniform vec2 uUvMax;
+
+    vec3 sampleAt(vec2 uv) {
+        return texture(uTexture, min(uv, uUvMax)).rgb;
+    }
 
     #define FXAA_REDUCE_MIN   (1.0/ 128.0)
     #define FXAA_REDUCE_MUL   (1.0 / 8.0)
@@ -163,11 +279,11 @@ const char* FXAA_FRAGMENT_SHADER = R"(
 
     void main()
     {
-        vec3 rgbNW = texture(uTexture, TexCoord + vec2(-1.0, -1.0) * uInverseScreenSize).rgb;
-        vec3 rgbNE = texture(uTexture, TexCoord + vec2(1.0, -1.0) * uInverseScreenSize).rgb;
-        vec3 rgbSW = texture(uTexture, TexCoord + vec2(-1.0, 1.0) * uInverseScreenSize).rgb;
-        vec3 rgbSE = texture(uTexture, TexCoord + vec2(1.0, 1.0) * uInverseScreenSize).rgb;
-        vec3 rgbM = texture(uTexture, TexCoord).rgb;
+        vec3 rgbNW = sampleAt(TexCoord + vec2(-1.0, -1.0) * uInverseScreenSize);
+        vec3 rgbNE = sampleAt(TexCoord + vec2(1.0, -1.0) * uInverseScreenSize);
+        vec3 rgbSW = sampleAt(TexCoord + vec2(-1.0, 1.0) * uInverseScreenSize);
+        vec3 rgbSE = sampleAt(TexCoord + vec2(1.0, 1.0) * uInverseScreenSize);
+        vec3 rgbM = sampleAt(TexCoord);
 
         vec3 luma = vec3(0.299, 0.587, 0.114);
         float lumaNW = dot(rgbNW, luma);
@@ -190,10 +306,10 @@ const char* FXAA_FRAGMENT_SHADER = R"(
         dir = min(vec2(FXAA_SPAN_MAX), max(vec2(-FXAA_SPAN_MAX),
                  dir * rcpDirMin)) * uInverseScreenSize;
 
-        vec3 rgbA = 0.5 * (texture(uTexture, TexCoord + dir * (1.0/3.0 - 0.5)).rgb +
-                          texture(uTexture, TexCoord + dir * (2.0/3.0 - 0.5)).rgb);
-        vec3 rgbB = rgbA * 0.5 + 0.25 * (texture(uTexture, TexCoord + dir * -0.5).rgb +
-                                        texture(uTexture, TexCoord + dir * 0.5).rgb);
+        vec3 rgbA = 0.5 * (sampleAt(TexCoord + dir * (1.0/3.0 - 0.5)) +
+                          sampleAt(TexCoord + dir * (2.0/3.0 - 0.5)));
+        vec3 rgbB = rgbA * 0.5 + 0.25 * (sampleAt(TexCoord + dir * -0.5) +
+                                        sampleAt(TexCoord + dir * 0.5));
 
         float lumaB = dot(rgbB, luma);
         if ((lumaB < lumaMin) || (lumaB > lumaMax)) {
@@ -204,6 +320,135 @@ const char* FXAA_FRAGMENT_SHADER = R"(
     }
 )";
 
+const char* COMPOSITE_FXAA_COMPUTE_SHADER = R"(
+    #version 430 core
+    layout (local_size_x = 16, local_size_y = 16) in;
+
+    layout (rgba16f, binding = 0) uniform writeonly image2D uOutput;
+    uniform sampler2D uScene;
+    uniform sampler2D uBloomBlur;
+    uniform float uBloomStrength;
+    uniform float uExposure;
+    uniform float uGamma;
+    uniform bool uFXAA;
+    uniform ivec2 uSize;       // Used area, the textures can be bigger
+    uniform vec2 uBloomUvMax;
+
+    // FXAA reaches SPAN_MAX pixels out, +1 for the bilinear neighbour
+    #define FXAA_REDUCE_MIN   (1.0 / 128.0)
+    #define FXAA_REDUCE_MUL   (1.0 / 8.0)
+    #define FXAA_SPAN_MAX     4.0
+    #define HALO 5
+    #define TILE (16 + 2 * HALO)
+
+    const vec3 LUMA = vec3(0.299, 0.587, 0.114);
+
+    // Tone mapped color + luma for the group's pixels and the halo around them
+    shared vec4 sTile[TILE * TILE];
+
+    vec3 composite(ivec2 pixel) {
+        vec2 uv = min((vec2(pixel) + 0.5) / vec2(textureSize(uScene, 0)), uBloomUvMax);
+        vec3 color = texelFetch(uScene, pixel, 0).rgb + texture(uBloomBlur, uv).rgb * uBloomStrength;
+
+        // Same Reinhard + gamma as the fragment path
+        color *= uExposure;
+        color = color / (1.0 + color);
+        return pow(color, vec3(1.0 / uGamma));
+    }
+
+    vec4 tileAt(ivec2 p) {
+        return sTile[p.y * TILE + p.x];
+    }
+
+    // Bilinear out of shared memory, p in tile pixels (integer = pixel center)
+    vec3 tileSample(vec2 p) {
+        vec2 base = floor(p);
+        vec2 f = p - base;
+        ivec2 i = ivec2(base);
+        vec3 top = mix(tileAt(i).rgb, tileAt(i + ivec2(1, 0)).rgb, f.x);
+        vec3 bottom = mix(tileAt(i + ivec2(0, 1)).rgb, tileAt(i + ivec2(1, 1)).rgb, f.x);
+        return mix(top, bottom, f.y);
+    }
+
+    void main()
+    {
+        // Every thread fills a few tile slots, so each input pixel is fetched and tone mapped once per group
+        ivec2 origin = ivec2(gl_WorkGroupID.xy) * 16 - HALO;
+        for (uint i = gl_LocalInvocationIndex; i < uint(TILE * TILE); i += 256u) {
+            ivec2 pixel = clamp(origin + ivec2(int(i) % TILE, int(i) / TILE), ivec2(0), uSize - 1);
+            vec3 color = composite(pixel);
+            sTile[i] = vec4(color, dot(color, LUMA));
+        }
+        barrier();
+
+        ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+        if (any(greaterThanEqual(pixel, uSize))) {
+            return;
+        }
+
+        ivec2 t = ivec2(gl_LocalInvocationID.xy) + HALO;
+        vec4 center = tileAt(t);
+        if (!uFXAA) {
+            imageStore(uOutput, pixel, vec4(center.rgb, 1.0));
+            return;
+        }
+
+        float lumaNW = tileAt(t + ivec2(-1, -1)).a;
+        float lumaNE = tileAt(t + ivec2(1, -1)).a;
+        float lumaSW = tileAt(t + ivec2(-1, 1)).a;
+        float lumaSE = tileAt(t + ivec2(1, 1)).a;
+        float lumaM = center.a;
+
+        float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+        float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+        vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)),
+                        ((lumaNW + lumaSW) - (lumaNE + lumaSE)));
+
+        float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+        float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+        dir = clamp(dir * rcpDirMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX));
+
+        vec2 p = vec2(t);
+        vec3 rgbA = 0.5 * (tileSample(p + dir * (1.0 / 3.0 - 0.5)) + tileSample(p + dir * (2.0 / 3.0 - 0.5)));
+        vec3 rgbB = rgbA * 0.5 + 0.25 * (tileSample(p + dir * -0.5) + tileSample(p + dir * 0.5));
+
+        float lumaB = dot(rgbB, LUMA);
+        vec3 result = (lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB;
+        imageStore(uOutput, pixel, vec4(result, 1.0));
+    }
+)";
+
+const char* HIZ_VERTEX_SHADER = R"(
+    #version 330 core
+
+    // One triangle over the whole target, no vertex buffer needed
+    void main()
+    {
+        vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+        gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+    }
+)";
+
+const char* HIZ_DOWNSAMPLE_FRAGMENT_SHADER = R"(
+    #version 330 core
+    layout (location = 0) out float MaxDepth;
+
+    uniform sampler2D uSource;  // Depth texture for the first level, the previous R32F level after that
+    uniform ivec2 uSourceSize;  // Texels that hold this frame's depth, the texture can be bigger
+
+    void main()
+    {
+        // Farthest of the 2x2 texels under us. Odd sizes clamp, the last row/column covers the leftover.
+        ivec2 base = ivec2(gl_FragCoord.xy) * 2;
+        ivec2 last = uSourceSize - 1;
+        float depth = texelFetch(uSource, min(base, last), 0).r;
+        depth = max(depth, texelFetch(uSource, min(base + ivec2(1, 0), last), 0).r);
+        depth = max(depth, texelFetch(uSource, min(base + ivec2(0, 1), last), 0).r);
+        depth = max(depth, texelFetch(uSource, min(base + ivec2(1, 1), last), 0).r);
+        MaxDepth = depth;
+    }
+)";
 
 } // namespace Shaders
 } // namespace Blacksite
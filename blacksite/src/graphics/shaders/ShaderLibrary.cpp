@@ -8,6 +8,7 @@ namespace Blacksite {
 // Static member definitions
 std::unordered_map<std::string, ShaderSource> ShaderLibrary::s_shaders;
 std::unordered_map<ShaderType, std::string> ShaderLibrary::s_typeToName;
+std::deque<std::string> ShaderLibrary::s_generatedSources;
 bool ShaderLibrary::s_initialized = false;
 
 const ShaderSource* ShaderLibrary::GetShader(const std::string& name) {
@@ -92,13 +93,25 @@ bool ShaderLibrary::ShaderRequiresLighting(const std::string& name) {
     return shader ? shader->requiresLighting : true; // Default to true for safety
 }
 
+const char* ShaderLibrary::WithFrameData(const char* source) {
+    // #version has to stay the first thing in the source, so the block goes on the line after it
+    std::string expanded = source;
+    size_t version = expanded.find("#version");
+    size_t lineEnd = version == std::string::npos ? std::string::npos : expanded.find('\n', version);
+    size_t insertAt = lineEnd == std::string::npos ? 0 : lineEnd + 1;
+    expanded.insert(insertAt, Shaders::FRAME_DATA_BLOCK);
+
+    s_generatedSources.push_back(std::move(expanded));
+    return s_generatedSources.back().c_str();
+}
+
 void ShaderLibrary::InitializeShaders() {
     if (s_initialized) return;
 
     // Core rendering shaders
     s_shaders["basic"] = {
-        Shaders::BASIC_VERTEX_SHADER,
-        Shaders::BASIC_FRAGMENT_SHADER,
+        WithFrameData(Shaders::BASIC_VERTEX_SHADER),
+        WithFrameData(Shaders::BASIC_FRAGMENT_SHADER),
         "basic",
         "Standard Phong lighting with texture support",
         false, // requiresTime
@@ -106,7 +119,7 @@ void ShaderLibrary::InitializeShaders() {
     };
 
     s_shaders["unlit"] = {
-        Shaders::UNLIT_VERTEX_SHADER,
+        WithFrameData(Shaders::UNLIT_VERTEX_SHADER),
         Shaders::UNLIT_FRAGMENT_SHADER,
         "unlit",
         "No lighting, just color and texture",
@@ -114,18 +127,54 @@ void ShaderLibrary::InitializeShaders() {
         false  // requiresLighting
     };
 
+    s_shaders["basic_instanced"] = {
+        WithFrameData(Shaders::BASIC_INSTANCED_VERTEX_SHADER),
+        WithFrameData(Shaders::BASIC_INSTANCED_FRAGMENT_SHADER),
+        "basic_instanced",
+        "Instanced Phong lighting, transform and color per instance",
+        false, // requiresTime
+        true   // requiresLighting
+    };
+
+    s_shaders["unlit_instanced"] = {
+        WithFrameData(Shaders::UNLIT_INSTANCED_VERTEX_SHADER),
+        Shaders::UNLIT_INSTANCED_FRAGMENT_SHADER,
+        "unlit_instanced",
+        "Instanced unlit, transform and color per instance",
+        false, // requiresTime
+        false  // requiresLighting
+    };
+
     s_shaders["transparent"] = {
-        Shaders::TRANSPARENT_VERTEX_SHADER,
-        Shaders::TRANSPARENT_FRAGMENT_SHADER,
+        WithFrameData(Shaders::TRANSPARENT_VERTEX_SHADER),
+        WithFrameData(Shaders::TRANSPARENT_FRAGMENT_SHADER),
         "transparent",
         "Basic lighting with alpha blending support",
         false, // requiresTime
         true   // requiresLighting
     };
 
+    s_shaders["depth_only"] = {
+        WithFrameData(Shaders::DEPTH_ONLY_VERTEX_SHADER),
+        Shaders::DEPTH_ONLY_FRAGMENT_SHADER,
+        "depth_only",
+        "Position only, for the depth pre-pass",
+        false, // requiresTime
+        false  // requiresLighting
+    };
+
+    s_shaders["shadow_depth"] = {
+        Shaders::SHADOW_DEPTH_VERTEX_SHADER,
+        Shaders::SHADOW_DEPTH_FRAGMENT_SHADER,
+        "shadow_depth",
+        "Instanced position only, renders shadow casters into a cascade",
+        false, // requiresTime
+        false  // requiresLighting
+    };
+
     // Debug shaders
     s_shaders["wireframe"] = {
-        Shaders::WIREFRAME_VERTEX_SHADER,
+        WithFrameData(Shaders::WIREFRAME_VERTEX_SHADER),
         Shaders::WIREFRAME_FRAGMENT_SHADER,
         "wireframe",
         "Simple wireframe rendering for debug visualization",
@@ -134,7 +183,7 @@ void ShaderLibrary::InitializeShaders() {
     };
 
     s_shaders["debug"] = {
-        Shaders::DEBUG_VERTEX_SHADER,
+        WithFrameData(Shaders::DEBUG_VERTEX_SHADER),
         Shaders::DEBUG_FRAGMENT_SHADER,
         "debug",
         "Debug shader with normal visualization",
@@ -142,6 +191,15 @@ void ShaderLibrary::InitializeShaders() {
         false  // requiresLighting
     };
 
+    s_shaders["debug_lines"] = {
+        WithFrameData(Shaders::DEBUG_LINES_VERTEX_SHADER),
+        Shaders::DEBUG_LINES_FRAGMENT_SHADER,
+        "debug_lines",
+        "Per-vertex colored lines, everything DebugDraw collected in one draw",
+        false, // requiresTime
+        false  // requiresLighting
+    };
+
     // Post-processing shaders
     s_shaders["postprocess"] = {
         Shaders::POSTPROCESS_VERTEX_SHADER,
@@ -170,6 +228,24 @@ void ShaderLibrary::InitializeShaders() {
         false  // requiresLighting
     };
 
+    s_shaders["bloom_downsample"] = {
+        Shaders::POSTPROCESS_VERTEX_SHADER,
+        Shaders::BLOOM_DOWNSAMPLE_FRAGMENT_SHADER,
+        "bloom_downsample",
+        "13-tap bloom downsample, bright pass on the first mip",
+        false, // requiresTime
+        false  // requiresLighting
+    };
+
+    s_shaders["bloom_upsample"] = {
+        Shaders::POSTPROCESS_VERTEX_SHADER,
+        Shaders::BLOOM_UPSAMPLE_FRAGMENT_SHADER,
+        "bloom_upsample",
+        "Tent-filtered bloom upsample, blended additively",
+        false, // requiresTime
+        false  // requiresLighting
+    };
+
     s_shaders["fxaa"] = {
         Shaders::FXAA_VERTEX_SHADER,
         Shaders::FXAA_FRAGMENT_SHADER,
@@ -179,16 +255,45 @@ void ShaderLibrary::InitializeShaders() {
         false  // requiresLighting
     };
 
+    s_shaders["hiz_downsample"] = {
+        Shaders::HIZ_VERTEX_SHADER,
+        Shaders::HIZ_DOWNSAMPLE_FRAGMENT_SHADER,
+        "hiz_downsample",
+        "Max-depth 2x2 reduction, one level of the Hi-Z pyramid",
+        false, // requiresTime
+        false  // requiresLighting
+    };
+
+    // Compute - no vertex/fragment stages, GL 4.3 only
+    s_shaders["composite_fxaa"] = {
+        nullptr,
+        nullptr,
+        "composite_fxaa",
+        "Compute: bloom composite, tone mapping and FXAA in one dispatch",
+        false, // requiresTime
+        false, // requiresLighting
+        Shaders::COMPOSITE_FXAA_COMPUTE_SHADER
+    };
+
     // Map shader types to names
     s_typeToName[ShaderType::Basic] = "basic";
     s_typeToName[ShaderType::Unlit] = "unlit";
+    s_typeToName[ShaderType::BasicInstanced] = "basic_instanced";
+    s_typeToName[ShaderType::UnlitInstanced] = "unlit_instanced";
     s_typeToName[ShaderType::Transparent] = "transparent";
+    s_typeToName[ShaderType::DepthOnly] = "depth_only";
+    s_typeToName[ShaderType::ShadowDepth] = "shadow_depth";
     s_typeToName[ShaderType::Wireframe] = "wireframe";
     s_typeToName[ShaderType::Debug] = "debug";
+    s_typeToName[ShaderType::DebugLines] = "debug_lines";
     s_typeToName[ShaderType::PostProcess] = "postprocess";
     s_typeToName[ShaderType::Blur] = "blur";
     s_typeToName[ShaderType::Bloom] = "bloom";
+    s_typeToName[ShaderType::BloomDownsample] = "bloom_downsample";
+    s_typeToName[ShaderType::BloomUpsample] = "bloom_upsample";
     s_typeToName[ShaderType::FXAA] = "fxaa";
+    s_typeToName[ShaderType::CompositeFXAA] = "composite_fxaa";
+    s_typeToName[ShaderType::HiZDownsample] = "hiz_downsample";
 
     s_initialized = true;
 }
@@ -0,0 +1,190 @@
+#include "blacksite/math/TransformBatch.h"
+#include "blacksite/math/Transform.h"
+
+// glm stores quaternions as x, y, z, w unless told otherwise - the SIMD loads rely on that
+#if defined(GLM_FORCE_QUAT_DATA_WXYZ)
+#define BS_MATRIX_KERNEL_SCALAR
+#elif defined(__AVX2__)
+#define BS_MATRIX_KERNEL_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BS_MATRIX_KERNEL_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BS_MATRIX_KERNEL_NEON
+#include <arm_neon.h>
+#else
+#define BS_MATRIX_KERNEL_SCALAR
+#endif
+
+namespace Blacksite {
+
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "BuildModelMatrices expects tightly packed vec3");
+static_assert(sizeof(glm::quat) == 4 * sizeof(float), "BuildModelMatrices expects tightly packed quat");
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "BuildModelMatrices expects tightly packed mat4");
+
+namespace {
+
+// Per-ISA lane ops. The math below is written once against these and instantiated per width.
+#if defined(BS_MATRIX_KERNEL_SSE) || defined(BS_MATRIX_KERNEL_AVX2)
+inline __m128 Splat(__m128, float v) { return _mm_set1_ps(v); }
+inline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+inline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+inline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+#endif
+
+#if defined(BS_MATRIX_KERNEL_AVX2)
+inline __m256 Splat(__m256, float v) { return _mm256_set1_ps(v); }
+inline __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+inline __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+inline __m256 Mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+#endif
+
+#if defined(BS_MATRIX_KERNEL_NEON)
+inline float32x4_t Splat(float32x4_t, float v) { return vdupq_n_f32(v); }
+inline float32x4_t Add(float32x4_t a, float32x4_t b) { return vaddq_f32(a, b); }
+inline float32x4_t Sub(float32x4_t a, float32x4_t b) { return vsubq_f32(a, b); }
+inline float32x4_t Mul(float32x4_t a, float32x4_t b) { return vmulq_f32(a, b); }
+#endif
+
+// Rotation * scale part of ComposeTRS, one entity per lane. q = xyzw, s = scale, out = the three
+// upper 3x3 columns (c0.xyz, c1.xyz, c2.xyz). Translation doesn't need any math.
+template <typename V>
+inline void ComposeLanes(const V q[4], const V s[3], V out[9]) {
+    V two = Splat(q[0], 2.0f);
+    V one = Splat(q[0], 1.0f);
+    V tx = Mul(q[0], two), ty = Mul(q[1], two), tz = Mul(q[2], two);
+    V xx = Mul(q[0], tx), yy = Mul(q[1], ty), zz = Mul(q[2], tz);
+    V xy = Mul(q[0], ty), xz = Mul(q[0], tz), yz = Mul(q[1], tz);
+    V wx = Mul(q[3], tx), wy = Mul(q[3], ty), wz = Mul(q[3], tz);
+
+    out[0] = Mul(Sub(one, Add(yy, zz)), s[0]);
+    out[1] = Mul(Add(xy, wz), s[0]);
+    out[2] = Mul(Sub(xz, wy), s[0]);
+    out[3] = Mul(Sub(xy, wz), s[1]);
+    out[4] = Mul(Sub(one, Add(xx, zz)), s[1]);
+    out[5] = Mul(Add(yz, wx), s[1]);
+    out[6] = Mul(Add(xz, wy), s[2]);
+    out[7] = Mul(Sub(yz, wx), s[2]);
+    out[8] = Mul(Sub(one, Add(xx, yy)), s[2]);
+}
+
+#if defined(BS_MATRIX_KERNEL_SSE) || defined(BS_MATRIX_KERNEL_AVX2)
+// 4 entities starting at 'i' into lanes: quaternions via a 4x4 transpose, vec3s gathered
+inline void LoadLanes4(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, size_t i,
+                       __m128 p[3], __m128 q[4], __m128 s[3]) {
+    q[0] = _mm_loadu_ps(&rotations[i].x);
+    q[1] = _mm_loadu_ps(&rotations[i + 1].x);
+    q[2] = _mm_loadu_ps(&rotations[i + 2].x);
+    q[3] = _mm_loadu_ps(&rotations[i + 3].x);
+    _MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+
+    for (int axis = 0; axis < 3; ++axis) {
+        p[axis] = _mm_setr_ps(positions[i][axis], positions[i + 1][axis], positions[i + 2][axis],
+                              positions[i + 3][axis]);
+        s[axis] = _mm_setr_ps(scales[i][axis], scales[i + 1][axis], scales[i + 2][axis], scales[i + 3][axis]);
+    }
+}
+
+// Lanes back to 4 matrices - each column is (x, y, z, w) across the lanes, transposed per entity
+inline void StoreLanes4(const __m128 m[9], const __m128 p[3], glm::mat4* out) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 columns[4][4] = {
+        {m[0], m[1], m[2], zero}, {m[3], m[4], m[5], zero}, {m[6], m[7], m[8], zero}, {p[0], p[1], p[2], one}};
+
+    for (int c = 0; c < 4; ++c) {
+        __m128 r0 = columns[c][0], r1 = columns[c][1], r2 = columns[c][2], r3 = columns[c][3];
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(&out[0][c][0], r0);
+        _mm_storeu_ps(&out[1][c][0], r1);
+        _mm_storeu_ps(&out[2][c][0], r2);
+        _mm_storeu_ps(&out[3][c][0], r3);
+    }
+}
+#endif
+
+}  // namespace
+
+void BuildModelMatrices(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales,
+                        size_t count, glm::mat4* out) {
+    size_t i = 0;
+
+#if defined(BS_MATRIX_KERNEL_AVX2)
+    // Two SSE-width loads glued together, the 256-bit part is the arithmetic
+    for (; i + 8 <= count; i += 8) {
+        __m128 pLo[3], qLo[4], sLo[3], pHi[3], qHi[4], sHi[3];
+        LoadLanes4(positions, rotations, scales, i, pLo, qLo, sLo);
+        LoadLanes4(positions, rotations, scales, i + 4, pHi, qHi, sHi);
+
+        __m256 q[4], s[3], m[9];
+        for (int k = 0; k < 4; ++k)
+            q[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(qLo[k]), qHi[k], 1);
+        for (int k = 0; k < 3; ++k)
+            s[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(sLo[k]), sHi[k], 1);
+        ComposeLanes(q, s, m);
+
+        __m128 mLo[9], mHi[9];
+        for (int k = 0; k < 9; ++k) {
+            mLo[k] = _mm256_castps256_ps128(m[k]);
+            mHi[k] = _mm256_extractf128_ps(m[k], 1);
+        }
+        StoreLanes4(mLo, pLo, out + i);
+        StoreLanes4(mHi, pHi, out + i + 4);
+    }
+#endif
+
+#if defined(BS_MATRIX_KERNEL_SSE) || defined(BS_MATRIX_KERNEL_AVX2)
+    for (; i + 4 <= count; i += 4) {
+        __m128 p[3], q[4], s[3], m[9];
+        LoadLanes4(positions, rotations, scales, i, p, q, s);
+        ComposeLanes(q, s, m);
+        StoreLanes4(m, p, out + i);
+    }
+#endif
+
+#if defined(BS_MATRIX_KERNEL_NEON)
+    // vld3/vld4 de-interleave straight into lanes, no transposes needed on the way in
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t p = vld3q_f32(&positions[i].x);
+        float32x4x3_t sc = vld3q_f32(&scales[i].x);
+        float32x4x4_t qv = vld4q_f32(&rotations[i].x);
+        float32x4_t q[4] = {qv.val[0], qv.val[1], qv.val[2], qv.val[3]};
+        float32x4_t s[3] = {sc.val[0], sc.val[1], sc.val[2]};
+        float32x4_t m[9];
+        ComposeLanes(q, s, m);
+
+        // vst4 lane stores write one entity's column (x, y, z, w) at a time
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        float32x4x4_t columns[4] = {{{m[0], m[1], m[2], zero}},
+                                    {{m[3], m[4], m[5], zero}},
+                                    {{m[6], m[7], m[8], zero}},
+                                    {{p.val[0], p.val[1], p.val[2], one}}};
+        for (int c = 0; c < 4; ++c) {
+            vst4q_lane_f32(&out[i][c][0], columns[c], 0);
+            vst4q_lane_f32(&out[i + 1][c][0], columns[c], 1);
+            vst4q_lane_f32(&out[i + 2][c][0], columns[c], 2);
+            vst4q_lane_f32(&out[i + 3][c][0], columns[c], 3);
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        out[i] = ComposeTRS(positions[i], rotations[i], scales[i]);
+    }
+}
+
+const char* GetModelMatrixKernelName() {
+#if defined(BS_MATRIX_KERNEL_AVX2)
+    return "AVX2";
+#elif defined(BS_MATRIX_KERNEL_SSE)
+    return "SSE";
+#elif defined(BS_MATRIX_KERNEL_NEON)
+    return "NEON";
+#else
+    return "Scalar";
+#endif
+}
+
+}  // namespace Blacksite
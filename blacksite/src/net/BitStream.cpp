@@ -0,0 +1,92 @@
+#include "blacksite/net/BitStream.h"
+
+#include <algorithm>
+
+namespace Blacksite {
+
+namespace {
+
+uint32_t ZigZag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t UnZigZag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+}  // namespace
+
+void BitWriter::Write(uint32_t value, int bits) {
+    if (bits < 32) {
+        value &= (1u << bits) - 1;
+    }
+    m_scratch |= static_cast<uint64_t>(value) << m_scratchBits;
+    m_scratchBits += bits;
+    m_bitCount += static_cast<size_t>(bits);
+
+    // Whole bytes out, at most 7 bits stay behind
+    while (m_scratchBits >= 8) {
+        m_buffer.push_back(static_cast<uint8_t>(m_scratch));
+        m_scratch >>= 8;
+        m_scratchBits -= 8;
+    }
+}
+
+void BitWriter::WriteSigned(int32_t value, int bits) {
+    Write(ZigZag(value), bits);
+}
+
+void BitWriter::WriteVarUint(uint32_t value) {
+    do {
+        Write(value & 0xF, 4);
+        value >>= 4;
+        WriteBool(value != 0);
+    } while (value != 0);
+}
+
+void BitWriter::Flush() {
+    if (m_scratchBits > 0) {
+        m_buffer.push_back(static_cast<uint8_t>(m_scratch));
+        m_bitCount += static_cast<size_t>(8 - m_scratchBits);
+        m_scratch = 0;
+        m_scratchBits = 0;
+    }
+}
+
+uint32_t BitReader::Read(int bits) {
+    if (m_overflowed || static_cast<size_t>(bits) > GetBitsRemaining()) {
+        m_overflowed = true;
+        return 0;
+    }
+
+    uint32_t value = 0;
+    int written = 0;
+    while (written < bits) {
+        size_t byte = m_bitPosition >> 3;
+        int offset = static_cast<int>(m_bitPosition & 7);
+        int take = std::min(8 - offset, bits - written);
+        uint32_t chunk = (static_cast<uint32_t>(m_data[byte]) >> offset) & ((1u << take) - 1);
+        value |= chunk << written;
+        written += take;
+        m_bitPosition += static_cast<size_t>(take);
+    }
+    return value;
+}
+
+int32_t BitReader::ReadSigned(int bits) {
+    return UnZigZag(Read(bits));
+}
+
+uint32_t BitReader::ReadVarUint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 4) {
+        value |= Read(4) << shift;
+        if (!ReadBool()) {
+            return value;
+        }
+    }
+    m_overflowed = true;  // More groups than a uint32 has, garbage
+    return 0;
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,505 @@
+#include "blacksite/net/Replication.h"
+#include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/net/BitStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Blacksite {
+
+namespace {
+
+// First byte of every datagram
+enum MessageType : uint32_t {
+    MSG_CONNECT = 1,     // Client -> server, protocol id
+    MSG_SNAPSHOT = 2,    // Server -> client, one fragment
+    MSG_ACK = 3,         // Client -> server, newest decoded tick
+    MSG_DISCONNECT = 4,  // Either way
+};
+
+constexpr uint32_t PROTOCOL_ID = 0x42535231;  // "BSR1", bump with any wire format change
+
+// type 8 + tick 32 + baseline tick 32 + fragment index 8 + fragment count 8 bits
+constexpr size_t FRAGMENT_HEADER_BYTES = 11;
+constexpr size_t FRAGMENT_PAYLOAD_BYTES = UdpSocket::MAX_DATAGRAM - FRAGMENT_HEADER_BYTES;
+constexpr size_t MAX_FRAGMENTS = 255;
+
+constexpr float HELLO_INTERVAL = 0.25f;
+
+const Snapshot EMPTY_SNAPSHOT;
+
+glm::vec3 UnpackColor(uint32_t color) {
+    auto channel = [&](int shift) { return static_cast<float>((color >> shift) & 0xFF) / 255.0f; };
+    return glm::vec3(channel(0), channel(8), channel(16));
+}
+
+EntityShape::VisualShape ClientShape(uint8_t shape) {
+    // No mesh name to go with it, a cube is the best stand-in
+    return shape == EntityShape::MESH ? EntityShape::CUBE : static_cast<EntityShape::VisualShape>(shape);
+}
+
+void WriteTransform(const SnapshotCodec& codec, const ReplicatedEntity& source, Transform& transform) {
+    for (int axis = 0; axis < 3; ++axis) {
+        transform.position[axis] = codec.DequantizePosition(source.position[axis]);
+        transform.scale[axis] = codec.DequantizeScale(source.scale[axis]);
+    }
+    transform.rotation = codec.DequantizeRotation(source.rotation);
+}
+
+}  // namespace
+
+// --- Server ---
+
+bool ReplicationServer::Start(uint16_t port, const ReplicationConfig& config) {
+    Stop();
+    m_config = config;
+    m_codec = SnapshotCodec(config);
+    if (!m_socket.Open(port)) {
+        return false;
+    }
+
+    m_tick = 0;
+    m_sendTimer = 0.0f;
+    m_stats = ReplicationStats{};
+    BS_INFO_F(LogCategory::NETWORK, "Replication server listening on port %u", static_cast<unsigned>(port));
+    return true;
+}
+
+void ReplicationServer::Stop() {
+    if (!IsRunning()) {
+        return;
+    }
+
+    const uint8_t goodbye = MSG_DISCONNECT;
+    while (!m_clients.empty()) {
+        m_socket.Send(m_clients.back().address, &goodbye, 1);
+        DropClient(m_clients.size() - 1, "server stopped");
+    }
+    m_socket.Close();
+    BS_INFO(LogCategory::NETWORK, "Replication server stopped");
+}
+
+void ReplicationServer::Update(const EntitySystem& entities, float deltaTime) {
+    BS_PROFILE_SCOPE("ReplicationServer::Update");
+    if (!IsRunning()) {
+        return;
+    }
+
+    ReceiveMessages();
+    for (size_t i = m_clients.size(); i-- > 0;) {
+        m_clients[i].silence += deltaTime;
+        if (m_clients[i].silence > m_config.clientTimeout) {
+            DropClient(i, "timed out");
+        }
+    }
+
+    m_statsTimer += deltaTime;
+    if (m_statsTimer >= 1.0f) {
+        m_stats.bytesPerSecond = static_cast<float>(m_bytesThisSecond) / m_statsTimer;
+        m_bytesThisSecond = 0;
+        m_statsTimer = 0.0f;
+    }
+    m_stats.clients = m_clients.size();
+
+    float interval = 1.0f / std::max(m_config.snapshotRate, 1.0f);
+    m_sendTimer += deltaTime;
+    if (m_sendTimer < interval) {
+        return;
+    }
+    // One snapshot per call even after a hitch, a burst of them would only be stale
+    m_sendTimer = std::min(m_sendTimer - interval, interval);
+
+    ++m_tick;
+    m_stats.tick = m_tick;
+    m_stats.snapshotBytes = 0;
+    m_stats.fullSnapshots = 0;
+    if (m_clients.empty()) {
+        return;
+    }
+
+    m_codec.Capture(entities, m_tick, m_captured);
+    for (Client& client : m_clients) {
+        if (client.interestRadius > 0.0f) {
+            m_codec.FilterByDistance(m_captured, client.interestCenter, client.interestRadius, m_filtered);
+            SendSnapshot(client, m_filtered);
+        } else {
+            SendSnapshot(client, m_captured);
+        }
+    }
+}
+
+void ReplicationServer::SetClientInterest(int clientId, const glm::vec3& center, float radius) {
+    for (Client& client : m_clients) {
+        if (client.id == clientId) {
+            client.interestCenter = center;
+            client.interestRadius = radius;
+            return;
+        }
+    }
+}
+
+void ReplicationServer::ReceiveMessages() {
+    uint8_t buffer[UdpSocket::MAX_DATAGRAM];
+    NetAddress from;
+    size_t size;
+    while ((size = m_socket.Receive(from, buffer, sizeof(buffer))) > 0) {
+        BitReader reader(buffer, size);
+        uint32_t type = reader.Read(8);
+        auto it = std::find_if(m_clients.begin(), m_clients.end(),
+                               [&](const Client& client) { return client.address == from; });
+
+        if (type == MSG_CONNECT) {
+            if (reader.Read(32) != PROTOCOL_ID) {
+                BS_WARN_F(LogCategory::NETWORK, "Ignoring connect from %s, protocol mismatch", from.ToString().c_str());
+                continue;
+            }
+            if (it != m_clients.end()) {
+                // Repeated hello, or the client started over - either way a full snapshot is the safe bet
+                it->ackedTick = 0;
+                it->silence = 0.0f;
+                continue;
+            }
+
+            m_clients.emplace_back();
+            Client& client = m_clients.back();
+            client.id = m_nextClientId++;
+            client.address = from;
+            BS_INFO_F(LogCategory::NETWORK, "Client %d connected from %s", client.id, from.ToString().c_str());
+            if (m_connectedCallback) {
+                m_connectedCallback(client.id, client.address);
+            }
+        } else if (it == m_clients.end()) {
+            continue;  // Strangers only get to say hello
+        } else if (type == MSG_ACK) {
+            uint32_t tick = reader.Read(32);
+            if (!reader.IsOverflowed() && tick > it->ackedTick && tick <= m_tick) {
+                it->ackedTick = tick;
+            }
+            it->silence = 0.0f;
+        } else if (type == MSG_DISCONNECT) {
+            DropClient(static_cast<size_t>(it - m_clients.begin()), "disconnected");
+        }
+    }
+}
+
+void ReplicationServer::DropClient(size_t index, const char* reason) {
+    Client& client = m_clients[index];
+    BS_INFO_F(LogCategory::NETWORK, "Client %d (%s) %s", client.id, client.address.ToString().c_str(), reason);
+    if (m_disconnectedCallback) {
+        m_disconnectedCallback(client.id, client.address);
+    }
+    m_clients.erase(m_clients.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+void ReplicationServer::SendSnapshot(Client& client, const Snapshot& snapshot) {
+    // The acked snapshot is only a baseline while it's still in the history
+    const Snapshot* baseline = nullptr;
+    if (client.ackedTick != 0 && m_tick - client.ackedTick < HISTORY_SIZE) {
+        const Snapshot& candidate = client.sent[client.ackedTick % HISTORY_SIZE];
+        if (candidate.tick == client.ackedTick) {
+            baseline = &candidate;
+        }
+    }
+
+    m_payload.clear();
+    {
+        BitWriter writer(m_payload);
+        m_codec.WriteDelta(baseline ? *baseline : EMPTY_SNAPSHOT, snapshot, writer);
+    }
+
+    size_t fragmentCount = (m_payload.size() + FRAGMENT_PAYLOAD_BYTES - 1) / FRAGMENT_PAYLOAD_BYTES;
+    if (fragmentCount > MAX_FRAGMENTS) {
+        if (!m_warnedOversize) {
+            BS_WARN_F(LogCategory::NETWORK, "Snapshot of %zu bytes doesn't fit in %zu fragments, not sent",
+                      m_payload.size(), MAX_FRAGMENTS);
+            m_warnedOversize = true;
+        }
+        return;
+    }
+
+    uint32_t baselineTick = baseline ? baseline->tick : 0;
+    for (size_t fragment = 0; fragment < fragmentCount; ++fragment) {
+        size_t offset = fragment * FRAGMENT_PAYLOAD_BYTES;
+        size_t length = std::min(FRAGMENT_PAYLOAD_BYTES, m_payload.size() - offset);
+
+        m_packet.clear();
+        {
+            BitWriter header(m_packet);
+            header.Write(MSG_SNAPSHOT, 8);
+            header.Write(m_tick, 32);
+            header.Write(baselineTick, 32);
+            header.Write(static_cast<uint32_t>(fragment), 8);
+            header.Write(static_cast<uint32_t>(fragmentCount), 8);
+        }
+        m_packet.insert(m_packet.end(), m_payload.begin() + static_cast<std::ptrdiff_t>(offset),
+                        m_payload.begin() + static_cast<std::ptrdiff_t>(offset + length));
+        m_socket.Send(client.address, m_packet.data(), m_packet.size());
+        m_bytesThisSecond += m_packet.size();
+    }
+
+    m_stats.snapshotBytes += m_payload.size();
+    if (!baseline) {
+        ++m_stats.fullSnapshots;
+    }
+
+    // Can't be the baseline's entry, that one is less than HISTORY_SIZE ticks old
+    Snapshot& sent = client.sent[m_tick % HISTORY_SIZE];
+    sent.tick = m_tick;
+    sent.entities.assign(snapshot.entities.begin(), snapshot.entities.end());
+}
+
+// --- Client ---
+
+bool ReplicationClient::Connect(const std::string& host, uint16_t port, const ReplicationConfig& config) {
+    Disconnect();
+    m_config = config;
+    m_codec = SnapshotCodec(config);
+    if (!NetAddress::Resolve(host, port, m_server) || !m_socket.Open()) {
+        return false;
+    }
+
+    ResetReception();
+    m_applied = Snapshot{};
+    m_localIds.clear();
+    m_helloTimer = 0.0f;  // First hello goes out with the next Update
+    BS_INFO_F(LogCategory::NETWORK, "Connecting to %s", m_server.ToString().c_str());
+    return true;
+}
+
+void ReplicationClient::Disconnect() {
+    if (!m_socket.IsOpen()) {
+        return;
+    }
+
+    SendControl(MSG_DISCONNECT, 0);
+    m_socket.Close();
+    m_connected = false;
+    BS_INFO_F(LogCategory::NETWORK, "Disconnected from %s", m_server.ToString().c_str());
+}
+
+void ReplicationClient::Update(EntitySystem& entities, float deltaTime) {
+    BS_PROFILE_SCOPE("ReplicationClient::Update");
+    if (!m_socket.IsOpen()) {
+        return;
+    }
+
+    uint32_t newestBefore = m_newestTick;
+    ReceiveMessages();
+
+    if (!m_connected) {
+        m_helloTimer -= deltaTime;
+        if (m_helloTimer <= 0.0f) {
+            SendControl(MSG_CONNECT, PROTOCOL_ID);
+            m_helloTimer = HELLO_INTERVAL;
+        }
+    } else {
+        m_silence += deltaTime;
+        if (m_silence > m_config.clientTimeout) {
+            // Back to saying hello, the server starts over with a full snapshot if it's still there
+            BS_WARN_F(LogCategory::NETWORK, "Lost the server at %s, reconnecting", m_server.ToString().c_str());
+            m_connected = false;
+            ResetReception();
+        }
+    }
+
+    // Only the newest matters, anything in between was already superseded
+    if (m_newestTick != newestBefore && m_newestTick != 0) {
+        Apply(entities, m_received[m_newestTick % HISTORY_SIZE]);
+    }
+}
+
+int ReplicationClient::GetLocalId(int serverId) const {
+    uint32_t slot = EntitySystem::GetIdIndex(serverId);
+    auto it = std::lower_bound(
+        m_applied.entities.begin(), m_applied.entities.end(), slot,
+        [](const ReplicatedEntity& entity, uint32_t value) { return entity.slot < value; });
+    if (it == m_applied.entities.end() || it->GetId() != serverId) {
+        return -1;
+    }
+    return m_localIds[slot];
+}
+
+void ReplicationClient::SendControl(uint32_t type, uint32_t value) {
+    std::vector<uint8_t> packet;
+    {
+        BitWriter writer(packet);
+        writer.Write(type, 8);
+        if (type != MSG_DISCONNECT) {
+            writer.Write(value, 32);
+        }
+    }
+    m_socket.Send(m_server, packet.data(), packet.size());
+}
+
+void ReplicationClient::ReceiveMessages() {
+    uint8_t buffer[UdpSocket::MAX_DATAGRAM];
+    NetAddress from;
+    size_t size;
+    while ((size = m_socket.Receive(from, buffer, sizeof(buffer))) > 0) {
+        if (from != m_server) {
+            continue;
+        }
+
+        BitReader reader(buffer, size);
+        uint32_t type = reader.Read(8);
+        if (type == MSG_SNAPSHOT && size > FRAGMENT_HEADER_BYTES) {
+            m_silence = 0.0f;
+            OnFragment(reader, buffer + FRAGMENT_HEADER_BYTES, size - FRAGMENT_HEADER_BYTES);
+        } else if (type == MSG_DISCONNECT && m_connected) {
+            BS_INFO_F(LogCategory::NETWORK, "Server at %s closed the connection", m_server.ToString().c_str());
+            m_connected = false;
+            ResetReception();
+            m_helloTimer = m_config.clientTimeout;  // Give it a moment before knocking again
+        }
+    }
+}
+
+void ReplicationClient::ResetReception() {
+    for (Snapshot& snapshot : m_received) {
+        snapshot.tick = 0;
+    }
+    m_newestTick = 0;
+    m_assemblyTick = 0;
+    m_fragmentsMissing = 0;
+    m_silence = 0.0f;
+}
+
+void ReplicationClient::OnFragment(BitReader& reader, const uint8_t* payload, size_t payloadSize) {
+    uint32_t tick = reader.Read(32);
+    uint32_t baselineTick = reader.Read(32);
+    uint32_t index = reader.Read(8);
+    uint32_t count = reader.Read(8);
+    if (reader.IsOverflowed() || count == 0 || index >= count || tick <= m_newestTick || tick < m_assemblyTick) {
+        return;  // Malformed, or older than what we have / are putting together
+    }
+
+    if (tick != m_assemblyTick) {
+        // A newer tick started arriving, whatever was left of the old one is lost
+        m_assemblyTick = tick;
+        m_assemblyBaseline = baselineTick;
+        m_fragments.resize(count);
+        for (std::vector<uint8_t>& fragment : m_fragments) {
+            fragment.clear();
+        }
+        m_fragmentsMissing = count;
+    }
+    if (m_fragments.size() != count || baselineTick != m_assemblyBaseline || !m_fragments[index].empty()) {
+        return;  // Doesn't match the rest, or a duplicate
+    }
+
+    m_fragments[index].assign(payload, payload + payloadSize);
+    if (--m_fragmentsMissing == 0) {
+        DecodeAssembled();
+    }
+}
+
+void ReplicationClient::DecodeAssembled() {
+    BS_PROFILE_SCOPE("ReplicationClient::DecodeAssembled");
+    m_assembled.clear();
+    for (const std::vector<uint8_t>& fragment : m_fragments) {
+        m_assembled.insert(m_assembled.end(), fragment.begin(), fragment.end());
+    }
+
+    const Snapshot* baseline = &EMPTY_SNAPSHOT;
+    if (m_assemblyBaseline != 0) {
+        const Snapshot& candidate = m_received[m_assemblyBaseline % HISTORY_SIZE];
+        if (m_assemblyTick - m_assemblyBaseline >= HISTORY_SIZE || candidate.tick != m_assemblyBaseline) {
+            BS_DEBUG_F(LogCategory::NETWORK, "Snapshot %u: baseline %u is gone, dropped", m_assemblyTick,
+                       m_assemblyBaseline);
+            return;
+        }
+        baseline = &candidate;
+    }
+
+    BitReader reader(m_assembled.data(), m_assembled.size());
+    if (!m_codec.ReadDelta(*baseline, reader, m_decoded)) {
+        BS_WARN_F(LogCategory::NETWORK, "Snapshot %u didn't decode, dropped", m_assemblyTick);
+        return;
+    }
+    m_decoded.tick = m_assemblyTick;
+    std::swap(m_received[m_assemblyTick % HISTORY_SIZE], m_decoded);
+    m_newestTick = m_assemblyTick;
+    SendControl(MSG_ACK, m_newestTick);
+
+    if (!m_connected) {
+        m_connected = true;
+        BS_INFO_F(LogCategory::NETWORK, "Connected to %s", m_server.ToString().c_str());
+    }
+}
+
+void ReplicationClient::Apply(EntitySystem& entities, const Snapshot& snapshot) {
+    BS_PROFILE_SCOPE("ReplicationClient::Apply");
+    const std::vector<ReplicatedEntity>& before = m_applied.entities;
+    const std::vector<ReplicatedEntity>& after = snapshot.entities;
+    if (!after.empty() && m_localIds.size() <= after.back().slot) {
+        m_localIds.resize(after.back().slot + 1, -1);
+    }
+
+    auto removeLocal = [&](uint32_t slot) {
+        if (m_localIds[slot] != -1) {
+            entities.RemoveEntity(m_localIds[slot]);
+            m_localIds[slot] = -1;
+        }
+    };
+
+    // Same merge walk as the codec - both are in slot order
+    m_spawns.clear();
+    size_t b = 0;
+    size_t a = 0;
+    while (b < before.size() || a < after.size()) {
+        if (a == after.size() || (b < before.size() && before[b].slot < after[a].slot)) {
+            removeLocal(before[b++].slot);
+            continue;
+        }
+        if (b == before.size() || after[a].slot < before[b].slot) {
+            m_spawns.push_back(&after[a++]);
+            continue;
+        }
+
+        const ReplicatedEntity& old = before[b++];
+        const ReplicatedEntity& now = after[a++];
+        if (old.generation != now.generation) {
+            removeLocal(old.slot);
+            m_spawns.push_back(&now);
+            continue;
+        }
+        if (std::memcmp(old.position, now.position, sizeof(now.position)) == 0 && old.rotation == now.rotation &&
+            std::memcmp(old.scale, now.scale, sizeof(now.scale)) == 0 && old.SameAppearance(now)) {
+            continue;
+        }
+
+        // Removed locally behind our back - leave it gone
+        Entity* entity = entities.GetEntityPtr(m_localIds[now.slot]);
+        if (!entity) {
+            continue;
+        }
+        WriteTransform(m_codec, now, entity->GetTransform());
+        if (!old.SameAppearance(now)) {
+            entity->GetRender().shape = ClientShape(now.shape);
+            entity->GetRender().color = UnpackColor(now.color);
+        }
+    }
+
+    if (!m_spawns.empty()) {
+        m_spawnedIds.clear();
+        entities.SpawnBatch(
+            m_spawns.size(),
+            [&](size_t i, Entity& entity) {
+                const ReplicatedEntity& source = *m_spawns[i];
+                entity.GetRender().shape = ClientShape(source.shape);
+                entity.GetRender().color = UnpackColor(source.color);
+                WriteTransform(m_codec, source, entity.GetTransform());
+            },
+            &m_spawnedIds);
+        for (size_t i = 0; i < m_spawnedIds.size(); ++i) {
+            m_localIds[m_spawns[i]->slot] = m_spawnedIds[i];
+        }
+    }
+
+    m_applied.tick = snapshot.tick;
+    m_applied.entities.assign(after.begin(), after.end());
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,357 @@
+#include "blacksite/net/Snapshot.h"
+#include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/net/BitStream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Blacksite {
+
+namespace {
+
+enum EntryKind : uint32_t { ENTRY_UPDATE = 0, ENTRY_CREATE = 1, ENTRY_REMOVE = 2 };
+
+constexpr int SHAPE_BITS = 2;
+constexpr int COLOR_BITS = 24;
+constexpr int GENERATION_BITS = 11;  // EntitySystem::ID_GENERATION_MASK
+static_assert(EntitySystem::ID_GENERATION_MASK == (1u << GENERATION_BITS) - 1, "Generation bits changed");
+
+constexpr float SQRT2 = 1.41421356f;
+
+uint32_t PackColor(const glm::vec3& color) {
+    auto channel = [](float value) {
+        return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+    return channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16);
+}
+
+}  // namespace
+
+int ReplicatedEntity::GetId() const {
+    return static_cast<int>((generation << EntitySystem::ID_INDEX_BITS) | slot);
+}
+
+void SnapshotCodec::Capture(const EntitySystem& entities, uint32_t tick, Snapshot& out) const {
+    BS_PROFILE_SCOPE("SnapshotCodec::Capture");
+    const ComponentStore& components = entities.GetComponents();
+    const std::vector<Entity*>& slots = entities.GetEntities();
+
+    out.tick = tick;
+    out.entities.clear();
+    out.entities.reserve(entities.GetAliveCount());
+
+    // Walking slots instead of the alive list gives slot order for free
+    for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+        if (!slots[slot] || !components.IsActive(slot)) {
+            continue;
+        }
+
+        const Transform& transform = components.GetTransform(slot);
+        const RenderComponent& render = components.GetRender(slot);
+        ReplicatedEntity entity;
+        entity.slot = slot;
+        entity.generation = EntitySystem::GetIdGeneration(entities.GetSlotId(slot));
+        entity.shape = static_cast<uint8_t>(render.shape);
+        entity.color = PackColor(render.color);
+        for (int axis = 0; axis < 3; ++axis) {
+            entity.position[axis] = QuantizePosition(transform.position[axis]);
+            entity.scale[axis] = QuantizeScale(transform.scale[axis]);
+        }
+        entity.rotation = QuantizeRotation(transform.rotation);
+        out.entities.push_back(entity);
+    }
+}
+
+void SnapshotCodec::FilterByDistance(const Snapshot& source, const glm::vec3& center, float radius,
+                                     Snapshot& out) const {
+    out.tick = source.tick;
+    if (radius <= 0.0f) {
+        out.entities = source.entities;
+        return;
+    }
+
+    out.entities.clear();
+    float radiusSquared = radius * radius;
+    for (const ReplicatedEntity& entity : source.entities) {
+        glm::vec3 position(DequantizePosition(entity.position[0]), DequantizePosition(entity.position[1]),
+                           DequantizePosition(entity.position[2]));
+        glm::vec3 offset = position - center;
+        if (glm::dot(offset, offset) <= radiusSquared) {
+            out.entities.push_back(entity);
+        }
+    }
+}
+
+void SnapshotCodec::WriteDelta(const Snapshot& baseline, const Snapshot& current, BitWriter& writer) const {
+    BS_PROFILE_SCOPE("SnapshotCodec::WriteDelta");
+    const std::vector<ReplicatedEntity>& before = baseline.entities;
+    const std::vector<ReplicatedEntity>& after = current.entities;
+
+    // Entry = more bit, slot as a skip from the last entry's, 2-bit kind, payload. Unchanged entities aren't
+    // mentioned at all, the reader copies them from the baseline.
+    uint32_t nextSlot = 0;
+    auto beginEntry = [&](uint32_t slot, EntryKind kind) {
+        writer.WriteBool(true);
+        writer.WriteVarUint(slot - nextSlot);
+        writer.Write(kind, 2);
+        nextSlot = slot + 1;
+    };
+
+    size_t b = 0;
+    size_t a = 0;
+    while (b < before.size() || a < after.size()) {
+        if (a == after.size() || (b < before.size() && before[b].slot < after[a].slot)) {
+            beginEntry(before[b].slot, ENTRY_REMOVE);
+            ++b;
+        } else if (b == before.size() || after[a].slot < before[b].slot) {
+            beginEntry(after[a].slot, ENTRY_CREATE);
+            writer.Write(after[a].generation, GENERATION_BITS);
+            WriteFull(after[a], writer);
+            ++a;
+        } else {
+            const ReplicatedEntity& old = before[b];
+            const ReplicatedEntity& now = after[a];
+            if (old.generation != now.generation) {
+                // Slot got reused, the reader replaces the old entity
+                beginEntry(now.slot, ENTRY_CREATE);
+                writer.Write(now.generation, GENERATION_BITS);
+                WriteFull(now, writer);
+            } else if (std::memcmp(old.position, now.position, sizeof(old.position)) != 0 ||
+                       old.rotation != now.rotation || std::memcmp(old.scale, now.scale, sizeof(old.scale)) != 0 ||
+                       !old.SameAppearance(now)) {
+                beginEntry(now.slot, ENTRY_UPDATE);
+                WriteChanges(old, now, writer);
+            }
+            ++a;
+            ++b;
+        }
+    }
+    writer.WriteBool(false);
+}
+
+bool SnapshotCodec::ReadDelta(const Snapshot& baseline, BitReader& reader, Snapshot& out) const {
+    BS_PROFILE_SCOPE("SnapshotCodec::ReadDelta");
+    const std::vector<ReplicatedEntity>& before = baseline.entities;
+    out.entities.clear();
+    out.entities.reserve(before.size());
+
+    size_t b = 0;
+    uint32_t nextSlot = 0;
+    while (reader.ReadBool()) {
+        uint32_t slot = nextSlot + reader.ReadVarUint();
+        uint32_t kind = reader.Read(2);
+        if (reader.IsOverflowed() || slot > EntitySystem::ID_INDEX_MASK || slot < nextSlot) {
+            return false;
+        }
+        nextSlot = slot + 1;
+
+        while (b < before.size() && before[b].slot < slot) {
+            out.entities.push_back(before[b++]);
+        }
+        bool inBaseline = b < before.size() && before[b].slot == slot;
+
+        switch (kind) {
+            case ENTRY_REMOVE:
+                if (!inBaseline) {
+                    return false;
+                }
+                ++b;
+                break;
+            case ENTRY_CREATE: {
+                ReplicatedEntity entity;
+                entity.slot = slot;
+                entity.generation = reader.Read(GENERATION_BITS);
+                ReadFull(reader, entity);
+                out.entities.push_back(entity);
+                if (inBaseline) {
+                    ++b;
+                }
+                break;
+            }
+            case ENTRY_UPDATE: {
+                if (!inBaseline) {
+                    return false;
+                }
+                ReplicatedEntity entity = before[b++];
+                ReadChanges(reader, entity);
+                out.entities.push_back(entity);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    out.entities.insert(out.entities.end(), before.begin() + static_cast<std::ptrdiff_t>(b), before.end());
+    return !reader.IsOverflowed();
+}
+
+void SnapshotCodec::WriteFull(const ReplicatedEntity& entity, BitWriter& writer) const {
+    writer.Write(entity.shape, SHAPE_BITS);
+    writer.Write(entity.color, COLOR_BITS);
+    for (int axis = 0; axis < 3; ++axis) {
+        writer.WriteSigned(entity.position[axis], m_config.positionBits);
+    }
+    writer.Write(entity.rotation, 2 + 3 * m_config.rotationBits);
+    for (int axis = 0; axis < 3; ++axis) {
+        writer.Write(entity.scale[axis], m_config.scaleBits);
+    }
+}
+
+void SnapshotCodec::ReadFull(BitReader& reader, ReplicatedEntity& entity) const {
+    entity.shape = static_cast<uint8_t>(reader.Read(SHAPE_BITS));
+    entity.color = reader.Read(COLOR_BITS);
+    for (int axis = 0; axis < 3; ++axis) {
+        entity.position[axis] = reader.ReadSigned(m_config.positionBits);
+    }
+    entity.rotation = reader.Read(2 + 3 * m_config.rotationBits);
+    for (int axis = 0; axis < 3; ++axis) {
+        entity.scale[axis] = reader.Read(m_config.scaleBits);
+    }
+}
+
+void SnapshotCodec::WriteChanges(const ReplicatedEntity& baseline, const ReplicatedEntity& current,
+                                 BitWriter& writer) const {
+    // Position per axis: unchanged (1 bit), a small step from the baseline, or the full value
+    bool moved = std::memcmp(baseline.position, current.position, sizeof(current.position)) != 0;
+    writer.WriteBool(moved);
+    if (moved) {
+        const int64_t deltaLimit = int64_t(1) << (m_config.positionDeltaBits - 1);
+        for (int axis = 0; axis < 3; ++axis) {
+            int64_t delta = int64_t(current.position[axis]) - int64_t(baseline.position[axis]);
+            writer.WriteBool(delta != 0);
+            if (delta == 0) {
+                continue;
+            }
+            bool small = delta >= -deltaLimit && delta < deltaLimit;
+            writer.WriteBool(small);
+            if (small) {
+                writer.WriteSigned(static_cast<int32_t>(delta), m_config.positionDeltaBits);
+            } else {
+                writer.WriteSigned(current.position[axis], m_config.positionBits);
+            }
+        }
+    }
+
+    bool rotated = baseline.rotation != current.rotation;
+    writer.WriteBool(rotated);
+    if (rotated) {
+        writer.Write(current.rotation, 2 + 3 * m_config.rotationBits);
+    }
+
+    bool scaled = std::memcmp(baseline.scale, current.scale, sizeof(current.scale)) != 0;
+    writer.WriteBool(scaled);
+    if (scaled) {
+        for (int axis = 0; axis < 3; ++axis) {
+            writer.Write(current.scale[axis], m_config.scaleBits);
+        }
+    }
+
+    bool restyled = !baseline.SameAppearance(current);
+    writer.WriteBool(restyled);
+    if (restyled) {
+        writer.Write(current.shape, SHAPE_BITS);
+        writer.Write(current.color, COLOR_BITS);
+    }
+}
+
+void SnapshotCodec::ReadChanges(BitReader& reader, ReplicatedEntity& entity) const {
+    if (reader.ReadBool()) {
+        for (int axis = 0; axis < 3; ++axis) {
+            if (!reader.ReadBool()) {
+                continue;
+            }
+            if (reader.ReadBool()) {
+                entity.position[axis] += reader.ReadSigned(m_config.positionDeltaBits);
+            } else {
+                entity.position[axis] = reader.ReadSigned(m_config.positionBits);
+            }
+        }
+    }
+    if (reader.ReadBool()) {
+        entity.rotation = reader.Read(2 + 3 * m_config.rotationBits);
+    }
+    if (reader.ReadBool()) {
+        for (int axis = 0; axis < 3; ++axis) {
+            entity.scale[axis] = reader.Read(m_config.scaleBits);
+        }
+    }
+    if (reader.ReadBool()) {
+        entity.shape = static_cast<uint8_t>(reader.Read(SHAPE_BITS));
+        entity.color = reader.Read(COLOR_BITS);
+    }
+}
+
+int32_t SnapshotCodec::QuantizePosition(float value) const {
+    // Clamped to what positionBits can hold, far-away entities pile up at the edge instead of wrapping
+    const float limit = static_cast<float>((int64_t(1) << (m_config.positionBits - 1)) - 1);
+    float steps = std::round(value / m_config.positionPrecision);
+    return static_cast<int32_t>(std::clamp(steps, -limit, limit));
+}
+
+float SnapshotCodec::DequantizePosition(int32_t value) const {
+    return static_cast<float>(value) * m_config.positionPrecision;
+}
+
+uint32_t SnapshotCodec::QuantizeRotation(const glm::quat& rotation) const {
+    // Smallest three: drop the largest component (it follows from the others), send which one it was.
+    // q and -q are the same rotation, so flip it to make the dropped one positive.
+    glm::quat q = glm::normalize(rotation);
+    float components[4] = {q.x, q.y, q.z, q.w};
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i) {
+        if (std::abs(components[i]) > std::abs(components[largest])) {
+            largest = i;
+        }
+    }
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    // The other three are within +-1/sqrt(2)
+    const float maxValue = static_cast<float>((1u << m_config.rotationBits) - 1);
+    uint32_t packed = largest;
+    int shift = 2;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        float normalized = components[i] * sign * SQRT2 * 0.5f + 0.5f;
+        uint32_t value = static_cast<uint32_t>(std::clamp(normalized, 0.0f, 1.0f) * maxValue + 0.5f);
+        packed |= value << shift;
+        shift += m_config.rotationBits;
+    }
+    return packed;
+}
+
+glm::quat SnapshotCodec::DequantizeRotation(uint32_t packed) const {
+    const uint32_t mask = (1u << m_config.rotationBits) - 1;
+    const float maxValue = static_cast<float>(mask);
+    uint32_t largest = packed & 3;
+
+    float components[4];
+    float sumSquares = 0.0f;
+    int shift = 2;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        float normalized = static_cast<float>((packed >> shift) & mask) / maxValue;
+        components[i] = (normalized - 0.5f) * 2.0f / SQRT2;
+        sumSquares += components[i] * components[i];
+        shift += m_config.rotationBits;
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSquares));
+    return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+}
+
+uint32_t SnapshotCodec::QuantizeScale(float value) const {
+    const float limit = static_cast<float>((1u << m_config.scaleBits) - 1);
+    return static_cast<uint32_t>(std::clamp(std::round(value / m_config.scalePrecision), 0.0f, limit));
+}
+
+float SnapshotCodec::DequantizeScale(uint32_t value) const {
+    return static_cast<float>(value) * m_config.scalePrecision;
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,185 @@
+#include "blacksite/net/UdpSocket.h"
+#include "blacksite/core/Logger.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Blacksite {
+
+namespace {
+
+#ifdef _WIN32
+bool StartWinsock() {
+    // Once per process, never cleaned up - the OS does that at exit
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+using SocketHandle = SOCKET;
+// Errors that are about one datagram, not the socket: ICMP port unreachable from an earlier send, oversized
+bool IsSkippableError() {
+    int error = WSAGetLastError();
+    return error == WSAECONNRESET || error == WSAEMSGSIZE;
+}
+void CloseSocket(SocketHandle handle) {
+    closesocket(handle);
+}
+#else
+bool StartWinsock() {
+    return true;
+}
+
+using SocketHandle = int;
+bool IsSkippableError() {
+    return errno == ECONNREFUSED;  // ICMP port unreachable from an earlier send
+}
+void CloseSocket(SocketHandle handle) {
+    close(handle);
+}
+#endif
+
+sockaddr_in ToSockAddr(const NetAddress& address) {
+    sockaddr_in result;
+    std::memset(&result, 0, sizeof(result));
+    result.sin_family = AF_INET;
+    result.sin_addr.s_addr = htonl(address.ip);
+    result.sin_port = htons(address.port);
+    return result;
+}
+
+}  // namespace
+
+std::string NetAddress::ToString() const {
+    return std::to_string((ip >> 24) & 0xFF) + "." + std::to_string((ip >> 16) & 0xFF) + "." +
+           std::to_string((ip >> 8) & 0xFF) + "." + std::to_string(ip & 0xFF) + ":" + std::to_string(port);
+}
+
+bool NetAddress::Resolve(const std::string& host, uint16_t port, NetAddress& out) {
+    out = NetAddress{};
+    if (!StartWinsock()) {
+        return false;
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* results = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &results) != 0 || !results) {
+        BS_WARN_F(LogCategory::NETWORK, "Couldn't resolve '%s'", host.c_str());
+        return false;
+    }
+
+    const auto* address = reinterpret_cast<const sockaddr_in*>(results->ai_addr);
+    out.ip = ntohl(address->sin_addr.s_addr);
+    out.port = port;
+    freeaddrinfo(results);
+    return true;
+}
+
+bool UdpSocket::Open(uint16_t port) {
+    Close();
+    if (!StartWinsock()) {
+        BS_ERROR(LogCategory::NETWORK, "Winsock failed to start");
+        return false;
+    }
+
+    SocketHandle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if (handle == INVALID_SOCKET) {
+#else
+    if (handle < 0) {
+#endif
+        BS_ERROR(LogCategory::NETWORK, "Failed to create a UDP socket");
+        return false;
+    }
+
+    sockaddr_in address = ToSockAddr(NetAddress{INADDR_ANY, port});
+    if (bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        BS_ERROR_F(LogCategory::NETWORK, "Failed to bind UDP port %u", static_cast<unsigned>(port));
+        CloseSocket(handle);
+        return false;
+    }
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool ok = ioctlsocket(handle, FIONBIO, &nonBlocking) == 0;
+#else
+    bool ok = fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!ok) {
+        BS_ERROR(LogCategory::NETWORK, "Failed to make the UDP socket non-blocking");
+        CloseSocket(handle);
+        return false;
+    }
+
+    // Port 0 picked one for us, find out which
+    socklen_t length = sizeof(address);
+    getsockname(handle, reinterpret_cast<sockaddr*>(&address), &length);
+    m_port = ntohs(address.sin_port);
+    m_handle = static_cast<intptr_t>(handle);
+    BS_DEBUG_F(LogCategory::NETWORK, "UDP socket open on port %u", static_cast<unsigned>(m_port));
+    return true;
+}
+
+void UdpSocket::Close() {
+    if (IsOpen()) {
+        CloseSocket(static_cast<SocketHandle>(m_handle));
+        m_handle = INVALID_HANDLE;
+        m_port = 0;
+    }
+}
+
+bool UdpSocket::Send(const NetAddress& to, const void* data, size_t size) {
+    if (!IsOpen()) {
+        return false;
+    }
+
+    sockaddr_in address = ToSockAddr(to);
+    auto sent = sendto(static_cast<SocketHandle>(m_handle), static_cast<const char*>(data), static_cast<int>(size),
+                       0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    return sent == static_cast<decltype(sent)>(size);
+}
+
+size_t UdpSocket::Receive(NetAddress& from, void* data, size_t capacity) {
+    if (!IsOpen()) {
+        return 0;
+    }
+
+    // Loops only past datagrams we can't use, returns on the first good one, an empty queue or a real error
+    for (;;) {
+        sockaddr_in address;
+        socklen_t length = sizeof(address);
+        auto received = recvfrom(static_cast<SocketHandle>(m_handle), static_cast<char*>(data),
+                                 static_cast<int>(capacity), 0, reinterpret_cast<sockaddr*>(&address), &length);
+        if (received > 0) {
+            from.ip = ntohl(address.sin_addr.s_addr);
+            from.port = ntohs(address.sin_port);
+            return static_cast<size_t>(received);
+        }
+        if (received < 0 && !IsSkippableError()) {
+            return 0;  // Would block = nothing queued
+        }
+    }
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,56 @@
+#include "blacksite/physics/JoltJobSystem.h"
+#include "blacksite/core/JobSystem.h"
+
+#include <thread>
+
+namespace Blacksite {
+
+JoltJobSystem::JoltJobSystem(JobSystem& jobs, JPH::uint maxJobs, JPH::uint maxBarriers)
+    : JPH::JobSystemWithBarrier(maxBarriers), m_jobs(jobs) {
+    m_jobPool.Init(maxJobs, maxJobs);
+}
+
+int JoltJobSystem::GetMaxConcurrency() const {
+    return static_cast<int>(m_jobs.GetConcurrency());
+}
+
+JPH::JobSystem::JobHandle JoltJobSystem::CreateJob(const char* inName, JPH::ColorArg inColor,
+                                                   const JobFunction& inJobFunction, JPH::uint32 inNumDependencies) {
+    // Jolt frees it through FreeJob once the last handle lets go. The pool only runs dry if a step has
+    // more than maxJobs in flight, then wait for some to finish like Jolt's own thread pool does.
+    JPH::uint32 index;
+    while ((index = m_jobPool.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies)) ==
+           JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex) {
+        std::this_thread::yield();
+    }
+    Job* job = &m_jobPool.Get(index);
+    JobHandle handle(job);
+
+    // With dependencies Jolt queues it itself once they're met
+    if (inNumDependencies == 0) {
+        QueueJob(job);
+    }
+    return handle;
+}
+
+void JoltJobSystem::QueueJob(Job* inJob) {
+    // The queue holds a reference until the job has run. Execute is a no-op if a barrier wait
+    // got to it first on another thread.
+    inJob->AddRef();
+    m_jobs.Run([inJob]() {
+        inJob->Execute();
+        inJob->Release();
+    });
+}
+
+void JoltJobSystem::QueueJobs(Job** inJobs, JPH::uint inNumJobs) {
+    for (JPH::uint i = 0; i < inNumJobs; ++i) {
+        QueueJob(inJobs[i]);
+    }
+}
+
+void JoltJobSystem::FreeJob(Job* inJob) {
+    m_jobPool.DestructObject(inJob);
+}
+
+}  // namespace Blacksite
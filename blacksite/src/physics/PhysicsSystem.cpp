@@ -1,11 +1,27 @@
 #include "blacksite/physics/PhysicsSystem.h"
+#include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/JobSystem.h"
+#include "blacksite/physics/JoltJobSystem.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdarg>
 #include <cstdio>
+#include <limits>
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtx/euler_angles.hpp>
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/MemoryTracker.h"
+#include "blacksite/core/Profiler.h"
 #include "Core/IssueReporting.h"
+#include "Core/JobSystemThreadPool.h"
 #include "Core/Memory.h"
+#include "Physics/Collision/CastResult.h"
+#include "Physics/Collision/CollideShape.h"
+#include "Physics/Collision/CollisionCollectorImpl.h"
+#include "Physics/Collision/NarrowPhaseQuery.h"
+#include "Physics/Collision/RayCast.h"
+#include "Physics/Collision/ShapeCast.h"
+#include "Physics/Collision/Shape/CapsuleShape.h"
+#include "Physics/Collision/Shape/ScaledShape.h"
 #include "Physics/Collision/Shape/StaticCompoundShape.h"
 
 namespace Blacksite {
@@ -28,6 +44,23 @@ static bool AssertFailedImpl(const char* inExpression, const char* inMessage, co
 }
 #endif
 
+// Jolt's allocation hooks, so everything it allocates shows up under MemoryTag::Physics
+static void* JoltAllocate(size_t inSize) {
+    return MemoryTracker::Allocate(inSize, MemoryTag::Physics);
+}
+
+static void* JoltReallocate(void* inBlock, size_t /*inOldSize*/, size_t inNewSize) {
+    return MemoryTracker::Reallocate(inBlock, inNewSize, MemoryTag::Physics);
+}
+
+static void* JoltAlignedAllocate(size_t inSize, size_t inAlignment) {
+    return MemoryTracker::Allocate(inSize, MemoryTag::Physics, inAlignment);
+}
+
+static void JoltFree(void* inBlock) {
+    MemoryTracker::Free(inBlock);
+}
+
 // Utility conversion functions
 JPH::Vec3 ToJoltPos(const glm::vec3& v) {
     return JPH::Vec3(v.x, v.y, v.z);
@@ -37,82 +70,130 @@ glm::vec3 ToGLMPos(const JPH::Vec3& v) {
     return glm::vec3(v.GetX(), v.GetY(), v.GetZ());
 }
 
+JPH::Quat ToJoltRot(const glm::quat& q) {
+    return JPH::Quat(q.x, q.y, q.z, q.w);
+}
+
 JPH::Quat ToJoltRot(const glm::vec3& eulerAngles) {
-    glm::mat4 rotationMatrix =
-        glm::eulerAngleXYZ(glm::radians(eulerAngles.x), glm::radians(eulerAngles.y), glm::radians(eulerAngles.z));
+    return ToJoltRot(EulerToQuat(eulerAngles));
+}
 
-    glm::quat glmQuat = glm::quat_cast(rotationMatrix);
-    return JPH::Quat(glmQuat.x, glmQuat.y, glmQuat.z, glmQuat.w);
+JPH::Quat ToJoltRot(const Transform& transform) {
+    return ToJoltRot(transform.rotation);
+}
+
+glm::quat ToGLMQuat(const JPH::Quat& q) {
+    return glm::quat(q.GetW(), q.GetX(), q.GetY(), q.GetZ());
 }
 
 glm::vec3 ToGLMRot(const JPH::Quat& q) {
-    glm::quat glmQuat(q.GetW(), q.GetX(), q.GetY(), q.GetZ());
-    glm::vec3 eulerAngles = glm::eulerAngles(glmQuat);
-    return glm::degrees(eulerAngles);
+    return QuatToEuler(ToGLMQuat(q));
+}
+
+// Bodies still waiting for FlushBodyChanges (or held) aren't in the broadphase, and Jolt won't activate those.
+// Edits to them go straight onto the body and the batch add activates it later, so touching a body right
+// after spawning it doesn't flush the whole queue. False for bodies already in the world.
+template <typename Edit>
+static bool EditQueuedBody(JPH::PhysicsSystem& physics, const JPH::BodyID& bodyID, Edit&& edit) {
+    JPH::BodyLockWrite lock(physics.GetBodyLockInterface(), bodyID);
+    if (!lock.Succeeded() || lock.GetBody().IsInBroadPhase())
+        return false;
+    edit(lock.GetBody());
+    return true;
 }
 
-// Layer interfaces for Jolt Physics - FIXED VERSION
+// Layer interfaces for Jolt Physics - all three read the layer config, so rules set through
+// PhysicsConfig::layers (or SetLayerCollision) are what the broadphase and narrowphase see
 class PhysicsSystem::BPLayerInterfaceImpl : public JPH::BroadPhaseLayerInterface {
   public:
-    BPLayerInterfaceImpl() {
-        // Create a mapping table from object to broad phase layer
-        mObjectToBroadPhase[NON_MOVING] = JPH::BroadPhaseLayer(NON_MOVING);
-        mObjectToBroadPhase[MOVING] = JPH::BroadPhaseLayer(MOVING);
-    }
+    explicit BPLayerInterfaceImpl(const PhysicsLayerConfig& layers) : mLayers(layers) {}
 
-    virtual JPH::uint GetNumBroadPhaseLayers() const override { return NUM_LAYERS; }
+    virtual JPH::uint GetNumBroadPhaseLayers() const override { return mLayers.GetBroadPhaseLayerCount(); }
 
     virtual JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override {
-        JPH_ASSERT(inLayer < NUM_LAYERS);
-        return mObjectToBroadPhase[inLayer];
+        JPH_ASSERT(inLayer < mLayers.GetLayerCount());
+        return JPH::BroadPhaseLayer(mLayers.GetBroadPhaseLayer(inLayer));
     }
 
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
     virtual const char* GetBroadPhaseLayerName(JPH::BroadPhaseLayer inLayer) const override {
-        switch ((JPH::BroadPhaseLayer::Type)inLayer) {
-            case (JPH::BroadPhaseLayer::Type)NON_MOVING:
-                return "NON_MOVING";
-            case (JPH::BroadPhaseLayer::Type)MOVING:
-                return "MOVING";
-            default:
-                JPH_ASSERT(false);
-                return "INVALID";
+        auto index = static_cast<JPH::BroadPhaseLayer::Type>(inLayer);
+        if (index >= mLayers.GetBroadPhaseLayerCount()) {
+            JPH_ASSERT(false);
+            return "INVALID";
         }
+        return mLayers.GetBroadPhaseLayerName(index).c_str();
     }
 #endif
 
   private:
-    JPH::BroadPhaseLayer mObjectToBroadPhase[NUM_LAYERS];
+    const PhysicsLayerConfig& mLayers;
 };
 
 class PhysicsSystem::ObjectVsBroadPhaseLayerFilterImpl : public JPH::ObjectVsBroadPhaseLayerFilter {
   public:
-    virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override {
-        switch (inLayer1) {
-            case NON_MOVING:
-                return inLayer2 == JPH::BroadPhaseLayer(MOVING);
-            case MOVING:
-                return true;
-            default:
-                JPH_ASSERT(false);
-                return false;
+    explicit ObjectVsBroadPhaseLayerFilterImpl(const PhysicsLayerConfig& layers) { Rebuild(layers); }
+
+    // Flattens the object layer matrix into one broadphase mask per object layer, the broadphase
+    // asks this for every tree it walks so it shouldn't loop over layers each time
+    void Rebuild(const PhysicsLayerConfig& layers) {
+        for (uint32_t layer = 0; layer < PhysicsLayerConfig::MAX_LAYERS; ++layer) {
+            mBroadPhaseMasks[layer] = 0;
+            if (layer >= layers.GetLayerCount())
+                continue;
+            for (uint32_t bp = 0; bp < layers.GetBroadPhaseLayerCount(); ++bp) {
+                if (layers.ShouldCollideWithBroadPhase(static_cast<PhysicsLayer>(layer), static_cast<uint8_t>(bp)))
+                    mBroadPhaseMasks[layer] |= 1u << bp;
+            }
         }
     }
+
+    virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override {
+        JPH_ASSERT(inLayer1 < PhysicsLayerConfig::MAX_LAYERS);
+        auto bp = static_cast<JPH::BroadPhaseLayer::Type>(inLayer2);
+        return (mBroadPhaseMasks[inLayer1] & (1u << bp)) != 0;
+    }
+
+  private:
+    uint32_t mBroadPhaseMasks[PhysicsLayerConfig::MAX_LAYERS];
 };
 
 class PhysicsSystem::ObjectLayerPairFilterImpl : public JPH::ObjectLayerPairFilter {
   public:
+    explicit ObjectLayerPairFilterImpl(const PhysicsLayerConfig& layers) : mLayers(layers) {}
+
     virtual bool ShouldCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2) const override {
-        switch (inObject1) {
-            case NON_MOVING:
-                return inObject2 == MOVING;
-            case MOVING:
-                return true;
-            default:
-                JPH_ASSERT(false);
-                return false;
-        }
+        return mLayers.ShouldCollide(inObject1, inObject2);
     }
+
+  private:
+    const PhysicsLayerConfig& mLayers;
+};
+
+// Runs on Jolt's job threads in the middle of the step - no locks, no allocation, just record and go
+class PhysicsSystem::ContactListenerImpl : public JPH::ContactListener {
+  public:
+    explicit ContactListenerImpl(PhysicsSystem& owner) : m_owner(owner) {}
+
+    virtual void OnContactAdded(const JPH::Body& inBody1, const JPH::Body& inBody2,
+                                const JPH::ContactManifold& inManifold, JPH::ContactSettings& /*ioSettings*/) override {
+        // User data is entity id + 1, 0 = a body that isn't an entity
+        JPH::uint64 user1 = inBody1.GetUserData();
+        JPH::uint64 user2 = inBody2.GetUserData();
+        if (user1 == 0 || user2 == 0)
+            return;
+
+        CollisionEvent event;
+        event.entityA = static_cast<int>(user1 - 1);
+        event.entityB = static_cast<int>(user2 - 1);
+        event.point = ToGLMPos(inManifold.GetWorldSpaceContactPointOn1(0));
+        event.normal = ToGLMPos(inManifold.mWorldSpaceNormal);
+        event.penetrationDepth = inManifold.mPenetrationDepth;
+        m_owner.RecordCollisionEvent(event);
+    }
+
+  private:
+    PhysicsSystem& m_owner;
 };
 
 PhysicsSystem::PhysicsSystem() = default;
@@ -121,14 +202,37 @@ PhysicsSystem::~PhysicsSystem() {
     Shutdown();
 }
 
-bool PhysicsSystem::Initialize() {
+bool PhysicsSystem::Initialize(const PhysicsConfig& config, JobSystem* jobSystem) {
     if (m_initialized) {
         BS_ERROR(LogCategory::PHYSICS, "PhysicsSystem already initialized");
         return false;
     }
 
-    // Register allocation hook
-    JPH::RegisterDefaultAllocator();
+    if (config.maxBodies == 0 || config.maxBodyPairs == 0 || config.maxContactConstraints == 0 ||
+        config.tempAllocatorSize == 0) {
+        BS_ERROR(LogCategory::PHYSICS, "Invalid PhysicsConfig - body, pair, constraint and temp sizes must be > 0");
+        return false;
+    }
+    if (config.layers.GetLayerCount() < 2 || config.layers.GetBroadPhaseLayerCount() == 0) {
+        BS_ERROR(LogCategory::PHYSICS, "Invalid PhysicsConfig - layers must keep the built-in Static and Moving");
+        return false;
+    }
+    m_config = config;
+
+    // Jolt sizes its temp allocator with a 32-bit uint, a bigger size would wrap around to something tiny
+    constexpr size_t maxTempAllocatorSize = std::numeric_limits<JPH::uint>::max() & ~size_t(15);
+    if (m_config.tempAllocatorSize > maxTempAllocatorSize) {
+        BS_WARN_F(LogCategory::PHYSICS, "PhysicsConfig tempAllocatorSize %zu is over Jolt's limit, clamped to %zu",
+                  m_config.tempAllocatorSize, maxTempAllocatorSize);
+        m_config.tempAllocatorSize = maxTempAllocatorSize;
+    }
+
+    // Allocation hooks - before the factory, nothing Jolt allocated may be freed through a different allocator
+    JPH::Allocate = JoltAllocate;
+    JPH::Reallocate = JoltReallocate;
+    JPH::Free = JoltFree;
+    JPH::AlignedAllocate = JoltAlignedAllocate;
+    JPH::AlignedFree = JoltFree;
 
     // Install trace and assert callbacks - FIXED: Use function pointers instead of lambdas
     JPH::Trace = TraceImpl;
@@ -142,41 +246,104 @@ bool PhysicsSystem::Initialize() {
     JPH::RegisterTypes();
 
     // Create allocators and job system
-    m_tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(10 * 1024 * 1024);
-
-    int cNumThreads = std::thread::hardware_concurrency() - 1;
-    if (cNumThreads < 1)
-        cNumThreads = 1;
-    m_jobSystem =
-        std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, cNumThreads);
+    m_tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(static_cast<JPH::uint>(m_config.tempAllocatorSize));
+
+    if (jobSystem) {
+        // Shared workers, so jobThreads just records how many threads can end up running physics jobs
+        m_config.jobThreads = static_cast<int>(jobSystem->GetWorkerCount());
+        m_jobSystem = std::make_unique<JoltJobSystem>(*jobSystem, JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
+    } else {
+        if (m_config.jobThreads < 0) {
+            m_config.jobThreads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        }
+        if (m_config.jobThreads < 1)
+            m_config.jobThreads = 1;
+        m_jobSystem = std::make_unique<JPH::JobSystemThreadPool>(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers,
+                                                                 m_config.jobThreads);
+    }
 
     // Create physics system
     m_physicsSystem = std::make_unique<JPH::PhysicsSystem>();
 
     // Create layer interfaces
-    m_broadPhaseLayerInterface = std::make_unique<BPLayerInterfaceImpl>();
-    m_objectVsBroadphaseLayerFilter = std::make_unique<ObjectVsBroadPhaseLayerFilterImpl>();
-    m_objectVsObjectLayerFilter = std::make_unique<ObjectLayerPairFilterImpl>();
+    m_broadPhaseLayerInterface = std::make_unique<BPLayerInterfaceImpl>(m_config.layers);
+    m_objectVsBroadphaseLayerFilter = std::make_unique<ObjectVsBroadPhaseLayerFilterImpl>(m_config.layers);
+    m_objectVsObjectLayerFilter = std::make_unique<ObjectLayerPairFilterImpl>(m_config.layers);
+
+    // One event buffer per job thread, plus whoever calls Update (main or step thread)
+    size_t bufferCount = static_cast<size_t>(m_config.jobThreads) + 2;
+    m_collisionBuffers = std::vector<CollisionEventBuffer>(bufferCount);
+    for (CollisionEventBuffer& buffer : m_collisionBuffers) {
+        buffer.events = std::make_unique<CollisionEvent[]>(m_config.maxCollisionEventsPerThread);
+    }
+    m_overflowEvents = std::make_unique<CollisionEvent[]>(m_config.maxCollisionEventsPerThread);
+    m_nextCollisionBuffer = 0;
+    m_overflowCount = 0;
+    m_droppedCollisionEvents = 0;
+
+    // Not the address - a new PhysicsSystem can land where an old one was, and threads would keep its slots
+    static std::atomic<uint32_t> s_nextEventGeneration{1};
+    m_eventGeneration = s_nextEventGeneration.fetch_add(1, std::memory_order_relaxed);
 
     // Initialize physics system
-    const JPH::uint cMaxBodies = 1024;
-    const JPH::uint cNumBodyMutexes = 0;
-    const JPH::uint cMaxBodyPairs = 1024;
-    const JPH::uint cMaxContactConstraints = 1024;
+    // Body indices never go past maxBodies, so the reverse table can be sized once
+    m_bodyEntities.assign(m_config.maxBodies, -1);
 
-    m_physicsSystem->Init(cMaxBodies, cNumBodyMutexes, cMaxBodyPairs, cMaxContactConstraints,
-                          *m_broadPhaseLayerInterface, *m_objectVsBroadphaseLayerFilter, *m_objectVsObjectLayerFilter);
+    m_physicsSystem->Init(m_config.maxBodies, m_config.numBodyMutexes, m_config.maxBodyPairs,
+                          m_config.maxContactConstraints, *m_broadPhaseLayerInterface,
+                          *m_objectVsBroadphaseLayerFilter, *m_objectVsObjectLayerFilter);
+
+    m_contactListener = std::make_unique<ContactListenerImpl>(*this);
+    m_physicsSystem->SetContactListener(m_contactListener.get());
 
     m_initialized = true;
     BS_INFO(LogCategory::PHYSICS, "Physics system initialized successfully with Jolt Physics!");
+    LogCapacityReport();
     return true;
 }
 
+PhysicsCapacityReport PhysicsSystem::GetCapacityReport() const {
+    PhysicsCapacityReport report;
+    report.maxBodyPairs = m_config.maxBodyPairs;
+    report.maxContactConstraints = m_config.maxContactConstraints;
+    report.tempAllocatorSize = m_config.tempAllocatorSize;
+    report.jobThreads = m_config.jobThreads;
+    if (!m_initialized || !m_physicsSystem) {
+        report.maxBodies = m_config.maxBodies;
+        return report;
+    }
+
+    report.numBodies = m_physicsSystem->GetNumBodies();
+    report.numActiveBodies = m_physicsSystem->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+    report.maxBodies = m_physicsSystem->GetMaxBodies();
+    return report;
+}
+
+void PhysicsSystem::LogCapacityReport() const {
+    PhysicsCapacityReport report = GetCapacityReport();
+    BS_INFO_F(LogCategory::PHYSICS,
+              "Physics capacity: %u/%u bodies (%u active), %u pairs, %u contacts, %.1f MB temp, %d threads",
+              report.numBodies, report.maxBodies, report.numActiveBodies, report.maxBodyPairs,
+              report.maxContactConstraints, report.tempAllocatorSize / (1024.0f * 1024.0f), report.jobThreads);
+}
+
 void PhysicsSystem::Shutdown() {
     if (!m_initialized)
         return;
 
+    // Step thread first, it's still using everything below
+    SetThreadedStepping(false);
+
+    m_pendingAdds.clear();
+    m_pendingRemovals.clear();
+    m_entityBodies.clear();
+    m_bodyEntities.clear();
+    m_shapeCache.clear();
+
     m_physicsSystem.reset();
+    m_contactListener.reset();
+    m_collisionBuffers.clear();
+    m_overflowEvents.reset();
     m_objectVsObjectLayerFilter.reset();
     m_objectVsBroadphaseLayerFilter.reset();
     m_broadPhaseLayerInterface.reset();
@@ -193,12 +360,167 @@ void PhysicsSystem::Shutdown() {
     BS_INFO(LogCategory::PHYSICS, "Physics system shut down");
 }
 
-void PhysicsSystem::Update(float deltaTime) {
+int PhysicsSystem::Update(float deltaTime) {
+    BS_PROFILE_SCOPE("PhysicsSystem::Update");
+    m_lastStepCount = 0;
+    if (!m_initialized || !m_physicsSystem)
+        return 0;
+
+    // Plain Update always steps on the calling thread, so let anything in flight finish first
+    WaitForStep();
+    FlushBodyChanges();
+
+    int steps = AdvanceAccumulator(deltaTime);
+    RunSteps(steps, GetStepTime(steps, deltaTime));
+    m_lastStepCount = steps;
+    m_renderAlpha = ComputeAlpha();
+    return steps;
+}
+
+int PhysicsSystem::BeginStep(float deltaTime) {
     if (!m_initialized || !m_physicsSystem)
+        return 0;
+
+    if (!m_threadedStepping)
+        return Update(deltaTime);
+
+    std::unique_lock<std::mutex> lock(m_stepMutex);
+    if (m_stepRequested) {
+        BS_WARN(LogCategory::PHYSICS, "BeginStep called with a step still running, waiting for it first");
+        m_stepDone.wait(lock, [this] { return !m_stepRequested; });
+    }
+
+    FlushBodyChanges();
+    int steps = AdvanceAccumulator(deltaTime);
+    m_lastStepCount = steps;
+    m_pendingAlpha = ComputeAlpha();
+    if (steps > 0) {
+        m_requestedSteps = steps;
+        m_requestedStepTime = GetStepTime(steps, deltaTime);
+        m_stepRequested = true;
+        lock.unlock();
+        m_stepWake.notify_one();
+    }
+    return steps;
+}
+
+void PhysicsSystem::WaitForStep() {
+    if (!m_threadedStepping)
+        return;
+
+    std::unique_lock<std::mutex> lock(m_stepMutex);
+    m_stepDone.wait(lock, [this] { return !m_stepRequested; });
+
+    // The bodies now hold the state that pending alpha was worked out for
+    m_renderAlpha = m_pendingAlpha;
+}
+
+void PhysicsSystem::SetThreadedStepping(bool enabled) {
+    if (enabled == m_threadedStepping)
         return;
 
-    const int cCollisionSteps = 1;
-    m_physicsSystem->Update(deltaTime, cCollisionSteps, m_tempAllocator.get(), m_jobSystem.get());
+    if (enabled) {
+        if (!m_initialized) {
+            BS_ERROR(LogCategory::PHYSICS, "Threaded physics needs an initialized PhysicsSystem");
+            return;
+        }
+        m_stopStepThread = false;
+        m_threadedStepping = true;
+        m_stepThread = std::thread(&PhysicsSystem::StepThreadMain, this);
+    } else {
+        WaitForStep();
+        {
+            std::lock_guard<std::mutex> lock(m_stepMutex);
+            m_stopStepThread = true;
+        }
+        m_stepWake.notify_one();
+        if (m_stepThread.joinable()) {
+            m_stepThread.join();
+        }
+        m_threadedStepping = false;
+    }
+    BS_INFO_F(LogCategory::PHYSICS, "Physics stepping: %s", enabled ? "own thread" : "main thread");
+}
+
+void PhysicsSystem::StepThreadMain() {
+    Profiler::SetThreadName("Physics");
+
+    std::unique_lock<std::mutex> lock(m_stepMutex);
+    while (true) {
+        m_stepWake.wait(lock, [this] { return m_stepRequested || m_stopStepThread; });
+        if (m_stopStepThread)
+            break;
+
+        int steps = m_requestedSteps;
+        float stepTime = m_requestedStepTime;
+        lock.unlock();
+        RunSteps(steps, stepTime);
+        lock.lock();
+
+        m_stepRequested = false;
+        m_stepDone.notify_all();
+    }
+}
+
+int PhysicsSystem::AdvanceAccumulator(float deltaTime) {
+    if (!m_fixedTimestep)
+        return 1;
+
+    m_accumulator += std::min(std::max(deltaTime, 0.0f), MAX_FRAME_TIME);
+
+    int steps = static_cast<int>(m_accumulator / m_fixedStep);
+    if (steps > m_maxSubSteps) {
+        // Spiral of death guard - if we can't keep up, let the simulation fall behind instead of
+        // taking ever more steps per frame. Keep only the fraction so the blend factor stays sane.
+        BS_DEBUG_F(LogCategory::PHYSICS, "Physics fell behind, dropping %d steps", steps - m_maxSubSteps);
+        steps = m_maxSubSteps;
+        m_accumulator = std::fmod(m_accumulator, m_fixedStep);
+    } else {
+        m_accumulator -= steps * m_fixedStep;
+    }
+    return steps;
+}
+
+void PhysicsSystem::RunSteps(int steps, float stepTime) {
+    if (steps <= 0)
+        return;
+
+    BS_PROFILE_SCOPE("PhysicsSystem::RunSteps");
+    ClearCollisionEvents();
+
+    // Jolt splits the time into 'steps' equal collision steps, so in fixed mode this is the same as
+    // stepping one fixed step at a time, with a single job dispatch
+    m_physicsSystem->Update(stepTime, steps, m_tempAllocator.get(), m_jobSystem.get());
+}
+
+float PhysicsSystem::GetStepTime(int steps, float deltaTime) const {
+    return m_fixedTimestep ? steps * m_fixedStep : deltaTime;
+}
+
+float PhysicsSystem::ComputeAlpha() const {
+    if (!m_fixedTimestep)
+        return 1.0f;
+    return std::min(m_accumulator / m_fixedStep, 1.0f);
+}
+
+void PhysicsSystem::SetFixedTimestep(bool enabled, float stepSeconds) {
+    if (stepSeconds <= 0.0f) {
+        BS_ERROR_F(LogCategory::PHYSICS, "Invalid physics step %.4f, keeping %.4f", stepSeconds, m_fixedStep);
+    } else {
+        m_fixedStep = stepSeconds;
+    }
+    m_fixedTimestep = enabled;
+    m_accumulator = 0.0f;
+    BS_INFO_F(LogCategory::PHYSICS, "Physics timestep: %s (%.1f Hz)", enabled ? "fixed" : "variable",
+              1.0f / m_fixedStep);
+}
+
+void PhysicsSystem::SetMaxSubSteps(int maxSubSteps) {
+    m_maxSubSteps = std::max(1, maxSubSteps);
+}
+
+float PhysicsSystem::GetInterpolationAlpha() const {
+    return m_fixedTimestep ? m_renderAlpha : 1.0f;
 }
 
 JPH::BodyID PhysicsSystem::CreateBoxBody(const glm::vec3& position, const glm::vec3& size, bool isStatic) {
@@ -218,8 +540,9 @@ JPH::BodyID PhysicsSystem::CreateBoxBody(const glm::vec3& position, const glm::v
         return JPH::BodyID();
     }
 
+    // Goes into the broadphase with everything else spawned this frame, see FlushBodyChanges
     JPH::BodyID bodyID = body->GetID();
-    m_physicsSystem->GetBodyInterface().AddBody(bodyID, JPH::EActivation::Activate);
+    QueueBodyAdd(bodyID);
     return bodyID;
 }
 
@@ -240,8 +563,9 @@ JPH::BodyID PhysicsSystem::CreateSphereBody(const glm::vec3& position, float rad
         return JPH::BodyID();
     }
 
+    // Goes into the broadphase with everything else spawned this frame, see FlushBodyChanges
     JPH::BodyID bodyID = body->GetID();
-    m_physicsSystem->GetBodyInterface().AddBody(bodyID, JPH::EActivation::Activate);
+    QueueBodyAdd(bodyID);
     return bodyID;
 }
 
@@ -270,13 +594,91 @@ JPH::BodyID PhysicsSystem::CreatePlaneBody(const glm::vec3& position, const glm:
 void PhysicsSystem::SetBodyPosition(JPH::BodyID bodyID, const glm::vec3& position) {
     if (!m_initialized)
         return;
+    auto edit = [&](JPH::Body& body) { body.SetPositionAndRotationInternal(ToJoltPos(position), body.GetRotation()); };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
     m_physicsSystem->GetBodyInterface().SetPosition(bodyID, ToJoltPos(position), JPH::EActivation::Activate);
 }
 
 void PhysicsSystem::SetBodyRotation(JPH::BodyID bodyID, const glm::vec3& eulerAngles) {
+    SetBodyRotation(bodyID, EulerToQuat(eulerAngles));
+}
+
+void PhysicsSystem::SetBodyRotation(JPH::BodyID bodyID, const glm::quat& rotation) {
+    if (!m_initialized)
+        return;
+    auto edit = [&](JPH::Body& body) { body.SetPositionAndRotationInternal(body.GetPosition(), ToJoltRot(rotation)); };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
+    m_physicsSystem->GetBodyInterface().SetRotation(bodyID, ToJoltRot(rotation), JPH::EActivation::Activate);
+}
+
+void PhysicsSystem::SetBodyPositionAndRotation(JPH::BodyID bodyID, const glm::vec3& position,
+                                               const glm::quat& rotation) {
     if (!m_initialized)
         return;
-    m_physicsSystem->GetBodyInterface().SetRotation(bodyID, ToJoltRot(eulerAngles), JPH::EActivation::Activate);
+    auto edit = [&](JPH::Body& body) {
+        body.SetPositionAndRotationInternal(ToJoltPos(position), ToJoltRot(rotation));
+    };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
+    m_physicsSystem->GetBodyInterface().SetPositionAndRotation(bodyID, ToJoltPos(position), ToJoltRot(rotation),
+                                                               JPH::EActivation::Activate);
+}
+
+void PhysicsSystem::SetBodyTransforms(const std::vector<Entity*>& entities) {
+    if (!m_initialized || entities.empty())
+        return;
+
+    // Nothing else touches bodies between steps, the per-body mutexes would only cost us. A threaded step is
+    // still inside them though, so let it finish first.
+    if (m_threadedStepping) {
+        std::unique_lock<std::mutex> lock(m_stepMutex);
+        m_stepDone.wait(lock, [this] { return !m_stepRequested; });
+    }
+
+    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterfaceNoLock();
+    std::vector<JPH::BodyID> wake;
+    wake.reserve(entities.size());
+
+    for (Entity* entity : entities) {
+        const PhysicsComponent& physics = entity->GetPhysics();
+        if (!physics.hasPhysics || physics.body.IsInvalid())
+            continue;
+
+        const Transform& transform = entity->GetTransform();
+        bodyInterface.SetPositionAndRotation(physics.body, ToJoltPos(transform.position), ToJoltRot(transform.rotation),
+                                             JPH::EActivation::DontActivate);
+        // Queued bodies just take the new pose, the batch add activates them
+        bool inWorld = bodyInterface.IsAdded(physics.body);
+        if (inWorld && bodyInterface.GetMotionType(physics.body) != JPH::EMotionType::Static) {
+            wake.push_back(physics.body);
+        }
+    }
+
+    if (!wake.empty()) {
+        bodyInterface.ActivateBodies(wake.data(), static_cast<int>(wake.size()));
+    }
+    BS_DEBUG_F(LogCategory::PHYSICS, "Moved %zu bodies in one batch", wake.size());
+}
+
+void PhysicsSystem::SetBodiesSleeping(const std::vector<JPH::BodyID>& bodies, bool sleeping) {
+    if (!m_initialized || bodies.empty())
+        return;
+
+    // No-lock interface again, so not while a threaded step is running
+    if (m_threadedStepping) {
+        std::unique_lock<std::mutex> lock(m_stepMutex);
+        m_stepDone.wait(lock, [this] { return !m_stepRequested; });
+    }
+    FlushPendingAdds();
+
+    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterfaceNoLock();
+    if (sleeping) {
+        bodyInterface.DeactivateBodies(bodies.data(), static_cast<int>(bodies.size()));
+    } else {
+        bodyInterface.ActivateBodies(bodies.data(), static_cast<int>(bodies.size()));
+    }
 }
 
 glm::vec3 PhysicsSystem::GetBodyPosition(JPH::BodyID bodyID) {
@@ -294,24 +696,48 @@ glm::vec3 PhysicsSystem::GetBodyRotation(JPH::BodyID bodyID) {
 void PhysicsSystem::AddForce(JPH::BodyID bodyID, const glm::vec3& force) {
     if (!m_initialized)
         return;
+    auto edit = [&](JPH::Body& body) {
+        if (body.IsDynamic())
+            body.AddForce(ToJoltPos(force));
+    };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
     m_physicsSystem->GetBodyInterface().AddForce(bodyID, ToJoltPos(force));
 }
 
 void PhysicsSystem::AddImpulse(JPH::BodyID bodyID, const glm::vec3& impulse) {
     if (!m_initialized)
         return;
+    auto edit = [&](JPH::Body& body) {
+        if (body.IsDynamic())
+            body.AddImpulse(ToJoltPos(impulse));
+    };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
     m_physicsSystem->GetBodyInterface().AddImpulse(bodyID, ToJoltPos(impulse));
 }
 
 void PhysicsSystem::SetVelocity(JPH::BodyID bodyID, const glm::vec3& velocity) {
     if (!m_initialized)
         return;
+    auto edit = [&](JPH::Body& body) {
+        if (!body.IsStatic())
+            body.SetLinearVelocityClamped(ToJoltPos(velocity));
+    };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
     m_physicsSystem->GetBodyInterface().SetLinearVelocity(bodyID, ToJoltPos(velocity));
 }
 
 void PhysicsSystem::SetAngularVelocity(JPH::BodyID bodyID, const glm::vec3& angularVel) {
     if (!m_initialized)
         return;
+    auto edit = [&](JPH::Body& body) {
+        if (!body.IsStatic())
+            body.SetAngularVelocityClamped(ToJoltPos(angularVel));
+    };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
     m_physicsSystem->GetBodyInterface().SetAngularVelocity(bodyID, ToJoltPos(angularVel));
 }
 
@@ -319,10 +745,20 @@ void PhysicsSystem::SetAngularVelocity(JPH::BodyID bodyID, const glm::vec3& angu
 void PhysicsSystem::MakeBodyStatic(JPH::BodyID bodyID) {
     if (!m_initialized)
         return;
+    // Change motion type to static, bodies in the built-in moving layer move to NON_MOVING.
+    // Custom layers stay put, the layer was picked on purpose.
+    auto edit = [](JPH::Body& body) {
+        body.SetMotionType(JPH::EMotionType::Static);
+        if (body.GetObjectLayer() == MOVING)
+            body.SetObjectLayerInternal(NON_MOVING);
+    };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
 
-    // Change motion type to static and move to NON_MOVING layer
-    m_physicsSystem->GetBodyInterface().SetMotionType(bodyID, JPH::EMotionType::Static, JPH::EActivation::DontActivate);
-    m_physicsSystem->GetBodyInterface().SetObjectLayer(bodyID, NON_MOVING);
+    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterface();
+    bodyInterface.SetMotionType(bodyID, JPH::EMotionType::Static, JPH::EActivation::DontActivate);
+    if (bodyInterface.GetObjectLayer(bodyID) == MOVING)
+        bodyInterface.SetObjectLayer(bodyID, NON_MOVING);
 
     BS_DEBUG_F(LogCategory::PHYSICS, "Body %d is now static", bodyID.GetIndex());
 }
@@ -330,10 +766,19 @@ void PhysicsSystem::MakeBodyStatic(JPH::BodyID bodyID) {
 void PhysicsSystem::MakeBodyDynamic(JPH::BodyID bodyID) {
     if (!m_initialized)
         return;
+    // Change motion type to dynamic, same deal as MakeBodyStatic the other way around
+    auto edit = [](JPH::Body& body) {
+        body.SetMotionType(JPH::EMotionType::Dynamic);
+        if (body.GetObjectLayer() == NON_MOVING)
+            body.SetObjectLayerInternal(MOVING);
+    };
+    if (EditQueuedBody(*m_physicsSystem, bodyID, edit))
+        return;
 
-    // Change motion type to dynamic and move to MOVING layer
-    m_physicsSystem->GetBodyInterface().SetMotionType(bodyID, JPH::EMotionType::Dynamic, JPH::EActivation::Activate);
-    m_physicsSystem->GetBodyInterface().SetObjectLayer(bodyID, MOVING);
+    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterface();
+    bodyInterface.SetMotionType(bodyID, JPH::EMotionType::Dynamic, JPH::EActivation::Activate);
+    if (bodyInterface.GetObjectLayer(bodyID) == NON_MOVING)
+        bodyInterface.SetObjectLayer(bodyID, MOVING);
 
     BS_DEBUG_F(LogCategory::PHYSICS, "Body %d is now dynamic", bodyID.GetIndex());
 }
@@ -345,6 +790,49 @@ bool PhysicsSystem::IsBodyStatic(JPH::BodyID bodyID) {
     return m_physicsSystem->GetBodyInterface().GetMotionType(bodyID) == JPH::EMotionType::Static;
 }
 
+JPH::ObjectLayer PhysicsSystem::ResolveLayer(const PhysicsComponent& physics) const {
+    if (physics.layer != PhysicsComponent::AUTO_LAYER) {
+        if (physics.layer < m_config.layers.GetLayerCount())
+            return physics.layer;
+        BS_WARN_F(LogCategory::PHYSICS, "Unknown physics layer %u, using the default", physics.layer);
+    }
+    return physics.isDynamic ? MOVING : NON_MOVING;
+}
+
+void PhysicsSystem::SetBodyLayer(Entity& entity, PhysicsLayer layer) {
+    PhysicsComponent& physics = entity.GetPhysics();
+    if (layer != PhysicsComponent::AUTO_LAYER && layer >= m_config.layers.GetLayerCount()) {
+        BS_ERROR_F(LogCategory::PHYSICS, "SetBodyLayer: entity %d, layer %u doesn't exist", entity.id, layer);
+        return;
+    }
+    physics.layer = layer;
+
+    if (!m_initialized || !physics.hasPhysics || physics.body.IsInvalid())
+        return;
+    JPH::ObjectLayer objectLayer = ResolveLayer(physics);
+    auto edit = [&](JPH::Body& body) { body.SetObjectLayerInternal(objectLayer); };
+    if (EditQueuedBody(*m_physicsSystem, physics.body, edit))
+        return;
+    m_physicsSystem->GetBodyInterface().SetObjectLayer(physics.body, objectLayer);
+}
+
+void PhysicsSystem::SetLayerCollision(PhysicsLayer a, PhysicsLayer b, bool collide) {
+    if (a >= m_config.layers.GetLayerCount() || b >= m_config.layers.GetLayerCount()) {
+        BS_ERROR_F(LogCategory::PHYSICS, "SetLayerCollision: layer %u/%u doesn't exist", a, b);
+        return;
+    }
+
+    // The filters read the matrix from the job threads, so not mid-step
+    if (m_threadedStepping) {
+        std::unique_lock<std::mutex> lock(m_stepMutex);
+        m_stepDone.wait(lock, [this] { return !m_stepRequested; });
+    }
+
+    m_config.layers.SetCollision(a, b, collide);
+    if (m_objectVsBroadphaseLayerFilter)
+        m_objectVsBroadphaseLayerFilter->Rebuild(m_config.layers);
+}
+
 JPH::BodyID PhysicsSystem::CreatePhysicsBody(Entity& entity) {
     if (!m_initialized) {
         BS_ERROR(LogCategory::PHYSICS, "Physics system not initialized");
@@ -356,34 +844,37 @@ JPH::BodyID PhysicsSystem::CreatePhysicsBody(Entity& entity) {
         AddDefaultColliderToEntity(entity);
     }
 
-    // Create compound shape from all colliders
-    JPH::Ref<JPH::Shape> shape = CreateShapeFromColliders(entity.colliders, entity.transform.scale);
+    // Shared with every other body that has the same colliders and scale
+    JPH::Ref<JPH::Shape> shape = GetOrCreateShape(entity.colliders, entity.GetTransform().scale);
     if (!shape) {
         BS_ERROR_F(LogCategory::PHYSICS, "Failed to create shape for entity %d", entity.id);
         return JPH::BodyID();
     }
 
     // Create body settings
-    JPH::BodyCreationSettings bodySettings(shape, ToJoltPos(entity.transform.position),
-                                           ToJoltRot(entity.transform.rotation),
-                                           entity.isDynamic ? JPH::EMotionType::Dynamic : JPH::EMotionType::Static,
-                                           entity.isDynamic ? MOVING : NON_MOVING);
+    JPH::BodyCreationSettings bodySettings(shape, ToJoltPos(entity.GetTransform().position),
+                                           ToJoltRot(entity.GetTransform()),
+                                           entity.GetPhysics().isDynamic ? JPH::EMotionType::Dynamic : JPH::EMotionType::Static,
+                                           ResolveLayer(entity.GetPhysics()));
 
     bodySettings.mAllowDynamicOrKinematic = true;
+    bodySettings.mUserData = static_cast<JPH::uint64>(entity.id) + 1;
 
     // Create and add body
     JPH::Body* body = m_physicsSystem->GetBodyInterface().CreateBody(bodySettings);
     if (!body) {
-        BS_ERROR_F(LogCategory::PHYSICS, "Failed to create physics body for entity %d", entity.id);
+        BS_ERROR_F(LogCategory::PHYSICS, "Failed to create physics body for entity %d (%u/%u bodies in use)",
+                   entity.id, m_physicsSystem->GetNumBodies(), m_physicsSystem->GetMaxBodies());
         return JPH::BodyID();
     }
 
+    // Goes into the broadphase with everything else spawned this frame, see FlushBodyChanges
     JPH::BodyID bodyID = body->GetID();
-    m_physicsSystem->GetBodyInterface().AddBody(bodyID, JPH::EActivation::Activate);
+    QueueBodyAdd(bodyID);
 
     // Store mapping and update entity
-    entity.physicsBody = bodyID;
-    entity.hasPhysics = true;
+    entity.GetPhysics().body = bodyID;
+    entity.GetPhysics().hasPhysics = true;
     MapEntityToBody(entity.id, bodyID);
 
     BS_DEBUG_F(LogCategory::PHYSICS, "Created physics body for entity %d with %zu colliders", entity.id,
@@ -392,38 +883,281 @@ JPH::BodyID PhysicsSystem::CreatePhysicsBody(Entity& entity) {
     return bodyID;
 }
 
+void PhysicsSystem::CreatePhysicsBodies(const std::vector<Entity*>& entities) {
+    if (!m_initialized) {
+        BS_ERROR(LogCategory::PHYSICS, "Physics system not initialized");
+        return;
+    }
+
+    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterface();
+
+    std::vector<JPH::BodyID> bodyIDs;
+    bodyIDs.reserve(entities.size());
+    for (Entity* entity : entities) {
+        Transform& transform = entity->GetTransform();
+        PhysicsComponent& physics = entity->GetPhysics();
+
+        if (entity->colliders.empty()) {
+            entity->colliders = GetDefaultColliders(entity->GetRender().shape);
+        }
+
+        // Identical entities all hit the same cache entry, so a batch of crates is one BoxShape
+        JPH::Ref<JPH::Shape> shape = GetOrCreateShape(entity->colliders, transform.scale);
+        if (!shape) {
+            BS_ERROR_F(LogCategory::PHYSICS, "Failed to create shape for entity %d", entity->id);
+            continue;
+        }
+
+        JPH::BodyCreationSettings bodySettings(shape, ToJoltPos(transform.position), ToJoltRot(transform),
+                                               physics.isDynamic ? JPH::EMotionType::Dynamic : JPH::EMotionType::Static,
+                                               ResolveLayer(physics));
+        bodySettings.mAllowDynamicOrKinematic = true;
+        bodySettings.mUserData = static_cast<JPH::uint64>(entity->id) + 1;
+
+        // CreateBody only fails when we hit the body limit, no point trying the rest
+        JPH::Body* body = bodyInterface.CreateBody(bodySettings);
+        if (!body) {
+            BS_ERROR_F(LogCategory::PHYSICS,
+                       "Body limit reached (%u), %zu of %zu batched bodies created - raise PhysicsConfig::maxBodies",
+                       m_physicsSystem->GetMaxBodies(), bodyIDs.size(), entities.size());
+            break;
+        }
+
+        physics.body = body->GetID();
+        physics.hasPhysics = true;
+        MapEntityToBody(entity->id, physics.body);
+        bodyIDs.push_back(physics.body);
+    }
+
+    // Added to the broadphase in one go at the next flush
+    std::vector<JPH::BodyID>& queue = m_heldAdds ? *m_heldAdds : m_pendingAdds;
+    queue.insert(queue.end(), bodyIDs.begin(), bodyIDs.end());
+    BS_DEBUG_F(LogCategory::PHYSICS, "Batch-created %zu physics bodies", bodyIDs.size());
+}
+
+void PhysicsSystem::FlushBodyChanges() {
+    if (!m_initialized || (m_pendingAdds.empty() && m_pendingRemovals.empty()))
+        return;
+
+    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterface();
+    size_t added = m_pendingAdds.size();
+    size_t removed = m_pendingRemovals.size();
+
+    // Adds first - a body created and removed in the same frame is still queued for add, and
+    // RemoveBodies wants it in the broadphase
+    if (!m_pendingAdds.empty()) {
+        // Prepare builds the broadphase nodes off to the side, Finalize links them in under one lock.
+        // (Prepare may reorder the array, that's fine - every entity already has its id.)
+        int count = static_cast<int>(m_pendingAdds.size());
+        JPH::BodyInterface::AddState addState = bodyInterface.AddBodiesPrepare(m_pendingAdds.data(), count);
+        bodyInterface.AddBodiesFinalize(m_pendingAdds.data(), count, addState, JPH::EActivation::Activate);
+        m_pendingAdds.clear();
+    }
+
+    if (!m_pendingRemovals.empty()) {
+        // Held bodies that never went in only get destroyed, RemoveBodies wants everything in the broadphase
+        m_removedInWorld.clear();
+        for (const JPH::BodyID& bodyID : m_pendingRemovals) {
+            if (bodyInterface.IsAdded(bodyID)) {
+                m_removedInWorld.push_back(bodyID);
+            }
+        }
+        if (!m_removedInWorld.empty()) {
+            bodyInterface.RemoveBodies(m_removedInWorld.data(), static_cast<int>(m_removedInWorld.size()));
+        }
+        bodyInterface.DestroyBodies(m_pendingRemovals.data(), static_cast<int>(m_pendingRemovals.size()));
+        m_pendingRemovals.clear();
+    }
+
+    // The broadphase tree goes lopsided after big adds/removes, rebuild it once the churn adds up
+    m_bodiesChangedSinceOptimize += added + removed;
+    if (m_bodiesChangedSinceOptimize >= BROADPHASE_OPTIMIZE_THRESHOLD) {
+        m_physicsSystem->OptimizeBroadPhase();
+        BS_DEBUG_F(LogCategory::PHYSICS, "Broadphase optimized after %zu body changes", m_bodiesChangedSinceOptimize);
+        m_bodiesChangedSinceOptimize = 0;
+    }
+
+    BS_DEBUG_F(LogCategory::PHYSICS, "Flushed body changes: %zu added, %zu removed", added, removed);
+}
+
+void PhysicsSystem::AddHeldBodies(std::vector<JPH::BodyID>& held) {
+    if (!m_initialized) {
+        held.clear();
+        return;
+    }
+
+    // Skip whatever got destroyed while it was held
+    m_pendingAdds.reserve(m_pendingAdds.size() + held.size());
+    for (const JPH::BodyID& bodyID : held) {
+        JPH::BodyLockRead lock(m_physicsSystem->GetBodyLockInterface(), bodyID);
+        if (lock.Succeeded() && !lock.GetBody().IsInBroadPhase()) {
+            m_pendingAdds.push_back(bodyID);
+        }
+    }
+    BS_DEBUG_F(LogCategory::PHYSICS, "Queued %zu held bodies", held.size());
+    held.clear();
+}
+
 void PhysicsSystem::UpdatePhysicsBody(Entity& entity) {
-    if (!entity.hasPhysics || entity.physicsBody.IsInvalid()) {
+    if (!entity.GetPhysics().hasPhysics || entity.GetPhysics().body.IsInvalid()) {
         return;
     }
 
     // Remove old body
-    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterface();
-    bodyInterface.RemoveBody(entity.physicsBody);
-    bodyInterface.DestroyBody(entity.physicsBody);
+    m_pendingRemovals.push_back(entity.GetPhysics().body);
 
     // Create new body with updated colliders
-    entity.hasPhysics = false;
-    entity.physicsBody = JPH::BodyID();
+    entity.GetPhysics().hasPhysics = false;
+    entity.GetPhysics().body = JPH::BodyID();
     CreatePhysicsBody(entity);
 }
 
 void PhysicsSystem::RemovePhysicsBody(Entity& entity) {
-    if (!entity.hasPhysics || entity.physicsBody.IsInvalid()) {
+    if (!entity.GetPhysics().hasPhysics || entity.GetPhysics().body.IsInvalid()) {
         return;
     }
 
-    JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterface();
-    bodyInterface.RemoveBody(entity.physicsBody);
-    bodyInterface.DestroyBody(entity.physicsBody);
+    // Stays in the world until the next flush, but the entity lets go of it right away
+    m_pendingRemovals.push_back(entity.GetPhysics().body);
 
     UnmapEntity(entity.id);
-    entity.hasPhysics = false;
-    entity.physicsBody = JPH::BodyID();
+    entity.GetPhysics().hasPhysics = false;
+    entity.GetPhysics().body = JPH::BodyID();
 
     BS_DEBUG_F(LogCategory::PHYSICS, "Removed physics body for entity %d", entity.id);
 }
 
+bool PhysicsSystem::ShapeCacheKey::operator==(const ShapeCacheKey& other) const {
+    if (colliders.size() != other.colliders.size() || scale != other.scale)
+        return false;
+
+    for (size_t i = 0; i < colliders.size(); ++i) {
+        const Collider& a = colliders[i];
+        const Collider& b = other.colliders[i];
+        if (a.type != b.type || a.size != b.size || a.center != b.center || a.rotation != b.rotation)
+            return false;
+    }
+    return true;
+}
+
+size_t PhysicsSystem::ShapeCacheKeyHash::operator()(const ShapeCacheKey& key) const {
+    size_t hash = 0;
+    auto combine = [&hash](float value) {
+        hash ^= std::hash<float>()(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+
+    for (const Collider& collider : key.colliders) {
+        hash ^= std::hash<int>()(static_cast<int>(collider.type)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        for (int i = 0; i < 3; ++i) {
+            combine(collider.size[i]);
+            combine(collider.center[i]);
+        }
+        for (int i = 0; i < 4; ++i) {
+            combine(collider.rotation[i]);
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        combine(key.scale[i]);
+    }
+    return hash;
+}
+
+JPH::Ref<JPH::Shape> PhysicsSystem::GetOrCreateShape(const std::vector<Collider>& colliders, const glm::vec3& scale) {
+    if (colliders.empty())
+        return nullptr;
+
+    ShapeCacheKey key{colliders, glm::abs(scale)};
+    {
+        std::lock_guard<std::mutex> lock(m_shapeCacheMutex);
+        auto it = m_shapeCache.find(key);
+        if (it != m_shapeCache.end())
+            return it->second;
+
+        if (m_shapeCache.size() >= SHAPE_CACHE_PRUNE_SIZE) {
+            PruneShapeCacheLocked();
+        }
+    }
+
+    // Spheres and capsules only take uniform scale in Jolt, anything else has to be built at its final size
+    bool uniformScale = key.scale.x == key.scale.y && key.scale.y == key.scale.z;
+    bool hasSphere = std::any_of(colliders.begin(), colliders.end(), [](const Collider& collider) {
+        return collider.type == ColliderType::Sphere || collider.type == ColliderType::Capsule;
+    });
+
+    JPH::Ref<JPH::Shape> shape;
+    if (key.scale == glm::vec3(1.0f) || (hasSphere && !uniformScale)) {
+        shape = CreateShapeFromColliders(colliders, key.scale);
+    } else {
+        // Compounds with rotated children can't be scaled non-uniformly either, those get built too
+        JPH::Ref<JPH::Shape> unitShape = GetOrCreateShape(colliders, glm::vec3(1.0f));
+        if (unitShape && unitShape->IsValidScale(ToJoltPos(key.scale))) {
+            shape = new JPH::ScaledShape(unitShape.GetPtr(), ToJoltPos(key.scale));
+        } else if (unitShape) {
+            shape = CreateShapeFromColliders(colliders, key.scale);
+        }
+    }
+
+    // Built outside the lock, if another thread got there first its shape wins and this one is dropped
+    if (shape) {
+        std::lock_guard<std::mutex> lock(m_shapeCacheMutex);
+        shape = m_shapeCache.emplace(std::move(key), shape).first->second;
+    }
+    return shape;
+}
+
+size_t PhysicsSystem::GetShapeCacheSize() const {
+    std::lock_guard<std::mutex> lock(m_shapeCacheMutex);
+    return m_shapeCache.size();
+}
+
+void PhysicsSystem::PruneShapeCache() {
+    std::lock_guard<std::mutex> lock(m_shapeCacheMutex);
+    PruneShapeCacheLocked();
+}
+
+void PhysicsSystem::PruneShapeCacheLocked() {
+    size_t before = m_shapeCache.size();
+
+    // Scaled shapes hold a ref to their unit shape, so a couple of passes frees those too
+    bool removed = true;
+    while (removed) {
+        removed = false;
+        for (auto it = m_shapeCache.begin(); it != m_shapeCache.end();) {
+            if (it->second->GetRefCount() == 1) {
+                it = m_shapeCache.erase(it);
+                removed = true;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    BS_DEBUG_F(LogCategory::PHYSICS, "Shape cache pruned, %zu -> %zu shapes", before, m_shapeCache.size());
+}
+
+void PhysicsSystem::SetBodyScale(Entity& entity, const glm::vec3& scale) {
+    PhysicsComponent& physics = entity.GetPhysics();
+    if (!m_initialized || !physics.hasPhysics || physics.body.IsInvalid())
+        return;
+
+    if (entity.colliders.empty()) {
+        AddDefaultColliderToEntity(entity);
+    }
+
+    JPH::Ref<JPH::Shape> shape = GetOrCreateShape(entity.colliders, scale);
+    if (!shape) {
+        BS_ERROR_F(LogCategory::PHYSICS, "Failed to create scaled shape for entity %d", entity.id);
+        return;
+    }
+
+    auto edit = [&](JPH::Body& body) { body.SetShapeInternal(shape, true); };
+    if (!EditQueuedBody(*m_physicsSystem, physics.body, edit)) {
+        m_physicsSystem->GetBodyInterface().SetShape(physics.body, shape, true, JPH::EActivation::Activate);
+    }
+    BS_DEBUG_F(LogCategory::PHYSICS, "Entity %d physics scale set to (%.2f, %.2f, %.2f)", entity.id, scale.x,
+               scale.y, scale.z);
+}
+
 JPH::Ref<JPH::Shape> PhysicsSystem::CreateShapeFromColliders(const std::vector<Collider>& colliders,
                                                              const glm::vec3& entityScale) {
     if (colliders.empty()) {
@@ -488,16 +1222,26 @@ JPH::Ref<JPH::Shape> PhysicsSystem::CreateSingleColliderShape(const Collider& co
             BS_DEBUG_F(LogCategory::PHYSICS, "  Sphere radius: %.2f", radius);
             return new JPH::SphereShape(radius);
         }
+        case ColliderType::Capsule: {
+            // Along Y, same as DebugDraw: size.x is the diameter, size.y the full height caps included
+            float radius = scaledSize.x * 0.5f;
+            float halfHeight = scaledSize.y * 0.5f - radius;
+            BS_DEBUG_F(LogCategory::PHYSICS, "  Capsule radius: %.2f, cylinder half height: %.2f", radius, halfHeight);
+            if (halfHeight <= 0.0f) {
+                return new JPH::SphereShape(radius);  // Not tall enough to have a middle
+            }
+            return new JPH::CapsuleShape(halfHeight, radius);
+        }
         default:
             BS_ERROR_F(LogCategory::PHYSICS, "Unknown collider type: %d", static_cast<int>(collider.type));
             return nullptr;
     }
 }
 
-void PhysicsSystem::AddDefaultColliderToEntity(Entity& entity) {
+Collider PhysicsSystem::MakeDefaultCollider(Entity::VisualShape shape) {
     Collider defaultCollider;
 
-    switch (entity.shape) {
+    switch (shape) {
         case Entity::CUBE:
             defaultCollider.type = ColliderType::Box;
             defaultCollider.size = glm::vec3(1.0f);
@@ -512,9 +1256,30 @@ void PhysicsSystem::AddDefaultColliderToEntity(Entity& entity) {
             // Y would become too small on .1f.
             defaultCollider.size = glm::vec3(1.0f, 1.f, 1.0f);
             break;
+        case Entity::MESH:
+            // Physics never sees the mesh data, a unit box until the entity gets real colliders
+            defaultCollider.type = ColliderType::Box;
+            defaultCollider.size = glm::vec3(1.0f);
+            break;
     }
 
-    entity.colliders.push_back(defaultCollider);
+    return defaultCollider;
+}
+
+const ColliderSet& PhysicsSystem::GetDefaultColliders(Entity::VisualShape shape) {
+    static const ColliderSet defaults[] = {
+        std::vector<Collider>{MakeDefaultCollider(Entity::CUBE)},
+        std::vector<Collider>{MakeDefaultCollider(Entity::SPHERE)},
+        std::vector<Collider>{MakeDefaultCollider(Entity::PLANE)},
+        std::vector<Collider>{MakeDefaultCollider(Entity::MESH)},
+    };
+    return defaults[shape];
+}
+
+void PhysicsSystem::AddDefaultColliderToEntity(Entity& entity) {
+    const Collider& defaultCollider = GetDefaultColliders(entity.GetRender().shape)[0];
+
+    entity.colliders = GetDefaultColliders(entity.GetRender().shape);
     BS_DEBUG_F(LogCategory::PHYSICS, "Added default collider to entity %d (type: %d, size: %.2f,%.2f,%.2f)", entity.id,
                static_cast<int>(defaultCollider.type), defaultCollider.size.x, defaultCollider.size.y,
                defaultCollider.size.z);
@@ -524,7 +1289,7 @@ void PhysicsSystem::AddColliderToEntity(Entity& entity, const Collider& collider
     entity.colliders.push_back(collider);
 
     // If entity already has physics, update the body
-    if (entity.hasPhysics) {
+    if (entity.GetPhysics().hasPhysics) {
         UpdatePhysicsBody(entity);
     }
 
@@ -537,10 +1302,10 @@ void PhysicsSystem::RemoveColliderFromEntity(Entity& entity, size_t colliderInde
         return;
     }
 
-    entity.colliders.erase(entity.colliders.begin() + colliderIndex);
+    entity.colliders.Erase(colliderIndex);
 
     // If entity has physics, update the body
-    if (entity.hasPhysics) {
+    if (entity.GetPhysics().hasPhysics) {
         if (entity.colliders.empty()) {
             // No colliders left - remove physics body
             RemovePhysicsBody(entity);
@@ -623,32 +1388,320 @@ glm::vec3 PhysicsSystem::GetBodyCenterOfMass(JPH::BodyID bodyID) {
     return ToGLMPos(centerOfMass);
 }
 
-JPH::BodyID PhysicsSystem::GetBodyIDFromEntityID(int entityId) {
-    auto it = m_entityToBodyMap.find(entityId);
-    if (it != m_entityToBodyMap.end()) {
-        return it->second;
+size_t PhysicsSystem::SyncActiveBodies(ComponentStore& components) {
+    if (!m_initialized) {
+        return 0;
     }
-    return JPH::BodyID();  // Invalid body ID
+
+    // Only bodies that moved this step, resting ones don't show up here at all
+    m_activeBodies.clear();
+    m_physicsSystem->GetActiveBodies(JPH::EBodyType::RigidBody, m_activeBodies);
+
+    const JPH::BodyLockInterfaceNoLock& lockInterface = m_physicsSystem->GetBodyLockInterfaceNoLock();
+    auto& transforms = components.GetTransforms();
+    auto& previousPoses = components.GetPreviousPoses();
+    const auto& physics = components.GetPhysicsComponents();
+
+    // Bodies that went to sleep since last time won't be visited below, bring their previous
+    // pose up to date so they don't keep blending between two old poses
+    for (uint32_t slot : m_syncedSlots) {
+        if (slot < transforms.size() && previousPoses[slot].valid) {
+            previousPoses[slot].position = transforms[slot].position;
+            previousPoses[slot].orientation = transforms[slot].rotation;
+        }
+    }
+    m_syncedSlots.clear();
+
+    size_t synced = 0;
+    for (const JPH::BodyID& bodyID : m_activeBodies) {
+        JPH::BodyLockRead lock(lockInterface, bodyID);
+        if (!lock.Succeeded())
+            continue;
+
+        const JPH::Body& body = lock.GetBody();
+        JPH::uint64 userData = body.GetUserData();
+        if (userData == 0)
+            continue;  // Not an entity body (CreateBoxBody and friends)
+
+        // Slot from the entity id, then make sure the slot still belongs to this body
+        uint32_t slot = EntitySystem::GetIdIndex(static_cast<int>(userData - 1));
+        if (slot >= transforms.size() || physics[slot].body != bodyID)
+            continue;
+
+        JPH::Quat rotation = body.GetRotation();
+        Transform& transform = transforms[slot];
+        BodyPose& previous = previousPoses[slot];
+        if (previous.valid) {
+            previous.position = transform.position;
+            previous.orientation = transform.rotation;
+        } else {
+            // First sync for this body, nothing sensible to blend from
+            previous.position = ToGLMPos(body.GetCenterOfMassPosition());
+            previous.orientation = ToGLMQuat(rotation);
+            previous.valid = true;
+        }
+
+        transform.position = ToGLMPos(body.GetCenterOfMassPosition());
+        transform.rotation = ToGLMQuat(rotation);
+        components.MarkTransformDirty(slot);
+        m_syncedSlots.push_back(slot);
+        synced++;
+    }
+
+    return synced;
 }
 
-void PhysicsSystem::MapEntityToBody(int entityId, JPH::BodyID bodyID) {
-    m_entityToBodyMap[entityId] = bodyID;
+void PhysicsSystem::CastRayRange(const Ray* rays, QueryHit* hits, size_t count) const {
+    const JPH::NarrowPhaseQuery& query = m_physicsSystem->GetNarrowPhaseQuery();
+    const JPH::BodyLockInterfaceNoLock& lockInterface = m_physicsSystem->GetBodyLockInterfaceNoLock();
+
+    for (size_t i = 0; i < count; ++i) {
+        const Ray& ray = rays[i];
+        QueryHit& hit = hits[i];
+        hit = QueryHit{};
+
+        float length = glm::length(ray.direction);
+        if (length <= 0.0f || ray.maxDistance <= 0.0f)
+            continue;
+
+        // Jolt rays are origin + full-length direction, the hit fraction is along that
+        glm::vec3 direction = ray.direction / length * ray.maxDistance;
+        JPH::RRayCast joltRay(ToJoltPos(ray.origin), ToJoltPos(direction));
+        JPH::RayCastResult result;
+        if (!query.CastRay(joltRay, result))
+            continue;
+
+        hit.hit = true;
+        hit.body = result.mBodyID;
+        hit.distance = result.mFraction * ray.maxDistance;
+        hit.point = ray.origin + direction * result.mFraction;
+
+        JPH::BodyLockRead lock(lockInterface, result.mBodyID);
+        if (lock.Succeeded()) {
+            const JPH::Body& body = lock.GetBody();
+            hit.normal = ToGLMPos(body.GetWorldSpaceSurfaceNormal(result.mSubShapeID2, ToJoltPos(hit.point)));
+        }
+        hit.entityId = GetEntityIDFromBodyID(result.mBodyID);
+    }
 }
 
-void PhysicsSystem::UnmapEntity(int entityId) {
-    auto it = m_entityToBodyMap.find(entityId);
-    if (it != m_entityToBodyMap.end()) {
-        JPH::BodyID bodyID = it->second;
+void PhysicsSystem::RaycastBatch(const std::vector<Ray>& rays, std::vector<QueryHit>& outHits) {
+    outHits.resize(rays.size());
+    if (!m_initialized || rays.empty())
+        return;
+
+    FlushBodyChanges();  // New bodies are hit right away, removed ones never
+
+    if (rays.size() < PARALLEL_RAY_THRESHOLD) {
+        CastRayRange(rays.data(), outHits.data(), rays.size());
+        return;
+    }
+
+    // Queries only read, so the job threads can all go at the broadphase at once. Every job owns
+    // its own slice of outHits.
+    size_t jobCount = (rays.size() + RAYS_PER_JOB - 1) / RAYS_PER_JOB;
+    JPH::JobSystem::Barrier* barrier = m_jobSystem->CreateBarrier();
+    for (size_t job = 0; job < jobCount; ++job) {
+        size_t begin = job * RAYS_PER_JOB;
+        size_t count = std::min(RAYS_PER_JOB, rays.size() - begin);
+        const Ray* rayData = rays.data() + begin;
+        QueryHit* hitData = outHits.data() + begin;
+
+        JPH::JobSystem::JobHandle handle =
+            m_jobSystem->CreateJob("RaycastBatch", JPH::Color::sCyan,
+                                   [this, rayData, hitData, count]() { CastRayRange(rayData, hitData, count); });
+        barrier->AddJob(handle);
+    }
+    m_jobSystem->WaitForJobs(barrier);
+    m_jobSystem->DestroyBarrier(barrier);
+}
+
+QueryHit PhysicsSystem::Raycast(const Ray& ray) {
+    QueryHit hit;
+    if (!m_initialized)
+        return hit;
+
+    FlushBodyChanges();  // New bodies are hit right away, removed ones never
+    CastRayRange(&ray, &hit, 1);
+    return hit;
+}
+
+size_t PhysicsSystem::OverlapSphere(const glm::vec3& center, float radius, std::vector<int>& out) {
+    if (!m_initialized || radius <= 0.0f)
+        return 0;
+
+    FlushBodyChanges();  // New bodies are hit right away, removed ones never
+
+    JPH::SphereShape sphere(radius);
+    sphere.SetEmbedded();  // Lives on the stack, keep the ref counting away from it
+
+    JPH::CollideShapeSettings settings;
+    JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+    JPH::Mat44 sphereTransform = JPH::Mat44::sRotationTranslation(JPH::Quat::sIdentity(), ToJoltPos(center));
+    m_physicsSystem->GetNarrowPhaseQuery().CollideShape(&sphere, JPH::Vec3::sReplicate(1.0f), sphereTransform, settings,
+                                                        JPH::Vec3::sZero(), collector);
+
+    // One result per touching sub shape, so compounds can show up more than once
+    size_t before = out.size();
+    for (const JPH::CollideShapeResult& result : collector.mHits) {
+        int entityId = GetEntityIDFromBodyID(result.mBodyID2);
+        if (entityId >= 0 && std::find(out.begin() + before, out.end(), entityId) == out.end()) {
+            out.push_back(entityId);
+        }
+    }
+    return out.size() - before;
+}
 
-        m_entityToBodyMap.erase(it);
+QueryHit PhysicsSystem::SweepBox(const glm::vec3& halfExtents, const glm::quat& rotation, const glm::vec3& from,
+                                 const glm::vec3& to) {
+    QueryHit hit;
+    if (!m_initialized)
+        return hit;
+
+    glm::vec3 delta = to - from;
+    float distance = glm::length(delta);
+    if (distance <= 0.0f)
+        return hit;
+
+    FlushBodyChanges();  // New bodies are hit right away, removed ones never
+
+    // Jolt wants every half extent at least the convex radius, so thin boxes get a smaller radius rather
+    // than a bigger box
+    glm::vec3 extents = glm::max(halfExtents, glm::vec3(0.001f));
+    float convexRadius = std::min({JPH::cDefaultConvexRadius, extents.x, extents.y, extents.z});
+    JPH::BoxShape box(ToJoltPos(extents), convexRadius);
+    box.SetEmbedded();
+
+    JPH::Quat joltRotation(rotation.x, rotation.y, rotation.z, rotation.w);
+    JPH::RShapeCast shapeCast(&box, JPH::Vec3::sReplicate(1.0f),
+                              JPH::Mat44::sRotationTranslation(joltRotation, ToJoltPos(from)), ToJoltPos(delta));
+    JPH::ShapeCastSettings settings;
+    JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+    m_physicsSystem->GetNarrowPhaseQuery().CastShape(shapeCast, settings, JPH::Vec3::sZero(), collector);
+    if (!collector.HadHit())
+        return hit;
+
+    const JPH::ShapeCastResult& result = collector.mHit;
+    hit.hit = true;
+    hit.body = result.mBodyID2;
+    hit.distance = result.mFraction * distance;
+    hit.point = ToGLMPos(result.mContactPointOn2);
+    // Starting out deep inside something can leave no axis at all, face back along the sweep then
+    JPH::Vec3 axis = result.mPenetrationAxis;
+    hit.normal = axis.LengthSq() > 1.0e-12f ? -ToGLMPos(axis.Normalized()) : -delta / distance;
+    hit.entityId = GetEntityIDFromBodyID(result.mBodyID2);
+    return hit;
+}
+
+void PhysicsSystem::RecordCollisionEvent(const CollisionEvent& event) {
+    // Which buffer this thread writes to, claimed on its first contact. Keyed on the generation too,
+    // so threads don't carry a stale slot into another PhysicsSystem (or a re-initialized one).
+    struct ThreadSlot {
+        uint32_t generation = 0;
+        int index = -1;
+    };
+    thread_local ThreadSlot t_slot;
+    if (t_slot.generation != m_eventGeneration) {
+        t_slot.generation = m_eventGeneration;
+        t_slot.index = m_nextCollisionBuffer.fetch_add(1, std::memory_order_relaxed);
+    }
 
-        // Then safely remove and destroy the body
-        if (!bodyID.IsInvalid() && m_physicsSystem) {
-            JPH::BodyInterface& bodyInterface = m_physicsSystem->GetBodyInterface();
-            bodyInterface.RemoveBody(bodyID);
-            bodyInterface.DestroyBody(bodyID);
+    uint32_t capacity = m_config.maxCollisionEventsPerThread;
+    if (t_slot.index < static_cast<int>(m_collisionBuffers.size())) {
+        CollisionEventBuffer& buffer = m_collisionBuffers[t_slot.index];
+        if (buffer.count < capacity) {
+            buffer.events[buffer.count++] = event;
+            return;
+        }
+    } else {
+        uint32_t index = m_overflowCount.fetch_add(1, std::memory_order_relaxed);
+        if (index < capacity) {
+            m_overflowEvents[index] = event;
+            return;
         }
     }
+    m_droppedCollisionEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PhysicsSystem::ClearCollisionEvents() {
+    // Anything still here was never drained, it's stale once the bodies move again
+    for (CollisionEventBuffer& buffer : m_collisionBuffers) {
+        buffer.count = 0;
+    }
+    m_overflowCount.store(0, std::memory_order_relaxed);
+}
+
+void PhysicsSystem::DrainCollisionEvents(std::vector<CollisionEvent>& out) {
+    if (!m_initialized)
+        return;
+
+    // Step is over (the thread handoff or the join of Update orders the writes before this)
+    for (CollisionEventBuffer& buffer : m_collisionBuffers) {
+        out.insert(out.end(), buffer.events.get(), buffer.events.get() + buffer.count);
+        buffer.count = 0;
+    }
+
+    uint32_t overflow = std::min(m_overflowCount.exchange(0, std::memory_order_relaxed),
+                                 m_config.maxCollisionEventsPerThread);
+    out.insert(out.end(), m_overflowEvents.get(), m_overflowEvents.get() + overflow);
+
+    uint32_t dropped = m_droppedCollisionEvents.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        BS_WARN_F(LogCategory::PHYSICS, "Dropped %u collision events, raise PhysicsConfig::maxCollisionEventsPerThread",
+                  dropped);
+    }
+}
+
+JPH::BodyID PhysicsSystem::GetBodyIDFromEntityID(int entityId) const {
+    if (entityId < 0)
+        return JPH::BodyID();
+
+    // Full id stored per slot, so an older entity in the same slot doesn't match
+    uint32_t slot = EntitySystem::GetIdIndex(entityId);
+    if (slot < m_entityBodies.size() && m_entityBodies[slot].entityId == entityId) {
+        return m_entityBodies[slot].body;
+    }
+    return JPH::BodyID();  // Invalid body ID
+}
+
+int PhysicsSystem::GetEntityIDFromBodyID(const JPH::BodyID& bodyID) const {
+    if (bodyID.IsInvalid())
+        return -1;
+
+    uint32_t index = bodyID.GetIndex();
+    if (index >= m_bodyEntities.size())
+        return -1;
+
+    // Body indices get recycled too, the forward link has the sequence number to check against
+    int entityId = m_bodyEntities[index];
+    return (entityId >= 0 && GetBodyIDFromEntityID(entityId) == bodyID) ? entityId : -1;
+}
+
+void PhysicsSystem::MapEntityToBody(int entityId, JPH::BodyID bodyID) {
+    if (entityId < 0 || bodyID.IsInvalid())
+        return;
+
+    uint32_t slot = EntitySystem::GetIdIndex(entityId);
+    if (slot >= m_entityBodies.size()) {
+        m_entityBodies.resize(slot + 1);
+    }
+    m_entityBodies[slot] = {entityId, bodyID};
+
+    uint32_t index = bodyID.GetIndex();
+    if (index >= m_bodyEntities.size()) {
+        m_bodyEntities.resize(index + 1, -1);
+    }
+    m_bodyEntities[index] = entityId;
+}
+
+void PhysicsSystem::UnmapEntity(int entityId) {
+    // Mapping only - the body itself goes through RemovePhysicsBody, doing both here removed it twice
+    JPH::BodyID bodyID = GetBodyIDFromEntityID(entityId);
+    if (bodyID.IsInvalid())
+        return;
+
+    m_entityBodies[EntitySystem::GetIdIndex(entityId)] = EntityBodyLink{};
+    m_bodyEntities[bodyID.GetIndex()] = -1;
 }
 
 }  // namespace Blacksite
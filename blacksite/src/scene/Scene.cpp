@@ -1,6 +1,10 @@
 #include "blacksite/scene/Scene.h"
+#include <algorithm>
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/core/JobSystem.h"
 #include "blacksite/graphics/Renderer.h"
+#include "blacksite/math/TransformBatch.h"
 #include "blacksite/physics/PhysicsSystem.h"
 
 namespace Blacksite {
@@ -45,17 +49,28 @@ void Scene::Update(float deltaTime) {
     if (!m_active || !m_initialized)
         return;
 
-    // Update all entities
-    auto& entities = m_entitySystem->GetEntities();
-    for (auto& entity : entities) {
-        if (entity.active) {
-            entity.Update(deltaTime);
-        }
+    // Far away entities sit some frames out, see SimulationLod. Runs between physics steps, so it can
+    // put bodies to sleep right here.
+    const UpdateSchedule* schedule = nullptr;
+    if (m_simulationLodEnabled) {
+        const Camera& camera = m_cameraSystem->GetCamera();
+        m_simulationLod.Schedule(*m_entitySystem, m_physicsSystem, camera.GetPosition(), camera.GetFrustum(),
+                                 deltaTime);
+        schedule = &m_simulationLod.GetSchedule();
+    } else if (m_simulationLod.HasSleepingBodies()) {
+        m_simulationLod.Reset(*m_entitySystem, m_physicsSystem);
     }
 
+    // Update all entities, one pool (= concrete type) at a time - not alive list or id order. Removals
+    // from inside Update are deferred until every pool has run, so nothing gets skipped mid-pass.
+    m_entitySystem->UpdateEntities(deltaTime, schedule);
+
     // Sync physics to graphics
     SyncPhysicsToGraphics();
 
+    // Everything has moved for this frame, the index catches up before the callback can query it
+    m_spatialIndex.Update(*m_entitySystem);
+
     // Call user update callback
     if (m_updateCallback) {
         m_updateCallback(*this, deltaTime);
@@ -86,6 +101,9 @@ void Scene::Shutdown() {
 
     m_cameraSystem.reset();
     m_entitySystem.reset();
+    m_staticBatcher.Shutdown();  // Scenes go before the renderer, so the batch meshes can still be freed
+    m_spatialIndex.Clear();
+    m_simulationLod = SimulationLod();
 
     m_physicsSystem = nullptr;
     m_active = false;
@@ -98,42 +116,380 @@ void Scene::Clear() {
     if (m_entitySystem) {
         m_entitySystem->Clear();
     }
+    m_spatialIndex.Clear();
+}
+
+void Scene::SetSimulationImportance(int entityId, float importance) {
+    if (m_entitySystem) {
+        m_simulationLod.SetImportance(*m_entitySystem, entityId, importance);
+    }
 }
 
 void Scene::SyncPhysicsToGraphics() {
     if (!m_entitySystem || !m_physicsSystem)
         return;
 
-    for (auto& entity : m_entitySystem->GetEntities()) {
-        if (entity.hasPhysics && entity.active) {
-            entity.transform.position = m_physicsSystem->GetBodyPosition(entity.physicsBody);
-            entity.transform.rotation = m_physicsSystem->GetBodyRotation(entity.physicsBody);
-        }
-    }
+    BS_PROFILE_SCOPE("Scene::SyncPhysicsToGraphics");
+
+    // Nothing stepped this frame (fixed timestep, short frame) - syncing now would overwrite the
+    // previous poses with the current ones and kill the interpolation
+    if (m_physicsSystem->GetLastStepCount() == 0)
+        return;
+
+    // This is the handoff with threaded physics - the step has finished, and from here on the renderer only
+    // reads the transform array, so the bodies are free to step again while this frame draws.
+    // Only awake bodies get visited, straight into the transform array
+    m_physicsSystem->SyncActiveBodies(m_entitySystem->GetComponents());
+
+    // Contacts from the step, handed out in one go now that the transforms are current
+    m_collisionEvents.clear();
+    m_physicsSystem->DrainCollisionEvents(m_collisionEvents);
+    m_entitySystem->DispatchCollisions(m_collisionEvents);
 }
 
 void Scene::RenderEntities(Renderer* renderer) {
     if (!m_entitySystem || !renderer)
         return;
 
-    for (const auto& entity : m_entitySystem->GetEntities()) {
-        if (!entity.active)
+    BS_PROFILE_SCOPE("Scene::RenderEntities");
+
+    // Chunks are ranges of the alive list, not raw slots
+    size_t entityCount = m_entitySystem->GetAliveCount();
+
+    // Every chunk writes its own slice, so size these up front
+    if (m_boundsX.size() < entityCount) {
+        m_boundsX.resize(entityCount);
+        m_boundsY.resize(entityCount);
+        m_boundsZ.resize(entityCount);
+        m_boundsRadius.resize(entityCount);
+        m_visibility.resize(entityCount);
+        m_posePositions.resize(entityCount);
+        m_poseRotations.resize(entityCount);
+        m_poseScales.resize(entityCount);
+        m_modelMatrices.resize(entityCount);
+        m_poseState.resize(entityCount);
+        m_packedCommands.resize(entityCount);
+        m_packedSources.resize(entityCount);
+    }
+
+    // Physics runs at its own rate, blend dynamic bodies between their last two steps
+    m_interpolationAlpha = -1.0f;
+    if (m_physicsSystem && m_physicsSystem->IsFixedTimestep()) {
+        m_interpolationAlpha = m_physicsSystem->GetInterpolationAlpha();
+    }
+
+    // Before recording, so entities that just left a batch draw on their own this frame
+    m_staticBatcher.Update(renderer, *m_entitySystem);
+
+    if (renderer->IsShadowsEnabled()) {
+        SyncShadowCasters(renderer);
+    }
+
+    m_rebuiltMatrixCount.store(0, std::memory_order_relaxed);
+    Frustum frustum = renderer->GetCamera().GetFrustum();
+
+    // [1][1] is 1 / tan(fov / 2), turns radius / distance into a fraction of the half-height
+    m_lodCameraPosition = renderer->GetCamera().GetPosition();
+    m_lodProjectionScale = renderer->GetCamera().GetProjectionMatrix()[1][1];
+    const Frustum* cullFrustum = m_frustumCulling ? &frustum : nullptr;
+    const HiZBuffer* occlusion = m_occlusionCulling ? renderer->GetOcclusionBuffer() : nullptr;
+    m_occludedEntityCount.store(0, std::memory_order_relaxed);
+
+    // Small scenes: one buffer, this thread
+    JobSystem& pool = JobSystem::Get();
+    size_t chunkCount = entityCount < PARALLEL_RENDER_THRESHOLD ? (entityCount == 0 ? 0 : 1)
+                                                                : pool.GetChunkCount(entityCount, RENDER_CHUNK_SIZE);
+    if (m_commandBuffers.size() < chunkCount) {
+        m_commandBuffers.resize(chunkCount);
+    }
+    for (size_t i = 0; i < chunkCount; ++i) {
+        m_commandBuffers[i] = FrameVector<RenderCommand>();
+    }
+
+    if (chunkCount == 1) {
+        RecordEntityCommands(renderer, cullFrustum, occlusion, 0, entityCount, m_commandBuffers[0]);
+    } else if (chunkCount > 1) {
+        // Workers only cull and build matrices + sort keys, the GL side stays on this thread in Flush
+        pool.ParallelFor(entityCount, RENDER_CHUNK_SIZE, [&](size_t chunk, size_t begin, size_t end) {
+            RecordEntityCommands(renderer, cullFrustum, occlusion, begin, end, m_commandBuffers[chunk]);
+        });
+    }
+
+    // Merge - Flush sorts everything anyway, so order doesn't matter here
+    m_visibleEntityCount = 0;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        m_visibleEntityCount += m_commandBuffers[i].size();
+        renderer->SubmitPrebuilt(m_commandBuffers[i]);
+    }
+    m_staticBatcher.Submit(renderer, cullFrustum);
+}
+
+MeshHandle Scene::MeshForSlot(Renderer* renderer, uint32_t slot) {
+    // Loaded meshes resolve their name once, like the shaders. Each slot is in one render chunk only,
+    // so filling in the handle from a worker is fine.
+    RenderComponent& render = m_entitySystem->GetComponents().GetRender(slot);
+    switch (render.shape) {
+        case Entity::CUBE:
+            return renderer->GetCubeMesh();
+        case Entity::SPHERE:
+            return renderer->GetSphereMesh();
+        case Entity::PLANE:
+            return renderer->GetPlaneMesh();
+        case Entity::MESH:
+            if (!render.meshHandle.IsValid()) {
+                render.meshHandle = renderer->GetMeshHandle(m_entitySystem->GetEntities()[slot]->mesh);
+            }
+            return render.meshHandle;
+        default:
+            return MeshHandle{};
+    }
+}
+
+void Scene::SyncShadowCasters(Renderer* renderer) {
+    BS_PROFILE_SCOPE("Scene::SyncShadowCasters");
+
+    ComponentStore& components = m_entitySystem->GetComponents();
+    const auto& shadowDirty = components.GetShadowDirtyFlags();
+    uint32_t slotCount = static_cast<uint32_t>(components.Size());
+
+    // Someone else's static casters (or none yet) - start over, everything alive counts as static right away
+    if (renderer->GetShadowCasterOwner() != this) {
+        renderer->ClearStaticShadowCasters();
+        renderer->SetShadowCasterOwner(this);
+        m_shadowState.assign(slotCount, 0);
+        m_movingCasters.clear();
+
+        MeshHandle mesh;
+        glm::mat4 model;
+        float radius = 0.0f;
+        for (uint32_t slot : m_entitySystem->GetAliveSlots()) {
+            components.ClearShadowDirty(slot);
+            if (GetShadowCaster(renderer, slot, mesh, model, radius)) {
+                renderer->SetStaticShadowCaster(slot, mesh, model, radius);
+                m_shadowState[slot] = SHADOW_STATIC;
+            }
+        }
+    } else if (m_shadowState.size() < slotCount) {
+        m_shadowState.resize(slotCount, 0);
+    }
+
+    // Anything that moved (or left its slot) stops being static and gets watched until it settles
+    for (uint32_t slot = 0; slot < slotCount; ++slot) {
+        if (!shadowDirty[slot]) {
             continue;
+        }
+        components.ClearShadowDirty(slot);
+        uint8_t& state = m_shadowState[slot];
+        if (state == SHADOW_STATIC) {
+            renderer->RemoveStaticShadowCaster(slot);
+        }
+        if (state == 0 || state == SHADOW_STATIC) {
+            m_movingCasters.push_back(slot);
+        }
+        state = 1;
+    }
 
-        switch (entity.shape) {
-            case Entity::CUBE:
-                renderer->DrawCube(entity.transform, entity.shader, entity.color);
-                break;
-            case Entity::SPHERE:
-                renderer->DrawSphere(entity.transform, entity.shader, entity.color);
-                break;
-            case Entity::PLANE:
-                renderer->DrawPlane(entity.transform, entity.shader, entity.color);
-                break;
-            default:
+    // Still moving: a dynamic caster for this frame. Settled: into the static cache.
+    size_t i = 0;
+    while (i < m_movingCasters.size()) {
+        uint32_t slot = m_movingCasters[i];
+        uint8_t& state = m_shadowState[slot];
+        MeshHandle mesh;
+        glm::mat4 model;
+        float radius = 0.0f;
+        if (GetShadowCaster(renderer, slot, mesh, model, radius)) {
+            if (state < SHADOW_SETTLE_FRAMES) {
+                renderer->SubmitShadowCaster(mesh, model, radius);
+                state++;
+                ++i;
+                continue;
+            }
+            renderer->SetStaticShadowCaster(slot, mesh, model, radius);
+            state = SHADOW_STATIC;
+        } else {
+            state = 0;
+        }
+        m_movingCasters[i] = m_movingCasters.back();
+        m_movingCasters.pop_back();
+    }
+}
+
+bool Scene::GetShadowCaster(Renderer* renderer, uint32_t slot, MeshHandle& mesh, glm::mat4& model, float& radius) {
+    // Batched entities still cast on their own, the batch meshes aren't registered anywhere. The current
+    // pose is close enough, shadows don't need the render interpolation.
+    ComponentStore& components = m_entitySystem->GetComponents();
+    if (!components.IsActive(slot)) {
+        return false;
+    }
+    mesh = MeshForSlot(renderer, slot);
+    if (!mesh.IsValid()) {
+        return false;
+    }
+
+    const Transform& transform = components.GetTransform(slot);
+    glm::vec3 scale = glm::abs(transform.scale);
+    model = Renderer::CreateModelMatrix(transform);
+    radius = renderer->GetMeshBoundingRadius(mesh) * std::max(scale.x, std::max(scale.y, scale.z));
+    return true;
+}
+
+void Scene::RecordEntityCommands(Renderer* renderer, const Frustum* frustum, const HiZBuffer* occlusion,
+                                 size_t begin, size_t end, FrameVector<RenderCommand>& out) {
+    ComponentStore& components = m_entitySystem->GetComponents();
+    const auto& transforms = components.GetTransforms();
+    auto& render = components.GetRenderComponents();
+    const auto& activeFlags = components.GetActiveFlags();
+    const auto& previousPoses = components.GetPreviousPoses();
+    const auto& physics = components.GetPhysicsComponents();
+    const auto& alive = m_entitySystem->GetAliveSlots();
+    out.clear();
+    out.reserve(end - begin);
+
+    // Work out which entities need a new world matrix. Clean ones draw straight from the cache (most
+    // of a level is static), dirty and interpolated ones get their pose gathered for the batch build.
+    // Bodies mid-interpolation never go into the cache, the matrix is only good for this frame.
+    for (size_t i = begin; i < end; ++i) {
+        uint32_t slot = alive[i];
+        if (render[slot].staticBatched) {
+            m_poseState[i] = POSE_CACHED;  // Its batch draws it, nothing to build
+            continue;
+        }
+
+        const Transform& transform = transforms[slot];
+        const BodyPose& previous = previousPoses[slot];
+        bool interpolate = m_interpolationAlpha >= 0.0f && previous.valid && physics[slot].isDynamic &&
+                           (previous.position != transform.position || previous.orientation != transform.rotation);
+
+        if (interpolate) {
+            m_poseState[i] = POSE_INTERPOLATED;
+            m_posePositions[i] = glm::mix(previous.position, transform.position, m_interpolationAlpha);
+            m_poseRotations[i] = glm::slerp(previous.orientation, transform.rotation, m_interpolationAlpha);
+        } else if (components.IsTransformDirty(slot)) {
+            m_poseState[i] = POSE_DIRTY;
+            m_posePositions[i] = transform.position;
+            m_poseRotations[i] = transform.rotation;
+        } else {
+            m_poseState[i] = POSE_CACHED;
+            continue;
+        }
+        m_poseScales[i] = transform.scale;
+
+        // The meshes are built around their origin, so the sphere sits at the entity position and
+        // grows with the largest scale axis
+        glm::vec3 scale = glm::abs(transform.scale);
+        m_boundsRadius[i] = renderer->GetMeshBoundingRadius(MeshForSlot(renderer, slot)) *
+                            std::max(scale.x, std::max(scale.y, scale.z));
+    }
+
+    bool cull = frustum || occlusion;
+    if (cull) {
+        // World-space spheres for this slice, cached entities take theirs from the world cache
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 center;
+            if (m_poseState[i] == POSE_CACHED) {
+                uint32_t slot = alive[i];
+                center = glm::vec3(components.GetWorldMatrix(slot)[3]);
+                m_boundsRadius[i] = components.GetWorldRadius(slot);
+            } else {
+                center = m_posePositions[i];
+            }
+            m_boundsX[i] = center.x;
+            m_boundsY[i] = center.y;
+            m_boundsZ[i] = center.z;
+        }
+
+        if (frustum) {
+            frustum->CullSpheres(&m_boundsX[begin], &m_boundsY[begin], &m_boundsZ[begin], &m_boundsRadius[begin],
+                                 end - begin, &m_visibility[begin]);
+        } else {
+            std::fill(m_visibility.begin() + begin, m_visibility.begin() + end, uint8_t(1));
+        }
+
+        // Only what survived the frustum, the pyramid test is the more expensive one
+        if (occlusion) {
+            size_t occluded = occlusion->CullSpheres(&m_boundsX[begin], &m_boundsY[begin], &m_boundsZ[begin],
+                                                     &m_boundsRadius[begin], end - begin, &m_visibility[begin]);
+            m_occludedEntityCount.fetch_add(occluded, std::memory_order_relaxed);
+        }
+    }
+
+    // Commands for everything that survived. The poses that need a matrix get packed down to the
+    // front of the slice (never past i, so in place is fine) for the batch build.
+    size_t packed = begin;
+    for (size_t i = begin; i < end; ++i) {
+        uint32_t slot = alive[i];
+        if (!activeFlags[slot] || render[slot].staticBatched || (cull && !m_visibility[i]))
+            continue;
+
+        // Resolve the shader name once, after that it's just an index.
+        // The name is cold data, so this is the only place the loop reaches into the Entity.
+        RenderComponent& renderData = render[slot];
+        if (!renderData.shaderHandle.IsValid()) {
+            renderData.shaderHandle = renderer->GetShaderHandle(m_entitySystem->GetEntities()[slot]->shader);
+            if (!renderData.shaderHandle.IsValid())
+                continue;
+        }
+
+        RenderCommand cmd;
+        cmd.mesh = MeshForSlot(renderer, slot);
+        if (!cmd.mesh.IsValid()) {
+            // A mesh that isn't loaded (yet) just doesn't draw, anything else is a bug
+            if (renderData.shape != Entity::MESH) {
                 BS_ERROR(LogCategory::RENDERER, "Unknown entity shape");
-                break;
+            }
+            continue;
+        }
+
+        // Same lazy lookup for the texture. One that isn't loaded (yet) draws untextured.
+        if (renderData.hasTexture && !renderData.textureHandle.IsValid()) {
+            renderData.textureHandle = renderer->GetTextureHandle(m_entitySystem->GetEntities()[slot]->texture);
         }
+
+        cmd.shader = renderData.shaderHandle;
+        cmd.texture = renderData.textureHandle;
+        cmd.color = renderData.color;
+        cmd.entityId = static_cast<uint32_t>(m_entitySystem->GetSlotId(slot)) + 1;
+
+        bool cached = m_poseState[i] == POSE_CACHED;
+        if (m_lodEnabled) {
+            // Same bounding sphere the culling uses, cached entities keep theirs next to the world matrix
+            glm::vec3 center = cached ? glm::vec3(components.GetWorldMatrix(slot)[3]) : m_posePositions[i];
+            float radius = cached ? components.GetWorldRadius(slot) : m_boundsRadius[i];
+            float distance = std::max(glm::length(center - m_lodCameraPosition), 0.001f);
+            cmd.mesh = renderer->SelectLod(cmd.mesh, radius * m_lodProjectionScale / distance, renderData.lodLevel);
+        }
+
+        if (cached) {
+            cmd.model = components.GetWorldMatrix(slot);
+        } else {
+            m_posePositions[packed] = m_posePositions[i];
+            m_poseRotations[packed] = m_poseRotations[i];
+            m_poseScales[packed] = m_poseScales[i];
+            m_packedCommands[packed] = static_cast<uint32_t>(out.size());
+            m_packedSources[packed] = static_cast<uint32_t>(i);
+            packed++;
+        }
+        out.push_back(cmd);
+    }
+
+    // One SIMD pass over whatever moved, then write the static/settled ones back to the cache.
+    // Every slot belongs to exactly one chunk, so the cache writes don't race.
+    size_t count = packed - begin;
+    BuildModelMatrices(&m_posePositions[begin], &m_poseRotations[begin], &m_poseScales[begin], count,
+                       &m_modelMatrices[begin]);
+    for (size_t k = begin; k < packed; ++k) {
+        const glm::mat4& model = m_modelMatrices[k];
+        out[m_packedCommands[k]].model = model;
+
+        uint32_t source = m_packedSources[k];
+        if (m_poseState[source] == POSE_DIRTY) {
+            components.SetWorldCache(alive[source], model, m_boundsRadius[source]);
+        }
+    }
+    m_rebuiltMatrixCount.fetch_add(count, std::memory_order_relaxed);
+
+    for (RenderCommand& cmd : out) {
+        cmd.sortKey = renderer->BuildSortKey(cmd);  // Depth comes from the model matrix
     }
 }
 
@@ -163,15 +519,29 @@ int Scene::SpawnPlane(const glm::vec3& position, const glm::vec3& size, const st
     return m_entitySystem ? m_entitySystem->SpawnPlane(position, size, shader, color) : -1;
 }
 
+int Scene::SpawnMesh(const std::string& mesh, const glm::vec3& position, const std::string& shader,
+                     const glm::vec3& color) {
+    return m_entitySystem ? m_entitySystem->SpawnMesh(mesh, position, shader, color) : -1;
+}
+
 int Scene::SpawnEntity(Entity::VisualShape shape, const glm::vec3& position, const std::string& shader,
                        const glm::vec3& color) {
     return m_entitySystem ? m_entitySystem->SpawnEntity(shape, position, shader, color) : -1;
 }
 
+size_t Scene::SpawnBatch(const std::vector<glm::vec3>& positions, const std::vector<Entity::VisualShape>& shapes,
+                         const std::vector<glm::vec3>& colors, const std::string& shader, std::vector<int>* outIds) {
+    return m_entitySystem ? m_entitySystem->SpawnBatch(positions, shapes, colors, shader, outIds) : 0;
+}
+
 EntityHandle Scene::GetEntity(int id) {
     return EntityHandle(m_entitySystem.get(), m_physicsSystem, id);
 }
 
+EntityEditBatch Scene::EditEntities() {
+    return EntityEditBatch(m_entitySystem.get(), m_physicsSystem);
+}
+
 void Scene::RemoveEntity(int id) {
    m_entitySystem->RemoveEntity(id);
 }
@@ -0,0 +1,700 @@
+#include "blacksite/scene/SceneSerializer.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/MappedFile.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/scene/Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace Blacksite {
+
+namespace {
+
+// .bscn layout: this header, then each section at its offset (16-byte aligned), one record per entity
+// except colliders (entityPhysics points into them) and strings (the string table + its character blob).
+// Native endianness and plain floats, so the load loop is copies only.
+struct SceneFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entityCount;
+    uint32_t colliderCount;
+    uint32_t stringCount;
+    uint32_t stringBytes;
+    float cameraPosition[3];
+    float cameraTarget[3];
+    uint64_t entitiesOffset;
+    uint64_t transformsOffset;
+    uint64_t renderOffset;
+    uint64_t physicsOffset;
+    uint64_t collidersOffset;
+    uint64_t stringsOffset;
+    uint64_t stringDataOffset;
+};
+static_assert(sizeof(SceneFileHeader) == 104, "SceneFileHeader layout is part of the file format");
+
+struct SceneEntityRecord {
+    uint32_t name;  // String index, NO_STRING = default name
+    uint8_t flags;
+    uint8_t space;
+    uint16_t reserved;
+};
+static_assert(sizeof(SceneEntityRecord) == 8, "SceneEntityRecord layout is part of the file format");
+
+struct SceneTransformRecord {
+    float position[3];
+    float rotation[4];  // x, y, z, w - fixed here, whatever glm's own member order is
+    float scale[3];
+};
+static_assert(sizeof(SceneTransformRecord) == 40, "SceneTransformRecord layout is part of the file format");
+
+struct SceneRenderRecord {
+    float color[3];
+    uint32_t shape;
+    uint32_t shader;   // String index
+    uint32_t mesh;     // String index, NO_STRING unless shape is MESH
+    uint32_t texture;  // String index, NO_STRING = untextured. Not in version 1 files.
+};
+static_assert(sizeof(SceneRenderRecord) == 28, "SceneRenderRecord layout is part of the file format");
+constexpr size_t RENDER_RECORD_SIZE_V1 = offsetof(SceneRenderRecord, texture);
+
+struct ScenePhysicsRecord {
+    uint32_t firstCollider;
+    uint32_t colliderCount;
+    uint16_t layer;
+    uint16_t reserved;
+};
+static_assert(sizeof(ScenePhysicsRecord) == 12, "ScenePhysicsRecord layout is part of the file format");
+
+struct SceneColliderRecord {
+    uint32_t type;
+    float center[3];
+    float rotation[4];
+    float size[3];
+};
+static_assert(sizeof(SceneColliderRecord) == 44, "SceneColliderRecord layout is part of the file format");
+
+struct SceneStringRecord {
+    uint32_t offset;  // Into the character blob
+    uint32_t length;
+};
+
+constexpr char SCENE_MAGIC[4] = {'B', 'S', 'C', 'N'};
+constexpr uint32_t NO_STRING = 0xFFFFFFFF;
+constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+constexpr uint8_t FLAG_ACTIVE = 1 << 0;
+constexpr uint8_t FLAG_HAS_PHYSICS = 1 << 1;
+constexpr uint8_t FLAG_DYNAMIC = 1 << 2;
+
+uint64_t AlignSection(uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+size_t RenderRecordSize(uint32_t version) {
+    return version == 1 ? RENDER_RECORD_SIZE_V1 : sizeof(SceneRenderRecord);
+}
+
+// Version 1 records are the same minus the texture, so older files read as untextured
+SceneRenderRecord ReadRenderRecord(const uint8_t* section, uint32_t version, size_t index) {
+    SceneRenderRecord record;
+    record.texture = NO_STRING;
+    std::memcpy(&record, section + index * RenderRecordSize(version), RenderRecordSize(version));
+    return record;
+}
+
+// Shader and mesh names repeat a lot, entity names mostly don't - both go through here
+class StringTableBuilder {
+  public:
+    uint32_t Add(const std::string& text) {
+        auto it = m_lookup.find(text);
+        if (it != m_lookup.end()) {
+            return it->second;
+        }
+        uint32_t index = static_cast<uint32_t>(m_records.size());
+        m_records.push_back({static_cast<uint32_t>(m_data.size()), static_cast<uint32_t>(text.size())});
+        m_data.insert(m_data.end(), text.begin(), text.end());
+        m_lookup.emplace(text, index);
+        return index;
+    }
+
+    const std::vector<SceneStringRecord>& GetRecords() const { return m_records; }
+    const std::vector<char>& GetData() const { return m_data; }
+
+  private:
+    std::vector<SceneStringRecord> m_records;
+    std::vector<char> m_data;
+    std::unordered_map<std::string, uint32_t> m_lookup;
+};
+
+void WriteVec3(float* out, const glm::vec3& v) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+void WriteQuat(float* out, const glm::quat& q) {
+    out[0] = q.x;
+    out[1] = q.y;
+    out[2] = q.z;
+    out[3] = q.w;
+}
+
+glm::vec3 ReadVec3(const float* in) {
+    return glm::vec3(in[0], in[1], in[2]);
+}
+
+glm::quat ReadQuat(const float* in) {
+    return glm::quat(in[3], in[0], in[1], in[2]);
+}
+
+void ReadCollider(const SceneColliderRecord& record, Collider& collider) {
+    collider.type = static_cast<ColliderType>(record.type);
+    collider.center = ReadVec3(record.center);
+    collider.rotation = ReadQuat(record.rotation);
+    collider.size = ReadVec3(record.size);
+}
+
+// Everything in the file, gathered in entity order before anything is written
+struct SceneData {
+    SceneFileHeader header{};
+    std::vector<SceneEntityRecord> entities;
+    std::vector<SceneTransformRecord> transforms;
+    std::vector<SceneRenderRecord> render;
+    std::vector<ScenePhysicsRecord> physics;
+    std::vector<SceneColliderRecord> colliders;
+    StringTableBuilder strings;
+};
+
+void GatherEntity(const Entity* entity, SceneData& data) {
+    const Transform& transform = entity->GetTransform();
+    const RenderComponent& render = entity->GetRender();
+    const PhysicsComponent& physics = entity->GetPhysics();
+
+    SceneEntityRecord entityRecord{};
+    entityRecord.name = entity->name.empty() ? NO_STRING : data.strings.Add(entity->name);
+    entityRecord.flags = (entity->IsActive() ? FLAG_ACTIVE : 0) | (physics.hasPhysics ? FLAG_HAS_PHYSICS : 0) |
+                         (physics.isDynamic ? FLAG_DYNAMIC : 0);
+    entityRecord.space = static_cast<uint8_t>(entity->space);
+    data.entities.push_back(entityRecord);
+
+    SceneTransformRecord transformRecord{};
+    WriteVec3(transformRecord.position, transform.position);
+    WriteQuat(transformRecord.rotation, transform.rotation);
+    WriteVec3(transformRecord.scale, transform.scale);
+    data.transforms.push_back(transformRecord);
+
+    SceneRenderRecord renderRecord{};
+    WriteVec3(renderRecord.color, render.color);
+    renderRecord.shape = static_cast<uint32_t>(render.shape);
+    renderRecord.shader = data.strings.Add(entity->shader);
+    renderRecord.mesh = entity->mesh.empty() ? NO_STRING : data.strings.Add(entity->mesh);
+    renderRecord.texture = entity->texture.empty() ? NO_STRING : data.strings.Add(entity->texture);
+    data.render.push_back(renderRecord);
+
+    ScenePhysicsRecord physicsRecord{};
+    physicsRecord.firstCollider = static_cast<uint32_t>(data.colliders.size());
+    physicsRecord.colliderCount = static_cast<uint32_t>(entity->colliders.size());
+    physicsRecord.layer = physics.layer;
+    data.physics.push_back(physicsRecord);
+
+    for (const Collider& collider : entity->colliders) {
+        SceneColliderRecord colliderRecord{};
+        colliderRecord.type = static_cast<uint32_t>(collider.type);
+        WriteVec3(colliderRecord.center, collider.center);
+        WriteQuat(colliderRecord.rotation, collider.rotation);
+        WriteVec3(colliderRecord.size, collider.size);
+        data.colliders.push_back(colliderRecord);
+    }
+}
+
+// ids = null takes the whole scene
+void GatherScene(Scene& scene, SceneData& data, const std::vector<int>* ids) {
+    EntitySystem& entitySystem = *scene.GetEntitySystem();
+    size_t count = ids ? ids->size() : entitySystem.GetAliveCount();
+    data.entities.reserve(count);
+    data.transforms.reserve(count);
+    data.render.reserve(count);
+    data.physics.reserve(count);
+
+    if (ids) {
+        for (int id : *ids) {
+            if (const Entity* entity = entitySystem.GetEntityPtr(id)) {
+                GatherEntity(entity, data);
+            }
+        }
+    } else {
+        // Slot order rather than alive-list order, so saving an unchanged scene twice gives the same file
+        for (const Entity* entity : entitySystem.GetEntities()) {
+            if (entity) {
+                GatherEntity(entity, data);
+            }
+        }
+    }
+
+    SceneFileHeader& header = data.header;
+    std::memcpy(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC));
+    header.version = SceneSerializer::FORMAT_VERSION;
+    header.entityCount = static_cast<uint32_t>(data.entities.size());
+    header.colliderCount = static_cast<uint32_t>(data.colliders.size());
+    header.stringCount = static_cast<uint32_t>(data.strings.GetRecords().size());
+    header.stringBytes = static_cast<uint32_t>(data.strings.GetData().size());
+    WriteVec3(header.cameraPosition, scene.GetCameraPosition());
+    WriteVec3(header.cameraTarget, scene.GetCameraTarget());
+
+    uint64_t offset = AlignSection(sizeof(SceneFileHeader));
+    auto place = [&offset](uint64_t& sectionOffset, size_t bytes) {
+        sectionOffset = offset;
+        offset = AlignSection(offset + bytes);
+    };
+    place(header.entitiesOffset, data.entities.size() * sizeof(SceneEntityRecord));
+    place(header.transformsOffset, data.transforms.size() * sizeof(SceneTransformRecord));
+    place(header.renderOffset, data.render.size() * sizeof(SceneRenderRecord));
+    place(header.physicsOffset, data.physics.size() * sizeof(ScenePhysicsRecord));
+    place(header.collidersOffset, data.colliders.size() * sizeof(SceneColliderRecord));
+    place(header.stringsOffset, data.strings.GetRecords().size() * sizeof(SceneStringRecord));
+    place(header.stringDataOffset, data.strings.GetData().size());
+}
+
+// Every offset and count checked against the mapping, so the spawn loop can index without checks
+bool ValidateScene(const SceneFileHeader& header, size_t fileSize, const uint8_t* data) {
+    if (std::memcmp(header.magic, SCENE_MAGIC, sizeof(SCENE_MAGIC)) != 0 || header.version < 1 ||
+        header.version > SceneSerializer::FORMAT_VERSION) {
+        return false;
+    }
+
+    auto sectionFits = [fileSize](uint64_t offset, uint64_t count, uint64_t recordSize) {
+        return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize && count <= (fileSize - offset) / recordSize;
+    };
+    if (!sectionFits(header.entitiesOffset, header.entityCount, sizeof(SceneEntityRecord)) ||
+        !sectionFits(header.transformsOffset, header.entityCount, sizeof(SceneTransformRecord)) ||
+        !sectionFits(header.renderOffset, header.entityCount, RenderRecordSize(header.version)) ||
+        !sectionFits(header.physicsOffset, header.entityCount, sizeof(ScenePhysicsRecord)) ||
+        !sectionFits(header.collidersOffset, header.colliderCount, sizeof(SceneColliderRecord)) ||
+        !sectionFits(header.stringsOffset, header.stringCount, sizeof(SceneStringRecord)) ||
+        !sectionFits(header.stringDataOffset, header.stringBytes, 1)) {
+        return false;
+    }
+
+    const auto* strings = reinterpret_cast<const SceneStringRecord*>(data + header.stringsOffset);
+    for (uint32_t i = 0; i < header.stringCount; ++i) {
+        if (strings[i].offset > header.stringBytes || strings[i].length > header.stringBytes - strings[i].offset) {
+            return false;
+        }
+    }
+
+    auto validString = [&header](uint32_t index, bool optional) {
+        return index < header.stringCount || (optional && index == NO_STRING);
+    };
+    const auto* entities = reinterpret_cast<const SceneEntityRecord*>(data + header.entitiesOffset);
+    const auto* physics = reinterpret_cast<const ScenePhysicsRecord*>(data + header.physicsOffset);
+    for (uint32_t i = 0; i < header.entityCount; ++i) {
+        SceneRenderRecord render = ReadRenderRecord(data + header.renderOffset, header.version, i);
+        if (!validString(entities[i].name, true) || !validString(render.shader, false) ||
+            entities[i].space > static_cast<uint8_t>(Entity::Space::UISpace) ||
+            !validString(render.mesh, true) || !validString(render.texture, true) || render.shape > EntityShape::MESH ||
+            physics[i].firstCollider > header.colliderCount ||
+            physics[i].colliderCount > header.colliderCount - physics[i].firstCollider) {
+            return false;
+        }
+    }
+
+    const auto* colliders = reinterpret_cast<const SceneColliderRecord*>(data + header.collidersOffset);
+    for (uint32_t i = 0; i < header.colliderCount; ++i) {
+        if (colliders[i].type > static_cast<uint32_t>(ColliderType::Capsule)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WriteSection(std::ofstream& file, uint64_t offset, const void* data, size_t bytes) {
+    // Zero padding up to the section start
+    static const char padding[SECTION_ALIGNMENT] = {};
+    uint64_t position = static_cast<uint64_t>(file.tellp());
+    if (position < offset) {
+        file.write(padding, static_cast<std::streamsize>(offset - position));
+    }
+    if (bytes > 0) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    }
+    return static_cast<bool>(file);
+}
+
+void WriteJsonString(std::ofstream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+void WriteJsonFloats(std::ofstream& out, const float* values, int count) {
+    out << '[';
+    for (int i = 0; i < count; ++i) {
+        char number[32];
+        std::snprintf(number, sizeof(number), "%.9g", values[i]);  // Round-trips a float exactly
+        out << (i ? ", " : "") << number;
+    }
+    out << ']';
+}
+
+}  // namespace
+
+bool SceneSerializer::Save(Scene& scene, const std::string& path) {
+    return SaveEntities(scene, path, nullptr);
+}
+
+bool SceneSerializer::Save(Scene& scene, const std::string& path, const std::vector<int>& ids) {
+    return SaveEntities(scene, path, &ids);
+}
+
+bool SceneSerializer::SaveEntities(Scene& scene, const std::string& path, const std::vector<int>* ids) {
+    if (!scene.GetEntitySystem()) {
+        BS_ERROR(LogCategory::CORE, "SceneSerializer: Scene isn't initialized, nothing to save");
+        return false;
+    }
+
+    BS_PROFILE_SCOPE("SceneSerializer::Save");
+    SceneData data;
+    GatherScene(scene, data, ids);
+    const SceneFileHeader& header = data.header;
+
+    // Temp file + rename, so a crash mid-save never leaves a half-written scene where the old one was
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            BS_ERROR_F(LogCategory::CORE, "SceneSerializer: Can't write '%s'", tempPath.c_str());
+            return false;
+        }
+
+        const auto& strings = data.strings;
+        bool written =
+            WriteSection(file, 0, &header, sizeof(header)) &&
+            WriteSection(file, header.entitiesOffset, data.entities.data(),
+                         data.entities.size() * sizeof(SceneEntityRecord)) &&
+            WriteSection(file, header.transformsOffset, data.transforms.data(),
+                         data.transforms.size() * sizeof(SceneTransformRecord)) &&
+            WriteSection(file, header.renderOffset, data.render.data(), data.render.size() * sizeof(SceneRenderRecord)) &&
+            WriteSection(file, header.physicsOffset, data.physics.data(),
+                         data.physics.size() * sizeof(ScenePhysicsRecord)) &&
+            WriteSection(file, header.collidersOffset, data.colliders.data(),
+                         data.colliders.size() * sizeof(SceneColliderRecord)) &&
+            WriteSection(file, header.stringsOffset, strings.GetRecords().data(),
+                         strings.GetRecords().size() * sizeof(SceneStringRecord)) &&
+            WriteSection(file, header.stringDataOffset, strings.GetData().data(), strings.GetData().size());
+        if (!written) {
+            BS_ERROR_F(LogCategory::CORE, "SceneSerializer: Failed writing '%s'", tempPath.c_str());
+            file.close();
+            std::error_code ignored;
+            std::filesystem::remove(tempPath, ignored);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        BS_ERROR_F(LogCategory::CORE, "SceneSerializer: Can't move scene into place at '%s': %s", path.c_str(),
+                   error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    BS_INFO_F(LogCategory::CORE, "SceneSerializer: Saved %u entities to '%s'", header.entityCount, path.c_str());
+    return true;
+}
+
+bool SceneSerializer::Load(Scene& scene, const std::string& path) {
+    if (!scene.GetEntitySystem()) {
+        BS_ERROR(LogCategory::CORE, "SceneSerializer: Scene isn't initialized, can't load into it");
+        return false;
+    }
+
+    BS_PROFILE_SCOPE("SceneSerializer::Load");
+    auto start = std::chrono::steady_clock::now();
+
+    SceneFileReader reader;
+    if (!reader.Open(path)) {
+        return false;
+    }
+
+    size_t count = reader.GetEntityCount();
+    scene.Clear();
+    size_t spawned = reader.Spawn(scene, 0, count);
+    reader.ApplyCamera(scene);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    BS_INFO_F(LogCategory::CORE, "SceneSerializer: Loaded %zu of %zu entities from '%s' in %.1f ms", spawned, count,
+              path.c_str(), ms);
+    return spawned == count;
+}
+
+bool SceneSerializer::ExportJson(Scene& scene, const std::string& path) {
+    if (!scene.GetEntitySystem()) {
+        BS_ERROR(LogCategory::CORE, "SceneSerializer: Scene isn't initialized, nothing to export");
+        return false;
+    }
+
+    // Same records the binary writer produces, so the text shows exactly what a .bscn would hold
+    SceneData data;
+    GatherScene(scene, data, nullptr);
+    const auto& strings = data.strings.GetRecords();
+    const auto& stringData = data.strings.GetData();
+    auto stringAt = [&](uint32_t index) {
+        return index == NO_STRING ? std::string() : std::string(&stringData[strings[index].offset], strings[index].length);
+    };
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        BS_ERROR_F(LogCategory::CORE, "SceneSerializer: Can't write '%s'", path.c_str());
+        return false;
+    }
+
+    out << "{\n  \"version\": " << FORMAT_VERSION << ",\n  \"name\": ";
+    WriteJsonString(out, scene.GetName());
+    out << ",\n  \"camera\": {\"position\": ";
+    WriteJsonFloats(out, data.header.cameraPosition, 3);
+    out << ", \"target\": ";
+    WriteJsonFloats(out, data.header.cameraTarget, 3);
+    out << "},\n  \"entities\": [";
+
+    for (size_t i = 0; i < data.entities.size(); ++i) {
+        const SceneEntityRecord& entity = data.entities[i];
+        const SceneTransformRecord& transform = data.transforms[i];
+        const SceneRenderRecord& render = data.render[i];
+        const ScenePhysicsRecord& physics = data.physics[i];
+
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        WriteJsonString(out, stringAt(entity.name));
+        out << ", \"active\": " << ((entity.flags & FLAG_ACTIVE) ? "true" : "false");
+        out << ",\n     \"position\": ";
+        WriteJsonFloats(out, transform.position, 3);
+        out << ", \"rotation\": ";
+        WriteJsonFloats(out, transform.rotation, 4);
+        out << ", \"scale\": ";
+        WriteJsonFloats(out, transform.scale, 3);
+        out << ",\n     \"shape\": " << render.shape << ", \"shader\": ";
+        WriteJsonString(out, stringAt(render.shader));
+        out << ", \"mesh\": ";
+        WriteJsonString(out, stringAt(render.mesh));
+        out << ", \"texture\": ";
+        WriteJsonString(out, stringAt(render.texture));
+        out << ", \"color\": ";
+        WriteJsonFloats(out, render.color, 3);
+        out << ",\n     \"physics\": " << ((entity.flags & FLAG_HAS_PHYSICS) ? "true" : "false")
+            << ", \"dynamic\": " << ((entity.flags & FLAG_DYNAMIC) ? "true" : "false") << ", \"layer\": " << physics.layer
+            << ", \"colliders\": [";
+        for (uint32_t c = 0; c < physics.colliderCount; ++c) {
+            const SceneColliderRecord& collider = data.colliders[physics.firstCollider + c];
+            out << (c ? ", " : "") << "{\"type\": " << collider.type << ", \"center\": ";
+            WriteJsonFloats(out, collider.center, 3);
+            out << ", \"rotation\": ";
+            WriteJsonFloats(out, collider.rotation, 4);
+            out << ", \"size\": ";
+            WriteJsonFloats(out, collider.size, 3);
+            out << '}';
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+
+    if (!out) {
+        BS_ERROR_F(LogCategory::CORE, "SceneSerializer: Failed writing '%s'", path.c_str());
+        return false;
+    }
+    BS_INFO_F(LogCategory::CORE, "SceneSerializer: Exported %zu entities to '%s'", data.entities.size(), path.c_str());
+    return true;
+}
+
+bool SceneFileReader::Open(const std::string& path) {
+    BS_PROFILE_SCOPE("SceneFileReader::Open");
+    Close();
+
+    if (!m_file.Open(path, sizeof(SceneFileHeader))) {
+        BS_ERROR_F(LogCategory::CORE, "SceneSerializer: Can't open '%s'", path.c_str());
+        return false;
+    }
+
+    const uint8_t* data = m_file.Data();
+    SceneFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (!ValidateScene(header, m_file.Size(), data)) {
+        BS_ERROR_F(LogCategory::CORE, "SceneSerializer: '%s' isn't a version 1-%u scene or is damaged", path.c_str(),
+                   SceneSerializer::FORMAT_VERSION);
+        m_file.Close();
+        return false;
+    }
+
+    // Validation already read the string and record sections, this gets the rest off disk as well
+    constexpr size_t PAGE_STRIDE = 4096;
+    volatile uint8_t sink = 0;
+    for (size_t offset = 0; offset < m_file.Size(); offset += PAGE_STRIDE) {
+        sink = sink + data[offset];
+    }
+    return true;
+}
+
+void SceneFileReader::Close() {
+    m_file.Close();
+}
+
+size_t SceneFileReader::GetEntityCount() const {
+    if (!IsOpen()) {
+        return 0;
+    }
+    SceneFileHeader header;
+    std::memcpy(&header, m_file.Data(), sizeof(header));
+    return header.entityCount;
+}
+
+size_t SceneFileReader::Spawn(Scene& scene, size_t first, size_t count, std::vector<int>* outIds) const {
+    EntitySystem* entitySystem = scene.GetEntitySystem();
+    if (!IsOpen() || !entitySystem) {
+        return 0;
+    }
+
+    const uint8_t* data = m_file.Data();
+    SceneFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (first >= header.entityCount) {
+        return 0;
+    }
+    count = std::min<size_t>(count, header.entityCount - first);
+
+    // Sections are aligned in the file and the mapping is page-aligned, so these read in place
+    const auto* entities = reinterpret_cast<const SceneEntityRecord*>(data + header.entitiesOffset) + first;
+    const auto* transforms = reinterpret_cast<const SceneTransformRecord*>(data + header.transformsOffset) + first;
+    const uint8_t* renderSection = data + header.renderOffset;  // Record size depends on the version
+    const auto* physics = reinterpret_cast<const ScenePhysicsRecord*>(data + header.physicsOffset) + first;
+    const auto* colliders = reinterpret_cast<const SceneColliderRecord*>(data + header.collidersOffset);
+    const auto* strings = reinterpret_cast<const SceneStringRecord*>(data + header.stringsOffset);
+    const char* stringData = reinterpret_cast<const char*>(data + header.stringDataOffset);
+
+    auto assignString = [strings, stringData](std::string& out, uint32_t index) {
+        if (index == NO_STRING) {
+            out.clear();
+        } else {
+            out.assign(stringData + strings[index].offset, strings[index].length);
+        }
+    };
+
+    // Runs of entities with the same colliders (a wall of crates) share one list, like prefab instances
+    ColliderSet sharedColliders;
+    uint32_t sharedFirst = 0;
+    uint32_t sharedCount = 0;
+
+    return entitySystem->SpawnBatch(count, [&](size_t i, Entity& entity) {
+        SceneRenderRecord render = ReadRenderRecord(renderSection, header.version, first + i);
+        assignString(entity.name, entities[i].name);
+        assignString(entity.shader, render.shader);
+        assignString(entity.mesh, render.mesh);
+        entity.space = static_cast<Entity::Space>(entities[i].space);
+        entity.SetActive((entities[i].flags & FLAG_ACTIVE) != 0);
+
+        Transform& transform = entity.GetTransform();
+        transform.position = ReadVec3(transforms[i].position);
+        transform.rotation = ReadQuat(transforms[i].rotation);
+        transform.scale = ReadVec3(transforms[i].scale);
+
+        RenderComponent& renderComponent = entity.GetRender();
+        renderComponent.color = ReadVec3(render.color);
+        renderComponent.shape = static_cast<Entity::VisualShape>(render.shape);
+        if (render.texture != NO_STRING) {
+            std::string texture;
+            assignString(texture, render.texture);
+            entity.SetTexture(texture);
+        }
+
+        PhysicsComponent& physicsComponent = entity.GetPhysics();
+        physicsComponent.hasPhysics = (entities[i].flags & FLAG_HAS_PHYSICS) != 0;
+        physicsComponent.isDynamic = (entities[i].flags & FLAG_DYNAMIC) != 0;
+        physicsComponent.layer = physics[i].layer;
+
+        uint32_t first = physics[i].firstCollider;
+        uint32_t colliderCount = physics[i].colliderCount;
+        if (colliderCount == 0) {
+            return;
+        }
+        if (colliderCount != sharedCount ||
+            std::memcmp(&colliders[first], &colliders[sharedFirst], colliderCount * sizeof(SceneColliderRecord)) != 0) {
+            std::vector<Collider> list(colliderCount);
+            for (uint32_t c = 0; c < colliderCount; ++c) {
+                ReadCollider(colliders[first + c], list[c]);
+            }
+            sharedColliders = std::move(list);
+            sharedFirst = first;
+            sharedCount = colliderCount;
+        }
+        entity.colliders = sharedColliders;
+    }, outIds);
+}
+
+void SceneFileReader::ApplyCamera(Scene& scene) const {
+    if (!IsOpen()) {
+        return;
+    }
+    SceneFileHeader header;
+    std::memcpy(&header, m_file.Data(), sizeof(header));
+    scene.SetCameraPosition(ReadVec3(header.cameraPosition));
+    scene.SetCameraTarget(ReadVec3(header.cameraTarget));
+}
+
+bool SceneFileReader::ReadColliders(size_t index, std::vector<Collider>& colliders, glm::vec3& scale) const {
+    if (!IsOpen()) {
+        return false;
+    }
+
+    const uint8_t* data = m_file.Data();
+    SceneFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (index >= header.entityCount) {
+        return false;
+    }
+
+    const auto& entity = reinterpret_cast<const SceneEntityRecord*>(data + header.entitiesOffset)[index];
+    const auto& physics = reinterpret_cast<const ScenePhysicsRecord*>(data + header.physicsOffset)[index];
+    if (!(entity.flags & FLAG_HAS_PHYSICS) || physics.colliderCount == 0) {
+        return false;
+    }
+
+    const auto* records = reinterpret_cast<const SceneColliderRecord*>(data + header.collidersOffset);
+    colliders.resize(physics.colliderCount);
+    for (uint32_t c = 0; c < physics.colliderCount; ++c) {
+        ReadCollider(records[physics.firstCollider + c], colliders[c]);
+    }
+    scale = ReadVec3(reinterpret_cast<const SceneTransformRecord*>(data + header.transformsOffset)[index].scale);
+    return true;
+}
+
+}  // namespace Blacksite
@@ -1,10 +1,53 @@
 #include "blacksite/scene/SceneSystem.h"
 #include "blacksite/physics/PhysicsSystem.h"
 #include "blacksite/graphics/Renderer.h"
+#include "blacksite/core/JobSystem.h"
 #include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/scene/SceneSerializer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 namespace Blacksite {
 
+namespace {
+
+// Share of the progress bar the read job gets, spawning takes the rest
+constexpr float PREPARE_WEIGHT = 0.3f;
+// Entities per SpawnBatch call, the budget is checked between slices
+constexpr size_t SPAWN_SLICE = 256;
+
+}  // namespace
+
+struct SceneSystem::PendingLoad {
+    std::string sceneName;
+    std::string path;
+    LoadProgressCallback onProgress;
+    float budgetMs = 4.0f;
+
+    // Job side, the main thread only looks at these once 'prepared' is done
+    SceneFileReader reader;
+    std::vector<JPH::Ref<JPH::Shape>> shapes;  // Held so a cache prune can't drop them before the bodies exist
+    bool opened = false;
+    JobCounter prepared;
+    std::atomic<bool> cancelled{false};
+    std::atomic<float> prepareProgress{0.0f};
+
+    // Main thread side
+    size_t total = 0;
+    size_t spawned = 0;
+    bool cleared = false;
+    std::vector<JPH::BodyID> heldBodies;  // Kept out of the world until the switch, see FinishLoad
+
+    float GetProgress() const {
+        if (!prepared.IsDone())
+            return prepareProgress.load(std::memory_order_relaxed) * PREPARE_WEIGHT;
+        float spawnProgress = total ? static_cast<float>(spawned) / static_cast<float>(total) : 1.0f;
+        return PREPARE_WEIGHT + spawnProgress * (1.0f - PREPARE_WEIGHT);
+    }
+};
+
 SceneSystem::SceneSystem() = default;
 
 SceneSystem::~SceneSystem() {
@@ -42,6 +85,15 @@ bool SceneSystem::Initialize(PhysicsSystem* physicsSystem, Renderer* renderer, f
 void SceneSystem::Update(float deltaTime) {
     if (!m_initialized) return;
 
+    if (m_pendingLoad) {
+        StepLoad();
+    }
+
+    // Before the scene update, so new cells get their first tick this frame
+    if (m_streamer && m_activeScene && m_activeSceneName == m_streamingSceneName) {
+        m_streamer->Update();
+    }
+
     if (m_activeScene) {
         m_activeScene->Update(deltaTime);
     }
@@ -54,6 +106,9 @@ void SceneSystem::Render() {
 
     if (m_activeScene) {
         m_activeScene->Render(m_renderer);
+        if (m_renderer->GetShowColliders()) {
+            m_renderer->DrawColliders(m_activeScene->GetEntitySystem()->GetEntities());
+        }
     }
 
     m_renderer->EndFrame();
@@ -64,6 +119,9 @@ void SceneSystem::Shutdown() {
 
     BS_INFO(LogCategory::CORE, "Shutting down SceneSystem...");
 
+    CancelLoad();
+    DisableWorldStreaming();
+
     UnloadAllScenes();
     m_scenes.clear();
 
@@ -101,6 +159,13 @@ bool SceneSystem::RemoveScene(const std::string& name) {
         return false;
     }
 
+    if (m_pendingLoad && m_pendingLoad->sceneName == name) {
+        CancelLoad();
+    }
+    if (m_streamer && m_streamingSceneName == name) {
+        DisableWorldStreaming();
+    }
+
     // If this is the active scene, deactivate it
     if (m_activeScene == it->second.get()) {
         UnloadScene(name);
@@ -206,6 +271,208 @@ bool SceneSystem::SwitchToScene(const std::string& name) {
     return true;
 }
 
+bool SceneSystem::LoadSceneAsync(const std::string& name, const std::string& path, LoadProgressCallback onProgress,
+                                 float budgetMs) {
+    if (!m_initialized) {
+        BS_ERROR(LogCategory::CORE, "SceneSystem not initialized, can't load scenes");
+        return false;
+    }
+    if (m_pendingLoad) {
+        BS_ERROR_F(LogCategory::CORE, "Can't load '%s', scene '%s' is still loading", name.c_str(),
+                   m_pendingLoad->sceneName.c_str());
+        return false;
+    }
+
+    Scene* scene = GetScene(name);
+    if (!scene) {
+        if (!CreateScene(name))
+            return false;
+    } else if (scene == m_activeScene) {
+        BS_ERROR_F(LogCategory::CORE, "Scene '%s' is active, load it synchronously or switch away first",
+                   name.c_str());
+        return false;
+    } else if (!scene->IsInitialized() && !scene->Initialize(m_physicsSystem, m_aspectRatio)) {
+        BS_ERROR_F(LogCategory::CORE, "Failed to initialize scene '%s'", name.c_str());
+        return false;
+    }
+
+    m_pendingLoad = std::make_unique<PendingLoad>();
+    PendingLoad* load = m_pendingLoad.get();
+    load->sceneName = name;
+    load->path = path;
+    load->onProgress = std::move(onProgress);
+    load->budgetMs = std::max(budgetMs, 0.0f);
+
+    // Everything here only reads the file or goes through the shape cache, which takes its own lock.
+    // The file read blocks one job worker for a moment, the rest of the pool carries on.
+    PhysicsSystem* physics = m_physicsSystem;
+    JobSystem::Get().Run([load, physics]() {
+        BS_PROFILE_SCOPE("SceneSystem::PrepareLoad");
+        load->opened = load->reader.Open(load->path);
+        if (load->opened) {
+            size_t count = load->reader.GetEntityCount();
+            std::vector<Collider> colliders;
+            glm::vec3 scale(1.0f);
+            for (size_t i = 0; i < count && !load->cancelled.load(std::memory_order_relaxed); ++i) {
+                if (load->reader.ReadColliders(i, colliders, scale)) {
+                    JPH::Ref<JPH::Shape> shape = physics->GetOrCreateShape(colliders, scale);
+                    // Most scenes repeat a handful of shapes, only keep a ref when it changes
+                    if (shape && (load->shapes.empty() || load->shapes.back() != shape)) {
+                        load->shapes.push_back(std::move(shape));
+                    }
+                }
+                if ((i & 1023) == 0) {
+                    load->prepareProgress.store(static_cast<float>(i) / static_cast<float>(count),
+                                                std::memory_order_relaxed);
+                }
+            }
+        }
+        load->prepareProgress.store(1.0f, std::memory_order_relaxed);
+    }, &load->prepared);
+
+    BS_INFO_F(LogCategory::CORE, "Loading scene '%s' from '%s' in the background", name.c_str(), path.c_str());
+    return true;
+}
+
+float SceneSystem::GetLoadProgress() const {
+    return m_pendingLoad ? m_pendingLoad->GetProgress() : 0.0f;
+}
+
+void SceneSystem::CancelLoad() {
+    if (!m_pendingLoad)
+        return;
+
+    m_pendingLoad->cancelled.store(true, std::memory_order_relaxed);
+    JobSystem::Get().Wait(m_pendingLoad->prepared);
+
+    if (m_pendingLoad->cleared) {
+        if (Scene* scene = GetScene(m_pendingLoad->sceneName)) {
+            scene->Clear();
+        }
+    }
+
+    BS_INFO_F(LogCategory::CORE, "Loading scene '%s' cancelled", m_pendingLoad->sceneName.c_str());
+    m_pendingLoad.reset();
+}
+
+void SceneSystem::StepLoad() {
+    PendingLoad& load = *m_pendingLoad;
+    if (!load.prepared.IsDone()) {
+        if (load.onProgress) {
+            load.onProgress(load.GetProgress(), false, false);
+        }
+        return;
+    }
+
+    if (!load.opened) {
+        FinishLoad(false);
+        return;
+    }
+    load.total = load.reader.GetEntityCount();
+
+    Scene* scene = GetScene(load.sceneName);
+    if (!scene) {
+        FinishLoad(false);
+        return;
+    }
+
+    BS_PROFILE_SCOPE("SceneSystem::StepLoad");
+    if (!load.cleared) {
+        scene->Clear();
+        load.cleared = true;
+    }
+
+    // At least one slice per frame so a zero budget still gets there
+    auto start = std::chrono::steady_clock::now();
+    while (load.spawned < load.total) {
+        size_t count = std::min(SPAWN_SLICE, load.total - load.spawned);
+        // The bodies exist right away but stay out of the running world, or both levels would collide
+        if (m_physicsSystem) {
+            m_physicsSystem->BeginHoldingBodies(&load.heldBodies);
+        }
+        size_t created = load.reader.Spawn(*scene, load.spawned, count);
+        if (m_physicsSystem) {
+            m_physicsSystem->EndHoldingBodies();
+        }
+        if (created != count) {
+            BS_ERROR_F(LogCategory::CORE, "Scene '%s': only %zu of %zu entities spawned", load.sceneName.c_str(),
+                       load.spawned + created, load.total);
+            FinishLoad(false);
+            return;
+        }
+        load.spawned += count;
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ms >= load.budgetMs)
+            break;
+    }
+
+    if (load.spawned < load.total) {
+        if (load.onProgress) {
+            load.onProgress(load.GetProgress(), false, false);
+        }
+        return;
+    }
+
+    load.reader.ApplyCamera(*scene);
+    FinishLoad(SwitchToScene(load.sceneName));
+}
+
+void SceneSystem::FinishLoad(bool success) {
+    // Moved out first, the callback is free to start the next load
+    std::unique_ptr<PendingLoad> load = std::move(m_pendingLoad);
+    JobSystem::Get().Wait(load->prepared);
+
+    if (success) {
+        if (m_physicsSystem) {
+            m_physicsSystem->AddHeldBodies(load->heldBodies);  // Go in with the next step
+        }
+        BS_INFO_F(LogCategory::CORE, "Scene '%s' loaded, %zu entities", load->sceneName.c_str(), load->spawned);
+    } else {
+        BS_ERROR_F(LogCategory::CORE, "Loading scene '%s' from '%s' failed", load->sceneName.c_str(),
+                   load->path.c_str());
+        Scene* scene = GetScene(load->sceneName);
+        if (load->cleared && scene && scene != m_activeScene) {
+            scene->Clear();  // No half-loaded scenes left behind
+        }
+    }
+
+    if (load->onProgress) {
+        load->onProgress(success ? 1.0f : load->GetProgress(), true, success);
+    }
+}
+
+WorldStreamer* SceneSystem::EnableWorldStreaming(const std::string& name, const WorldStreamingConfig& config) {
+    Scene* scene = GetScene(name);
+    if (!m_initialized || !scene) {
+        BS_ERROR_F(LogCategory::CORE, "Can't stream into scene '%s', it doesn't exist", name.c_str());
+        return nullptr;
+    }
+    if (!scene->IsInitialized() && !scene->Initialize(m_physicsSystem, m_aspectRatio)) {
+        BS_ERROR_F(LogCategory::CORE, "Failed to initialize scene '%s'", name.c_str());
+        return nullptr;
+    }
+
+    DisableWorldStreaming();
+    auto streamer = std::make_unique<WorldStreamer>();
+    if (!streamer->Initialize(scene, m_physicsSystem, config))
+        return nullptr;
+
+    m_streamer = std::move(streamer);
+    m_streamingSceneName = name;
+    BS_INFO_F(LogCategory::CORE, "World streaming enabled for scene '%s'", name.c_str());
+    return m_streamer.get();
+}
+
+void SceneSystem::DisableWorldStreaming() {
+    if (!m_streamer)
+        return;
+
+    m_streamer.reset();  // Shuts down, taking the streamed entities with it
+    BS_INFO_F(LogCategory::CORE, "World streaming disabled for scene '%s'", m_streamingSceneName.c_str());
+    m_streamingSceneName.clear();
+}
+
 Scene* SceneSystem::GetScene(const std::string& name) {
     auto it = m_scenes.find(name);
     return (it != m_scenes.end()) ? it->second.get() : nullptr;
@@ -241,6 +508,10 @@ EntityHandle SceneSystem::GetEntity(int id) {
     return m_activeScene ? m_activeScene->GetEntity(id) : EntityHandle(nullptr, nullptr, -1);
 }
 
+EntityEditBatch SceneSystem::EditEntities() {
+    return m_activeScene ? m_activeScene->EditEntities() : EntityEditBatch(nullptr, nullptr);
+}
+
 void SceneSystem::SetCameraPosition(const glm::vec3& position) {
     if (m_activeScene) m_activeScene->SetCameraPosition(position);
 }
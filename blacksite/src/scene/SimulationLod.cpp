@@ -0,0 +1,146 @@
+#include "blacksite/scene/SimulationLod.h"
+#include <algorithm>
+#include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/Frustum.h"
+#include "blacksite/physics/PhysicsSystem.h"
+
+namespace Blacksite {
+
+void SimulationLod::SetSettings(const SimulationLodSettings& settings) {
+    m_settings = settings;
+    for (int& interval : m_settings.tierIntervals) {
+        interval = std::max(interval, 1);
+    }
+}
+
+void SimulationLod::SetImportance(const EntitySystem& entities, int id, float importance) {
+    if (!entities.IsAlive(id)) {
+        return;
+    }
+    uint32_t slot = EntitySystem::GetIdIndex(id);
+    if (m_slots.size() <= slot) {
+        m_slots.resize(slot + 1);
+    }
+    GetSlot(entities, slot).importance = std::max(importance, 0.0f);
+}
+
+void SimulationLod::Schedule(EntitySystem& entities, PhysicsSystem* physics, const glm::vec3& cameraPosition,
+                             const Frustum& view, float deltaTime) {
+    BS_PROFILE_SCOPE("SimulationLod::Schedule");
+    m_stats = SimulationLodStats{};
+
+    const ComponentStore& components = entities.GetComponents();
+    const auto& transforms = components.GetTransforms();
+    const auto& bodies = components.GetPhysicsComponents();
+    size_t slotCount = components.Size();
+    if (m_slots.size() < slotCount) {
+        m_slots.resize(slotCount);
+    }
+
+    // Free slots (and whatever an Update spawns into them) run this frame with the frame's time
+    m_due.assign(slotCount, 1);
+    m_deltaTimes.assign(slotCount, deltaTime);
+    m_toSleep.clear();
+    m_toWake.clear();
+    m_sleepingCount = 0;
+
+    const int lastTier = SimulationLodSettings::MAX_TIERS - 1;
+    for (uint32_t slot : entities.GetAliveSlots()) {
+        SlotState& state = GetSlot(entities, slot);
+        if (!components.IsActive(slot)) {
+            state.accumulated = 0.0f;  // Doesn't update anyway, and shouldn't come back with a huge step
+            continue;
+        }
+
+        float distance = glm::length(transforms[slot].position - cameraPosition);
+        int tier = state.importance > 0.0f ? GetTier(distance / state.importance) : lastTier;
+        m_stats.tierCounts[tier]++;
+
+        // Staggered by slot, so a tier's entities come due a few at a time rather than all on one frame
+        state.accumulated += deltaTime;
+        uint64_t interval = static_cast<uint64_t>(m_settings.tierIntervals[tier]);
+        if ((m_frame + slot) % interval != 0) {
+            m_due[slot] = 0;
+            m_stats.skipped++;
+            if (state.sleeping) {
+                m_sleepingCount++;
+            }
+            continue;
+        }
+        m_deltaTimes[slot] = state.accumulated;
+        state.accumulated = 0.0f;
+        m_stats.updated++;
+
+        // Sleeping is decided on the entity's own update frames, which spreads those checks out as well
+        const PhysicsComponent& body = bodies[slot];
+        if (physics && body.hasPhysics && body.isDynamic && !body.body.IsInvalid()) {
+            float radius = std::max(components.GetWorldRadius(slot), 1.0f);  // 0 until it has been drawn
+            bool hidden = m_settings.sleepOffscreenBodies && tier == lastTier &&
+                          !view.IntersectsSphere(transforms[slot].position, radius);
+            if (hidden && !state.sleeping) {
+                m_toSleep.push_back(body.body);
+                state.sleeping = true;
+            } else if (!hidden && state.sleeping) {
+                m_toWake.push_back(body.body);
+                state.sleeping = false;
+            }
+        }
+        if (state.sleeping) {
+            m_sleepingCount++;
+        }
+    }
+
+    if (physics) {
+        physics->SetBodiesSleeping(m_toSleep, true);
+        physics->SetBodiesSleeping(m_toWake, false);
+    }
+    m_stats.sleepingBodies = m_sleepingCount;
+
+    m_schedule.due = m_due.data();
+    m_schedule.deltaTimes = m_deltaTimes.data();
+    m_schedule.size = slotCount;
+    m_frame++;
+}
+
+void SimulationLod::Reset(EntitySystem& entities, PhysicsSystem* physics) {
+    const auto& bodies = entities.GetComponents().GetPhysicsComponents();
+    m_toWake.clear();
+    for (uint32_t slot : entities.GetAliveSlots()) {
+        if (slot >= m_slots.size()) {
+            continue;
+        }
+        SlotState& state = GetSlot(entities, slot);
+        if (state.sleeping && bodies[slot].hasPhysics && !bodies[slot].body.IsInvalid()) {
+            m_toWake.push_back(bodies[slot].body);
+        }
+        state.sleeping = false;
+        state.accumulated = 0.0f;
+    }
+    if (physics) {
+        physics->SetBodiesSleeping(m_toWake, false);
+    }
+    m_sleepingCount = 0;
+    m_stats = SimulationLodStats{};
+}
+
+SimulationLod::SlotState& SimulationLod::GetSlot(const EntitySystem& entities, uint32_t slot) {
+    SlotState& state = m_slots[slot];
+    int id = entities.GetSlotId(slot);
+    if (state.id != id) {
+        state = SlotState{};  // Someone new, whatever the last one had doesn't carry over
+        state.id = id;
+    }
+    return state;
+}
+
+int SimulationLod::GetTier(float distance) const {
+    for (int i = 0; i < SimulationLodSettings::MAX_TIERS - 1; ++i) {
+        if (distance < m_settings.tierDistances[i]) {
+            return i;
+        }
+    }
+    return SimulationLodSettings::MAX_TIERS - 1;
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,286 @@
+#include "blacksite/scene/SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/graphics/Frustum.h"
+
+namespace Blacksite {
+
+namespace {
+
+constexpr int KEY_BITS = 21;  // Per axis, signed - +-1M cells
+constexpr uint64_t KEY_MASK = (1ull << KEY_BITS) - 1;
+
+// Bounding radius of the built-in meshes at scale 1, for entities the renderer hasn't measured yet
+float ShapeRadius(EntityShape::VisualShape shape) {
+    switch (shape) {
+        case EntityShape::CUBE:
+            return 0.866f;  // Half the diagonal of the unit cube
+        case EntityShape::SPHERE:
+            return 0.5f;
+        case EntityShape::PLANE:
+            return 0.7072f;  // Flat unit square
+        default:
+            return 1.0f;  // Loaded mesh, a guess until the first draw
+    }
+}
+
+float MaxScale(const glm::vec3& scale) {
+    glm::vec3 s = glm::abs(scale);
+    return std::max(s.x, std::max(s.y, s.z));
+}
+
+// Sphere vs box, squared distance from the center to the closest point of the box
+bool SphereTouchesBox(const glm::vec3& center, float radius, const glm::vec3& min, const glm::vec3& max) {
+    glm::vec3 closest = glm::clamp(center, min, max);
+    glm::vec3 d = center - closest;
+    return glm::dot(d, d) <= radius * radius;
+}
+
+}  // namespace
+
+void SpatialIndex::Update(EntitySystem& entities) {
+    BS_PROFILE_SCOPE("SpatialIndex::Update");
+
+    ComponentStore& components = entities.GetComponents();
+    const auto& pointers = entities.GetEntities();
+    const auto& active = components.GetActiveFlags();
+    const auto& transforms = components.GetTransforms();
+    size_t slotCount = std::min(components.Size(), pointers.size());
+
+    // Store got cleared or the cell size changed - start from scratch, every slot comes in as new
+    if (m_rebuild || slotCount < m_entries.size()) {
+        Clear();
+        m_rebuild = false;
+    }
+    if (m_entries.size() < slotCount) {
+        m_entries.resize(slotCount);
+    }
+
+    for (uint32_t slot = 0; slot < slotCount; ++slot) {
+        Entry& entry = m_entries[slot];
+        if (!pointers[slot] || !active[slot]) {
+            if (entry.indexed) {
+                Remove(slot);
+            }
+            continue;
+        }
+        // Unmeasured ones go in with the shape estimate and come back once the render cache has a radius,
+        // SetWorldCache marks them again when it does
+        if (entry.indexed && !components.IsSpatialDirty(slot)) {
+            continue;
+        }
+        components.ClearSpatialDirty(slot);
+
+        // A reused slot is a different entity, nothing learned about the old one applies
+        int id = entities.GetSlotId(slot);
+        if (id != entry.id) {
+            entry.localRadius = 0.0f;
+            entry.id = id;
+        }
+
+        // The render cache's radius is exact but only current while the transform is clean. Learn the
+        // unscaled radius from it, so entities that keep moving get close to the real thing too.
+        const Transform& transform = transforms[slot];
+        float scale = MaxScale(transform.scale);
+        if (entry.localRadius == 0.0f && !components.IsTransformDirty(slot) &&
+            components.GetWorldRadius(slot) > 0.0f && scale > 0.0f) {
+            entry.localRadius = components.GetWorldRadius(slot) / scale;
+        }
+        float local = entry.localRadius > 0.0f ? entry.localRadius
+                                               : ShapeRadius(components.GetRender(slot).shape);
+
+        glm::vec3 center = transform.position;
+        float radius = local * scale;
+        bool large = radius > m_cellSize * 0.5f;
+        if (entry.indexed) {
+            // Most moves stay in the same cell, only the bounds change then
+            if (large == entry.large && (large || CellKey(CellOf(center)) == entry.cell)) {
+                entry.center = center;
+                entry.radius = radius;
+                continue;
+            }
+            Remove(slot);
+        }
+        entry.center = center;
+        entry.radius = radius;
+        Insert(slot);
+    }
+}
+
+void SpatialIndex::Clear() {
+    m_entries.clear();
+    m_cells.clear();
+    m_large.clear();
+    m_entityCount = 0;
+}
+
+void SpatialIndex::SetCellSize(float cellSize) {
+    if (cellSize > 0.0f && cellSize != m_cellSize) {
+        m_cellSize = cellSize;
+        m_rebuild = true;
+    }
+}
+
+void SpatialIndex::Insert(uint32_t slot) {
+    Entry& entry = m_entries[slot];
+    entry.large = entry.radius > m_cellSize * 0.5f;
+    if (entry.large) {
+        entry.position = static_cast<uint32_t>(m_large.size());
+        m_large.push_back(slot);
+    } else {
+        entry.cell = CellKey(CellOf(entry.center));
+        std::vector<uint32_t>& cell = m_cells[entry.cell];
+        entry.position = static_cast<uint32_t>(cell.size());
+        cell.push_back(slot);
+    }
+    entry.indexed = true;
+    ++m_entityCount;
+}
+
+void SpatialIndex::Remove(uint32_t slot) {
+    Entry& entry = m_entries[slot];
+
+    // Swap with the last one in the list, it takes over our position
+    auto removeFrom = [&](std::vector<uint32_t>& list) {
+        uint32_t last = list.back();
+        list[entry.position] = last;
+        m_entries[last].position = entry.position;
+        list.pop_back();
+    };
+
+    if (entry.large) {
+        removeFrom(m_large);
+    } else {
+        auto it = m_cells.find(entry.cell);
+        removeFrom(it->second);
+        if (it->second.empty()) {
+            m_cells.erase(it);
+        }
+    }
+    entry.indexed = false;
+    --m_entityCount;
+}
+
+glm::ivec3 SpatialIndex::CellOf(const glm::vec3& position) const {
+    return glm::ivec3(glm::floor(position / m_cellSize));
+}
+
+uint64_t SpatialIndex::CellKey(const glm::ivec3& cell) {
+    return ((static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) & KEY_MASK) << (2 * KEY_BITS)) |
+           ((static_cast<uint64_t>(static_cast<uint32_t>(cell.y)) & KEY_MASK) << KEY_BITS) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(cell.z)) & KEY_MASK);
+}
+
+glm::ivec3 SpatialIndex::CellFromKey(uint64_t key) {
+    // Back from 21 bits to a signed int, the top bit of each field is the sign
+    auto unpack = [](uint64_t bits) {
+        int value = static_cast<int>(bits & KEY_MASK);
+        return value >= (1 << (KEY_BITS - 1)) ? value - (1 << KEY_BITS) : value;
+    };
+    return glm::ivec3(unpack(key >> (2 * KEY_BITS)), unpack(key >> KEY_BITS), unpack(key));
+}
+
+template<typename Fn>
+void SpatialIndex::ForEachCandidate(const glm::vec3& min, const glm::vec3& max, Fn&& fn) const {
+    for (uint32_t slot : m_large) {
+        fn(m_entries[slot]);
+    }
+    if (m_cells.empty()) {
+        return;
+    }
+
+    // Cell entries hang over their cell by up to half a cell
+    glm::vec3 slack(m_cellSize * 0.5f);
+    glm::ivec3 first = CellOf(min - slack);
+    glm::ivec3 last = CellOf(max + slack);
+    double span = (double(last.x) - first.x + 1.0) * (double(last.y) - first.y + 1.0) *
+                  (double(last.z) - first.z + 1.0);
+
+    // A query that covers more cells than exist is cheaper as a walk over the occupied ones
+    if (span > static_cast<double>(m_cells.size())) {
+        for (const auto& [key, slots] : m_cells) {
+            glm::ivec3 cell = CellFromKey(key);
+            if (cell.x >= first.x && cell.y >= first.y && cell.z >= first.z && cell.x <= last.x &&
+                cell.y <= last.y && cell.z <= last.z) {
+                for (uint32_t slot : slots) {
+                    fn(m_entries[slot]);
+                }
+            }
+        }
+        return;
+    }
+
+    for (int x = first.x; x <= last.x; ++x) {
+        for (int y = first.y; y <= last.y; ++y) {
+            for (int z = first.z; z <= last.z; ++z) {
+                auto it = m_cells.find(CellKey(glm::ivec3(x, y, z)));
+                if (it == m_cells.end()) {
+                    continue;
+                }
+                for (uint32_t slot : it->second) {
+                    fn(m_entries[slot]);
+                }
+            }
+        }
+    }
+}
+
+void SpatialIndex::QuerySphere(const glm::vec3& center, float radius, std::vector<int>& out) const {
+    ForEachCandidate(center - radius, center + radius, [&](const Entry& entry) {
+        glm::vec3 d = entry.center - center;
+        float reach = entry.radius + radius;
+        if (glm::dot(d, d) <= reach * reach) {
+            out.push_back(entry.id);
+        }
+    });
+}
+
+void SpatialIndex::QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<int>& out) const {
+    ForEachCandidate(min, max, [&](const Entry& entry) {
+        if (SphereTouchesBox(entry.center, entry.radius, min, max)) {
+            out.push_back(entry.id);
+        }
+    });
+}
+
+void SpatialIndex::QueryFrustum(const Frustum& frustum, std::vector<int>& out) const {
+    // No box to narrow it down to, so every occupied cell - the cull per entry is still the cheap part
+    for (uint32_t slot : m_large) {
+        if (frustum.IntersectsSphere(m_entries[slot].center, m_entries[slot].radius)) {
+            out.push_back(m_entries[slot].id);
+        }
+    }
+
+    glm::vec3 half(m_cellSize * 0.5f);
+    float cellRadius = glm::length(half) + m_cellSize * 0.5f;  // Cell bounds plus the loose overhang
+    for (const auto& [key, slots] : m_cells) {
+        glm::vec3 cellCenter = (glm::vec3(CellFromKey(key)) + 0.5f) * m_cellSize;
+        if (!frustum.IntersectsSphere(cellCenter, cellRadius)) {
+            continue;
+        }
+        for (uint32_t slot : slots) {
+            const Entry& entry = m_entries[slot];
+            if (frustum.IntersectsSphere(entry.center, entry.radius)) {
+                out.push_back(entry.id);
+            }
+        }
+    }
+}
+
+int SpatialIndex::QueryNearest(const glm::vec3& point, float maxDistance) const {
+    int best = -1;
+    float bestDistance = std::numeric_limits<float>::max();
+    ForEachCandidate(point - maxDistance, point + maxDistance, [&](const Entry& entry) {
+        float distance = std::max(0.0f, glm::length(entry.center - point) - entry.radius);
+        if (distance <= maxDistance && distance < bestDistance) {
+            bestDistance = distance;
+            best = entry.id;
+        }
+    });
+    return best;
+}
+
+}  // namespace Blacksite
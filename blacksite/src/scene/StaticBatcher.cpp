@@ -0,0 +1,241 @@
+#include "blacksite/scene/StaticBatcher.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include "blacksite/core/EntitySystem.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/graphics/Frustum.h"
+#include "blacksite/graphics/Renderer.h"
+
+namespace Blacksite {
+
+uint32_t StaticBatcher::s_nextBatchId = 0;
+
+namespace {
+
+MeshHandle MeshForShape(const Renderer* renderer, EntityShape::VisualShape shape) {
+    switch (shape) {
+        case EntityShape::CUBE:
+            return renderer->GetCubeMesh();
+        case EntityShape::SPHERE:
+            return renderer->GetSphereMesh();
+        case EntityShape::PLANE:
+            return renderer->GetPlaneMesh();
+        default:
+            return MeshHandle{};
+    }
+}
+
+}  // namespace
+
+void StaticBatcher::Update(Renderer* renderer, EntitySystem& entities) {
+    m_renderer = renderer;
+    if (m_clearRequested) {
+        Clear(renderer, entities);
+        m_clearRequested = false;
+    }
+    if (m_bakeRequested) {
+        Bake(renderer, entities);
+        m_bakeRequested = false;
+        return;  // Fresh, nothing to check
+    }
+
+    // Byte and float compares per member - cheap next to drawing them one by one
+    for (size_t b = 0; b < m_batches.size();) {
+        Batch& batch = m_batches[b];
+        m_kept.clear();
+        for (const Member& member : batch.members) {
+            if (IsMemberUnchanged(batch, entities, member)) {
+                m_kept.push_back(member);
+            } else {
+                Release(entities, member.id);
+                batch.dirty = true;
+            }
+        }
+
+        if (batch.dirty) {
+            batch.members.swap(m_kept);
+            if (batch.members.empty() || !BuildMesh(renderer, entities, batch)) {
+                for (const Member& member : batch.members) {
+                    Release(entities, member.id);
+                }
+                renderer->DestroyMesh(batch.mesh);
+                m_batches.erase(m_batches.begin() + b);
+                continue;
+            }
+        }
+        ++b;
+    }
+}
+
+void StaticBatcher::Submit(Renderer* renderer, const Frustum* frustum) const {
+    for (const Batch& batch : m_batches) {
+        if (frustum && !frustum->IntersectsAABB(batch.boundsMin, batch.boundsMax))
+            continue;
+
+        // Vertices are already in world space. No single entity to report, so batches stay out of picking.
+        RenderCommand cmd;
+        cmd.mesh = batch.mesh;
+        cmd.model = glm::mat4(1.0f);
+        cmd.color = batch.color;
+        cmd.shader = batch.shader;
+        renderer->Submit(cmd);
+    }
+}
+
+size_t StaticBatcher::GetBatchedEntityCount() const {
+    size_t count = 0;
+    for (const Batch& batch : m_batches) {
+        count += batch.members.size();
+    }
+    return count;
+}
+
+void StaticBatcher::Bake(Renderer* renderer, EntitySystem& entities) {
+    Clear(renderer, entities);
+
+    // Sort candidates by (shader, color, cell), every run of equal keys becomes one batch
+    struct Candidate {
+        uint32_t shader;
+        glm::ivec3 cell;
+        glm::vec3 color;
+        int id;
+        EntityShape::VisualShape shape;
+
+        auto Key() const { return std::make_tuple(shader, cell.x, cell.y, cell.z, color.x, color.y, color.z); }
+    };
+
+    ComponentStore& components = entities.GetComponents();
+    std::vector<Candidate> candidates;
+    for (uint32_t slot : entities.GetAliveSlots()) {
+        if (!CanBatch(renderer, entities, slot))
+            continue;
+        const RenderComponent& render = components.GetRender(slot);
+        glm::vec3 cell = glm::floor(components.GetTransform(slot).position / BATCH_CELL_SIZE);
+        candidates.push_back({render.shaderHandle.id, glm::ivec3(cell), render.color, entities.GetEntities()[slot]->id,
+                              render.shape});
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.Key() < b.Key(); });
+
+    for (size_t begin = 0; begin < candidates.size();) {
+        size_t end = begin + 1;
+        while (end < candidates.size() && candidates[end].Key() == candidates[begin].Key()) {
+            ++end;
+        }
+
+        Batch batch;
+        batch.name = "static_batch_" + std::to_string(s_nextBatchId++);
+        batch.shader = ShaderHandle(candidates[begin].shader);
+        batch.color = candidates[begin].color;
+        batch.cell = candidates[begin].cell;
+        for (size_t i = begin; i < end; ++i) {
+            batch.members.push_back({candidates[i].id, candidates[i].shape});
+        }
+
+        if (BuildMesh(renderer, entities, batch)) {
+            for (const Member& member : batch.members) {
+                components.GetRender(EntitySystem::GetIdIndex(member.id)).staticBatched = true;
+            }
+            m_batches.push_back(std::move(batch));
+        }
+        begin = end;
+    }
+
+    BS_INFO_F(LogCategory::RENDERER, "Baked %zu static entities into %zu batches", GetBatchedEntityCount(),
+              m_batches.size());
+}
+
+void StaticBatcher::Shutdown() {
+    if (m_renderer) {
+        for (Batch& batch : m_batches) {
+            m_renderer->DestroyMesh(batch.mesh);
+        }
+    }
+    m_batches.clear();
+    m_kept.clear();
+    m_renderer = nullptr;
+    m_bakeRequested = false;
+    m_clearRequested = false;
+}
+
+void StaticBatcher::Clear(Renderer* renderer, EntitySystem& entities) {
+    for (Batch& batch : m_batches) {
+        for (const Member& member : batch.members) {
+            Release(entities, member.id);
+        }
+        renderer->DestroyMesh(batch.mesh);
+    }
+    m_batches.clear();
+}
+
+bool StaticBatcher::CanBatch(Renderer* renderer, EntitySystem& entities, uint32_t slot) const {
+    ComponentStore& components = entities.GetComponents();
+    if (!components.IsActive(slot) || components.GetPhysics(slot).isDynamic)
+        return false;
+
+    // Same lazy shader lookup the per-entity path does
+    RenderComponent& render = components.GetRender(slot);
+    if (!render.shaderHandle.IsValid()) {
+        render.shaderHandle = renderer->GetShaderHandle(entities.GetEntities()[slot]->shader);
+    }
+    // Batches are untextured, textured entities keep drawing on their own
+    return !render.hasTexture && render.shaderHandle.IsValid() && MeshForShape(renderer, render.shape).IsValid();
+}
+
+bool StaticBatcher::IsMemberUnchanged(const Batch& batch, EntitySystem& entities, const Member& member) const {
+    if (!entities.IsAlive(member.id))
+        return false;
+
+    uint32_t slot = EntitySystem::GetIdIndex(member.id);
+    ComponentStore& components = entities.GetComponents();
+    const RenderComponent& render = components.GetRender(slot);
+    if (!render.staticBatched || !components.IsActive(slot) || components.GetPhysics(slot).isDynamic ||
+        render.shaderHandle != batch.shader || render.color != batch.color || render.shape != member.shape ||
+        render.hasTexture)
+        return false;
+
+    // The dirty flag is conservative (any writable GetTransform sets it), so check it really moved
+    if (components.IsTransformDirty(slot)) {
+        const Transform& transform = components.GetTransform(slot);
+        glm::mat4 world = ComposeTRS(transform.position, transform.rotation, transform.scale);
+        if (world != components.GetWorldMatrix(slot))
+            return false;
+        components.SetWorldCache(slot, world, components.GetWorldRadius(slot));
+    }
+    return true;
+}
+
+void StaticBatcher::Release(EntitySystem& entities, int id) const {
+    if (!entities.IsAlive(id))
+        return;  // Slot may belong to someone else by now, ResetSlot already cleared the flag
+
+    uint32_t slot = EntitySystem::GetIdIndex(id);
+    ComponentStore& components = entities.GetComponents();
+    components.GetRender(slot).staticBatched = false;
+    components.MarkTransformDirty(slot);
+}
+
+bool StaticBatcher::BuildMesh(Renderer* renderer, EntitySystem& entities, Batch& batch) {
+    ComponentStore& components = entities.GetComponents();
+    std::vector<StaticBatchPiece> pieces;
+    pieces.reserve(batch.members.size());
+    for (const Member& member : batch.members) {
+        uint32_t slot = EntitySystem::GetIdIndex(member.id);
+        const Transform& transform = components.GetTransform(slot);
+        MeshHandle mesh = MeshForShape(renderer, member.shape);
+        glm::mat4 world = ComposeTRS(transform.position, transform.rotation, transform.scale);
+        pieces.push_back({mesh, world});
+
+        // Keep the world cache in step, it's how we notice the member moving later
+        glm::vec3 scale = glm::abs(transform.scale);
+        components.SetWorldCache(slot, world,
+                                 renderer->GetMeshBoundingRadius(mesh) * std::max(scale.x, std::max(scale.y, scale.z)));
+    }
+
+    batch.mesh = renderer->CreateStaticBatch(batch.name, pieces);
+    batch.dirty = false;
+    return batch.mesh.IsValid() && renderer->GetMeshBounds(batch.mesh, batch.boundsMin, batch.boundsMax);
+}
+
+}  // namespace Blacksite
@@ -0,0 +1,394 @@
+#include "blacksite/scene/WorldStreamer.h"
+#include "blacksite/core/JobSystem.h"
+#include "blacksite/core/Logger.h"
+#include "blacksite/core/Profiler.h"
+#include "blacksite/physics/PhysicsSystem.h"
+#include "blacksite/scene/Scene.h"
+#include "blacksite/scene/SceneSerializer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <system_error>
+
+namespace Blacksite {
+
+namespace {
+
+constexpr size_t STREAM_SLICE = 256;  // Entities per SpawnBatch / removal run, the budget is checked between them
+
+bool ParseCellFileName(const std::string& name, int& x, int& z) {
+    char tail[8] = {};
+    return std::sscanf(name.c_str(), "cell_%d_%d%7s", &x, &z, tail) == 3 && std::strcmp(tail, ".bscn") == 0;
+}
+
+}  // namespace
+
+// Same split as SceneSystem's async load: a job maps the file and builds the shapes, Update spawns
+struct WorldStreamer::CellLoad {
+    SceneFileReader reader;
+    std::vector<JPH::Ref<JPH::Shape>> shapes;  // Held so a cache prune can't drop them before the bodies exist
+    bool opened = false;
+    JobCounter prepared;
+    std::atomic<bool> cancelled{false};
+    size_t total = 0;
+    size_t spawned = 0;
+};
+
+WorldStreamer::WorldStreamer() = default;
+
+WorldStreamer::~WorldStreamer() {
+    Shutdown();
+}
+
+bool WorldStreamer::Initialize(Scene* scene, PhysicsSystem* physicsSystem, const WorldStreamingConfig& config) {
+    Shutdown();
+
+    if (!scene || !scene->GetEntitySystem() || !physicsSystem) {
+        BS_ERROR(LogCategory::CORE, "WorldStreamer: Needs an initialized scene and a PhysicsSystem");
+        return false;
+    }
+    if (config.cellSize <= 0.0f) {
+        BS_ERROR_F(LogCategory::CORE, "WorldStreamer: Cell size has to be positive, got %.2f", config.cellSize);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::directory_iterator it(config.directory, error);
+    if (error) {
+        BS_ERROR_F(LogCategory::CORE, "WorldStreamer: Can't read cell directory '%s': %s", config.directory.c_str(),
+                   error.message().c_str());
+        return false;
+    }
+
+    m_config = config;
+    m_config.evictRadius = std::max(m_config.evictRadius, m_config.prefetchRadius);
+    m_config.maxConcurrentLoads = std::max(m_config.maxConcurrentLoads, 1);
+
+    for (const auto& entry : it) {
+        int x = 0;
+        int z = 0;
+        if (!entry.is_regular_file(error) || !ParseCellFileName(entry.path().filename().string(), x, z))
+            continue;
+
+        Cell& cell = m_cells[CellKey(x, z)];
+        cell.x = x;
+        cell.z = z;
+        cell.path = entry.path().string();
+    }
+
+    m_scene = scene;
+    m_physicsSystem = physicsSystem;
+    BS_INFO_F(LogCategory::CORE, "WorldStreamer: %zu cells of %.0f units in '%s'", m_cells.size(), m_config.cellSize,
+              m_config.directory.c_str());
+    return true;
+}
+
+void WorldStreamer::Shutdown() {
+    if (!m_scene)
+        return;
+
+    EntitySystem* entitySystem = m_scene->GetEntitySystem();
+    for (auto& [key, cell] : m_cells) {
+        if (cell.load) {
+            cell.load->cancelled.store(true, std::memory_order_relaxed);
+            JobSystem::Get().Wait(cell.load->prepared);
+        }
+        if (entitySystem) {
+            for (size_t i = cell.removed; i < cell.ids.size(); ++i) {
+                if (entitySystem->IsAlive(cell.ids[i])) {
+                    entitySystem->RemoveEntity(cell.ids[i]);
+                }
+            }
+        }
+    }
+
+    m_cells.clear();
+    m_work.clear();
+    m_residentCount = 0;
+    m_scene = nullptr;
+    m_physicsSystem = nullptr;
+}
+
+void WorldStreamer::Update() {
+    if (m_scene && m_scene->GetCameraSystem()) {
+        Update(m_scene->GetCameraSystem()->GetPosition());
+    }
+}
+
+void WorldStreamer::Update(const glm::vec3& focusPosition) {
+    if (!m_scene)
+        return;
+
+    BS_PROFILE_SCOPE("WorldStreamer::Update");
+
+    // Anything that needs work this frame, nearest first - so the cell under the camera always goes first
+    m_work.clear();
+    int loading = 0;
+    for (auto& [key, cell] : m_cells) {
+        float distance = DistanceToCell(cell, focusPosition);
+        bool keep = distance <= m_config.evictRadius;
+
+        switch (cell.state) {
+            case CellState::Unloaded:
+                if (distance <= m_config.prefetchRadius) {
+                    m_work.emplace_back(distance, &cell);
+                }
+                break;
+            case CellState::Reading:
+            case CellState::Spawning:
+                ++loading;
+                if (!keep) {
+                    // Spawned entities go out like a resident cell's, an unfinished read is dropped when done
+                    cell.load->cancelled.store(true, std::memory_order_relaxed);
+                    if (cell.state == CellState::Spawning) {
+                        cell.state = CellState::Unloading;
+                        cell.removed = 0;
+                    }
+                }
+                m_work.emplace_back(distance, &cell);
+                break;
+            case CellState::Resident:
+                if (!keep) {
+                    cell.state = CellState::Unloading;
+                    cell.removed = 0;
+                    --m_residentCount;
+                    m_work.emplace_back(distance, &cell);
+                }
+                break;
+            case CellState::Unloading:
+                m_work.emplace_back(distance, &cell);
+                break;
+            case CellState::Failed:
+                break;
+        }
+    }
+
+    if (m_work.empty())
+        return;
+
+    std::sort(m_work.begin(), m_work.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // Removals first, they free the bodies and memory the loads are about to want
+    Clock::time_point deadline =
+        Clock::now() + std::chrono::microseconds(static_cast<int64_t>(m_config.budgetMs * 1000.0f));
+    for (auto& [distance, cell] : m_work) {
+        if (cell->state == CellState::Unloading) {
+            StepUnload(*cell, deadline);
+        }
+    }
+
+    for (auto& [distance, cell] : m_work) {
+        switch (cell->state) {
+            case CellState::Unloaded:
+                if (loading < m_config.maxConcurrentLoads) {
+                    StartLoad(*cell);
+                    ++loading;
+                }
+                break;
+            case CellState::Reading:
+            case CellState::Spawning:
+                StepSpawn(*cell, deadline);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+size_t WorldStreamer::BuildCells(Scene& scene, const std::string& directory, float cellSize) {
+    EntitySystem* entitySystem = scene.GetEntitySystem();
+    if (!entitySystem || cellSize <= 0.0f) {
+        BS_ERROR(LogCategory::CORE, "WorldStreamer: BuildCells needs an initialized scene and a positive cell size");
+        return 0;
+    }
+
+    BS_PROFILE_SCOPE("WorldStreamer::BuildCells");
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        BS_ERROR_F(LogCategory::CORE, "WorldStreamer: Can't create '%s': %s", directory.c_str(),
+                   error.message().c_str());
+        return 0;
+    }
+
+    // Old cells would stream back in alongside the new ones
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        int x = 0;
+        int z = 0;
+        if (ParseCellFileName(entry.path().filename().string(), x, z)) {
+            std::error_code ignored;
+            std::filesystem::remove(entry.path(), ignored);
+        }
+    }
+
+    // Ordered so the files come out the same way every time
+    std::map<std::pair<int, int>, std::vector<int>> cells;
+    const auto& entities = entitySystem->GetEntities();
+    for (uint32_t slot : entitySystem->GetAliveSlots()) {
+        const Entity* entity = entities[slot];
+        const glm::vec3& position = entity->GetTransform().position;
+        int x = static_cast<int>(std::floor(position.x / cellSize));
+        int z = static_cast<int>(std::floor(position.z / cellSize));
+        cells[{x, z}].push_back(entity->id);
+    }
+
+    size_t written = 0;
+    std::filesystem::path root(directory);
+    for (auto& [coords, ids] : cells) {
+        std::sort(ids.begin(), ids.end());  // Id order, same reason as the map
+        std::string path = (root / GetCellFileName(coords.first, coords.second)).string();
+        if (SceneSerializer::Save(scene, path, ids)) {
+            ++written;
+        }
+    }
+
+    BS_INFO_F(LogCategory::CORE, "WorldStreamer: Wrote %zu of %zu cells to '%s'", written, cells.size(),
+              directory.c_str());
+    return written;
+}
+
+std::string WorldStreamer::GetCellFileName(int x, int z) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "cell_%d_%d.bscn", x, z);
+    return name;
+}
+
+size_t WorldStreamer::GetLoadingCellCount() const {
+    size_t count = 0;
+    for (const auto& [key, cell] : m_cells) {
+        count += cell.state == CellState::Reading || cell.state == CellState::Spawning;
+    }
+    return count;
+}
+
+size_t WorldStreamer::GetStreamedEntityCount() const {
+    size_t count = 0;
+    for (const auto& [key, cell] : m_cells) {
+        count += cell.ids.size() - cell.removed;
+    }
+    return count;
+}
+
+bool WorldStreamer::IsCellResident(int x, int z) const {
+    auto it = m_cells.find(CellKey(x, z));
+    return it != m_cells.end() && it->second.state == CellState::Resident;
+}
+
+float WorldStreamer::DistanceToCell(const Cell& cell, const glm::vec3& position) const {
+    // To the nearest point of the cell's square, so the cell you're standing in is at 0
+    float minX = static_cast<float>(cell.x) * m_config.cellSize;
+    float minZ = static_cast<float>(cell.z) * m_config.cellSize;
+    float dx = std::max({minX - position.x, 0.0f, position.x - (minX + m_config.cellSize)});
+    float dz = std::max({minZ - position.z, 0.0f, position.z - (minZ + m_config.cellSize)});
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+void WorldStreamer::StartLoad(Cell& cell) {
+    cell.load = std::make_unique<CellLoad>();
+    cell.state = CellState::Reading;
+    cell.ids.clear();
+    cell.removed = 0;
+
+    CellLoad* load = cell.load.get();
+    PhysicsSystem* physics = m_physicsSystem;
+    std::string path = cell.path;
+    JobSystem::Get().Run([load, physics, path]() {
+        BS_PROFILE_SCOPE("WorldStreamer::ReadCell");
+        load->opened = load->reader.Open(path);
+        if (load->opened) {
+            std::vector<Collider> colliders;
+            glm::vec3 scale(1.0f);
+            size_t count = load->reader.GetEntityCount();
+            for (size_t i = 0; i < count && !load->cancelled.load(std::memory_order_relaxed); ++i) {
+                if (load->reader.ReadColliders(i, colliders, scale)) {
+                    JPH::Ref<JPH::Shape> shape = physics->GetOrCreateShape(colliders, scale);
+                    if (shape && (load->shapes.empty() || load->shapes.back() != shape)) {
+                        load->shapes.push_back(std::move(shape));
+                    }
+                }
+            }
+        }
+    }, &load->prepared);
+}
+
+void WorldStreamer::StepSpawn(Cell& cell, Clock::time_point deadline) {
+    CellLoad& load = *cell.load;
+    if (cell.state == CellState::Reading) {
+        if (!load.prepared.IsDone())
+            return;
+
+        if (load.cancelled.load(std::memory_order_relaxed)) {
+            cell.load.reset();
+            cell.state = CellState::Unloaded;
+            return;
+        }
+        if (!load.opened) {
+            // Open already logged why, don't retry it every frame
+            cell.load.reset();
+            cell.state = CellState::Failed;
+            return;
+        }
+        load.total = load.reader.GetEntityCount();
+        cell.ids.reserve(load.total);
+        cell.state = CellState::Spawning;
+    }
+
+    // One slice even past the deadline, so every loading cell keeps moving
+    do {
+        if (load.spawned >= load.total)
+            break;
+        size_t count = std::min(STREAM_SLICE, load.total - load.spawned);
+        size_t spawned = load.reader.Spawn(*m_scene, load.spawned, count, &cell.ids);
+        if (spawned < count) {
+            // The rest would fail the same way. What did spawn is in cell.ids, so it still unloads with the cell.
+            BS_ERROR_F(LogCategory::CORE, "WorldStreamer: Cell (%d, %d) stopped at %zu of %zu entities", cell.x,
+                       cell.z, load.spawned + spawned, load.total);
+            load.total = load.spawned + spawned;
+        }
+        load.spawned += spawned;
+    } while (Clock::now() < deadline);
+
+    if (load.spawned >= load.total) {
+        BS_DEBUG_F(LogCategory::CORE, "WorldStreamer: Cell (%d, %d) in, %zu entities", cell.x, cell.z,
+                   cell.ids.size());
+        cell.load.reset();
+        cell.state = CellState::Resident;
+        ++m_residentCount;
+    }
+}
+
+void WorldStreamer::StepUnload(Cell& cell, Clock::time_point deadline) {
+    // A load cancelled mid-spawn, its job finished before spawning started
+    cell.load.reset();
+
+    // Bodies only get queued here, PhysicsSystem pulls them all out of the world in one batch on its next flush
+    EntitySystem* entitySystem = m_scene->GetEntitySystem();
+    do {
+        if (cell.removed >= cell.ids.size())
+            break;
+        size_t end = std::min(cell.removed + STREAM_SLICE, cell.ids.size());
+        for (; cell.removed < end; ++cell.removed) {
+            int id = cell.ids[cell.removed];
+            if (entitySystem->IsAlive(id)) {  // The game may have removed it already
+                entitySystem->RemoveEntity(id);
+            }
+        }
+    } while (Clock::now() < deadline);
+
+    if (cell.removed >= cell.ids.size()) {
+        BS_DEBUG_F(LogCategory::CORE, "WorldStreamer: Cell (%d, %d) out, %zu entities", cell.x, cell.z,
+                   cell.ids.size());
+        cell.ids.clear();
+        cell.ids.shrink_to_fit();
+        cell.removed = 0;
+        cell.state = CellState::Unloaded;
+    }
+}
+
+}  // namespace Blacksite
@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "blacksite_editor/core/EditorCore.h"
+#include "blacksite_editor/panels/AssetBrowserPanel.h"
 #include "blacksite_editor/panels/ConsolePanel.h"
 #include "blacksite_editor/panels/InspectorPanel.h"
 #include "blacksite_editor/panels/PerformancePanel.h"
@@ -21,6 +22,7 @@ class InspectorPanel;
 class ViewportPanel;
 class ConsolePanel;
 class PerformancePanel;
+class AssetBrowserPanel;
 
 class EditorApplication : public Blacksite::Application {
   public:
@@ -43,6 +45,7 @@ class EditorApplication : public Blacksite::Application {
     std::unique_ptr<ViewportPanel> m_viewportPanel;
     std::unique_ptr<ConsolePanel> m_consolePanel;
     std::unique_ptr<PerformancePanel> m_performancePanel;
+    std::unique_ptr<AssetBrowserPanel> m_assetBrowserPanel;
 
     // Editor state
     bool m_showHierarchy = true;
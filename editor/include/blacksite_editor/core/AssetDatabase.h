@@ -0,0 +1,118 @@
+#pragma once
+#include <blacksite/core/FileWatcher.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace BlacksiteEditor {
+
+struct AssetEntry {
+    std::string path;       // Relative to the root, '/' separated, no trailing slash
+    std::string name;
+    std::string extension;  // Lowercase, with the dot
+    std::string parent;     // "" for things directly in the root
+    bool isDirectory = false;
+    uint64_t size = 0;
+    int64_t modified = 0;   // Filesystem clock ticks, only good for comparing against itself
+};
+
+/**
+ * AssetDatabase - Index of everything under the asset root, kept current without blocking the editor
+ * Directory walks run on their own thread and hand entries over in batches that Update merges on the main
+ * thread, so the browser fills in while a big tree is still being scanned. The index is saved to disk and
+ * loaded on Open, which makes startup instant; the scan that follows only has to reconcile differences.
+ * After that a FileWatcher keeps it up to date and full rescans only happen when asked for.
+ */
+class AssetDatabase {
+  public:
+    AssetDatabase() = default;
+    ~AssetDatabase() { Close(); }
+
+    AssetDatabase(const AssetDatabase&) = delete;
+    AssetDatabase& operator=(const AssetDatabase&) = delete;
+
+    // Loads the saved index (if any) and starts a background scan of the whole root
+    bool Open(const std::string& root, const std::string& cachePath = "cache/assets.db");
+    void Close();  // Stops the scan thread and saves the index
+
+    // Merges scan results and file changes. Main thread, once a frame.
+    void Update();
+
+    // Walks the directory (relative, "" = root) again in the background
+    void Rescan(const std::string& directory = "");
+
+    const AssetEntry* Find(const std::string& path) const;
+    // Directories first, then by name
+    void GetChildren(const std::string& directory, std::vector<const AssetEntry*>& out) const;
+    std::string GetFullPath(const std::string& path) const;
+
+    const std::string& GetRoot() const { return m_root; }
+    bool IsOpen() const { return m_thread.joinable(); }
+    bool IsScanning() const { return m_activeScans > 0; }
+    bool IsWatching() const { return m_watcher.IsRunning(); }
+    size_t GetAssetCount() const { return m_entries.size(); }
+    // Goes up whenever anything in the index changes, so views can cache what they show
+    uint64_t GetVersion() const { return m_version; }
+
+  private:
+    // What the scan thread hands over. A finished message comes after all of its directory's batches.
+    struct ScanResult {
+        std::vector<AssetEntry> entries;
+        std::string directory;
+        uint32_t scanId = 0;
+        bool finished = false;
+        size_t merged = 0;  // Entries already taken, a batch can be split across Updates
+    };
+
+    struct Node {
+        AssetEntry entry;
+        uint32_t scanId = 0;  // Last scan that saw it, what tells deleted files apart after a walk
+    };
+
+    static constexpr size_t SCAN_BATCH_SIZE = 256;
+    static constexpr size_t MAX_MERGE_PER_UPDATE = 4096;  // Entries, keeps a huge first scan from stalling frames
+
+    std::string m_root;       // As given, with a trailing '/'
+    std::string m_rootFull;   // Absolute and normalized like FileWatcher's paths, with a trailing '/'
+    std::string m_cachePath;
+
+    std::unordered_map<std::string, Node> m_entries;
+    std::unordered_map<std::string, std::unordered_set<std::string>> m_children;  // Directory -> child paths
+    uint64_t m_version = 0;
+    bool m_dirty = false;  // Differs from what's on disk
+    int m_activeScans = 0;
+    uint32_t m_nextScanId = 1;
+
+    Blacksite::FileWatcher m_watcher;
+
+    // Scan thread
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::pair<std::string, uint32_t>> m_requests;  // Directory, scan id
+    std::deque<ScanResult> m_results;
+
+    void ScanLoop();
+    void ScanDirectory(const std::string& directory, uint32_t scanId);
+
+    void Merge(ScanResult& result, size_t& budget);
+    void ApplyChange(const std::string& fullPath);
+    bool Upsert(const AssetEntry& entry, uint32_t scanId);
+    void Erase(const std::string& path);
+    void EraseUnseen(const std::string& directory, uint32_t scanId);
+
+    bool Load();
+    void Save();
+
+    static AssetEntry MakeEntry(const std::string& path, bool isDirectory, uint64_t size, int64_t modified);
+};
+
+}  // namespace BlacksiteEditor
@@ -0,0 +1,81 @@
+#pragma once
+#include <blacksite/core/JobSystem.h>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BlacksiteEditor {
+
+/**
+ * ThumbnailCache - Small previews of image assets, packed into one atlas texture
+ * Nothing is loaded until the browser asks for a thumbnail it's about to draw. Files are read and shrunk on
+ * the job system, the GL upload happens in Update a few tiles per frame. When the atlas is full the tile
+ * that went longest without being drawn gets reused. Keyed by path + modified time, so an edited image
+ * gets a fresh thumbnail on its own.
+ *
+ * Whatever Blacksite::ImageLoader reads (TGA and BMP for now), other images just don't get one.
+ */
+class ThumbnailCache {
+  public:
+    static constexpr int TILE_SIZE = 64;
+    static constexpr int ATLAS_SIZE = 1024;
+
+    ThumbnailCache() = default;
+    ~ThumbnailCache() { Shutdown(); }
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    void Initialize();  // Needs the GL context
+    void Shutdown();    // Waits for decodes still running
+
+    // Uploads finished decodes. GL thread, once a frame.
+    void Update();
+
+    // True once the thumbnail is in the atlas, with its texture and uv rect. Queues the decode on the first call.
+    bool Get(const std::string& fullPath, int64_t modified, uint32_t& texture, float uv0[2], float uv1[2]);
+
+    static bool CanDecode(const std::string& extension);
+
+    size_t GetCachedCount() const { return m_tileCount - m_freeTiles.size(); }
+    size_t GetPendingCount() const { return static_cast<size_t>(m_inFlight); }  // Decoding or waiting to upload
+
+  private:
+    enum class State : uint8_t { Queued, Ready, Failed };
+
+    struct Thumbnail {
+        int64_t modified = 0;
+        int tile = -1;
+        uint64_t lastUsed = 0;  // Frame it was last drawn, for eviction
+        State state = State::Queued;
+    };
+
+    struct Decoded {
+        std::string path;
+        int64_t modified = 0;
+        std::vector<uint8_t> pixels;  // TILE_SIZE x TILE_SIZE RGBA, empty if the file couldn't be decoded
+    };
+
+    static constexpr int MAX_IN_FLIGHT = 8;         // Decode jobs at once, the rest wait for a later frame
+    static constexpr int MAX_UPLOADS_PER_FRAME = 8;
+
+    uint32_t m_atlas = 0;
+    size_t m_tileCount = 0;
+    std::vector<int> m_freeTiles;
+    std::vector<std::string> m_tileOwners;  // Tile -> path, to evict it
+    std::unordered_map<std::string, Thumbnail> m_thumbnails;
+    uint64_t m_frame = 0;
+    int m_inFlight = 0;
+
+    Blacksite::JobCounter m_jobs;
+    std::mutex m_mutex;
+    std::deque<Decoded> m_decoded;  // Filled by the jobs, drained by Update
+
+    int AllocateTile();
+    void Upload(int tile, const std::vector<uint8_t>& pixels);
+};
+
+}  // namespace BlacksiteEditor
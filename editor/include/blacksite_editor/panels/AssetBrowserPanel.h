@@ -1,39 +1,42 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <filesystem>
+
+#include "blacksite_editor/core/AssetDatabase.h"
+#include "blacksite_editor/core/ThumbnailCache.h"
 
 namespace BlacksiteEditor {
 
 class EditorCore;
 
-struct AssetItem {
-    std::string name;
-    std::string path;
-    std::string extension;
-    bool isDirectory;
-};
-
 class AssetBrowserPanel {
 public:
     AssetBrowserPanel(EditorCore* editorCore);
-    ~AssetBrowserPanel() = default;
+    ~AssetBrowserPanel();
 
     void Update(float deltaTime);
     void Render();
 
+    bool IsOpen() const { return m_isOpen; }
+    void SetOpen(bool open) { m_isOpen = open; }
+
 private:
     EditorCore* m_editorCore;
     bool m_isOpen = true;
 
-    std::string m_currentPath = "assets/";
-    std::vector<AssetItem> m_currentItems;
-    int m_selectedItem = -1;
+    AssetDatabase m_database;
+    ThumbnailCache m_thumbnails;
+
+    std::string m_currentPath;  // Relative to the asset root, "" = the root
+    std::vector<const AssetEntry*> m_currentItems;
+    uint64_t m_listedVersion = UINT64_MAX;  // Database version m_currentItems was built from
+    std::string m_selectedPath;
 
-    void RefreshCurrentDirectory();
     void NavigateToPath(const std::string& path);
     void RenderDirectoryNavigation();
     void RenderAssetGrid();
+    void RenderAssetItem(const AssetEntry& item, float itemSize);
     void RenderAssetContextMenu();
     bool IsImageFile(const std::string& extension);
     bool IsModelFile(const std::string& extension);
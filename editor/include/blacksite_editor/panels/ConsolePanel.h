@@ -1,17 +1,12 @@
 #pragma once
-#include <vector>
+#include <cstdint>
+#include <deque>
 #include <string>
 
 namespace BlacksiteEditor {
 
 class EditorCore;
 
-struct LogEntry {
-    std::string message;
-    int level; // 0=Info, 1=Warning, 2=Error
-    float timestamp;
-};
-
 class ConsolePanel {
 public:
     ConsolePanel(EditorCore* editorCore);
@@ -20,13 +15,25 @@ public:
     void Update(float deltaTime);
     void Render();
 
-    void AddLogEntry(const std::string& message, int level = 0);
+    // Goes through the engine Logger (EDITOR category), the panel shows the Logger's history
+    void AddLogEntry(const std::string& message, int level = 0);  // 0=Info, 1=Warning, 2=Error
 
 private:
     EditorCore* m_editorCore;
     bool m_isOpen = true;
-    std::vector<LogEntry> m_logEntries;
+    uint64_t m_firstSequence = 0;  // Clear just hides everything before this, the Logger keeps its history
+    uint64_t m_seenSequence = 0;   // Everything before this has been through the filter already
     bool m_autoScroll = true;
+    bool m_showInfo = true;
+    bool m_showWarning = true;
+    bool m_showError = true;
+
+    // Logger sequences that pass the level filter. New entries get appended, ones the ring has
+    // overwritten fall off the front, a filter change starts over.
+    std::deque<uint64_t> m_visible;
+
+    void ResetVisible();
+    size_t UpdateVisible();  // Returns how many entries were added
 
     // Command system
     char m_commandBuffer[256] = "";
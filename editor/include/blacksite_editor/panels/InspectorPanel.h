@@ -17,7 +17,14 @@ class InspectorPanel {
     EditorCore* m_editorCore;
     bool m_isOpen = true;
 
+    // Euler angles shown for the selected entity. Only re-derived when the quaternion changes under
+    // us (physics, another panel), so typed angles don't snap to a different but equal decomposition.
+    int m_eulerEntity = -1;
+    glm::quat m_eulerSource{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 m_eulerView{0.0f};
+
     void RenderEntityInspector(Blacksite::Entity* entity);
+    void MarkEntitiesChanged();
     void RenderTransformComponent(Blacksite::Entity* entity);
     void RenderPhysicsComponent(Blacksite::Entity* entity);
     void RenderRenderComponent(Blacksite::Entity* entity);
@@ -23,6 +23,7 @@ private:
 
     void UpdatePerformanceStats(float deltaTime);
     void RenderFrameRateInfo();
+    void RenderGpuTimings();
     void RenderMemoryInfo();
     void RenderSystemInfo();
     void RenderPerformanceControls();
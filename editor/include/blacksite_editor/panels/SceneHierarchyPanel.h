@@ -1,7 +1,14 @@
 #pragma once
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <vector>
 #include "blacksite/core/Entity.h"
 
+namespace Blacksite {
+class EntitySystem;
+}
+
 namespace BlacksiteEditor {
 
 class EditorCore;
@@ -25,6 +32,16 @@ private:
     // UI state
     bool m_isOpen = true;
     int m_contextMenuEntityId = -1;
+    char m_searchBuffer[256] = "";
+
+    // Slots that pass the active + search filter, rebuilt only when the entity system's version,
+    // the search text or the scene changes. Only the rows on screen get drawn.
+    std::vector<uint32_t> m_visibleSlots;
+    const Blacksite::EntitySystem* m_cachedSystem = nullptr;
+    uint64_t m_cachedVersion = UINT64_MAX;
+    std::string m_cachedSearch;
+
+    void RefreshVisibleSlots(const Blacksite::EntitySystem& entitySystem);
 
     void RenderEntityNode(const Blacksite::Entity& entity);
     void RenderContextMenu();
@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <glm/glm.hpp>
 #include "blacksite/graphics/PostProcessManager.h"
 
@@ -18,8 +19,14 @@ public:
     bool IsFocused() const { return m_isFocused; }
     glm::vec2 GetSize() const { return m_viewportSize; }
 
+    // Left click on the scene picks through the GPU id buffer, -1 when the click hit nothing
+    using EntityPickedCallback = std::function<void(int entityId)>;
+    void SetEntityPickedCallback(EntityPickedCallback callback) { m_entityPickedCallback = callback; }
+
 private:
     EditorCore* m_editorCore;
+    EntityPickedCallback m_entityPickedCallback;
+    bool m_pickPending = false;  // Clicked, waiting on the readback
     bool m_isOpen = true;
     bool m_isHovered = false;
     bool m_isFocused = false;
@@ -33,6 +40,7 @@ private:
 
     void HandleViewportInput();
     void RenderViewportContent();
+    void HandlePicking(Blacksite::PostProcessManager* postProcessManager);
     void RenderViewportOverlay();
 };
 
@@ -1,5 +1,6 @@
 #include "blacksite_editor/EditorApplication.h"
 #include "blacksite_editor/core/EditorCore.h"
+#include "blacksite_editor/panels/AssetBrowserPanel.h"
 #include "blacksite_editor/panels/ConsolePanel.h"
 #include "blacksite_editor/panels/InspectorPanel.h"
 #include "blacksite_editor/panels/PerformancePanel.h"
@@ -18,6 +19,11 @@ EditorApplication::EditorApplication() : Application("Blacksite Editor", 1920, 1
 void EditorApplication::OnInitialize() {
     BS_INFO(Blacksite::LogCategory::CORE, "Initializing Blacksite Editor");
 
+    // Nothing to redraw most of the time in an editor, sleep until input or the scene changes
+    Blacksite::FramePacingConfig pacing = GetEngine().GetFramePacing();
+    pacing.idleWhenUnchanged = true;
+    GetEngine().SetFramePacing(pacing);
+
     SetupImGui();
 
     // Initialize editor components
@@ -29,12 +35,17 @@ void EditorApplication::OnInitialize() {
     m_viewportPanel = std::make_unique<ViewportPanel>(m_editorCore.get());
     m_consolePanel = std::make_unique<ConsolePanel>(m_editorCore.get());
     m_performancePanel = std::make_unique<PerformancePanel>(m_editorCore.get());
+    m_assetBrowserPanel = std::make_unique<AssetBrowserPanel>(m_editorCore.get());
 
     // Setup callbacks
     m_hierarchyPanel->SetEntitySelectedCallback([this](int entityId) {
         m_selectedEntityId = entityId;
         m_editorCore->SetSelectedEntity(entityId);
     });
+    m_viewportPanel->SetEntityPickedCallback([this](int entityId) {
+        m_selectedEntityId = entityId;
+        m_editorCore->SetSelectedEntity(entityId);
+    });
 
     m_editorCore->NewScene("DefaultScene");
 }
@@ -50,6 +61,8 @@ void EditorApplication::OnRender() {
 }
 
 void EditorApplication::OnShutdown() {
+    // Owns a GL texture and a scan thread, both have to go while the engine is still up
+    m_assetBrowserPanel.reset();
     ShutdownImGui();
     BS_INFO(Blacksite::LogCategory::CORE, "Blacksite Editor shutdown");
 }
@@ -105,6 +118,7 @@ void EditorApplication::UpdateEditor(float deltaTime) {
     m_viewportPanel->Update(deltaTime);
     m_consolePanel->Update(deltaTime);
     m_performancePanel->Update(deltaTime);
+    m_assetBrowserPanel->Update(deltaTime);
 }
 
 void EditorApplication::RenderEditor() {
@@ -122,6 +136,7 @@ void EditorApplication::RenderEditor() {
     m_viewportPanel->Render();
     m_consolePanel->Render();
     m_performancePanel->Render();
+    m_assetBrowserPanel->Render();
 
     // Demo windows
     if (m_showDemoWindow) {
@@ -198,6 +213,9 @@ void EditorApplication::RenderMenuBar() {
             if (ImGui::MenuItem("Save As...", "Ctrl+Shift+S")) {
                 // TODO: Implement save as dialog
             }
+            if (ImGui::MenuItem("Export Scene JSON")) {
+                m_editorCore->SaveScene("scene.json");
+            }
             ImGui::Separator();
             if (ImGui::MenuItem("Recent Files")) {
                 // TODO: Implement recent files
@@ -302,7 +320,7 @@ void EditorApplication::RenderMenuBar() {
         // Tools menu
         if (ImGui::BeginMenu("Tools")) {
             if (ImGui::MenuItem("Asset Browser")) {
-                // TODO: Open asset browser
+                m_assetBrowserPanel->SetOpen(true);
             }
             if (ImGui::MenuItem("Material Editor")) {
                 // TODO: Open material editor
@@ -0,0 +1,442 @@
+#include "blacksite_editor/core/AssetDatabase.h"
+#include <blacksite/core/Logger.h>
+#include <blacksite/core/Profiler.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace BlacksiteEditor {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* DB_HEADER = "BSASSETDB 1";
+
+bool IsHidden(const std::string& relativePath) {
+    // Any component starting with '.' - editor temp files, .git and such
+    size_t start = 0;
+    while (start < relativePath.size()) {
+        if (relativePath[start] == '.') {
+            return true;
+        }
+        size_t slash = relativePath.find('/', start);
+        if (slash == std::string::npos) {
+            break;
+        }
+        start = slash + 1;
+    }
+    return false;
+}
+
+int64_t WriteTime(const fs::directory_entry& entry) {
+    std::error_code error;
+    auto time = entry.last_write_time(error);
+    return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+bool NameLess(const std::string& a, const std::string& b) {
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) < std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+}  // namespace
+
+bool AssetDatabase::Open(const std::string& root, const std::string& cachePath) {
+    Close();
+
+    m_root = root;
+    if (m_root.empty() || m_root.back() != '/') {
+        m_root += '/';
+    }
+    m_rootFull = Blacksite::FileWatcher::NormalizePath(m_root);
+    if (m_rootFull.empty() || m_rootFull.back() != '/') {
+        m_rootFull += '/';
+    }
+    m_cachePath = cachePath;
+
+    std::error_code error;
+    if (!fs::is_directory(m_root, error)) {
+        BS_WARN_F(Blacksite::LogCategory::EDITOR, "AssetDatabase: '%s' is not a directory", m_root.c_str());
+        return false;
+    }
+
+    if (Load()) {
+        BS_INFO_F(Blacksite::LogCategory::EDITOR, "AssetDatabase: Loaded %zu assets from %s", m_entries.size(),
+                  m_cachePath.c_str());
+    }
+
+    // Started before the scan so nothing that changes during it falls through the gap
+    if (!m_watcher.Start(m_root)) {
+        BS_WARN(Blacksite::LogCategory::EDITOR, "AssetDatabase: No file watcher, changes show up on Refresh");
+    }
+
+    m_stop = false;
+    m_thread = std::thread(&AssetDatabase::ScanLoop, this);
+    Rescan();
+    return true;
+}
+
+void AssetDatabase::Close() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_requests.clear();
+        m_results.clear();
+    }
+    m_wake.notify_all();
+    m_thread.join();
+    m_watcher.Stop();
+
+    if (m_dirty) {
+        Save();
+    }
+    m_entries.clear();
+    m_children.clear();
+    m_activeScans = 0;
+    ++m_version;
+}
+
+void AssetDatabase::Rescan(const std::string& directory) {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.emplace_back(directory, m_nextScanId++);
+    }
+    ++m_activeScans;
+    m_wake.notify_one();
+}
+
+void AssetDatabase::Update() {
+    BS_PROFILE_SCOPE("AssetDatabase::Update");
+
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    // Batches stay in the queue until they're fully merged, so a finished message never overtakes its entries
+    size_t budget = MAX_MERGE_PER_UPDATE;
+    while (budget > 0) {
+        ScanResult result;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_results.empty()) {
+                break;
+            }
+            result = std::move(m_results.front());
+            m_results.pop_front();
+        }
+
+        Merge(result, budget);
+        if (result.merged < result.entries.size()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_results.push_front(std::move(result));
+            break;
+        }
+    }
+
+    for (const std::string& path : m_watcher.PollChanges()) {
+        ApplyChange(path);
+    }
+}
+
+void AssetDatabase::Merge(ScanResult& result, size_t& budget) {
+    while (result.merged < result.entries.size() && budget > 0) {
+        Upsert(result.entries[result.merged++], result.scanId);
+        --budget;
+    }
+    if (result.merged < result.entries.size() || !result.finished) {
+        return;
+    }
+
+    // Whatever the walk didn't see is gone, unless a newer scan or the watcher put it there since
+    EraseUnseen(result.directory, result.scanId);
+    if (--m_activeScans == 0) {
+        BS_DEBUG_F(Blacksite::LogCategory::EDITOR, "AssetDatabase: Scan finished, %zu assets", m_entries.size());
+        if (m_dirty) {
+            Save();
+        }
+    }
+}
+
+void AssetDatabase::ApplyChange(const std::string& fullPath) {
+    if (fullPath.size() <= m_rootFull.size() || fullPath.compare(0, m_rootFull.size(), m_rootFull) != 0) {
+        return;
+    }
+    std::string path = fullPath.substr(m_rootFull.size());
+    if (IsHidden(path)) {
+        return;
+    }
+
+    std::error_code error;
+    fs::directory_entry entry(fs::u8path(fullPath), error);
+    if (error || !entry.exists(error)) {
+        Erase(path);
+        return;
+    }
+
+    bool isDirectory = entry.is_directory(error);
+    uint64_t size = isDirectory ? 0 : entry.file_size(error);
+    bool isNew = m_entries.find(path) == m_entries.end();
+
+    // Stamped past every scan already queued, none of those can have seen it
+    Upsert(MakeEntry(path, isDirectory, error ? 0 : size, WriteTime(entry)), m_nextScanId);
+
+    // A directory moved in from outside brings its contents along without an event for each
+    if (isDirectory && isNew) {
+        Rescan(path);
+    }
+}
+
+bool AssetDatabase::Upsert(const AssetEntry& entry, uint32_t scanId) {
+    auto [it, inserted] = m_entries.try_emplace(entry.path);
+    Node& node = it->second;
+    node.scanId = std::max(node.scanId, scanId);
+    if (!inserted && node.entry.isDirectory == entry.isDirectory && node.entry.size == entry.size &&
+        node.entry.modified == entry.modified) {
+        return false;
+    }
+
+    node.entry = entry;
+    if (inserted) {
+        m_children[entry.parent].insert(entry.path);
+    }
+    ++m_version;
+    m_dirty = true;
+    return true;
+}
+
+void AssetDatabase::Erase(const std::string& path) {
+    auto it = m_entries.find(path);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    auto children = m_children.find(path);
+    if (children != m_children.end()) {
+        // Copied, erasing a child takes it out of this set
+        std::vector<std::string> paths(children->second.begin(), children->second.end());
+        for (const std::string& child : paths) {
+            Erase(child);
+        }
+        m_children.erase(path);
+    }
+
+    auto siblings = m_children.find(it->second.entry.parent);
+    if (siblings != m_children.end()) {
+        siblings->second.erase(path);
+    }
+    m_entries.erase(it);
+    ++m_version;
+    m_dirty = true;
+}
+
+void AssetDatabase::EraseUnseen(const std::string& directory, uint32_t scanId) {
+    auto children = m_children.find(directory);
+    if (children == m_children.end()) {
+        return;
+    }
+
+    std::vector<std::string> stale;
+    for (const std::string& child : children->second) {
+        const Node& node = m_entries[child];
+        if (node.scanId < scanId) {
+            stale.push_back(child);
+        } else if (node.entry.isDirectory) {
+            EraseUnseen(child, scanId);
+        }
+    }
+    for (const std::string& path : stale) {
+        Erase(path);
+    }
+}
+
+const AssetEntry* AssetDatabase::Find(const std::string& path) const {
+    auto it = m_entries.find(path);
+    return it != m_entries.end() ? &it->second.entry : nullptr;
+}
+
+void AssetDatabase::GetChildren(const std::string& directory, std::vector<const AssetEntry*>& out) const {
+    out.clear();
+    auto children = m_children.find(directory);
+    if (children == m_children.end()) {
+        return;
+    }
+
+    out.reserve(children->second.size());
+    for (const std::string& child : children->second) {
+        out.push_back(&m_entries.at(child).entry);
+    }
+    std::sort(out.begin(), out.end(), [](const AssetEntry* a, const AssetEntry* b) {
+        if (a->isDirectory != b->isDirectory) {
+            return a->isDirectory;
+        }
+        return NameLess(a->name, b->name);
+    });
+}
+
+std::string AssetDatabase::GetFullPath(const std::string& path) const {
+    return m_root + path;
+}
+
+void AssetDatabase::ScanLoop() {
+    while (true) {
+        std::pair<std::string, uint32_t> request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || !m_requests.empty(); });
+            if (m_stop) {
+                return;
+            }
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+        ScanDirectory(request.first, request.second);
+    }
+}
+
+void AssetDatabase::ScanDirectory(const std::string& directory, uint32_t scanId) {
+    ScanResult batch;
+    batch.scanId = scanId;
+    batch.directory = directory;
+
+    auto flush = [&](bool finished) {
+        batch.finished = finished;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(batch));
+        batch = ScanResult();
+        batch.scanId = scanId;
+        batch.directory = directory;
+    };
+
+    std::error_code error;
+    fs::path start = fs::u8path(m_root + directory);
+    fs::recursive_directory_iterator it(start, fs::directory_options::skip_permission_denied, error);
+    fs::recursive_directory_iterator end;
+
+    // Errors part way through just end the walk, the finished message still goes out so the count drops
+    while (!error && it != end && !m_stop) {
+        const fs::directory_entry& entry = *it;
+        std::string name = entry.path().filename().u8string();
+        bool isDirectory = entry.is_directory(error);
+
+        if (!name.empty() && name[0] == '.') {
+            if (isDirectory) {
+                it.disable_recursion_pending();
+            }
+        } else {
+            std::string path = entry.path().lexically_relative(fs::u8path(m_root)).generic_u8string();
+            std::error_code sizeError;
+            uint64_t size = isDirectory ? 0 : entry.file_size(sizeError);
+            batch.entries.push_back(MakeEntry(path, isDirectory, sizeError ? 0 : size, WriteTime(entry)));
+            if (batch.entries.size() >= SCAN_BATCH_SIZE) {
+                flush(false);
+            }
+        }
+        it.increment(error);
+    }
+
+    if (error) {
+        BS_WARN_F(Blacksite::LogCategory::EDITOR, "AssetDatabase: Scan of '%s' stopped early: %s",
+                  (m_root + directory).c_str(), error.message().c_str());
+    }
+    flush(true);
+}
+
+AssetEntry AssetDatabase::MakeEntry(const std::string& path, bool isDirectory, uint64_t size, int64_t modified) {
+    AssetEntry entry;
+    entry.path = path;
+    entry.isDirectory = isDirectory;
+    entry.size = size;
+    entry.modified = modified;
+
+    size_t slash = path.find_last_of('/');
+    entry.name = slash == std::string::npos ? path : path.substr(slash + 1);
+    entry.parent = slash == std::string::npos ? std::string() : path.substr(0, slash);
+
+    size_t dot = entry.name.find_last_of('.');
+    if (!isDirectory && dot != std::string::npos && dot > 0) {
+        entry.extension = entry.name.substr(dot);
+        std::transform(entry.extension.begin(), entry.extension.end(), entry.extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    }
+    return entry;
+}
+
+bool AssetDatabase::Load() {
+    std::ifstream file(m_cachePath);
+    std::string line;
+    if (!file || !std::getline(file, line) || line != DB_HEADER) {
+        return false;
+    }
+
+    // One entry per line: D|F <tab> size <tab> modified <tab> path. Parents come before their children.
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string type, size, modified, path;
+        if (!std::getline(fields, type, '\t') || !std::getline(fields, size, '\t') ||
+            !std::getline(fields, modified, '\t') || !std::getline(fields, path) || path.empty()) {
+            continue;
+        }
+        try {
+            Upsert(MakeEntry(path, type == "D", std::stoull(size), std::stoll(modified)), 0);
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    m_dirty = false;
+    return true;
+}
+
+void AssetDatabase::Save() {
+    BS_PROFILE_SCOPE("AssetDatabase::Save");
+
+    std::error_code error;
+    fs::path target(m_cachePath);
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path(), error);
+    }
+
+    // Written next to it and renamed over, a crash mid-save leaves the old index instead of half of one
+    std::string temp = m_cachePath + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        if (!file) {
+            BS_WARN_F(Blacksite::LogCategory::EDITOR, "AssetDatabase: Can't write %s", temp.c_str());
+            return;
+        }
+
+        std::vector<const std::string*> paths;
+        paths.reserve(m_entries.size());
+        for (const auto& [path, node] : m_entries) {
+            paths.push_back(&path);
+        }
+        std::sort(paths.begin(), paths.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+        file << DB_HEADER << '\n';
+        for (const std::string* path : paths) {
+            const AssetEntry& entry = m_entries.at(*path).entry;
+            file << (entry.isDirectory ? 'D' : 'F') << '\t' << entry.size << '\t' << entry.modified << '\t'
+                 << entry.path << '\n';
+        }
+    }
+
+    fs::rename(temp, target, error);
+    if (error) {
+        BS_WARN_F(Blacksite::LogCategory::EDITOR, "AssetDatabase: Can't replace %s: %s", m_cachePath.c_str(),
+                  error.message().c_str());
+        return;
+    }
+    m_dirty = false;
+}
+
+}  // namespace BlacksiteEditor
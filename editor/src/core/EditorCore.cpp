@@ -2,6 +2,7 @@
 #include <blacksite/core/EntitySystem.h>
 #include <blacksite/core/Logger.h>
 #include <blacksite/scene/Scene.h>
+#include <blacksite/scene/SceneSerializer.h>
 
 namespace BlacksiteEditor {
 
@@ -52,28 +53,26 @@ void EditorCore::SaveScene(const std::string& filename) {
         return;
     }
 
-    // TODO: Implement scene serialization
-    // For now, just log the action
-    BS_INFO_F(Blacksite::LogCategory::CORE, "Saving scene '%s' to: %s", scene->GetName().c_str(), filename.c_str());
-
-    // Future implementation would serialize the scene to JSON/binary format
-    // scene->Serialize(filename);
+    // .json is the diffable text export, anything else gets the binary format
+    bool json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+    bool saved = json ? Blacksite::SceneSerializer::ExportJson(*scene, filename)
+                      : Blacksite::SceneSerializer::Save(*scene, filename);
+    if (saved) {
+        BS_INFO_F(Blacksite::LogCategory::CORE, "Saved scene '%s' to: %s", scene->GetName().c_str(), filename.c_str());
+    }
 }
 
 void EditorCore::LoadScene(const std::string& filename) {
-    if (!m_engine)
+    auto* scene = GetActiveScene();
+    if (!scene) {
+        BS_WARN(Blacksite::LogCategory::CORE, "No active scene to load into");
         return;
+    }
 
-    // TODO: Implement scene deserialization
-    // For now, just log the action
-    BS_INFO_F(Blacksite::LogCategory::CORE, "Loading scene from: %s", filename.c_str());
-
-    // Future implementation would deserialize from file
-    // auto scene = Scene::Deserialize(filename);
-    // if (scene) {
-    //     m_engine->AddScene(scene);
-    //     m_engine->SwitchToScene(scene->GetName());
-    // }
+    m_selectedEntityId = -1;  // Ids from before the load don't point at anything anymore
+    if (Blacksite::SceneSerializer::Load(*scene, filename)) {
+        BS_INFO_F(Blacksite::LogCategory::CORE, "Loaded scene from: %s", filename.c_str());
+    }
 }
 
 int EditorCore::CreateEntity(const std::string& type) {
@@ -164,41 +163,45 @@ int EditorCore::DuplicateEntity(int entityId) {
         return -1;
     }
 
-    auto* originalEntity = entitySystem->GetEntityPtr(entityId);
+    const Blacksite::Entity* originalEntity = entitySystem->GetEntityPtr(entityId);
     if (!originalEntity) {
         BS_ERROR_F(Blacksite::LogCategory::CORE, "Could not get entity pointer for ID: %d", entityId);
         return -1;
     }
 
     // Create new entity of the same type
-    glm::vec3 newPosition = originalEntity->transform.position + glm::vec3(2.0f, 0.0f, 0.0f);
+    glm::vec3 newPosition = originalEntity->GetTransform().position + glm::vec3(2.0f, 0.0f, 0.0f);
     int newEntityId = -1;
 
-    switch (originalEntity->shape) {
+    switch (originalEntity->GetRender().shape) {
         case Blacksite::Entity::CUBE:
-            newEntityId = scene->SpawnCube(newPosition, originalEntity->shader, originalEntity->color);
+            newEntityId = scene->SpawnCube(newPosition, originalEntity->shader, originalEntity->GetRender().color);
             break;
         case Blacksite::Entity::SPHERE:
-            newEntityId = scene->SpawnSphere(newPosition, originalEntity->shader, originalEntity->color);
+            newEntityId = scene->SpawnSphere(newPosition, originalEntity->shader, originalEntity->GetRender().color);
             break;
         case Blacksite::Entity::PLANE:
-            newEntityId = scene->SpawnPlane(newPosition, originalEntity->transform.scale, originalEntity->shader,
-                                            originalEntity->color);
+            newEntityId = scene->SpawnPlane(newPosition, originalEntity->GetTransform().scale, originalEntity->shader,
+                                            originalEntity->GetRender().color);
+            break;
+        case Blacksite::Entity::MESH:
+            newEntityId = scene->SpawnMesh(originalEntity->mesh, newPosition, originalEntity->shader,
+                                           originalEntity->GetRender().color);
             break;
         default:
             BS_ERROR_F(Blacksite::LogCategory::CORE, "Unknown entity shape for duplication: %d",
-                       static_cast<int>(originalEntity->shape));
+                       static_cast<int>(originalEntity->GetRender().shape));
             return -1;
     }
 
     if (newEntityId >= 0) {
         // Copy properties from original
         auto newEntityHandle = scene->GetEntity(newEntityId);
-        newEntityHandle.Scale(originalEntity->transform.scale);
+        newEntityHandle.Scale(originalEntity->GetTransform().scale);
 
         // Copy physics state
-        if (originalEntity->hasPhysics) {
-            if (originalEntity->isDynamic) {
+        if (originalEntity->GetPhysics().hasPhysics) {
+            if (originalEntity->GetPhysics().isDynamic) {
                 newEntityHandle.MakeDynamic();
             } else {
                 newEntityHandle.MakeStatic();
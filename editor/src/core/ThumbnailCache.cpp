@@ -0,0 +1,234 @@
+#include "blacksite_editor/core/ThumbnailCache.h"
+#include <GL/glew.h>
+#include <blacksite/core/Profiler.h>
+#include <blacksite/graphics/ImageLoader.h>
+#include <algorithm>
+
+namespace BlacksiteEditor {
+
+namespace {
+
+// Box filter down (or nearest up) to fit the tile, centered with transparent borders
+std::vector<uint8_t> FitToTile(const Blacksite::ImageData& image) {
+    constexpr int size = ThumbnailCache::TILE_SIZE;
+    std::vector<uint8_t> tile(size * size * 4, 0);
+
+    float scale = std::min(static_cast<float>(size) / image.width, static_cast<float>(size) / image.height);
+    int width = std::clamp(static_cast<int>(image.width * scale + 0.5f), 1, size);
+    int height = std::clamp(static_cast<int>(image.height * scale + 0.5f), 1, size);
+    int left = (size - width) / 2;
+    int top = (size - height) / 2;
+
+    for (int y = 0; y < height; ++y) {
+        int y0 = static_cast<int>(static_cast<int64_t>(y) * image.height / height);
+        int y1 = std::max(y0 + 1, static_cast<int>(static_cast<int64_t>(y + 1) * image.height / height));
+        for (int x = 0; x < width; ++x) {
+            int x0 = static_cast<int>(static_cast<int64_t>(x) * image.width / width);
+            int x1 = std::max(x0 + 1, static_cast<int>(static_cast<int64_t>(x + 1) * image.width / width));
+
+            uint32_t sum[4] = {0, 0, 0, 0};
+            for (int sy = y0; sy < y1; ++sy) {
+                const uint8_t* src = &image.rgba[(static_cast<size_t>(sy) * image.width + x0) * 4];
+                for (int sx = x0; sx < x1; ++sx, src += 4) {
+                    sum[0] += src[0];
+                    sum[1] += src[1];
+                    sum[2] += src[2];
+                    sum[3] += src[3];
+                }
+            }
+            uint32_t count = static_cast<uint32_t>((y1 - y0) * (x1 - x0));
+            uint8_t* dst = &tile[((top + y) * size + left + x) * 4];
+            for (int c = 0; c < 4; ++c) {
+                dst[c] = static_cast<uint8_t>(sum[c] / count);
+            }
+        }
+    }
+    return tile;
+}
+
+std::vector<uint8_t> DecodeThumbnail(const std::string& path) {
+    Blacksite::ImageData image;
+    return Blacksite::ImageLoader::Load(path, image) ? FitToTile(image) : std::vector<uint8_t>();
+}
+
+}  // namespace
+
+void ThumbnailCache::Initialize() {
+    if (m_atlas) {
+        return;
+    }
+
+    glGenTextures(1, &m_atlas);
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    int tilesPerRow = ATLAS_SIZE / TILE_SIZE;
+    m_tileCount = static_cast<size_t>(tilesPerRow * tilesPerRow);
+    m_tileOwners.assign(m_tileCount, std::string());
+    m_freeTiles.clear();
+    for (int tile = static_cast<int>(m_tileCount) - 1; tile >= 0; --tile) {
+        m_freeTiles.push_back(tile);
+    }
+}
+
+void ThumbnailCache::Shutdown() {
+    // The jobs write into this object, they have to be done before it goes
+    Blacksite::JobSystem::Get().Wait(m_jobs);
+    m_decoded.clear();
+    m_thumbnails.clear();
+    m_tileOwners.clear();
+    m_freeTiles.clear();
+    m_tileCount = 0;
+    m_inFlight = 0;
+
+    if (m_atlas) {
+        glDeleteTextures(1, &m_atlas);
+        m_atlas = 0;
+    }
+}
+
+bool ThumbnailCache::CanDecode(const std::string& extension) {
+    return Blacksite::ImageLoader::IsSupported(extension);
+}
+
+void ThumbnailCache::Update() {
+    BS_PROFILE_SCOPE("ThumbnailCache::Update");
+
+    ++m_frame;
+    for (int uploads = 0; uploads < MAX_UPLOADS_PER_FRAME; ++uploads) {
+        Decoded decoded;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_decoded.empty()) {
+                break;
+            }
+            decoded = std::move(m_decoded.front());
+            m_decoded.pop_front();
+        }
+        --m_inFlight;
+
+        auto it = m_thumbnails.find(decoded.path);
+        if (it == m_thumbnails.end()) {
+            continue;
+        }
+        Thumbnail& thumbnail = it->second;
+
+        // Changed while it was decoding - forget it, the next Get starts over with the new version
+        if (thumbnail.modified != decoded.modified) {
+            m_thumbnails.erase(it);
+            continue;
+        }
+        if (decoded.pixels.empty()) {
+            thumbnail.state = State::Failed;
+            continue;
+        }
+
+        int tile = AllocateTile();
+        if (tile < 0) {
+            // Every tile is on screen, try again once some scroll away
+            m_thumbnails.erase(it);
+            continue;
+        }
+        Upload(tile, decoded.pixels);
+        thumbnail.tile = tile;
+        thumbnail.state = State::Ready;
+        m_tileOwners[tile] = decoded.path;
+    }
+}
+
+bool ThumbnailCache::Get(const std::string& fullPath, int64_t modified, uint32_t& texture, float uv0[2],
+                         float uv1[2]) {
+    if (!m_atlas) {
+        return false;
+    }
+
+    auto it = m_thumbnails.find(fullPath);
+    if (it != m_thumbnails.end() && it->second.modified != modified && it->second.state != State::Queued) {
+        // The file changed, give its tile back and decode it again
+        if (it->second.tile >= 0) {
+            m_tileOwners[it->second.tile].clear();
+            m_freeTiles.push_back(it->second.tile);
+        }
+        m_thumbnails.erase(it);
+        it = m_thumbnails.end();
+    }
+
+    if (it != m_thumbnails.end()) {
+        Thumbnail& thumbnail = it->second;
+        thumbnail.lastUsed = m_frame;
+        if (thumbnail.state != State::Ready) {
+            return false;
+        }
+
+        int tilesPerRow = ATLAS_SIZE / TILE_SIZE;
+        float tileUv = static_cast<float>(TILE_SIZE) / ATLAS_SIZE;
+        texture = m_atlas;
+        uv0[0] = (thumbnail.tile % tilesPerRow) * tileUv;
+        uv0[1] = (thumbnail.tile / tilesPerRow) * tileUv;
+        uv1[0] = uv0[0] + tileUv;
+        uv1[1] = uv0[1] + tileUv;
+        return true;
+    }
+
+    if (m_inFlight >= MAX_IN_FLIGHT) {
+        return false;
+    }
+
+    Thumbnail& thumbnail = m_thumbnails[fullPath];
+    thumbnail.modified = modified;
+    thumbnail.lastUsed = m_frame;
+    ++m_inFlight;
+
+    Blacksite::JobSystem::Get().Run(
+        [this, fullPath, modified] {
+            Decoded decoded;
+            decoded.path = fullPath;
+            decoded.modified = modified;
+            decoded.pixels = DecodeThumbnail(fullPath);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_decoded.push_back(std::move(decoded));
+        },
+        &m_jobs);
+    return false;
+}
+
+int ThumbnailCache::AllocateTile() {
+    if (!m_freeTiles.empty()) {
+        int tile = m_freeTiles.back();
+        m_freeTiles.pop_back();
+        return tile;
+    }
+
+    // Least recently drawn, as long as it wasn't drawn last frame (it would flicker)
+    int oldest = -1;
+    uint64_t oldestFrame = m_frame;
+    for (size_t tile = 0; tile < m_tileOwners.size(); ++tile) {
+        auto it = m_thumbnails.find(m_tileOwners[tile]);
+        if (it != m_thumbnails.end() && it->second.lastUsed + 1 < oldestFrame) {
+            oldest = static_cast<int>(tile);
+            oldestFrame = it->second.lastUsed + 1;
+        }
+    }
+    if (oldest >= 0) {
+        m_thumbnails.erase(m_tileOwners[oldest]);
+        m_tileOwners[oldest].clear();
+    }
+    return oldest;
+}
+
+void ThumbnailCache::Upload(int tile, const std::vector<uint8_t>& pixels) {
+    int tilesPerRow = ATLAS_SIZE / TILE_SIZE;
+    glBindTexture(GL_TEXTURE_2D, m_atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, (tile % tilesPerRow) * TILE_SIZE, (tile / tilesPerRow) * TILE_SIZE,
+                    TILE_SIZE, TILE_SIZE, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+}  // namespace BlacksiteEditor
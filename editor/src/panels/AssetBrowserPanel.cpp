@@ -1,16 +1,29 @@
 #include "blacksite_editor/panels/AssetBrowserPanel.h"
 #include "blacksite_editor/core/EditorCore.h"
+#include <blacksite/core/FramePacer.h>
 #include <imgui.h>
 #include <algorithm>
 
 namespace BlacksiteEditor {
 
 AssetBrowserPanel::AssetBrowserPanel(EditorCore* editorCore) : m_editorCore(editorCore) {
-    RefreshCurrentDirectory();
+    m_thumbnails.Initialize();
+    m_database.Open("assets/");
+}
+
+AssetBrowserPanel::~AssetBrowserPanel() {
+    m_database.Close();
+    m_thumbnails.Shutdown();
 }
 
 void AssetBrowserPanel::Update(float deltaTime) {
-    // Update logic if needed
+    m_database.Update();
+    m_thumbnails.Update();
+
+    // Results trickle in from other threads, keep an idle editor drawing until they're all in
+    if (m_database.IsScanning() || m_thumbnails.GetPendingCount() > 0) {
+        Blacksite::FramePacer::RequestRedraw();
+    }
 }
 
 void AssetBrowserPanel::Render() {
@@ -25,163 +38,159 @@ void AssetBrowserPanel::Render() {
     ImGui::End();
 }
 
-void AssetBrowserPanel::RefreshCurrentDirectory() {
-    m_currentItems.clear();
-
-    try {
-        // Add parent directory option (if not at root)
-        if (m_currentPath != "assets/" && m_currentPath.find("assets/") == 0) {
-            AssetItem parentItem;
-            parentItem.name = "..";
-            parentItem.path = m_currentPath;
-            parentItem.isDirectory = true;
-            m_currentItems.push_back(parentItem);
-        }
-
-        // For now, add some mock assets since we don't have filesystem scanning
-        // In a real implementation, you'd scan the actual directory
-
-        // Mock directories
-        if (m_currentPath == "assets/") {
-            m_currentItems.push_back({"textures", "assets/textures/", "", true});
-            m_currentItems.push_back({"models", "assets/models/", "", true});
-            m_currentItems.push_back({"shaders", "assets/shaders/", "", true});
-            m_currentItems.push_back({"audio", "assets/audio/", "", true});
-            m_currentItems.push_back({"scenes", "assets/scenes/", "", true});
-        }
-
-        // Mock files based on directory
-        if (m_currentPath == "assets/textures/") {
-            m_currentItems.push_back({"default.png", "assets/textures/default.png", ".png", false});
-            m_currentItems.push_back({"wood.jpg", "assets/textures/wood.jpg", ".jpg", false});
-            m_currentItems.push_back({"metal.tga", "assets/textures/metal.tga", ".tga", false});
-        } else if (m_currentPath == "assets/models/") {
-            m_currentItems.push_back({"cube.obj", "assets/models/cube.obj", ".obj", false});
-            m_currentItems.push_back({"sphere.fbx", "assets/models/sphere.fbx", ".fbx", false});
-            m_currentItems.push_back({"character.dae", "assets/models/character.dae", ".dae", false});
-        } else if (m_currentPath == "assets/shaders/") {
-            m_currentItems.push_back({"basic.vert", "assets/shaders/basic.vert", ".vert", false});
-            m_currentItems.push_back({"basic.frag", "assets/shaders/basic.frag", ".frag", false});
-            m_currentItems.push_back({"unlit.glsl", "assets/shaders/unlit.glsl", ".glsl", false});
-        } else if (m_currentPath == "assets/scenes/") {
-            m_currentItems.push_back({"test_scene.bscn", "assets/scenes/test_scene.bscn", ".bscn", false});
-            m_currentItems.push_back({"demo.bscn", "assets/scenes/demo.bscn", ".bscn", false});
-        }
-
-    } catch (...) {
-        // Handle filesystem errors
-        AssetItem errorItem;
-        errorItem.name = "Error reading directory";
-        errorItem.isDirectory = false;
-        m_currentItems.push_back(errorItem);
-    }
-}
-
 void AssetBrowserPanel::NavigateToPath(const std::string& path) {
     m_currentPath = path;
-    m_selectedItem = -1;
-    RefreshCurrentDirectory();
+    m_selectedPath.clear();
+    m_listedVersion = UINT64_MAX;
 }
 
 void AssetBrowserPanel::RenderDirectoryNavigation() {
     // Current path display
-    ImGui::Text("Path: %s", m_currentPath.c_str());
+    ImGui::Text("Path: %s%s", m_database.GetRoot().c_str(), m_currentPath.c_str());
 
     // Navigation buttons
     if (ImGui::Button("Assets Root")) {
-        NavigateToPath("assets/");
+        NavigateToPath("");
     }
 
     ImGui::SameLine();
     if (ImGui::Button("Refresh")) {
-        RefreshCurrentDirectory();
+        m_database.Rescan(m_currentPath);
     }
 
     ImGui::SameLine();
-    if (ImGui::Button("Up") && m_currentPath != "assets/") {
+    if (ImGui::Button("Up") && !m_currentPath.empty()) {
         // Navigate to parent directory
-        size_t lastSlash = m_currentPath.find_last_of('/', m_currentPath.length() - 2);
-        if (lastSlash != std::string::npos) {
-            NavigateToPath(m_currentPath.substr(0, lastSlash + 1));
-        }
+        size_t lastSlash = m_currentPath.find_last_of('/');
+        NavigateToPath(lastSlash != std::string::npos ? m_currentPath.substr(0, lastSlash) : "");
+    }
+
+    // Scan status
+    ImGui::SameLine();
+    if (m_database.IsScanning()) {
+        ImGui::TextDisabled("Scanning... %zu assets", m_database.GetAssetCount());
+    } else {
+        ImGui::TextDisabled("%zu assets%s", m_database.GetAssetCount(),
+                            m_database.IsWatching() ? "" : " (not watching for changes)");
     }
 }
 
 void AssetBrowserPanel::RenderAssetGrid() {
+    // Only re-listed when something in the index changed, a big directory is sorted once, not every frame
+    if (m_listedVersion != m_database.GetVersion()) {
+        m_database.GetChildren(m_currentPath, m_currentItems);
+        m_listedVersion = m_database.GetVersion();
+    }
+
+    const AssetEntry* selected = m_selectedPath.empty() ? nullptr : m_database.Find(m_selectedPath);
+    float footerHeight = selected ? ImGui::GetFrameHeightWithSpacing() * 3.0f : 0.0f;
+
     // Asset grid
-    float panelWidth = ImGui::GetContentRegionAvail().x;
+    const ImGuiStyle& style = ImGui::GetStyle();
     float itemSize = 80.0f;
-    int columns = std::max(1, (int)(panelWidth / (itemSize + ImGui::GetStyle().ItemSpacing.x)));
-
-    ImGui::Columns(columns, nullptr, false);
+    float panelWidth = ImGui::GetContentRegionAvail().x;
+    int columns = std::max(1, (int)((panelWidth + style.ItemSpacing.x) / (itemSize + style.ItemSpacing.x)));
+    int rows = ((int)m_currentItems.size() + columns - 1) / columns;
+    float rowHeight = itemSize + ImGui::GetTextLineHeightWithSpacing() + style.ItemSpacing.y;
 
-    for (int i = 0; i < m_currentItems.size(); ++i) {
-        const auto& item = m_currentItems[i];
+    if (ImGui::BeginChild("AssetGrid", ImVec2(0, -footerHeight))) {
+        if (m_currentItems.empty()) {
+            ImGui::TextDisabled(m_database.IsScanning() ? "Scanning..." : "Empty");
+        }
 
-        ImGui::PushID(i);
+        // Clipped by rows, only what's scrolled into view gets laid out - and asks for a thumbnail
+        ImGuiListClipper clipper;
+        clipper.Begin(rows, rowHeight);
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                for (int column = 0; column < columns; ++column) {
+                    size_t index = (size_t)row * columns + column;
+                    if (index >= m_currentItems.size()) {
+                        break;
+                    }
+                    if (column > 0) {
+                        ImGui::SameLine();
+                    }
+                    ImGui::PushID((int)index);
+                    RenderAssetItem(*m_currentItems[index], itemSize);
+                    ImGui::PopID();
+                }
+            }
+        }
+    }
+    ImGui::EndChild();
 
-        // Item button
-        bool isSelected = (m_selectedItem == i);
-        if (isSelected) {
-            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.3f, 0.5f, 0.8f, 1.0f));
+    // Selected item info
+    if (selected) {
+        ImGui::Separator();
+        ImGui::Text("Selected: %s", selected->name.c_str());
+        ImGui::Text("Path: %s", m_database.GetFullPath(selected->path).c_str());
+        if (!selected->isDirectory) {
+            ImGui::Text("Type: %s  Size: %.1f KB", selected->extension.c_str(), selected->size / 1024.0);
         }
+    }
+}
+
+void AssetBrowserPanel::RenderAssetItem(const AssetEntry& item, float itemSize) {
+    ImGui::BeginGroup();
+
+    // Item button
+    bool isSelected = (m_selectedPath == item.path);
+    if (isSelected) {
+        ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.3f, 0.5f, 0.8f, 1.0f));
+    }
 
-        // Choose icon based on type (removed emojis for professionalism and compatibility)
-        const char* icon = ""; // Default file
+    // Thumbnail if there is one yet, otherwise a plain button labeled with the type
+    bool clicked = false;
+    uint32_t texture = 0;
+    float uv0[2], uv1[2];
+    if (!item.isDirectory && ThumbnailCache::CanDecode(item.extension) &&
+        m_thumbnails.Get(m_database.GetFullPath(item.path), item.modified, texture, uv0, uv1)) {
+        ImVec2 padding = ImGui::GetStyle().FramePadding;
+        clicked = ImGui::ImageButton("##thumbnail", (ImTextureID)(intptr_t)texture,
+                                     ImVec2(itemSize - padding.x * 2.0f, itemSize - padding.y * 2.0f),
+                                     ImVec2(uv0[0], uv0[1]), ImVec2(uv1[0], uv1[1]));
+    } else {
+        const char* label = "File";
         if (item.isDirectory) {
-            icon = "";
+            label = "Folder";
         } else if (IsImageFile(item.extension)) {
-            icon = "";
+            label = "Image";
         } else if (IsModelFile(item.extension)) {
-            icon = "";
+            label = "Model";
         } else if (IsAudioFile(item.extension)) {
-            icon = "";
+            label = "Audio";
         } else if (item.extension == ".bscn") {
-            icon = "";
+            label = "Scene";
         } else if (item.extension == ".vert" || item.extension == ".frag" || item.extension == ".glsl") {
-            icon = "";
-        }
-
-        if (ImGui::Button((std::string(icon) + "\n" + item.name).c_str(), ImVec2(itemSize, itemSize))) {
-            m_selectedItem = i;
-
-            if (item.isDirectory) {
-                if (item.name == "..") {
-                    // Navigate up
-                    size_t lastSlash = m_currentPath.find_last_of('/', m_currentPath.length() - 2);
-                    if (lastSlash != std::string::npos) {
-                        NavigateToPath(m_currentPath.substr(0, lastSlash + 1));
-                    }
-                } else {
-                    // Navigate into directory
-                    NavigateToPath(item.path);
-                }
-            }
-        }
-
-        if (isSelected) {
-            ImGui::PopStyleColor();
+            label = "Shader";
         }
+        clicked = ImGui::Button(label, ImVec2(itemSize, itemSize));
+    }
 
-        // Tooltip with full path
-        if (ImGui::IsItemHovered()) {
-            ImGui::SetTooltip("%s", item.path.c_str());
-        }
+    if (isSelected) {
+        ImGui::PopStyleColor();
+    }
 
-        ImGui::PopID();
-        ImGui::NextColumn();
+    // Tooltip with full path
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("%s", m_database.GetFullPath(item.path).c_str());
     }
 
-    ImGui::Columns(1);
+    // Name under the button, clipped to its width so every cell stays the same size
+    ImVec2 textPos = ImGui::GetCursorScreenPos();
+    ImVec4 clipRect(textPos.x, textPos.y, textPos.x + itemSize, textPos.y + ImGui::GetTextLineHeight());
+    ImGui::GetWindowDrawList()->AddText(nullptr, 0.0f, textPos, ImGui::GetColorU32(ImGuiCol_Text),
+                                        item.name.c_str(), nullptr, 0.0f, &clipRect);
+    ImGui::Dummy(ImVec2(itemSize, ImGui::GetTextLineHeight()));
 
-    // Selected item info
-    if (m_selectedItem >= 0 && m_selectedItem < m_currentItems.size()) {
-        const auto& selected = m_currentItems[m_selectedItem];
-        ImGui::Separator();
-        ImGui::Text("Selected: %s", selected.name.c_str());
-        ImGui::Text("Path: %s", selected.path.c_str());
-        if (!selected.isDirectory) {
-            ImGui::Text("Type: %s", selected.extension.c_str());
+    ImGui::EndGroup();
+
+    if (clicked) {
+        m_selectedPath = item.path;
+        if (item.isDirectory) {
+            // Navigate into directory
+            NavigateToPath(item.path);
         }
     }
 }
@@ -196,7 +205,7 @@ void AssetBrowserPanel::RenderAssetContextMenu() {
         }
         ImGui::Separator();
         if (ImGui::MenuItem("Refresh")) {
-            RefreshCurrentDirectory();
+            m_database.Rescan(m_currentPath);
         }
         ImGui::EndPopup();
     }
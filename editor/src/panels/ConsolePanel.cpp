@@ -2,7 +2,11 @@
 #include "blacksite_editor/core/EditorCore.h"
 #include <blacksite/scene/Scene.h>
 #include <blacksite/core/EntitySystem.h>
+#include <blacksite/core/Logger.h>
+#include <blacksite/core/Profiler.h>
+#include <blacksite/graphics/GLDebug.h>
 #include <imgui.h>
+#include <algorithm>
 #include <cstring>
 
 namespace BlacksiteEditor {
@@ -13,14 +17,7 @@ ConsolePanel::ConsolePanel(EditorCore* editorCore) : m_editorCore(editorCore) {
 }
 
 void ConsolePanel::Update(float deltaTime) {
-    // Simulate periodic log entries for testing
-    static float timer = 0.0f;
-    timer += deltaTime;
-
-    if (timer > 10.0f) {
-        AddLogEntry("System heartbeat - all systems operational");
-        timer = 0.0f;
-    }
+    (void)deltaTime;  // Nothing to poll, the Logger keeps the history and we read it while drawing
 }
 
 void ConsolePanel::Render() {
@@ -29,19 +26,22 @@ void ConsolePanel::Render() {
     if (ImGui::Begin("Console", &m_isOpen)) {
         // Console controls
         if (ImGui::Button("Clear")) {
-            m_logEntries.clear();
+            m_firstSequence = Blacksite::Logger::Instance().GetHistorySequence();
+            ResetVisible();
         }
         ImGui::SameLine();
         ImGui::Checkbox("Auto-scroll", &m_autoScroll);
 
         // Log level filters
         ImGui::SameLine();
-        static bool showInfo = true, showWarning = true, showError = true;
-        ImGui::Checkbox("Info", &showInfo);
+        bool filterChanged = ImGui::Checkbox("Info", &m_showInfo);
         ImGui::SameLine();
-        ImGui::Checkbox("Warning", &showWarning);
+        filterChanged |= ImGui::Checkbox("Warning", &m_showWarning);
         ImGui::SameLine();
-        ImGui::Checkbox("Error", &showError);
+        filterChanged |= ImGui::Checkbox("Error", &m_showError);
+        if (filterChanged) {
+            ResetVisible();
+        }
 
         ImGui::Separator();
 
@@ -52,15 +52,10 @@ void ConsolePanel::Render() {
 }
 
 void ConsolePanel::AddLogEntry(const std::string& message, int level) {
-    static float time = 0.0f;
-    time += 0.016f; // Approximate time increment
-
-    m_logEntries.push_back({message, level, time});
-
-    // Limit log entries to prevent memory issues
-    if (m_logEntries.size() > 1000) {
-        m_logEntries.erase(m_logEntries.begin());
-    }
+    Blacksite::LogLevel logLevel = level == 2   ? Blacksite::LogLevel::ERROR
+                                   : level == 1 ? Blacksite::LogLevel::WARN
+                                                : Blacksite::LogLevel::INFO;
+    Blacksite::Logger::Instance().Log(logLevel, Blacksite::LogCategory::EDITOR, message);
 }
 
 void ConsolePanel::ProcessCommand(const std::string& command) {
@@ -76,9 +71,12 @@ void ConsolePanel::ProcessCommand(const std::string& command) {
         AddLogEntry("  select <id> - Select entity by ID");
         AddLogEntry("  camera <x> <y> <z> - Set camera position");
         AddLogEntry("  info - Show engine information");
+        AddLogEntry("  gldebug <on|off> - Toggle OpenGL debug output");
+        AddLogEntry("  profile <on|off|save [path]> - Record CPU scopes, save as a Chrome trace");
     }
     else if (command == "clear") {
-        m_logEntries.clear();
+        m_firstSequence = Blacksite::Logger::Instance().GetHistorySequence();
+        ResetVisible();
         AddLogEntry("Console cleared");
     }
     else if (command.substr(0, 6) == "create") {
@@ -132,10 +130,12 @@ void ConsolePanel::ProcessCommand(const std::string& command) {
                 const auto& entities = entitySystem->GetEntities();
                 AddLogEntry("Entities in scene:");
                 int count = 0;
-                for (const auto& entity : entities) {
-                    if (entity.active) {
-                        std::string shapeStr = (entity.shape == Blacksite::Entity::CUBE) ? "Cube" :
-                                             (entity.shape == Blacksite::Entity::SPHERE) ? "Sphere" : "Plane";
+                for (const Blacksite::Entity* slot : entities) {
+                    if (slot && slot->IsActive()) {
+                        const Blacksite::Entity& entity = *slot;
+                        std::string shapeStr = (entity.GetRender().shape == Blacksite::Entity::CUBE) ? "Cube" :
+                                             (entity.GetRender().shape == Blacksite::Entity::SPHERE) ? "Sphere" :
+                                             (entity.GetRender().shape == Blacksite::Entity::PLANE) ? "Plane" : "Mesh";
                         std::string info = "  [" + std::to_string(entity.id) + "] " +
                                          entity.name + " (" + shapeStr + ")";
                         AddLogEntry(info);
@@ -158,6 +158,36 @@ void ConsolePanel::ProcessCommand(const std::string& command) {
             AddLogEntry("  Active Scene: " + scene->GetName());
         }
     }
+    else if (command.substr(0, 7) == "gldebug") {
+        std::string arg = command.length() > 8 ? command.substr(8) : "";
+        if (arg == "on" || arg == "off") {
+            Blacksite::GLDebug::SetEnabled(arg == "on");
+            if (arg == "on" && !Blacksite::GLDebug::HasDebugOutput()) {
+                AddLogEntry("No KHR_debug on this driver, falling back to glGetError checks", 1);
+            }
+        }
+        AddLogEntry(std::string("GL debug output: ") + (Blacksite::GLDebug::IsEnabled() ? "on" : "off"));
+    }
+    else if (command.substr(0, 7) == "profile") {
+        std::string arg = command.length() > 8 ? command.substr(8) : "";
+        if (arg == "on" || arg == "off") {
+            if (arg == "on") {
+                Blacksite::Profiler::Clear();  // Fresh trace per recording
+            }
+            Blacksite::Profiler::SetEnabled(arg == "on");
+        } else if (arg.substr(0, 4) == "save") {
+            std::string path = arg.length() > 5 ? arg.substr(5) : "blacksite_trace.json";
+            bool wasEnabled = Blacksite::Profiler::IsEnabled();
+            Blacksite::Profiler::SetEnabled(false);
+            if (Blacksite::Profiler::ExportChromeTrace(path)) {
+                AddLogEntry("Trace saved to " + path + ", open it in chrome://tracing or ui.perfetto.dev");
+            } else {
+                AddLogEntry("Couldn't write " + path, 2);
+            }
+            Blacksite::Profiler::SetEnabled(wasEnabled);
+        }
+        AddLogEntry(std::string("CPU profiler: ") + (Blacksite::Profiler::IsEnabled() ? "recording" : "off"));
+    }
     else if (command.empty()) {
         // Do nothing for empty command
     }
@@ -166,28 +196,65 @@ void ConsolePanel::ProcessCommand(const std::string& command) {
     }
 }
 
+void ConsolePanel::ResetVisible() {
+    m_visible.clear();
+    m_seenSequence = m_firstSequence;
+}
+
+size_t ConsolePanel::UpdateVisible() {
+    auto& logger = Blacksite::Logger::Instance();
+
+    uint64_t first = std::max(m_firstSequence, logger.GetOldestHistorySequence());
+    while (!m_visible.empty() && m_visible.front() < first) {
+        m_visible.pop_front();
+    }
+
+    size_t before = m_visible.size();
+    auto filter = [this](uint64_t sequence, const Blacksite::LogEntry& entry) {
+        bool isError = entry.level >= Blacksite::LogLevel::ERROR;
+        bool isWarning = entry.level == Blacksite::LogLevel::WARN;
+        if ((isError && m_showError) || (isWarning && m_showWarning) || (!isError && !isWarning && m_showInfo)) {
+            m_visible.push_back(sequence);
+        }
+    };
+    m_seenSequence = logger.VisitHistory(std::max(m_seenSequence, first), filter);
+    return m_visible.size() - before;
+}
+
 void ConsolePanel::RenderLogDisplay() {
     const float footer_height = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
     ImGui::BeginChild("ScrollingRegion", ImVec2(0, -footer_height), false, ImGuiWindowFlags_HorizontalScrollbar);
 
-    for (const auto& entry : m_logEntries) {
-        ImVec4 color = ImVec4(0.8f, 0.8f, 0.8f, 1.0f); // Default info color
+    bool hasNew = UpdateVisible() > 0;
 
-        switch (entry.level) {
-            case 1: // Warning
-                color = ImVec4(1.0f, 1.0f, 0.0f, 1.0f);
-                break;
-            case 2: // Error
-                color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
-                break;
+    // Read in place out of the Logger's ring. No wrapping, so every row is one line and the clipper
+    // only has to draw what's on screen.
+    auto drawEntry = [](const Blacksite::LogEntry& entry) {
+        ImVec4 color = ImVec4(0.8f, 0.8f, 0.8f, 1.0f); // Default info color
+        if (entry.level == Blacksite::LogLevel::WARN) {
+            color = ImVec4(1.0f, 1.0f, 0.0f, 1.0f);
+        } else if (entry.level >= Blacksite::LogLevel::ERROR) {
+            color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
         }
 
         ImGui::PushStyleColor(ImGuiCol_Text, color);
-        ImGui::TextWrapped("[%.2f] %s", entry.timestamp, entry.message.c_str());
+        ImGui::Text("[%s] %s", entry.timestamp.c_str(), entry.message.c_str());
         ImGui::PopStyleColor();
+    };
+
+    auto& logger = Blacksite::Logger::Instance();
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(m_visible.size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            if (!logger.VisitHistoryEntry(m_visible[i], drawEntry)) {
+                ImGui::TextUnformatted("");  // Overwritten since the last update, keep the row height
+            }
+        }
     }
+    clipper.End();
 
-    if (m_autoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+    if (m_autoScroll && hasNew && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
         ImGui::SetScrollHereY(1.0f);
     }
 
@@ -23,7 +23,7 @@ void InspectorPanel::Render() {
                 auto* entitySystem = scene->GetEntitySystem();
                 if (entitySystem) {
                     auto* entity = entitySystem->GetEntityPtr(m_editorCore->GetSelectedEntity());
-                    if (entity && entity->active) {
+                    if (entity && entity->IsActive()) {
                         RenderEntityInspector(entity);
                     } else {
                         ImGui::Text("Selected entity is invalid or inactive");
@@ -40,6 +40,14 @@ void InspectorPanel::Render() {
     ImGui::End();
 }
 
+void InspectorPanel::MarkEntitiesChanged() {
+    // We edit the entity directly, so tell the entity system or the hierarchy keeps showing stale names
+    auto* scene = m_editorCore->GetActiveScene();
+    if (scene && scene->GetEntitySystem()) {
+        scene->GetEntitySystem()->MarkChanged();
+    }
+}
+
 void InspectorPanel::RenderEntityInspector(Blacksite::Entity* entity) {
     // Entity header with ID and active status
     ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[0]);
@@ -47,7 +55,11 @@ void InspectorPanel::RenderEntityInspector(Blacksite::Entity* entity) {
     ImGui::PopFont();
 
     ImGui::SameLine();
-    ImGui::Checkbox("##Active", &entity->active);
+    bool active = entity->IsActive();
+    if (ImGui::Checkbox("##Active", &active)) {
+        entity->SetActive(active);
+        MarkEntitiesChanged();
+    }
     if (ImGui::IsItemHovered()) {
         ImGui::SetTooltip("Entity Active");
     }
@@ -59,6 +71,7 @@ void InspectorPanel::RenderEntityInspector(Blacksite::Entity* entity) {
 
     if (ImGui::InputText("Name", nameBuffer, sizeof(nameBuffer))) {
         entity->name = nameBuffer;
+        MarkEntitiesChanged();
     }
 
     ImGui::Separator();
@@ -69,7 +82,7 @@ void InspectorPanel::RenderEntityInspector(Blacksite::Entity* entity) {
     }
 
     // Physics component
-    if (entity->hasPhysics) {
+    if (entity->GetPhysics().hasPhysics) {
         if (ImGui::CollapsingHeader("Physics", ImGuiTreeNodeFlags_DefaultOpen)) {
             RenderPhysicsComponent(entity);
         }
@@ -88,41 +101,48 @@ void InspectorPanel::RenderEntityInspector(Blacksite::Entity* entity) {
 }
 
 void InspectorPanel::RenderTransformComponent(Blacksite::Entity* entity) {
-    auto& transform = entity->transform;
+    // Edited on a copy - the writable GetTransform marks the entity dirty, which is only wanted on a real change
+    const Blacksite::Entity& current = *entity;
+    Blacksite::Transform transform = current.GetTransform();
+
+    // Rotation is a quaternion, the panel edits an Euler view of it
+    if (m_eulerEntity != entity->id || m_eulerSource != transform.rotation) {
+        m_eulerEntity = entity->id;
+        m_eulerView = transform.GetEulerRotation();
+    }
 
     // Store original values to detect changes
     glm::vec3 originalPos = transform.position;
-    glm::vec3 originalRot = transform.rotation;
+    glm::quat originalRot = transform.rotation;
     glm::vec3 originalScale = transform.scale;
 
     bool transformChanged = false;
 
     transformChanged |= DrawVec3Control("Position", transform.position);
-    transformChanged |= DrawVec3Control("Rotation", transform.rotation);
+    if (DrawVec3Control("Rotation", m_eulerView)) {
+        transform.SetEulerRotation(m_eulerView);
+        transformChanged = true;
+    }
+    m_eulerSource = transform.rotation;
     transformChanged |= DrawVec3Control("Scale", transform.scale, 1.0f);
 
     if (transformChanged) {
+        entity->GetTransform() = transform;
+
         // Update physics body if entity has physics
-        if (entity->hasPhysics) {
+        if (entity->GetPhysics().hasPhysics) {
             auto* scene = m_editorCore->GetActiveScene();
             if (scene) {
-                auto handle = scene->GetEntity(entity->id);
-
-                // Update position if changed
+                // Only what changed, all of it synced to the body at once
+                auto edit = scene->GetEntity(entity->id).Edit();
                 if (originalPos != transform.position) {
-                    handle.At(transform.position);
+                    edit.At(transform.position);
                 }
-
-                // Update rotation if changed
                 if (originalRot != transform.rotation) {
-                    handle.Rotate(transform.rotation);
+                    edit.Rotate(transform.rotation);
                 }
-
-                // Update scale if changed
                 if (originalScale != transform.scale) {
-                    handle.Scale(transform.scale);
-                    // For Jolt physics, scaling might require body recreation
-                    handle.RecreatePhysicsBodyWithScale(*entity, transform.scale);
+                    edit.Scale(transform.scale);
                 }
             }
         }
@@ -132,7 +152,8 @@ void InspectorPanel::RenderTransformComponent(Blacksite::Entity* entity) {
     ImGui::Spacing();
     if (ImGui::Button("Reset Position")) {
         transform.position = {0, 0, 0};
-        if (entity->hasPhysics) {
+        entity->GetTransform().position = transform.position;
+        if (entity->GetPhysics().hasPhysics) {
             auto* scene = m_editorCore->GetActiveScene();
             if (scene) {
                 scene->GetEntity(entity->id).At(transform.position);
@@ -141,8 +162,9 @@ void InspectorPanel::RenderTransformComponent(Blacksite::Entity* entity) {
     }
     ImGui::SameLine();
     if (ImGui::Button("Reset Rotation")) {
-        transform.rotation = {0, 0, 0};
-        if (entity->hasPhysics) {
+        transform.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        entity->GetTransform().rotation = transform.rotation;
+        if (entity->GetPhysics().hasPhysics) {
             auto* scene = m_editorCore->GetActiveScene();
             if (scene) {
                 scene->GetEntity(entity->id).Rotate(transform.rotation);
@@ -152,12 +174,11 @@ void InspectorPanel::RenderTransformComponent(Blacksite::Entity* entity) {
     ImGui::SameLine();
     if (ImGui::Button("Reset Scale")) {
         transform.scale = {1, 1, 1};
-        if (entity->hasPhysics) {
+        entity->GetTransform().scale = transform.scale;
+        if (entity->GetPhysics().hasPhysics) {
             auto* scene = m_editorCore->GetActiveScene();
             if (scene) {
-                auto handle = scene->GetEntity(entity->id);
-                handle.Scale(transform.scale);
-                handle.RecreatePhysicsBodyWithScale(*entity, transform.scale);
+                scene->GetEntity(entity->id).Edit().Scale(transform.scale);
             }
         }
     }
@@ -166,16 +187,16 @@ void InspectorPanel::RenderTransformComponent(Blacksite::Entity* entity) {
 void InspectorPanel::RenderPhysicsComponent(Blacksite::Entity* entity) {
     ImGui::Text("Physics Properties");
 
-    bool wasDynamic = entity->isDynamic;
-    ImGui::Checkbox("Dynamic", &entity->isDynamic);
+    bool wasDynamic = entity->GetPhysics().isDynamic;
+    ImGui::Checkbox("Dynamic", &entity->GetPhysics().isDynamic);
 
-    if (wasDynamic != entity->isDynamic) {
+    if (wasDynamic != entity->GetPhysics().isDynamic) {
         // Update physics body type
         auto* scene = m_editorCore->GetActiveScene();
         if (scene) {
             auto handle = scene->GetEntity(entity->id);
             try {
-                if (entity->isDynamic) {
+                if (entity->GetPhysics().isDynamic) {
                     handle.MakeDynamic();
                 } else {
                     handle.MakeStatic();
@@ -183,14 +204,14 @@ void InspectorPanel::RenderPhysicsComponent(Blacksite::Entity* entity) {
             } catch (const std::exception& e) {
                 // Handle physics system errors
                 ImGui::TextColored(ImVec4(1, 0, 0, 1), "Physics Error: %s", e.what());
-                entity->isDynamic = wasDynamic; // Revert on error
+                entity->GetPhysics().isDynamic = wasDynamic; // Revert on error
             }
         }
     }
 
     // Show current physics state
-    ImGui::Text("Physics Body ID: %u", entity->physicsBody.GetIndexAndSequenceNumber());
-    ImGui::Text("Is Dynamic: %s", entity->isDynamic ? "Yes" : "No");
+    ImGui::Text("Physics Body ID: %u", entity->GetPhysics().body.GetIndexAndSequenceNumber());
+    ImGui::Text("Is Dynamic: %s", entity->GetPhysics().isDynamic ? "Yes" : "No");
 
     ImGui::Spacing();
 
@@ -199,7 +220,7 @@ void InspectorPanel::RenderPhysicsComponent(Blacksite::Entity* entity) {
         auto* scene = m_editorCore->GetActiveScene();
         if (scene) {
             try {
-                entity->isDynamic = false;
+                entity->GetPhysics().isDynamic = false;
                 scene->GetEntity(entity->id).MakeStatic();
             } catch (const std::exception& e) {
                 ImGui::TextColored(ImVec4(1, 0, 0, 1), "Error: %s", e.what());
@@ -211,7 +232,7 @@ void InspectorPanel::RenderPhysicsComponent(Blacksite::Entity* entity) {
         auto* scene = m_editorCore->GetActiveScene();
         if (scene) {
             try {
-                entity->isDynamic = true;
+                entity->GetPhysics().isDynamic = true;
                 scene->GetEntity(entity->id).MakeDynamic();
             } catch (const std::exception& e) {
                 ImGui::TextColored(ImVec4(1, 0, 0, 1), "Error: %s", e.what());
@@ -220,7 +241,7 @@ void InspectorPanel::RenderPhysicsComponent(Blacksite::Entity* entity) {
     }
 
     // Physics actions (only for dynamic bodies)
-    if (entity->isDynamic) {
+    if (entity->GetPhysics().isDynamic) {
         ImGui::Spacing();
         ImGui::Text("Physics Actions:");
 
@@ -256,11 +277,14 @@ void InspectorPanel::RenderPhysicsComponent(Blacksite::Entity* entity) {
 void InspectorPanel::RenderRenderComponent(Blacksite::Entity* entity) {
     ImGui::Text("Rendering Properties");
 
-    // Shape selection
+    // Shape selection - loaded meshes just show which mesh they are
     const char* shapes[] = { "Cube", "Sphere", "Plane" };
-    int currentShape = static_cast<int>(entity->shape);
-    if (ImGui::Combo("Shape", &currentShape, shapes, IM_ARRAYSIZE(shapes))) {
-        entity->shape = static_cast<Blacksite::Entity::VisualShape>(currentShape);
+    int currentShape = static_cast<int>(entity->GetRender().shape);
+    if (entity->GetRender().shape == Blacksite::Entity::MESH) {
+        ImGui::Text("Mesh: %s", entity->mesh.c_str());
+    } else if (ImGui::Combo("Shape", &currentShape, shapes, IM_ARRAYSIZE(shapes))) {
+        entity->GetRender().shape = static_cast<Blacksite::Entity::VisualShape>(currentShape);
+        entity->MarkTransformDirty();  // Bounding radius depends on the mesh
         // TODO: Update mesh/rendering and physics collider if needed
     }
 
@@ -270,23 +294,23 @@ void InspectorPanel::RenderRenderComponent(Blacksite::Entity* entity) {
     shaderBuffer[sizeof(shaderBuffer) - 1] = '\0';
 
     if (ImGui::InputText("Shader", shaderBuffer, sizeof(shaderBuffer))) {
-        entity->shader = shaderBuffer;
+        entity->SetShader(shaderBuffer);
     }
 
     // Common shader presets
-    if (ImGui::Button("Basic")) entity->shader = "basic";
+    if (ImGui::Button("Basic")) entity->SetShader("basic");
     ImGui::SameLine();
-    if (ImGui::Button("Unlit")) entity->shader = "unlit";
+    if (ImGui::Button("Unlit")) entity->SetShader("unlit");
     ImGui::SameLine();
-    if (ImGui::Button("Wireframe")) entity->shader = "wireframe";
+    if (ImGui::Button("Wireframe")) entity->SetShader("wireframe");
 
     // Color picker
-    bool colorChanged = DrawColorControl("Color", entity->color);
+    bool colorChanged = DrawColorControl("Color", entity->GetRender().color);
     if (colorChanged) {
         // Update entity color in scene
         auto* scene = m_editorCore->GetActiveScene();
         if (scene) {
-            scene->GetEntity(entity->id).Color(entity->color);
+            scene->GetEntity(entity->id).Color(entity->GetRender().color);
         }
     }
 }
@@ -334,28 +358,28 @@ void InspectorPanel::RenderEntityActions(Blacksite::Entity* entity) {
 void InspectorPanel::RenderComponentButtons(Blacksite::Entity* entity) {
     ImGui::Text("Components");
 
-    if (!entity->hasPhysics) {
+    if (!entity->GetPhysics().hasPhysics) {
         if (ImGui::Button("Add Physics Component", ImVec2(-1, 0))) {
-            entity->hasPhysics = true;
+            entity->GetPhysics().hasPhysics = true;
             // Create physics body
             auto* scene = m_editorCore->GetActiveScene();
             if (scene) {
                 auto handle = scene->GetEntity(entity->id);
                 try {
-                    if (entity->isDynamic) {
+                    if (entity->GetPhysics().isDynamic) {
                         handle.MakeDynamic();
                     } else {
                         handle.MakeStatic();
                     }
                 } catch (const std::exception& e) {
                     ImGui::TextColored(ImVec4(1, 0, 0, 1), "Error adding physics: %s", e.what());
-                    entity->hasPhysics = false; // Revert on error
+                    entity->GetPhysics().hasPhysics = false; // Revert on error
                 }
             }
         }
     } else {
         if (ImGui::Button("Remove Physics Component", ImVec2(-1, 0))) {
-            entity->hasPhysics = false;
+            entity->GetPhysics().hasPhysics = false;
             // Remove physics body
             auto* scene = m_editorCore->GetActiveScene();
             if (scene) {
@@ -1,6 +1,7 @@
 #include "blacksite_editor/panels/PerformancePanel.h"
 #include "blacksite_editor/core/EditorCore.h"
 #include <blacksite/core/Engine.h>
+#include <blacksite/core/MemoryTracker.h>
 #include <imgui.h>
 #include <GLFW/glfw3.h>
 #include <GL/glew.h>
@@ -24,6 +25,8 @@ void PerformancePanel::Render() {
     if (ImGui::Begin("Performance", &m_isOpen)) {
         RenderFrameRateInfo();
         ImGui::Separator();
+        RenderGpuTimings();
+        ImGui::Separator();
         RenderMemoryInfo();
         ImGui::Separator();
         RenderSystemInfo();
@@ -74,6 +77,48 @@ void PerformancePanel::RenderFrameRateInfo() {
     }
 }
 
+void PerformancePanel::RenderGpuTimings() {
+    ImGui::Text("GPU Timings");
+
+    auto* renderer = m_editorCore->GetEngine()->GetRenderer();
+    if (!renderer) {
+        ImGui::Text("No renderer");
+        return;
+    }
+
+    Blacksite::GpuProfiler& profiler = renderer->GetGpuProfiler();
+    bool enabled = profiler.IsEnabled();
+    if (ImGui::Checkbox("GPU Profiling", &enabled)) {
+        profiler.SetEnabled(enabled);
+    }
+    if (!enabled) {
+        return;
+    }
+
+    ImGui::Text("GPU Frame: %.2f ms (%u frames dropped)", profiler.GetFrameMs(), profiler.GetDroppedFrames());
+    ImGui::PlotLines("GPU Time (ms)", profiler.GetFrameHistory(), Blacksite::GpuProfiler::HISTORY_SIZE,
+                     profiler.GetHistoryOffset(), nullptr, 0.0f, 16.0f, ImVec2(0, 60));
+
+    // One bar per pass, scaled against the whole GPU frame so the expensive one stands out
+    float frameMs = profiler.GetFrameMs() > 0.0f ? profiler.GetFrameMs() : 1.0f;
+    for (const Blacksite::GpuZoneTiming& zone : profiler.GetResults()) {
+        char label[64];
+        snprintf(label, sizeof(label), "%.3f ms", zone.ms);
+        ImGui::ProgressBar(zone.ms / frameMs, ImVec2(120, 0), label);
+        ImGui::SameLine();
+        ImGui::Text("%s", zone.name.c_str());
+    }
+
+    // Passes the render graph skipped this frame, so a missing bar isn't a mystery
+    if (auto* postProcess = renderer->GetPostProcessManager()) {
+        for (const Blacksite::RenderPassTiming& pass : postProcess->GetPassTimings()) {
+            if (pass.culled) {
+                ImGui::TextDisabled("  %s (culled)", pass.name.c_str());
+            }
+        }
+    }
+}
+
 void PerformancePanel::RenderMemoryInfo() {
     ImGui::Text("Memory & Entity Information");
 
@@ -85,26 +130,53 @@ void PerformancePanel::RenderMemoryInfo() {
             int activeEntities = 0;
             int physicsEntities = 0;
 
-            for (const auto& entity : entities) {
-                if (entity.active) {
+            for (const Blacksite::Entity* slot : entities) {
+                if (slot && slot->IsActive()) {
+                    const Blacksite::Entity& entity = *slot;
                     activeEntities++;
-                    if (entity.hasPhysics) {
+                    if (entity.GetPhysics().hasPhysics) {
                         physicsEntities++;
                     }
                 }
             }
 
             ImGui::Text("Active Entities: %d", activeEntities);
-            ImGui::Text("Total Entities: %zu", entities.size());
+            ImGui::Text("Total Entities: %zu", entitySystem->GetAliveCount());
             ImGui::Text("Physics Entities: %d", physicsEntities);
-
-            // Memory estimation (rough)
-            size_t estimatedMemory = entities.size() * sizeof(Blacksite::Entity);
-            ImGui::Text("Est. Entity Memory: %.2f KB", estimatedMemory / 1024.0f);
+            ImGui::Text("Entity Slots: %zu (%zu free)", entities.size(),
+                        entities.size() - entitySystem->GetAliveCount());
         }
     } else {
         ImGui::Text("No active scene");
     }
+
+    // Tracked memory per subsystem. Live creeping up while the scene stays the same is a leak.
+    auto megabytes = [](int64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+    for (bool gpu : {false, true}) {
+        ImGui::Text(gpu ? "GPU Memory (estimated)" : "CPU Memory");
+        int64_t totalLive = 0;
+        for (size_t i = 0; i < static_cast<size_t>(Blacksite::MemoryTag::Count); ++i) {
+            auto tag = static_cast<Blacksite::MemoryTag>(i);
+            if (Blacksite::MemoryTracker::IsGpuTag(tag) != gpu) {
+                continue;
+            }
+
+            Blacksite::MemoryStats stats = Blacksite::MemoryTracker::GetStats(tag);
+            totalLive += stats.liveBytes;
+            ImGui::Text("  %-14s %8.2f MB  (peak %.2f MB)", Blacksite::MemoryTracker::GetTagName(tag),
+                        megabytes(stats.liveBytes), megabytes(stats.peakBytes));
+            if (stats.liveAllocations > 0 && ImGui::IsItemHovered()) {
+                ImGui::SetTooltip("%lld live allocations, %llu since startup",
+                                  static_cast<long long>(stats.liveAllocations),
+                                  static_cast<unsigned long long>(stats.totalAllocations));
+            }
+        }
+        ImGui::Text("  %-14s %8.2f MB", "Total", megabytes(totalLive));
+    }
+
+    if (ImGui::Button("Reset Peaks")) {
+        Blacksite::MemoryTracker::ResetPeaks();
+    }
 }
 
 void PerformancePanel::RenderSystemInfo() {
@@ -124,6 +196,11 @@ void PerformancePanel::RenderSystemInfo() {
     // Engine systems status
     ImGui::Text("Engine Systems:");
     ImGui::Text("  Physics: %s", engine->GetPhysicsSystem() ? "Active" : "Inactive");
+    if (auto* physics = engine->GetPhysicsSystem()) {
+        Blacksite::PhysicsCapacityReport capacity = physics->GetCapacityReport();
+        ImGui::Text("    Bodies: %u / %u (%u active)", capacity.numBodies, capacity.maxBodies,
+                    capacity.numActiveBodies);
+    }
     ImGui::Text("  Renderer: %s", engine->GetRenderer() ? "Active" : "Inactive");
     ImGui::Text("  Input: %s", engine->GetInputSystem() ? "Active" : "Inactive");
 
@@ -143,17 +220,50 @@ void PerformancePanel::RenderSystemInfo() {
 void PerformancePanel::RenderPerformanceControls() {
     ImGui::Text("Performance Controls");
 
-    // VSync control
-    static bool vsync = true;
-    if (ImGui::Checkbox("VSync", &vsync)) {
-        glfwSwapInterval(vsync ? 1 : 0);
+    // Frame pacing - every change goes straight to the engine
+    auto* engine = m_editorCore->GetEngine();
+    Blacksite::FramePacer* pacer = engine->GetFramePacer();
+    Blacksite::FramePacingConfig pacing = engine->GetFramePacing();
+    bool changed = false;
+
+    const char* vsyncModes[] = {"Off", "On", "Adaptive"};
+    int vsync = static_cast<int>(pacing.vsync);
+    if (ImGui::Combo("VSync", &vsync, vsyncModes, IM_ARRAYSIZE(vsyncModes))) {
+        pacing.vsync = static_cast<Blacksite::VSyncMode>(vsync);
+        changed = true;
+    }
+    if (pacer && pacing.vsync == Blacksite::VSyncMode::Adaptive && !pacer->IsAdaptiveVSyncSupported()) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.2f, 1.0f), "(unsupported, using On)");
     }
 
-    // Target FPS (for future use)
-    static int targetFPS = 60;
-    ImGui::SliderInt("Target FPS", &targetFPS, 30, 144);
-    ImGui::SameLine();
-    ImGui::Text("(Not implemented)");
+    changed |= ImGui::SliderInt("Target FPS", &pacing.targetFps, 0, 240, pacing.targetFps ? "%d" : "Uncapped");
+    changed |= ImGui::SliderInt("Unfocused FPS", &pacing.unfocusedFps, 0, 60, pacing.unfocusedFps ? "%d" : "Off");
+    changed |= ImGui::Checkbox("Idle when unchanged", &pacing.idleWhenUnchanged);
+    if (changed) {
+        engine->SetFramePacing(pacing);
+    }
+
+    if (pacer) {
+        const char* state = pacer->IsIdle() ? "Idle" : pacer->IsThrottled() ? "Throttled" : "Active";
+        ImGui::Text("Pacing: %s, waited %.2f ms last frame", state, pacer->GetLastWaitMs());
+    }
+
+    // Dynamic resolution, driven by the GPU timings above
+    Blacksite::Renderer* renderer = engine->GetRenderer();
+    if (Blacksite::PostProcessManager* postProcess = renderer ? renderer->GetPostProcessManager() : nullptr) {
+        Blacksite::PostProcessSettings& settings = postProcess->GetSettings();
+        ImGui::Checkbox("Dynamic Resolution", &settings.dynamicResolution);
+        if (settings.dynamicResolution) {
+            ImGui::SliderFloat("GPU Budget (ms)", &settings.gpuBudgetMs, 4.0f, 33.0f, "%.1f");
+            ImGui::SliderFloat("Min Render Scale", &settings.minRenderScale, 0.25f, 1.0f, "%.2f");
+            if (!renderer->GetGpuProfiler().IsEnabled()) {
+                ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.2f, 1.0f), "Needs GPU profiling on to adjust");
+            }
+        }
+        ImGui::Text("Render Scale: %.0f%% (%dx%d)", postProcess->GetRenderScale() * 100.0f,
+                    postProcess->GetRenderWidth(), postProcess->GetRenderHeight());
+    }
 
     // Performance actions
     if (ImGui::Button("Reset Performance Counters")) {
@@ -3,6 +3,7 @@
 #include <blacksite/scene/Scene.h>
 #include <blacksite/core/EntitySystem.h>
 #include <imgui.h>
+#include <cstring>
 
 namespace BlacksiteEditor {
 
@@ -20,10 +21,8 @@ void SceneHierarchyPanel::Render() {
         if (scene) {
             auto* entitySystem = scene->GetEntitySystem();
             if (entitySystem) {
-                const auto& entities = entitySystem->GetEntities();
-
                 // Header with entity count and controls
-                ImGui::Text("Entities: %zu", entities.size());
+                ImGui::Text("Entities: %zu", entitySystem->GetAliveCount());
                 ImGui::SameLine();
 
                 // Quick create buttons
@@ -42,27 +41,24 @@ void SceneHierarchyPanel::Render() {
                 ImGui::Separator();
 
                 // Search/Filter bar
-                static char searchBuffer[256] = "";
-                ImGui::InputTextWithHint("##Search", "Search entities...", searchBuffer, sizeof(searchBuffer));
-                bool hasSearch = strlen(searchBuffer) > 0;
+                ImGui::InputTextWithHint("##Search", "Search entities...", m_searchBuffer, sizeof(m_searchBuffer));
 
                 ImGui::Separator();
 
-                // Entity list
-                for (const auto& entity : entities) {
-                    if (entity.active) {
-                        // Apply search filter
-                        if (hasSearch) {
-                            std::string entityName = entity.name.empty() ?
-                                "Entity_" + std::to_string(entity.id) : entity.name;
-                            if (entityName.find(searchBuffer) == std::string::npos) {
-                                continue;
-                            }
+                // Entity list, every row is one line high so the clipper can skip everything off screen
+                RefreshVisibleSlots(*entitySystem);
+                const auto& entities = entitySystem->GetEntities();
+                ImGuiListClipper clipper;
+                clipper.Begin(static_cast<int>(m_visibleSlots.size()));
+                while (clipper.Step()) {
+                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                        const Blacksite::Entity* slot = entities[m_visibleSlots[i]];
+                        if (slot) {
+                            RenderEntityNode(*slot);
                         }
-
-                        RenderEntityNode(entity);
                     }
                 }
+                clipper.End();
             }
         } else {
             ImGui::Text("No active scene");
@@ -115,6 +111,33 @@ void SceneHierarchyPanel::Render() {
     ImGui::End();
 }
 
+void SceneHierarchyPanel::RefreshVisibleSlots(const Blacksite::EntitySystem& entitySystem) {
+    if (&entitySystem == m_cachedSystem && entitySystem.GetVersion() == m_cachedVersion &&
+        m_cachedSearch == m_searchBuffer) {
+        return;
+    }
+    m_cachedSystem = &entitySystem;
+    m_cachedVersion = entitySystem.GetVersion();
+    m_cachedSearch = m_searchBuffer;
+
+    bool hasSearch = !m_cachedSearch.empty();
+    const auto& entities = entitySystem.GetEntities();
+    m_visibleSlots.clear();
+    for (uint32_t index = 0; index < entities.size(); ++index) {
+        const Blacksite::Entity* slot = entities[index];
+        if (!slot || !slot->IsActive()) {
+            continue;
+        }
+        if (hasSearch) {
+            std::string entityName = slot->name.empty() ? "Entity_" + std::to_string(slot->id) : slot->name;
+            if (entityName.find(m_cachedSearch) == std::string::npos) {
+                continue;
+            }
+        }
+        m_visibleSlots.push_back(index);
+    }
+}
+
 void SceneHierarchyPanel::RenderEntityNode(const Blacksite::Entity& entity) {
     ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
 
@@ -130,15 +153,15 @@ void SceneHierarchyPanel::RenderEntityNode(const Blacksite::Entity& entity) {
 
     // Add icon based on entity type (removed emoji icons for professionalism and compatibility)
     const char* icon = ""; // Default cube (no icon)
-    switch (entity.shape) {
+    switch (entity.GetRender().shape) {
         case Blacksite::Entity::SPHERE: icon = ""; break;
         case Blacksite::Entity::PLANE: icon = ""; break;
         default: break;
     }
 
     // Add physics indicator
-    std::string physicsIndicator = entity.hasPhysics ?
-        (entity.isDynamic ? " [D]" : " [S]") : "";
+    std::string physicsIndicator = entity.GetPhysics().hasPhysics ?
+        (entity.GetPhysics().isDynamic ? " [D]" : " [S]") : "";
 
     std::string displayName = std::string(icon) + " " + label + physicsIndicator;
 
@@ -152,7 +175,7 @@ void SceneHierarchyPanel::RenderEntityNode(const Blacksite::Entity& entity) {
     if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0)) {
         auto* scene = m_editorCore->GetActiveScene();
         if (scene) {
-            glm::vec3 entityPos = entity.transform.position;
+            glm::vec3 entityPos = entity.GetTransform().position;
             scene->SetCameraTarget(entityPos);
             scene->SetCameraPosition(entityPos + glm::vec3(5, 5, 5));
         }
@@ -168,7 +191,7 @@ void SceneHierarchyPanel::RenderEntityNode(const Blacksite::Entity& entity) {
         if (ImGui::MenuItem("Focus Camera", "F")) {
             auto* scene = m_editorCore->GetActiveScene();
             if (scene) {
-                glm::vec3 entityPos = entity.transform.position;
+                glm::vec3 entityPos = entity.GetTransform().position;
                 scene->SetCameraTarget(entityPos);
                 scene->SetCameraPosition(entityPos + glm::vec3(5, 5, 5));
             }
@@ -194,8 +217,8 @@ void SceneHierarchyPanel::RenderEntityNode(const Blacksite::Entity& entity) {
         ImGui::Separator();
 
         // Physics quick actions
-        if (entity.hasPhysics) {
-            if (entity.isDynamic) {
+        if (entity.GetPhysics().hasPhysics) {
+            if (entity.GetPhysics().isDynamic) {
                 if (ImGui::MenuItem("Make Static")) {
                     auto* scene = m_editorCore->GetActiveScene();
                     if (scene) {
@@ -218,7 +241,7 @@ void SceneHierarchyPanel::RenderEntityNode(const Blacksite::Entity& entity) {
                     if (entitySystem) {
                         auto* entityPtr = entitySystem->GetEntityPtr(entity.id);
                         if (entityPtr) {
-                            entityPtr->hasPhysics = true;
+                            entityPtr->GetPhysics().hasPhysics = true;
                             scene->GetEntity(entity.id).MakeDynamic();
                         }
                     }
@@ -1,4 +1,5 @@
 #include "blacksite_editor/panels/ViewportPanel.h"
+#include <blacksite/core/FramePacer.h>
 #include <blacksite/core/InputSystem.h>
 #include <blacksite/scene/Scene.h>
 #include <imgui.h>
@@ -111,6 +112,9 @@ void ViewportPanel::RenderViewportContent() {
         // scene->GetCameraSystem()->SetAspectRatio(aspectRatio);
     }
 
+    // Picking reads ids written by the scene pass, so the buffer has to be on before we render
+    postProcessManager->GetSettings().entityIdBuffer = true;
+
     // Resize post-process buffers if viewport size changed
     static glm::vec2 lastViewportSize = {0, 0};
     if (m_viewportSize.x != lastViewportSize.x || m_viewportSize.y != lastViewportSize.y) {
@@ -130,15 +134,45 @@ void ViewportPanel::RenderViewportContent() {
         // Convert OpenGL texture ID to ImTextureID (ImTextureRef is not standard ImGui)
         ImTextureID textureID = (ImTextureID)(intptr_t)sceneTexture;
 
+        // The pooled texture can be bigger than the viewport, only the bottom-left part has the image
+        glm::vec2 uvScale = postProcessManager->GetSceneUvScale();
+
         // Display the texture using the ImGui::Image() function
         ImGui::Image(textureID, ImVec2(m_viewportSize.x, m_viewportSize.y),
-                    ImVec2(0, 1),    // uv0 - bottom-left in OpenGL coordinates
-                    ImVec2(1, 0));   // uv1 - top-right (flipped Y for OpenGL)
+                    ImVec2(0, uvScale.y),    // uv0 - bottom-left in OpenGL coordinates
+                    ImVec2(uvScale.x, 0));   // uv1 - top-right (flipped Y for OpenGL)
+        HandlePicking(postProcessManager);
     } else {
         ImGui::Text("Failed to get scene texture (ID: %u)", sceneTexture);
     }
 }
 
+void ViewportPanel::HandlePicking(Blacksite::PostProcessManager* postProcessManager) {
+    // Result of an earlier click - nothing here waits on the GPU
+    int pickedId = -1;
+    if (postProcessManager->PollPick(pickedId)) {
+        m_pickPending = false;
+        if (m_entityPickedCallback) {
+            m_entityPickedCallback(pickedId);
+        }
+    }
+
+    if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
+        // Image space, flipped to the framebuffer's bottom-left origin. The image is the buffer size 1:1.
+        ImVec2 mouse = ImGui::GetMousePos();
+        ImVec2 imageMin = ImGui::GetItemRectMin();
+        int x = static_cast<int>(mouse.x - imageMin.x);
+        int y = static_cast<int>(m_viewportSize.y) - 1 - static_cast<int>(mouse.y - imageMin.y);
+        postProcessManager->RequestPick(x, y);
+        m_pickPending = true;
+    }
+
+    // The answer shows up a frame or two later, don't let the editor go idle before it does
+    if (m_pickPending) {
+        Blacksite::FramePacer::RequestRedraw();
+    }
+}
+
 
 void ViewportPanel::RenderViewportOverlay() {
     // Overlay controls and information
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Compare two benchmark results and flag regressions.
+
+Takes either blacksite_microbench output (--benchmark_out=FILE --benchmark_out_format=json)
+or blacksite_bench output (--out FILE), the same kind for both files.
+
+    ./scripts/compare_bench.py baseline.json current.json
+    ./scripts/compare_bench.py baseline.json current.json --threshold 3
+
+Exits with 1 if anything got slower by more than the threshold, so CI can gate on it.
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+# Colors only when someone is looking
+if sys.stdout.isatty():
+    RED, GREEN, NC = "\033[0;31m", "\033[0;32m", "\033[0m"
+else:
+    RED = GREEN = NC = ""
+
+
+def load(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+def microbench_times(data, metric):
+    """name -> ns. With --benchmark_repetitions the median is used and the single runs skipped."""
+    times = {}
+    medians = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        value = bench[metric] * TIME_UNITS_NS[bench.get("time_unit", "ns")]
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[bench["run_name"]] = value
+        else:
+            times[bench["name"]] = value
+    times.update(medians)
+    return times
+
+
+def scene_bench_times(data, percentiles):
+    """scenario.percentile -> ms, frame time only. Scope times are too noisy to gate on."""
+    times = {}
+    for scenario in data.get("scenarios", []):
+        if not scenario.get("ok"):
+            continue
+        for p in percentiles:
+            times["%s.frame_%s" % (scenario["name"], p)] = scenario["frameMs"][p]
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two benchmark JSON files")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent slower that counts (default 5)")
+    parser.add_argument("--metric", default="cpu_time", choices=["cpu_time", "real_time"],
+                        help="microbenchmark time to compare (default cpu_time)")
+    parser.add_argument("--percentiles", default="p50,p95,p99",
+                        help="blacksite_bench frame percentiles to compare (default p50,p95,p99)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    if "benchmarks" in baseline and "benchmarks" in current:
+        before = microbench_times(baseline, args.metric)
+        after = microbench_times(current, args.metric)
+        unit = "ns"
+    elif "scenarios" in baseline and "scenarios" in current:
+        wanted = [p.strip() for p in args.percentiles.split(",") if p.strip()]
+        before = scene_bench_times(baseline, wanted)
+        after = scene_bench_times(current, wanted)
+        unit = "ms"
+    else:
+        print("Both files have to come from the same tool (blacksite_microbench or blacksite_bench)")
+        return 2
+
+    names = [name for name in before if name in after]
+    if not names:
+        print("Nothing in common to compare")
+        return 2
+
+    width = max(len(name) for name in names)
+    print("%-*s %14s %14s %9s" % (width, "benchmark", "baseline", "current", "change"))
+
+    regressions = []
+    for name in names:
+        old, new = before[name], after[name]
+        change = (new - old) / old * 100.0 if old > 0 else 0.0
+        color = RED if change > args.threshold else GREEN if change < -args.threshold else ""
+        print("%-*s %11.3f %s %11.3f %s %s%+8.1f%%%s" % (width, name, old, unit, new, unit, color, change, NC))
+        if change > args.threshold:
+            regressions.append(name)
+
+    for name in sorted(set(before) ^ set(after)):
+        print("%-*s only in %s" % (width, name, "baseline" if name in before else "current"))
+
+    if regressions:
+        print("\n%d regression(s) over %.1f%%: %s" % (len(regressions), args.threshold, ", ".join(regressions)))
+        return 1
+    print("\nNo regressions over %.1f%%" % args.threshold)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())